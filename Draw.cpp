@@ -36,9 +36,11 @@
 #include <Util/Graphics/Color.h>
 #include <Util/References.h>
 #include <Util/Macros.h>
+#include <cmath>
 #include <cstddef>
 #include <list>
 #include <cstdint>
+#include <vector>
 
 namespace Rendering {
 
@@ -122,6 +124,7 @@ void drawBox(RenderingContext & rc, const Geometry::Box & box) {
 void drawFastAbsBox(RenderingContext & rc, const Geometry::Box & b){
 	#ifdef LIB_GL
 	if(RenderingContext::getCompabilityMode()) {
+		rc.flushTransientGeometry();
 		rc.pushAndSetShader(nullptr);
 
 	//  Too slow:
@@ -224,72 +227,27 @@ void drawWireframeSphere(RenderingContext & rc, const Geometry::Sphere & sphere,
 
 void drawQuad(RenderingContext & rc, const Geometry::Vec3 & lowerLeft, const Geometry::Vec3 & lowerRight, const Geometry::Vec3 & upperRight,
 				const Geometry::Vec3 & upperLeft) {
-	static Util::Reference<Mesh> mesh;
-	if (mesh.isNull()) {
-		VertexDescription vertexDescription;
-		vertexDescription.appendPosition3D();
-		vertexDescription.appendNormalFloat();
-		vertexDescription.appendTexCoord();
-		mesh = new Mesh(vertexDescription, 4, 6);
-
-		MeshIndexData & id = mesh->openIndexData();
-		uint32_t * indices = id.data();
-		indices[0] = 0;
-		indices[1] = 1;
-		indices[2] = 2;
-		indices[3] = 0;
-		indices[4] = 2;
-		indices[5] = 3;
-		id.updateIndexRange();
-		id.markAsChanged();
-	}
+	static const VertexDescription vertexDescription = []() {
+		VertexDescription vd;
+		vd.appendPosition3D();
+		vd.appendNormalFloat();
+		vd.appendTexCoord();
+		return vd;
+	}();
+	static const uint32_t indices[] = {0, 1, 2, 0, 2, 3};
+
 	const Geometry::Vec3 edgeA = lowerRight - lowerLeft;
 	const Geometry::Vec3 edgeB = upperLeft - lowerLeft;
 	Geometry::Vec3 normal = edgeA.cross(edgeB);
 	normal.normalize();
 
-	MeshVertexData & vd = mesh->openVertexData();
-	float * vertices = reinterpret_cast<float *> (vd.data());
-	// Lower left
-	*vertices++ = lowerLeft.getX();
-	*vertices++ = lowerLeft.getY();
-	*vertices++ = lowerLeft.getZ();
-	*vertices++ = normal.getX();
-	*vertices++ = normal.getY();
-	*vertices++ = normal.getZ();
-	*vertices++ = 0.0f;
-	*vertices++ = 0.0f;
-	// Lower right
-	*vertices++ = lowerRight.getX();
-	*vertices++ = lowerRight.getY();
-	*vertices++ = lowerRight.getZ();
-	*vertices++ = normal.getX();
-	*vertices++ = normal.getY();
-	*vertices++ = normal.getZ();
-	*vertices++ = 1.0f;
-	*vertices++ = 0.0f;
-	// Upper right
-	*vertices++ = upperRight.getX();
-	*vertices++ = upperRight.getY();
-	*vertices++ = upperRight.getZ();
-	*vertices++ = normal.getX();
-	*vertices++ = normal.getY();
-	*vertices++ = normal.getZ();
-	*vertices++ = 1.0f;
-	*vertices++ = 1.0f;
-	// Upper left
-	*vertices++ = upperLeft.getX();
-	*vertices++ = upperLeft.getY();
-	*vertices++ = upperLeft.getZ();
-	*vertices++ = normal.getX();
-	*vertices++ = normal.getY();
-	*vertices++ = normal.getZ();
-	*vertices++ = 0.0f;
-	*vertices++ = 1.0f;
-	vd.updateBoundingBox();
-	vd.markAsChanged();
-
-	rc.displayMesh(mesh.get());
+	const float vertices[] = {
+		lowerLeft.getX(), lowerLeft.getY(), lowerLeft.getZ(), normal.getX(), normal.getY(), normal.getZ(), 0.0f, 0.0f,
+		lowerRight.getX(), lowerRight.getY(), lowerRight.getZ(), normal.getX(), normal.getY(), normal.getZ(), 1.0f, 0.0f,
+		upperRight.getX(), upperRight.getY(), upperRight.getZ(), normal.getX(), normal.getY(), normal.getZ(), 1.0f, 1.0f,
+		upperLeft.getX(), upperLeft.getY(), upperLeft.getZ(), normal.getX(), normal.getY(), normal.getZ(), 0.0f, 1.0f
+	};
+	rc.displayTransientGeometry(vertexDescription, GL_TRIANGLES, reinterpret_cast<const uint8_t *>(vertices), 4, indices, 6);
 }
 
 void drawQuad(RenderingContext & rc, const Geometry::Vec3f & lowerLeft, const Geometry::Vec3f & lowerRight, const Geometry::Vec3f & upperRight,
@@ -300,22 +258,20 @@ void drawQuad(RenderingContext & rc, const Geometry::Vec3f & lowerLeft, const Ge
 }
 
 void drawWireframeRect(RenderingContext & rc, const Geometry::Rect & rect) {
-	static Util::Reference<Mesh> mesh;
-	if(mesh.isNull()) {
-		VertexDescription vertexDescription;
-		vertexDescription.appendPosition2D();
-		Geometry::Rect unitRect(0,0,1,1);
-		mesh = MeshUtils::WireShapes::createWireRectangle(vertexDescription, unitRect);
-		mesh->setDataStrategy(SimpleMeshDataStrategy::getPureLocalStrategy());
-	}
-
-	Geometry::Matrix4x4 matrix;
-	matrix.translate(rect.getX(), rect.getY(), 0.0f);
-	matrix.scale(rect.getWidth(), rect.getHeight(), 1.0f);
-	rc.pushMatrix_modelToCamera();
-	rc.multMatrix_modelToCamera(matrix);
-	rc.displayMesh(mesh.get());
-	rc.popMatrix_modelToCamera();
+	static const VertexDescription vertexDescription = []() {
+		VertexDescription vd;
+		vd.appendPosition2D();
+		return vd;
+	}();
+	static const uint32_t indices[] = {0, 1, 1, 2, 2, 3, 3, 0};
+
+	const float vertices[] = {
+		rect.getMinX(), rect.getMinY(),
+		rect.getMaxX(), rect.getMinY(),
+		rect.getMaxX(), rect.getMaxY(),
+		rect.getMinX(), rect.getMaxY()
+	};
+	rc.displayTransientGeometry(vertexDescription, GL_LINES, reinterpret_cast<const uint8_t *>(vertices), 4, indices, 8);
 }
 
 void drawWireframeRect(RenderingContext & rc, const Geometry::Rect & rect, const Util::Color4f & color) {
@@ -325,22 +281,21 @@ void drawWireframeRect(RenderingContext & rc, const Geometry::Rect & rect, const
 }
 
 void drawRect(RenderingContext & rc, const Geometry::Rect & rect) {
-	static Util::Reference<Mesh> mesh;
-	if(mesh.isNull()) {
-		VertexDescription vertexDescription;
-		vertexDescription.appendPosition2D();
-		Geometry::Rect unitRect(0,0,1,1);
-		mesh = MeshUtils::createRectangle(vertexDescription, unitRect);
-		mesh->setDataStrategy(SimpleMeshDataStrategy::getPureLocalStrategy());
-	}
-
-	Geometry::Matrix4x4 matrix;
-	matrix.translate(rect.getX(), rect.getY(), 0.0f);
-	matrix.scale(rect.getWidth(), rect.getHeight(), 1.0f);
-	rc.pushMatrix_modelToCamera();
-	rc.multMatrix_modelToCamera(matrix);
-	rc.displayMesh(mesh.get());
-	rc.popMatrix_modelToCamera();
+	static const VertexDescription vertexDescription = []() {
+		VertexDescription vd;
+		vd.appendPosition2D();
+		return vd;
+	}();
+	// same orientation as MeshUtils::createRectangle
+	static const uint32_t indices[] = {0, 1, 3, 1, 2, 3};
+
+	const float vertices[] = {
+		rect.getMinX(), rect.getMinY(),
+		rect.getMinX(), rect.getMaxY(),
+		rect.getMaxX(), rect.getMaxY(),
+		rect.getMaxX(), rect.getMinY()
+	};
+	rc.displayTransientGeometry(vertexDescription, GL_TRIANGLES, reinterpret_cast<const uint8_t *>(vertices), 4, indices, 6);
 }
 
 void drawRect(RenderingContext & rc, const Geometry::Rect & rect, const Util::Color4f & color) {
@@ -350,21 +305,29 @@ void drawRect(RenderingContext & rc, const Geometry::Rect & rect, const Util::Co
 }
 
 void drawWireframeCircle(RenderingContext & rc, const Geometry::Vec2f & center, float radius) {
-	static Util::Reference<Mesh> mesh;
-	if(mesh.isNull()) {
-		VertexDescription vertexDescription;
-		vertexDescription.appendPosition2D();
-		mesh = MeshUtils::WireShapes::createWireCircle(vertexDescription, 1, 32);
-		mesh->setDataStrategy(SimpleMeshDataStrategy::getPureLocalStrategy());
+	static const uint32_t numSegments = 32;
+	static const VertexDescription vertexDescription = []() {
+		VertexDescription vd;
+		vd.appendPosition2D();
+		return vd;
+	}();
+	static const std::vector<uint32_t> indices = []() {
+		std::vector<uint32_t> lineIndices;
+		for(uint32_t segment = 0; segment < numSegments; ++segment) {
+			lineIndices.push_back(segment);
+			lineIndices.push_back((segment + 1) % numSegments);
+		}
+		return lineIndices;
+	}();
+
+	float vertices[2 * numSegments];
+	for(uint32_t segment = 0; segment < numSegments; ++segment) {
+		const double segmentAngle = static_cast<double>(segment) * 2.0 * M_PI / static_cast<double>(numSegments);
+		vertices[2 * segment] = center.getX() + static_cast<float>(std::sin(segmentAngle)) * radius;
+		vertices[2 * segment + 1] = center.getY() + static_cast<float>(std::cos(segmentAngle)) * radius;
 	}
-
-	Geometry::Matrix4x4 matrix;
-	matrix.translate(center.getX(), center.getY(), 0.0f);
-	matrix.scale(radius, radius, 1.0f);
-	rc.pushMatrix_modelToCamera();
-	rc.multMatrix_modelToCamera(matrix);
-	rc.displayMesh(mesh.get());
-	rc.popMatrix_modelToCamera();
+	rc.displayTransientGeometry(vertexDescription, GL_LINES, reinterpret_cast<const uint8_t *>(vertices), numSegments,
+								indices.data(), static_cast<uint32_t>(indices.size()));
 }
 
 void drawWireframeCircle(RenderingContext & rc, const Geometry::Vec2f & center, float radius, const Util::Color4f & color) {
@@ -374,109 +337,49 @@ void drawWireframeCircle(RenderingContext & rc, const Geometry::Vec2f & center,
 }
 
 void drawTriangle(RenderingContext & rc, const Geometry::Vec3f & vertexA, const Geometry::Vec3f & vertexB, const Geometry::Vec3f & vertexC) {
-	static Util::Reference<Mesh> mesh;
-	if (mesh.isNull()) {
-		VertexDescription vertexDescription;
-		vertexDescription.appendPosition3D();
-		mesh = new Mesh(vertexDescription, 3, 3);
-
-		MeshIndexData & id = mesh->openIndexData();
-		uint32_t * indices = id.data();
-		indices[0] = 0;
-		indices[1] = 1;
-		indices[2] = 2;
-		id.updateIndexRange();
-		id.markAsChanged();
-	}
-
-	MeshVertexData & vd = mesh->openVertexData();
-	float * vertices = reinterpret_cast<float *>(vd.data());
-	// First vertex
-	*vertices++ = vertexA.getX();
-	*vertices++ = vertexA.getY();
-	*vertices++ = vertexA.getZ();
-	// Second vertex
-	*vertices++ = vertexB.getX();
-	*vertices++ = vertexB.getY();
-	*vertices++ = vertexB.getZ();
-	// Third vertex
-	*vertices++ = vertexC.getX();
-	*vertices++ = vertexC.getY();
-	*vertices++ = vertexC.getZ();
-	vd.updateBoundingBox();
-	vd.markAsChanged();
-
-	rc.displayMesh(mesh.get());
+	static const VertexDescription vertexDescription = []() {
+		VertexDescription vd;
+		vd.appendPosition3D();
+		return vd;
+	}();
+	static const uint32_t indices[] = {0, 1, 2};
+
+	const float vertices[] = {
+		vertexA.getX(), vertexA.getY(), vertexA.getZ(),
+		vertexB.getX(), vertexB.getY(), vertexB.getZ(),
+		vertexC.getX(), vertexC.getY(), vertexC.getZ()
+	};
+	rc.displayTransientGeometry(vertexDescription, GL_TRIANGLES, reinterpret_cast<const uint8_t *>(vertices), 3, indices, 3);
 }
 
 void drawVector(RenderingContext & rc, const Geometry::Vec3 & from, const Geometry::Vec3 & to) {
-	static Util::Reference<Mesh> mesh;
-	if (mesh.isNull()) {
-		VertexDescription vertexDescription;
-		vertexDescription.appendPosition3D();
-		mesh = new Mesh(vertexDescription, 2, 2);
-		mesh->setDrawMode(Mesh::DRAW_LINES);
-
-		MeshIndexData & id = mesh->openIndexData();
-		uint32_t * indices = id.data();
-		indices[0] = 0;
-		indices[1] = 1;
-		id.updateIndexRange();
-		id.markAsChanged();
-		mesh->setDataStrategy(SimpleMeshDataStrategy::getPureLocalStrategy());
-	}
-
-	MeshVertexData & vd = mesh->openVertexData();
-	float * vertices = reinterpret_cast<float *> (vd.data());
-	*vertices++ = from.getX(); // From
-	*vertices++ = from.getY();
-	*vertices++ = from.getZ();
-	*vertices++ = to.getX(); // To
-	*vertices++ = to.getY();
-	*vertices++ = to.getZ();
-	vd.updateBoundingBox();
-	vd.markAsChanged();
-
-	rc.displayMesh(mesh.get());
+	static const VertexDescription vertexDescription = []() {
+		VertexDescription vd;
+		vd.appendPosition3D();
+		return vd;
+	}();
+	static const uint32_t indices[] = {0, 1};
+
+	const float vertices[] = {
+		from.getX(), from.getY(), from.getZ(),
+		to.getX(), to.getY(), to.getZ()
+	};
+	rc.displayTransientGeometry(vertexDescription, GL_LINES, reinterpret_cast<const uint8_t *>(vertices), 2, indices, 2);
 }
 void drawVector(RenderingContext & rc, const Geometry::Vec3 & from, const Geometry::Vec3 & to, const Util::Color4f & color1, const Util::Color4f & color2) {
-	static Util::Reference<Mesh> mesh;
-	if (mesh.isNull()) {
-		VertexDescription vertexDescription;
-		vertexDescription.appendPosition3D();
-		vertexDescription.appendColorRGBAFloat();
-		mesh = new Mesh(vertexDescription, 2, 2);
-		mesh->setDrawMode(Mesh::DRAW_LINES);
-
-		MeshIndexData & id = mesh->openIndexData();
-		uint32_t * indices = id.data();
-		indices[0] = 0;
-		indices[1] = 1;
-		id.updateIndexRange();
-		id.markAsChanged();
-		mesh->setDataStrategy(SimpleMeshDataStrategy::getPureLocalStrategy());
-	}
-
-	MeshVertexData & vd = mesh->openVertexData();
-	float * vertices = reinterpret_cast<float *> (vd.data());
-	*vertices++ = from.getX(); // From
-	*vertices++ = from.getY();
-	*vertices++ = from.getZ();
-	*vertices++ = color1.r(); // FromColor
-	*vertices++ = color1.g();
-	*vertices++ = color1.b();
-	*vertices++ = color1.a();
-	*vertices++ = to.getX(); // To
-	*vertices++ = to.getY();
-	*vertices++ = to.getZ();
-	*vertices++ = color2.r(); // ToColor
-	*vertices++ = color2.g();
-	*vertices++ = color2.b();
-	*vertices++ = color2.a();
-	vd.updateBoundingBox();
-	vd.markAsChanged();
-
-	rc.displayMesh(mesh.get());
+	static const VertexDescription vertexDescription = []() {
+		VertexDescription vd;
+		vd.appendPosition3D();
+		vd.appendColorRGBAFloat();
+		return vd;
+	}();
+	static const uint32_t indices[] = {0, 1};
+
+	const float vertices[] = {
+		from.getX(), from.getY(), from.getZ(), color1.r(), color1.g(), color1.b(), color1.a(),
+		to.getX(), to.getY(), to.getZ(), color2.r(), color2.g(), color2.b(), color2.a()
+	};
+	rc.displayTransientGeometry(vertexDescription, GL_LINES, reinterpret_cast<const uint8_t *>(vertices), 2, indices, 2);
 }
 
 void drawVector(RenderingContext & rc, const Geometry::Vec3f & from, const Geometry::Vec3f & to, const Util::Color4f & color) {
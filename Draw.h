@@ -17,6 +17,11 @@
 /**
  * @file
  * Draw functions for simple objects
+ *
+ * drawQuad(), drawRect(), drawWireframeRect(), drawWireframeCircle(), drawTriangle() and drawVector() pass their
+ * geometry to RenderingContext::displayTransientGeometry(). The geometry is drawn immediately, unless the calls are
+ * placed between RenderingContext::beginTransientGeometryBatch() and RenderingContext::endTransientGeometryBatch();
+ * then consecutive calls with the same state are drawn with one draw call when the batch ends.
  */
 
 // Forward declarations
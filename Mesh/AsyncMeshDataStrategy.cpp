@@ -0,0 +1,171 @@
+/*
+ This file is part of the Rendering library.
+ Copyright (C) 2026 agent <agent@local>
+
+ This library is subject to the terms of the Mozilla Public License, v. 2.0.
+ You should have received a copy of the MPL along with this library; see the
+ file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "AsyncMeshDataStrategy.h"
+#include "Mesh.h"
+#include "MeshIndexData.h"
+#include "MeshVertexData.h"
+#include "../GLHeader.h"
+#include "../StagingRing.h"
+#include <algorithm>
+
+namespace Rendering {
+
+AsyncMeshDataStrategy::Entry::Entry() : vertexTransfer(StagingRing::INVALID_TRANSFER), indexTransfer(StagingRing::INVALID_TRANSFER),
+		pendingTransfers(0), vertexRevision(0), indexRevision(0), uploadedDescription(nullptr), uploadedVertexCount(0),
+		uploadedIndexCount(0), uploadedMinIndex(0), uploadedMaxIndex(0), prepared(false) {
+}
+
+AsyncMeshDataStrategy::AsyncMeshDataStrategy(uint8_t _flags, size_t _stagingCapacity, size_t _bytesPerFrame, uint32_t _workerCount) :
+		MeshDataStrategy(true), flags(_flags), stagingCapacity(_stagingCapacity), bytesPerFrame(_bytesPerFrame), workerCount(_workerCount) {
+}
+
+AsyncMeshDataStrategy::~AsyncMeshDataStrategy() {
+	// cancel the uploads of the meshes
+	detachMeshes();
+	// stop the workers before the targets of the uploads are destroyed
+	stagingRing.reset();
+}
+
+bool AsyncMeshDataStrategy::isReady(Mesh * m) const {
+	const auto it = entries.find(m);
+	return it != entries.end() && it->second.prepared && it->second.pendingTransfers == 0;
+}
+
+size_t AsyncMeshDataStrategy::getPendingMeshCount() const {
+	return static_cast<size_t>(std::count_if(entries.begin(), entries.end(), [](const std::pair<Mesh * const, Entry> & entry) {
+		return entry.second.pendingTransfers > 0;
+	}));
+}
+
+void AsyncMeshDataStrategy::update() {
+	if(stagingRing)
+		stagingRing->update();
+}
+
+//! (internal)
+void AsyncMeshDataStrategy::cancelUploads(Entry & entry) {
+	if(entry.vertexTransfer != StagingRing::INVALID_TRANSFER)
+		stagingRing->cancel(entry.vertexTransfer);
+	if(entry.indexTransfer != StagingRing::INVALID_TRANSFER)
+		stagingRing->cancel(entry.indexTransfer);
+	entry.vertexTransfer = entry.indexTransfer = StagingRing::INVALID_TRANSFER;
+	entry.pendingTransfers = 0;
+	entry.vertexBuffer.destroy();
+	entry.indexBuffer.destroy();
+}
+
+//! (internal) Called by the StagingRing when an upload of the mesh is complete.
+void AsyncMeshDataStrategy::uploadComplete(Mesh * m) {
+	Entry & entry = entries.at(m);
+	if(--entry.pendingTransfers > 0)
+		return;
+	MeshVertexData & vd = m->_getVertexData();
+	MeshIndexData & id = m->_getIndexData();
+	if(entry.vertexTransfer != StagingRing::INVALID_TRANSFER)
+		vd._swapBufferObject(entry.vertexBuffer, vd.getRevision() == entry.vertexRevision);
+	if(entry.indexTransfer != StagingRing::INVALID_TRANSFER)
+		id._swapBufferObject(entry.indexBuffer, id.getRevision() == entry.indexRevision);
+	entry.vertexTransfer = entry.indexTransfer = StagingRing::INVALID_TRANSFER;
+	entry.uploadedDescription = &vd.getVertexDescription();
+	entry.uploadedVertexCount = vd.getVertexCount();
+	entry.uploadedIndexCount = id.getIndexCount();
+	entry.uploadedMinIndex = id.getMinIndex();
+	entry.uploadedMaxIndex = id.getMaxIndex();
+	// the buffers replaced by the uploads
+	entry.vertexBuffer.destroy();
+	entry.indexBuffer.destroy();
+	if(!getFlag(PRESERVE_LOCAL_DATA)) {
+		if(vd.isUploaded())
+			vd.releaseLocalData();
+		if(id.isUploaded())
+			id.releaseLocalData();
+	}
+}
+
+/*! (internal) Return true if the buffers of the mesh, which are replaced when the pending uploads are complete,
+	can be drawn with the current data of the mesh (e.g. the vertices have been changed, but not their number). */
+bool AsyncMeshDataStrategy::canDisplayPreviousBuffers(Mesh * m, const Entry & entry) const {
+	const MeshVertexData & vd = m->_getVertexData();
+	const MeshIndexData & id = m->_getIndexData();
+	return vd.isUploaded() && (!m->isUsingIndexData() || id.isUploaded())
+			&& entry.uploadedDescription == &vd.getVertexDescription() && entry.uploadedVertexCount == vd.getVertexCount()
+			&& entry.uploadedIndexCount == id.getIndexCount() && entry.uploadedMinIndex == id.getMinIndex()
+			&& entry.uploadedMaxIndex == id.getMaxIndex();
+}
+
+//! ---|> MeshDataStrategy
+void AsyncMeshDataStrategy::assureLocalVertexData(Mesh * m){
+	MeshVertexData & vd = m->_getVertexData();
+	if(vd.dataSize() == 0 && vd.isUploaded())
+		vd.download();
+}
+
+//! ---|> MeshDataStrategy
+void AsyncMeshDataStrategy::assureLocalIndexData(Mesh * m){
+	MeshIndexData & id = m->_getIndexData();
+	if(id.dataSize() == 0 && id.isUploaded())
+		id.download();
+}
+
+//! ---|> MeshDataStrategy
+void AsyncMeshDataStrategy::prepare(Mesh * m){
+	Entry & entry = entries[m];
+	MeshVertexData & vd = m->_getVertexData();
+	MeshIndexData & id = m->_getIndexData();
+	if(entry.prepared && entry.vertexRevision == vd.getRevision() && entry.indexRevision == id.getRevision())
+		return;
+	if(!stagingRing)
+		stagingRing.reset(new StagingRing(stagingCapacity, bytesPerFrame, workerCount));
+	cancelUploads(entry);
+	entry.prepared = true;
+	entry.vertexRevision = vd.getRevision();
+	entry.indexRevision = id.getRevision();
+
+	// without local data, the mesh uses its existing buffers (e.g. uploaded by another strategy)
+	if(!vd.empty() && vd.hasLocalData()) {
+		const uint8_t * source = vd.data();
+		entry.vertexBuffer.allocateData<uint8_t>(GL_ARRAY_BUFFER, vd.dataSize(), GL_STATIC_DRAW);
+		entry.vertexTransfer = stagingRing->enqueue(entry.vertexBuffer, 0, vd.dataSize(),
+				[source](uint8_t * destination, size_t offset, size_t size) {	std::copy(source + offset, source + offset + size, destination);	},
+				[this, m]() {	uploadComplete(m);	});
+		++entry.pendingTransfers;
+	}
+	if(!id.empty() && id.hasLocalData()) {
+		const uint8_t * source = reinterpret_cast<const uint8_t *>(id.data());
+		entry.indexBuffer.allocateData<uint8_t>(GL_ELEMENT_ARRAY_BUFFER, id.dataSize(), GL_STATIC_DRAW);
+		entry.indexTransfer = stagingRing->enqueue(entry.indexBuffer, 0, id.dataSize(),
+				[source](uint8_t * destination, size_t offset, size_t size) {	std::copy(source + offset, source + offset + size, destination);	},
+				[this, m]() {	uploadComplete(m);	});
+		++entry.pendingTransfers;
+	}
+}
+
+//! ---|> MeshDataStrategy
+void AsyncMeshDataStrategy::displayMesh(RenderingContext & context, Mesh * m,uint32_t startIndex,uint32_t indexCount){
+	const auto it = entries.find(m);
+	if(m->empty() || it == entries.end() || !it->second.prepared)
+		return;
+	// until the fences of the pending uploads have signaled, the previous buffers are drawn
+	if(it->second.pendingTransfers == 0 || canDisplayPreviousBuffers(m, it->second))
+		MeshDataStrategy::doDisplayMesh(context, m, startIndex, indexCount);
+}
+
+//! ---|> MeshDataStrategy
+void AsyncMeshDataStrategy::releaseMesh(Mesh * m, bool /*destroyed*/){
+	const auto it = entries.find(m);
+	if(it == entries.end())
+		return;
+	// the local data is kept until the uploads are complete
+	if(stagingRing)
+		cancelUploads(it->second);
+	entries.erase(it);
+}
+
+}
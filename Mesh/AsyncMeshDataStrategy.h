@@ -0,0 +1,99 @@
+/*
+ This file is part of the Rendering library.
+ Copyright (C) 2026 agent <agent@local>
+
+ This library is subject to the terms of the Mozilla Public License, v. 2.0.
+ You should have received a copy of the MPL along with this library; see the
+ file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef RENDERING_MESH_ASYNCMESHDATASTRATEGY_H_
+#define RENDERING_MESH_ASYNCMESHDATASTRATEGY_H_
+
+#include "MeshDataStrategy.h"
+#include "../BufferObject.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+
+namespace Rendering {
+class StagingRing;
+class VertexDescription;
+
+/*!	AsyncMeshDataStrategy ---|> MeshDataStrategy
+	Uploads the data of the meshes asynchronously through a StagingRing instead of uploading it when a mesh is
+	displayed the first time. A mesh is not drawn until its first upload is complete; while a changed mesh is
+	uploaded again, its previous buffers are drawn, unless the number or range of its vertices or indices has
+	changed. update() has to be called once per frame to advance the uploads.
+
+	\note The local data of a mesh must not be changed while its upload is pending (see isReady()); changes
+		marked afterwards (MeshVertexData::markAsChanged()) start a new upload.
+	@ingroup mesh
+*/
+class AsyncMeshDataStrategy : public MeshDataStrategy {
+	public:
+		//! Keep a copy of the data in main memory after the upload.
+		static const uint8_t PRESERVE_LOCAL_DATA = 1<<0;
+
+		const uint8_t flags;
+		inline bool getFlag(const uint8_t f)const	{	return flags&f;	}
+
+		/*! @param stagingCapacity, bytesPerFrame, workerCount Parameters of the StagingRing, which is created
+				when the first mesh is prepared. */
+		explicit AsyncMeshDataStrategy(uint8_t flags = 0, size_t stagingCapacity = 8 * 1024 * 1024,
+									   size_t bytesPerFrame = 2 * 1024 * 1024, uint32_t workerCount = 1);
+		virtual ~AsyncMeshDataStrategy();
+
+		void assureLocalVertexData(Mesh * m) override;
+		void assureLocalIndexData(Mesh * m) override;
+		void prepare(Mesh * m) override;
+		void displayMesh(RenderingContext & context, Mesh * m,uint32_t startIndex,uint32_t indexCount) override;
+		void releaseMesh(Mesh * m, bool destroyed) override;
+
+		//! Advance the uploads (see StagingRing::update()); has to be called once per frame in the gl-thread.
+		void update();
+		//! Return true if the mesh has been prepared and its upload is complete.
+		bool isReady(Mesh * m) const;
+		//! Number of meshes whose upload is pending.
+		size_t getPendingMeshCount() const;
+		//! The ring used for the uploads, or nullptr if no mesh has been prepared yet.
+		StagingRing * getStagingRing() const		{	return stagingRing.get();	}
+
+	private:
+		struct Entry {
+			//! Targets of the pending uploads; swapped into the mesh when the uploads are complete
+			BufferObject vertexBuffer;
+			BufferObject indexBuffer;
+			uint32_t vertexTransfer;
+			uint32_t indexTransfer;
+			uint32_t pendingTransfers;
+			//! Revisions of the uploaded data (see MeshVertexData::getRevision())
+			uint64_t vertexRevision;
+			uint64_t indexRevision;
+			//! Layout of the data in the mesh's buffers after the last complete upload
+			const VertexDescription * uploadedDescription;
+			uint32_t uploadedVertexCount;
+			uint32_t uploadedIndexCount;
+			uint32_t uploadedMinIndex;
+			uint32_t uploadedMaxIndex;
+			bool prepared;
+
+			Entry();
+		};
+
+		const size_t stagingCapacity;
+		const size_t bytesPerFrame;
+		const uint32_t workerCount;
+		std::unique_ptr<StagingRing> stagingRing;
+		std::unordered_map<Mesh *, Entry> entries;
+
+		void cancelUploads(Entry & entry);
+		void uploadComplete(Mesh * m);
+		bool canDisplayPreviousBuffers(Mesh * m, const Entry & entry) const;
+};
+
+}
+
+#endif /* RENDERING_MESH_ASYNCMESHDATASTRATEGY_H_ */
@@ -0,0 +1,415 @@
+/*
+ This file is part of the Rendering library.
+ Copyright (C) 2026 agent <agent@local>
+
+ This library is subject to the terms of the Mozilla Public License, v. 2.0.
+ You should have received a copy of the MPL along with this library; see the
+ file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "BudgetedMeshDataStrategy.h"
+#include "Mesh.h"
+#include "MeshIndexData.h"
+#include "MeshVertexData.h"
+#include "VertexDescription.h"
+#include "../GLHeader.h"
+#include "../Serialization/Serialization.h"
+#include <Geometry/Box.h>
+#include <Geometry/Matrix4x4.h>
+#include <Util/IO/FileName.h>
+#include <Util/Macros.h>
+#include <Util/References.h>
+#include <algorithm>
+#include <utility>
+
+namespace Rendering {
+
+/*! (internal) Lossless compression of mesh data: every byte is replaced by its difference to the same byte of
+	the previous element (vertex or index), and the resulting runs of zeros are run-length encoded as
+	[literal count][literal bytes][zero count]... with variable length counts. */
+static void writeCount(std::vector<uint8_t> & out, size_t count) {
+	while(count >= 0x80) {
+		out.push_back(static_cast<uint8_t>(count | 0x80));
+		count >>= 7;
+	}
+	out.push_back(static_cast<uint8_t>(count));
+}
+
+static size_t readCount(const uint8_t * & cursor, const uint8_t * end) {
+	size_t count = 0;
+	for(uint32_t shift = 0; cursor != end; shift += 7) {
+		const uint8_t byte = *cursor++;
+		count |= static_cast<size_t>(byte & 0x7f) << shift;
+		if((byte & 0x80) == 0)
+			break;
+	}
+	return count;
+}
+
+static std::vector<uint8_t> compressData(const uint8_t * data, size_t size, size_t stride) {
+	std::vector<uint8_t> deltas(data, data + size);
+	for(size_t i = stride; i < size; ++i)
+		deltas[i] = static_cast<uint8_t>(data[i] - data[i - stride]);
+
+	std::vector<uint8_t> out;
+	size_t i = 0;
+	while(i < size) {
+		// single zeros are cheaper as literals
+		size_t literalEnd = i;
+		while(literalEnd < size && !(deltas[literalEnd] == 0 && literalEnd + 1 < size && deltas[literalEnd + 1] == 0))
+			++literalEnd;
+		size_t zeroEnd = literalEnd;
+		while(zeroEnd < size && deltas[zeroEnd] == 0)
+			++zeroEnd;
+		writeCount(out, literalEnd - i);
+		out.insert(out.end(), deltas.begin() + i, deltas.begin() + literalEnd);
+		writeCount(out, zeroEnd - literalEnd);
+		i = zeroEnd;
+	}
+	out.shrink_to_fit();
+	return out;
+}
+
+static void decompressData(const std::vector<uint8_t> & compressed, uint8_t * data, size_t size, size_t stride) {
+	const uint8_t * cursor = compressed.data();
+	const uint8_t * end = cursor + compressed.size();
+	size_t i = 0;
+	while(i < size && cursor != end) {
+		const size_t literalCount = std::min(readCount(cursor, end), std::min(size - i, static_cast<size_t>(end - cursor)));
+		std::copy(cursor, cursor + literalCount, data + i);
+		cursor += literalCount;
+		i += literalCount;
+		const size_t zeroCount = std::min(readCount(cursor, end), size - i);
+		std::fill(data + i, data + i + zeroCount, 0);
+		i += zeroCount;
+	}
+	for(i = stride; i < size; ++i)
+		data[i] = static_cast<uint8_t>(data[i] + data[i - stride]);
+}
+
+// -------------------------------------------------------------------
+
+//! (internal) Backend storing the data in the buffer objects of the meshes.
+class BudgetedMeshDataStrategy::BufferObjectBackend : public BudgetedMeshDataStrategy::Backend {
+	public:
+		size_t upload(Mesh * m) override {
+			MeshVertexData & vd = m->_getVertexData();
+			MeshIndexData & id = m->_getIndexData();
+			if(!vd.empty())
+				vd.upload(GL_STATIC_DRAW);
+			if(!id.empty())
+				id.upload(GL_STATIC_DRAW);
+			return m->getGraphicsMemoryUsage();
+		}
+		void download(Mesh * m) override {
+			MeshVertexData & vd = m->_getVertexData();
+			MeshIndexData & id = m->_getIndexData();
+			if(!vd.hasLocalData() && vd.isUploaded())
+				vd.download();
+			if(!id.hasLocalData() && id.isUploaded())
+				id.download();
+		}
+		void release(Mesh * m) override {
+			m->_getVertexData().removeGlBuffer();
+			m->_getIndexData().removeGlBuffer();
+		}
+		void display(RenderingContext & context, Mesh * m, uint32_t firstElement, uint32_t elementCount) override {
+			doDisplayMesh(context, m, firstElement, elementCount);
+		}
+};
+
+//! (static)
+std::unique_ptr<BudgetedMeshDataStrategy::Backend> BudgetedMeshDataStrategy::createBufferObjectBackend() {
+	return std::unique_ptr<Backend>(new BufferObjectBackend);
+}
+
+// -------------------------------------------------------------------
+
+BudgetedMeshDataStrategy::BudgetedMeshDataStrategy(size_t _budget, uint8_t _flags, std::unique_ptr<Backend> _backend, MeshLoader_t _loader) :
+		MeshDataStrategy(true), flags(_flags), budget(_budget), backend(_backend ? std::move(_backend) : createBufferObjectBackend()),
+		loader(_loader ? std::move(_loader) : MeshLoader_t(static_cast<Mesh * (*)(const Util::FileName &)>(&Serialization::loadMesh))),
+		residentBytes(0), frameNumber(0) {
+}
+
+BudgetedMeshDataStrategy::~BudgetedMeshDataStrategy() {
+	// restore the local data of the meshes before the backend is destroyed
+	detachMeshes();
+}
+
+//! ---|> MeshDataStrategy
+void BudgetedMeshDataStrategy::meshAttached(Mesh * m) {
+	recordOriginalData(m);
+}
+
+//! ---|> MeshDataStrategy
+void BudgetedMeshDataStrategy::fileNameAssigned(Mesh * m) {
+	recordOriginalData(m);
+}
+
+/*! (internal) Regard the current local data of a mesh as its original data (the content of its file), so that
+	changes made before the first upload are detected. Uploaded data is not touched. */
+void BudgetedMeshDataStrategy::recordOriginalData(Mesh * m) {
+	const MeshVertexData & vd = m->_getVertexData();
+	const MeshIndexData & id = m->_getIndexData();
+	if(m->empty() || !(vd.empty() || vd.hasLocalData()) || !(id.empty() || id.hasLocalData()))
+		return;
+	Entry & entry = entries[m];
+	if(entry.resident || entry.storage != Storage::MESH)
+		return;
+	entry.modified = false;
+	entry.vertexRevision = vd.getRevision();
+	entry.indexRevision = id.getRevision();
+}
+
+//! (internal)
+BudgetedMeshDataStrategy::Entry & BudgetedMeshDataStrategy::getEntry(Mesh * m) {
+	const MeshVertexData & vd = m->_getVertexData();
+	const MeshIndexData & id = m->_getIndexData();
+	const auto inserted = entries.emplace(m, Entry());
+	Entry & entry = inserted.first->second;
+	if(inserted.second && (vd.empty() || vd.hasLocalData()) && (id.empty() || id.hasLocalData())) {
+		/* The mesh has got its data after it was assigned to the strategy, without a file name being set
+		   afterwards; whether the data matches the mesh's file is unknown. */
+		entry.vertexRevision = vd.getRevision();
+		entry.indexRevision = id.getRevision();
+		entry.modified = true;
+	} else if( (entry.vertexRevision != vd.getRevision() && !vd.hasLocalData()) || (entry.indexRevision != id.getRevision() && !id.hasLocalData()) ) {
+		// the data has been swapped or moved from another mesh (e.g. by Mesh::swap(...)); take over its entry
+		for(auto & other : entries) {
+			if(other.first != m && other.second.vertexRevision == vd.getRevision() && other.second.indexRevision == id.getRevision()) {
+				std::swap(entry, other.second);
+				if(entry.resident)
+					*entry.lruPosition = m;
+				if(other.second.resident)
+					*other.second.lruPosition = other.first;
+				break;
+			}
+		}
+	}
+	return entry;
+}
+
+bool BudgetedMeshDataStrategy::isResident(Mesh * m) const {
+	const auto it = entries.find(m);
+	return it != entries.end() && it->second.resident;
+}
+
+size_t BudgetedMeshDataStrategy::getCompressedBytes() const {
+	size_t bytes = 0;
+	for(const auto & entry : entries)
+		bytes += entry.second.compressedVertices.size() + entry.second.compressedIndices.size();
+	return bytes;
+}
+
+//! (internal) Download the data of the mesh from graphics memory, if it is not available locally.
+void BudgetedMeshDataStrategy::download(Mesh * m, Entry & entry) {
+	const MeshVertexData & vd = m->_getVertexData();
+	const MeshIndexData & id = m->_getIndexData();
+	const bool upToDate = entry.vertexRevision == vd.getRevision() && entry.indexRevision == id.getRevision();
+	backend->download(m);
+	if(upToDate) { // the backend may assign new revisions to the downloaded data
+		entry.vertexRevision = vd.getRevision();
+		entry.indexRevision = id.getRevision();
+	}
+}
+
+//! (internal) Make the data of the mesh locally available.
+void BudgetedMeshDataStrategy::restoreLocalData(Mesh * m, Entry & entry) {
+	MeshVertexData & vd = m->_getVertexData();
+	MeshIndexData & id = m->_getIndexData();
+	switch(entry.storage) {
+		case Storage::MESH:
+			download(m, entry);
+			return;
+		case Storage::COMPRESSED: {
+			if(!vd.empty()) {
+				// allocate() resets the quantization
+				std::unique_ptr<Geometry::Matrix4x4> dequantization;
+				if(vd.getPositionDequantization() != nullptr)
+					dequantization.reset(new Geometry::Matrix4x4(*vd.getPositionDequantization()));
+				const Geometry::Box boundingBox = vd.getBoundingBox();
+				vd.allocate(vd.getVertexCount(), vd.getVertexDescription());
+				decompressData(entry.compressedVertices, vd.data(), vd.dataSize(), vd.getVertexDescription().getVertexSize());
+				if(dequantization)
+					vd.setPositionDequantization(*dequantization);
+				vd._setBoundingBox(boundingBox);
+			}
+			if(!id.empty()) {
+				id.allocate(id.getIndexCount());
+				decompressData(entry.compressedIndices, reinterpret_cast<uint8_t *>(id.data()), id.dataSize(), sizeof(uint32_t));
+				id.updateIndexRange();
+			}
+			std::vector<uint8_t>().swap(entry.compressedVertices);
+			std::vector<uint8_t>().swap(entry.compressedIndices);
+			break;
+		}
+		case Storage::FILE_NAME: {
+			Util::Reference<Mesh> loadedMesh = loader(m->getFileName());
+			if(loadedMesh.isNull() || loadedMesh->getVertexCount() != vd.getVertexCount() || loadedMesh->_getIndexData().getIndexCount() != id.getIndexCount()
+					|| !(loadedMesh->getVertexDescription() == vd.getVertexDescription())) {
+				WARN("BudgetedMeshDataStrategy: Could not reload the mesh from '" + m->getFileName().toString() + "'.");
+				return;
+			}
+			loadedMesh->openVertexData();
+			loadedMesh->openIndexData();
+			vd.swap(loadedMesh->_getVertexData());
+			id.swap(loadedMesh->_getIndexData());
+			break;
+		}
+	}
+	entry.storage = Storage::MESH;
+	// the restored data is equal to the uploaded data
+	entry.vertexRevision = vd.getRevision();
+	entry.indexRevision = id.getRevision();
+	++frameStatistics.restores;
+}
+
+//! (internal) Remove the mesh from graphics memory.
+bool BudgetedMeshDataStrategy::evict(Mesh * m, Entry & entry) {
+	MeshVertexData & vd = m->_getVertexData();
+	MeshIndexData & id = m->_getIndexData();
+	const bool reload = getFlag(RELOAD_FROM_FILE) && !entry.modified && !m->getFileName().empty();
+	if(!reload) {
+		download(m, entry);
+		if( (!vd.empty() && !vd.hasLocalData()) || (!id.empty() && !id.hasLocalData()) ) {
+			WARN("BudgetedMeshDataStrategy: Could not download the mesh data; the mesh is not evicted.");
+			return false;
+		}
+	}
+	backend->release(m);
+	residentBytes -= entry.residentBytes;
+	++frameStatistics.evictions;
+	frameStatistics.evictedBytes += entry.residentBytes;
+	entry.residentBytes = 0;
+	entry.resident = false;
+	lruList.erase(entry.lruPosition);
+
+	if(reload) {
+		vd.releaseLocalData();
+		id.releaseLocalData();
+		entry.storage = Storage::FILE_NAME;
+	} else if(getFlag(COMPRESS_EVICTED_DATA)) {
+		if(!vd.empty())
+			entry.compressedVertices = compressData(vd.data(), vd.dataSize(), vd.getVertexDescription().getVertexSize());
+		if(!id.empty())
+			entry.compressedIndices = compressData(reinterpret_cast<const uint8_t *>(id.data()), id.dataSize(), sizeof(uint32_t));
+		vd.releaseLocalData();
+		id.releaseLocalData();
+		entry.storage = Storage::COMPRESSED;
+	}
+	return true;
+}
+
+//! (internal) Evict the least recently displayed meshes until the budget is met.
+void BudgetedMeshDataStrategy::enforceBudget() {
+	while(residentBytes > budget && !lruList.empty()) {
+		Mesh * m = lruList.back();
+		Entry & entry = entries.at(m);
+		// all remaining meshes have been displayed in the current frame
+		if(entry.lastFrame == frameNumber || !evict(m, entry))
+			break;
+	}
+	updateResidentStatistics();
+}
+
+//! (internal)
+void BudgetedMeshDataStrategy::updateResidentStatistics() {
+	frameStatistics.residentBytes = residentBytes;
+	frameStatistics.residentMeshes = static_cast<uint32_t>(lruList.size());
+}
+
+void BudgetedMeshDataStrategy::beginFrame() {
+	updateResidentStatistics();
+	lastFrameStatistics = frameStatistics;
+	frameStatistics = FrameStatistics();
+	++frameNumber;
+	enforceBudget();
+}
+
+void BudgetedMeshDataStrategy::setBudget(size_t _budget) {
+	budget = _budget;
+	enforceBudget();
+}
+
+//! ---|> MeshDataStrategy
+void BudgetedMeshDataStrategy::assureLocalVertexData(Mesh * m){
+	const MeshVertexData & vd = m->_getVertexData();
+	if(vd.empty() || vd.hasLocalData())
+		return;
+	if(entries.count(m) == 0)
+		backend->download(m);
+	else
+		restoreLocalData(m, getEntry(m));
+}
+
+//! ---|> MeshDataStrategy
+void BudgetedMeshDataStrategy::assureLocalIndexData(Mesh * m){
+	const MeshIndexData & id = m->_getIndexData();
+	if(id.empty() || id.hasLocalData())
+		return;
+	if(entries.count(m) == 0)
+		backend->download(m);
+	else
+		restoreLocalData(m, getEntry(m));
+}
+
+//! ---|> MeshDataStrategy
+void BudgetedMeshDataStrategy::prepare(Mesh * m){
+	Entry & entry = getEntry(m);
+	entry.lastFrame = frameNumber;
+	MeshVertexData & vd = m->_getVertexData();
+	MeshIndexData & id = m->_getIndexData();
+	const bool changed = entry.vertexRevision != vd.getRevision() || entry.indexRevision != id.getRevision();
+	if(entry.resident) {
+		lruList.splice(lruList.begin(), lruList, entry.lruPosition);
+		if(!changed)
+			return;
+		residentBytes -= entry.residentBytes;
+	} else {
+		restoreLocalData(m, entry);
+	}
+	if(changed)
+		entry.modified = true;
+
+	entry.residentBytes = backend->upload(m);
+	entry.vertexRevision = vd.getRevision();
+	entry.indexRevision = id.getRevision();
+	residentBytes += entry.residentBytes;
+	++frameStatistics.uploads;
+	frameStatistics.uploadedBytes += entry.residentBytes;
+	if(!entry.resident) {
+		entry.resident = true;
+		entry.lruPosition = lruList.insert(lruList.begin(), m);
+	}
+	if(!getFlag(PRESERVE_LOCAL_DATA) && entry.residentBytes > 0) {
+		vd.releaseLocalData();
+		id.releaseLocalData();
+	}
+	enforceBudget();
+}
+
+//! ---|> MeshDataStrategy
+void BudgetedMeshDataStrategy::displayMesh(RenderingContext & context, Mesh * m,uint32_t startIndex,uint32_t indexCount){
+	const auto it = entries.find(m);
+	if(!m->empty() && it != entries.end() && it->second.resident)
+		backend->display(context, m, startIndex, indexCount);
+}
+
+//! ---|> MeshDataStrategy
+void BudgetedMeshDataStrategy::releaseMesh(Mesh * m, bool destroyed){
+	const auto it = entries.find(m);
+	if(it == entries.end())
+		return;
+	Entry & entry = it->second;
+	if(!destroyed)
+		restoreLocalData(m, entry);
+	if(entry.resident) {
+		backend->release(m);
+		residentBytes -= entry.residentBytes;
+		lruList.erase(entry.lruPosition);
+	}
+	entries.erase(it);
+	updateResidentStatistics();
+}
+
+}
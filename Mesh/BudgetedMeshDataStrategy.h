@@ -0,0 +1,173 @@
+/*
+ This file is part of the Rendering library.
+ Copyright (C) 2026 agent <agent@local>
+
+ This library is subject to the terms of the Mozilla Public License, v. 2.0.
+ You should have received a copy of the MPL along with this library; see the
+ file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef RENDERING_MESH_BUDGETEDMESHDATASTRATEGY_H_
+#define RENDERING_MESH_BUDGETEDMESHDATASTRATEGY_H_
+
+#include "MeshDataStrategy.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace Util {
+class FileName;
+}
+namespace Rendering {
+
+/*!	BudgetedMeshDataStrategy ---|> MeshDataStrategy
+	Keeps the graphics memory used by its meshes below a budget. The meshes are uploaded when they are displayed;
+	if the budget is exceeded, the least recently displayed meshes are evicted from graphics memory. The data of
+	an evicted mesh is kept in main memory (optionally compressed) or, if enabled, read again from the mesh's
+	file; it is restored and uploaded again when the mesh is displayed the next time.
+
+	Meshes displayed in the current frame (see beginFrame()) are not evicted, so the budget may be exceeded
+	if a single frame uses more memory.
+	@ingroup mesh
+*/
+class BudgetedMeshDataStrategy : public MeshDataStrategy {
+	public:
+		//! Transfers the data of the meshes between main memory and graphics memory.
+		class Backend {
+			public:
+				virtual ~Backend() {}
+				//! Upload the local data of the mesh and return the number of bytes used in graphics memory.
+				virtual size_t upload(Mesh * m) = 0;
+				//! Copy the data from graphics memory into local memory, if it is not available locally.
+				virtual void download(Mesh * m) = 0;
+				//! Release the graphics memory used by the mesh.
+				virtual void release(Mesh * m) = 0;
+				virtual void display(RenderingContext & context, Mesh * m, uint32_t firstElement, uint32_t elementCount) = 0;
+		};
+
+		/*! Backend storing the data in the buffer objects of the meshes (with static usage).
+			@note Uses OpenGL and must only be used in the gl-thread. */
+		static std::unique_ptr<Backend> createBufferObjectBackend();
+
+		//! Loads a mesh from a file; used to restore evicted meshes (see RELOAD_FROM_FILE).
+		typedef std::function<Mesh * (const Util::FileName &)> MeshLoader_t;
+
+		//! Keep a copy of the data in main memory while the mesh is uploaded.
+		static const uint8_t PRESERVE_LOCAL_DATA = 1<<0;
+		//! Compress the data of evicted meshes kept in main memory.
+		static const uint8_t COMPRESS_EVICTED_DATA = 1<<1;
+		/*! Release the data of evicted meshes having a file name (see Mesh::getFileName()) and load it from the
+			file when it is needed again. The data of a mesh is regarded as the content of its file when the mesh is
+			assigned to the strategy (e.g. as default strategy after Mesh(desc, vertexCount, indexCount) has allocated
+			its data) or when its file name is set (e.g. by Serialization::loadMesh() after loading). Meshes whose
+			data has been changed afterwards, and meshes that were empty then, are kept. */
+		static const uint8_t RELOAD_FROM_FILE = 1<<2;
+
+		const uint8_t flags;
+		inline bool getFlag(const uint8_t f)const	{	return flags&f;	}
+
+		//! Number of transfers and the used graphics memory of a frame.
+		struct FrameStatistics {
+			uint32_t uploads;
+			size_t uploadedBytes;
+			uint32_t evictions;
+			size_t evictedBytes;
+			//! Evicted meshes whose local data has been restored (decompressed or loaded from file)
+			uint32_t restores;
+			//! Graphics memory used at the end of the frame
+			size_t residentBytes;
+			uint32_t residentMeshes;
+
+			FrameStatistics() : uploads(0), uploadedBytes(0), evictions(0), evictedBytes(0), restores(0), residentBytes(0), residentMeshes(0) {}
+		};
+
+		/*! @param budget Graphics memory in bytes available for the meshes.
+			@param backend If null, the data is stored in the meshes' buffer objects.
+			@param loader Used for RELOAD_FROM_FILE; if empty, Serialization::loadMesh is used. */
+		BudgetedMeshDataStrategy(size_t budget, uint8_t flags = COMPRESS_EVICTED_DATA,
+								 std::unique_ptr<Backend> backend = nullptr, MeshLoader_t loader = MeshLoader_t());
+		virtual ~BudgetedMeshDataStrategy();
+
+		void assureLocalVertexData(Mesh * m) override;
+		void assureLocalIndexData(Mesh * m) override;
+		void prepare(Mesh * m) override;
+		void displayMesh(RenderingContext & context, Mesh * m,uint32_t startIndex,uint32_t indexCount) override;
+		void releaseMesh(Mesh * m, bool destroyed) override;
+
+		/*! Start a new frame: meshes displayed before may be evicted again and the statistics of the last frame
+			are stored (see getLastFrameStatistics()). */
+		void beginFrame();
+		const FrameStatistics & getFrameStatistics() const		{	return frameStatistics;	}
+		const FrameStatistics & getLastFrameStatistics() const	{	return lastFrameStatistics;	}
+
+		//! Set the budget; meshes are evicted immediately if it is exceeded.
+		void setBudget(size_t budget);
+		size_t getBudget() const					{	return budget;	}
+		//! Graphics memory used by all uploaded meshes.
+		size_t getResidentBytes() const				{	return residentBytes;	}
+		//! Number of meshes managed by the strategy.
+		size_t getMeshCount() const					{	return entries.size();	}
+		bool isResident(Mesh * m) const;
+		//! Main memory used by the compressed data of evicted meshes.
+		size_t getCompressedBytes() const;
+
+	private:
+		class BufferObjectBackend;
+
+		enum class Storage : uint8_t {
+			//! The local data of the mesh (or the graphics memory) contains the data
+			MESH,
+			//! The data has been compressed into the entry
+			COMPRESSED,
+			//! The data has to be loaded from the mesh's file
+			FILE_NAME
+		};
+		struct Entry {
+			//! Position in lruList; only valid if the mesh is resident
+			std::list<Mesh *>::iterator lruPosition;
+			bool resident;
+			//! The data has been changed after the mesh has been seen the first time, so it can not be loaded from file
+			bool modified;
+			Storage storage;
+			uint32_t lastFrame;
+			size_t residentBytes;
+			//! Revisions of the uploaded data (see MeshVertexData::getRevision())
+			uint64_t vertexRevision;
+			uint64_t indexRevision;
+			std::vector<uint8_t> compressedVertices;
+			std::vector<uint8_t> compressedIndices;
+
+			Entry() : resident(false), modified(false), storage(Storage::MESH), lastFrame(0), residentBytes(0),
+					vertexRevision(0), indexRevision(0) {}
+		};
+
+		size_t budget;
+		const std::unique_ptr<Backend> backend;
+		const MeshLoader_t loader;
+		std::unordered_map<Mesh *, Entry> entries;
+		//! Resident meshes; the most recently displayed mesh is at the front
+		std::list<Mesh *> lruList;
+		size_t residentBytes;
+		uint32_t frameNumber;
+		FrameStatistics frameStatistics;
+		FrameStatistics lastFrameStatistics;
+
+		void meshAttached(Mesh * m) override;
+		void fileNameAssigned(Mesh * m) override;
+		void recordOriginalData(Mesh * m);
+		Entry & getEntry(Mesh * m);
+		void download(Mesh * m, Entry & entry);
+		void restoreLocalData(Mesh * m, Entry & entry);
+		bool evict(Mesh * m, Entry & entry);
+		void enforceBudget();
+		void updateResidentStatistics();
+};
+
+}
+
+#endif /* RENDERING_MESH_BUDGETEDMESHDATASTRATEGY_H_ */
@@ -26,17 +26,49 @@ static_assert(GL_TRIANGLES<256 && GL_LINES<256 && GL_POINTS<256 && GL_LINE_STRIP
 
 Mesh::Mesh() :
 		ReferenceCounter_t(), fileName(), dataStrategy(MeshDataStrategy::getDefaultStrategy()),drawMode(DRAW_TRIANGLES), useIndexData(true) {
+	dataStrategy->_attachMesh(this);
 }
 
 Mesh::Mesh(MeshIndexData meshIndexData, MeshVertexData meshVertexData) :
 		ReferenceCounter_t(), indexData(std::move(meshIndexData)), fileName(), vertexData(std::move(meshVertexData)), 
 		dataStrategy(MeshDataStrategy::getDefaultStrategy()), drawMode(DRAW_TRIANGLES), useIndexData(true) {
+	dataStrategy->_attachMesh(this);
 }
 
 Mesh::Mesh(const VertexDescription & desc, uint32_t vertexCount, uint32_t indexCount) :
 		ReferenceCounter_t(), fileName(), dataStrategy(MeshDataStrategy::getDefaultStrategy()), drawMode(DRAW_TRIANGLES), useIndexData(true) {
 	indexData.allocate(indexCount);
 	vertexData.allocate(vertexCount, desc);
+	dataStrategy->_attachMesh(this);
+}
+
+Mesh::Mesh(const Mesh & other) :
+		ReferenceCounter_t(), indexData(other.indexData), fileName(other.fileName), vertexData(other.vertexData),
+		dataStrategy(other.dataStrategy), drawMode(other.drawMode), triangleBVH(other.triangleBVH), clusters(other.clusters),
+		useIndexData(other.useIndexData) {
+	if(dataStrategy != nullptr)
+		dataStrategy->_attachMesh(this);
+}
+
+Mesh::Mesh(Mesh && other) :
+		ReferenceCounter_t(), indexData(std::move(other.indexData)), fileName(std::move(other.fileName)), vertexData(std::move(other.vertexData)),
+		dataStrategy(other.dataStrategy), drawMode(other.drawMode), triangleBVH(std::move(other.triangleBVH)), clusters(std::move(other.clusters)),
+		useIndexData(other.useIndexData) {
+	if(dataStrategy != nullptr)
+		dataStrategy->_attachMesh(this);
+}
+
+Mesh::~Mesh() {
+	if(dataStrategy != nullptr) {
+		dataStrategy->releaseMesh(this, true);
+		dataStrategy->_detachMesh(this);
+	}
+}
+
+void Mesh::setFileName(const Util::FileName & f) {
+	fileName = f;
+	if(dataStrategy != nullptr)
+		dataStrategy->_fileNameAssigned(this);
 }
 
 Mesh * Mesh::clone()const{
@@ -48,10 +80,22 @@ void Mesh::swap(Mesh & m){
 	_getVertexData().swap(m._getVertexData());
 
 	using std::swap;
-	swap(dataStrategy, m.dataStrategy);
+	if(dataStrategy != m.dataStrategy) {
+		if(dataStrategy != nullptr)
+			dataStrategy->_detachMesh(this);
+		if(m.dataStrategy != nullptr)
+			m.dataStrategy->_detachMesh(&m);
+		swap(dataStrategy, m.dataStrategy);
+		if(dataStrategy != nullptr)
+			dataStrategy->_attachMesh(this);
+		if(m.dataStrategy != nullptr)
+			m.dataStrategy->_attachMesh(&m);
+	}
 	swap(fileName, m.fileName);
 	swap(drawMode, m.drawMode);
 	swap(useIndexData, m.useIndexData);
+	swap(triangleBVH, m.triangleBVH);
+	swap(clusters, m.clusters);
 }
 
 size_t Mesh::getMainMemoryUsage() const {
@@ -99,7 +143,15 @@ MeshVertexData & Mesh::openVertexData(){
 }
 
 void Mesh::setDataStrategy(MeshDataStrategy * newStrategy) {
+	if(dataStrategy == newStrategy)
+		return;
+	if(dataStrategy != nullptr) {
+		dataStrategy->releaseMesh(this, false);
+		dataStrategy->_detachMesh(this);
+	}
 	dataStrategy = newStrategy;
+	if(dataStrategy != nullptr)
+		dataStrategy->_attachMesh(this);
 }
 
 uint32_t Mesh::getGLDrawMode() const {
@@ -18,6 +18,7 @@
 #include <Util/IO/FileName.h>
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 
 namespace Geometry {
 template<typename value_t> class _Box;
@@ -29,6 +30,10 @@ namespace Rendering{
 class MeshDataStrategy;
 class VertexDescription;
 class RenderingContext;
+namespace MeshUtils {
+class MeshClusters;
+class TriangleBVH;
+}
 
 //! @addtogroup rendering_resources
 //! @{
@@ -75,8 +80,9 @@ class Mesh : public Util::ReferenceCounter<Mesh> {
 		Mesh();
 		Mesh(MeshIndexData meshIndexData, MeshVertexData meshVertexData);
 		Mesh(const VertexDescription & desc,uint32_t vertexCount,uint32_t indexCount);
-		Mesh(const Mesh &) = default;
-		Mesh(Mesh &&) = default;
+		Mesh(const Mesh & other);
+		Mesh(Mesh && other);
+		~Mesh();
 
 		Mesh* clone()const;
 
@@ -158,7 +164,9 @@ class Mesh : public Util::ReferenceCounter<Mesh> {
 	// @{
 	public:
 		const Util::FileName & getFileName() const				{	return fileName;	}
-		void setFileName(const Util::FileName & f)				{	fileName=f;			}
+		/*! Set the file the mesh has been loaded from; loaders call this after loading the data
+			(see MeshDataStrategy::fileNameAssigned()). */
+		void setFileName(const Util::FileName & f);
 
 	private:
 		Util::FileName fileName;
@@ -252,7 +260,28 @@ class Mesh : public Util::ReferenceCounter<Mesh> {
 		 */
 		void setGLDrawMode(uint32_t glDrawMode);
 	// @}
-	
+
+	/*!	@name Ray queries */
+	// @{
+	public:
+		/*! (internal) Cached bounding volume hierarchy of the triangles.
+			\note Use MeshUtils::TriangleBVH::get(mesh), which checks if the cache is still valid.	*/
+		std::shared_ptr<const MeshUtils::TriangleBVH> & _getTriangleBVHCache()	{	return triangleBVH;	}
+
+	private:
+		std::shared_ptr<const MeshUtils::TriangleBVH> triangleBVH;
+	// @}
+
+	/*!	@name Clusters */
+	// @{
+	public:
+		/*! (internal) Clusters of triangles with culling bounds.
+			\note Use MeshUtils::MeshClusters::get(mesh), which checks if the clusters are still valid.	*/
+		std::shared_ptr<const MeshUtils::MeshClusters> & _getClusterCache()	{	return clusters;	}
+
+	private:
+		std::shared_ptr<const MeshUtils::MeshClusters> clusters;
+	// @}
 	
 	private:
 		bool useIndexData; //! (located at this position to save memory due to padding)
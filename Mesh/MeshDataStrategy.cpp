@@ -37,6 +37,20 @@ void MeshDataStrategy::setDefaultStrategy(MeshDataStrategy * newDefault){
 
 // -------------
 
+MeshDataStrategy::~MeshDataStrategy() {
+	detachMeshes();
+}
+
+void MeshDataStrategy::detachMeshes() {
+	if(defaultStrategy == this)
+		defaultStrategy = nullptr;
+	MeshDataStrategy * fallback = getDefaultStrategy();
+	if(fallback == this)
+		return;
+	while(!meshes.empty())
+		(*meshes.begin())->setDataStrategy(fallback);
+}
+
 //! (static,internal)
 void MeshDataStrategy::doDisplayMesh(RenderingContext & context, Mesh * m,uint32_t startIndex,uint32_t indexCount){
 	if(m->isUsingIndexData()){
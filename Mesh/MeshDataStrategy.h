@@ -12,6 +12,7 @@
 #define MESHDATASTRATEGY_H
 
 #include <cstdint>
+#include <unordered_set>
 
 namespace Rendering{
 
@@ -24,6 +25,7 @@ class RenderingContext;
 	(e.g. with a more sophisticated memory management) can use this class as a base.
 
 	\note All instances of this class should be created only once and re-used (they are probably never deleted)
+	\note Strategies that keep track of their meshes reset them to the default strategy when they are destroyed.
 	\note If a mesh does not have a data-strategy, the default strategy is used.
 	\note If an implementation does make use of gl-calls, be carefull if the
 		mesh is accesed from a non-gl-thread. 
@@ -39,8 +41,8 @@ class MeshDataStrategy {
 		// --------------------------------------
 
 	public:
-		MeshDataStrategy(){}
-		virtual ~MeshDataStrategy(){}
+		MeshDataStrategy() : trackMeshes(false) {}
+		virtual ~MeshDataStrategy();
 
 		/*! If the Mesh has vertex data, assure that it can be accessed locally
 			(e.g. by downloading it from graphics memory)
@@ -59,11 +61,52 @@ class MeshDataStrategy {
 		/*! Display the mesh as VBO or VertexArray.
 			---o	*/
 		virtual void displayMesh(RenderingContext & context, Mesh * m,uint32_t firstElement,uint32_t elementCount)=0;
+
+		/*! Called when the mesh is destroyed (@p destroyed is true) or gets another data strategy.
+			Strategies managing data per mesh (e.g. SharedBufferMeshDataStrategy) release it here; if the mesh
+			is not destroyed, its data has to stay accessible.
+			---o	*/
+		virtual void releaseMesh(Mesh * /*m*/, bool /*destroyed*/)	{}
+
+		//! (internal) Called by a mesh when it starts using this strategy.
+		void _attachMesh(Mesh * m) {
+			if(trackMeshes && meshes.insert(m).second)
+				meshAttached(m);
+		}
+		//! (internal) Called by a mesh when it stops using this strategy (after releaseMesh()).
+		void _detachMesh(Mesh * m)		{	if(trackMeshes) meshes.erase(m);	}
+		//! (internal) Called by Mesh::setFileName().
+		void _fileNameAssigned(Mesh * m) {
+			if(trackMeshes && meshes.count(m) > 0)
+				fileNameAssigned(m);
+		}
 		
 	protected:
+		/*! @param _trackMeshes Keep track of the meshes using the strategy, so that they can be reset to the default
+				strategy by detachMeshes(). Strategies managing data per mesh have to enable this. */
+		explicit MeshDataStrategy(bool _trackMeshes) : trackMeshes(_trackMeshes) {}
+
+		/*! Called when a mesh starts using this strategy (only if the strategy tracks its meshes).
+			---o	*/
+		virtual void meshAttached(Mesh * /*m*/)	{}
+
+		/*! Called when the file name of a mesh using this strategy is set (only if the strategy tracks its meshes).
+			Loaders (e.g. Serialization::loadMesh()) set the file name after loading, so the data of the mesh is
+			the content of the file at this point.
+			---o	*/
+		virtual void fileNameAssigned(Mesh * /*m*/)	{}
+
+		/*! Set the default strategy for all meshes using this strategy (see Mesh::setDataStrategy()), so that
+			releaseMesh() is called while the strategy still exists. Strategies tracking their meshes have to call
+			this in their destructor; if this strategy is the default strategy, the initial default is restored. */
+		void detachMeshes();
+
 		//! (internal) Actually bind the buffers and render the mesh.
 		static void doDisplayMesh(RenderingContext & context, Mesh * m,uint32_t firstElement,uint32_t elementCount);
 
+	private:
+		const bool trackMeshes;
+		std::unordered_set<Mesh *> meshes;
 };
 
 // -------------------------------------------------------------------
@@ -13,6 +13,7 @@
 #include "../Helper.h"
 #include <Util/Macros.h>
 #include <algorithm>
+#include <atomic>
 #include <limits>
 #include <stdexcept>
 #include <utility>
@@ -22,16 +23,17 @@ namespace Rendering {
 /*! (ctor)  */
 MeshIndexData::MeshIndexData() :
 			indexCount(0), minIndex(0), maxIndex(0),
-			bufferObject(), dataChanged(false) {
+			bufferObject(), dataChanged(false), revision(0) {
 }
 
 /*! (ctor)  */
 MeshIndexData::MeshIndexData(const MeshIndexData & other) :
 			indexCount(other.getIndexCount()), 
 			minIndex(other.getMinIndex()), maxIndex(other.getMaxIndex()),
-			bufferObject(), dataChanged(true) {
+			bufferObject(), dataChanged(false), revision(0) {
+	markAsChanged();
 	if(other.hasLocalData()) {
-		indexArray = other.indexArray;
+		indexArray.assign(other.data(), other.data() + other.getIndexCount());
 	} else if(other.isUploaded()) {
 		other.downloadTo(indexArray);
 	} else {
@@ -41,6 +43,7 @@ MeshIndexData::MeshIndexData(const MeshIndexData & other) :
 
 //!(internal)
 void MeshIndexData::releaseLocalData(){
+	sharedData.reset();
 	indexArray.clear();
 	indexArray.shrink_to_fit();
 }
@@ -55,22 +58,39 @@ void MeshIndexData::swap(MeshIndexData & other){
 	swap(maxIndex, other.maxIndex);
 	swap(bufferObject, other.bufferObject);
 	swap(dataChanged, other.dataChanged);
+	swap(revision, other.revision);
 	swap(indexArray, other.indexArray);
+	swap(sharedData, other.sharedData);
+}
+
+void MeshIndexData::markAsChanged() {
+	static std::atomic<uint64_t> revisionCounter(0);
+	dataChanged = true;
+	revision = ++revisionCounter;
 }
 
 void MeshIndexData::allocate(uint32_t count) {
 	indexCount = count;
+	sharedData.reset();
 	indexArray.resize(indexCount, std::numeric_limits<uint32_t>::max());
 	indexArray.shrink_to_fit();
 	markAsChanged();
 }
 
+void MeshIndexData::_setSharedData(uint32_t count, std::shared_ptr<uint32_t> newData) {
+	indexCount = newData ? count : 0;
+	indexArray.clear();
+	indexArray.shrink_to_fit();
+	sharedData = std::move(newData);
+	markAsChanged();
+}
+
 void MeshIndexData::updateIndexRange() {
-	if(indexArray.empty()) {
+	if(!hasLocalData() || indexCount == 0) {
 		minIndex = 1;
 		maxIndex = 0;
 	} else {
-		auto minMaxPair = std::minmax_element(indexArray.begin(), indexArray.end());
+		auto minMaxPair = std::minmax_element(data(), data() + indexCount);
 		minIndex = *minMaxPair.first;
 		maxIndex = *minMaxPair.second;
 	}
@@ -85,11 +105,11 @@ bool MeshIndexData::upload(uint32_t usageHint){
 	if( isUploaded() )
 		removeGlBuffer();
 
-	if(indexCount == 0 || indexArray.empty() )
+	if(indexCount == 0 || !hasLocalData() )
 		return false;
 
 	try {
-		bufferObject.uploadData(GL_ELEMENT_ARRAY_BUFFER, indexArray, usageHint);
+		bufferObject.uploadData(GL_ELEMENT_ARRAY_BUFFER, reinterpret_cast<const uint8_t *>(data()), dataSize(), usageHint);
 		GET_GL_ERROR()
 	}
 	catch (...) {
@@ -105,6 +125,7 @@ bool MeshIndexData::upload(uint32_t usageHint){
 bool MeshIndexData::download(){
 	if(!isUploaded() || indexCount==0)
 		return false;
+	sharedData.reset();
 	downloadTo(indexArray);
 	dataChanged = false;
 	return true;
@@ -14,6 +14,7 @@
 #include "../BufferObject.h"
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <vector>
 
 namespace Rendering {
@@ -40,16 +41,21 @@ class MeshIndexData {
 
 		// data
 		void allocate(uint32_t count);
+		//! Use @p data as local index data instead of allocating own memory (see MeshVertexData::_setSharedData()).
+		void _setSharedData(uint32_t count, std::shared_ptr<uint32_t> data);
 		void releaseLocalData();
-		const uint32_t * data() const						{	return indexArray.data();	}
-		uint32_t * data() 									{	return indexArray.data();	}
-		std::size_t dataSize() const						{	return indexArray.size() * sizeof(uint32_t);	}
-		void markAsChanged()								{  	dataChanged=true;	}
+		const uint32_t * data() const						{	return sharedData ? sharedData.get() : indexArray.data();	}
+		uint32_t * data() 									{	return sharedData ? sharedData.get() : indexArray.data();	}
+		std::size_t dataSize() const						{	return (sharedData ? indexCount : indexArray.size()) * sizeof(uint32_t);	}
+		//! Mark the local data as changed (see MeshVertexData::markAsChanged()).
+		void markAsChanged();
 		bool hasChanged()const								{  	return dataChanged;	}
-		bool hasLocalData()const							{  	return !indexArray.empty();	}
+		//! Number that is unique for every state of the data marked by markAsChanged().
+		uint64_t getRevision()const							{	return revision;	}
+		bool hasLocalData()const							{  	return sharedData || !indexArray.empty();	}
 
-		const uint32_t & operator[](uint32_t index) const	{	return indexArray[index]; }
-		uint32_t & operator[](uint32_t index) 				{	return indexArray[index]; }
+		const uint32_t & operator[](uint32_t index) const	{	return data()[index]; }
+		uint32_t & operator[](uint32_t index) 				{	return data()[index]; }
 
 		// index range
 		inline uint32_t getMinIndex() const 				{   return minIndex;    }
@@ -78,15 +84,24 @@ class MeshIndexData {
 		/*! Swap the internal BufferObject.
 			\note The local data is not changed!
 			\note the size of the new buffer must be equal to that of the old one.
-			\note Use only if you know what you are doing!	*/
-		void _swapBufferObject(BufferObject & other)	{	bufferObject.swap(other);	}
+			\note Use only if you know what you are doing!
+			@param upToDate The new buffer contains the current local data; the data is marked as unchanged
+				(see hasChanged()). */
+		void _swapBufferObject(BufferObject & other, bool upToDate = false) {
+			bufferObject.swap(other);
+			if(upToDate)
+				dataChanged = false;
+		}
 	private:
 		uint32_t indexCount;
 		std::vector<uint32_t> indexArray;
+		//! Writable data owned by someone else; used instead of indexArray if set.
+		std::shared_ptr<uint32_t> sharedData;
 		uint32_t minIndex;
 		uint32_t maxIndex;
 		BufferObject bufferObject;
 		bool dataChanged;
+		uint64_t revision;
 };
 }
 
@@ -16,8 +16,10 @@
 #include "../RenderingContext/RenderingContext.h"
 #include "../GLHeader.h"
 #include "../Helper.h"
+#include <Geometry/Matrix4x4.h>
 #include <Util/Macros.h>
 #include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <mutex>
@@ -42,15 +44,17 @@ void MeshVertexData::setVertexDescription(const VertexDescription & vd){
 
 //! (ctor)
 MeshVertexData::MeshVertexData() :
-	binaryData(), vertexDescription(nullptr), vertexCount(0), bufferObject(), bb(), dataChanged(false) {
+	binaryData(), sharedData(), sharedDataSize(0), vertexDescription(nullptr), vertexCount(0), bufferObject(), bb(), dataChanged(false), revision(0) {
 	setVertexDescription(VertexDescription());
 }
 
 //! (ctor)
 MeshVertexData::MeshVertexData(const MeshVertexData & other) :
-	binaryData(), vertexDescription(other.vertexDescription), vertexCount(other.getVertexCount()), bufferObject(), bb(other.getBoundingBox()), dataChanged(true) {
+	binaryData(), sharedData(), sharedDataSize(0), vertexDescription(other.vertexDescription), vertexCount(other.getVertexCount()), bufferObject(), bb(other.getBoundingBox()),
+	positionDequantization(other.positionDequantization), dataChanged(false), revision(0) {
+	markAsChanged();
 	if(other.hasLocalData()) {
-		binaryData = other.binaryData;
+		binaryData.assign(other.data(), other.data() + other.dataSize());
 	} else if(other.isUploaded()) {
 		other.downloadTo(binaryData);
 	} else {
@@ -59,6 +63,8 @@ MeshVertexData::MeshVertexData(const MeshVertexData & other) :
 }
 
 void MeshVertexData::releaseLocalData(){
+	sharedData.reset();
+	sharedDataSize = 0;
 	binaryData.resize(0);
 	binaryData.shrink_to_fit();
 }
@@ -72,25 +78,49 @@ void MeshVertexData::swap(MeshVertexData & other){
 	swap(vertexCount, other.vertexCount);
 	swap(bufferObject, other.bufferObject);
 	swap(bb, other.bb);
+	swap(positionDequantization, other.positionDequantization);
 	swap(dataChanged, other.dataChanged);
+	swap(revision, other.revision);
 	swap(binaryData, other.binaryData);
+	swap(sharedData, other.sharedData);
+	swap(sharedDataSize, other.sharedDataSize);
+}
+
+void MeshVertexData::markAsChanged() {
+	static std::atomic<uint64_t> revisionCounter(0);
+	dataChanged = true;
+	revision = ++revisionCounter;
 }
 
 void MeshVertexData::allocate(uint32_t count, const VertexDescription & vd){
 	setVertexDescription(vd);
 	vertexCount = count;
+	sharedData.reset();
+	sharedDataSize = 0;
+	positionDequantization.reset();
 	binaryData.resize(vd.getVertexSize() * count);
 	binaryData.shrink_to_fit();
 	markAsChanged();
 }
 
+void MeshVertexData::_setSharedData(uint32_t count, const VertexDescription & vd, std::shared_ptr<uint8_t> newData){
+	setVertexDescription(vd);
+	vertexCount = count;
+	binaryData.clear();
+	binaryData.shrink_to_fit();
+	positionDequantization.reset();
+	sharedData = std::move(newData);
+	sharedDataSize = sharedData ? vd.getVertexSize() * count : 0;
+	markAsChanged();
+}
+
 const uint8_t * MeshVertexData::operator[](uint32_t index) const {
-	return binaryData.data() + index * vertexDescription->getVertexSize();
+	return data() + index * vertexDescription->getVertexSize();
 
 }
 
 uint8_t * MeshVertexData::operator[](uint32_t index) {
-	return binaryData.data() + index * vertexDescription->getVertexSize();
+	return data() + index * vertexDescription->getVertexSize();
 }
 
 void MeshVertexData::updateBoundingBox() {
@@ -131,6 +161,20 @@ void MeshVertexData::updateBoundingBox() {
 	} else {
 		bb = Geometry::Box(min[0], max[0], min[1], max[1], min[2], max[2]);
 	}
+	if(positionDequantization) {
+		const Geometry::Box storedBox(bb);
+		bb.invalidate();
+		for(uint_fast8_t corner = 0; corner < 8; ++corner) {
+			const Geometry::Vec3 storedCorner((corner & 1) ? storedBox.getMaxX() : storedBox.getMinX(),
+											  (corner & 2) ? storedBox.getMaxY() : storedBox.getMinY(),
+											  (corner & 4) ? storedBox.getMaxZ() : storedBox.getMinZ());
+			bb.include(positionDequantization->transformPosition(storedCorner));
+		}
+	}
+}
+
+void MeshVertexData::setPositionDequantization(const Geometry::Matrix4x4 & matrix) {
+	positionDequantization = std::make_shared<const Geometry::Matrix4x4>(matrix);
 }
 
 bool MeshVertexData::upload() {
@@ -138,14 +182,14 @@ bool MeshVertexData::upload() {
 }
 
 bool MeshVertexData::upload(uint32_t usageHint){
-	if(vertexCount == 0 || binaryData.empty() )
+	if(vertexCount == 0 || !hasLocalData() )
 		return false;
 		
 	if( isUploaded() )
 		removeGlBuffer();
 
 	try {
-		bufferObject.uploadData(GL_ARRAY_BUFFER, binaryData, usageHint);
+		bufferObject.uploadData(GL_ARRAY_BUFFER, data(), dataSize(), usageHint);
 		GET_GL_ERROR()
 	}
 	catch (...) {
@@ -160,6 +204,8 @@ bool MeshVertexData::upload(uint32_t usageHint){
 bool MeshVertexData::download(){
 	if(!isUploaded() || vertexCount==0)
 		return false;
+	sharedData.reset();
+	sharedDataSize = 0;
 	downloadTo(binaryData);
 	dataChanged = false;
 	return true;
@@ -181,15 +227,17 @@ void MeshVertexData::removeGlBuffer(){
 }
 
 void MeshVertexData::bind(RenderingContext & context, bool useVBO) {
-	const VertexDescription & vd = getVertexDescription();
-
 	const uint8_t * vertexPosition = nullptr;
 	if (useVBO && isUploaded()) { // use VBO
 		bufferObject.bind(GL_ARRAY_BUFFER);
 	} else { // use Vertex array
 		vertexPosition = data();
 	}
+	_bindAttributes(context, getVertexDescription(), vertexPosition);
+}
 
+//! (static)
+void MeshVertexData::_bindAttributes(RenderingContext & context, const VertexDescription & vd, const uint8_t * vertexPosition) {
 	Shader * shader = context.getActiveShader();
 	const GLsizei vSize=vd.getVertexSize();
 #ifdef LIB_GL
@@ -272,6 +320,11 @@ void MeshVertexData::unbind(RenderingContext & context, bool useVBO) {
 	if (useVBO && isUploaded()) { // unbind vertex VBO
 		bufferObject.unbind(GL_ARRAY_BUFFER);
 	}
+	_unbindAttributes(context);
+}
+
+//! (static)
+void MeshVertexData::_unbindAttributes(RenderingContext & context) {
 	context.disableAllClientStates();
 	context.disableAllTextureClientStates();
 	context.disableAllVertexAttribArrays();
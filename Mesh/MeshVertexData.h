@@ -15,8 +15,13 @@
 #include <Geometry/Box.h>
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <vector>
 
+namespace Geometry {
+template<typename _T> class _Matrix4x4;
+typedef _Matrix4x4<float> Matrix4x4;
+}
 namespace Rendering {
 
 class RenderingContext;
@@ -29,16 +34,23 @@ class VertexDescription;
 		the graphics card, the local copy may be freed.)
 	- The vertex buffer id, if the data has been uploaded to graphics memory.
 	- A bounding box enclosing all vertices.
+	- An optional transformation for quantized positions (see MeshUtils::quantizeMesh()).
 	@ingroup mesh
 */
 class MeshVertexData {
 		std::vector<uint8_t> binaryData;
+		//! Writable data owned by someone else (e.g. a private file mapping); used instead of binaryData if set.
+		std::shared_ptr<uint8_t> sharedData;
+		size_t sharedDataSize;
 		const VertexDescription * vertexDescription;
 		uint32_t vertexCount;
 		BufferObject bufferObject;
 
 		Geometry::Box bb;
+		//! Transformation from the stored positions to object space; null if the positions are stored in object space.
+		std::shared_ptr<const Geometry::Matrix4x4> positionDequantization;
 		bool dataChanged;
+		uint64_t revision;
 
 		/*! (internal) To save memory, the vertexDescription is stored in a static set
 			so that each MeshVertexData-Object having the same vertex description references the same
@@ -68,13 +80,23 @@ class MeshVertexData {
 		/*! Set the local vertex data. The old data is freed.
 			\note Sets dataChanged. */
 		void allocate(uint32_t count, const VertexDescription & vd);
+		/*! Use @p data as local vertex data instead of allocating own memory. The old data is freed.
+			@p data has to stay valid and writable as long as it is referenced by the shared pointer
+			(e.g. a copy-on-write mapping of a file, see Serialization::loadMeshMapped).
+			\note Sets dataChanged. */
+		void _setSharedData(uint32_t count, const VertexDescription & vd, std::shared_ptr<uint8_t> data);
 		void releaseLocalData();
-		void markAsChanged()								{  	dataChanged=true;	}
+		/*! Mark the local data as changed, so that it is uploaded again and derived data
+			(e.g. a MeshUtils::TriangleBVH) is rebuilt. Assigns a new revision. */
+		void markAsChanged();
 		bool hasChanged()const								{  	return dataChanged;	}
-		bool hasLocalData()const							{  	return !binaryData.empty();	}
-		const uint8_t * data()const							{	return binaryData.data();	}
-		uint8_t * data()									{	return binaryData.data();	}
-		size_t dataSize()const								{	return binaryData.size();	}
+		/*! Number that is unique for every state of the data marked by markAsChanged().
+			Can be used to check if data derived from the vertices is still up to date. */
+		uint64_t getRevision()const							{	return revision;	}
+		bool hasLocalData()const							{  	return sharedData || !binaryData.empty();	}
+		const uint8_t * data()const							{	return sharedData ? sharedData.get() : binaryData.data();	}
+		uint8_t * data()									{	return sharedData ? sharedData.get() : binaryData.data();	}
+		size_t dataSize()const								{	return sharedData ? sharedDataSize : binaryData.size();	}
 		const uint8_t * operator[](uint32_t index) const;
 		uint8_t * operator[](uint32_t index);
 
@@ -89,6 +111,18 @@ class MeshVertexData {
 		 */
 		void _setBoundingBox(const Geometry::Box & box)		{ bb = box; }
 
+		// quantization
+		/*! Return the transformation from the stored positions to object space, or nullptr if
+			the positions are stored in object space. If set, the positions are quantized (e.g.
+			normalized 16 bit values relative to the bounding box); shaders have to apply this
+			transformation and PositionAttributeAccessor applies it. The bounding box is always
+			given in object space. */
+		const Geometry::Matrix4x4 * getPositionDequantization() const	{	return positionDequantization.get();	}
+		/*! Set the transformation from the stored positions to object space.
+			\note The stored positions are not changed; allocate() resets the transformation. */
+		void setPositionDequantization(const Geometry::Matrix4x4 & matrix);
+		void clearPositionDequantization()								{	positionDequantization.reset();	}
+
 
 		// vbo
 		inline bool isUploaded()const						{   return bufferObject.isValid();    }
@@ -97,6 +131,11 @@ class MeshVertexData {
 		void bind(RenderingContext & context, bool useVBO);
 		/*! (internal) */
 		void unbind(RenderingContext & context, bool useVBO);
+		/*! (internal) Enable the attributes of @p vd for rendering. @p vertexPosition is the address of the first
+			vertex, or its offset into the buffer bound to GL_ARRAY_BUFFER. */
+		static void _bindAttributes(RenderingContext & context, const VertexDescription & vd, const uint8_t * vertexPosition);
+		/*! (internal) Disable all attributes enabled by _bindAttributes(...). */
+		static void _unbindAttributes(RenderingContext & context);
 
 		//! Call @a upload() with default usage hint.
 		bool upload();
@@ -116,8 +155,14 @@ class MeshVertexData {
 		/*! Swap the internal BufferObject. 
 			\note The local data is not changed!
 			\note the size of the new buffer must be equal to that of the old one.
-			\note Use only if you know what you are doing!	*/		
-		void _swapBufferObject(BufferObject & other)	{	bufferObject.swap(other);	}
+			\note Use only if you know what you are doing!
+			@param upToDate The new buffer contains the current local data; the data is marked as unchanged
+				(see hasChanged()). */
+		void _swapBufferObject(BufferObject & other, bool upToDate = false) {
+			bufferObject.swap(other);
+			if(upToDate)
+				dataChanged = false;
+		}
 		
 		/*! get the internal BufferObject.
 		\note Use only if you know what you are doing!	*/		
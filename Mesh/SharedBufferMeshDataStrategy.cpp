@@ -0,0 +1,223 @@
+/*
+ This file is part of the Rendering library.
+ Copyright (C) 2026 agent <agent@local>
+
+ This library is subject to the terms of the Mozilla Public License, v. 2.0.
+ You should have received a copy of the MPL along with this library; see the
+ file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "SharedBufferMeshDataStrategy.h"
+#include "Mesh.h"
+#include "MeshIndexData.h"
+#include "MeshVertexData.h"
+#include "VertexDescription.h"
+#include "../GLHeader.h"
+#include "../RenderingContext/RenderingContext.h"
+#include <Geometry/Box.h>
+#include <Geometry/Matrix4x4.h>
+#include <Util/Macros.h>
+#include <stdexcept>
+#include <utility>
+
+namespace Rendering {
+
+SharedBufferMeshDataStrategy::SharedBufferMeshDataStrategy(uint8_t _flags, size_t _initialCapacity, BackendFactory_t _backendFactory) :
+		MeshDataStrategy(true), flags(_flags), initialCapacity(_initialCapacity), backendFactory(std::move(_backendFactory)) {
+}
+
+SharedBufferMeshDataStrategy::~SharedBufferMeshDataStrategy() {
+	// download the data of the meshes before the shared buffers are destroyed
+	detachMeshes();
+}
+
+//! (internal)
+std::unique_ptr<SubAllocatedBuffer::Backend> SharedBufferMeshDataStrategy::createBackend() const {
+	return backendFactory ? backendFactory() : SubAllocatedBuffer::createBufferObjectBackend(GL_STATIC_DRAW);
+}
+
+//! (internal)
+SharedBufferMeshDataStrategy::Entry & SharedBufferMeshDataStrategy::getEntry(Mesh * m) {
+	Entry & entry = entries[m];
+	const MeshVertexData & vd = m->_getVertexData();
+	const MeshIndexData & id = m->_getIndexData();
+	if( (entry.vertexRevision != vd.getRevision() && !vd.hasLocalData()) || (entry.indexRevision != id.getRevision() && !id.hasLocalData()) ) {
+		// the data has been swapped or moved from another mesh (e.g. by Mesh::swap(...)); take over its entry
+		for(auto & other : entries) {
+			if(other.first != m && other.second.vertexRevision == vd.getRevision() && other.second.indexRevision == id.getRevision()) {
+				std::swap(entry, other.second);
+				break;
+			}
+		}
+	}
+	return entry;
+}
+
+SubAllocatedBuffer * SharedBufferMeshDataStrategy::getVertexBuffer(const VertexDescription & vd) const {
+	const auto it = vertexBuffers.find(&vd);
+	return it == vertexBuffers.end() ? nullptr : it->second.get();
+}
+
+//! ---|> MeshDataStrategy
+void SharedBufferMeshDataStrategy::assureLocalVertexData(Mesh * m){
+	MeshVertexData & vd = m->_getVertexData();
+	if(vd.empty() || vd.hasLocalData())
+		return;
+	if(vd.isUploaded()) { // buffer created by another strategy
+		vd.download();
+		return;
+	}
+	const auto it = entries.find(m);
+	if(it == entries.end() || it->second.vertexAllocation == SubAllocatedBuffer::INVALID_ALLOCATION) {
+		WARN("SharedBufferMeshDataStrategy: The vertex data is not accessible.");
+		return;
+	}
+	Entry & entry = it->second;
+
+	// allocate() resets the quantization
+	std::unique_ptr<Geometry::Matrix4x4> dequantization;
+	if(vd.getPositionDequantization() != nullptr)
+		dequantization.reset(new Geometry::Matrix4x4(*vd.getPositionDequantization()));
+	const Geometry::Box boundingBox = vd.getBoundingBox();
+	vd.allocate(vd.getVertexCount(), vd.getVertexDescription());
+	entry.vertexBuffer->download(entry.vertexAllocation, vd.data(), vd.dataSize());
+	if(dequantization)
+		vd.setPositionDequantization(*dequantization);
+	vd._setBoundingBox(boundingBox);
+	entry.vertexRevision = vd.getRevision(); // the shared buffer still contains the data
+}
+
+//! ---|> MeshDataStrategy
+void SharedBufferMeshDataStrategy::assureLocalIndexData(Mesh * m){
+	MeshIndexData & id = m->_getIndexData();
+	if(id.empty() || id.hasLocalData())
+		return;
+	if(id.isUploaded()) { // buffer created by another strategy
+		id.download();
+		return;
+	}
+	const auto it = entries.find(m);
+	if(it == entries.end() || it->second.indexAllocation == SubAllocatedBuffer::INVALID_ALLOCATION) {
+		WARN("SharedBufferMeshDataStrategy: The index data is not accessible.");
+		return;
+	}
+	Entry & entry = it->second;
+	id.allocate(id.getIndexCount());
+	indexBuffer->download(entry.indexAllocation, reinterpret_cast<uint8_t *>(id.data()), id.dataSize());
+	id.updateIndexRange();
+	entry.indexRevision = id.getRevision(); // the shared buffer still contains the data
+}
+
+//! ---|> MeshDataStrategy
+void SharedBufferMeshDataStrategy::prepare(Mesh * m){
+	MeshVertexData & vd = m->_getVertexData();
+	MeshIndexData & id = m->_getIndexData();
+
+	// take over data uploaded into own buffers by another strategy
+	if(vd.isUploaded()) {
+		if(!vd.hasLocalData())
+			vd.download();
+		vd.removeGlBuffer();
+	}
+	if(id.isUploaded()) {
+		if(!id.hasLocalData())
+			id.download();
+		id.removeGlBuffer();
+	}
+
+	Entry & entry = getEntry(m);
+	const VertexDescription & description = vd.getVertexDescription();
+	if(entry.vertexRevision != vd.getRevision() && vd.hasLocalData()) {
+		if(entry.vertexAllocation != SubAllocatedBuffer::INVALID_ALLOCATION)
+			entry.vertexBuffer->free(entry.vertexAllocation);
+		entry.vertexAllocation = SubAllocatedBuffer::INVALID_ALLOCATION;
+		if(!vd.empty()) {
+			std::unique_ptr<SubAllocatedBuffer> & buffer = vertexBuffers[&description];
+			if(!buffer)
+				buffer.reset(new SubAllocatedBuffer(createBackend(), description.getVertexSize(), initialCapacity));
+			entry.vertexBuffer = buffer.get();
+			entry.vertexAllocation = buffer->allocate(vd.dataSize());
+			buffer->upload(entry.vertexAllocation, vd.data(), vd.dataSize());
+		}
+		entry.vertexRevision = vd.getRevision();
+	}
+	if(entry.indexRevision != id.getRevision() && id.hasLocalData()) {
+		if(entry.indexAllocation != SubAllocatedBuffer::INVALID_ALLOCATION)
+			indexBuffer->free(entry.indexAllocation);
+		entry.indexAllocation = SubAllocatedBuffer::INVALID_ALLOCATION;
+		if(!id.empty()) {
+			if(!indexBuffer)
+				indexBuffer.reset(new SubAllocatedBuffer(createBackend(), sizeof(uint32_t), initialCapacity));
+			entry.indexAllocation = indexBuffer->allocate(id.dataSize());
+			indexBuffer->upload(entry.indexAllocation, reinterpret_cast<const uint8_t *>(id.data()), id.dataSize());
+		}
+		entry.indexRevision = id.getRevision();
+	}
+
+	if(getFlag(RELEASE_LOCAL_DATA)) {
+		if(entry.vertexAllocation != SubAllocatedBuffer::INVALID_ALLOCATION && vd.hasLocalData())
+			vd.releaseLocalData();
+		if(entry.indexAllocation != SubAllocatedBuffer::INVALID_ALLOCATION && id.hasLocalData())
+			id.releaseLocalData();
+	}
+}
+
+//! ---|> MeshDataStrategy
+void SharedBufferMeshDataStrategy::displayMesh(RenderingContext & context, Mesh * m,uint32_t startIndex,uint32_t indexCount){
+	if(m->empty())
+		return;
+	const auto it = entries.find(m);
+	if(it == entries.end() || it->second.vertexAllocation == SubAllocatedBuffer::INVALID_ALLOCATION)
+		return;
+	const Entry & entry = it->second;
+	const VertexDescription & description = m->getVertexDescription();
+	const GLint baseVertex = static_cast<GLint>(entry.vertexBuffer->getOffset(entry.vertexAllocation) / description.getVertexSize());
+
+	// the attributes of all meshes in the buffer start at offset 0; the mesh is selected by the base vertex
+	entry.vertexBuffer->getBackend().bind(GL_ARRAY_BUFFER);
+	MeshVertexData::_bindAttributes(context, description, nullptr);
+	if(m->isUsingIndexData()) {
+		if(startIndex + indexCount > m->getIndexCount())
+			throw std::out_of_range("SharedBufferMeshDataStrategy::displayMesh: Accessing invalid index.");
+		if(entry.indexAllocation != SubAllocatedBuffer::INVALID_ALLOCATION) {
+			const size_t indexOffset = indexBuffer->getOffset(entry.indexAllocation) + startIndex * sizeof(uint32_t);
+			indexBuffer->getBackend().bind(GL_ELEMENT_ARRAY_BUFFER);
+			glDrawElementsBaseVertex(m->getGLDrawMode(), indexCount, GL_UNSIGNED_INT, reinterpret_cast<void *>(indexOffset), baseVertex);
+			indexBuffer->getBackend().unbind(GL_ELEMENT_ARRAY_BUFFER);
+		}
+	} else {
+		if(startIndex + indexCount > m->getVertexCount())
+			throw std::out_of_range("SharedBufferMeshDataStrategy::displayMesh: Accessing invalid vertex.");
+		glDrawArrays(m->getGLDrawMode(), baseVertex + static_cast<GLint>(startIndex), indexCount);
+	}
+	MeshVertexData::_unbindAttributes(context);
+	entry.vertexBuffer->getBackend().unbind(GL_ARRAY_BUFFER);
+}
+
+//! ---|> MeshDataStrategy
+void SharedBufferMeshDataStrategy::releaseMesh(Mesh * m, bool destroyed){
+	const auto it = entries.find(m);
+	if(it == entries.end())
+		return;
+	if(!destroyed) {
+		assureLocalVertexData(m);
+		assureLocalIndexData(m);
+	}
+	const Entry & entry = it->second;
+	if(entry.vertexAllocation != SubAllocatedBuffer::INVALID_ALLOCATION)
+		entry.vertexBuffer->free(entry.vertexAllocation);
+	if(entry.indexAllocation != SubAllocatedBuffer::INVALID_ALLOCATION)
+		indexBuffer->free(entry.indexAllocation);
+	entries.erase(it);
+}
+
+size_t SharedBufferMeshDataStrategy::defragment() {
+	size_t movedBytes = 0;
+	for(auto & buffer : vertexBuffers)
+		movedBytes += buffer.second->defragment();
+	if(indexBuffer)
+		movedBytes += indexBuffer->defragment();
+	return movedBytes;
+}
+
+}
@@ -0,0 +1,95 @@
+/*
+ This file is part of the Rendering library.
+ Copyright (C) 2026 agent <agent@local>
+
+ This library is subject to the terms of the Mozilla Public License, v. 2.0.
+ You should have received a copy of the MPL along with this library; see the
+ file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef RENDERING_MESH_SHAREDBUFFERMESHDATASTRATEGY_H_
+#define RENDERING_MESH_SHAREDBUFFERMESHDATASTRATEGY_H_
+
+#include "MeshDataStrategy.h"
+#include "../SubAllocatedBuffer.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+
+namespace Rendering {
+class VertexDescription;
+
+/*!	SharedBufferMeshDataStrategy ---|> MeshDataStrategy
+	Packs the data of many meshes into a few large buffers instead of creating two buffer objects per mesh:
+	the vertices of all meshes with the same VertexDescription share one vertex buffer, and the indices of
+	all meshes share one index buffer. The buffers are sub-allocated (see SubAllocatedBuffer) and the meshes
+	are drawn with a base vertex offset.
+
+	\note If the local data is released (RELEASE_LOCAL_DATA), a mesh must not be copied or moved before its
+		data has been opened (Mesh::openVertexData(), Mesh::openIndexData()).
+	@ingroup mesh
+*/
+class SharedBufferMeshDataStrategy : public MeshDataStrategy {
+	public:
+		//! Creates the storage of a new shared buffer; used to run the strategy without a GPU (e.g. for tests).
+		typedef std::function<std::unique_ptr<SubAllocatedBuffer::Backend> ()> BackendFactory_t;
+
+		//! Release the local data of a mesh after it has been uploaded; it is downloaded again when it is opened.
+		static const uint8_t RELEASE_LOCAL_DATA = 1<<0;
+
+		const uint8_t flags;
+		inline bool getFlag(const uint8_t f)const	{	return flags&f;	}
+
+		/*! @param initialCapacity Initial size in bytes of every shared buffer.
+			@param backendFactory If empty, the buffers are stored in BufferObjects. */
+		explicit SharedBufferMeshDataStrategy(uint8_t flags = 0, size_t initialCapacity = 4 * 1024 * 1024,
+											  BackendFactory_t backendFactory = BackendFactory_t());
+		virtual ~SharedBufferMeshDataStrategy();
+
+		void assureLocalVertexData(Mesh * m) override;
+		void assureLocalIndexData(Mesh * m) override;
+		void prepare(Mesh * m) override;
+		void displayMesh(RenderingContext & context, Mesh * m,uint32_t startIndex,uint32_t indexCount) override;
+		void releaseMesh(Mesh * m, bool destroyed) override;
+
+		//! Compact all shared buffers (see SubAllocatedBuffer::defragment()) and return the number of moved bytes.
+		size_t defragment();
+
+		//! Number of meshes having data in the shared buffers.
+		size_t getMeshCount() const		{	return entries.size();	}
+		//! Number of shared buffers (one per VertexDescription plus the index buffer).
+		size_t getBufferCount() const	{	return vertexBuffers.size() + (indexBuffer ? 1 : 0);	}
+		//! Shared vertex buffer of the given VertexDescription, or nullptr.
+		SubAllocatedBuffer * getVertexBuffer(const VertexDescription & vd) const;
+		SubAllocatedBuffer * getIndexBuffer() const	{	return indexBuffer.get();	}
+
+	private:
+		struct Entry {
+			SubAllocatedBuffer * vertexBuffer;
+			uint32_t vertexAllocation;
+			uint32_t indexAllocation;
+			//! Revisions of the data in the shared buffers (see MeshVertexData::getRevision())
+			uint64_t vertexRevision;
+			uint64_t indexRevision;
+
+			Entry() : vertexBuffer(nullptr), vertexAllocation(SubAllocatedBuffer::INVALID_ALLOCATION),
+					indexAllocation(SubAllocatedBuffer::INVALID_ALLOCATION), vertexRevision(0), indexRevision(0) {}
+		};
+
+		const size_t initialCapacity;
+		const BackendFactory_t backendFactory;
+		//! The VertexDescriptions of all MeshVertexData objects are shared, so they can be identified by their address.
+		std::unordered_map<const VertexDescription *, std::unique_ptr<SubAllocatedBuffer>> vertexBuffers;
+		std::unique_ptr<SubAllocatedBuffer> indexBuffer;
+		std::unordered_map<Mesh *, Entry> entries;
+
+		Entry & getEntry(Mesh * m);
+		std::unique_ptr<SubAllocatedBuffer::Backend> createBackend() const;
+};
+
+}
+
+#endif /* RENDERING_MESH_SHAREDBUFFERMESHDATASTRATEGY_H_ */
@@ -12,6 +12,9 @@
 #include "VertexAttributeAccessors.h"
 #include "../GLHeader.h"
 #include <Geometry/Convert.h>
+#include <Geometry/Matrix4x4.h>
+#include <algorithm>
+#include <cmath>
 #include <sstream>
 #include <exception>
 
@@ -35,6 +38,15 @@ void VertexAttributeAccessor::assertNumValues(uint32_t index, uint32_t count) co
 	}
 }
 
+//! (internal)
+void VertexAttributeAccessor::assertRange(const uint32_t * indices, uint32_t count) const {
+	const uint32_t vertexCount = vData.getVertexCount();
+	for(uint32_t i = 0; i < count; ++i) {
+		if(indices[i] >= vertexCount)
+			throwRangeError(indices[i]);
+	}
+}
+
 // -----------
 
 static const std::string noAttrErrorMsg("No attribute named '");
@@ -48,9 +60,37 @@ static const VertexAttribute & assertAttribute(MeshVertexData & _vData, const Ut
 	return attr;
 }
 
+/*! (helper) Call fn(vertex, i) with a pointer to the attribute of the vertex indices[i] (or begin+i, if
+	@p indices is nullptr) for all i < count. The loops are inlined into the batch functions of the accessors. */
+template<typename Fn_t>
+static void forEachVertex(const VertexAttributeAccessor & acc, const uint32_t * indices, uint32_t begin, uint32_t count, Fn_t fn) {
+	uint8_t * const data = acc._ptr<uint8_t>(0);
+	const size_t vertexSize = acc.getVertexSize();
+	if(indices) {
+		for(uint32_t i = 0; i < count; ++i)
+			fn(data + indices[i] * vertexSize, i);
+	} else {
+		uint8_t * vertex = data + begin * vertexSize;
+		for(uint32_t i = 0; i < count; ++i, vertex += vertexSize)
+			fn(vertex, i);
+	}
+}
+
 // ---------------------------------
 // Color
 
+void ColorAttributeAccessor::readColors(const uint32_t * indices, uint32_t begin, uint32_t count, float * rgba) const {
+	for(uint32_t i = 0; i < count; ++i) {
+		const Util::Color4f c = getColor4f(indices ? indices[i] : begin + i);
+		rgba[4 * i] = c.getR(), rgba[4 * i + 1] = c.getG(), rgba[4 * i + 2] = c.getB(), rgba[4 * i + 3] = c.getA();
+	}
+}
+
+void ColorAttributeAccessor::writeColors(const uint32_t * indices, uint32_t begin, uint32_t count, const float * rgba) {
+	for(uint32_t i = 0; i < count; ++i)
+		setColor(indices ? indices[i] : begin + i, Util::Color4f(rgba[4 * i], rgba[4 * i + 1], rgba[4 * i + 2], rgba[4 * i + 3]));
+}
+
 /*! ColorAttributeAccessor3f ---|> ColorAttributeAccessor	*/
 class ColorAttributeAccessor3f : public ColorAttributeAccessor {
 	public:
@@ -83,6 +123,21 @@ class ColorAttributeAccessor3f : public ColorAttributeAccessor {
 			float * v = _ptr<float>(index);
 			v[0] = c.getR() , v[1] = c.getG() , v[2] = c.getB();
 		}
+	protected:
+		//! ---|> ColorAttributeAccessor
+		void readColors(const uint32_t * indices, uint32_t begin, uint32_t count, float * rgba)const override {
+			forEachVertex(*this, indices, begin, count, [rgba](const uint8_t * vertex, uint32_t i) {
+				const float * v = reinterpret_cast<const float *>(vertex);
+				rgba[4 * i] = v[0], rgba[4 * i + 1] = v[1], rgba[4 * i + 2] = v[2], rgba[4 * i + 3] = 1.0f;
+			});
+		}
+		//! ---|> ColorAttributeAccessor
+		void writeColors(const uint32_t * indices, uint32_t begin, uint32_t count, const float * rgba) override {
+			forEachVertex(*this, indices, begin, count, [rgba](uint8_t * vertex, uint32_t i) {
+				float * v = reinterpret_cast<float *>(vertex);
+				v[0] = rgba[4 * i], v[1] = rgba[4 * i + 1], v[2] = rgba[4 * i + 2];
+			});
+		}
 };
 
 /*! ColorAttributeAccessor4f ---|> ColorAttributeAccessor	*/
@@ -117,6 +172,20 @@ class ColorAttributeAccessor4f : public ColorAttributeAccessor {
 			float * v = _ptr<float>(index);
 			v[0] = c.getR() , v[1] = c.getG() , v[2] = c.getB() , v[3] = c.getA();
 		}
+	protected:
+		//! ---|> ColorAttributeAccessor
+		void readColors(const uint32_t * indices, uint32_t begin, uint32_t count, float * rgba)const override {
+			forEachVertex(*this, indices, begin, count, [rgba](const uint8_t * vertex, uint32_t i) {
+				const float * v = reinterpret_cast<const float *>(vertex);
+				std::copy(v, v + 4, rgba + 4 * i);
+			});
+		}
+		//! ---|> ColorAttributeAccessor
+		void writeColors(const uint32_t * indices, uint32_t begin, uint32_t count, const float * rgba) override {
+			forEachVertex(*this, indices, begin, count, [rgba](uint8_t * vertex, uint32_t i) {
+				std::copy(rgba + 4 * i, rgba + 4 * i + 4, reinterpret_cast<float *>(vertex));
+			});
+		}
 };
 
 /*! ColorAttributeAccessor4ub ---|> ColorAttributeAccessor	*/
@@ -151,6 +220,21 @@ class ColorAttributeAccessor4ub : public ColorAttributeAccessor {
 			uint8_t * v = _ptr<uint8_t>(index);
 			v[0] = c.getR() , v[1] = c.getG() , v[2] = c.getB() , v[3] = c.getA();
 		}
+	protected:
+		//! ---|> ColorAttributeAccessor
+		void readColors(const uint32_t * indices, uint32_t begin, uint32_t count, float * rgba)const override {
+			forEachVertex(*this, indices, begin, count, [rgba](const uint8_t * v, uint32_t i) {
+				const Util::Color4f c(Util::Color4ub(v[0], v[1], v[2], v[3]));
+				rgba[4 * i] = c.getR(), rgba[4 * i + 1] = c.getG(), rgba[4 * i + 2] = c.getB(), rgba[4 * i + 3] = c.getA();
+			});
+		}
+		//! ---|> ColorAttributeAccessor
+		void writeColors(const uint32_t * indices, uint32_t begin, uint32_t count, const float * rgba) override {
+			forEachVertex(*this, indices, begin, count, [rgba](uint8_t * v, uint32_t i) {
+				const Util::Color4ub c(Util::Color4f(rgba[4 * i], rgba[4 * i + 1], rgba[4 * i + 2], rgba[4 * i + 3]));
+				v[0] = c.getR(), v[1] = c.getG(), v[2] = c.getB(), v[3] = c.getA();
+			});
+		}
 };
 
 
@@ -171,6 +255,18 @@ Util::Reference<ColorAttributeAccessor> ColorAttributeAccessor::create(MeshVerte
 // ---------------------------------
 // Normals
 
+void NormalAttributeAccessor::readNormals(const uint32_t * indices, uint32_t begin, uint32_t count, float * xyz) const {
+	for(uint32_t i = 0; i < count; ++i) {
+		const Geometry::Vec3 n = getNormal(indices ? indices[i] : begin + i);
+		xyz[3 * i] = n.x(), xyz[3 * i + 1] = n.y(), xyz[3 * i + 2] = n.z();
+	}
+}
+
+void NormalAttributeAccessor::writeNormals(const uint32_t * indices, uint32_t begin, uint32_t count, const float * xyz) {
+	for(uint32_t i = 0; i < count; ++i)
+		setNormal(indices ? indices[i] : begin + i, Geometry::Vec3(xyz[3 * i], xyz[3 * i + 1], xyz[3 * i + 2]));
+}
+
 /*! NormalAttributeAccessor4b ---|> NormalAttributeAccessor */
 class NormalAttributeAccessor4b : public NormalAttributeAccessor {
 	public:
@@ -196,6 +292,24 @@ class NormalAttributeAccessor4b : public NormalAttributeAccessor {
 			v[2] = Geometry::Convert::toSigned<int8_t>(n.z());
 			v[3] = 0;
 		}
+	protected:
+		//! ---|> NormalAttributeAccessor
+		void readNormals(const uint32_t * indices, uint32_t begin, uint32_t count, float * xyz)const override {
+			forEachVertex(*this, indices, begin, count, [xyz](const uint8_t * vertex, uint32_t i) {
+				const int8_t * v = reinterpret_cast<const int8_t *>(vertex);
+				for(uint_fast8_t c = 0; c < 3; ++c)
+					xyz[3 * i + c] = Geometry::Convert::fromSignedTo<float>(v[c]);
+			});
+		}
+		//! ---|> NormalAttributeAccessor
+		void writeNormals(const uint32_t * indices, uint32_t begin, uint32_t count, const float * xyz) override {
+			forEachVertex(*this, indices, begin, count, [xyz](uint8_t * vertex, uint32_t i) {
+				int8_t * v = reinterpret_cast<int8_t *>(vertex);
+				for(uint_fast8_t c = 0; c < 3; ++c)
+					v[c] = Geometry::Convert::toSigned<int8_t>(xyz[3 * i + c]);
+				v[3] = 0;
+			});
+		}
 };
 
 /*! NormalAttributeAccessor3f ---|> NormalAttributeAccessor */
@@ -218,6 +332,66 @@ class NormalAttributeAccessor3f : public NormalAttributeAccessor {
 			float * v = _ptr<float>(index);
 			v[0] = n.x() , v[1] = n.y() , v[2] = n.z();
 		}
+	protected:
+		//! ---|> NormalAttributeAccessor
+		void readNormals(const uint32_t * indices, uint32_t begin, uint32_t count, float * xyz)const override {
+			forEachVertex(*this, indices, begin, count, [xyz](const uint8_t * vertex, uint32_t i) {
+				const float * v = reinterpret_cast<const float *>(vertex);
+				std::copy(v, v + 3, xyz + 3 * i);
+			});
+		}
+		//! ---|> NormalAttributeAccessor
+		void writeNormals(const uint32_t * indices, uint32_t begin, uint32_t count, const float * xyz) override {
+			forEachVertex(*this, indices, begin, count, [xyz](uint8_t * vertex, uint32_t i) {
+				std::copy(xyz + 3 * i, xyz + 3 * i + 3, reinterpret_cast<float *>(vertex));
+			});
+		}
+};
+
+/*! NormalAttributeAccessorOct16 ---|> NormalAttributeAccessor
+	Octahedral encoding with two normalized 16 bit values (see VertexDescription::appendNormalOctahedral()).
+	A decoded normal is normalized. */
+class NormalAttributeAccessorOct16 : public NormalAttributeAccessor {
+		static float signNotZero(float value)	{	return value >= 0.0f ? 1.0f : -1.0f;	}
+		static float decode(int16_t value)		{	return std::max(value / 32767.0f, -1.0f);	}
+		static int16_t encode(float value)		{	return static_cast<int16_t>(std::round(std::max(-1.0f, std::min(1.0f, value)) * 32767.0f));	}
+	public:
+		NormalAttributeAccessorOct16(MeshVertexData & _vData, const VertexAttribute & _attribute) :
+			NormalAttributeAccessor(_vData, _attribute) {}
+		virtual ~NormalAttributeAccessorOct16() {}
+
+		//! ---|> NormalAttributeAccessor
+		Geometry::Vec3 getNormal(uint32_t index)const override {
+			assertRange(index);
+			const int16_t * v = _ptr<const int16_t>(index);
+			const float x = decode(v[0]);
+			const float y = decode(v[1]);
+			const float z = 1.0f - std::abs(x) - std::abs(y);
+			Geometry::Vec3 n(x, y, z);
+			if(z < 0.0f)
+				n = Geometry::Vec3((1.0f - std::abs(y)) * signNotZero(x), (1.0f - std::abs(x)) * signNotZero(y), z);
+			return n.normalize();
+		}
+
+		//! ---|> NormalAttributeAccessor
+		void setNormal(uint32_t index, const Geometry::Vec3 & n) override {
+			assertRange(index);
+			int16_t * v = _ptr<int16_t>(index);
+			const float l1Norm = std::abs(n.x()) + std::abs(n.y()) + std::abs(n.z());
+			if(l1Norm == 0.0f) {
+				v[0] = v[1] = 0;
+				return;
+			}
+			float x = n.x() / l1Norm;
+			float y = n.y() / l1Norm;
+			if(n.z() < 0.0f) {
+				const float foldedX = (1.0f - std::abs(y)) * signNotZero(x);
+				y = (1.0f - std::abs(x)) * signNotZero(y);
+				x = foldedX;
+			}
+			v[0] = encode(x);
+			v[1] = encode(y);
+		}
 };
 
 //! (static)
@@ -227,6 +401,8 @@ Util::Reference<NormalAttributeAccessor> NormalAttributeAccessor::create(MeshVer
 		return new NormalAttributeAccessor3f(_vData, attr);
 	} else if(attr.getNumValues() >= 4 && attr.getDataType() == GL_BYTE) {
 		return new NormalAttributeAccessor4b(_vData, attr);
+	} else if((attr.getNumValues() == 2 || attr.getNumValues() == 4) && attr.getDataType() == GL_SHORT) {
+		return new NormalAttributeAccessorOct16(_vData, attr);
 	} else {
 		throw std::invalid_argument(unimplementedFormatMsg + name.toString() + '\'');
 	}
@@ -235,6 +411,18 @@ Util::Reference<NormalAttributeAccessor> NormalAttributeAccessor::create(MeshVer
 // ---------------------------------
 // Position
 
+void PositionAttributeAccessor::readPositions(const uint32_t * indices, uint32_t begin, uint32_t count, float * xyz) const {
+	for(uint32_t i = 0; i < count; ++i) {
+		const Geometry::Vec3 p = getPosition(indices ? indices[i] : begin + i);
+		xyz[3 * i] = p.x(), xyz[3 * i + 1] = p.y(), xyz[3 * i + 2] = p.z();
+	}
+}
+
+void PositionAttributeAccessor::writePositions(const uint32_t * indices, uint32_t begin, uint32_t count, const float * xyz) {
+	for(uint32_t i = 0; i < count; ++i)
+		setPosition(indices ? indices[i] : begin + i, Geometry::Vec3(xyz[3 * i], xyz[3 * i + 1], xyz[3 * i + 2]));
+}
+
 /*! PositionAttributeAccessorF ---|> PositionAttributeAccessor */
 class PositionAttributeAccessorF : public PositionAttributeAccessor {
 	public:
@@ -255,6 +443,20 @@ class PositionAttributeAccessorF : public PositionAttributeAccessor {
 			float * v=_ptr<float>(index);
 			v[0] = p.x() , v[1] = p.y() , v[2] = p.z();
 		}
+	protected:
+		//! ---|> PositionAttributeAccessor
+		void readPositions(const uint32_t * indices, uint32_t begin, uint32_t count, float * xyz)const override {
+			forEachVertex(*this, indices, begin, count, [xyz](const uint8_t * vertex, uint32_t i) {
+				const float * v = reinterpret_cast<const float *>(vertex);
+				std::copy(v, v + 3, xyz + 3 * i);
+			});
+		}
+		//! ---|> PositionAttributeAccessor
+		void writePositions(const uint32_t * indices, uint32_t begin, uint32_t count, const float * xyz) override {
+			forEachVertex(*this, indices, begin, count, [xyz](uint8_t * vertex, uint32_t i) {
+				std::copy(xyz + 3 * i, xyz + 3 * i + 3, reinterpret_cast<float *>(vertex));
+			});
+		}
 };
 
 /*! PositionAttributeAccessorHF ---|> PositionAttributeAccessor */
@@ -283,6 +485,57 @@ class PositionAttributeAccessorHF : public PositionAttributeAccessor {
 			v[1] = Geometry::Convert::floatToHalf(p.y());
 			v[2] = Geometry::Convert::floatToHalf(p.z());
 		}
+	protected:
+		//! ---|> PositionAttributeAccessor
+		void readPositions(const uint32_t * indices, uint32_t begin, uint32_t count, float * xyz)const override {
+			forEachVertex(*this, indices, begin, count, [xyz](const uint8_t * vertex, uint32_t i) {
+				const uint16_t * v = reinterpret_cast<const uint16_t *>(vertex);
+				for(uint_fast8_t c = 0; c < 3; ++c)
+					xyz[3 * i + c] = Geometry::Convert::halfToFloat(v[c]);
+			});
+		}
+		//! ---|> PositionAttributeAccessor
+		void writePositions(const uint32_t * indices, uint32_t begin, uint32_t count, const float * xyz) override {
+			forEachVertex(*this, indices, begin, count, [xyz](uint8_t * vertex, uint32_t i) {
+				uint16_t * v = reinterpret_cast<uint16_t *>(vertex);
+				for(uint_fast8_t c = 0; c < 3; ++c)
+					v[c] = Geometry::Convert::floatToHalf(xyz[3 * i + c]);
+			});
+		}
+};
+
+/*! PositionAttributeAccessorUS ---|> PositionAttributeAccessor
+	Normalized 16 bit positions; the positions are transformed by the vertex data's dequantization
+	matrix (see MeshVertexData::getPositionDequantization()). */
+class PositionAttributeAccessorUS : public PositionAttributeAccessor {
+		Geometry::Matrix4x4 dequantization;
+		Geometry::Matrix4x4 quantization;
+	public:
+		PositionAttributeAccessorUS(MeshVertexData & _vData, const VertexAttribute & _attribute) :
+				PositionAttributeAccessor(_vData, _attribute) {
+			if(_vData.getPositionDequantization())
+				dequantization = *_vData.getPositionDequantization();
+			quantization = dequantization.inverse();
+		}
+		virtual ~PositionAttributeAccessorUS() {}
+
+		//! ---|> PositionAttributeAccessor
+		const Geometry::Vec3 getPosition(uint32_t index) const override {
+			assertRange(index);
+			const uint16_t * v = _ptr<const uint16_t>(index);
+			return dequantization.transformPosition(Geometry::Vec3(v[0] / 65535.0f, v[1] / 65535.0f, v[2] / 65535.0f));
+		}
+
+		//! ---|> PositionAttributeAccessor
+		void setPosition(uint32_t index, const Geometry::Vec3 & p) override {
+			assertRange(index);
+			uint16_t * v = _ptr<uint16_t>(index);
+			const Geometry::Vec3 q = quantization.transformPosition(p);
+			for(uint_fast8_t i = 0; i < 3; ++i)
+				v[i] = static_cast<uint16_t>(std::round(std::max(0.0f, std::min(1.0f, q[i])) * 65535.0f));
+			if(getAttribute().getNumValues() >= 4)
+				v[3] = 65535;
+		}
 };
 
 //! (static)
@@ -292,6 +545,8 @@ Util::Reference<PositionAttributeAccessor> PositionAttributeAccessor::create(Mes
 		return new PositionAttributeAccessorF(_vData, attr);
 	} else if(attr.getNumValues() >= 3 && attr.getDataType() == GL_HALF_FLOAT) {
 		return new PositionAttributeAccessorHF(_vData, attr);
+	} else if(attr.getNumValues() >= 3 && attr.getDataType() == GL_UNSIGNED_SHORT) {
+		return new PositionAttributeAccessorUS(_vData, attr);
 	} else {
 		throw std::invalid_argument(unimplementedFormatMsg + name.toString() + '\'');
 	}
@@ -395,6 +650,88 @@ class FloatAttributeAccessorb : public FloatAttributeAccessor {
 		}
 };
 
+/*! FloatAttributeAccessorus ---|> FloatAttributeAccessor */
+class FloatAttributeAccessorus : public FloatAttributeAccessor {
+	public:
+		FloatAttributeAccessorus(MeshVertexData & _vData, const VertexAttribute & _attribute) :
+			FloatAttributeAccessor(_vData, _attribute) {}
+		virtual ~FloatAttributeAccessorus() {}
+
+		//! ---|> FloatAttributeAccessor
+		float getValue(uint32_t index) const override {
+			assertRange(index);
+			const uint16_t * v = _ptr<const uint16_t>(index);
+			return Geometry::Convert::fromUnsignedTo<float>(v[0]);
+		}
+
+		//! ---|> FloatAttributeAccessor
+		void setValue(uint32_t index, float value) override {
+			assertRange(index);
+			uint16_t * v = _ptr<uint16_t>(index);
+			v[0] = Geometry::Convert::toUnsigned<uint16_t>(value);
+		}
+
+		//! ---|> FloatAttributeAccessor
+		const std::vector<float> getValues(uint32_t index) const override {
+			assertRange(index);
+			const uint16_t * v = _ptr<const uint16_t>(index);
+			std::vector<float> out(getAttribute().getNumValues());
+			for(uint32_t i=0; i<out.size(); ++i)
+				out[i] = Geometry::Convert::fromUnsignedTo<float>(v[i]);
+			return out;
+		}
+
+		//! ---|> FloatAttributeAccessor
+		void setValues(uint32_t index, const float* values, uint32_t count) override {
+			assertRange(index);
+			count = std::min<uint32_t>(count, getAttribute().getNumValues());
+			uint16_t * v = _ptr<uint16_t>(index);
+			for(uint32_t i=0; i<count; ++i)
+				v[i] = Geometry::Convert::toUnsigned<uint16_t>(values[i]);
+		}
+};
+
+/*! FloatAttributeAccessors ---|> FloatAttributeAccessor */
+class FloatAttributeAccessors : public FloatAttributeAccessor {
+	public:
+		FloatAttributeAccessors(MeshVertexData & _vData, const VertexAttribute & _attribute) :
+			FloatAttributeAccessor(_vData, _attribute) {}
+		virtual ~FloatAttributeAccessors() {}
+
+		//! ---|> FloatAttributeAccessor
+		float getValue(uint32_t index) const override {
+			assertRange(index);
+			const int16_t * v = _ptr<const int16_t>(index);
+			return Geometry::Convert::fromSignedTo<float>(v[0]);
+		}
+
+		//! ---|> FloatAttributeAccessor
+		void setValue(uint32_t index, float value) override {
+			assertRange(index);
+			int16_t * v = _ptr<int16_t>(index);
+			v[0] = Geometry::Convert::toSigned<int16_t>(value);
+		}
+
+		//! ---|> FloatAttributeAccessor
+		const std::vector<float> getValues(uint32_t index) const override {
+			assertRange(index);
+			const int16_t * v = _ptr<const int16_t>(index);
+			std::vector<float> out(getAttribute().getNumValues());
+			for(uint32_t i=0; i<out.size(); ++i)
+				out[i] = Geometry::Convert::fromSignedTo<float>(v[i]);
+			return out;
+		}
+
+		//! ---|> FloatAttributeAccessor
+		void setValues(uint32_t index, const float* values, uint32_t count) override {
+			assertRange(index);
+			count = std::min<uint32_t>(count, getAttribute().getNumValues());
+			int16_t * v = _ptr<int16_t>(index);
+			for(uint32_t i=0; i<count; ++i)
+				v[i] = Geometry::Convert::toSigned<int16_t>(values[i]);
+		}
+};
+
 /*! FloatAttributeAccessorHF ---|> FloatAttributeAccessor */
 class FloatAttributeAccessorHF : public FloatAttributeAccessor {
 	public:
@@ -430,7 +767,7 @@ class FloatAttributeAccessorHF : public FloatAttributeAccessor {
 		void setValues(uint32_t index, const float* values, uint32_t count) override {
 			assertRange(index);
 			count = std::min<uint32_t>(count, getAttribute().getNumValues());
-			uint8_t * v = _ptr<uint8_t>(index);
+			uint16_t * v = _ptr<uint16_t>(index);
 			for(uint32_t i=0; i<count; ++i)
 				v[i] = Geometry::Convert::floatToHalf(values[i]);
 		}
@@ -482,6 +819,10 @@ Util::Reference<FloatAttributeAccessor> FloatAttributeAccessor::create(MeshVerte
 		return new FloatAttributeAccessorb(_vData, attr);
 	} else if(attr.getDataType() == GL_UNSIGNED_BYTE) {
 		return new FloatAttributeAccessorub(_vData, attr);
+	} else if(attr.getDataType() == GL_UNSIGNED_SHORT) {
+		return new FloatAttributeAccessorus(_vData, attr);
+	} else if(attr.getDataType() == GL_SHORT) {
+		return new FloatAttributeAccessors(_vData, attr);
 	} else if(attr.getDataType() == GL_HALF_FLOAT) {
 		return new FloatAttributeAccessorHF(_vData, attr);
 	} else {
@@ -534,4 +875,34 @@ Util::Reference<UIntAttributeAccessor> UIntAttributeAccessor::create(MeshVertexD
 	}
 }
 
+// ---------------------------------
+// Typed view
+
+//! (internal) OpenGL data type of the values of a VertexAttributeView
+template<typename value_t> struct ViewDataType;
+template<> struct ViewDataType<float> {	static const uint32_t value = GL_FLOAT;	};
+template<> struct ViewDataType<uint8_t> {	static const uint32_t value = GL_UNSIGNED_BYTE;	};
+template<> struct ViewDataType<int8_t> {	static const uint32_t value = GL_BYTE;	};
+
+//! (static)
+template<typename value_t, uint32_t numValues>
+bool VertexAttributeView<value_t, numValues>::isCompatible(const VertexAttribute & attr) {
+	return !attr.empty() && attr.getDataType() == ViewDataType<value_t>::value && attr.getNumValues() >= numValues;
+}
+
+template<typename value_t, uint32_t numValues>
+VertexAttributeView<value_t, numValues>::VertexAttributeView(MeshVertexData & vData, Util::StringIdentifier name) :
+		dataPtr(nullptr), vertexSize(vData.getVertexDescription().getVertexSize()), vertexCount(vData.getVertexCount()) {
+	const VertexAttribute & attr = assertAttribute(vData, name);
+	if(!isCompatible(attr))
+		throw std::invalid_argument(unimplementedFormatMsg + name.toString() + '\'');
+	dataPtr = vData.data() + attr.getOffset();
+}
+
+template class VertexAttributeView<float, 2>;
+template class VertexAttributeView<float, 3>;
+template class VertexAttributeView<float, 4>;
+template class VertexAttributeView<uint8_t, 4>;
+template class VertexAttributeView<int8_t, 4>;
+
 }
@@ -44,12 +44,15 @@ class VertexAttributeAccessor : public Util::ReferenceCounter<VertexAttributeAcc
 				dataPtr( vData.data() + attribute.getOffset() ) {}
 
 		void assertRange(uint32_t index)const			{	if(index>=vData.getVertexCount()) throwRangeError(index); }
+		void assertRange(uint32_t begin, uint32_t count)const	{	if(count>0 && (begin>=vData.getVertexCount() || count>vData.getVertexCount()-begin)) throwRangeError(begin+count-1); }
+		void assertRange(const uint32_t * indices, uint32_t count)const;
 		void assertNumValues(uint32_t index, uint32_t count) const;
 	public:
 		virtual ~VertexAttributeAccessor() {}
 
 		bool checkRange(uint32_t index)const			{	return index<vData.getVertexCount();	}
 		const VertexAttribute & getAttribute()const		{	return attribute;	}
+		size_t getVertexSize()const						{	return vertexSize;	}
 
 		template<typename number_t>
 		number_t * _ptr(uint32_t index)const			{	return reinterpret_cast<number_t*>(dataPtr+index*vertexSize); }
@@ -79,6 +82,19 @@ class ColorAttributeAccessor : public VertexAttributeAccessor{
 		virtual Util::Color4ub getColor4ub(uint32_t index)const = 0;
 		virtual void setColor(uint32_t index,const Util::Color4f & c) = 0;
 		virtual void setColor(uint32_t index,const Util::Color4ub & c) = 0;
+
+		/*! Batch access: Read the colors of the vertices [begin, begin+count) (gather: of the vertices indices[0..count-1])
+			into @p rgba, four floats per vertex. One virtual call for all vertices. */
+		void getColors4f(uint32_t begin, uint32_t count, float * rgba)const					{	assertRange(begin, count);	readColors(nullptr, begin, count, rgba);	}
+		void gatherColors(const uint32_t * indices, uint32_t count, float * rgba)const		{	assertRange(indices, count);	readColors(indices, 0, count, rgba);	}
+		//! Batch access: Write the colors of the vertices [begin, begin+count) (scatter: of indices[0..count-1]) from @p rgba, four floats per vertex.
+		void setColors(uint32_t begin, uint32_t count, const float * rgba)					{	assertRange(begin, count);	writeColors(nullptr, begin, count, rgba);	}
+		void scatterColors(const uint32_t * indices, uint32_t count, const float * rgba)		{	assertRange(indices, count);	writeColors(indices, 0, count, rgba);	}
+	protected:
+		/*! Batch access of the vertices indices[i] (or begin+i, if @p indices is nullptr) without range checks.
+			The default implementations call getColor4f() and setColor() per vertex. */
+		virtual void readColors(const uint32_t * indices, uint32_t begin, uint32_t count, float * rgba)const;
+		virtual void writeColors(const uint32_t * indices, uint32_t begin, uint32_t count, const float * rgba);
 };
 
 // ---------------------------------
@@ -100,6 +116,19 @@ class NormalAttributeAccessor : public VertexAttributeAccessor{
 
 		virtual Geometry::Vec3 getNormal(uint32_t index)const = 0;
 		virtual void setNormal(uint32_t index,const Geometry::Vec3 & vec) = 0;
+
+		/*! Batch access: Read the normals of the vertices [begin, begin+count) (gather: of the vertices indices[0..count-1])
+			into @p xyz, three floats per vertex. One virtual call for all vertices. */
+		void getNormals(uint32_t begin, uint32_t count, float * xyz)const					{	assertRange(begin, count);	readNormals(nullptr, begin, count, xyz);	}
+		void gatherNormals(const uint32_t * indices, uint32_t count, float * xyz)const		{	assertRange(indices, count);	readNormals(indices, 0, count, xyz);	}
+		//! Batch access: Write the normals of the vertices [begin, begin+count) (scatter: of indices[0..count-1]) from @p xyz, three floats per vertex.
+		void setNormals(uint32_t begin, uint32_t count, const float * xyz)					{	assertRange(begin, count);	writeNormals(nullptr, begin, count, xyz);	}
+		void scatterNormals(const uint32_t * indices, uint32_t count, const float * xyz)		{	assertRange(indices, count);	writeNormals(indices, 0, count, xyz);	}
+	protected:
+		/*! Batch access of the vertices indices[i] (or begin+i, if @p indices is nullptr) without range checks.
+			The default implementations call getNormal() and setNormal() per vertex. */
+		virtual void readNormals(const uint32_t * indices, uint32_t begin, uint32_t count, float * xyz)const;
+		virtual void writeNormals(const uint32_t * indices, uint32_t begin, uint32_t count, const float * xyz);
 };
 
 // ---------------------------------
@@ -122,6 +151,19 @@ class PositionAttributeAccessor : public VertexAttributeAccessor{
 
 		virtual const Geometry::Vec3 getPosition(uint32_t index) const = 0;
 		virtual void setPosition(uint32_t index, const Geometry::Vec3 & p) = 0;
+
+		/*! Batch access: Read the positions of the vertices [begin, begin+count) (gather: of the vertices indices[0..count-1])
+			into @p xyz, three floats per vertex. One virtual call for all vertices. */
+		void getPositions(uint32_t begin, uint32_t count, float * xyz)const				{	assertRange(begin, count);	readPositions(nullptr, begin, count, xyz);	}
+		void gatherPositions(const uint32_t * indices, uint32_t count, float * xyz)const		{	assertRange(indices, count);	readPositions(indices, 0, count, xyz);	}
+		//! Batch access: Write the positions of the vertices [begin, begin+count) (scatter: of indices[0..count-1]) from @p xyz, three floats per vertex.
+		void setPositions(uint32_t begin, uint32_t count, const float * xyz)				{	assertRange(begin, count);	writePositions(nullptr, begin, count, xyz);	}
+		void scatterPositions(const uint32_t * indices, uint32_t count, const float * xyz)	{	assertRange(indices, count);	writePositions(indices, 0, count, xyz);	}
+	protected:
+		/*! Batch access of the vertices indices[i] (or begin+i, if @p indices is nullptr) without range checks.
+			The default implementations call getPosition() and setPosition() per vertex. */
+		virtual void readPositions(const uint32_t * indices, uint32_t begin, uint32_t count, float * xyz)const;
+		virtual void writePositions(const uint32_t * indices, uint32_t begin, uint32_t count, const float * xyz);
 };
 
 // ---------------------------------
@@ -215,6 +257,37 @@ class UIntAttributeAccessor : public VertexAttributeAccessor{
 		}
 };
 
+// ---------------------------------
+// Typed view
+
+/*! Direct, typed access to the values of a vertex attribute with a known format, e.g. float positions
+	(Float3AttributeView) or byte colors (UByte4AttributeView). Element access is plain pointer arithmetic:
+	no virtual calls, no conversion and no range checks.
+	Use isCompatible() to select between a typed view and the generic accessors.
+	\note Like the accessors, the view only stays valid as long as the referenced MeshVertexData is not altered externally.
+	\note Instantiated for float (2, 3 or 4 values), uint8_t (4 values) and int8_t (4 values). */
+template<typename value_t, uint32_t numValues>
+class VertexAttributeView {
+		uint8_t * dataPtr;
+		size_t vertexSize;
+		uint32_t vertexCount;
+	public:
+		/*! Create a view of the given MeshVertexData's attribute having the given name.
+			If the attribute does not exist or has another data type or less than @p numValues values,
+			an std::invalid_argument exception is thrown. */
+		VertexAttributeView(MeshVertexData & vData, Util::StringIdentifier name);
+
+		//! Return true if the attribute has the data type value_t and at least numValues values.
+		static bool isCompatible(const VertexAttribute & attr);
+
+		uint32_t getVertexCount()const						{	return vertexCount;	}
+		//! Pointer to the numValues values of the vertex @p index
+		value_t * operator[](uint32_t index)const			{	return reinterpret_cast<value_t*>(dataPtr + index * vertexSize);	}
+};
+
+typedef VertexAttributeView<float, 3> Float3AttributeView;
+typedef VertexAttributeView<uint8_t, 4> UByte4AttributeView;
+
 //! @}
 }
 #endif // VERTEXACCESSOR_H
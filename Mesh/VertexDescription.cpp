@@ -145,6 +145,10 @@ const VertexAttribute & VertexDescription::appendNormalFloat() {
 	return appendAttribute(VertexAttributeIds::NORMAL, 3, GL_FLOAT, false);
 }
 
+const VertexAttribute & VertexDescription::appendNormalOctahedral() {
+	return appendAttribute(VertexAttributeIds::NORMAL, 2, GL_SHORT, true);
+}
+
 const VertexAttribute & VertexDescription::appendPosition2D() {
 	return appendAttribute(VertexAttributeIds::POSITION, 2, GL_FLOAT, false);
 }
@@ -161,9 +165,17 @@ const VertexAttribute & VertexDescription::appendPosition4DHalf() {
 	return appendAttribute(VertexAttributeIds::POSITION, 4, GL_HALF_FLOAT, false);
 }
 
+const VertexAttribute & VertexDescription::appendPosition4DUnsignedShort() {
+	return appendAttribute(VertexAttributeIds::POSITION, 4, GL_UNSIGNED_SHORT, true);
+}
+
 const VertexAttribute & VertexDescription::appendTexCoord(uint_fast8_t textureUnit /*= 0*/) {
 	return appendAttribute(VertexAttributeIds::getTextureCoordinateIdentifier(textureUnit), 2, GL_FLOAT, false);
 }
 
+const VertexAttribute & VertexDescription::appendTexCoordHalf(uint_fast8_t textureUnit /*= 0*/) {
+	return appendAttribute(VertexAttributeIds::getTextureCoordinateIdentifier(textureUnit), 2, GL_HALF_FLOAT, false);
+}
+
 
 }
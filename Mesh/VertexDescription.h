@@ -64,6 +64,10 @@ class VertexDescription {
 		//! Add a three-dimensional normal attribute. It is stored as three float values.
 		const VertexAttribute & appendNormalFloat();
 
+		/*! Add a three-dimensional normal attribute. It is stored as two normalized short values
+			in octahedral encoding; it has to be decoded in the shader. */
+		const VertexAttribute & appendNormalOctahedral();
+
 		//! Add a two-dimensional position attribute. It is stored as two float values.
 		const VertexAttribute & appendPosition2D();
 
@@ -76,9 +80,16 @@ class VertexDescription {
 		//! Add a three-dimensional position attribute. It is stored as four half float values.
 		const VertexAttribute & appendPosition4DHalf();
 
+		/*! Add a three-dimensional position attribute. It is stored as four normalized unsigned short values
+			in the unit cube; the mapping to object space is given by MeshVertexData::getPositionDequantization(). */
+		const VertexAttribute & appendPosition4DUnsignedShort();
+
 		//! Add a texture coordinate attribute. It is stored as two float values.
 		const VertexAttribute & appendTexCoord(uint_fast8_t textureUnit = 0);
 
+		//! Add a texture coordinate attribute. It is stored as two half float values.
+		const VertexAttribute & appendTexCoordHalf(uint_fast8_t textureUnit = 0);
+
 		/*! Get a reference to the attribute with the corresponding name.
 			\return Always returns an attribute.
 					If the attribute is not present in the vertex description, it is empty.
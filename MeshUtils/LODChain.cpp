@@ -0,0 +1,134 @@
+/*
+ This file is part of the Rendering library.
+ Copyright (C) 2026 agent <agent@local>
+
+ This library is subject to the terms of the Mozilla Public License, v. 2.0.
+ You should have received a copy of the MPL along with this library; see the
+ file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "LODChain.h"
+#include "MeshOptimizer.h"
+#include "../Mesh/Mesh.h"
+#include "../Mesh/MeshIndexData.h"
+#include "../Mesh/MeshVertexData.h"
+#include "../Mesh/VertexDescription.h"
+#include "../RenderingContext/RenderingContext.h"
+#include <Util/Macros.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+namespace Rendering {
+namespace MeshUtils {
+
+std::vector<LODLevel> buildLODChain(Mesh * mesh, const LODChainOptions & options) {
+	std::vector<LODLevel> levels;
+	if(mesh->getDrawMode() != Mesh::DRAW_TRIANGLES || !mesh->isUsingIndexData()) {
+		WARN("buildLODChain: Only indexed triangle meshes are supported.");
+		return levels;
+	}
+	levels.push_back({mesh, 0.0f});
+	while(levels.size() < options.levelCount) {
+		Mesh * previous = levels.back().mesh.get();
+		const uint32_t targetCount = static_cast<uint32_t>(std::floor(previous->getPrimitiveCount() * options.reductionFactor));
+		if(targetCount < options.minTriangleCount || targetCount >= previous->getPrimitiveCount())
+			break;
+		float stepError = 0.0f;
+		Util::Reference<Mesh> simplified = Simplification::simplifyMeshParallel(previous, targetCount, options.useOptimalPositioning,
+																			   options.maxAngle, options.weights, options.partitionCount, &stepError);
+		// stop if the simplification failed or was blocked by its constraints
+		if(simplified.isNull() || simplified->getPrimitiveCount() >= previous->getPrimitiveCount())
+			break;
+		levels.push_back({simplified, levels.back().error + stepError});
+	}
+	return levels;
+}
+
+//! (internal) Hash and comparison of vertices by their bytes.
+struct VertexBytes {
+	const uint8_t * data;
+	size_t size;
+
+	bool operator==(const VertexBytes & other) const	{	return std::memcmp(data, other.data, size) == 0;	}
+};
+struct VertexBytesHash {
+	size_t operator()(const VertexBytes & vertex) const {
+		// FNV-1a
+		uint64_t hash = 14695981039346656037ULL;
+		for(size_t i = 0; i < vertex.size; ++i)
+			hash = (hash ^ vertex.data[i]) * 1099511628211ULL;
+		return static_cast<size_t>(hash);
+	}
+};
+
+PackedLODMesh packLODChain(const std::vector<LODLevel> & levels) {
+	PackedLODMesh packed;
+	if(levels.empty())
+		return packed;
+	const VertexDescription & vd = levels.front().mesh->getVertexDescription();
+	for(const auto & level : levels) {
+		if(level.mesh->getDrawMode() != Mesh::DRAW_TRIANGLES || !level.mesh->isUsingIndexData() || !(level.mesh->getVertexDescription() == vd)) {
+			WARN("packLODChain: All levels have to be indexed triangle meshes with the same vertex description.");
+			return packed;
+		}
+	}
+	const size_t vertexSize = vd.getVertexSize();
+
+	// assign the vertices in the order of their first use, beginning with the coarsest level
+	std::unordered_map<VertexBytes, uint32_t, VertexBytesHash> vertexIndices;
+	std::vector<const uint8_t *> vertices;
+	std::vector<std::vector<uint32_t>> levelIndices(levels.size());
+	std::vector<uint32_t> levelVertexCounts(levels.size());
+	for(size_t l = levels.size(); l-- > 0;) {
+		Mesh * mesh = levels[l].mesh.get();
+		const uint8_t * vertexData = mesh->openVertexData().data();
+		const MeshIndexData & indexData = mesh->openIndexData();
+		std::vector<uint32_t> & indices = levelIndices[l];
+		indices.assign(indexData.data(), indexData.data() + indexData.getIndexCount());
+		optimizeVertexCache(indices.data(), indices.size(), mesh->getVertexCount(), 16);
+		for(auto & index : indices) {
+			const VertexBytes vertex = {vertexData + index * vertexSize, vertexSize};
+			const auto result = vertexIndices.emplace(vertex, static_cast<uint32_t>(vertices.size()));
+			if(result.second)
+				vertices.push_back(vertex.data);
+			index = result.first->second;
+		}
+		levelVertexCounts[l] = static_cast<uint32_t>(vertices.size());
+	}
+
+	size_t indexCount = 0;
+	for(const auto & indices : levelIndices)
+		indexCount += indices.size();
+	packed.mesh = new Mesh(vd, static_cast<uint32_t>(vertices.size()), static_cast<uint32_t>(indexCount));
+	MeshVertexData & vertexData = packed.mesh->openVertexData();
+	for(size_t v = 0; v < vertices.size(); ++v)
+		std::copy(vertices[v], vertices[v] + vertexSize, vertexData.data() + v * vertexSize);
+	vertexData.updateBoundingBox();
+
+	MeshIndexData & indexData = packed.mesh->openIndexData();
+	uint32_t * target = indexData.data();
+	for(size_t l = 0; l < levels.size(); ++l) {
+		const uint32_t firstElement = static_cast<uint32_t>(target - indexData.data());
+		target = std::copy(levelIndices[l].begin(), levelIndices[l].end(), target);
+		packed.levels.push_back({firstElement, static_cast<uint32_t>(levelIndices[l].size()), levelVertexCounts[l], levels[l].error});
+	}
+	indexData.updateIndexRange();
+	return packed;
+}
+
+uint32_t PackedLODMesh::selectLevel(float maxError) const {
+	uint32_t level = 0;
+	for(uint32_t l = 1; l < levels.size() && levels[l].error <= maxError; ++l)
+		level = l;
+	return level;
+}
+
+void PackedLODMesh::display(RenderingContext & context, uint32_t level) const {
+	const LODRange & range = levels.at(level);
+	context.displayMesh(mesh.get(), range.firstElement, range.elementCount);
+}
+
+}
+}
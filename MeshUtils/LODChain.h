@@ -0,0 +1,91 @@
+/*
+ This file is part of the Rendering library.
+ Copyright (C) 2026 agent <agent@local>
+
+ This library is subject to the terms of the Mozilla Public License, v. 2.0.
+ You should have received a copy of the MPL along with this library; see the
+ file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef RENDERING_MESHUTILS_LODCHAIN_H_
+#define RENDERING_MESHUTILS_LODCHAIN_H_
+
+#include "Simplification.h"
+#include <Util/References.h>
+#include <cstdint>
+#include <vector>
+
+namespace Rendering {
+class Mesh;
+class RenderingContext;
+namespace MeshUtils {
+
+//! Options for buildLODChain().
+struct LODChainOptions {
+	//! Maximal number of levels including the original mesh.
+	uint32_t levelCount;
+	//! Triangle count of a level relative to the previous level.
+	float reductionFactor;
+	//! No level with fewer triangles is generated.
+	uint32_t minTriangleCount;
+	//! Weights for Simplification::simplifyMeshParallel(); the vertex weight should normalize the positions (e.g. 1 / max. extent).
+	Simplification::weights_t weights;
+	bool useOptimalPositioning;
+	//! Maximal rotation of a triangle per collapse (arccos of the angle; -1 disables the test).
+	float maxAngle;
+	//! Number of partitions that are simplified in parallel; 0 uses the number of hardware threads.
+	uint32_t partitionCount;
+
+	LODChainOptions() : levelCount(4), reductionFactor(0.5f), minTriangleCount(64), weights({{1.0f, 0.0f, 0.0f, 0.0f, 1.0f}}),
+			useOptimalPositioning(true), maxAngle(-1.0f), partitionCount(0) {}
+};
+
+//! One level of a chain built by buildLODChain().
+struct LODLevel {
+	Util::Reference<Mesh> mesh;
+	/*! Estimated largest distance to the original surface (in object space): the sum of the errors of the
+		simplification steps leading to this level (see Simplification::simplifyMeshParallel()). 0 for the first level. */
+	float error;
+};
+
+/*! Build a chain of discrete levels of detail in one run. The first level is the given mesh; every further level
+	is simplified from the previous one, until LODChainOptions::levelCount levels exist or the next level would have
+	less than LODChainOptions::minTriangleCount triangles. The errors are non-decreasing.
+	@note The mesh has to consist of indexed triangles. */
+std::vector<LODLevel> buildLODChain(Mesh * mesh, const LODChainOptions & options = LODChainOptions());
+
+//! Element range of one level in a mesh created by packLODChain().
+struct LODRange {
+	//! First index of the level (argument of Mesh::_display())
+	uint32_t firstElement;
+	//! Number of indices of the level
+	uint32_t elementCount;
+	//! The level only uses the first vertexCount vertices of the shared vertex buffer.
+	uint32_t vertexCount;
+	float error;
+};
+
+/*! All levels of a chain in one mesh: the vertices of all levels share one vertex buffer and the indices of the
+	levels are stored one after another. Any level can be drawn without rebinding buffers. */
+struct PackedLODMesh {
+	Util::Reference<Mesh> mesh;
+	//! Ranges of the levels, from the finest to the coarsest level.
+	std::vector<LODRange> levels;
+
+	//! Return the coarsest level with an error of at most @p maxError (the finest level if there is none).
+	uint32_t selectLevel(float maxError) const;
+	//! Draw the given level (see RenderingContext::displayMesh()).
+	void display(RenderingContext & context, uint32_t level) const;
+};
+
+/*! Pack the levels of a chain into one mesh.
+	Vertices with identical data are stored once; vertices are ordered by their first use, starting with the
+	coarsest level, so every level uses a prefix of the vertex buffer. The triangles of every level are
+	reordered for the post-transform vertex cache (see optimizeVertexCache()).
+	@return a packed mesh, or one with a null mesh if the levels do not share a vertex description or are no indexed triangle meshes */
+PackedLODMesh packLODChain(const std::vector<LODLevel> & levels);
+
+}
+}
+
+#endif /* RENDERING_MESHUTILS_LODCHAIN_H_ */
@@ -9,13 +9,21 @@
 	file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
 */
 #include "MarchingCubesMeshBuilder.h"
-#include "MeshBuilder.h"
+#include "ParallelFor.h"
+#include "../Mesh/Mesh.h"
+#include "../Mesh/MeshIndexData.h"
+#include "../Mesh/MeshVertexData.h"
+#include "../Mesh/VertexAttributeAccessors.h"
+#include "../Mesh/VertexAttributeIds.h"
 #include "../Mesh/VertexDescription.h"
+#include <Geometry/Vec3.h>
 #include <Geometry/Vec4.h>
 #include <Util/Graphics/Color.h>
 #include <Util/Graphics/PixelAccessor.h>
 #include <Util/Macros.h>
+#include <algorithm>
 #include <cmath>
+#include <thread>
 #include <vector>
 
 namespace Rendering {
@@ -335,142 +343,293 @@ static Geometry::Vec4 interpolateVertices(float isolevel, const Geometry::Vec4 &
 	return result;
 }
 
-//struct DataSet{
-//	uint32_t resolutionX,resolutionY,resolutionZ;
-//	std::vector<float> density; //! resolutionX*resolutionY*resolutionZ many values.
-//	float isolevel;
-//	uint32_t rangeMinX,rangeMaxX,rangeMinY,rangeMaxY,rangeMinZ,rangeMaxZ;
-//	std::vector<float> occlusion;
-//};
-//	
-//! (static)
-Mesh * MarchingCubesMeshBuilder::createMesh(DataSet & data) {
+static const uint32_t NO_VERTEX = 0xffffffff;
+//! Number of cubes per side of the blocks that are tested for the isolevel in x and y direction.
+static const uint32_t BLOCK_SIZE = 8;
 
-	if(data.density.size() < data.resolutionX * data.resolutionY * data.resolutionZ )
-		INVALID_ARGUMENT_EXCEPTION("createMesh: Given data has invalid size.");
+//! Offset of the eight cube corners (in the order of the bits of the cube index).
+static const uint8_t cornerOffsets[8][3] = {
+	{0, 0, 0}, {1, 0, 0}, {1, 0, 1}, {0, 0, 1}, {0, 1, 0}, {1, 1, 0}, {1, 1, 1}, {0, 1, 1}
+};
+//! Corners of the twelve cube edges, ordered along the positive axis direction.
+static const uint8_t edgeCorners[12][2] = {
+	{0, 1}, {1, 2}, {3, 2}, {0, 3}, {4, 5}, {5, 6}, {7, 6}, {4, 7}, {0, 4}, {1, 5}, {2, 6}, {3, 7}
+};
 
-//	if(data.occlusion.empty())
-//		data.occlusion = data.density;
+//! (internal) Access to a dense DataSet.
+struct DenseSampler {
+	const MarchingCubesMeshBuilder::DataSet & data;
 
-	VertexDescription vertexDescription;
-	vertexDescription.appendPosition3D();
-//	vertexDescription.appendNormalFloat();
-	vertexDescription.appendColorRGBAFloat();
-//	vertexDescription.appendTexCoord();
-	MeshBuilder mb(vertexDescription);
+	float density(uint32_t x, uint32_t y, uint32_t z) const {
+		return data.density[static_cast<size_t>(z) * data.layerXYSize + y * data.resolutionX + x];
+	}
+	float occlusion(uint32_t x, uint32_t y, uint32_t z) const {
+		return data.occlusion.empty() ? 1.0f : data.occlusion[static_cast<size_t>(z) * data.layerXYSize + y * data.resolutionX + x];
+	}
+	bool mayContainSurface(uint32_t minX, uint32_t minY, uint32_t minZ, uint32_t maxX, uint32_t maxY, uint32_t maxZ) const {
+		bool above = false, below = false;
+		for(uint32_t z = minZ; z <= maxZ; ++z) {
+			for(uint32_t y = minY; y <= maxY; ++y) {
+				const float * row = data.density.data() + static_cast<size_t>(z) * data.layerXYSize + y * data.resolutionX;
+				for(uint32_t x = minX; x <= maxX; ++x) {
+					if(row[x] > data.isolevel)
+						above = true;
+					else
+						below = true;
+				}
+				if(above && below)
+					return true;
+			}
+		}
+		return false;
+	}
+};
 
-	const float isolevel = data.isolevel;
-//	const uint32_t layerXYSize = data.layerXYSize;
-//	const uint8_t * ptr=data.data();
-//	const float uScale = 1.0f / sizeX;
-//	const float vScale = 1.0f / sizeY;
+//! (internal) Access to a ChunkedDataSet.
+struct ChunkedSampler {
+	const MarchingCubesMeshBuilder::ChunkedDataSet & data;
 
-	Geometry::Vec4 vertexList[12];
+	float density(uint32_t x, uint32_t y, uint32_t z) const	{	return data.getDensity(x, y, z);	}
+	float occlusion(uint32_t, uint32_t, uint32_t) const	{	return 1.0f;	}
+	bool mayContainSurface(uint32_t minX, uint32_t minY, uint32_t minZ, uint32_t maxX, uint32_t maxY, uint32_t maxZ) const {
+		return data.mayContainSurface(minX, minY, minZ, maxX, maxY, maxZ);
+	}
+};
 
-	for(uint32_t z = data.rangeMinZ; z < data.rangeMaxZ - 1; ++z) {
-		for(uint32_t y = data.rangeMinY; y < data.rangeMaxY - 1; ++y) {
-			for(uint32_t x = data.rangeMinX; x < data.rangeMaxX - 1; ++x) {
-				const float * ptr = data.density.data() + z * data.layerXYSize + y * data.resolutionX + x;
+//! (internal) Surface of a range of cube layers.
+struct Slab {
+	//! x, y, z and occlusion of every vertex
+	std::vector<float> vertices;
+	std::vector<uint32_t> indices;
+	//! Vertices on the x- and y-edges of the first and last sample plane (two entries per sample)
+	std::vector<uint32_t> firstPlane, lastPlane;
+	//! Entries of lastPlane below this value are outdated.
+	uint32_t lastPlaneFirstVertex;
+	//! Global index of every vertex
+	std::vector<uint32_t> remap;
+};
 
-				const float density_xyz = *ptr ;
-				const float density_Xyz = *(ptr + 1) ;
-				const float density_XyZ = *(ptr + 1 + data.layerXYSize) ;
-				const float density_xyZ = *(ptr + data.layerXYSize) ;
-				const float density_xYz = *(ptr + data.resolutionX) ;
-				const float density_XYz = *(ptr + data.resolutionX + 1) ;
-				const float density_XYZ = *(ptr + data.resolutionX + 1 + data.layerXYSize) ;
-				const float density_xYZ = *(ptr + data.resolutionX + data.layerXYSize) ;
+/*! (internal) Polygonize the cube layers [zBegin, zEnd).
+	Vertices are cached per cube edge: x- and y-edges in the lower and upper sample plane of the current layer
+	and the z-edges in between. Instead of clearing the caches for every layer, an entry is only valid if it
+	references a vertex created in the respective layer. */
+template<typename Sampler_t>
+static void extractSlab(const Sampler_t & sampler, float isolevel, uint32_t minX, uint32_t maxX, uint32_t minY, uint32_t maxY,
+						uint32_t zBegin, uint32_t zEnd, Slab & slab) {
+	const uint32_t sizeX = maxX - minX;
+	const size_t planeSize = static_cast<size_t>(sizeX) * (maxY - minY);
+	std::vector<uint32_t> lowerPlane(2 * planeSize, NO_VERTEX);
+	std::vector<uint32_t> upperPlane(2 * planeSize, NO_VERTEX);
+	std::vector<uint32_t> zEdges(planeSize, NO_VERTEX);
+	uint32_t previousLayerFirstVertex = 0;
+	uint32_t layerFirstVertex = 0;
+	for(uint32_t z = zBegin; z < zEnd; ++z) {
+		layerFirstVertex = static_cast<uint32_t>(slab.vertices.size() / 4);
+		// the lower plane was the upper plane of the previous layer
+		const uint32_t lowerPlaneFirstVertex = z == zBegin ? 0 : previousLayerFirstVertex;
+		auto getCacheEntry = [&](uint32_t x, uint32_t y, const uint8_t * start, uint8_t axis, uint32_t & firstVertex) -> uint32_t & {
+			const size_t sample = static_cast<size_t>(y + start[1] - minY) * sizeX + (x + start[0] - minX);
+			if(axis == 2) {
+				firstVertex = layerFirstVertex;
+				return zEdges[sample];
+			} else if(start[2] == 0) {
+				firstVertex = lowerPlaneFirstVertex;
+				return lowerPlane[2 * sample + axis];
+			} else {
+				firstVertex = layerFirstVertex;
+				return upperPlane[2 * sample + axis];
+			}
+		};
+		for(uint32_t blockY = minY; blockY < maxY - 1; blockY += BLOCK_SIZE) {
+			const uint32_t blockEndY = std::min(blockY + BLOCK_SIZE, maxY - 1);
+			for(uint32_t blockX = minX; blockX < maxX - 1; blockX += BLOCK_SIZE) {
+				const uint32_t blockEndX = std::min(blockX + BLOCK_SIZE, maxX - 1);
+				if(!sampler.mayContainSurface(blockX, blockY, z, blockEndX, blockEndY, z + 1))
+					continue;
+				for(uint32_t y = blockY; y < blockEndY; ++y) {
+					for(uint32_t x = blockX; x < blockEndX; ++x) {
+						float density[8];
+						uint8_t cubeindex = 0;
+						for(uint_fast8_t c = 0; c < 8; ++c) {
+							density[c] = sampler.density(x + cornerOffsets[c][0], y + cornerOffsets[c][1], z + cornerOffsets[c][2]);
+							if(density[c] > isolevel)
+								cubeindex |= 1 << c;
+						}
+						/* Cube is entirely in/out of the surface */
+						if(edgeTable[cubeindex] == 0)
+							continue;
 
-				uint8_t cubeindex = 0;
-				if( density_xyz > isolevel)				cubeindex |= 1;
-				if( density_Xyz > isolevel)				cubeindex |= 2;
-				if( density_XyZ > isolevel)				cubeindex |= 4;
-				if( density_xyZ > isolevel)				cubeindex |= 8;
-				if( density_xYz > isolevel)				cubeindex |= 16;
-				if( density_XYz > isolevel)				cubeindex |= 32;
-				if( density_XYZ > isolevel)				cubeindex |= 64;
-				if( density_xYZ > isolevel)				cubeindex |= 128;
+						uint32_t cubeVertices[12];
+						for(uint_fast8_t e = 0; e < 12; ++e) {
+							if((edgeTable[cubeindex] & (1 << e)) == 0)
+								continue;
+							const uint8_t * start = cornerOffsets[edgeCorners[e][0]];
+							const uint8_t * end = cornerOffsets[edgeCorners[e][1]];
+							const uint8_t axis = end[0] != start[0] ? 0 : (end[1] != start[1] ? 1 : 2);
+							uint32_t firstVertex;
+							uint32_t & entry = getCacheEntry(x, y, start, axis, firstVertex);
+							if(entry == NO_VERTEX || entry < firstVertex) {
+								const uint32_t x1 = x + start[0], y1 = y + start[1], z1 = z + start[2];
+								const uint32_t x2 = x + end[0], y2 = y + end[1], z2 = z + end[2];
+								const Geometry::Vec4 v = interpolateVertices(isolevel,
+										Geometry::Vec4(x1, y1, z1, sampler.occlusion(x1, y1, z1)), Geometry::Vec4(x2, y2, z2, sampler.occlusion(x2, y2, z2)),
+										density[edgeCorners[e][0]], density[edgeCorners[e][1]]);
+								entry = static_cast<uint32_t>(slab.vertices.size() / 4);
+								slab.vertices.insert(slab.vertices.end(), {v.x(), v.y(), v.z(), v.w()});
+							}
+							cubeVertices[e] = entry;
+						}
+						for(uint8_t i = 0; triTable[cubeindex][i] != -1; i += 3) {
+							for(int8_t j = 2; j >= 0; --j)
+								slab.indices.push_back(cubeVertices[triTable[cubeindex][i + j]]);
+						}
+					}
+				}
+			}
+		}
+		if(z == zBegin)
+			slab.firstPlane = lowerPlane;
+		previousLayerFirstVertex = layerFirstVertex;
+		std::swap(lowerPlane, upperPlane);
+	}
+	slab.lastPlane = std::move(lowerPlane);
+	slab.lastPlaneFirstVertex = layerFirstVertex;
+}
 
-				/* Cube is entirely in/out of the surface */
-				if(edgeTable[cubeindex] == 0)
-					continue;
+//! (internal) Polygonize the given range of samples in parallel slabs and join the slabs.
+template<typename Sampler_t>
+static Mesh * extractSurface(const Sampler_t & sampler, float isolevel, uint32_t minX, uint32_t maxX, uint32_t minY, uint32_t maxY,
+							 uint32_t minZ, uint32_t maxZ) {
+	if(maxX < minX + 2 || maxY < minY + 2 || maxZ < minZ + 2)
+		return nullptr;
+	const uint32_t layerCount = maxZ - minZ - 1;
+	const uint32_t slabCount = std::min(layerCount, std::max(1u, std::thread::hardware_concurrency()));
+	std::vector<Slab> slabs(slabCount);
+	parallelFor(slabCount, 1, [&](uint32_t begin, uint32_t end) {
+		for(uint32_t s = begin; s < end; ++s)
+			extractSlab(sampler, isolevel, minX, maxX, minY, maxY, minZ + static_cast<uint32_t>(static_cast<uint64_t>(layerCount) * s / slabCount),
+						minZ + static_cast<uint32_t>(static_cast<uint64_t>(layerCount) * (s + 1) / slabCount), slabs[s]);
+	});
 
+	// vertices on the plane between two slabs are taken from the lower slab
+	uint32_t vertexCount = 0;
+	size_t indexCount = 0;
+	std::vector<uint32_t> firstVertices(slabCount);
+	std::vector<size_t> firstIndices(slabCount);
+	for(uint32_t s = 0; s < slabCount; ++s) {
+		Slab & slab = slabs[s];
+		slab.remap.assign(slab.vertices.size() / 4, NO_VERTEX);
+		if(s > 0) {
+			const Slab & lower = slabs[s - 1];
+			for(size_t i = 0; i < slab.firstPlane.size(); ++i) {
+				const uint32_t lowerVertex = lower.lastPlane[i];
+				if(slab.firstPlane[i] != NO_VERTEX && lowerVertex != NO_VERTEX && lowerVertex >= lower.lastPlaneFirstVertex)
+					slab.remap[slab.firstPlane[i]] = lower.remap[lowerVertex];
+			}
+		}
+		firstVertices[s] = vertexCount;
+		for(auto & index : slab.remap) {
+			if(index == NO_VERTEX)
+				index = vertexCount++;
+		}
+		firstIndices[s] = indexCount;
+		indexCount += slab.indices.size();
+	}
+	if(indexCount == 0)
+		return nullptr;
 
-				// get occlusion values
-				const float * oPtr = data.occlusion.data() + z * data.layerXYSize + y * data.resolutionX + x;
-				const float o_xyz = *oPtr ;
-				const float o_Xyz = *(oPtr + 1) ;
-				const float o_XyZ = *(oPtr + 1 + data.layerXYSize) ;
-				const float o_xyZ = *(oPtr + data.layerXYSize) ;
-				const float o_xYz = *(oPtr + data.resolutionX) ;
-				const float o_XYz = *(oPtr + data.resolutionX + 1) ;
-				const float o_XYZ = *(oPtr + data.resolutionX + 1 + data.layerXYSize) ;
-				const float o_xYZ = *(oPtr + data.resolutionX + data.layerXYSize) ;
+	VertexDescription vertexDescription;
+	vertexDescription.appendPosition3D();
+	vertexDescription.appendColorRGBAFloat();
+	auto mesh = new Mesh(vertexDescription, vertexCount, static_cast<uint32_t>(indexCount));
+	MeshVertexData & vertexData = mesh->openVertexData();
+	MeshIndexData & indexData = mesh->openIndexData();
+	auto posAcc = PositionAttributeAccessor::create(vertexData, VertexAttributeIds::POSITION);
+	auto colorAcc = ColorAttributeAccessor::create(vertexData, VertexAttributeIds::COLOR);
+	parallelFor(slabCount, 1, [&](uint32_t begin, uint32_t end) {
+		for(uint32_t s = begin; s < end; ++s) {
+			const Slab & slab = slabs[s];
+			for(uint32_t v = 0; v < slab.remap.size(); ++v) {
+				if(slab.remap[v] < firstVertices[s])
+					continue;
+				const float * vertex = slab.vertices.data() + 4 * v;
+				posAcc->setPosition(slab.remap[v], Geometry::Vec3(vertex[0], vertex[1], vertex[2]));
+				colorAcc->setColor(slab.remap[v], Util::Color4f(vertex[3], vertex[3], vertex[3], 1.0));
+			}
+			uint32_t * indices = indexData.data() + firstIndices[s];
+			for(const auto & index : slab.indices)
+				*(indices++) = slab.remap[index];
+		}
+	});
+	vertexData.updateBoundingBox();
+	indexData.updateIndexRange();
+	return mesh;
+}
 
-				/* Find the vertices where the surface intersects the cube */
-				if(edgeTable[cubeindex] & 1)
-					vertexList[0] = interpolateVertices(isolevel,
-								Geometry::Vec4(x, y, z, o_xyz),			Geometry::Vec4(x+1, y, z, o_Xyz),		density_xyz, density_Xyz);
-				if(edgeTable[cubeindex] & 2)
-					vertexList[1] = interpolateVertices(isolevel,
-								Geometry::Vec4(x+1, y, z, o_Xyz),		Geometry::Vec4(x+1, y, z+1, o_XyZ),		density_Xyz, density_XyZ);
-				if(edgeTable[cubeindex] & 4)
-					vertexList[2] = interpolateVertices(isolevel,
-								Geometry::Vec4(x+1, y, z+1, o_XyZ),		Geometry::Vec4(x, y, z+1, o_xyZ),		density_XyZ, density_xyZ);
-				if(edgeTable[cubeindex] & 8)
-					vertexList[3] = interpolateVertices(isolevel,
-								Geometry::Vec4(x, y, z+1, o_xyZ),		Geometry::Vec4(x, y, z, o_xyz),			density_xyZ, density_xyz);
-				if(edgeTable[cubeindex] & 16)
-					vertexList[4] = interpolateVertices(isolevel,
-								Geometry::Vec4(x, y+1 , z, o_xYz),		Geometry::Vec4(x+1 , y+1 , z, o_XYz),	density_xYz, density_XYz);
-				if(edgeTable[cubeindex] & 32)
-					vertexList[5] = interpolateVertices(isolevel,
-								Geometry::Vec4(x+1 , y+1 , z, o_XYz),	Geometry::Vec4(x+1 , y+1 , z+1, o_XYZ),	density_XYz, density_XYZ);
-				if(edgeTable[cubeindex] & 64)
-					vertexList[6] = interpolateVertices(isolevel,
-								Geometry::Vec4(x+1 , y+1 , z+1, o_XYZ),	Geometry::Vec4(x, y+1 , z+1, o_xYZ),	density_XYZ, density_xYZ);
-				if(edgeTable[cubeindex] & 128)
-					vertexList[7] = interpolateVertices(isolevel,
-								Geometry::Vec4(x, y+1 , z+1, o_xYZ),	Geometry::Vec4(x, y+1 , z, o_xYz),		density_xYZ, density_xYz);
-				if(edgeTable[cubeindex] & 256)
-					vertexList[8] = interpolateVertices(isolevel,
-								Geometry::Vec4(x, y, z, o_xyz),			Geometry::Vec4(x, y+1 , z, o_xYz),		density_xyz, density_xYz);
-				if(edgeTable[cubeindex] & 512)
-					vertexList[9] = interpolateVertices(isolevel,
-								Geometry::Vec4(x+1, y, z, o_Xyz),		Geometry::Vec4(x+1 , y+1 , z, o_XYz),	density_Xyz, density_XYz);
-				if(edgeTable[cubeindex] & 1024)
-					vertexList[10] = interpolateVertices(isolevel,
-								Geometry::Vec4(x+1, y, z+1, o_XyZ),		Geometry::Vec4(x+1 , y+1 , z+1, o_XYZ),	density_XyZ, density_XYZ);
-				if(edgeTable[cubeindex] & 2048)
-					vertexList[11] = interpolateVertices(isolevel,
-								Geometry::Vec4(x, y, z+1, o_xyZ),		Geometry::Vec4(x, y+1 , z+1, o_xYZ),	density_xyZ, density_xYZ);
+//! (static)
+Mesh * MarchingCubesMeshBuilder::createMesh(DataSet & data) {
+	if(data.density.size() < static_cast<size_t>(data.resolutionX) * data.resolutionY * data.resolutionZ)
+		INVALID_ARGUMENT_EXCEPTION("createMesh: Given data has invalid size.");
+	if(!data.occlusion.empty() && data.occlusion.size() < data.density.size())
+		INVALID_ARGUMENT_EXCEPTION("createMesh: Given occlusion data has invalid size.");
+	if(data.rangeMaxX > data.resolutionX || data.rangeMaxY > data.resolutionY || data.rangeMaxZ > data.resolutionZ)
+		INVALID_ARGUMENT_EXCEPTION("createMesh: Given range exceeds the resolution.");
+	return extractSurface(DenseSampler{data}, data.isolevel, data.rangeMinX, data.rangeMaxX, data.rangeMinY, data.rangeMaxY,
+						  data.rangeMinZ, data.rangeMaxZ);
+}
 
-				for (uint8_t i = 0; triTable[cubeindex][i] != -1; i += 3) {
+//! (static)
+Mesh * MarchingCubesMeshBuilder::createMesh(const ChunkedDataSet & data) {
+	return extractSurface(ChunkedSampler{data}, data.isolevel, 0, data.resolutionX, 0, data.resolutionY, 0, data.resolutionZ);
+}
 
-//					mb.texCoord0(Geometry::Vec2( x*uScale,y*vScale) );
+MarchingCubesMeshBuilder::ChunkedDataSet::ChunkedDataSet(uint32_t rX, uint32_t rY, uint32_t rZ, float initialDensity) :
+		resolutionX(rX), resolutionY(rY), resolutionZ(rZ), isolevel(0.5),
+		chunksX((rX + CHUNK_SIZE - 1) / CHUNK_SIZE), chunksY((rY + CHUNK_SIZE - 1) / CHUNK_SIZE), chunksZ((rZ + CHUNK_SIZE - 1) / CHUNK_SIZE),
+		chunks(static_cast<size_t>(chunksX) * chunksY * chunksZ) {
+	for(auto & chunk : chunks)
+		chunk.minValue = chunk.maxValue = initialDensity;
+}
 
-					for(int8_t j = 2; j >= 0; --j) {
-						const Geometry::Vec4 & v = vertexList[triTable[cubeindex][i+j]];
-						mb.color(Util::Color4f(v.w(),v.w(),v.w(),1.0));
+void MarchingCubesMeshBuilder::ChunkedDataSet::setDensity(uint32_t x, uint32_t y, uint32_t z, float value) {
+	Chunk & chunk = chunks[getChunkIndex(x, y, z)];
+	if(!chunk.values) {
+		if(value == chunk.minValue)
+			return;
+		chunk.values.reset(new float[CHUNK_SIZE * CHUNK_SIZE * CHUNK_SIZE]);
+		std::fill(chunk.values.get(), chunk.values.get() + CHUNK_SIZE * CHUNK_SIZE * CHUNK_SIZE, chunk.minValue);
+	}
+	chunk.values[getValueIndex(x, y, z)] = value;
+	chunk.minValue = std::min(chunk.minValue, value);
+	chunk.maxValue = std::max(chunk.maxValue, value);
+}
 
-						mb.position( v.xyz() );
-						mb.addIndex(mb.addVertex());
+void MarchingCubesMeshBuilder::ChunkedDataSet::fillChunk(uint32_t x, uint32_t y, uint32_t z, float value) {
+	Chunk & chunk = chunks[getChunkIndex(x, y, z)];
+	chunk.values.reset();
+	chunk.minValue = chunk.maxValue = value;
+}
 
-					}
+size_t MarchingCubesMeshBuilder::ChunkedDataSet::getAllocatedChunkCount() const {
+	return static_cast<size_t>(std::count_if(chunks.begin(), chunks.end(), [](const Chunk & chunk) { return static_cast<bool>(chunk.values); }));
+}
 
-				}
-//					mb.texCoord0(Geometry::Vec2( x*uScale,y*vScale) );
-//					mb.position(Geometry::Vec3(static_cast<float>(x),static_cast<float>(y),static_cast<float>(z)));
-//					mb.addIndex(mb.addVertex());
-//				}
+bool MarchingCubesMeshBuilder::ChunkedDataSet::mayContainSurface(uint32_t minX, uint32_t minY, uint32_t minZ, uint32_t maxX, uint32_t maxY, uint32_t maxZ) const {
+	bool above = false, below = false;
+	for(uint32_t cz = minZ / CHUNK_SIZE; cz <= maxZ / CHUNK_SIZE; ++cz) {
+		for(uint32_t cy = minY / CHUNK_SIZE; cy <= maxY / CHUNK_SIZE; ++cy) {
+			for(uint32_t cx = minX / CHUNK_SIZE; cx <= maxX / CHUNK_SIZE; ++cx) {
+				const Chunk & chunk = chunks[(static_cast<size_t>(cz) * chunksY + cy) * chunksX + cx];
+				above |= chunk.maxValue > isolevel;
+				below |= chunk.minValue <= isolevel;
+				if(above && below)
+					return true;
 			}
 		}
 	}
-	return mb.buildMesh();
-
+	return false;
 }
 
-
 //! (static)
 Mesh * MarchingCubesMeshBuilder::createMeshFromTiledImage(const Util::PixelAccessor & accessor, uint32_t sizeX, uint32_t sizeY, uint32_t sizeZ) {
 	const uint32_t numHorizontalTiles = accessor.getWidth() / sizeX;
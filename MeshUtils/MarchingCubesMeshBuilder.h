@@ -12,6 +12,7 @@
 #define MACRHING_CUBES_MESH_BUILDER_H_
 
 #include <cstdint>
+#include <memory>
 #include <vector>
 
 namespace Util {
@@ -32,24 +33,75 @@ namespace MeshUtils {
  */
 namespace MarchingCubesMeshBuilder {
 
+/*! Dense density field.
+	The occlusion values are used as vertex colors; if @p withOcclusion is false, no occlusion storage is
+	allocated and all vertices are white. */
 struct DataSet{
 	const uint32_t resolutionX,resolutionY,resolutionZ;
 	const uint32_t layerXYSize;
 	float isolevel;
 	uint32_t rangeMinX,rangeMaxX,rangeMinY,rangeMaxY,rangeMinZ,rangeMaxZ;
 	std::vector<float> density; //! resolutionX*resolutionY*resolutionZ many values.
-	std::vector<float> occlusion;
+	std::vector<float> occlusion; //! resolutionX*resolutionY*resolutionZ many values or empty.
 	
-	DataSet(const uint32_t rX,const uint32_t rY,const uint32_t rZ) : 
+	DataSet(const uint32_t rX,const uint32_t rY,const uint32_t rZ,bool withOcclusion=true) : 
 		resolutionX(rX),resolutionY(rY),resolutionZ(rZ),layerXYSize(rX*rY),
 		isolevel(0.5),
 		rangeMinX(0),rangeMaxX(rX),rangeMinY(0),rangeMaxY(rY),rangeMinZ(0),rangeMaxZ(rZ),
-		density(rX*rY*rZ),occlusion(rX*rY*rZ)
+		density(static_cast<size_t>(rX)*rY*rZ),occlusion(withOcclusion ? static_cast<size_t>(rX)*rY*rZ : 0)
 		{}
 	
 };
-	
+
+/*! Sparse density field stored in cubic chunks of CHUNK_SIZE³ samples.
+	Chunks with a single value (e.g. empty space) only store that value; storage for a chunk is allocated
+	on the first write of a differing value. The whole resolution is polygonized and all vertices are white. */
+class ChunkedDataSet {
+	public:
+		static const uint32_t CHUNK_SIZE = 32;
+
+		const uint32_t resolutionX,resolutionY,resolutionZ;
+		float isolevel;
+
+		ChunkedDataSet(uint32_t rX, uint32_t rY, uint32_t rZ, float initialDensity = 0.0f);
+
+		float getDensity(uint32_t x, uint32_t y, uint32_t z) const {
+			const Chunk & chunk = chunks[getChunkIndex(x, y, z)];
+			return chunk.values ? chunk.values[getValueIndex(x, y, z)] : chunk.minValue;
+		}
+		void setDensity(uint32_t x, uint32_t y, uint32_t z, float value);
+		//! Set all samples of the chunk containing the given sample to @p value and release its storage.
+		void fillChunk(uint32_t x, uint32_t y, uint32_t z, float value);
+
+		size_t getAllocatedChunkCount() const;
+		/*! Return false if all samples in the given inclusive range are on the same side of the isolevel.
+			The test uses the value range of the chunks and may return true for ranges without the surface. */
+		bool mayContainSurface(uint32_t minX, uint32_t minY, uint32_t minZ, uint32_t maxX, uint32_t maxY, uint32_t maxZ) const;
+
+	private:
+		struct Chunk {
+			std::unique_ptr<float[]> values;
+			//! Bounds of the values ever written to the chunk
+			float minValue, maxValue;
+		};
+		const uint32_t chunksX,chunksY,chunksZ;
+		std::vector<Chunk> chunks;
+
+		size_t getChunkIndex(uint32_t x, uint32_t y, uint32_t z) const {
+			return (static_cast<size_t>(z / CHUNK_SIZE) * chunksY + y / CHUNK_SIZE) * chunksX + x / CHUNK_SIZE;
+		}
+		static uint32_t getValueIndex(uint32_t x, uint32_t y, uint32_t z) {
+			return ((z % CHUNK_SIZE) * CHUNK_SIZE + y % CHUNK_SIZE) * CHUNK_SIZE + x % CHUNK_SIZE;
+		}
+};
+
+/*! Create an indexed triangle mesh of the isosurface (position and color attributes).
+	The field is split into slabs along the z axis that are polygonized in parallel; vertices on shared cube
+	edges are created once (also across slabs), so the surface is watertight. Blocks of cubes that do not
+	contain the isolevel are skipped.
+	@return the mesh or nullptr if the surface is empty */
 Mesh * createMesh(DataSet & data);
+Mesh * createMesh(const ChunkedDataSet & data);
 Mesh * createMeshFromTiledImage(const Util::PixelAccessor & accessor, uint32_t sizeX, uint32_t sizeY, uint32_t sizeZ);
 }
 
@@ -0,0 +1,288 @@
+/*
+ This file is part of the Rendering library.
+ Copyright (C) 2026 agent <agent@local>
+
+ This library is subject to the terms of the Mozilla Public License, v. 2.0.
+ You should have received a copy of the MPL along with this library; see the
+ file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "MeshClusters.h"
+#include "../Mesh/Mesh.h"
+#include "../Mesh/MeshIndexData.h"
+#include "../Mesh/MeshVertexData.h"
+#include "../Mesh/VertexAttributeAccessors.h"
+#include "../Mesh/VertexAttributeIds.h"
+#include <Geometry/Matrix4x4.h>
+#include <Geometry/Vec3.h>
+#include <Util/Macros.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace Rendering {
+namespace MeshUtils {
+
+static const uint32_t NO_CLUSTER = std::numeric_limits<uint32_t>::max();
+
+//! (internal) Spread the lower 10 bits of the value to every third bit.
+static uint32_t spreadBits(uint32_t value) {
+	value &= 0x3ff;
+	value = (value | (value << 16)) & 0x030000ff;
+	value = (value | (value << 8)) & 0x0300f00f;
+	value = (value | (value << 4)) & 0x030c30c3;
+	value = (value | (value << 2)) & 0x09249249;
+	return value;
+}
+
+//! (internal) Compute the bounds and the normal cone of a cluster from its triangles.
+static void computeBounds(MeshClusters::Cluster & cluster, const std::vector<Geometry::Vec3> & positions, const uint32_t * indices) {
+	Geometry::Vec3 min(std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
+	Geometry::Vec3 max(std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest());
+	Geometry::Vec3 normalSum;
+	std::vector<Geometry::Vec3> normals;
+	normals.reserve(cluster.elementCount / 3);
+	for(uint32_t i = 0; i < cluster.elementCount; i += 3) {
+		const Geometry::Vec3 & a = positions[indices[i]];
+		const Geometry::Vec3 & b = positions[indices[i + 1]];
+		const Geometry::Vec3 & c = positions[indices[i + 2]];
+		for(const auto & p : {a, b, c}) {
+			for(uint_fast8_t axis = 0; axis < 3; ++axis) {
+				min[axis] = std::min(min[axis], p[axis]);
+				max[axis] = std::max(max[axis], p[axis]);
+			}
+		}
+		// the length of the cross product is twice the area
+		const Geometry::Vec3 areaNormal = (b - a).cross(c - a);
+		normalSum += areaNormal;
+		const float length = areaNormal.length();
+		if(length > 0)
+			normals.push_back(areaNormal / length);
+	}
+	const Geometry::Vec3 center = (min + max) * 0.5f;
+	float radiusSquared = 0;
+	for(uint32_t i = 0; i < cluster.elementCount; ++i)
+		radiusSquared = std::max(radiusSquared, center.distanceSquared(positions[indices[i]]));
+	for(uint_fast8_t axis = 0; axis < 3; ++axis) {
+		cluster.min[axis] = min[axis];
+		cluster.max[axis] = max[axis];
+		cluster.center[axis] = center[axis];
+	}
+	cluster.radius = std::sqrt(radiusSquared);
+
+	// normal cone: the smallest cosine between the average normal and a triangle normal
+	const float sumLength = normalSum.length();
+	float minCosine = sumLength > 0 && !normals.empty() ? 1.0f : -1.0f;
+	const Geometry::Vec3 axis = sumLength > 0 ? normalSum / sumLength : Geometry::Vec3(0, 0, 1);
+	for(const auto & normal : normals)
+		minCosine = std::min(minCosine, axis.dot(normal));
+	for(uint_fast8_t i = 0; i < 3; ++i)
+		cluster.coneAxis[i] = axis[i];
+	cluster.coneSine = minCosine > 0 ? std::sqrt(std::max(0.0f, 1.0f - minCosine * minCosine)) : 1.0f;
+}
+
+//! (static)
+std::shared_ptr<const MeshClusters> MeshClusters::build(Mesh * mesh, uint32_t maxVertices, uint32_t maxTriangles) {
+	if(mesh->getDrawMode() != Mesh::DRAW_TRIANGLES || !mesh->isUsingIndexData()) {
+		WARN("MeshClusters: Only indexed triangle meshes are supported.");
+		return nullptr;
+	}
+	maxVertices = std::max(3u, maxVertices);
+	maxTriangles = std::max(1u, maxTriangles);
+	MeshVertexData & vertexData = mesh->openVertexData();
+	MeshIndexData & indexData = mesh->openIndexData();
+	const uint32_t vertexCount = vertexData.getVertexCount();
+	const uint32_t triangleCount = indexData.getIndexCount() / 3;
+	const uint32_t * indices = indexData.data();
+
+	std::vector<Geometry::Vec3> positions(vertexCount);
+	{
+		auto posAcc = PositionAttributeAccessor::create(vertexData, VertexAttributeIds::POSITION);
+		posAcc->getPositions(0, vertexCount, reinterpret_cast<float *>(positions.data()));
+	}
+
+	// triangles of every vertex (compressed row storage)
+	std::vector<uint32_t> offsets(vertexCount + 1, 0);
+	for(uint32_t i = 0; i < 3 * triangleCount; ++i)
+		++offsets[indices[i] + 1];
+	std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+	std::vector<uint32_t> vertexTriangles(offsets.back());
+	{
+		std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+		for(uint32_t i = 0; i < 3 * triangleCount; ++i)
+			vertexTriangles[cursor[indices[i]]++] = i / 3;
+	}
+
+	// seeds in Morton order of the triangle centers
+	std::vector<Geometry::Vec3> centers(triangleCount);
+	std::vector<uint32_t> seeds(triangleCount);
+	{
+		const Geometry::Box & box = vertexData.getBoundingBox();
+		const float scale[3] = {box.getExtentX() > 0 ? 1023.0f / box.getExtentX() : 0.0f,
+								box.getExtentY() > 0 ? 1023.0f / box.getExtentY() : 0.0f,
+								box.getExtentZ() > 0 ? 1023.0f / box.getExtentZ() : 0.0f};
+		std::vector<uint32_t> codes(triangleCount);
+		for(uint32_t t = 0; t < triangleCount; ++t) {
+			centers[t] = (positions[indices[3 * t]] + positions[indices[3 * t + 1]] + positions[indices[3 * t + 2]]) / 3.0f;
+			const auto quantize = [&](uint_fast8_t axis, float minValue) {
+				return static_cast<uint32_t>(std::max(0.0f, std::min(1023.0f, (centers[t][axis] - minValue) * scale[axis])));
+			};
+			codes[t] = spreadBits(quantize(0, box.getMinX())) | (spreadBits(quantize(1, box.getMinY())) << 1) | (spreadBits(quantize(2, box.getMinZ())) << 2);
+		}
+		std::iota(seeds.begin(), seeds.end(), 0);
+		std::sort(seeds.begin(), seeds.end(), [&codes](uint32_t a, uint32_t b) { return codes[a] < codes[b] || (codes[a] == codes[b] && a < b); });
+	}
+
+	std::vector<uint32_t> triangleCluster(triangleCount, NO_CLUSTER);
+	std::vector<uint32_t> vertexCluster(vertexCount, NO_CLUSTER);
+	std::vector<uint32_t> liveTriangles(vertexCount);
+	for(uint32_t v = 0; v < vertexCount; ++v)
+		liveTriangles[v] = offsets[v + 1] - offsets[v];
+	std::vector<uint32_t> newIndices;
+	newIndices.reserve(3 * static_cast<size_t>(triangleCount));
+	std::vector<Cluster> clusters;
+	std::vector<uint32_t> candidates;
+	size_t seedCursor = 0;
+	while(true) {
+		while(seedCursor < seeds.size() && triangleCluster[seeds[seedCursor]] != NO_CLUSTER)
+			++seedCursor;
+		if(seedCursor == seeds.size())
+			break;
+		const uint32_t clusterId = static_cast<uint32_t>(clusters.size());
+		Cluster cluster;
+		cluster.firstElement = static_cast<uint32_t>(newIndices.size());
+		cluster.vertexCount = 0;
+		Geometry::Vec3 centerSum;
+		uint32_t clusterTriangles = 0;
+		candidates.clear();
+
+		auto countNewVertices = [&](uint32_t t) {
+			uint32_t count = 0;
+			for(uint_fast8_t k = 0; k < 3; ++k)
+				count += vertexCluster[indices[3 * t + k]] != clusterId ? 1 : 0;
+			return count;
+		};
+		uint32_t triangle = seeds[seedCursor];
+		while(true) {
+			// add the triangle
+			triangleCluster[triangle] = clusterId;
+			for(uint_fast8_t k = 0; k < 3; ++k) {
+				const uint32_t v = indices[3 * triangle + k];
+				newIndices.push_back(v);
+				--liveTriangles[v];
+				if(vertexCluster[v] != clusterId) {
+					vertexCluster[v] = clusterId;
+					++cluster.vertexCount;
+				}
+			}
+			centerSum += centers[triangle];
+			++clusterTriangles;
+			if(clusterTriangles == maxTriangles)
+				break;
+			const Geometry::Vec3 clusterCenter = centerSum / static_cast<float>(clusterTriangles);
+
+			// candidates are the unassigned neighbors of the cluster
+			for(uint_fast8_t k = 0; k < 3; ++k) {
+				const uint32_t v = indices[3 * triangle + k];
+				for(uint32_t i = offsets[v]; i < offsets[v + 1]; ++i) {
+					if(triangleCluster[vertexTriangles[i]] == NO_CLUSTER)
+						candidates.push_back(vertexTriangles[i]);
+				}
+			}
+			// prefer triangles adding few vertices, then triangles whose vertices have few remaining triangles
+			// (to avoid leaving isolated triangles behind), then triangles close to the cluster center
+			triangle = NO_CLUSTER;
+			uint32_t bestNewVertices = 4;
+			uint32_t bestLiveCount = std::numeric_limits<uint32_t>::max();
+			float bestDistance = std::numeric_limits<float>::max();
+			size_t keep = 0;
+			for(size_t i = 0; i < candidates.size(); ++i) {
+				const uint32_t t = candidates[i];
+				if(triangleCluster[t] != NO_CLUSTER)
+					continue;
+				candidates[keep++] = t;
+				const uint32_t newVertices = countNewVertices(t);
+				if(cluster.vertexCount + newVertices > maxVertices || newVertices > bestNewVertices)
+					continue;
+				const uint32_t liveCount = liveTriangles[indices[3 * t]] + liveTriangles[indices[3 * t + 1]] + liveTriangles[indices[3 * t + 2]];
+				const float distance = clusterCenter.distanceSquared(centers[t]);
+				if(newVertices < bestNewVertices || liveCount < bestLiveCount || (liveCount == bestLiveCount && distance < bestDistance)) {
+					triangle = t;
+					bestNewVertices = newVertices;
+					bestLiveCount = liveCount;
+					bestDistance = distance;
+				}
+			}
+			candidates.resize(keep);
+			if(triangle == NO_CLUSTER)
+				break;
+		}
+		cluster.elementCount = static_cast<uint32_t>(newIndices.size()) - cluster.firstElement;
+		clusters.push_back(cluster);
+	}
+
+	std::copy(newIndices.begin(), newIndices.end(), indexData.data());
+	indexData.markAsChanged();
+	for(auto & cluster : clusters)
+		computeBounds(cluster, positions, indexData.data() + cluster.firstElement);
+
+	auto result = std::make_shared<MeshClusters>(std::move(clusters));
+	result->vertexRevision = vertexData.getRevision();
+	result->indexRevision = indexData.getRevision();
+	mesh->_getClusterCache() = result;
+	return result;
+}
+
+//! (static)
+std::shared_ptr<const MeshClusters> MeshClusters::get(Mesh * mesh) {
+	const auto & cache = mesh->_getClusterCache();
+	if(cache && cache->vertexRevision == mesh->_getVertexData().getRevision() && cache->indexRevision == mesh->_getIndexData().getRevision())
+		return cache;
+	return nullptr;
+}
+
+uint32_t MeshClusters::cull(const Geometry::Matrix4x4 & viewProjection, const Geometry::Vec3 & cameraPosition, bool cullBackFaces,
+							std::vector<Range> & ranges) const {
+	// frustum planes (a, b, c, d) with a*x + b*y + c*z + d >= 0 inside (Gribb and Hartmann)
+	float planes[6][4];
+	for(uint_fast8_t p = 0; p < 6; ++p) {
+		const uint_fast8_t row = p / 2;
+		const float sign = (p % 2 == 0) ? 1.0f : -1.0f;
+		float length = 0;
+		for(uint_fast8_t col = 0; col < 4; ++col) {
+			planes[p][col] = viewProjection.at(3, col) + sign * viewProjection.at(row, col);
+			if(col < 3)
+				length += planes[p][col] * planes[p][col];
+		}
+		length = std::sqrt(length);
+		for(uint_fast8_t col = 0; col < 4; ++col)
+			planes[p][col] = length > 0 ? planes[p][col] / length : 0.0f;
+	}
+	const float camera[3] = {cameraPosition.getX(), cameraPosition.getY(), cameraPosition.getZ()};
+
+	uint32_t visibleCount = 0;
+	for(const auto & cluster : clusters) {
+		bool visible = true;
+		for(uint_fast8_t p = 0; p < 6 && visible; ++p)
+			visible = planes[p][0] * cluster.center[0] + planes[p][1] * cluster.center[1] + planes[p][2] * cluster.center[2] + planes[p][3] >= -cluster.radius;
+		if(visible && cullBackFaces && cluster.coneSine < 1.0f) {
+			// all triangles face away if the angle between the cone axis and every view direction to the sphere is below 90 degrees minus the cone angle
+			const float toCenter[3] = {cluster.center[0] - camera[0], cluster.center[1] - camera[1], cluster.center[2] - camera[2]};
+			const float distance = std::sqrt(toCenter[0] * toCenter[0] + toCenter[1] * toCenter[1] + toCenter[2] * toCenter[2]);
+			const float axisDistance = toCenter[0] * cluster.coneAxis[0] + toCenter[1] * cluster.coneAxis[1] + toCenter[2] * cluster.coneAxis[2];
+			visible = axisDistance < cluster.coneSine * (distance + cluster.radius) + cluster.radius;
+		}
+		if(!visible)
+			continue;
+		++visibleCount;
+		if(!ranges.empty() && ranges.back().firstElement + ranges.back().elementCount == cluster.firstElement)
+			ranges.back().elementCount += cluster.elementCount;
+		else
+			ranges.push_back({cluster.firstElement, cluster.elementCount});
+	}
+	return visibleCount;
+}
+
+}
+}
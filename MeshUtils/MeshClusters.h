@@ -0,0 +1,102 @@
+/*
+ This file is part of the Rendering library.
+ Copyright (C) 2026 agent <agent@local>
+
+ This library is subject to the terms of the Mozilla Public License, v. 2.0.
+ You should have received a copy of the MPL along with this library; see the
+ file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef RENDERING_MESHUTILS_MESHCLUSTERS_H_
+#define RENDERING_MESHUTILS_MESHCLUSTERS_H_
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace Geometry {
+template<typename _T> class _Matrix4x4;
+typedef _Matrix4x4<float> Matrix4x4;
+template<typename _T> class _Vec3;
+typedef _Vec3<float> Vec3;
+}
+namespace Rendering {
+class Mesh;
+namespace MeshUtils {
+
+/**
+ * Partitioning of the triangles of a mesh into small, spatially coherent clusters ("meshlets")
+ * with bounds for culling.
+ *
+ * build() reorders the index data of the mesh so that the triangles of every cluster form a
+ * contiguous element range. A cluster is grown from a seed triangle by adding adjacent triangles
+ * that add the fewest new vertices; seeds are taken in Morton order of the triangle centers.
+ * For every cluster, an axis-aligned bounding box, a bounding sphere and a normal cone are stored
+ * in flat arrays, so cull() can test many clusters per second on the CPU.
+ *
+ * The clusters are cached at the mesh; get() returns them as long as the vertex and index
+ * data of the mesh have not been marked as changed. MeshClusters are immutable.
+ * @ingroup mesh_accessor
+ */
+class MeshClusters {
+	public:
+		//! Cluster of triangles.
+		struct Cluster {
+			//! First index of the cluster in the index data
+			uint32_t firstElement;
+			//! Number of indices (three per triangle)
+			uint32_t elementCount;
+			float min[3];
+			float max[3];
+			float center[3];
+			float radius;
+			//! Average normal direction of the triangles
+			float coneAxis[3];
+			/*! Sine of the largest angle between the axis and a triangle normal.
+				Values of 1 or more disable the back-face test (normals deviate by more than 90 degrees). */
+			float coneSine;
+			//! Number of distinct vertices referenced by the cluster
+			uint32_t vertexCount;
+		};
+
+		//! Contiguous range of indices (arguments of Mesh::_display()).
+		struct Range {
+			uint32_t firstElement;
+			uint32_t elementCount;
+		};
+
+		/*! Split the triangles of the mesh into clusters of at most @p maxVertices distinct vertices and
+			@p maxTriangles triangles, reorder the index data accordingly and store the clusters at the mesh.
+			@note Only indexed triangle meshes are supported; otherwise nullptr is returned. */
+		static std::shared_ptr<const MeshClusters> build(Mesh * mesh, uint32_t maxVertices = 64, uint32_t maxTriangles = 124);
+
+		//! Return the clusters stored at the mesh, or nullptr if there are none or the mesh has been changed since.
+		static std::shared_ptr<const MeshClusters> get(Mesh * mesh);
+
+		const std::vector<Cluster> & getClusters() const	{	return clusters;	}
+
+		/*! Collect the element ranges of the clusters that are (potentially) visible.
+			Adjacent visible clusters are merged into one range. All parameters are given in the
+			object space of the mesh.
+			@param viewProjection Matrix transforming positions into clip space; clusters whose bounding
+				sphere is outside of one of its six planes are skipped.
+			@param cameraPosition Used for back-face culling
+			@param cullBackFaces Skip clusters whose triangles are all facing away from the camera
+			@param ranges Ranges of visible clusters are appended
+			@return the number of visible clusters */
+		uint32_t cull(const Geometry::Matrix4x4 & viewProjection, const Geometry::Vec3 & cameraPosition, bool cullBackFaces,
+					  std::vector<Range> & ranges) const;
+
+		MeshClusters(std::vector<Cluster> _clusters) : clusters(std::move(_clusters)), vertexRevision(0), indexRevision(0) {}
+
+	private:
+		std::vector<Cluster> clusters;
+		uint64_t vertexRevision;
+		uint64_t indexRevision;
+};
+
+}
+}
+
+#endif /* RENDERING_MESHUTILS_MESHCLUSTERS_H_ */
@@ -0,0 +1,343 @@
+/*
+ This file is part of the Rendering library.
+ Copyright (C) 2026 agent <agent@local>
+
+ This library is subject to the terms of the Mozilla Public License, v. 2.0.
+ You should have received a copy of the MPL along with this library; see the
+ file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "MeshOptimizer.h"
+
+#include "../Mesh/Mesh.h"
+#include "../Mesh/MeshIndexData.h"
+#include "../Mesh/MeshVertexData.h"
+#include "../Mesh/VertexAttributeAccessors.h"
+
+#include <Geometry/Vec3.h>
+#include <Util/Macros.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace Rendering {
+namespace MeshUtils {
+
+static const uint32_t INVALID_VERTEX = std::numeric_limits<uint32_t>::max();
+
+//! (internal) FIFO cache simulation using time stamps: an entry is cached if it was inserted less than @a size insertions ago.
+class FifoCache {
+		std::vector<uint32_t> insertionTimes;
+		const uint32_t size;
+		uint32_t time;
+	public:
+		FifoCache(size_t entryCount, uint32_t _size) : insertionTimes(entryCount, 0), size(_size), time(_size + 1) {}
+
+		uint32_t getTime() const						{	return time;	}
+		uint32_t getInsertionTime(uint32_t entry) const	{	return insertionTimes[entry];	}
+		bool isCached(uint32_t entry) const				{	return time - insertionTimes[entry] <= size;	}
+
+		//! Access an entry; returns true on a cache miss.
+		bool access(uint32_t entry) {
+			if(isCached(entry))
+				return false;
+			insertionTimes[entry] = time++;
+			return true;
+		}
+		//! Evict all entries.
+		void clear() {
+			time += size + 1;
+		}
+};
+
+//! (internal) Return false (after a warning) if the mesh is not an indexed triangle list with valid indices.
+static bool checkMesh(Mesh * mesh, const char * function) {
+	if(mesh->getDrawMode() != Mesh::DRAW_TRIANGLES || !mesh->isUsingIndexData()) {
+		WARN(std::string(function) + ": Only indexed triangle lists are supported.");
+		return false;
+	}
+	const MeshIndexData & indices = mesh->openIndexData();
+	const uint32_t vertexCount = mesh->getVertexCount();
+	for(uint32_t i = 0; i < indices.getIndexCount(); ++i) {
+		if(indices[i] >= vertexCount) {
+			WARN(std::string(function) + ": Invalid index.");
+			return false;
+		}
+	}
+	return true;
+}
+
+MeshStatistics analyzeMesh(Mesh * mesh, uint32_t cacheSize, uint32_t fetchCacheSize, uint32_t cacheLineSize) {
+	MeshStatistics statistics = {0.0f, 0.0f, 0.0f, 0, 0};
+	if(!checkMesh(mesh, "analyzeMesh") || mesh->getIndexCount() < 3)
+		return statistics;
+	const MeshIndexData & indices = mesh->openIndexData();
+	const uint32_t vertexCount = mesh->getVertexCount();
+	const size_t vertexSize = mesh->getVertexDescription().getVertexSize();
+	cacheLineSize = std::max(1u, cacheLineSize);
+
+	FifoCache vertexCache(vertexCount, cacheSize);
+	FifoCache lineCache((vertexCount * vertexSize + cacheLineSize - 1) / cacheLineSize, std::max(1u, fetchCacheSize / cacheLineSize));
+	std::vector<bool> referenced(vertexCount, false);
+	uint32_t referencedCount = 0;
+	for(uint32_t i = 0; i < indices.getIndexCount(); ++i) {
+		const uint32_t vertex = indices[i];
+		if(!referenced[vertex]) {
+			referenced[vertex] = true;
+			++referencedCount;
+		}
+		if(vertexCache.access(vertex)) {
+			++statistics.transformedVertices;
+			const size_t firstLine = vertex * vertexSize / cacheLineSize;
+			const size_t lastLine = ((vertex + 1) * vertexSize - 1) / cacheLineSize;
+			for(size_t line = firstLine; line <= lastLine; ++line) {
+				if(lineCache.access(static_cast<uint32_t>(line)))
+					++statistics.fetchedCacheLines;
+			}
+		}
+	}
+	statistics.acmr = static_cast<float>(statistics.transformedVertices) / (indices.getIndexCount() / 3);
+	statistics.atvr = static_cast<float>(statistics.transformedVertices) / referencedCount;
+	statistics.fetchOverhead = static_cast<float>(statistics.fetchedCacheLines * cacheLineSize) / (referencedCount * vertexSize);
+	return statistics;
+}
+
+// -----------------------------------------------------------------------------
+
+void optimizeVertexCache(uint32_t * indices, size_t indexCount, uint32_t vertexCount, uint32_t cacheSize, std::vector<uint32_t> * clusters) {
+	const size_t triangleCount = indexCount / 3;
+	if(clusters)
+		clusters->clear();
+	if(triangleCount == 0)
+		return;
+
+	// vertex-triangle adjacency in compressed rows
+	std::vector<uint32_t> offsets(vertexCount + 1, 0);
+	for(size_t i = 0; i < 3 * triangleCount; ++i)
+		++offsets[indices[i] + 1];
+	for(uint32_t v = 0; v < vertexCount; ++v)
+		offsets[v + 1] += offsets[v];
+	std::vector<uint32_t> adjacency(3 * triangleCount);
+	{
+		std::vector<uint32_t> cursors(offsets.begin(), offsets.end() - 1);
+		for(size_t i = 0; i < 3 * triangleCount; ++i)
+			adjacency[cursors[indices[i]]++] = static_cast<uint32_t>(i / 3);
+	}
+
+	std::vector<uint32_t> liveTriangles(vertexCount);
+	for(uint32_t v = 0; v < vertexCount; ++v)
+		liveTriangles[v] = offsets[v + 1] - offsets[v];
+	FifoCache cache(vertexCount, cacheSize);
+	std::vector<uint32_t> deadEndStack;
+	deadEndStack.reserve(3 * triangleCount);
+	std::vector<bool> emitted(triangleCount, false);
+	std::vector<uint32_t> candidates;
+	std::vector<uint32_t> output(3 * triangleCount);
+	size_t outputTriangles = 0;
+
+	uint32_t cursor = 0;
+	while(cursor < vertexCount && liveTriangles[cursor] == 0)
+		++cursor;
+	uint32_t fanVertex = cursor;
+	bool newCluster = true;
+	while(fanVertex != INVALID_VERTEX) {
+		// emit the live triangles of the fanning vertex
+		candidates.clear();
+		for(uint32_t k = offsets[fanVertex]; k < offsets[fanVertex + 1]; ++k) {
+			const uint32_t triangle = adjacency[k];
+			if(emitted[triangle])
+				continue;
+			if(newCluster && clusters)
+				clusters->push_back(static_cast<uint32_t>(outputTriangles));
+			newCluster = false;
+			for(uint_fast8_t c = 0; c < 3; ++c) {
+				const uint32_t v = indices[3 * triangle + c];
+				output[3 * outputTriangles + c] = v;
+				deadEndStack.push_back(v);
+				candidates.push_back(v);
+				--liveTriangles[v];
+				cache.access(v);
+			}
+			emitted[triangle] = true;
+			++outputTriangles;
+		}
+
+		// select the candidate that will still be in the cache after fanning and has been in the cache the longest
+		uint32_t nextVertex = INVALID_VERTEX;
+		int64_t maxPriority = -1;
+		for(const auto v : candidates) {
+			if(liveTriangles[v] == 0)
+				continue;
+			const uint32_t age = cache.getTime() - cache.getInsertionTime(v);
+			const int64_t priority = (age + 2 * liveTriangles[v] <= cacheSize) ? age : 0;
+			if(priority > maxPriority) {
+				maxPriority = priority;
+				nextVertex = v;
+			}
+		}
+		if(nextVertex == INVALID_VERTEX) {
+			// dead end: continue with a recently used vertex or with the next vertex in input order
+			newCluster = true;
+			while(!deadEndStack.empty() && nextVertex == INVALID_VERTEX) {
+				const uint32_t v = deadEndStack.back();
+				deadEndStack.pop_back();
+				if(liveTriangles[v] > 0)
+					nextVertex = v;
+			}
+			while(nextVertex == INVALID_VERTEX && cursor < vertexCount) {
+				if(liveTriangles[cursor] > 0)
+					nextVertex = cursor;
+				else
+					++cursor;
+			}
+		}
+		fanVertex = nextVertex;
+	}
+	std::copy(output.begin(), output.end(), indices);
+}
+
+void optimizeVertexCache(Mesh * mesh, uint32_t cacheSize) {
+	if(!checkMesh(mesh, "optimizeVertexCache"))
+		return;
+	MeshIndexData & indices = mesh->openIndexData();
+	optimizeVertexCache(indices.data(), indices.getIndexCount(), mesh->getVertexCount(), cacheSize);
+	indices.markAsChanged();
+}
+
+// -----------------------------------------------------------------------------
+
+void optimizeOverdraw(Mesh * mesh, float threshold, uint32_t cacheSize) {
+	if(!checkMesh(mesh, "optimizeOverdraw"))
+		return;
+	MeshIndexData & indexData = mesh->openIndexData();
+	uint32_t * indices = indexData.data();
+	const uint32_t triangleCount = indexData.getIndexCount() / 3;
+	const uint32_t vertexCount = mesh->getVertexCount();
+	if(triangleCount == 0)
+		return;
+
+	// the clusters of the cache optimization are split where the local cache efficiency is good enough
+	std::vector<uint32_t> hardClusters;
+	optimizeVertexCache(indices, 3 * triangleCount, vertexCount, cacheSize, &hardClusters);
+	hardClusters.push_back(triangleCount);
+	std::vector<uint32_t> clusters;
+	FifoCache cache(vertexCount, cacheSize);
+	auto getMisses = [&](uint32_t triangle) {
+		return static_cast<uint32_t>(cache.access(indices[3 * triangle])) + cache.access(indices[3 * triangle + 1]) + cache.access(indices[3 * triangle + 2]);
+	};
+	for(size_t h = 0; h + 1 < hardClusters.size(); ++h) {
+		const uint32_t begin = hardClusters[h];
+		const uint32_t end = hardClusters[h + 1];
+		cache.clear();
+		uint32_t misses = 0;
+		for(uint32_t t = begin; t < end; ++t)
+			misses += getMisses(t);
+		const float maxMissRatio = threshold * misses / (end - begin);
+
+		cache.clear();
+		clusters.push_back(begin);
+		uint32_t clusterBegin = begin;
+		uint32_t clusterMisses = 0;
+		for(uint32_t t = begin; t < end; ++t) {
+			clusterMisses += getMisses(t);
+			if(t + 1 < end && static_cast<float>(clusterMisses) / (t + 1 - clusterBegin) <= maxMissRatio) {
+				clusterBegin = t + 1;
+				clusterMisses = 0;
+				clusters.push_back(clusterBegin);
+				cache.clear();
+			}
+		}
+	}
+	clusters.push_back(triangleCount);
+
+	// sort the clusters by the orientation of their (area weighted) normals relative to the mesh's center
+	auto positions = PositionAttributeAccessor::create(mesh->openVertexData());
+	std::vector<Geometry::Vec3> clusterCenters(clusters.size() - 1);
+	std::vector<Geometry::Vec3> clusterNormals(clusters.size() - 1);
+	Geometry::Vec3 meshCenter;
+	float meshArea = 0.0f;
+	for(size_t c = 0; c + 1 < clusters.size(); ++c) {
+		Geometry::Vec3 center;
+		Geometry::Vec3 normal;
+		float area = 0.0f;
+		for(uint32_t t = clusters[c]; t < clusters[c + 1]; ++t) {
+			const Geometry::Vec3 p0 = positions->getPosition(indices[3 * t]);
+			const Geometry::Vec3 p1 = positions->getPosition(indices[3 * t + 1]);
+			const Geometry::Vec3 p2 = positions->getPosition(indices[3 * t + 2]);
+			const Geometry::Vec3 cross = (p1 - p0).cross(p2 - p0);
+			const float triangleArea = cross.length();
+			center += (p0 + p1 + p2) * (triangleArea / 3.0f);
+			normal += cross;
+			area += triangleArea;
+		}
+		meshCenter += center;
+		meshArea += area;
+		clusterCenters[c] = area > 0.0f ? center / area : center;
+		clusterNormals[c] = normal;
+	}
+	if(meshArea > 0.0f)
+		meshCenter /= meshArea;
+	std::vector<std::pair<float, uint32_t>> order;
+	for(uint32_t c = 0; c + 1 < clusters.size(); ++c) {
+		const float normalLength = clusterNormals[c].length();
+		const float dot = normalLength > 0.0f ? (clusterCenters[c] - meshCenter).dot(clusterNormals[c]) / normalLength : 0.0f;
+		order.emplace_back(-dot, c);
+	}
+	std::stable_sort(order.begin(), order.end(), [](const std::pair<float, uint32_t> & a, const std::pair<float, uint32_t> & b) {
+		return a.first < b.first;
+	});
+
+	std::vector<uint32_t> output;
+	output.reserve(3 * triangleCount);
+	for(const auto & entry : order)
+		output.insert(output.end(), indices + 3 * clusters[entry.second], indices + 3 * clusters[entry.second + 1]);
+	std::copy(output.begin(), output.end(), indices);
+	indexData.markAsChanged();
+}
+
+// -----------------------------------------------------------------------------
+
+uint32_t optimizeVertexFetch(Mesh * mesh) {
+	if(!checkMesh(mesh, "optimizeVertexFetch"))
+		return mesh->getVertexCount();
+	MeshIndexData & indexData = mesh->openIndexData();
+	MeshVertexData & vertices = mesh->openVertexData();
+	uint32_t * indices = indexData.data();
+	const uint32_t oldVertexCount = vertices.getVertexCount();
+
+	std::vector<uint32_t> newIndices(oldVertexCount, INVALID_VERTEX);
+	uint32_t newVertexCount = 0;
+	for(uint32_t i = 0; i < indexData.getIndexCount(); ++i) {
+		uint32_t & newIndex = newIndices[indices[i]];
+		if(newIndex == INVALID_VERTEX)
+			newIndex = newVertexCount++;
+		indices[i] = newIndex;
+	}
+
+	MeshVertexData newVertices;
+	newVertices.allocate(newVertexCount, vertices.getVertexDescription());
+	const size_t vertexSize = vertices.getVertexDescription().getVertexSize();
+	const uint8_t * source = vertices.data();
+	uint8_t * target = newVertices.data();
+	for(uint32_t v = 0; v < oldVertexCount; ++v) {
+		if(newIndices[v] != INVALID_VERTEX)
+			std::memcpy(target + newIndices[v] * vertexSize, source + v * vertexSize, vertexSize);
+	}
+	if(vertices.getPositionDequantization())
+		newVertices.setPositionDequantization(*vertices.getPositionDequantization());
+	newVertices.updateBoundingBox();
+	vertices.swap(newVertices);
+	vertices.markAsChanged();
+	indexData.updateIndexRange();
+	indexData.markAsChanged();
+	return newVertexCount;
+}
+
+void optimizeMesh(Mesh * mesh, float overdrawThreshold, uint32_t cacheSize) {
+	optimizeOverdraw(mesh, overdrawThreshold, cacheSize);
+	optimizeVertexFetch(mesh);
+}
+
+}
+}
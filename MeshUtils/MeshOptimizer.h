@@ -0,0 +1,90 @@
+/*
+ This file is part of the Rendering library.
+ Copyright (C) 2026 agent <agent@local>
+
+ This library is subject to the terms of the Mozilla Public License, v. 2.0.
+ You should have received a copy of the MPL along with this library; see the
+ file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef RENDERING_MESHUTILS_MESHOPTIMIZER_H_
+#define RENDERING_MESHUTILS_MESHOPTIMIZER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Rendering {
+class Mesh;
+namespace MeshUtils {
+
+/**
+ * @defgroup mesh_optimizer Mesh optimizer
+ * Reordering of triangle lists and vertices for rendering performance.
+ *
+ * A full optimization consists of three steps that are applied in this order (see optimizeMesh()):
+ * -# optimizeVertexCache() reorders the triangles for the post-transform vertex cache,
+ * -# optimizeOverdraw() reorders clusters of these triangles so that the triangles facing outwards are drawn first,
+ *    without reducing the cache efficiency by more than a given factor (it includes the first step),
+ * -# optimizeVertexFetch() reorders the vertices in the order of their first use.
+ *
+ * analyzeMesh() measures the result; the cache is simulated as FIFO cache, like in most GPUs.
+ * All functions work on meshes with DRAW_TRIANGLES and run in time linear in the number of indices
+ * (plus sorting the clusters for overdraw optimization).
+ * @ingroup mesh_optimizer
+ * @{
+ */
+
+//! Result of analyzeMesh().
+struct MeshStatistics {
+	//! Average cache miss ratio: number of transformed vertices per triangle (0.5 is optimal for large grids, 3 is the worst case)
+	float acmr;
+	//! Average transform to vertex ratio: number of transformed vertices per referenced vertex (1 is optimal)
+	float atvr;
+	/*! Ratio of the bytes fetched from the vertex buffer (in cache lines) to the size of the referenced vertices.
+		1 is optimal; values above 1 mean that vertices are fetched in an incoherent order. */
+	float fetchOverhead;
+	//! Number of simulated vertex shader invocations
+	uint64_t transformedVertices;
+	//! Number of simulated cache lines fetched from the vertex buffer
+	uint64_t fetchedCacheLines;
+};
+
+/*! Simulate the rendering of @p mesh with a FIFO post-transform cache of @p cacheSize entries and a
+	vertex fetch cache of @p fetchCacheSize bytes consisting of @p cacheLineSize byte lines. */
+MeshStatistics analyzeMesh(Mesh * mesh, uint32_t cacheSize = 16, uint32_t fetchCacheSize = 16384, uint32_t cacheLineSize = 64);
+
+/*! Reorder the triangles of the index array for a post-transform cache with @p cacheSize entries.
+	Implements 'Tipsify' (Sander, Nehab and Barczak: Fast triangle reordering for vertex locality and
+	reduced overdraw, 2007) with flat arrays in linear time.
+	@param clusters If not null, receives the index of the first triangle of every cluster
+		(sequence of triangles that is emitted without jumping to a non-adjacent vertex), ascending.
+	@see http://doi.acm.org/10.1145/1276377.1276489 */
+void optimizeVertexCache(uint32_t * indices, size_t indexCount, uint32_t vertexCount, uint32_t cacheSize,
+						std::vector<uint32_t> * clusters = nullptr);
+
+//! Reorder the triangles of the mesh with optimizeVertexCache().
+void optimizeVertexCache(Mesh * mesh, uint32_t cacheSize = 16);
+
+/*! Reorder clusters of triangles of the mesh to reduce overdraw.
+	The triangles are reordered with optimizeVertexCache() first. The clusters found by it
+	are split further as long as the cache miss ratio of a cluster is below
+	@p threshold times the ratio of the original cluster. Clusters are then sorted by the
+	orientation of their normals relative to the center of the mesh, so that clusters on the
+	outside of the mesh are drawn first.
+	@param threshold 1 keeps the cache efficiency; 1.05 allows 5% more vertex transformations */
+void optimizeOverdraw(Mesh * mesh, float threshold = 1.05f, uint32_t cacheSize = 16);
+
+/*! Reorder the vertices of the mesh in the order of their first use by the indices and update
+	the indices accordingly. Vertices that are not referenced are removed.
+	@return the number of vertices after the reordering */
+uint32_t optimizeVertexFetch(Mesh * mesh);
+
+//! Apply optimizeVertexCache(), optimizeOverdraw() and optimizeVertexFetch().
+void optimizeMesh(Mesh * mesh, float overdrawThreshold = 1.05f, uint32_t cacheSize = 16);
+
+//! @}
+}
+}
+
+#endif /* RENDERING_MESHUTILS_MESHOPTIMIZER_H_ */
@@ -18,8 +18,13 @@
 #include "../Texture/Texture.h"
 #include "../Texture/TextureUtils.h"
 #include "TriangleAccessor.h"
+#include "MeshOptimizer.h"
+#include "NormalCalculation.h"
+#include "TriangleBVH.h"
+#include "ParallelFor.h"
 #include <Geometry/BoundingSphere.h>
 #include <Geometry/Box.h>
+#include <Geometry/Convert.h>
 #include <Geometry/Matrix4x4.h>
 #include <Geometry/Sphere.h>
 #include <Geometry/Tools.h>
@@ -39,6 +44,7 @@
 #include <Util/Utils.h>
 #include <Util/Numeric.h>
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <cstring> /* for memcmp */
 #include <map>
@@ -46,7 +52,6 @@
 #include <queue>
 #include <deque>
 #include <set>
-#include <stack>
 #include <stdexcept>
 #include <vector>
 #include <unordered_map>
@@ -638,6 +643,116 @@ void shrinkMesh(Mesh * m, bool shrinkPosition) {
 
 // -----------------------------------------------------------------------------
 
+//! (internal) Decoding and encoding of the components of a vertex attribute.
+struct FloatComponents {
+	typedef float value_t;
+	static float decode(float v)		{	return v;	}
+	static float encode(float f)		{	return f;	}
+};
+struct HalfComponents {
+	typedef uint16_t value_t;
+	static float decode(uint16_t v)		{	return Geometry::Convert::halfToFloat(v);	}
+	static uint16_t encode(float f)		{	return Geometry::Convert::floatToHalf(f);	}
+};
+struct NormalizedByteComponents {
+	typedef int8_t value_t;
+	static float decode(int8_t v)		{	return Geometry::Convert::fromSignedTo<float>(v);	}
+	static int8_t encode(float f)		{	return Geometry::Convert::toSigned<int8_t>(f);	}
+};
+
+/*! (internal) Transform the first three components of an attribute of the vertices [begin, end) as position (w = 1)
+	or as direction (w = 0). The vertices are processed in blocks: the components are decoded into separate
+	arrays, transformed by a loop the compiler can vectorize, and encoded again. */
+template<typename Components_t, bool isPosition>
+static void transformBlocks(uint8_t * data, size_t stride, uint32_t begin, uint32_t end, const Matrix4x4f & transMat) {
+	typedef typename Components_t::value_t value_t;
+	static const uint32_t BLOCK_SIZE = 64;
+	float m[4][4];
+	for(uint_fast8_t row = 0; row < 4; ++row)
+		for(uint_fast8_t col = 0; col < 4; ++col)
+			m[row][col] = transMat.at(row, col);
+	float x[BLOCK_SIZE], y[BLOCK_SIZE], z[BLOCK_SIZE];
+	for(uint32_t blockBegin = begin; blockBegin < end; blockBegin += BLOCK_SIZE) {
+		const uint32_t count = std::min(BLOCK_SIZE, end - blockBegin);
+		for(uint32_t i = 0; i < count; ++i) {
+			const value_t * v = reinterpret_cast<const value_t *>(data + (blockBegin + i) * stride);
+			x[i] = Components_t::decode(v[0]);
+			y[i] = Components_t::decode(v[1]);
+			z[i] = Components_t::decode(v[2]);
+		}
+		for(uint32_t i = 0; i < count; ++i) {
+			const float tx = m[0][0] * x[i] + m[0][1] * y[i] + m[0][2] * z[i] + (isPosition ? m[0][3] : 0.0f);
+			const float ty = m[1][0] * x[i] + m[1][1] * y[i] + m[1][2] * z[i] + (isPosition ? m[1][3] : 0.0f);
+			const float tz = m[2][0] * x[i] + m[2][1] * y[i] + m[2][2] * z[i] + (isPosition ? m[2][3] : 0.0f);
+			if(isPosition) {
+				const float w = m[3][0] * x[i] + m[3][1] * y[i] + m[3][2] * z[i] + m[3][3];
+				x[i] = tx / w;
+				y[i] = ty / w;
+				z[i] = tz / w;
+			} else {
+				x[i] = tx;
+				y[i] = ty;
+				z[i] = tz;
+			}
+		}
+		for(uint32_t i = 0; i < count; ++i) {
+			value_t * v = reinterpret_cast<value_t *>(data + (blockBegin + i) * stride);
+			v[0] = Components_t::encode(x[i]);
+			v[1] = Components_t::encode(y[i]);
+			v[2] = Components_t::encode(z[i]);
+		}
+	}
+}
+
+//! (internal) Return true if the attribute is transformed by transformBlocks().
+static bool hasTransformKernel(const VertexAttribute & attr, bool isPosition) {
+	return (attr.getNumValues() >= 3 && attr.getDataType() == GL_FLOAT)
+			|| (isPosition && attr.getNumValues() >= 3 && attr.getDataType() == GL_HALF_FLOAT)
+			|| (!isPosition && attr.getNumValues() >= 4 && attr.getDataType() == GL_BYTE);
+}
+
+/*! (internal) Transform the positions (or normals) of the vertices [begin, end) without marking the data as changed.
+	Float, half float positions and byte normals are transformed by transformBlocks(); other formats use the
+	attribute accessors (which throw for unknown attributes and formats). */
+static void transformVertexRange(MeshVertexData & vData, Util::StringIdentifier attrName, const Matrix4x4f & transMat, uint32_t begin, uint32_t end, bool isPosition) {
+	const VertexAttribute & attr = vData.getVertexDescription().getAttribute(attrName);
+	const size_t stride = vData.getVertexDescription().getVertexSize();
+	uint8_t * data = vData.data() + attr.getOffset();
+	if(!hasTransformKernel(attr, isPosition)) {
+		if(isPosition) {
+			Util::Reference<PositionAttributeAccessor> positionAccessor(PositionAttributeAccessor::create(vData,attrName));
+			for(uint32_t i=begin;i<end;++i)
+				positionAccessor->setPosition(i,transMat.transformPosition(positionAccessor->getPosition(i)));
+		} else {
+			Util::Reference<NormalAttributeAccessor> normalAccessor(NormalAttributeAccessor::create(vData,attrName));
+			for(uint32_t i=begin;i<end;++i)
+				normalAccessor->setNormal(i, (transMat * Geometry::Vec4(normalAccessor->getNormal(i),0)).xyz());
+		}
+	} else if(attr.getDataType() == GL_FLOAT) {
+		if(isPosition)
+			transformBlocks<FloatComponents, true>(data, stride, begin, end, transMat);
+		else
+			transformBlocks<FloatComponents, false>(data, stride, begin, end, transMat);
+	} else if(attr.getDataType() == GL_HALF_FLOAT) {
+		transformBlocks<HalfComponents, true>(data, stride, begin, end, transMat);
+	} else {
+		transformBlocks<NormalizedByteComponents, false>(data, stride, begin, end, transMat);
+	}
+}
+
+//! (internal) Transform a range of vertices on several threads.
+static void transformVertexRangeParallel(MeshVertexData & vData, Util::StringIdentifier attrName, const Matrix4x4f & transMat, uint32_t begin,
+		uint32_t numVerts, bool isPosition) {
+	// other formats are transformed on the calling thread, so that the accessors' exceptions reach the caller
+	if(!hasTransformKernel(vData.getVertexDescription().getAttribute(attrName), isPosition)) {
+		transformVertexRange(vData, attrName, transMat, begin, begin + numVerts, isPosition);
+		return;
+	}
+	parallelFor(numVerts, 65536, [&](uint32_t rangeBegin, uint32_t rangeEnd) {
+		transformVertexRange(vData, attrName, transMat, begin + rangeBegin, begin + rangeEnd, isPosition);
+	});
+}
+
 //! (internal) Transforms a range of vertices with the given matrix.
 static void transformVertexData(MeshVertexData & vData, const Matrix4x4f & transMat, uint32_t begin, uint32_t numVerts) {
 	transformCoordinates(vData, VertexAttributeIds::POSITION, transMat, begin, numVerts);
@@ -658,11 +773,7 @@ void transform(MeshVertexData & vData, const Matrix4x4f & transMat) {
 //! (static)
 void transformCoordinates(MeshVertexData & vData, Util::StringIdentifier attrName, const Geometry::Matrix4x4 & transMat, uint32_t begin,
 		uint32_t numVerts) {
-
-	Util::Reference<PositionAttributeAccessor> positionAccessor(PositionAttributeAccessor::create(vData,attrName));
-	const uint32_t end = begin+numVerts;
-	for(uint32_t i=begin;i<end;++i)
-		positionAccessor->setPosition(i,transMat.transformPosition(positionAccessor->getPosition(i)));
+	transformVertexRangeParallel(vData, attrName, transMat, begin, numVerts, true);
 	vData.markAsChanged();
 }
 
@@ -671,43 +782,54 @@ void transformCoordinates(MeshVertexData & vData, Util::StringIdentifier attrNam
 //! (static)
 void transformNormals(MeshVertexData & vData, Util::StringIdentifier attrName, const Geometry::Matrix4x4 & transMat, uint32_t begin,
 		uint32_t numVerts) {
-
-	Util::Reference<NormalAttributeAccessor> normalAccessor(NormalAttributeAccessor::create(vData,attrName));
-	const uint32_t end = begin+numVerts;
-	for(uint32_t i=begin;i<end;++i)
-		normalAccessor->setNormal(i, (transMat * Geometry::Vec4(normalAccessor->getNormal(i),0)).xyz());
+	transformVertexRangeParallel(vData, attrName, transMat, begin, numVerts, false);
 	vData.markAsChanged();
 }
 
 // -----------------------------------------------------------------------------
 
-inline bool canConvert(const VertexAttribute& oldAttr, const VertexAttribute& newAttr) {
-	if(oldAttr.getDataType() == GL_FLOAT) {
-		return newAttr.getDataType() == GL_BYTE || newAttr.getDataType() == GL_UNSIGNED_BYTE; // float to byte
-	} else if(newAttr.getDataType() == GL_FLOAT) {
-		return oldAttr.getDataType() == GL_BYTE || oldAttr.getDataType() == GL_UNSIGNED_BYTE; // byte to float
-	}
-	return false;
+inline bool isConvertibleType(uint32_t glType) {
+	return glType == GL_FLOAT || glType == GL_HALF_FLOAT || glType == GL_BYTE || glType == GL_UNSIGNED_BYTE
+			|| glType == GL_SHORT || glType == GL_UNSIGNED_SHORT;
 }
 
-// -----------------------------------------------------------------------------
+inline bool canConvert(const VertexAttribute& oldAttr, const VertexAttribute& newAttr) {
+	return oldAttr.getDataType() != newAttr.getDataType() && isConvertibleType(oldAttr.getDataType()) && isConvertibleType(newAttr.getDataType());
+}
 
-//! (static)
-MeshVertexData * convertVertices(const MeshVertexData & oldVertices, const VertexDescription & newVertexDescription) {
+//! Quantized positions have to be converted through their dequantization transformation.
+inline bool isQuantizedPositionConversion(const VertexAttribute& oldAttr, const VertexAttribute& newAttr) {
+	return oldAttr.getNameId() == VertexAttributeIds::POSITION && oldAttr.getNumValues() >= 3 && newAttr.getNumValues() >= 3
+			&& (oldAttr.getDataType() == GL_UNSIGNED_SHORT || newAttr.getDataType() == GL_UNSIGNED_SHORT);
+}
 
-	const VertexDescription & oldVertexDescription = oldVertices.getVertexDescription();
-	if (oldVertexDescription == newVertexDescription)
-		return new MeshVertexData(oldVertices);
+inline bool isNormalFormat(const VertexAttribute& attr) {
+	return (attr.getDataType() == GL_FLOAT && attr.getNumValues() >= 3) || (attr.getDataType() == GL_BYTE && attr.getNumValues() >= 4)
+			|| (attr.getDataType() == GL_SHORT && (attr.getNumValues() == 2 || attr.getNumValues() == 4));
+}
 
-	const uint32_t numVertices = oldVertices.getVertexCount();
-	auto newVertices = new MeshVertexData;
-	newVertices->allocate(numVertices, newVertexDescription);
+//! Octahedral normals and tangents (stored as shorts) have to be converted through their decoded vectors.
+inline bool isOctahedralNormalConversion(const VertexAttribute& oldAttr, const VertexAttribute& newAttr) {
+	return (oldAttr.getNameId() == VertexAttributeIds::NORMAL || oldAttr.getNameId() == VertexAttributeIds::TANGENT)
+			&& isNormalFormat(oldAttr) && isNormalFormat(newAttr)
+			&& (oldAttr.getDataType() == GL_SHORT || newAttr.getDataType() == GL_SHORT);
+}
 
-	// Initialize the data with zero.
-	std::fill_n(newVertices->data(), newVertices->dataSize(), 0);
+// -----------------------------------------------------------------------------
 
+/*! (internal) Convert all vertices of @p oldVertices into the description of @p newVertices and store them
+	starting at vertex @p begin. Attributes missing in the old vertices are set to zero. */
+static void convertVertexRange(const MeshVertexData & oldVertices, MeshVertexData & newVertices, uint32_t begin) {
+	const VertexDescription & oldVertexDescription = oldVertices.getVertexDescription();
+	const VertexDescription & newVertexDescription = newVertices.getVertexDescription();
+	const uint32_t numVertices = oldVertices.getVertexCount();
 	const std::size_t oldVertexSize = oldVertexDescription.getVertexSize();
 	const std::size_t newVertexSize = newVertexDescription.getVertexSize();
+	if (numVertices == 0)
+		return;
+
+	// Initialize the data with zero.
+	std::fill_n(newVertices[begin], numVertices * newVertexSize, 0);
 	for(const auto & oldAttr : oldVertexDescription.getAttributes()) {
 		const VertexAttribute & newAttr = newVertexDescription.getAttribute(oldAttr.getNameId());
 
@@ -717,20 +839,51 @@ MeshVertexData * convertVertices(const MeshVertexData & oldVertices, const Verte
 		if(oldAttr.getDataType() == newAttr.getDataType()) {					
 			uint32_t dataSize = std::min(oldAttr.getDataSize(), newAttr.getDataSize());
 			const uint8_t * source = oldVertices.data() + oldAttr.getOffset();
-			uint8_t * target = newVertices->data() + newAttr.getOffset();
+			uint8_t * target = newVertices[begin] + newAttr.getOffset();
 			for (uint32_t i = 0; i < numVertices; ++i) {
 				std::copy(source, source + dataSize, target);
 				source += oldVertexSize;
 				target += newVertexSize;
 			}			
+		} else if( isQuantizedPositionConversion(oldAttr, newAttr) ) {
+			auto oldAcc = PositionAttributeAccessor::create(const_cast<MeshVertexData&>(oldVertices), newAttr.getNameId());
+			auto newAcc = PositionAttributeAccessor::create(newVertices, newAttr.getNameId());
+			for (uint32_t i = 0; i < numVertices; ++i) {
+				newAcc->setPosition(begin + i, oldAcc->getPosition(i));
+			}
+		} else if( isOctahedralNormalConversion(oldAttr, newAttr) ) {
+			auto oldAcc = NormalAttributeAccessor::create(const_cast<MeshVertexData&>(oldVertices), newAttr.getNameId());
+			auto newAcc = NormalAttributeAccessor::create(newVertices, newAttr.getNameId());
+			for (uint32_t i = 0; i < numVertices; ++i) {
+				newAcc->setNormal(begin + i, oldAcc->getNormal(i));
+			}
 		} else if( canConvert(oldAttr, newAttr) ) {
 			auto oldAcc = FloatAttributeAccessor::create(const_cast<MeshVertexData&>(oldVertices), newAttr.getNameId());
-			auto newAcc = FloatAttributeAccessor::create(*newVertices, newAttr.getNameId());
+			auto newAcc = FloatAttributeAccessor::create(newVertices, newAttr.getNameId());
 			for (uint32_t i = 0; i < numVertices; ++i) {
-				newAcc->setValues(i, oldAcc->getValues(i));
+				newAcc->setValues(begin + i, oldAcc->getValues(i));
 			}
 		}
 	}
+}
+
+//! (static)
+MeshVertexData * convertVertices(const MeshVertexData & oldVertices, const VertexDescription & newVertexDescription) {
+
+	const VertexDescription & oldVertexDescription = oldVertices.getVertexDescription();
+	if (oldVertexDescription == newVertexDescription)
+		return new MeshVertexData(oldVertices);
+
+	auto newVertices = new MeshVertexData;
+	newVertices->allocate(oldVertices.getVertexCount(), newVertexDescription);
+	if(oldVertices.getPositionDequantization())
+		newVertices->setPositionDequantization(*oldVertices.getPositionDequantization());
+
+	convertVertexRange(oldVertices, *newVertices, 0);
+
+	const VertexAttribute & newPosAttr = newVertexDescription.getAttribute(VertexAttributeIds::POSITION);
+	if(newPosAttr.empty() || newPosAttr.getDataType() != GL_UNSIGNED_SHORT)
+		newVertices->clearPositionDequantization();
 	newVertices->updateBoundingBox();
 	return newVertices;
 }
@@ -774,47 +927,7 @@ void removeColorData(Mesh * m) {
 
 //! (static)
 void calculateNormals(Mesh * m) {
-	MeshVertexData & vData = m->openVertexData();
-
-	// add normals to vData if necessary
-	if (!vData.getVertexDescription().hasAttribute(VertexAttributeIds::NORMAL)) {
-		VertexDescription newVd = vData.getVertexDescription();
-		newVd.appendNormalByte();
-		std::unique_ptr<MeshVertexData> newVertices(convertVertices(vData, newVd));
-		vData.swap(*newVertices.get());
-	}
-
-	const uint32_t vertexCount = vData.getVertexCount();
-
-	std::vector<Geometry::Vec3> normals(vertexCount);
-
-	// accumulate normals
-	const MeshIndexData & indices = m->openIndexData();
-	const uint32_t indexCount = m->getIndexCount();
-	Util::Reference<PositionAttributeAccessor> positionAccessor(PositionAttributeAccessor::create(vData,VertexAttributeIds::POSITION));
-	for (uint32_t i = 0; i < indexCount-2; i += 3) {
-		// n = cb x ab
-		const Geometry::Vec3 a( positionAccessor->getPosition(indices[i + 0]) );
-		const Geometry::Vec3 b( positionAccessor->getPosition(indices[i + 1]) );
-		const Geometry::Vec3 c( positionAccessor->getPosition(indices[i + 2]) );
-
-		Geometry::Vec3 n( (c-b).cross(a-b) );
-		const float length = n.length();
-		if(length>0)
-			n.normalize();
-		normals[indices[i+0]] += n;
-		normals[indices[i+1]] += n;
-		normals[indices[i+2]] += n;
-	}
-
-	// set normals
-	Util::Reference<NormalAttributeAccessor> normalAccessor(NormalAttributeAccessor::create(vData,VertexAttributeIds::NORMAL));
-	for(uint32_t i=0;i<vertexCount;++i){
-		const Geometry::Vec3 n = normals[i];
-		const float length = n.length();
-		normalAccessor->setNormal(i, length>0 ? n/length : n);
-	}
-	vData.markAsChanged();
+	calculateNormals(m, NormalWeighting::UNIFORM);
 }
 
 // -----------------------------------------------------------------------------
@@ -822,7 +935,6 @@ void calculateNormals(Mesh * m) {
 /**
  * [static]
  * Combines the meshes from meshArray to a single mesh.
- * Must have identical VertexDescription.
  */
 Mesh * combineMeshes(const std::deque<Mesh *> & meshArray) {
 	return combineMeshes(meshArray, std::deque<Geometry::Matrix4x4>());
@@ -831,41 +943,58 @@ Mesh * combineMeshes(const std::deque<Mesh *> & meshArray) {
 // -----------------------------------------------------------------------------
 
 Mesh * combineMeshes(const std::deque<Mesh *> & meshArray, const std::deque<Geometry::Matrix4x4> & transformations) {
+	return combineMeshes(meshArray, transformations, nullptr);
+}
+
+// -----------------------------------------------------------------------------
+
+Mesh * combineMeshes(const std::deque<Mesh *> & meshArray, const std::deque<Geometry::Matrix4x4> & transformations, std::vector<SubmeshRange> * ranges) {
 	if (meshArray.empty()) {
 		return nullptr;
 	}
 
-	Mesh * firstMesh = meshArray.front();
-	if (!firstMesh)
-		FAIL();
-
-	const VertexDescription & vd = firstMesh->getVertexDescription();
-
-	std::deque<Mesh *> meshArray2; //< collect meshes which have the same vertexDescription
-	std::deque<Geometry::Matrix4x4> transformations2; //< collect meshes which have the same vertexDescription
-
-	//count vertices and indices, check if Meshes exist and have the same vertexDescription
+	// 1. phase: united vertex description, sizes and offsets of all meshes
+	struct Source {
+		MeshVertexData * vertices;
+		const MeshIndexData * indices;
+		const Geometry::Matrix4x4 * transformation;
+		SubmeshRange range;
+	};
+	std::vector<Source> sources;
+	sources.reserve(meshArray.size());
+	std::deque<VertexDescription> vertexDescs;
 	uint32_t indexCount = 0;
 	uint32_t vertexCount = 0;
 	{
+		const Geometry::Matrix4x4 noTrans;
 		auto tIt = transformations.begin();
 		for (auto it = meshArray.begin(); it != meshArray.end(); ++it, (tIt != transformations.end() ? ++tIt : tIt)) {
 			if (!(*it)) {
 				WARN("combineMeshes: No Mesh");
+				sources.push_back({nullptr, nullptr, nullptr, {vertexCount, 0, indexCount, 0}});
 				continue;
 			}
-			if (!((*it)->getVertexDescription() == vd)) {
-				WARN("combineMeshes: can't combine meshes with different vertex descriptions.");
-				std::cout << (*it)->getVertexDescription().toString() << ":" << vd.toString() << "\n";
-				continue;
-			}
-			meshArray2.push_back(*it);
-			if (tIt != transformations.end())
-				transformations2.push_back(*tIt);
-			indexCount += (*it)->getIndexCount();
-			vertexCount += (*it)->getVertexCount();
+			// the local data is opened sequentially, as it may have to be downloaded
+			MeshVertexData & currentVertices = (*it)->openVertexData();
+			const MeshIndexData & currentIndices = (*it)->openIndexData();
+			const Geometry::Matrix4x4 * transformation = (tIt != transformations.end() && (*tIt) != noTrans) ? &(*tIt) : nullptr;
+			sources.push_back({&currentVertices, &currentIndices, transformation,
+					{vertexCount, currentVertices.getVertexCount(), indexCount, currentIndices.getIndexCount()}});
+			if (vertexDescs.empty() || !(vertexDescs.back() == currentVertices.getVertexDescription()))
+				vertexDescs.push_back(currentVertices.getVertexDescription());
+			indexCount += currentIndices.getIndexCount();
+			vertexCount += currentVertices.getVertexCount();
 		}
 	}
+	if (vertexDescs.empty()) {
+		return nullptr;
+	}
+	VertexDescription vd = uniteVertexDescriptions(vertexDescs);
+	// quantized positions of different meshes do not share a dequantization
+	const VertexAttribute posAttr = vd.getAttribute(VertexAttributeIds::POSITION);
+	if (posAttr.getDataType() == GL_UNSIGNED_SHORT)
+		vd.updateAttribute(VertexAttribute(posAttr.getNumValues(), GL_FLOAT, VertexAttributeIds::POSITION, false));
+
 	// create mesh
 	auto mesh = new Mesh;
 	MeshVertexData & vertices = mesh->openVertexData();
@@ -873,33 +1002,39 @@ Mesh * combineMeshes(const std::deque<Mesh *> & meshArray, const std::deque<Geom
 	MeshIndexData & indices = mesh->openIndexData();
 	indices.allocate(indexCount);
 
-	// copy data
-
-	uint32_t indexPointer = 0;
-	uint32_t vertexPointer = 0;
-
-	Geometry::Matrix4x4 noTrans;
-	auto tIt2 = transformations2.cbegin();
-	for (auto it = meshArray2.cbegin(); it != meshArray2.cend(); ++it, (tIt2 != transformations2.cend() ? ++tIt2 : tIt2)) {
-		Mesh * currentMesh = *it;
-		// add modified indices
-		MeshIndexData & currentIndices = currentMesh->openIndexData();
-		for (uint32_t j = 0; j < currentIndices.getIndexCount(); ++j)
-			indices[indexPointer + j] = currentIndices[j] + vertexPointer;
-		indexPointer += currentIndices.getIndexCount();
-
-		// add vertices
-		MeshVertexData & currentVertices = currentMesh->openVertexData();
-		std::copy(currentVertices.data(), currentVertices.data() + currentVertices.dataSize(), vertices[vertexPointer]);
-
-		if (tIt2 != transformations2.cend() && (*tIt2) != noTrans) {
-			transformVertexData(vertices, (*tIt2), vertexPointer, currentVertices.getVertexCount());
+	// 2. phase: convert, transform and rebase every mesh in parallel
+	parallelFor(static_cast<uint32_t>(sources.size()), 16, [&](uint32_t begin, uint32_t end) {
+		for (uint32_t s = begin; s < end; ++s) {
+			const Source & source = sources[s];
+			if (!source.vertices || source.range.vertexCount == 0)
+				continue;
+			const SubmeshRange & range = source.range;
+			// add modified indices
+			const uint32_t * sourceIndices = source.indices->data();
+			for (uint32_t j = 0; j < range.elementCount; ++j)
+				indices[range.firstElement + j] = sourceIndices[j] + range.firstVertex;
+
+			// add vertices
+			if (source.vertices->getVertexDescription() == vd)
+				std::copy(source.vertices->data(), source.vertices->data() + source.vertices->dataSize(), vertices[range.firstVertex]);
+			else
+				convertVertexRange(*source.vertices, vertices, range.firstVertex);
+
+			if (source.transformation) {
+				transformVertexRange(vertices, VertexAttributeIds::POSITION, *source.transformation, range.firstVertex, range.firstVertex + range.vertexCount, true);
+				if (vd.hasAttribute(VertexAttributeIds::NORMAL))
+					transformVertexRange(vertices, VertexAttributeIds::NORMAL, *source.transformation, range.firstVertex, range.firstVertex + range.vertexCount, false);
+			}
 		}
-		vertexPointer += currentVertices.getVertexCount();
-	}
+	});
 	vertices.updateBoundingBox();
 	indices.updateIndexRange();
 
+	if (ranges) {
+		ranges->clear();
+		for (const auto & source : sources)
+			ranges->push_back(source.range);
+	}
 	return mesh;
 }
 
@@ -934,6 +1069,8 @@ std::deque<MeshVertexData> splitVertexData(Mesh * mesh, uint32_t chunkSize){
 
 
 		std::copy(meshVertices.data() + chunkFront, meshVertices.data() + chunkEnd, currentVertices.data());
+		if(meshVertices.getPositionDequantization())
+			currentVertices.setPositionDequantization(*meshVertices.getPositionDequantization());
 
 		result.emplace_back(std::move(currentVertices));
 
@@ -965,6 +1102,8 @@ MeshVertexData * extractVertexData(Mesh * mesh, uint32_t begin, uint32_t length)
 	uint32_t end = front + length*desc.getVertexSize();
 
 	std::copy(meshVertices.data() + front, meshVertices.data() + end, result->data());
+	if(meshVertices.getPositionDequantization())
+		result->setPositionDequantization(*meshVertices.getPositionDequantization());
 
 	return result;
 
@@ -972,68 +1111,222 @@ MeshVertexData * extractVertexData(Mesh * mesh, uint32_t begin, uint32_t length)
 
 // -----------------------------------------------------------------------------
 
-//! (static)
-void eliminateDuplicateVertices(Mesh * mesh) {
-	const VertexDescription & desc = mesh->getVertexDescription();
-	const uint32_t indexCount = mesh->getIndexCount();
+//! (internal) Marker for unused entries in the flat remapping and hash tables.
+static const uint32_t INVALID_INDEX = 0xffffffff;
 
-	// Set of vertices used to create unique vertices.
-	std::set<RawVertex> rawVertices;
-	// Mapping from old index to new index.
-	std::map<uint32_t, uint32_t> indexReplace;
+//! (internal) Return a power of two that is at least twice as large as @p count (load factor <= 0.5).
+static uint32_t getHashTableSize(uint32_t count) {
+	uint64_t size = 16;
+	while(size < 2 * static_cast<uint64_t>(count))
+		size <<= 1;
+	return static_cast<uint32_t>(size);
+}
 
-	// Simply go over the indices and add one vertex after another.
-	{
-		const MeshVertexData & vertices = mesh->openVertexData();
-		const MeshIndexData & indices = mesh->openIndexData();
-		const std::size_t vertexSize = desc.getVertexSize();
-
-		for (uint32_t counter = 0; counter < indexCount; ++counter) {
-			const uint32_t index = indices[counter];
-			const uint8_t * vertex = vertices[index];
-			RawVertex raw(index, vertex, vertexSize);
-			auto it = rawVertices.insert(raw).first;
-			indexReplace.insert(std::make_pair(index, it->getIndex()));
+//! (internal) FNV-1a hash of the raw bytes of a vertex.
+static inline uint32_t hashVertexData(const uint8_t * data, std::size_t size) {
+	uint32_t hash = 2166136261u;
+	for(std::size_t i = 0; i < size; ++i) {
+		hash ^= data[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+//! (internal) Hash of the integer coordinates of a grid cell.
+static inline uint32_t hashCell(int64_t x, int64_t y, int64_t z) {
+	uint64_t hash = static_cast<uint64_t>(x) * 0x9E3779B97F4A7C15ull;
+	hash ^= static_cast<uint64_t>(y) * 0xC2B2AE3D27D4EB4Full + (hash << 6) + (hash >> 2);
+	hash ^= static_cast<uint64_t>(z) * 0x165667B19E3779F9ull + (hash << 6) + (hash >> 2);
+	return static_cast<uint32_t>(hash ^ (hash >> 32));
+}
+
+/**
+ * Result of a vertex welding pass. Used in
+ * @a eliminateDuplicateVertices().
+ * @a mergeCloseVertices().
+ * The new vertices are numbered in the order in which they are first referenced by the index data.
+ */
+struct VertexRemap {
+	//! Mapping from old vertex index to new vertex index (INVALID_INDEX for unreferenced vertices).
+	std::vector<uint32_t> newIndex;
+	//! Old index of the vertex whose data is used for each new vertex.
+	std::vector<uint32_t> source;
+};
+
+/**
+ * (internal) Weld the referenced vertices whose positions differ by at most @p tolerance in each coordinate.
+ * The positions are sorted into a hash grid with a cell size of at least twice the @p tolerance, so besides the
+ * vertex' own cell only the neighbouring cells it is close to have to be searched (at most eight cells).
+ * A vertex is merged into the closest vertex found there. Expected runtime is O(n) where n is the number of indices.
+ */
+static VertexRemap weldPositions(const std::vector<Geometry::Vec3> & positions, const uint32_t * indices, uint32_t indexCount, float tolerance) {
+	const uint32_t vertexCount = static_cast<uint32_t>(positions.size());
+	VertexRemap remap;
+	remap.newIndex.assign(vertexCount, INVALID_INDEX);
+	remap.source.reserve(std::min(vertexCount, indexCount));
+
+	// The lower bound relative to the largest coordinate keeps the cell coordinates representable.
+	float maxCoordinate = 0.0f;
+	for(const auto & p : positions)
+		maxCoordinate = std::max(maxCoordinate, std::max(std::abs(p.x()), std::max(std::abs(p.y()), std::abs(p.z()))));
+	const double cellSize = std::max<double>({2.0 * tolerance, maxCoordinate * std::ldexp(1.0, -40), std::numeric_limits<float>::min()});
+	const double invCellSize = 1.0 / cellSize;
+	// Slightly enlarged tolerance in cell units; searching too many cells is harmless.
+	const double cellTolerance = std::max(0.0, tolerance * invCellSize * 1.0001 + 1.0e-9);
+
+	struct Cell {
+		int64_t x, y, z;
+		uint32_t head; //!< First new vertex in this cell (INVALID_INDEX for empty slots)
+	};
+	std::vector<Cell> cells(getHashTableSize(std::min(vertexCount, indexCount) / 8), Cell{0, 0, 0, INVALID_INDEX});
+	uint32_t tableMask = static_cast<uint32_t>(cells.size()) - 1;
+	uint32_t usedCells = 0;
+	std::vector<uint32_t> nextInCell;
+	nextInCell.reserve(remap.source.capacity());
+
+	auto findSlot = [&](int64_t x, int64_t y, int64_t z) {
+		uint32_t slot = hashCell(x, y, z) & tableMask;
+		while(cells[slot].head != INVALID_INDEX && (cells[slot].x != x || cells[slot].y != y || cells[slot].z != z))
+			slot = (slot + 1) & tableMask;
+		return slot;
+	};
+	auto getCellRange = [&](float value, int64_t & first, int64_t & last) {
+		const double scaled = value * invCellSize;
+		const double cell = std::floor(scaled);
+		first = static_cast<int64_t>(cell) - (scaled - cell <= cellTolerance ? 1 : 0);
+		last = static_cast<int64_t>(cell) + (cell + 1.0 - scaled <= cellTolerance ? 1 : 0);
+		return static_cast<int64_t>(cell);
+	};
+
+	for(uint32_t counter = 0; counter < indexCount; ++counter) {
+		const uint32_t index = indices[counter];
+		if(remap.newIndex[index] != INVALID_INDEX)
+			continue;
+		const Geometry::Vec3 & p = positions[index];
+		int64_t x0, x1, y0, y1, z0, z1;
+		const int64_t cx = getCellRange(p.x(), x0, x1);
+		const int64_t cy = getCellRange(p.y(), y0, y1);
+		const int64_t cz = getCellRange(p.z(), z0, z1);
+
+		uint32_t closest = INVALID_INDEX;
+		float closestDistance = std::numeric_limits<float>::max();
+		for(int64_t z = z0; z <= z1; ++z) {
+			for(int64_t y = y0; y <= y1; ++y) {
+				for(int64_t x = x0; x <= x1; ++x) {
+					for(uint32_t v = cells[findSlot(x, y, z)].head; v != INVALID_INDEX; v = nextInCell[v]) {
+						const Geometry::Vec3 & q = positions[remap.source[v]];
+						if(std::abs(p.x() - q.x()) > tolerance || std::abs(p.y() - q.y()) > tolerance || std::abs(p.z() - q.z()) > tolerance)
+							continue;
+						const float distance = (p - q).lengthSquared();
+						if(distance < closestDistance) {
+							closestDistance = distance;
+							closest = v;
+						}
+					}
+				}
+			}
+		}
+		if(closest == INVALID_INDEX) {
+			closest = static_cast<uint32_t>(remap.source.size());
+			remap.source.push_back(index);
+			uint32_t slot = findSlot(cx, cy, cz);
+			if(cells[slot].head == INVALID_INDEX) {
+				if(2 * (usedCells + 1) > cells.size()) {
+					// Grow the table and reinsert all occupied cells.
+					std::vector<Cell> oldCells(2 * cells.size(), Cell{0, 0, 0, INVALID_INDEX});
+					oldCells.swap(cells);
+					tableMask = static_cast<uint32_t>(cells.size()) - 1;
+					for(const auto & cell : oldCells) {
+						if(cell.head != INVALID_INDEX)
+							cells[findSlot(cell.x, cell.y, cell.z)] = cell;
+					}
+					slot = findSlot(cx, cy, cz);
+				}
+				++usedCells;
+				cells[slot].x = cx;
+				cells[slot].y = cy;
+				cells[slot].z = cz;
+			}
+			nextInCell.push_back(cells[slot].head);
+			cells[slot].head = closest;
 		}
+		remap.newIndex[index] = closest;
 	}
+	return remap;
+}
 
-	// Mapping from new index to vertex position.
-	std::map<uint32_t, uint32_t> indexPosition;
+//! (internal) Replace the vertex and index data of @p mesh by the welded data described by @p remap.
+static void applyVertexRemap(Mesh * mesh, const VertexRemap & remap) {
+	MeshVertexData & oldVertices = mesh->openVertexData();
+	MeshIndexData & oldIndices = mesh->openIndexData();
+	const VertexDescription & desc = oldVertices.getVertexDescription();
+	const std::size_t vertexSize = desc.getVertexSize();
+	const uint32_t indexCount = mesh->getIndexCount();
 
-	// Create the new mesh and add the rawVertices.
-	Util::Reference<Mesh> result = new Mesh;
-	result->setDataStrategy(mesh->getDataStrategy());
+	MeshVertexData newVertices;
+	newVertices.allocate(static_cast<uint32_t>(remap.source.size()), desc);
+	uint8_t * target = newVertices.data();
+	for(const auto & oldIndex : remap.source) {
+		std::copy(oldVertices[oldIndex], oldVertices[oldIndex] + vertexSize, target);
+		target += vertexSize;
+	}
+	if(oldVertices.getPositionDequantization())
+		newVertices.setPositionDequantization(*oldVertices.getPositionDequantization());
+	newVertices.updateBoundingBox();
 
-	MeshVertexData & vertices = result->openVertexData();
-	vertices.allocate(rawVertices.size(), desc);
+	MeshIndexData newIndices;
+	newIndices.allocate(indexCount);
+	const uint32_t * srcIndex = oldIndices.data();
+	uint32_t * dstIndex = newIndices.data();
+	for(uint32_t counter = 0; counter < indexCount; ++counter)
+		dstIndex[counter] = remap.newIndex[srcIndex[counter]];
+	newIndices.updateIndexRange();
 
-	MeshIndexData & indices = result->openIndexData();
-	indices.allocate(indexCount);
+	oldVertices.swap(newVertices);
+	oldIndices.swap(newIndices);
+}
 
-	{
-		uint8_t * data = vertices.data();
-		uint32_t vertexPos = 0;
-		for(const auto & vertex : rawVertices) {
-			std::copy(vertex.getData(), vertex.getData() + vertex.getSize(), data);
-			data += vertex.getSize();
-			indexPosition.insert(std::make_pair(vertex.getIndex(), vertexPos));
-			++vertexPos;
+// -----------------------------------------------------------------------------
+
+//! (static)
+void eliminateDuplicateVertices(Mesh * mesh) {
+	const uint32_t indexCount = mesh->getIndexCount();
+	const MeshVertexData & vertices = mesh->openVertexData();
+	const MeshIndexData & indices = mesh->openIndexData();
+	const uint32_t vertexCount = vertices.getVertexCount();
+	const std::size_t vertexSize = vertices.getVertexDescription().getVertexSize();
+
+	VertexRemap remap;
+	remap.newIndex.assign(vertexCount, INVALID_INDEX);
+	remap.source.reserve(std::min(vertexCount, indexCount));
+
+	// Open addressing table of new vertex indices together with the hash of their data.
+	const uint32_t tableMask = getHashTableSize(std::min(vertexCount, indexCount)) - 1;
+	std::vector<uint32_t> tableEntries(tableMask + 1, INVALID_INDEX);
+	std::vector<uint32_t> tableHashes(tableMask + 1, 0);
+
+	// Simply go over the indices and add one vertex after another.
+	for(uint32_t counter = 0; counter < indexCount; ++counter) {
+		const uint32_t index = indices[counter];
+		if(remap.newIndex[index] != INVALID_INDEX)
+			continue;
+		const uint8_t * vertex = vertices[index];
+		const uint32_t hash = hashVertexData(vertex, vertexSize);
+		uint32_t slot = hash & tableMask;
+		while(tableEntries[slot] != INVALID_INDEX) {
+			if(tableHashes[slot] == hash && std::memcmp(vertices[remap.source[tableEntries[slot]]], vertex, vertexSize) == 0)
+				break;
+			slot = (slot + 1) & tableMask;
 		}
-		// Translate the indices.
-		const uint32_t * srcIndex = mesh->openIndexData().data();
-		uint32_t * dstIndex = indices.data();
-		for (uint32_t counter = 0; counter < indexCount; ++counter) {
-			const uint32_t newIndex = indexReplace.find(*srcIndex)->second;
-			*dstIndex = indexPosition.find(newIndex)->second;
-			++srcIndex;
-			++dstIndex;
+		if(tableEntries[slot] == INVALID_INDEX) {
+			tableEntries[slot] = static_cast<uint32_t>(remap.source.size());
+			tableHashes[slot] = hash;
+			remap.source.push_back(index);
 		}
+		remap.newIndex[index] = tableEntries[slot];
 	}
 
-	vertices.updateBoundingBox();
-	indices.updateIndexRange();
-
-	mesh->swap(*result.get());
+	applyVertexRemap(mesh, remap);
 }
 
 // -----------------------------------------------------------------------------
@@ -1082,6 +1375,8 @@ Mesh * eliminateUnusedVertices(Mesh * mesh) {
 	for(const auto & oldIndex : usedOldVertices) {
 		std::copy(oldVertexData[oldIndex], oldVertexData[oldIndex] + vSize, newVertexData[i++]);
 	}
+	if(oldVertexData.getPositionDequantization())
+		newVertexData.setPositionDequantization(*oldVertexData.getPositionDequantization());
 	newVertexData.updateBoundingBox();
 
 	return newMesh;
@@ -1298,197 +1593,7 @@ Mesh * removeSkinsWithHoleCovering(Mesh * mesh, float maxNormalZ, float covering
 // -----------------------------------------------------------------------------
 
 void optimizeIndices(Mesh * mesh, const uint_fast8_t _cacheSize) {
-	struct Inner {
-		/**
-		 * Consider all 1-ring candidates and select the best for fanning.
-		 *
-		 * @param stop Flag which tells if the algorithm has ended.
-		 * @param nextCand Passed from caller.
-		 * @param stamp Passed from caller.
-		 * @param cacheSize Passed from caller.
-		 * @param cacheTimes Passed from caller.
-		 * @param liveTriangles Passed from caller.
-		 * @param deadEndStack Passed from caller.
-		 * @param numVertices Passed from caller.
-		 * @param cursor Passed from caller.
-		 * @return Number of next vertex.
-		 */
-		static uint32_t getNextVertex(bool & stop, const std::set<uint32_t> & nextCand, const uint32_t stamp, const uint8_t cacheSize,
-				const uint32_t * cacheTimes, const uint_fast16_t * liveTriangles, std::stack<uint32_t> & deadEndStack, const uint32_t numVertices,
-				uint32_t & cursor) {
-			// Best candidate and priority.
-			bool found = false;
-			uint32_t n = 0;
-			uint32_t maxPriority = 0; // m
-			for(const auto & v : nextCand) {
-				// Must have live triangles.
-				if (liveTriangles[v] > 0) {
-					// Initial priority.
-					uint32_t p = 0;
-					// In cache even after fanning?
-					if (stamp - cacheTimes[v] + 2 * liveTriangles[v] <= cacheSize) {
-						// Priority is position in cache.
-						p = stamp - cacheTimes[v];
-					}
-					// Keep best candidate.
-					if (p > maxPriority) {
-						maxPriority = p;
-						n = v;
-						found = true;
-					}
-				}
-			}
-			// Reached a dead-end?
-			if (!found) {
-				n = skipDeadEnd(stop, liveTriangles, deadEndStack, numVertices, cursor);
-			}
-			return n;
-		}
-
-		/**
-		 * When there are no candidates left we might have to choose an non-
-		 * local vertex.
-		 *
-		 * @param stop Flag which tells if the algorithm has ended.
-		 * @param liveTriangles Passed from caller.
-		 * @param deadEndStack Passed from caller.
-		 * @param numVertices Passed from caller.
-		 * @param cursor Passed from caller.
-		 * @return Number of non-local vertex.
-		 */
-		static uint32_t skipDeadEnd(bool & stop, const uint_fast16_t * liveTriangles, std::stack<uint32_t> & deadEndStack,
-				const uint32_t numVertices, uint32_t & cursor) {
-			while (!deadEndStack.empty()) {
-				// Next in dead-end stack.
-				uint32_t d = deadEndStack.top();
-				deadEndStack.pop();
-				// Check for live triangles.
-				if (liveTriangles[d] > 0) {
-					return d;
-				}
-			}
-			while (cursor < numVertices) {
-				// Check for live triangles.
-				if (liveTriangles[cursor] > 0) {
-					return cursor;
-				}
-				// Next in input order.
-				// Cursor sweeps list only once.
-				++cursor;
-			}
-			// We are done!
-			stop = true;
-			return 0;
-		}
-	};
-	if (mesh->getDrawMode() != Mesh::DRAW_TRIANGLES) {
-		WARN("This function only works with meshes with a triangle list.");
-		return;
-	}
-	uint32_t numVertices = mesh->getVertexCount();
-	uint32_t numIndices = mesh->getIndexCount();
-	uint32_t numTriangles = numIndices / 3;
-	MeshIndexData & indices = mesh->openIndexData();
-
-	// Build vertex-triangle adjacency.
-	// First pass: Count occurrences.
-	auto occurrences = new uint_fast16_t[numVertices];
-	std::fill_n(occurrences, numVertices, 0);
-	for (uint32_t i = 0; i < numIndices; ++i) {
-		++occurrences[indices[i]];
-	}
-	// Second pass: Create the offset map.
-	auto offsetMap = new uint32_t[numVertices];
-	uint32_t sum = 0;
-	for (uint32_t v = 0; v < numVertices; ++v) {
-		offsetMap[v] = sum;
-		sum += occurrences[v];
-	}
-	// Third pass: Construct triangle lists.
-	auto triangleLists = new uint32_t[sum]; // A
-	auto tmpOffsetMap = new uint32_t[numVertices];
-	std::copy(offsetMap, offsetMap + numVertices, tmpOffsetMap);
-	for (uint32_t i = 0; i < numIndices; ++i) {
-		uint32_t vertex = indices[i];
-		uint32_t offset = tmpOffsetMap[vertex];
-		triangleLists[offset] = i / 3;
-		++tmpOffsetMap[vertex];
-	}
-	delete[] tmpOffsetMap;
-
-	// Create per-vertex live triangle count.
-	auto liveTriangles = new uint_fast16_t[numVertices]; // L
-	std::copy(occurrences, occurrences + numVertices, liveTriangles);
-	// Create per-vertex caching time stamps.
-	auto cacheTimes = new uint32_t[numVertices]; // C
-	std::fill_n(cacheTimes, numVertices, 0);
-	// Create dead-end vertex stack.
-	std::stack<uint32_t> deadEndStack; // D
-	// Create per-triangles emitted flags.
-	auto emitted = new bool[numTriangles]; // E
-	for (uint32_t t = 0; t < numTriangles; ++t) {
-		emitted[t] = false;
-	}
-	// Create output buffer.
-	MeshIndexData newIndices;
-	newIndices.allocate(numIndices);
-	uint32_t * output = newIndices.data();
-	// Initialize fanning vertex.
-	uint32_t fanVertex = 0; // f
-	// Initialize time stamp.
-	uint32_t stamp = static_cast<uint32_t> (_cacheSize) + 1; // s
-	// Initialize the cursor.
-	uint32_t cursor = 1; // i
-
-	bool stop = false;
-	while (!stop) {
-		// 1-ring of next candidates.
-		std::set<uint32_t> nextCand; // N
-		uint_fast16_t numNeighbors = occurrences[fanVertex];
-		for (uint_fast16_t i = 0; i < numNeighbors; ++i) {
-			uint32_t t = triangleLists[offsetMap[fanVertex] + i];
-			if (emitted[t])
-				continue;
-
-			for (uint_fast8_t ii = 0; ii < 3; ++ii) {
-				uint32_t v = indices[3 * t + ii];
-				// Output vertex.
-				*output = v;
-				++output;
-				// Add to dead-end stack.
-				deadEndStack.push(v);
-				// Register as candidate.
-				nextCand.insert(v);
-				// Decrease live triangle count.
-				--liveTriangles[v];
-				// If not in cache
-				if (stamp - cacheTimes[v] > _cacheSize) {
-					// Set time stamp.
-					cacheTimes[v] = stamp;
-					// Increment time stamp.
-					++stamp;
-				}
-			}
-			// Flag triangle as emitted.
-			emitted[t] = true;
-
-		}
-		fanVertex = Inner::getNextVertex(stop, nextCand, stamp, _cacheSize, cacheTimes, liveTriangles, deadEndStack, numVertices, cursor);
-	}
-
-	// Clean up.
-	delete[] occurrences;
-	delete[] offsetMap;
-	delete[] triangleLists;
-	delete[] liveTriangles;
-	delete[] cacheTimes;
-	delete[] emitted;
-
-	newIndices.markAsChanged();
-	newIndices.updateIndexRange();
-
-	// Modify the mesh.
-	indices.swap(newIndices);
+	optimizeVertexCache(mesh, _cacheSize);
 }
 
 // -----------------------------------------------------------------------------
@@ -1575,115 +1680,7 @@ void calculateTextureCoordinates_projection(Mesh * mesh, Util::StringIdentifier
 
 //!	(static)
 void calculateTangentVectors(Mesh * mesh, const Util::StringIdentifier uvName, const Util::StringIdentifier tangentVecName) {
-	using Geometry::Vec3;
-	using Geometry::Vec2;
-	MeshVertexData & vertices(mesh->openVertexData());
-	const MeshIndexData & indices(mesh->openIndexData());
-
-	{ // assure mesh has the right form
-		if (mesh->getDrawMode() != Mesh::DRAW_TRIANGLES)
-			INVALID_ARGUMENT_EXCEPTION("addTangentVectors: No triangle mesh.");
-
-		if (vertices.getVertexDescription().getAttribute(VertexAttributeIds::POSITION).getDataType() != GL_FLOAT)
-			INVALID_ARGUMENT_EXCEPTION("addTangentVectors: No float positions.");
-
-		if (vertices.getVertexDescription().getAttribute(VertexAttributeIds::NORMAL).empty())
-			INVALID_ARGUMENT_EXCEPTION("addTangentVectors: No normals.");
-
-		if (vertices.getVertexDescription().getAttribute(uvName).getDataType() != GL_FLOAT
-				|| vertices.getVertexDescription().getAttribute(uvName).getNumValues() < 2)
-			INVALID_ARGUMENT_EXCEPTION("addTangentVectors: No or wrong texture coordinates.");
-
-		// add slot for 4 byte tangent vector
-		if (vertices.getVertexDescription().getAttribute(tangentVecName).empty()) {
-			VertexDescription newVd = vertices.getVertexDescription();
-			newVd.appendAttribute(tangentVecName, 4, GL_BYTE, true);
-			std::unique_ptr<MeshVertexData> newVertices(convertVertices(vertices, newVd));
-			vertices.swap(*newVertices.get());
-		}
-		if (vertices.getVertexDescription().getAttribute(tangentVecName).getDataType() != GL_BYTE || vertices.getVertexDescription().getAttribute(
-				tangentVecName).getNumValues() != 4)
-			INVALID_ARGUMENT_EXCEPTION("createTextureCoordinates_boxProjection: Wrong tangent format.");
-
-	}
-	// calculate tangents and bitangents
-	const VertexDescription & vDesc = vertices.getVertexDescription();
-	const VertexAttribute & posAttr = vDesc.getAttribute(VertexAttributeIds::POSITION);
-	const VertexAttribute & normalAttr = vDesc.getAttribute(VertexAttributeIds::NORMAL);
-	const VertexAttribute & uvAttr = vDesc.getAttribute(uvName);
-	const VertexAttribute & tanAttr = vDesc.getAttribute(tangentVecName);
-
-	std::vector<Vec3> tan1(vertices.getVertexCount());
-	std::vector<Vec3> tan2(vertices.getVertexCount());
-
-	for (uint32_t i = 0; i < indices.getIndexCount(); i += 3) {
-		const uint32_t index1 = indices[i];
-		const uint32_t index2 = indices[i + 1];
-		const uint32_t index3 = indices[i + 2];
-
-		const Vec3 pos1(reinterpret_cast<float*> (vertices[index1] + posAttr.getOffset()));
-		const Vec3 pos2(reinterpret_cast<float*> (vertices[index2] + posAttr.getOffset()));
-		const Vec3 pos3(reinterpret_cast<float*> (vertices[index3] + posAttr.getOffset()));
-
-		const Vec2 uv1(reinterpret_cast<float*> (vertices[index1] + uvAttr.getOffset()));
-		const Vec2 uv2(reinterpret_cast<float*> (vertices[index2] + uvAttr.getOffset()));
-		const Vec2 uv3(reinterpret_cast<float*> (vertices[index3] + uvAttr.getOffset()));
-
-		const float x1 = pos2.x() - pos1.x();
-		const float x2 = pos3.x() - pos1.x();
-		const float y1 = pos2.y() - pos1.y();
-		const float y2 = pos3.y() - pos1.y();
-		const float z1 = pos2.z() - pos1.z();
-		const float z2 = pos3.z() - pos1.z();
-
-		const float s1 = uv2.x() - uv1.x();
-		const float s2 = uv3.x() - uv1.x();
-		const float t1 = uv2.y() - uv1.y();
-		const float t2 = uv3.y() - uv1.y();
-
-		const float r = 1.0f / (s1 * t2 - s2 * t1);
-		const Vec3 sdir((t2 * x1 - t1 * x2) * r, (t2 * y1 - t1 * y2) * r, (t2 * z1 - t1 * z2) * r);
-		const Vec3 tdir((s1 * x2 - s2 * x1) * r, (s1 * y2 - s2 * y1) * r, (s1 * z2 - s2 * z1) * r);
-
-		tan1[index1] += sdir;
-		tan1[index2] += sdir;
-		tan1[index3] += sdir;
-
-		tan2[index1] += tdir;
-		tan2[index2] += tdir;
-		tan2[index3] += tdir;
-	}
-
-	// -----------------------------------------------------------------------------
-
-	if (normalAttr.getDataType() == GL_FLOAT) {
-		for (uint32_t i = 0; i < vertices.getVertexCount(); ++i) {
-			const Vec3 normal(reinterpret_cast<float*> (vertices[i] + normalAttr.getOffset()));
-			const Vec3 & t = tan1[i];
-			const Vec3 tan((t - normal * normal.dot(t)).getNormalized() * 127); // Gram-Schmidt orthogonalize
-
-			int8_t * const tPtr = reinterpret_cast<int8_t*> (vertices[i] + tanAttr.getOffset());
-			int8_t handedness = (normal.cross(t).dot(tan2[i]) < 0.0f) ? -1 : 1; // Calculate handedness
-			tPtr[0] = handedness * static_cast<int8_t> (tan.x());
-			tPtr[1] = handedness * static_cast<int8_t> (tan.y());
-			tPtr[2] = handedness * static_cast<int8_t> (tan.z());
-			tPtr[3] = handedness;
-		}
-	} else if (normalAttr.getDataType() == GL_BYTE) {
-		for (uint32_t i = 0; i < vertices.getVertexCount(); ++i) {
-			const int8_t * nPtr = reinterpret_cast<const int8_t*> (vertices[i] + normalAttr.getOffset());
-			const Vec3 normal((Vec3(nPtr[0], nPtr[1], nPtr[2])).normalize());
-			const Vec3 & t = tan1[i];
-			const Vec3 tan((t - normal * normal.dot(t)).getNormalized() * 127); // Gram-Schmidt orthogonalize
-
-			int8_t * const tPtr = reinterpret_cast<int8_t*> (vertices[i] + tanAttr.getOffset());
-			int8_t handedness = (normal.cross(t).dot(tan2[i]) < 0.0f) ? -1 : 1; // Calculate handedness
-			tPtr[0] = handedness * static_cast<int8_t> (tan.x());
-			tPtr[1] = handedness * static_cast<int8_t> (tan.y());
-			tPtr[2] = handedness * static_cast<int8_t> (tan.z());
-			tPtr[3] = handedness;
-		}
-	}
+	calculateTangentVectors(mesh, uvName, tangentVecName, TriangleAdjacency(mesh));
 }
 
 // -----------------------------------------------------------------------------
@@ -1960,27 +1957,7 @@ int32_t getFirstTriangleIntersectingRay(Mesh* m, const Geometry::Ray3& ray) {
 		WARN("getFirstTriangleIntersectingRay: Unsupported vertex format.");
 		return -1;
 	}
-	auto posAcc = PositionAttributeAccessor::create(m->openVertexData(), VertexAttributeIds::POSITION);
-	MeshIndexData & indices = m->openIndexData();
-
-	float tLine, uTri, vTri;
-	int32_t closest = -1;
-	float closestDist = std::numeric_limits<float>::infinity();
-	for(uint32_t i=0; i<indices.getIndexCount(); i+=3) {
-		Geometry::Triangle<Geometry::Vec3> triangle(
-			posAcc->getPosition(indices[i+0]),
-			posAcc->getPosition(indices[i+1]),
-			posAcc->getPosition(indices[i+2]));
-		// TODO: check triangle normal
-		if(Geometry::Intersection::getLineTriangleIntersection(ray, triangle, tLine, uTri, vTri)) {
-			if(tLine >= 0 && tLine < closestDist) {
-				closestDist = tLine;
-				closest = i/3;
-			}
-		}
-	}
-
-	return closest;
+	return TriangleBVH::get(m)->getClosestHit(ray).triangle;
 }
 
 // -----------------------------------------------------------------------------
@@ -1988,211 +1965,158 @@ int32_t getFirstTriangleIntersectingRay(Mesh* m, const Geometry::Ray3& ray) {
 
 //! (static)
 uint32_t mergeCloseVertices(Mesh * mesh, float tolerance) {
-	const VertexDescription & desc = mesh->getVertexDescription();
 	const uint32_t indexCount = mesh->getIndexCount();
+	MeshVertexData & vertices = mesh->openVertexData();
+	const MeshIndexData & indices = mesh->openIndexData();
+	const uint32_t oldCount = vertices.getVertexCount();
 
-	auto posAcc = PositionAttributeAccessor::create(mesh->openVertexData(), VertexAttributeIds::POSITION);
-
-	auto comp = [&posAcc, &tolerance](const RawVertex& lhs, const RawVertex& rhs) -> bool {
-		auto v1 = posAcc->getPosition(lhs.getIndex());
-		auto v2 = posAcc->getPosition(rhs.getIndex());
-		if(std::abs(v1.x()-v2.x()) > tolerance)
-			return v1.x() < v2.x();
-		if(std::abs(v1.y()-v2.y()) > tolerance)
-			return v1.y() < v2.y();
-		if(std::abs(v1.z()-v2.z()) > tolerance)
-			return v1.z() < v2.z();
-		return false;
-	};
-
-	uint32_t oldCount = mesh->getVertexCount();
-
-	// Set of vertices used to create unique vertices.
-	std::set<RawVertex, decltype(comp)> rawVertices(comp);
-	// Mapping from old index to new index.
-	std::map<uint32_t, uint32_t> indexReplace;
-
-	// Simply go over the indices and add one vertex after another.
-	{
-		const MeshVertexData & vertices = mesh->openVertexData();
-		const MeshIndexData & indices = mesh->openIndexData();
-		const std::size_t vertexSize = desc.getVertexSize();
-
-		for (uint32_t counter = 0; counter < indexCount; ++counter) {
-			const uint32_t index = indices[counter];
-			const uint8_t * vertex = vertices[index];
-			RawVertex raw(index, vertex, vertexSize);
-			auto it = rawVertices.insert(raw);
-			indexReplace.insert(std::make_pair(index, it.first->getIndex()));
-		}
-	}
-
-	// Mapping from new index to vertex position.
-	std::map<uint32_t, uint32_t> indexPosition;
-
-	// Create the new mesh and add the rawVertices.
-	Util::Reference<Mesh> result = new Mesh;
-	result->setDataStrategy(mesh->getDataStrategy());
-	result->setFileName(mesh->getFileName());
-	result->setUseIndexData(mesh->isUsingIndexData());
-	result->setDrawMode(mesh->getDrawMode());
-
-	MeshVertexData & vertices = result->openVertexData();
-	vertices.allocate(rawVertices.size(), desc);
-
-	MeshIndexData & indices = result->openIndexData();
-	indices.allocate(indexCount);
-
-	{
-		uint8_t * data = vertices.data();
-		uint32_t vertexPos = 0;
-		for(const auto & vertex : rawVertices) {
-			std::copy(vertex.getData(), vertex.getData() + vertex.getSize(), data);
-			data += vertex.getSize();
-			indexPosition.insert(std::make_pair(vertex.getIndex(), vertexPos));
-			++vertexPos;
-		}
-		// Translate the indices.
-		const uint32_t * srcIndex = mesh->openIndexData().data();
-		uint32_t * dstIndex = indices.data();
-		for (uint32_t counter = 0; counter < indexCount; ++counter) {
-			const uint32_t newIndex = indexReplace.find(*srcIndex)->second;
-			*dstIndex = indexPosition.find(newIndex)->second;
-			++srcIndex;
-			++dstIndex;
-		}
-	}
-
-	vertices.updateBoundingBox();
-	indices.updateIndexRange();
+	std::vector<Geometry::Vec3> positions;
+	positions.reserve(oldCount);
+	auto posAcc = PositionAttributeAccessor::create(vertices, VertexAttributeIds::POSITION);
+	for(uint32_t i = 0; i < oldCount; ++i)
+		positions.emplace_back(posAcc->getPosition(i));
 
-	mesh->swap(*result.get());
+	applyVertexRemap(mesh, weldPositions(positions, indices.data(), indexCount, tolerance));
 
 	return oldCount-mesh->getVertexCount();
 }
 
 // -----------------------------------------------------------------------------
 
-std::deque<Mesh*> splitIntoConnectedComponents(Mesh* mesh, float relDistance/*=0.001*/) {
+/**
+ * (internal) Lock-free disjoint-set forest.
+ * Roots are always linked to the smaller root, so concurrent unions cannot create cycles.
+ */
+class ConcurrentUnionFind {
+		std::unique_ptr<std::atomic<uint32_t>[]> parent;
+	public:
+		explicit ConcurrentUnionFind(uint32_t count) : parent(new std::atomic<uint32_t>[count]) {
+			for(uint32_t i = 0; i < count; ++i)
+				parent[i].store(i, std::memory_order_relaxed);
+		}
+		uint32_t find(uint32_t x) const {
+			while(true) {
+				uint32_t p = parent[x].load(std::memory_order_relaxed);
+				if(p == x)
+					return x;
+				const uint32_t grandParent = parent[p].load(std::memory_order_relaxed);
+				if(p != grandParent) // path halving
+					parent[x].compare_exchange_weak(p, grandParent, std::memory_order_relaxed);
+				x = grandParent;
+			}
+		}
+		void unite(uint32_t a, uint32_t b) {
+			while(true) {
+				a = find(a);
+				b = find(b);
+				if(a == b)
+					return;
+				if(a < b)
+					std::swap(a, b);
+				uint32_t expected = a;
+				if(parent[a].compare_exchange_strong(expected, b, std::memory_order_relaxed))
+					return;
+			}
+		}
+};
+
+//! (static)
+std::deque<Mesh*> splitIntoConnectedComponents(Mesh* mesh, float relDistance/*=0.001*/, const std::function<void(float)> & progress/*=nullptr*/) {
 	std::deque<Mesh*> result;
-	auto bb = mesh->getBoundingBox();
-	float distance =bb.getDiameter() * relDistance;
-	
 	if(mesh->getDrawMode() != Mesh::DRAW_TRIANGLES) {
 		WARN("Mesh is not a triangle mesh.");
 		return result;
 	}
-	
-	struct ConnectedComponent;
-	struct Triangle {
-		uint32_t idx;
-		ConnectedComponent* component;
-		Triangle(uint32_t i) : idx(i), component(nullptr) {}
-	};	
-	struct ConnectedComponent {
-		std::vector<Triangle*> triangles;
-		void join(ConnectedComponent* other) {
-			if(other != this) {
-				if(other->triangles.size() < triangles.size()) {
-					for(auto& t : other->triangles) 
-						t->component = this;
-					triangles.reserve(triangles.size() + other->triangles.size());
-					triangles.insert(triangles.end(), other->triangles.begin(), other->triangles.end());
-					other->triangles.clear();
-				} else {
-					for(auto& t : triangles) 
-						t->component = other;
-					other->triangles.reserve(triangles.size() + other->triangles.size());
-					other->triangles.insert(other->triangles.end(), triangles.begin(), triangles.end());
-					triangles.clear();
-				}
-			}
-		}
-		void add(Triangle* t) {
-			t->component = this;
-			triangles.emplace_back(t);
-		}
-	};
-	struct OctreeEntry : public Geometry::Point<Geometry::Vec3f> {
-		Triangle* triangle;
-		OctreeEntry(const Geometry::Vec3 & p, Triangle* tri) : Geometry::Point<Geometry::Vec3f>(p), triangle(tri) {}
+	const float distance = mesh->getBoundingBox().getDiameter() * relDistance;
+	const uint32_t indexCount = mesh->getPrimitiveCount() * 3;
+	const uint32_t vertexCount = mesh->getVertexCount();
+	if(indexCount == 0)
+		return result;
+	auto reportProgress = [&progress](float value) {
+		if(progress)
+			progress(value);
 	};
-	
-	Geometry::PointOctree<OctreeEntry> octree(bb,distance,100);
-	Geometry::Sphere_f searchSphere({0,0,0}, distance);
-	std::vector<std::unique_ptr<ConnectedComponent>> components;
-	std::vector<std::unique_ptr<Triangle>> triangles;
-	triangles.reserve(mesh->getPrimitiveCount());
-	
-	auto triAcc = TriangleAccessor::create(mesh);
-	std::cout << "Identifying connected components " << 0 << "%        ";
-	for(uint32_t i=0; i<mesh->getPrimitiveCount(); ++i) {
-		auto triangle = new Triangle(i);
-		triangles.emplace_back(triangle);
-		auto tri = triAcc->getTriangle(i);
-		for(const auto& pos : {tri.getVertexA(), tri.getVertexB(), tri.getVertexC()}) {
-			searchSphere.setCenter(pos);
-			std::deque<OctreeEntry> points;
-			octree.collectPointsWithinSphere(searchSphere, points);
-			for(auto& point : points) {
-				auto otherTriangle = point.triangle;
-				if(!triangle->component)
-					otherTriangle->component->add(triangle);
-				else
-					otherTriangle->component->join(triangle->component);
-			}
-		}
-		if(!triangle->component) {
-			auto cc = new ConnectedComponent;
-			cc->add(triangle);
-			components.emplace_back(cc);
-		}		
-		for(const auto& pos : {tri.getVertexA(), tri.getVertexB(), tri.getVertexC()}) {
-			octree.insert({pos, triangle});
+	reportProgress(0.0f);
+
+	// 1. weld close positions
+	const MeshIndexData & iData = mesh->openIndexData();
+	MeshVertexData & vData = mesh->openVertexData();
+	std::vector<Geometry::Vec3> positions;
+	positions.reserve(vertexCount);
+	{
+		auto posAcc = PositionAttributeAccessor::create(vData, VertexAttributeIds::POSITION);
+		for(uint32_t i = 0; i < vertexCount; ++i)
+			positions.emplace_back(posAcc->getPosition(i));
+	}
+	const VertexRemap weld = weldPositions(positions, iData.data(), indexCount, distance);
+	const uint32_t weldedCount = static_cast<uint32_t>(weld.source.size());
+	reportProgress(0.3f);
+
+	// 2. union the welded vertices of each triangle
+	ConcurrentUnionFind sets(weldedCount);
+	parallelFor(indexCount / 3, 1 << 16, [&](uint32_t begin, uint32_t end) {
+		for(uint32_t t = begin; t < end; ++t) {
+			const uint32_t a = weld.newIndex[iData[3 * t]];
+			sets.unite(a, weld.newIndex[iData[3 * t + 1]]);
+			sets.unite(a, weld.newIndex[iData[3 * t + 2]]);
 		}
-		if(i%1000==0) {
-			std::cout << "\rIdentifying connected components " << (static_cast<float>(i*100)/static_cast<float>(mesh->getPrimitiveCount())) << "%        ";
+	});
+	reportProgress(0.5f);
+
+	// 3. number the components and count their vertices and triangles
+	std::vector<uint32_t> componentOfRoot(weldedCount, INVALID_INDEX);
+	std::vector<uint32_t> componentVertexCounts;
+	std::vector<uint32_t> componentIndexCounts;
+	std::vector<uint32_t> triangleComponents(indexCount / 3);
+	for(uint32_t t = 0; t < indexCount / 3; ++t) {
+		uint32_t & component = componentOfRoot[sets.find(weld.newIndex[iData[3 * t]])];
+		if(component == INVALID_INDEX) {
+			component = static_cast<uint32_t>(componentIndexCounts.size());
+			componentIndexCounts.push_back(0);
+			componentVertexCounts.push_back(0);
 		}
+		triangleComponents[t] = component;
+		componentIndexCounts[component] += 3;
 	}
-	std::cout << "\rIdentifying connected components 100%        " << std::endl;
-	
-	uint32_t cmpCount=0;
-	for(const auto& cc : components) {
-		if(cc->triangles.size() > 0) {
-			++cmpCount;
-		}
+	for(uint32_t v = 0; v < vertexCount; ++v) {
+		if(weld.newIndex[v] != INVALID_INDEX)
+			++componentVertexCounts[componentOfRoot[sets.find(weld.newIndex[v])]];
 	}
-	
-	std::cout << "Identifyied " << cmpCount << " components" << std::endl;
-	std::cout << "Creating meshes 0%        ";
-	uint32_t j=0;
-	
-	MeshIndexData tmpIndexData;
-	tmpIndexData.allocate(1);
-	MeshVertexData vertexData(mesh->openVertexData());
-	Mesh tmpMesh(tmpIndexData, vertexData);
-	tmpMesh.setDataStrategy(mesh->getDataStrategy());
-	tmpMesh.setDrawMode(mesh->getDrawMode());
-	tmpMesh.setUseIndexData(true);
-	
-	for(const auto& cc : components) {
-		if(cc->triangles.size() > 0) {
-			MeshIndexData indexData;
-			indexData.allocate(cc->triangles.size()*3);
-			uint32_t i=0;
-			for(auto t : cc->triangles) {
-				auto triIdx = triAcc->getIndices(t->idx);
-				indexData[i++] = std::get<0>(triIdx);
-				indexData[i++] = std::get<1>(triIdx);
-				indexData[i++] = std::get<2>(triIdx);
+	reportProgress(0.6f);
+
+	// 4. emit all component meshes with a single pass over the index data
+	const VertexDescription & desc = mesh->getVertexDescription();
+	const std::size_t vertexSize = desc.getVertexSize();
+	const uint32_t componentCount = static_cast<uint32_t>(componentIndexCounts.size());
+	std::vector<Mesh*> components;
+	components.reserve(componentCount);
+	for(uint32_t c = 0; c < componentCount; ++c)
+		components.push_back(new Mesh(desc, componentVertexCounts[c], componentIndexCounts[c]));
+	std::fill(componentVertexCounts.begin(), componentVertexCounts.end(), 0);
+	std::fill(componentIndexCounts.begin(), componentIndexCounts.end(), 0);
+	std::vector<uint32_t> localIndex(vertexCount, INVALID_INDEX);
+	for(uint32_t t = 0; t < indexCount / 3; ++t) {
+		const uint32_t c = triangleComponents[t];
+		MeshVertexData & newVertexData = components[c]->_getVertexData();
+		MeshIndexData & newIndexData = components[c]->_getIndexData();
+		for(uint32_t corner = 0; corner < 3; ++corner) {
+			const uint32_t index = iData[3 * t + corner];
+			if(localIndex[index] == INVALID_INDEX) {
+				localIndex[index] = componentVertexCounts[c]++;
+				std::copy(vData[index], vData[index] + vertexSize, newVertexData[localIndex[index]]);
 			}
-			tmpMesh.openIndexData().swap(indexData);
-			result.push_back(eliminateUnusedVertices(&tmpMesh));
-			std::cout << "\rCreating meshes " << (static_cast<float>(++j*100)/static_cast<float>(cmpCount)) << "%        ";
+			newIndexData[componentIndexCounts[c]++] = localIndex[index];
 		}
+		if((t & 0xffff) == 0)
+			reportProgress(0.6f + 0.4f * t / (indexCount / 3));
 	}
-	std::cout << "\rCreating meshes 100%        " << std::endl; 
-	
+	for(auto component : components) {
+		component->setDataStrategy(mesh->getDataStrategy());
+		component->_getVertexData().updateBoundingBox();
+		component->_getIndexData().updateIndexRange();
+		result.push_back(component);
+	}
+	reportProgress(1.0f);
 	return result;
 }
 
@@ -2302,6 +2226,8 @@ MeshVertexData* extractVertices(Mesh* mesh, const std::vector<uint32_t>& indices
     uint32_t end = start + desc.getVertexSize();
     std::copy(meshVertices.data() + start, meshVertices.data() + end, result->data() + desc.getVertexSize()*i++);
   }
+  if(meshVertices.getPositionDequantization())
+    result->setPositionDequantization(*meshVertices.getPositionDequantization());
 
   return result;
 }
@@ -15,6 +15,7 @@
 
 #include <cstdint>
 #include <deque>
+#include <functional>
 #include <utility>
 #include <vector>
 #include <set>
@@ -79,6 +80,7 @@ uint32_t calculateHash(const VertexDescription & vd);
  * - first calculating face normals
  * - second calculating the unweighted average of the adjacent face normals for all vertices
  * @note if the mesh has already normals these are ignored and recalculated
+ * @note weighted, parallel and incremental variants are declared in NormalCalculation.h
  * @param m the mesh to be modified
  * @author Ralf Petring
  */
@@ -98,16 +100,30 @@ const Util::StringIdentifier tangentVecName);
 //! Create texture coordinates by projecting the vertices with the given projection matrix.
 void calculateTextureCoordinates_projection( Mesh * mesh, Util::StringIdentifier attribName, const Geometry::Matrix4x4 & projection);
 
+//! Vertices and indices of one source mesh in a mesh created by combineMeshes().
+struct SubmeshRange {
+	uint32_t firstVertex;
+	uint32_t vertexCount;
+	//! First index (argument of Mesh::_display())
+	uint32_t firstElement;
+	uint32_t elementCount;
+};
+
 /**
  * Combine several meshes into a single mesh.
  *
- * @note All meshes must have the same VertexDescription.
+ * The vertex description of the result is the union of the descriptions of the meshes (see uniteVertexDescriptions());
+ * quantized positions are converted to float. All sizes and offsets are computed first, then the meshes are
+ * converted, transformed (positions and normals) and their indices rebased in parallel, directly into the result.
+ * @param transformations Optional transformation for every mesh (in the same order)
+ * @param ranges If not nullptr, it receives the range of every source mesh in the result (empty for null meshes).
  * @author Claudius Jaehn
  * @author Stefan Arens
  * @author Paul Justus
  */
 Mesh * combineMeshes(const std::deque<Mesh *> & meshArray);
 Mesh * combineMeshes(const std::deque<Mesh *> & meshArray, const std::deque<Geometry::Matrix4x4> & transformations);
+Mesh * combineMeshes(const std::deque<Mesh *> & meshArray, const std::deque<Geometry::Matrix4x4> & transformations, std::vector<SubmeshRange> * ranges);
 
 /**
  * Splits the vertex data of a given mesh into multiple blocks of vertex data each containing @a chunkSize many vertices.
@@ -147,8 +163,10 @@ void copyVertexAttribute(Mesh * mesh, Util::StringIdentifier from, Util::StringI
 /**
  * Remove vertices which are equal to each other from the mesh and
  * store them only once. The indices to the vertices are adjusted.
- * This function has runtime O(n * log(n)) where n is the
- * number of vertices in @a mesh.
+ * Vertices that are not referenced by the index data are removed as well.
+ * The remaining vertices are ordered by their first occurrence in the
+ * index data. This function has expected runtime O(n) where n is the
+ * number of indices in @a mesh.
  *
  * @param mesh Mesh to do the elimination on.
  *
@@ -204,6 +222,7 @@ float getLongestSideLength(Mesh * m);
  * @param cacheSize Post-transform vertex cache size to optimize
  * for. This parameter is called @c k in the article.
  * @see http://doi.acm.org/10.1145/1276377.1276489
+ * @see optimizeVertexCache(), optimizeMesh() in MeshOptimizer.h
  * @author Benjamin Eikel
  */
 void optimizeIndices(Mesh * mesh, const uint_fast8_t cacheSize =	24);
@@ -322,7 +341,9 @@ void cutMesh(Mesh* m, const Geometry::Plane& plane, const std::set<uint32_t> tIn
 void extrudeTriangles(Mesh* m, const Geometry::Vec3& dir, const std::set<uint32_t> tIndices);
 
 /**
- * Slow method for finding the first triangle in a mesh that intersects the given ray.
+ * Find the first triangle in a mesh that intersects the given ray.
+ * The query uses the TriangleBVH cached at the mesh, which is built on the first call
+ * and rebuilt after the mesh's vertex or index data has been marked as changed.
  * @param m the mesh
  * @param ray the ray
  * @return -1 if no intersecting triangle was found, the triangle index otherwise.
@@ -333,10 +354,15 @@ int32_t getFirstTriangleIntersectingRay(Mesh* m, const Geometry::Ray3& ray);
 /**
  * Remove vertices which are close to each other from the mesh and
  * store them only once. The indices to the vertices are adjusted.
- * This function has runtime O(n * log(n)) where n is the
- * number of vertices in @a mesh.
+ * Two vertices are close if their positions differ by at most @a tolerance
+ * in each coordinate; a vertex is merged into the closest such vertex that
+ * was kept before. Unreferenced vertices are removed and the remaining ones
+ * are ordered by their first occurrence in the index data.
+ * This function has expected runtime O(n) where n is the
+ * number of indices in @a mesh.
  *
  * @param mesh Mesh to do the elimination on.
+ * @param tolerance Maximal distance per coordinate of merged vertices.
  * @return number of merged vertices
  * @author Sascha Brandt
  */
@@ -344,13 +370,18 @@ uint32_t mergeCloseVertices(Mesh * mesh, float tolerance=std::numeric_limits<flo
 
 /**
  * Splits a mesh into its connected components.
+ * Vertex positions closer than the given distance are welded first (see mergeCloseVertices()),
+ * then triangles sharing a welded vertex are joined using a disjoint-set forest (in parallel).
+ * The vertices of the resulting meshes are copied from the original mesh and ordered by their
+ * first occurrence in the index data.
  *
  * @param mesh Mesh to split into connected components
  * @param relDistance relative distance (w.r.t. mesh's bounding box) between vertices that are considered as connected.
+ * @param progress Optional callback that is called with the progress in [0,1].
  * @return connected components of the mesh
  * @author Sascha Brandt
  */
-std::deque<Mesh*> splitIntoConnectedComponents(Mesh* mesh, float relDistance=0.001);
+std::deque<Mesh*> splitIntoConnectedComponents(Mesh* mesh, float relDistance=0.001, const std::function<void(float)> & progress=nullptr);
 
 /**
  * Moves every vertex along their normal according to the given texture (using its u,v coordinates).
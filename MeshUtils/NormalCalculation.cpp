@@ -0,0 +1,326 @@
+/*
+ This file is part of the Rendering library.
+ Copyright (C) 2026 agent <agent@local>
+
+ This library is subject to the terms of the Mozilla Public License, v. 2.0.
+ You should have received a copy of the MPL along with this library; see the
+ file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "NormalCalculation.h"
+#include "MeshUtils.h"
+#include "ParallelFor.h"
+#include "../Mesh/Mesh.h"
+#include "../Mesh/MeshIndexData.h"
+#include "../Mesh/MeshVertexData.h"
+#include "../Mesh/VertexAttributeAccessors.h"
+#include "../Mesh/VertexAttributeIds.h"
+#include "../Mesh/VertexDescription.h"
+#include "../GLHeader.h"
+#include <Geometry/Vec2.h>
+#include <Geometry/Vec3.h>
+#include <Util/Macros.h>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <numeric>
+
+namespace Rendering {
+namespace MeshUtils {
+
+//! Number of triangles or vertices processed by one thread at least.
+static const uint32_t MIN_RANGE_SIZE = 16384;
+//! Number of vertices read or written by one batch access of the attribute accessors.
+static const uint32_t BLOCK_SIZE = 256;
+
+TriangleAdjacency::TriangleAdjacency(Mesh * mesh) : offsets(mesh->getVertexCount() + 1, 0), indexRevision(0) {
+	const MeshIndexData & indexData = mesh->openIndexData();
+	const uint32_t indexCount = indexData.getIndexCount() - indexData.getIndexCount() % 3;
+	const uint32_t * indices = indexData.data();
+	for(uint32_t i = 0; i < indexCount; ++i)
+		++offsets[indices[i] + 1];
+	std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+	triangles.resize(offsets.back());
+	std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+	for(uint32_t i = 0; i < indexCount; ++i)
+		triangles[cursor[indices[i]]++] = i / 3;
+	indexRevision = mesh->_getIndexData().getRevision();
+}
+
+bool TriangleAdjacency::isValid(Mesh * mesh) const {
+	return mesh->_getIndexData().getRevision() == indexRevision && mesh->getVertexCount() == getVertexCount();
+}
+
+//! (internal) Weighted normal of a triangle; for NormalWeighting::ANGLE, the normalized normal.
+static Geometry::Vec3 calcFaceNormal(const Geometry::Vec3 & a, const Geometry::Vec3 & b, const Geometry::Vec3 & c, NormalWeighting weighting) {
+	// n = cb x ab
+	Geometry::Vec3 n((c - b).cross(a - b));
+	if(weighting != NormalWeighting::AREA && n.length() > 0)
+		n.normalize();
+	return n;
+}
+
+//! (internal) Angle of the triangle at corner @p a.
+static float calcCornerAngle(const Geometry::Vec3 & a, const Geometry::Vec3 & b, const Geometry::Vec3 & c) {
+	const Geometry::Vec3 ab(b - a);
+	const Geometry::Vec3 ac(c - a);
+	return std::atan2(ab.cross(ac).length(), ab.dot(ac));
+}
+
+//! (internal) Index of the corner of triangle @p t that references vertex @p v.
+static uint32_t findCorner(const uint32_t * indices, uint32_t t, uint32_t v) {
+	return indices[3 * t] == v ? 0 : (indices[3 * t + 1] == v ? 1 : 2);
+}
+
+//! (internal) Add a normal attribute if the mesh has none.
+static void assureNormals(Mesh * mesh) {
+	MeshVertexData & vData = mesh->openVertexData();
+	if(!vData.getVertexDescription().hasAttribute(VertexAttributeIds::NORMAL)) {
+		VertexDescription newVd = vData.getVertexDescription();
+		newVd.appendNormalByte();
+		std::unique_ptr<MeshVertexData> newVertices(convertVertices(vData, newVd));
+		vData.swap(*newVertices.get());
+	}
+}
+
+void calculateNormals(Mesh * mesh, NormalWeighting weighting, const TriangleAdjacency * adjacency) {
+	assureNormals(mesh);
+	std::unique_ptr<TriangleAdjacency> localAdjacency;
+	if(!adjacency) {
+		localAdjacency.reset(new TriangleAdjacency(mesh));
+		adjacency = localAdjacency.get();
+	} else if(!adjacency->isValid(mesh)) {
+		INVALID_ARGUMENT_EXCEPTION("calculateNormals: The adjacency does not match the mesh.");
+	}
+	MeshVertexData & vData = mesh->openVertexData();
+	const MeshIndexData & indexData = mesh->openIndexData();
+	const uint32_t * indices = indexData.data();
+	const uint32_t vertexCount = vData.getVertexCount();
+	const uint32_t triangleCount = indexData.getIndexCount() / 3;
+
+	// positions as separate coordinate arrays
+	std::vector<float> posX(vertexCount), posY(vertexCount), posZ(vertexCount);
+	{
+		Util::Reference<PositionAttributeAccessor> positionAccessor(PositionAttributeAccessor::create(vData, VertexAttributeIds::POSITION));
+		parallelFor(vertexCount, MIN_RANGE_SIZE, [&](uint32_t begin, uint32_t end) {
+			float xyz[3 * BLOCK_SIZE];
+			for(uint32_t blockBegin = begin; blockBegin < end; blockBegin += BLOCK_SIZE) {
+				const uint32_t count = std::min(BLOCK_SIZE, end - blockBegin);
+				positionAccessor->getPositions(blockBegin, count, xyz);
+				for(uint32_t i = 0; i < count; ++i) {
+					posX[blockBegin + i] = xyz[3 * i];
+					posY[blockBegin + i] = xyz[3 * i + 1];
+					posZ[blockBegin + i] = xyz[3 * i + 2];
+				}
+			}
+		});
+	}
+
+	// face normals (and corner angles)
+	std::vector<float> faceX(triangleCount), faceY(triangleCount), faceZ(triangleCount);
+	std::vector<float> angles(weighting == NormalWeighting::ANGLE ? 3 * static_cast<size_t>(triangleCount) : 0);
+	parallelFor(triangleCount, MIN_RANGE_SIZE, [&](uint32_t begin, uint32_t end) {
+		for(uint32_t t = begin; t < end; ++t) {
+			const uint32_t ia = indices[3 * t], ib = indices[3 * t + 1], ic = indices[3 * t + 2];
+			const Geometry::Vec3 a(posX[ia], posY[ia], posZ[ia]);
+			const Geometry::Vec3 b(posX[ib], posY[ib], posZ[ib]);
+			const Geometry::Vec3 c(posX[ic], posY[ic], posZ[ic]);
+			const Geometry::Vec3 n = calcFaceNormal(a, b, c, weighting);
+			faceX[t] = n.getX();
+			faceY[t] = n.getY();
+			faceZ[t] = n.getZ();
+			if(weighting == NormalWeighting::ANGLE) {
+				angles[3 * t] = calcCornerAngle(a, b, c);
+				angles[3 * t + 1] = calcCornerAngle(b, c, a);
+				angles[3 * t + 2] = calcCornerAngle(c, a, b);
+			}
+		}
+	});
+
+	// gather the face normals per vertex
+	const uint32_t * offsets = adjacency->getOffsets().data();
+	const uint32_t * triangles = adjacency->getTriangles().data();
+	Util::Reference<NormalAttributeAccessor> normalAccessor(NormalAttributeAccessor::create(vData, VertexAttributeIds::NORMAL));
+	parallelFor(vertexCount, MIN_RANGE_SIZE, [&](uint32_t begin, uint32_t end) {
+		float xyz[3 * BLOCK_SIZE];
+		for(uint32_t blockBegin = begin; blockBegin < end; blockBegin += BLOCK_SIZE) {
+			const uint32_t count = std::min(BLOCK_SIZE, end - blockBegin);
+			for(uint32_t i = 0; i < count; ++i) {
+				const uint32_t v = blockBegin + i;
+				Geometry::Vec3 n;
+				for(uint32_t j = offsets[v]; j < offsets[v + 1]; ++j) {
+					const uint32_t t = triangles[j];
+					const float weight = weighting == NormalWeighting::ANGLE ? angles[3 * t + findCorner(indices, t, v)] : 1.0f;
+					n += Geometry::Vec3(faceX[t], faceY[t], faceZ[t]) * weight;
+				}
+				const float length = n.length();
+				if(length > 0)
+					n /= length;
+				xyz[3 * i] = n.getX();
+				xyz[3 * i + 1] = n.getY();
+				xyz[3 * i + 2] = n.getZ();
+			}
+			normalAccessor->setNormals(blockBegin, count, xyz);
+		}
+	});
+	vData.markAsChanged();
+}
+
+void updateNormals(Mesh * mesh, const std::vector<uint32_t> & dirtyVertices, NormalWeighting weighting, const TriangleAdjacency & adjacency) {
+	if(!adjacency.isValid(mesh))
+		INVALID_ARGUMENT_EXCEPTION("updateNormals: The adjacency does not match the mesh.");
+	MeshVertexData & vData = mesh->openVertexData();
+	if(!vData.getVertexDescription().hasAttribute(VertexAttributeIds::NORMAL))
+		INVALID_ARGUMENT_EXCEPTION("updateNormals: No normals.");
+	const uint32_t * indices = mesh->openIndexData().data();
+	const std::vector<uint32_t> & offsets = adjacency.getOffsets();
+	const std::vector<uint32_t> & triangles = adjacency.getTriangles();
+
+	// all vertices sharing a triangle with a dirty vertex
+	std::vector<uint32_t> affectedVertices;
+	for(const auto & v : dirtyVertices) {
+		for(uint32_t i = offsets.at(v); i < offsets[v + 1]; ++i)
+			affectedVertices.insert(affectedVertices.end(), indices + 3 * triangles[i], indices + 3 * triangles[i] + 3);
+	}
+	std::sort(affectedVertices.begin(), affectedVertices.end());
+	affectedVertices.erase(std::unique(affectedVertices.begin(), affectedVertices.end()), affectedVertices.end());
+
+	Util::Reference<PositionAttributeAccessor> positionAccessor(PositionAttributeAccessor::create(vData, VertexAttributeIds::POSITION));
+	Util::Reference<NormalAttributeAccessor> normalAccessor(NormalAttributeAccessor::create(vData, VertexAttributeIds::NORMAL));
+	parallelFor(static_cast<uint32_t>(affectedVertices.size()), MIN_RANGE_SIZE, [&](uint32_t begin, uint32_t end) {
+		for(uint32_t j = begin; j < end; ++j) {
+			const uint32_t v = affectedVertices[j];
+			Geometry::Vec3 n;
+			for(uint32_t i = offsets[v]; i < offsets[v + 1]; ++i) {
+				const uint32_t t = triangles[i];
+				const Geometry::Vec3 corners[3] = {positionAccessor->getPosition(indices[3 * t]), positionAccessor->getPosition(indices[3 * t + 1]),
+												   positionAccessor->getPosition(indices[3 * t + 2])};
+				float weight = 1.0f;
+				if(weighting == NormalWeighting::ANGLE) {
+					const uint32_t k = findCorner(indices, t, v);
+					weight = calcCornerAngle(corners[k], corners[(k + 1) % 3], corners[(k + 2) % 3]);
+				}
+				n += calcFaceNormal(corners[0], corners[1], corners[2], weighting) * weight;
+			}
+			const float length = n.length();
+			normalAccessor->setNormal(v, length > 0 ? n / length : n);
+		}
+	});
+	vData.markAsChanged();
+}
+
+void calculateTangentVectors(Mesh * mesh, const Util::StringIdentifier uvName, const Util::StringIdentifier tangentVecName,
+							 const TriangleAdjacency & adjacency) {
+	using Geometry::Vec3;
+	using Geometry::Vec2;
+	MeshVertexData & vertices(mesh->openVertexData());
+	const MeshIndexData & indices(mesh->openIndexData());
+
+	{ // assure mesh has the right form
+		if (mesh->getDrawMode() != Mesh::DRAW_TRIANGLES)
+			INVALID_ARGUMENT_EXCEPTION("addTangentVectors: No triangle mesh.");
+
+		if (!adjacency.isValid(mesh))
+			INVALID_ARGUMENT_EXCEPTION("addTangentVectors: The adjacency does not match the mesh.");
+
+		if (vertices.getVertexDescription().getAttribute(VertexAttributeIds::POSITION).getDataType() != GL_FLOAT)
+			INVALID_ARGUMENT_EXCEPTION("addTangentVectors: No float positions.");
+
+		if (vertices.getVertexDescription().getAttribute(VertexAttributeIds::NORMAL).empty())
+			INVALID_ARGUMENT_EXCEPTION("addTangentVectors: No normals.");
+
+		if (vertices.getVertexDescription().getAttribute(uvName).getDataType() != GL_FLOAT
+				|| vertices.getVertexDescription().getAttribute(uvName).getNumValues() < 2)
+			INVALID_ARGUMENT_EXCEPTION("addTangentVectors: No or wrong texture coordinates.");
+
+		// add slot for 4 byte tangent vector
+		if (vertices.getVertexDescription().getAttribute(tangentVecName).empty()) {
+			VertexDescription newVd = vertices.getVertexDescription();
+			newVd.appendAttribute(tangentVecName, 4, GL_BYTE, true);
+			std::unique_ptr<MeshVertexData> newVertices(convertVertices(vertices, newVd));
+			vertices.swap(*newVertices.get());
+		}
+		if (vertices.getVertexDescription().getAttribute(tangentVecName).getDataType() != GL_BYTE || vertices.getVertexDescription().getAttribute(
+				tangentVecName).getNumValues() != 4)
+			INVALID_ARGUMENT_EXCEPTION("createTextureCoordinates_boxProjection: Wrong tangent format.");
+
+	}
+	// calculate tangents and bitangents
+	const VertexDescription & vDesc = vertices.getVertexDescription();
+	const VertexAttribute & posAttr = vDesc.getAttribute(VertexAttributeIds::POSITION);
+	const VertexAttribute & normalAttr = vDesc.getAttribute(VertexAttributeIds::NORMAL);
+	const VertexAttribute & uvAttr = vDesc.getAttribute(uvName);
+	const VertexAttribute & tanAttr = vDesc.getAttribute(tangentVecName);
+	const uint32_t triangleCount = indices.getIndexCount() / 3;
+	const uint32_t vertexCount = vertices.getVertexCount();
+	const bool floatNormals = normalAttr.getDataType() == GL_FLOAT;
+	if (!floatNormals && normalAttr.getDataType() != GL_BYTE)
+		return;
+
+	// per triangle
+	std::vector<Vec3> triangleSDirs(triangleCount);
+	std::vector<Vec3> triangleTDirs(triangleCount);
+	parallelFor(triangleCount, MIN_RANGE_SIZE, [&](uint32_t begin, uint32_t end) {
+		for (uint32_t t = begin; t < end; ++t) {
+			const uint32_t index1 = indices[3 * t];
+			const uint32_t index2 = indices[3 * t + 1];
+			const uint32_t index3 = indices[3 * t + 2];
+
+			const Vec3 pos1(reinterpret_cast<const float*> (vertices[index1] + posAttr.getOffset()));
+			const Vec3 pos2(reinterpret_cast<const float*> (vertices[index2] + posAttr.getOffset()));
+			const Vec3 pos3(reinterpret_cast<const float*> (vertices[index3] + posAttr.getOffset()));
+
+			const Vec2 uv1(reinterpret_cast<const float*> (vertices[index1] + uvAttr.getOffset()));
+			const Vec2 uv2(reinterpret_cast<const float*> (vertices[index2] + uvAttr.getOffset()));
+			const Vec2 uv3(reinterpret_cast<const float*> (vertices[index3] + uvAttr.getOffset()));
+
+			const float x1 = pos2.x() - pos1.x();
+			const float x2 = pos3.x() - pos1.x();
+			const float y1 = pos2.y() - pos1.y();
+			const float y2 = pos3.y() - pos1.y();
+			const float z1 = pos2.z() - pos1.z();
+			const float z2 = pos3.z() - pos1.z();
+
+			const float s1 = uv2.x() - uv1.x();
+			const float s2 = uv3.x() - uv1.x();
+			const float t1 = uv2.y() - uv1.y();
+			const float t2 = uv3.y() - uv1.y();
+
+			const float r = 1.0f / (s1 * t2 - s2 * t1);
+			triangleSDirs[t] = Vec3((t2 * x1 - t1 * x2) * r, (t2 * y1 - t1 * y2) * r, (t2 * z1 - t1 * z2) * r);
+			triangleTDirs[t] = Vec3((s1 * x2 - s2 * x1) * r, (s1 * y2 - s2 * y1) * r, (s1 * z2 - s2 * z1) * r);
+		}
+	});
+
+	// per vertex
+	const std::vector<uint32_t> & offsets = adjacency.getOffsets();
+	const std::vector<uint32_t> & triangles = adjacency.getTriangles();
+	parallelFor(vertexCount, MIN_RANGE_SIZE, [&](uint32_t begin, uint32_t end) {
+		for (uint32_t i = begin; i < end; ++i) {
+			Vec3 t, tan2;
+			for (uint32_t j = offsets[i]; j < offsets[i + 1]; ++j) {
+				t += triangleSDirs[triangles[j]];
+				tan2 += triangleTDirs[triangles[j]];
+			}
+			Vec3 normal;
+			if (floatNormals) {
+				normal = Vec3(reinterpret_cast<const float*> (vertices[i] + normalAttr.getOffset()));
+			} else {
+				const int8_t * nPtr = reinterpret_cast<const int8_t*> (vertices[i] + normalAttr.getOffset());
+				normal = Vec3(nPtr[0], nPtr[1], nPtr[2]).normalize();
+			}
+			const Vec3 tan((t - normal * normal.dot(t)).getNormalized() * 127); // Gram-Schmidt orthogonalize
+
+			int8_t * const tPtr = reinterpret_cast<int8_t*> (vertices[i] + tanAttr.getOffset());
+			int8_t handedness = (normal.cross(t).dot(tan2) < 0.0f) ? -1 : 1; // Calculate handedness
+			tPtr[0] = handedness * static_cast<int8_t> (tan.x());
+			tPtr[1] = handedness * static_cast<int8_t> (tan.y());
+			tPtr[2] = handedness * static_cast<int8_t> (tan.z());
+			tPtr[3] = handedness;
+		}
+	});
+	vertices.markAsChanged();
+}
+
+}
+}
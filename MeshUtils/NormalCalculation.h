@@ -0,0 +1,71 @@
+/*
+ This file is part of the Rendering library.
+ Copyright (C) 2026 agent <agent@local>
+
+ This library is subject to the terms of the Mozilla Public License, v. 2.0.
+ You should have received a copy of the MPL along with this library; see the
+ file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef RENDERING_MESHUTILS_NORMALCALCULATION_H_
+#define RENDERING_MESHUTILS_NORMALCALCULATION_H_
+
+#include <Util/StringIdentifier.h>
+#include <cstdint>
+#include <vector>
+
+namespace Rendering {
+class Mesh;
+namespace MeshUtils {
+
+//! Weighting of the adjacent face normals when calculating a vertex normal.
+enum class NormalWeighting : uint8_t {
+	UNIFORM,	//!< Average of the normalized face normals (as calculateNormals(Mesh*))
+	AREA,		//!< Face normals weighted by the area of the triangles
+	ANGLE		//!< Face normals weighted by the angle of the triangles at the vertex
+};
+
+/**
+ * Triangles adjacent to every vertex of an indexed triangle mesh (compressed row storage).
+ * Building the adjacency once allows to recalculate normals and tangents of a deforming mesh
+ * without rebuilding it; it stays valid as long as the index data of the mesh is not changed.
+ */
+class TriangleAdjacency {
+	public:
+		explicit TriangleAdjacency(Mesh * mesh);
+
+		//! Return true if the index data of the mesh has not been changed since the adjacency was built.
+		bool isValid(Mesh * mesh) const;
+
+		uint32_t getVertexCount() const	{	return static_cast<uint32_t>(offsets.size() - 1);	}
+		//! Triangles adjacent to vertex @p v are getTriangles()[getOffsets()[v]] to getTriangles()[getOffsets()[v+1]-1], in ascending order.
+		const std::vector<uint32_t> & getOffsets() const	{	return offsets;	}
+		const std::vector<uint32_t> & getTriangles() const	{	return triangles;	}
+
+	private:
+		std::vector<uint32_t> offsets;
+		std::vector<uint32_t> triangles;
+		uint64_t indexRevision;
+};
+
+/*! Calculate the vertex normals of an indexed triangle mesh on several threads.
+	The face normals are calculated once per triangle and gathered per vertex over the vertex-triangle adjacency.
+	A normal attribute (byte) is added if the mesh has none.
+	@param adjacency Adjacency of the mesh to reuse; built temporarily if nullptr.
+	@note With NormalWeighting::UNIFORM, the result is the same as the one of calculateNormals(Mesh*). */
+void calculateNormals(Mesh * mesh, NormalWeighting weighting, const TriangleAdjacency * adjacency = nullptr);
+
+/*! Recalculate only the normals affected by moving the given vertices: the normals of all vertices sharing
+	a triangle with one of @p dirtyVertices. The mesh needs a normal attribute.
+	@note The result equals the one of calculateNormals() with the same weighting. */
+void updateNormals(Mesh * mesh, const std::vector<uint32_t> & dirtyVertices, NormalWeighting weighting, const TriangleAdjacency & adjacency);
+
+/*! Parallel version of calculateTangentVectors(Mesh*, Util::StringIdentifier, Util::StringIdentifier) that can
+	reuse the adjacency of the mesh. The requirements and results are the same. */
+void calculateTangentVectors(Mesh * mesh, const Util::StringIdentifier uvName, const Util::StringIdentifier tangentVecName,
+							 const TriangleAdjacency & adjacency);
+
+}
+}
+
+#endif /* RENDERING_MESHUTILS_NORMALCALCULATION_H_ */
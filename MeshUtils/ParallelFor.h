@@ -0,0 +1,51 @@
+/*
+ This file is part of the Rendering library.
+ Copyright (C) 2026 agent <agent@local>
+
+ This library is subject to the terms of the Mozilla Public License, v. 2.0.
+ You should have received a copy of the MPL along with this library; see the
+ file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef RENDERING_MESHUTILS_PARALLELFOR_H_
+#define RENDERING_MESHUTILS_PARALLELFOR_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace Rendering {
+namespace MeshUtils {
+
+/**
+ * (internal) Split [0, @p count) into one consecutive range per hardware thread and
+ * call @p function(begin, end) for every range in parallel. The calling thread
+ * processes the first range. Ranges smaller than @p minRangeSize are avoided,
+ * so small inputs are processed by the calling thread only.
+ */
+template<typename Function_t>
+void parallelFor(uint32_t count, uint32_t minRangeSize, const Function_t & function) {
+	const uint32_t hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+	const uint32_t threadCount = std::max(1u, std::min(hardwareThreads, count / std::max(1u, minRangeSize)));
+	if(threadCount == 1) {
+		function(0, count);
+		return;
+	}
+	std::vector<std::thread> threads;
+	threads.reserve(threadCount - 1);
+	const uint32_t rangeSize = (count + threadCount - 1) / threadCount;
+	for(uint32_t t = 1; t < threadCount; ++t) {
+		const uint32_t begin = std::min(count, t * rangeSize);
+		const uint32_t end = std::min(count, begin + rangeSize);
+		threads.emplace_back([&function, begin, end]() { function(begin, end); });
+	}
+	function(0, std::min(count, rangeSize));
+	for(auto & thread : threads)
+		thread.join();
+}
+
+}
+}
+
+#endif /* RENDERING_MESHUTILS_PARALLELFOR_H_ */
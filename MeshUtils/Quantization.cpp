@@ -0,0 +1,233 @@
+/*
+ This file is part of the Rendering library.
+ Copyright (C) 2026 agent <agent@local>
+
+ This library is subject to the terms of the Mozilla Public License, v. 2.0.
+ You should have received a copy of the MPL along with this library; see the
+ file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "Quantization.h"
+
+#include "../Mesh/Mesh.h"
+#include "../Mesh/MeshVertexData.h"
+#include "../Mesh/VertexAttributeAccessors.h"
+#include "../Mesh/VertexAttributeIds.h"
+#include "../Mesh/VertexDescription.h"
+#include "../GLHeader.h"
+
+#include <Geometry/Box.h>
+#include <Geometry/Vec3.h>
+#include <Util/Graphics/Color.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+namespace Rendering {
+namespace MeshUtils {
+
+//! Upper bound of the angular error of the 16 bit octahedral encoding (measured: ~0.0037 degrees).
+static const float OCTAHEDRAL16_MAX_ERROR_DEGREES = 0.005f;
+//! Largest finite half float value.
+static const float HALF_MAX = 65504.0f;
+
+enum class Encoding : uint8_t {
+	KEEP,
+	POSITION_16,
+	OCTAHEDRAL_16,
+	HALF_FLOAT,
+	RGBA_8
+};
+
+static bool isTexCoord(const Util::StringIdentifier & nameId) {
+	for(uint_fast8_t unit = 0; unit < 8; ++unit) {
+		if(nameId == VertexAttributeIds::getTextureCoordinateIdentifier(unit))
+			return true;
+	}
+	return false;
+}
+
+//! Angle between two directions in degrees (atan2 is accurate for small angles, unlike acos).
+static float angleDegrees(const Geometry::Vec3 & a, const Geometry::Vec3 & b) {
+	return std::atan2(a.cross(b).length(), a.dot(b)) * 180.0f / static_cast<float>(M_PI);
+}
+
+static Encoding chooseEncoding(const VertexAttribute & attr, const MeshVertexData & vertices, const QuantizationOptions & options) {
+	if(attr.getDataType() != GL_FLOAT)
+		return Encoding::KEEP;
+	const Util::StringIdentifier nameId = attr.getNameId();
+	if(nameId == VertexAttributeIds::POSITION && attr.getNumValues() >= 3) {
+		const Geometry::Box & box = vertices.getBoundingBox();
+		const float extent = std::sqrt(box.getExtentX() * box.getExtentX() + box.getExtentY() * box.getExtentY() + box.getExtentZ() * box.getExtentZ());
+		if(options.maxPositionError > 0 && 0.5f * extent / 65535.0f <= options.maxPositionError)
+			return Encoding::POSITION_16;
+	} else if((nameId == VertexAttributeIds::NORMAL || nameId == VertexAttributeIds::TANGENT) && attr.getNumValues() >= 3) {
+		if(options.maxNormalErrorDegrees >= OCTAHEDRAL16_MAX_ERROR_DEGREES)
+			return Encoding::OCTAHEDRAL_16;
+	} else if(isTexCoord(nameId) && attr.getNumValues() == 2) {
+		if(options.maxTexCoordError <= 0)
+			return Encoding::KEEP;
+		// The rounding error of a half float is at most 2^-11 relative to its magnitude.
+		auto acc = FloatAttributeAccessor::create(const_cast<MeshVertexData &>(vertices), nameId);
+		float maxAbs = 0;
+		for(uint32_t i = 0; i < vertices.getVertexCount(); ++i) {
+			const std::vector<float> values = acc->getValues(i);
+			maxAbs = std::max(maxAbs, std::max(std::abs(values[0]), std::abs(values[1])));
+		}
+		if(maxAbs < HALF_MAX && maxAbs / 2048.0f <= options.maxTexCoordError)
+			return Encoding::HALF_FLOAT;
+	} else if(nameId == VertexAttributeIds::COLOR && (attr.getNumValues() == 3 || attr.getNumValues() == 4)) {
+		if(options.maxColorError < 0.5f / 255.0f)
+			return Encoding::KEEP;
+		// high dynamic range colors would be clamped
+		auto acc = FloatAttributeAccessor::create(const_cast<MeshVertexData &>(vertices), nameId);
+		for(uint32_t i = 0; i < vertices.getVertexCount(); ++i) {
+			for(const float value : acc->getValues(i)) {
+				if(!(value >= 0.0f && value <= 1.0f))
+					return Encoding::KEEP;
+			}
+		}
+		return Encoding::RGBA_8;
+	}
+	return Encoding::KEEP;
+}
+
+QuantizationReport quantizeMesh(Mesh * mesh, const QuantizationOptions & options) {
+	QuantizationReport report;
+	MeshVertexData & oldVertices = mesh->openVertexData();
+	const VertexDescription & oldVd = oldVertices.getVertexDescription();
+	const uint32_t vertexCount = oldVertices.getVertexCount();
+	report.oldVertexSize = oldVd.getVertexSize();
+	report.newVertexSize = oldVd.getVertexSize();
+	if(vertexCount == 0)
+		return report;
+	oldVertices.updateBoundingBox();
+	const Geometry::Box box = oldVertices.getBoundingBox();
+
+	VertexDescription newVd;
+	std::vector<Encoding> encodings;
+	bool changed = false;
+	for(const auto & attr : oldVd.getAttributes()) {
+		const Encoding encoding = chooseEncoding(attr, oldVertices, options);
+		switch(encoding) {
+			case Encoding::POSITION_16:
+				newVd.appendPosition4DUnsignedShort();
+				break;
+			case Encoding::OCTAHEDRAL_16:
+				newVd.appendAttribute(attr.getNameId(), attr.getNumValues() >= 4 ? 4 : 2, GL_SHORT, true);
+				break;
+			case Encoding::HALF_FLOAT:
+				newVd.appendAttribute(attr.getNameId(), 2, GL_HALF_FLOAT, false);
+				break;
+			case Encoding::RGBA_8:
+				newVd.appendAttribute(attr.getNameId(), 4, GL_UNSIGNED_BYTE, true);
+				break;
+			case Encoding::KEEP:
+			default:
+				newVd.appendAttribute(attr.getNameId(), attr.getNumValues(), attr.getDataType(), attr.getNormalize(), attr.getConvertToFloat());
+				break;
+		}
+		encodings.emplace_back(encoding);
+		changed |= encoding != Encoding::KEEP;
+	}
+	if(!changed)
+		return report;
+
+	std::unique_ptr<MeshVertexData> newVertices(new MeshVertexData);
+	newVertices->allocate(vertexCount, newVd);
+	std::fill_n(newVertices->data(), newVertices->dataSize(), 0);
+
+	const size_t oldVertexSize = oldVd.getVertexSize();
+	const size_t newVertexSize = newVd.getVertexSize();
+	for(size_t a = 0; a < encodings.size(); ++a) {
+		const VertexAttribute & oldAttr = oldVd.getAttributes()[a];
+		const VertexAttribute & newAttr = newVd.getAttribute(oldAttr.getNameId());
+		const Util::StringIdentifier nameId = oldAttr.getNameId();
+		switch(encodings[a]) {
+			case Encoding::POSITION_16: {
+				// map the bounding box to the unit cube; use a scale of 1 for flat dimensions to keep the matrix invertible
+				Geometry::Matrix4x4 dequantization;
+				dequantization.translate(box.getMin());
+				dequantization.scale(box.getExtentX() > 0 ? box.getExtentX() : 1.0f,
+									 box.getExtentY() > 0 ? box.getExtentY() : 1.0f,
+									 box.getExtentZ() > 0 ? box.getExtentZ() : 1.0f);
+				newVertices->setPositionDequantization(dequantization);
+				report.positionDequantization = dequantization;
+				auto oldAcc = PositionAttributeAccessor::create(oldVertices, nameId);
+				auto newAcc = PositionAttributeAccessor::create(*newVertices, nameId);
+				for(uint32_t i = 0; i < vertexCount; ++i) {
+					const Geometry::Vec3 p = oldAcc->getPosition(i);
+					newAcc->setPosition(i, p);
+					report.positionError = std::max(report.positionError, p.distance(newAcc->getPosition(i)));
+				}
+				break;
+			}
+			case Encoding::OCTAHEDRAL_16: {
+				auto oldAcc = NormalAttributeAccessor::create(oldVertices, nameId);
+				auto newAcc = NormalAttributeAccessor::create(*newVertices, nameId);
+				const bool hasW = newAttr.getNumValues() == 4;
+				Util::Reference<FloatAttributeAccessor> oldValues;
+				if(hasW)
+					oldValues = FloatAttributeAccessor::create(oldVertices, nameId);
+				for(uint32_t i = 0; i < vertexCount; ++i) {
+					const Geometry::Vec3 n = oldAcc->getNormal(i);
+					newAcc->setNormal(i, n);
+					if(hasW) {
+						// the handedness of tangents is stored as third value
+						int16_t * v = reinterpret_cast<int16_t*>(newVertices->data() + i * newVertexSize + newAttr.getOffset());
+						v[2] = oldValues->getValues(i)[3] < 0 ? -32767 : 32767;
+					}
+					if(n.length() > 0)
+						report.normalErrorDegrees = std::max(report.normalErrorDegrees, angleDegrees(n, newAcc->getNormal(i)));
+				}
+				break;
+			}
+			case Encoding::HALF_FLOAT: {
+				auto oldAcc = FloatAttributeAccessor::create(oldVertices, nameId);
+				auto newAcc = FloatAttributeAccessor::create(*newVertices, nameId);
+				for(uint32_t i = 0; i < vertexCount; ++i) {
+					const std::vector<float> values = oldAcc->getValues(i);
+					newAcc->setValues(i, values);
+					const std::vector<float> quantized = newAcc->getValues(i);
+					for(size_t c = 0; c < 2; ++c)
+						report.texCoordError = std::max(report.texCoordError, std::abs(values[c] - quantized[c]));
+				}
+				break;
+			}
+			case Encoding::RGBA_8: {
+				auto oldAcc = ColorAttributeAccessor::create(oldVertices, nameId);
+				auto newAcc = ColorAttributeAccessor::create(*newVertices, nameId);
+				for(uint32_t i = 0; i < vertexCount; ++i) {
+					const Util::Color4f color = oldAcc->getColor4f(i);
+					newAcc->setColor(i, color);
+					const Util::Color4f quantized = newAcc->getColor4f(i);
+					report.colorError = std::max({report.colorError, std::abs(color.getR() - quantized.getR()), std::abs(color.getG() - quantized.getG()),
+												std::abs(color.getB() - quantized.getB()), std::abs(color.getA() - quantized.getA())});
+				}
+				break;
+			}
+			case Encoding::KEEP:
+			default: {
+				const uint8_t * source = oldVertices.data() + oldAttr.getOffset();
+				uint8_t * target = newVertices->data() + newAttr.getOffset();
+				for(uint32_t i = 0; i < vertexCount; ++i) {
+					std::copy(source, source + oldAttr.getDataSize(), target);
+					source += oldVertexSize;
+					target += newVertexSize;
+				}
+				break;
+			}
+		}
+	}
+	// keep the bounding box of the original positions (the quantized positions may lie slightly outside)
+	newVertices->_setBoundingBox(box);
+	oldVertices.swap(*newVertices);
+	oldVertices.markAsChanged();
+	report.newVertexSize = newVertexSize;
+	return report;
+}
+
+}
+}
@@ -0,0 +1,68 @@
+/*
+ This file is part of the Rendering library.
+ Copyright (C) 2026 agent <agent@local>
+
+ This library is subject to the terms of the Mozilla Public License, v. 2.0.
+ You should have received a copy of the MPL along with this library; see the
+ file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef RENDERING_MESHUTILS_QUANTIZATION_H_
+#define RENDERING_MESHUTILS_QUANTIZATION_H_
+
+#include <Geometry/Matrix4x4.h>
+#include <cstddef>
+
+namespace Rendering {
+class Mesh;
+namespace MeshUtils {
+
+/*! Error budgets for quantizeMesh(). An attribute is only converted into its compact encoding
+	if the maximal error of the encoding is within the budget; a budget of 0 keeps the attribute. */
+struct QuantizationOptions {
+	//! Maximal distance between an original and a quantized position (in object space).
+	float maxPositionError;
+	//! Maximal angle (in degrees) between an original and a quantized normal or tangent.
+	float maxNormalErrorDegrees;
+	//! Maximal absolute error of a texture coordinate component.
+	float maxTexCoordError;
+	//! Maximal absolute error of a color component (in [0,1]).
+	float maxColorError;
+
+	QuantizationOptions() : maxPositionError(0.001f), maxNormalErrorDegrees(0.01f), maxTexCoordError(0.001f), maxColorError(0.002f) {}
+};
+
+//! Result of quantizeMesh(); the errors are measured by decoding the quantized values.
+struct QuantizationReport {
+	float positionError;
+	float normalErrorDegrees;
+	float texCoordError;
+	float colorError;
+	std::size_t oldVertexSize;
+	std::size_t newVertexSize;
+	//! Transformation from the stored positions to object space (identity if the positions were not quantized).
+	Geometry::Matrix4x4 positionDequantization;
+
+	QuantizationReport() : positionError(0), normalErrorDegrees(0), texCoordError(0), colorError(0), oldVertexSize(0), newVertexSize(0) {}
+};
+
+/*! Replace the float vertex attributes of the mesh by compact encodings:
+	- Positions: four normalized unsigned shorts relative to the bounding box
+		(see VertexDescription::appendPosition4DUnsignedShort()). The dequantization matrix is stored
+		in the vertex data (MeshVertexData::getPositionDequantization()) and has to be applied by the shader.
+	- Normals and tangents: octahedral encoding in two normalized shorts (see VertexDescription::appendNormalOctahedral());
+		the w component of four-dimensional tangents is kept in a third short.
+	- Texture coordinates: two half floats.
+	- Colors: four normalized unsigned bytes; colors with components outside of [0,1] are kept.
+
+	Attributes that are not stored as floats are kept. The bounding box stays in object space.
+	\note Only 16 bit octahedral normals are generated: vertex attributes have to be aligned to four bytes,
+		so a 2x8 bit encoding would not save any memory.
+	\note Of the mesh file formats, only MMF version 2 (StreamerMMF::saveMeshes()) stores the dequantization matrix;
+		the other savers write the quantized positions with a warning. */
+QuantizationReport quantizeMesh(Mesh * mesh, const QuantizationOptions & options = QuantizationOptions());
+
+}
+}
+
+#endif /* RENDERING_MESHUTILS_QUANTIZATION_H_ */
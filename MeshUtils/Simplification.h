@@ -48,6 +48,36 @@ Mesh * simplifyMesh(Mesh * mesh,
 					float maxAngle, 
 					const weights_t & weights);
 
+/**
+ * Simplify the given mesh like simplifyMesh(), but with flat arrays (corner lists and fixed-size
+ * quadrics instead of sets and a heap) and in parallel: the triangles are split into spatial
+ * partitions that are simplified concurrently while the vertices on the borders between partitions
+ * are locked. A final pass over the whole mesh then simplifies the borders.
+ * Edges are collapsed in passes: the cheapest independent collapses of the current mesh are applied,
+ * then the costs are recomputed.
+ * The weights have the same meaning as for simplifyMesh(); a non-zero boundary weight adds the boundary
+ * constraint planes. The vertex weight has to be positive. Pairs of unconnected vertices
+ * (the threshold of simplifyMesh()) are not supported.
+ *
+ * @param mesh Mesh to be simplified
+ * @param numberOfTriangles the number of polygons the returned mesh should have
+ * @param useOptimalPositioning enables/disables calculation of optimal positioning for vertices
+ * @param maxAngle maximum angle a face may rotate per merge step (value is arccos of angle [-1, 1]; -1 disables the test)
+ * @param weights weights for all attributes using indices defined above
+ * @param partitionCount number of partitions that are simplified in parallel; 0 uses the number of hardware threads
+ * @param maxError if not null, receives the square root of the largest quadric error of an applied collapse,
+ *   divided by the vertex weight. Without attribute weights, this is an estimate of the largest distance
+ *   between the simplified and the original surface.
+ * @return new simplified mesh, null if simplification failed
+ */
+Mesh * simplifyMeshParallel(Mesh * mesh,
+							uint32_t numberOfTriangles,
+							bool useOptimalPositioning,
+							float maxAngle,
+							const weights_t & weights,
+							uint32_t partitionCount = 0,
+							float * maxError = nullptr);
+
 }
 }
 }
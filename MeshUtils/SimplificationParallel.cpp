@@ -0,0 +1,728 @@
+/*
+ This file is part of the Rendering library.
+ Copyright (C) 2026 agent <agent@local>
+
+ This library is subject to the terms of the Mozilla Public License, v. 2.0.
+ You should have received a copy of the MPL along with this library; see the
+ file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "Simplification.h"
+#include "MeshUtils.h"
+#include "ParallelFor.h"
+#include "../Mesh/Mesh.h"
+#include "../Mesh/MeshIndexData.h"
+#include "../Mesh/MeshVertexData.h"
+#include "../Mesh/VertexAttributeAccessors.h"
+#include "../Mesh/VertexAttributeIds.h"
+#include <Geometry/Vec2.h>
+#include <Geometry/Vec3.h>
+#include <Util/Graphics/Color.h>
+#include <Util/Macros.h>
+#include <Util/References.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+namespace Rendering {
+namespace MeshUtils {
+namespace Simplification {
+
+//! Partitions are only split if both halves get at least this number of triangles.
+static const uint32_t MIN_PARTITION_TRIANGLES = 4096;
+static const uint32_t NO_PARTITION = std::numeric_limits<uint32_t>::max();
+static const uint32_t BORDER = NO_PARTITION - 1;
+
+/**
+ * (internal) Quadric Q(v) = v^T A v + 2 b^T v + c of fixed dimension N.
+ * Only the upper triangle of the symmetric matrix A is stored (row by row).
+ */
+template<uint32_t N>
+struct FixedQuadric {
+	static const uint32_t MATRIX_SIZE = N * (N + 1) / 2;
+	float a[MATRIX_SIZE];
+	float b[N];
+	float c;
+
+	void clear() {
+		std::fill_n(a, MATRIX_SIZE, 0.0f);
+		std::fill_n(b, N, 0.0f);
+		c = 0.0f;
+	}
+
+	void add(const FixedQuadric & other) {
+		for(uint32_t i = 0; i < MATRIX_SIZE; ++i)
+			a[i] += other.a[i];
+		for(uint32_t i = 0; i < N; ++i)
+			b[i] += other.b[i];
+		c += other.c;
+	}
+
+	/**
+	 * Set the quadric to the squared distance to the plane spanned by p, q and r in the first @p dims
+	 * dimensions (Garland and Heckbert: Simplifying surfaces with color and texture using quadric error metrics, 1998).
+	 * The remaining dimensions are ignored.
+	 */
+	void setPlane(const float * p, const float * q, const float * r, uint32_t dims) {
+		double e1[N], e2[N];
+		double length1 = 0.0;
+		for(uint32_t i = 0; i < dims; ++i) {
+			e1[i] = q[i] - p[i];
+			length1 += e1[i] * e1[i];
+		}
+		length1 = std::sqrt(length1);
+		double r_p_e1 = 0.0;
+		for(uint32_t i = 0; i < dims; ++i) {
+			e1[i] = length1 > 0.0 ? e1[i] / length1 : 0.0;
+			r_p_e1 += (r[i] - p[i]) * e1[i];
+		}
+		double length2 = 0.0;
+		for(uint32_t i = 0; i < dims; ++i) {
+			e2[i] = r[i] - p[i] - r_p_e1 * e1[i];
+			length2 += e2[i] * e2[i];
+		}
+		length2 = std::sqrt(length2);
+		double p_e1 = 0.0, p_e2 = 0.0, p_p = 0.0;
+		for(uint32_t i = 0; i < dims; ++i) {
+			e2[i] = length2 > 0.0 ? e2[i] / length2 : 0.0;
+			p_e1 += p[i] * e1[i];
+			p_e2 += p[i] * e2[i];
+			p_p += p[i] * p[i];
+		}
+		clear();
+		// A = I - e1 e1^T - e2 e2^T
+		for(uint32_t i = 0, k = 0; i < N; ++i) {
+			for(uint32_t j = i; j < N; ++j, ++k) {
+				if(j < dims)
+					a[k] = static_cast<float>((i == j ? 1.0 : 0.0) - e1[i] * e1[j] - e2[i] * e2[j]);
+			}
+		}
+		// b = (p * e1) e1 + (p * e2) e2 - p
+		for(uint32_t i = 0; i < dims; ++i)
+			b[i] = static_cast<float>(p_e1 * e1[i] + p_e2 * e2[i] - p[i]);
+		// c = p * p - (p * e1)^2 - (p * e2)^2
+		c = static_cast<float>(p_p - p_e1 * p_e1 - p_e2 * p_e2);
+	}
+
+	double evaluate(const double * v) const {
+		double result = c;
+		for(uint32_t i = 0, k = 0; i < N; ++i) {
+			double row = 0.5 * a[k++] * v[i];
+			for(uint32_t j = i + 1; j < N; ++j)
+				row += a[k++] * v[j];
+			result += 2.0 * v[i] * (row + b[i]);
+		}
+		return result;
+	}
+
+	//! Solve A x = -b with Gaussian elimination; returns false if A is (nearly) singular.
+	bool solve(double * x) const {
+		double m[N][N + 1];
+		double maxDiagonal = 0.0;
+		for(uint32_t i = 0, k = 0; i < N; ++i) {
+			for(uint32_t j = i; j < N; ++j, ++k)
+				m[i][j] = m[j][i] = a[k];
+			m[i][N] = -b[i];
+			maxDiagonal = std::max(maxDiagonal, std::abs(m[i][i]));
+		}
+		const double epsilon = 1.0e-6 * maxDiagonal;
+		if(epsilon == 0.0)
+			return false;
+		for(uint32_t col = 0; col < N; ++col) {
+			uint32_t pivot = col;
+			for(uint32_t row = col + 1; row < N; ++row) {
+				if(std::abs(m[row][col]) > std::abs(m[pivot][col]))
+					pivot = row;
+			}
+			if(std::abs(m[pivot][col]) < epsilon)
+				return false;
+			if(pivot != col) {
+				for(uint32_t j = col; j <= N; ++j)
+					std::swap(m[col][j], m[pivot][j]);
+			}
+			for(uint32_t row = col + 1; row < N; ++row) {
+				const double factor = m[row][col] / m[col][col];
+				for(uint32_t j = col; j <= N; ++j)
+					m[row][j] -= factor * m[col][j];
+			}
+		}
+		for(uint32_t i = N; i-- > 0;) {
+			double sum = m[i][N];
+			for(uint32_t j = i + 1; j < N; ++j)
+				sum -= m[i][j] * x[j];
+			x[i] = sum / m[i][i];
+			if(!std::isfinite(x[i]))
+				return false;
+		}
+		return true;
+	}
+};
+
+//! (internal) Normal of the triangle given by the first three values of the vertices; zero if degenerated.
+static Geometry::Vec3 calcNormal(const float * a, const float * b, const float * c) {
+	const Geometry::Vec3 direction = (Geometry::Vec3(b) - Geometry::Vec3(a)).cross(Geometry::Vec3(c) - Geometry::Vec3(a));
+	const float length = direction.length();
+	if(length < 1.0e-6f)
+		return Geometry::Vec3();
+	return direction / length;
+}
+
+/**
+ * (internal) Edge collapse simplification of the triangles given by flat index and vertex data arrays.
+ * @tparam N number of (weighted) values per vertex
+ */
+template<uint32_t N>
+class QuadricSimplifier {
+	public:
+		//! N weighted values per vertex; the first three are the position.
+		std::vector<float> data;
+		//! Three vertex indices per triangle.
+		std::vector<uint32_t> indices;
+		//! Locked vertices are not changed (e.g. vertices on the border of a partition).
+		std::vector<uint8_t> locked;
+		//! Vertices whose values have been replaced by a collapse.
+		std::vector<uint8_t> changed;
+
+		QuadricSimplifier(std::vector<float> && _data, std::vector<uint32_t> && _indices, bool _useOptimalPositioning, float _maxAngle) :
+				data(std::move(_data)), indices(std::move(_indices)), locked(data.size() / N, 0), changed(data.size() / N, 0), quadrics(data.size() / N),
+				remap(data.size() / N), localIndex(data.size() / N, 0), useOptimalPositioning(_useOptimalPositioning), maxAngle(_maxAngle) {
+			std::iota(remap.begin(), remap.end(), 0);
+		}
+
+		/*! Initialize the quadrics of all vertices with the planes of their triangles and, if @p preserveBoundary
+			is set, the boundary constraint planes (as simplifyMesh() does for a non-zero boundary weight). */
+		void initQuadrics(bool preserveBoundary);
+
+		/**
+		 * Collapse edges between unlocked vertices of the given triangles until at most @p targetCount triangles remain
+		 * or no edge can be collapsed. Degenerated triangles are removed from @p triangles.
+		 * Only the given triangles and their unlocked vertices are changed, so disjoint sets of triangles that share
+		 * only locked vertices can be simplified concurrently.
+		 * @param parallel compute the collapse costs with multiple threads
+		 * @return the largest cost of the applied collapses
+		 */
+		float simplify(std::vector<uint32_t> & triangles, uint32_t targetCount, bool parallel);
+
+	private:
+		std::vector<FixedQuadric<N>> quadrics;
+		//! Vertex into which a vertex has been collapsed in the current pass (identity otherwise).
+		std::vector<uint32_t> remap;
+		//! Index of a vertex in the vertex list of the current pass.
+		std::vector<uint32_t> localIndex;
+		const bool useOptimalPositioning;
+		const float maxAngle;
+
+		const float * getData(uint32_t vertex) const	{	return data.data() + static_cast<size_t>(vertex) * N;	}
+
+		//! Return the cost of collapsing the edge and store the resulting vertex values in @p result.
+		float computeCollapse(uint32_t v0, uint32_t v1, float * result) const;
+
+		//! Return true if a triangle of @p vertex (except the ones containing @p other) rotates too much when moving @p vertex to @p position.
+		bool rotatesTriangle(uint32_t vertex, uint32_t other, const float * position, const uint32_t * triangles, uint32_t triangleCount) const;
+};
+
+template<uint32_t N>
+void QuadricSimplifier<N>::initQuadrics(bool preserveBoundary) {
+	const uint32_t vertexCount = static_cast<uint32_t>(quadrics.size());
+	const uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3);
+	std::vector<uint32_t> offsets(vertexCount + 1, 0);
+	for(const auto index : indices)
+		++offsets[index + 1];
+	std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+	std::vector<uint32_t> vertexTriangles(offsets.back());
+	{
+		std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+		for(uint32_t t = 0; t < triangleCount; ++t) {
+			for(uint_fast8_t k = 0; k < 3; ++k)
+				vertexTriangles[cursor[indices[3 * t + k]]++] = t;
+		}
+	}
+	// Every vertex sums up the quadrics of its triangles; this computes every triangle quadric three times but needs no synchronization.
+	parallelFor(vertexCount, 4096, [&](uint32_t begin, uint32_t end) {
+		FixedQuadric<N> tmpQ;
+		std::vector<uint32_t> otherVertices;
+		for(uint32_t v = begin; v < end; ++v) {
+			FixedQuadric<N> & q = quadrics[v];
+			q.clear();
+			otherVertices.clear();
+			for(uint32_t i = offsets[v]; i < offsets[v + 1]; ++i) {
+				const uint32_t * triangle = indices.data() + 3 * vertexTriangles[i];
+				tmpQ.setPlane(getData(triangle[0]), getData(triangle[1]), getData(triangle[2]), N);
+				q.add(tmpQ);
+				for(uint_fast8_t k = 0; k < 3; ++k) {
+					if(triangle[k] != v)
+						otherVertices.push_back(triangle[k]);
+				}
+			}
+			if(!preserveBoundary)
+				continue;
+			// An edge to a vertex that appears in only one triangle of v is a boundary edge.
+			std::sort(otherVertices.begin(), otherVertices.end());
+			for(uint32_t i = offsets[v]; i < offsets[v + 1]; ++i) {
+				const uint32_t * triangle = indices.data() + 3 * vertexTriangles[i];
+				for(uint_fast8_t k = 0; k < 3; ++k) {
+					const uint32_t other = triangle[k];
+					if(other == v)
+						continue;
+					const auto range = std::equal_range(otherVertices.begin(), otherVertices.end(), other);
+					if(std::distance(range.first, range.second) != 1)
+						continue;
+					// The constraint plane contains the edge and is perpendicular to the triangle.
+					const Geometry::Vec3 normal = calcNormal(getData(triangle[0]), getData(triangle[1]), getData(triangle[2]));
+					if(normal.isZero())
+						continue;
+					const float * p = getData(v);
+					const float r[3] = {p[0] + normal.getX(), p[1] + normal.getY(), p[2] + normal.getZ()};
+					tmpQ.setPlane(p, getData(other), r, 3);
+					q.add(tmpQ);
+				}
+			}
+		}
+	});
+}
+
+template<uint32_t N>
+float QuadricSimplifier<N>::computeCollapse(uint32_t v0, uint32_t v1, float * result) const {
+	FixedQuadric<N> q = quadrics[v0];
+	q.add(quadrics[v1]);
+	const float * d0 = getData(v0);
+	const float * d1 = getData(v1);
+	double x[N];
+	if(useOptimalPositioning && q.solve(x)) {
+		// Nearly singular systems may result in positions far away from the edge.
+		double distanceSquared = 0.0, edgeLengthSquared = 0.0;
+		for(uint32_t i = 0; i < N; ++i) {
+			const double center = 0.5 * (static_cast<double>(d0[i]) + d1[i]);
+			distanceSquared += (x[i] - center) * (x[i] - center);
+			edgeLengthSquared += (static_cast<double>(d1[i]) - d0[i]) * (static_cast<double>(d1[i]) - d0[i]);
+		}
+		if(distanceSquared <= edgeLengthSquared) {
+			std::copy(x, x + N, result);
+			return static_cast<float>(std::max(0.0, q.evaluate(x)));
+		}
+	}
+	// use the best position of v0, v1 and (v0+v1)/2
+	double x0[N], x1[N], xCenter[N];
+	for(uint32_t i = 0; i < N; ++i) {
+		x0[i] = d0[i];
+		x1[i] = d1[i];
+		xCenter[i] = 0.5 * (x0[i] + x1[i]);
+	}
+	const double cost0 = q.evaluate(x0);
+	const double cost1 = q.evaluate(x1);
+	const double costCenter = q.evaluate(xCenter);
+	if(cost0 < cost1 && cost0 < costCenter) {
+		std::copy(d0, d0 + N, result);
+		return static_cast<float>(std::max(0.0, cost0));
+	} else if(cost1 < cost0 && cost1 < costCenter) {
+		std::copy(d1, d1 + N, result);
+		return static_cast<float>(std::max(0.0, cost1));
+	}
+	std::copy(xCenter, xCenter + N, result);
+	return static_cast<float>(std::max(0.0, costCenter));
+}
+
+template<uint32_t N>
+bool QuadricSimplifier<N>::rotatesTriangle(uint32_t vertex, uint32_t other, const float * position, const uint32_t * triangles, uint32_t triangleCount) const {
+	for(uint32_t i = 0; i < triangleCount; ++i) {
+		const uint32_t * triangle = indices.data() + 3 * triangles[i];
+		const uint32_t corners[3] = {remap[triangle[0]], remap[triangle[1]], remap[triangle[2]]};
+		if(corners[0] == corners[1] || corners[1] == corners[2] || corners[0] == corners[2])
+			continue; // already removed
+		if(corners[0] == other || corners[1] == other || corners[2] == other)
+			continue; // will be removed
+		const Geometry::Vec3 normalBefore = calcNormal(getData(corners[0]), getData(corners[1]), getData(corners[2]));
+		const Geometry::Vec3 normalAfter = calcNormal(corners[0] == vertex ? position : getData(corners[0]),
+													  corners[1] == vertex ? position : getData(corners[1]),
+													  corners[2] == vertex ? position : getData(corners[2]));
+		if(normalBefore.isZero() || normalAfter.isZero() || normalBefore.dot(normalAfter) < maxAngle)
+			return true;
+	}
+	return false;
+}
+
+template<uint32_t N>
+float QuadricSimplifier<N>::simplify(std::vector<uint32_t> & triangles, uint32_t targetCount, bool parallel) {
+	float maxCost = 0.0f;
+	std::vector<uint32_t> vertices;
+	std::vector<uint32_t> offsets;
+	std::vector<uint32_t> vertexTriangles;
+	std::vector<uint64_t> edges;
+	std::vector<float> costs;
+	std::vector<float> positions;
+	std::vector<uint32_t> order;
+	std::vector<uint8_t> collapsed;
+	while(triangles.size() > targetCount) {
+		// unlocked vertices and their triangles (compressed row storage)
+		vertices.clear();
+		edges.clear();
+		for(const auto t : triangles) {
+			const uint32_t * triangle = indices.data() + 3 * t;
+			for(uint_fast8_t k = 0; k < 3; ++k) {
+				const uint32_t a = triangle[k];
+				const uint32_t b = triangle[(k + 1) % 3];
+				if(!locked[a]) {
+					vertices.push_back(a);
+					if(!locked[b])
+						edges.push_back(a < b ? (static_cast<uint64_t>(a) << 32 | b) : (static_cast<uint64_t>(b) << 32 | a));
+				}
+			}
+		}
+		std::sort(edges.begin(), edges.end());
+		edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+		if(edges.empty())
+			break;
+		std::sort(vertices.begin(), vertices.end());
+		vertices.erase(std::unique(vertices.begin(), vertices.end()), vertices.end());
+		for(uint32_t i = 0; i < vertices.size(); ++i)
+			localIndex[vertices[i]] = i;
+		offsets.assign(vertices.size() + 1, 0);
+		for(const auto t : triangles) {
+			for(uint_fast8_t k = 0; k < 3; ++k) {
+				const uint32_t v = indices[3 * t + k];
+				if(!locked[v])
+					++offsets[localIndex[v] + 1];
+			}
+		}
+		std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+		vertexTriangles.resize(offsets.back());
+		{
+			std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+			for(const auto t : triangles) {
+				for(uint_fast8_t k = 0; k < 3; ++k) {
+					const uint32_t v = indices[3 * t + k];
+					if(!locked[v])
+						vertexTriangles[cursor[localIndex[v]]++] = t;
+				}
+			}
+		}
+
+		// costs of all edges
+		const uint32_t edgeCount = static_cast<uint32_t>(edges.size());
+		costs.resize(edgeCount);
+		positions.resize(static_cast<size_t>(edgeCount) * N);
+		const auto computeCosts = [&](uint32_t begin, uint32_t end) {
+			for(uint32_t e = begin; e < end; ++e)
+				costs[e] = computeCollapse(static_cast<uint32_t>(edges[e] >> 32), static_cast<uint32_t>(edges[e]), positions.data() + static_cast<size_t>(e) * N);
+		};
+		if(parallel)
+			parallelFor(edgeCount, 1024, computeCosts);
+		else
+			computeCosts(0, edgeCount);
+		order.resize(edgeCount);
+		std::iota(order.begin(), order.end(), 0);
+		std::sort(order.begin(), order.end(), [&](uint32_t e1, uint32_t e2) {
+			return costs[e1] < costs[e2] || (costs[e1] == costs[e2] && e1 < e2);
+		});
+
+		/* Every collapse removes about two triangles. As each vertex may only be changed once per pass, not all of
+			the cheapest collapses can be applied; limit the cost to avoid collapsing expensive edges early. */
+		const size_t goal = std::min<size_t>(edgeCount - 1, (triangles.size() - targetCount) / 2);
+		const float errorLimit = costs[order[goal]] * 1.5f;
+
+		collapsed.assign(vertices.size(), 0);
+		size_t triangleCount = triangles.size();
+		uint32_t collapseCount = 0;
+		for(const auto e : order) {
+			if(triangleCount <= targetCount || costs[e] > errorLimit)
+				break;
+			const uint32_t v0 = static_cast<uint32_t>(edges[e] >> 32);
+			const uint32_t v1 = static_cast<uint32_t>(edges[e]);
+			const uint32_t l0 = localIndex[v0];
+			const uint32_t l1 = localIndex[v1];
+			if(collapsed[l0] || collapsed[l1])
+				continue;
+			const float * position = positions.data() + static_cast<size_t>(e) * N;
+			if(maxAngle != -1 && (rotatesTriangle(v0, v1, position, vertexTriangles.data() + offsets[l0], offsets[l0 + 1] - offsets[l0])
+					|| rotatesTriangle(v1, v0, position, vertexTriangles.data() + offsets[l1], offsets[l1 + 1] - offsets[l1])))
+				continue;
+			// count the triangles that contain both vertices
+			for(uint32_t i = offsets[l1]; i < offsets[l1 + 1]; ++i) {
+				const uint32_t * triangle = indices.data() + 3 * vertexTriangles[i];
+				const uint32_t corners[3] = {remap[triangle[0]], remap[triangle[1]], remap[triangle[2]]};
+				if(corners[0] != corners[1] && corners[1] != corners[2] && corners[0] != corners[2]
+						&& (corners[0] == v0 || corners[1] == v0 || corners[2] == v0))
+					--triangleCount;
+			}
+			// merge v1 into v0
+			std::copy(position, position + N, data.begin() + static_cast<size_t>(v0) * N);
+			changed[v0] = 1;
+			quadrics[v0].add(quadrics[v1]);
+			remap[v1] = v0;
+			collapsed[l0] = collapsed[l1] = 1;
+			maxCost = std::max(maxCost, costs[e]);
+			++collapseCount;
+		}
+
+		// apply the collapses to the index data and remove degenerated triangles
+		auto newEnd = std::remove_if(triangles.begin(), triangles.end(), [&](uint32_t t) {
+			uint32_t * triangle = indices.data() + 3 * t;
+			for(uint_fast8_t k = 0; k < 3; ++k)
+				triangle[k] = remap[triangle[k]];
+			return triangle[0] == triangle[1] || triangle[1] == triangle[2] || triangle[0] == triangle[2];
+		});
+		triangles.erase(newEnd, triangles.end());
+		if(collapseCount == 0)
+			break;
+	}
+	return maxCost;
+}
+
+/**
+ * (internal) Split the triangles into at most @p partitionCount spatially coherent partitions
+ * by recursively splitting at the median of the triangle centers along the longest axis.
+ */
+static std::vector<std::vector<uint32_t>> createPartitions(const std::vector<float> & data, uint32_t dimension,
+															const std::vector<uint32_t> & indices, uint32_t partitionCount) {
+	const uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3);
+	std::vector<float> centers(3 * static_cast<size_t>(triangleCount));
+	for(uint32_t t = 0; t < triangleCount; ++t) {
+		for(uint_fast8_t axis = 0; axis < 3; ++axis) {
+			centers[3 * t + axis] = (data[indices[3 * t] * dimension + axis] + data[indices[3 * t + 1] * dimension + axis]
+									+ data[indices[3 * t + 2] * dimension + axis]) / 3.0f;
+		}
+	}
+	std::vector<std::vector<uint32_t>> partitions(1, std::vector<uint32_t>(triangleCount));
+	std::iota(partitions.front().begin(), partitions.front().end(), 0);
+	while(partitions.size() < partitionCount) {
+		std::vector<std::vector<uint32_t>> splitPartitions;
+		for(size_t i = 0; i < partitions.size(); ++i) {
+			auto & partition = partitions[i];
+			// splitting adds one partition; the remaining ones are added unchanged or split themselves
+			const size_t remaining = partitions.size() - i - 1;
+			if(partition.size() < 2 * MIN_PARTITION_TRIANGLES || splitPartitions.size() + 2 + remaining > partitionCount) {
+				splitPartitions.emplace_back(std::move(partition));
+				continue;
+			}
+			float minValues[3] = {std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max()};
+			float maxValues[3] = {std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest()};
+			for(const auto t : partition) {
+				for(uint_fast8_t axis = 0; axis < 3; ++axis) {
+					minValues[axis] = std::min(minValues[axis], centers[3 * t + axis]);
+					maxValues[axis] = std::max(maxValues[axis], centers[3 * t + axis]);
+				}
+			}
+			uint_fast8_t splitAxis = 0;
+			for(uint_fast8_t axis = 1; axis < 3; ++axis) {
+				if(maxValues[axis] - minValues[axis] > maxValues[splitAxis] - minValues[splitAxis])
+					splitAxis = axis;
+			}
+			const auto median = partition.begin() + partition.size() / 2;
+			std::nth_element(partition.begin(), median, partition.end(), [&](uint32_t t1, uint32_t t2) {
+				return centers[3 * t1 + splitAxis] < centers[3 * t2 + splitAxis];
+			});
+			splitPartitions.emplace_back(partition.begin(), median);
+			splitPartitions.emplace_back(median, partition.end());
+		}
+		if(splitPartitions.size() == partitions.size())
+			break;
+		partitions.swap(splitPartitions);
+	}
+	return partitions;
+}
+
+/*! @param changed is set to the flags of the vertices whose values have been changed
+	@return the largest cost of the applied collapses */
+template<uint32_t N>
+static float simplifyData(std::vector<float> & data, std::vector<uint32_t> & indices, std::vector<uint8_t> & changed, uint32_t numberOfTriangles,
+						 bool useOptimalPositioning, float maxAngle, bool preserveBoundary, uint32_t partitionCount) {
+	QuadricSimplifier<N> simplifier(std::move(data), std::move(indices), useOptimalPositioning, maxAngle);
+	simplifier.initQuadrics(preserveBoundary);
+	const uint32_t triangleCount = static_cast<uint32_t>(simplifier.indices.size() / 3);
+
+	std::vector<std::vector<uint32_t>> partitions = createPartitions(simplifier.data, N, simplifier.indices, partitionCount);
+	float maxCost = 0.0f;
+	if(partitions.size() > 1) {
+		// lock the vertices that are used by more than one partition
+		std::vector<uint32_t> owner(simplifier.locked.size(), NO_PARTITION);
+		for(uint32_t p = 0; p < partitions.size(); ++p) {
+			for(const auto t : partitions[p]) {
+				for(uint_fast8_t k = 0; k < 3; ++k) {
+					uint32_t & vertexOwner = owner[simplifier.indices[3 * t + k]];
+					vertexOwner = (vertexOwner == NO_PARTITION || vertexOwner == p) ? p : BORDER;
+				}
+			}
+		}
+		for(uint32_t v = 0; v < owner.size(); ++v)
+			simplifier.locked[v] = owner[v] == BORDER ? 1 : 0;
+		std::vector<float> partitionCosts(partitions.size(), 0.0f);
+		parallelFor(static_cast<uint32_t>(partitions.size()), 1, [&](uint32_t begin, uint32_t end) {
+			for(uint32_t p = begin; p < end; ++p) {
+				const uint32_t target = static_cast<uint32_t>(static_cast<uint64_t>(partitions[p].size()) * numberOfTriangles / triangleCount);
+				partitionCosts[p] = simplifier.simplify(partitions[p], target, false);
+			}
+		});
+		maxCost = *std::max_element(partitionCosts.begin(), partitionCosts.end());
+		for(uint32_t p = 1; p < partitions.size(); ++p)
+			partitions.front().insert(partitions.front().end(), partitions[p].begin(), partitions[p].end());
+		partitions.resize(1);
+		std::fill(simplifier.locked.begin(), simplifier.locked.end(), 0);
+	}
+	// final pass over the whole mesh (including the borders of the partitions)
+	std::vector<uint32_t> & triangles = partitions.front();
+	maxCost = std::max(maxCost, simplifier.simplify(triangles, numberOfTriangles, true));
+	if(triangles.size() > numberOfTriangles)
+		WARN("Could not merge any more due to constraints.");
+
+	indices.clear();
+	indices.reserve(3 * triangles.size());
+	std::sort(triangles.begin(), triangles.end());
+	for(const auto t : triangles)
+		indices.insert(indices.end(), simplifier.indices.begin() + 3 * t, simplifier.indices.begin() + 3 * t + 3);
+	data = std::move(simplifier.data);
+	changed = std::move(simplifier.changed);
+	return maxCost;
+}
+
+Mesh * simplifyMeshParallel(Mesh * mesh, uint32_t numberOfTriangles, bool useOptimalPositioning, float maxAngle, const weights_t & weights,
+							uint32_t partitionCount, float * maxError) {
+	if(maxError != nullptr)
+		*maxError = 0.0f;
+	if(mesh->getDrawMode() != Mesh::DRAW_TRIANGLES) {
+		WARN("Mesh simplification can only be done with triangle meshes.");
+		return nullptr;
+	}
+	if(weights[VERTEX_OFFSET] <= 0) {
+		WARN("Mesh simplification needs a positive vertex weight.");
+		return nullptr;
+	}
+	if(mesh->getPrimitiveCount() <= numberOfTriangles) {
+		WARN("Mesh already has less or equal as many triangles as requested.");
+		return mesh->clone();
+	}
+	MeshVertexData vertexData(mesh->openVertexData());
+	Util::Reference<PositionAttributeAccessor> positionAccessor;
+	try {
+		positionAccessor = PositionAttributeAccessor::create(vertexData, VertexAttributeIds::POSITION);
+	} catch(...) {
+		WARN("Vertex data does not contain readable positions.");
+		return nullptr;
+	}
+	uint32_t dimension = 3;
+	Util::Reference<NormalAttributeAccessor> normalAccessor;
+	if(weights[NORMAL_OFFSET] > 0) {
+		try {
+			normalAccessor = NormalAttributeAccessor::create(vertexData, VertexAttributeIds::NORMAL);
+			dimension += 3;
+		} catch(...) {
+		}
+	}
+	Util::Reference<ColorAttributeAccessor> colorAccessor;
+	if(weights[COLOR_OFFSET] > 0) {
+		try {
+			colorAccessor = ColorAttributeAccessor::create(vertexData, VertexAttributeIds::COLOR);
+			dimension += 4;
+		} catch(...) {
+		}
+	}
+	Util::Reference<TexCoordAttributeAccessor> texCoordAccessor;
+	if(weights[TEX0_OFFSET] > 0) {
+		try {
+			texCoordAccessor = TexCoordAttributeAccessor::create(vertexData, VertexAttributeIds::TEXCOORD0);
+			dimension += 2;
+		} catch(...) {
+		}
+	}
+
+	// weighted vertex data: VERTEX, NORMAL, COLOR, TEX0
+	const uint32_t vertexCount = vertexData.getVertexCount();
+	std::vector<float> data(static_cast<size_t>(vertexCount) * dimension);
+	parallelFor(vertexCount, 4096, [&](uint32_t begin, uint32_t end) {
+		for(uint32_t v = begin; v < end; ++v) {
+			float * values = data.data() + static_cast<size_t>(v) * dimension;
+			const Geometry::Vec3 position = positionAccessor->getPosition(v) * weights[VERTEX_OFFSET];
+			*values++ = position.getX();
+			*values++ = position.getY();
+			*values++ = position.getZ();
+			if(normalAccessor.isNotNull()) {
+				const Geometry::Vec3 normal = normalAccessor->getNormal(v) * weights[NORMAL_OFFSET];
+				*values++ = normal.getX();
+				*values++ = normal.getY();
+				*values++ = normal.getZ();
+			}
+			if(colorAccessor.isNotNull()) {
+				const Util::Color4f color = colorAccessor->getColor4f(v);
+				*values++ = color.getR() * weights[COLOR_OFFSET];
+				*values++ = color.getG() * weights[COLOR_OFFSET];
+				*values++ = color.getB() * weights[COLOR_OFFSET];
+				*values++ = color.getA() * weights[COLOR_OFFSET];
+			}
+			if(texCoordAccessor.isNotNull()) {
+				const Geometry::Vec2 texCoord = texCoordAccessor->getCoordinate(v);
+				*values++ = texCoord.getX() * weights[TEX0_OFFSET];
+				*values++ = texCoord.getY() * weights[TEX0_OFFSET];
+			}
+		}
+	});
+
+	// copy the triangles, skipping degenerated ones
+	std::vector<uint32_t> indices;
+	{
+		const MeshIndexData & iData = mesh->openIndexData();
+		indices.reserve(iData.getIndexCount());
+		for(uint32_t i = 0; i + 2 < iData.getIndexCount(); i += 3) {
+			if(iData[i] != iData[i + 1] && iData[i + 1] != iData[i + 2] && iData[i] != iData[i + 2])
+				indices.insert(indices.end(), {iData[i], iData[i + 1], iData[i + 2]});
+		}
+	}
+
+	if(partitionCount == 0)
+		partitionCount = std::max(1u, std::thread::hardware_concurrency());
+	const bool preserveBoundary = weights[BOUNDARY_OFFSET] != 0.0f;
+	std::vector<uint8_t> changed;
+	float maxCost = 0.0f;
+	switch(dimension) {
+		case 3: maxCost = simplifyData<3>(data, indices, changed, numberOfTriangles, useOptimalPositioning, maxAngle, preserveBoundary, partitionCount); break;
+		case 5: maxCost = simplifyData<5>(data, indices, changed, numberOfTriangles, useOptimalPositioning, maxAngle, preserveBoundary, partitionCount); break;
+		case 6: maxCost = simplifyData<6>(data, indices, changed, numberOfTriangles, useOptimalPositioning, maxAngle, preserveBoundary, partitionCount); break;
+		case 7: maxCost = simplifyData<7>(data, indices, changed, numberOfTriangles, useOptimalPositioning, maxAngle, preserveBoundary, partitionCount); break;
+		case 8: maxCost = simplifyData<8>(data, indices, changed, numberOfTriangles, useOptimalPositioning, maxAngle, preserveBoundary, partitionCount); break;
+		case 9: maxCost = simplifyData<9>(data, indices, changed, numberOfTriangles, useOptimalPositioning, maxAngle, preserveBoundary, partitionCount); break;
+		case 10: maxCost = simplifyData<10>(data, indices, changed, numberOfTriangles, useOptimalPositioning, maxAngle, preserveBoundary, partitionCount); break;
+		case 12: maxCost = simplifyData<12>(data, indices, changed, numberOfTriangles, useOptimalPositioning, maxAngle, preserveBoundary, partitionCount); break;
+		default:
+			WARN("Unsupported vertex dimension.");
+			return nullptr;
+	}
+	if(maxError != nullptr)
+		*maxError = std::sqrt(maxCost) / weights[VERTEX_OFFSET];
+
+	/* write the vertex data of the changed vertices; the other ones are kept bit-identical, so that they can be
+		shared with the original mesh (e.g. by MeshUtils::packLODChain) */
+	for(uint32_t v = 0; v < vertexCount; ++v) {
+		if(!changed[v])
+			continue;
+		const float * values = data.data() + static_cast<size_t>(v) * dimension;
+		positionAccessor->setPosition(v, Geometry::Vec3(values[0], values[1], values[2]) / weights[VERTEX_OFFSET]);
+		values += 3;
+		if(normalAccessor.isNotNull()) {
+			Geometry::Vec3 normal(values[0], values[1], values[2]);
+			const float length = normal.length();
+			if(length > 1.0e-6f)
+				normal /= length;
+			normalAccessor->setNormal(v, normal);
+			values += 3;
+		}
+		if(colorAccessor.isNotNull()) {
+			colorAccessor->setColor(v, Util::Color4f(values[0], values[1], values[2], values[3]) / weights[COLOR_OFFSET]);
+			values += 4;
+		}
+		if(texCoordAccessor.isNotNull())
+			texCoordAccessor->setCoordinate(v, Geometry::Vec2(values[0], values[1]) / weights[TEX0_OFFSET]);
+	}
+	vertexData.updateBoundingBox();
+
+	MeshIndexData indexData;
+	indexData.allocate(static_cast<uint32_t>(indices.size()));
+	std::copy(indices.begin(), indices.end(), indexData.data());
+	indexData.updateIndexRange();
+
+	Util::Reference<Mesh> newMesh = new Mesh(std::move(indexData), std::move(vertexData));
+	return MeshUtils::eliminateUnusedVertices(newMesh.get());
+}
+
+}
+}
+}
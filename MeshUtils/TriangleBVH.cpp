@@ -0,0 +1,475 @@
+/*
+ This file is part of the Rendering library.
+ Copyright (C) 2026 agent <agent@local>
+
+ This library is subject to the terms of the Mozilla Public License, v. 2.0.
+ You should have received a copy of the MPL along with this library; see the
+ file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "TriangleBVH.h"
+#include "ParallelFor.h"
+
+#include "../Mesh/Mesh.h"
+#include "../Mesh/MeshIndexData.h"
+#include "../Mesh/MeshVertexData.h"
+#include "../Mesh/VertexAttributeAccessors.h"
+#include "../Mesh/VertexAttributeIds.h"
+
+#include <Geometry/Ray.h>
+#include <Util/Macros.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <numeric>
+#include <ostream>
+#include <stdexcept>
+
+namespace Rendering {
+namespace MeshUtils {
+
+static const uint32_t BIN_COUNT = 12;
+static const uint32_t MAX_LEAF_SIZE = 8;
+static const uint32_t MAX_DEPTH = 64;
+static const char FILE_MAGIC[4] = {'B', 'V', 'H', '1'};
+
+//! (internal) Axis-aligned box used during construction.
+struct BuildBox {
+	float min[3];
+	float max[3];
+	BuildBox() {
+		std::fill(min, min + 3, std::numeric_limits<float>::max());
+		std::fill(max, max + 3, std::numeric_limits<float>::lowest());
+	}
+	void include(const float * p) {
+		for(uint32_t a = 0; a < 3; ++a) {
+			min[a] = std::min(min[a], p[a]);
+			max[a] = std::max(max[a], p[a]);
+		}
+	}
+	void include(const BuildBox & box) {
+		for(uint32_t a = 0; a < 3; ++a) {
+			min[a] = std::min(min[a], box.min[a]);
+			max[a] = std::max(max[a], box.max[a]);
+		}
+	}
+	//! Half of the surface area
+	float getHalfArea() const {
+		if(min[0] > max[0])
+			return 0.0f;
+		const float dx = max[0] - min[0];
+		const float dy = max[1] - min[1];
+		const float dz = max[2] - min[2];
+		return dx * dy + dy * dz + dz * dx;
+	}
+};
+
+//! (internal) Ray with precomputed reciprocal direction.
+struct TraversalRay {
+	float origin[3];
+	float dir[3];
+	float invDir[3];
+	explicit TraversalRay(const Geometry::Ray3 & ray) {
+		const Geometry::Vec3 & o = ray.getOrigin();
+		const Geometry::Vec3 & d = ray.getDirection();
+		for(uint32_t a = 0; a < 3; ++a) {
+			origin[a] = o[a];
+			dir[a] = d[a];
+			// avoid 0 * inf = NaN in the slab test
+			invDir[a] = 1.0f / (d[a] != 0.0f ? d[a] : 1.0e-30f);
+		}
+	}
+};
+
+//! (internal) Slab test; returns the entry distance or infinity if the box is missed.
+static inline float intersectNode(const TriangleBVH::Node & node, const TraversalRay & ray, float maxDistance) {
+	float tNear = 0.0f;
+	float tFar = maxDistance;
+	for(uint32_t a = 0; a < 3; ++a) {
+		const float t0 = (node.min[a] - ray.origin[a]) * ray.invDir[a];
+		const float t1 = (node.max[a] - ray.origin[a]) * ray.invDir[a];
+		tNear = std::max(tNear, std::min(t0, t1));
+		tFar = std::min(tFar, std::max(t0, t1));
+	}
+	return tNear <= tFar ? tNear : std::numeric_limits<float>::infinity();
+}
+
+/*! (internal) Double sided Moeller-Trumbore test of the triangle stored at @p tri.
+	Returns true if the triangle is hit within [0, maxDistance]. */
+static inline bool intersectTriangle(const float * tri, const TraversalRay & ray, float maxDistance, float & t, float & u, float & v) {
+	const float * e1 = tri + 3;
+	const float * e2 = tri + 6;
+	const float p[3] = {	ray.dir[1] * e2[2] - ray.dir[2] * e2[1],
+							ray.dir[2] * e2[0] - ray.dir[0] * e2[2],
+							ray.dir[0] * e2[1] - ray.dir[1] * e2[0]};
+	const float det = e1[0] * p[0] + e1[1] * p[1] + e1[2] * p[2];
+	if(det == 0.0f)
+		return false;
+	const float invDet = 1.0f / det;
+	const float s[3] = {ray.origin[0] - tri[0], ray.origin[1] - tri[1], ray.origin[2] - tri[2]};
+	u = (s[0] * p[0] + s[1] * p[1] + s[2] * p[2]) * invDet;
+	if(u < 0.0f || u > 1.0f)
+		return false;
+	const float q[3] = {	s[1] * e1[2] - s[2] * e1[1],
+							s[2] * e1[0] - s[0] * e1[2],
+							s[0] * e1[1] - s[1] * e1[0]};
+	v = (ray.dir[0] * q[0] + ray.dir[1] * q[1] + ray.dir[2] * q[2]) * invDet;
+	if(v < 0.0f || u + v > 1.0f)
+		return false;
+	t = (e2[0] * q[0] + e2[1] * q[1] + e2[2] * q[2]) * invDet;
+	return t >= 0.0f && t <= maxDistance;
+}
+
+//! (internal) Replace @p hit if the new hit is closer (or equally close with lower triangle index).
+static inline void updateHit(TriangleBVH::Hit & hit, uint32_t triangle, float t, float u, float v) {
+	if(t < hit.distance || (t == hit.distance && static_cast<int32_t>(triangle) < hit.triangle)) {
+		hit.triangle = static_cast<int32_t>(triangle);
+		hit.distance = t;
+		hit.u = u;
+		hit.v = v;
+	}
+}
+
+// -----------------------------------------------------------------------------
+
+TriangleBVH::TriangleBVH() : vertexRevision(0), indexRevision(0) {
+}
+
+TriangleBVH::TriangleBVH(const std::vector<Geometry::Vec3> & positions, const uint32_t * indices, uint32_t triangleCount) :
+		vertexRevision(0), indexRevision(0) {
+	if(triangleCount == 0)
+		return;
+	auto getVertex = [&](uint32_t triangle, uint32_t corner) -> const Geometry::Vec3 & {
+		return positions[indices ? indices[3 * triangle + corner] : 3 * triangle + corner];
+	};
+
+	std::vector<BuildBox> bounds(triangleCount);
+	std::vector<float> centroids(3 * triangleCount);
+	for(uint32_t t = 0; t < triangleCount; ++t) {
+		for(uint32_t c = 0; c < 3; ++c) {
+			const Geometry::Vec3 & p = getVertex(t, c);
+			const float coordinates[3] = {p.x(), p.y(), p.z()};
+			bounds[t].include(coordinates);
+		}
+		for(uint32_t a = 0; a < 3; ++a)
+			centroids[3 * t + a] = 0.5f * (bounds[t].min[a] + bounds[t].max[a]);
+	}
+
+	std::vector<uint32_t> order(triangleCount);
+	std::iota(order.begin(), order.end(), 0);
+	nodes.reserve(2 * triangleCount);
+	nodes.emplace_back();
+
+	struct Task {
+		uint32_t node, begin, end, depth;
+	};
+	std::vector<Task> tasks;
+	tasks.push_back({0, 0, triangleCount, 0});
+	while(!tasks.empty()) {
+		const Task task = tasks.back();
+		tasks.pop_back();
+		const uint32_t count = task.end - task.begin;
+
+		BuildBox nodeBox, centroidBox;
+		for(uint32_t i = task.begin; i < task.end; ++i) {
+			nodeBox.include(bounds[order[i]]);
+			centroidBox.include(&centroids[3 * order[i]]);
+		}
+		Node & node = nodes[task.node];
+		std::copy(nodeBox.min, nodeBox.min + 3, node.min);
+		std::copy(nodeBox.max, nodeBox.max + 3, node.max);
+		node.first = task.begin;
+		node.triangleCount = count;
+		if(count <= 2 || task.depth + 1 >= MAX_DEPTH)
+			continue;
+
+		// find the best split plane on all axes using binned SAH
+		float bestCost = std::numeric_limits<float>::max();
+		uint32_t bestAxis = 0, bestSplit = 0;
+		for(uint32_t a = 0; a < 3; ++a) {
+			const float extent = centroidBox.max[a] - centroidBox.min[a];
+			if(extent <= 0.0f)
+				continue;
+			const float scale = BIN_COUNT / extent;
+			BuildBox binBoxes[BIN_COUNT];
+			uint32_t binCounts[BIN_COUNT] = {};
+			for(uint32_t i = task.begin; i < task.end; ++i) {
+				const uint32_t t = order[i];
+				const uint32_t bin = std::min(BIN_COUNT - 1, static_cast<uint32_t>((centroids[3 * t + a] - centroidBox.min[a]) * scale));
+				++binCounts[bin];
+				binBoxes[bin].include(bounds[t]);
+			}
+			float rightAreas[BIN_COUNT];
+			uint32_t rightCounts[BIN_COUNT];
+			BuildBox accumulated;
+			uint32_t accumulatedCount = 0;
+			for(uint32_t bin = BIN_COUNT - 1; bin > 0; --bin) {
+				accumulated.include(binBoxes[bin]);
+				accumulatedCount += binCounts[bin];
+				rightAreas[bin] = accumulated.getHalfArea();
+				rightCounts[bin] = accumulatedCount;
+			}
+			accumulated = BuildBox();
+			accumulatedCount = 0;
+			for(uint32_t split = 1; split < BIN_COUNT; ++split) {
+				accumulated.include(binBoxes[split - 1]);
+				accumulatedCount += binCounts[split - 1];
+				const float cost = accumulated.getHalfArea() * accumulatedCount + rightAreas[split] * rightCounts[split];
+				if(accumulatedCount > 0 && rightCounts[split] > 0 && cost < bestCost) {
+					bestCost = cost;
+					bestAxis = a;
+					bestSplit = split;
+				}
+			}
+		}
+		if(bestSplit == 0)
+			continue; // all centroids are equal
+		// cost of a leaf vs. traversal (relative to one triangle test) plus the children
+		const float parentArea = nodeBox.getHalfArea();
+		const float splitCost = 1.0f + (parentArea > 0.0f ? bestCost / parentArea : static_cast<float>(count));
+		if(count <= MAX_LEAF_SIZE && splitCost >= static_cast<float>(count))
+			continue;
+
+		const float scale = BIN_COUNT / (centroidBox.max[bestAxis] - centroidBox.min[bestAxis]);
+		const float splitMin = centroidBox.min[bestAxis];
+		auto middle = std::partition(order.begin() + task.begin, order.begin() + task.end, [&](uint32_t t) {
+			return std::min(BIN_COUNT - 1, static_cast<uint32_t>((centroids[3 * t + bestAxis] - splitMin) * scale)) < bestSplit;
+		});
+		const uint32_t mid = static_cast<uint32_t>(middle - order.begin());
+
+		const uint32_t left = static_cast<uint32_t>(nodes.size());
+		nodes[task.node].first = left;
+		nodes[task.node].triangleCount = 0;
+		nodes.emplace_back();
+		nodes.emplace_back();
+		tasks.push_back({left + 1, mid, task.end, task.depth + 1});
+		tasks.push_back({left, task.begin, mid, task.depth + 1});
+	}
+	nodes.shrink_to_fit();
+
+	triangleIds.swap(order);
+	triangleData.reserve(9 * triangleCount);
+	for(const auto t : triangleIds) {
+		const Geometry::Vec3 & a = getVertex(t, 0);
+		const Geometry::Vec3 b = getVertex(t, 1) - a;
+		const Geometry::Vec3 c = getVertex(t, 2) - a;
+		const float values[9] = {a.x(), a.y(), a.z(), b.x(), b.y(), b.z(), c.x(), c.y(), c.z()};
+		triangleData.insert(triangleData.end(), values, values + 9);
+	}
+}
+
+// -----------------------------------------------------------------------------
+
+//! (static)
+std::shared_ptr<const TriangleBVH> TriangleBVH::get(Mesh * mesh) {
+	if(mesh->getDrawMode() != Mesh::DRAW_TRIANGLES)
+		throw std::invalid_argument("TriangleBVH: Mesh is not a triangle mesh.");
+	auto & cache = mesh->_getTriangleBVHCache();
+	const uint64_t vertexRevision = mesh->_getVertexData().getRevision();
+	const uint64_t indexRevision = mesh->_getIndexData().getRevision();
+	if(cache && cache->vertexRevision == vertexRevision && (!mesh->isUsingIndexData() || cache->indexRevision == indexRevision))
+		return cache;
+
+	MeshVertexData & vertexData = mesh->openVertexData();
+	std::vector<Geometry::Vec3> positions(vertexData.getVertexCount());
+	{
+		auto posAcc = PositionAttributeAccessor::create(vertexData, VertexAttributeIds::POSITION);
+		posAcc->getPositions(0, vertexData.getVertexCount(), reinterpret_cast<float *>(positions.data()));
+	}
+	std::shared_ptr<TriangleBVH> bvh;
+	if(mesh->isUsingIndexData())
+		bvh = std::make_shared<TriangleBVH>(positions, mesh->openIndexData().data(), mesh->getIndexCount() / 3);
+	else
+		bvh = std::make_shared<TriangleBVH>(positions, nullptr, mesh->getVertexCount() / 3);
+	bvh->vertexRevision = vertexRevision;
+	bvh->indexRevision = indexRevision;
+	cache = bvh;
+	return cache;
+}
+
+//! (static)
+bool TriangleBVH::attach(Mesh * mesh, const std::shared_ptr<TriangleBVH> & bvh) {
+	if(!bvh || bvh->getTriangleCount() != mesh->getPrimitiveCount())
+		return false;
+	bvh->vertexRevision = mesh->_getVertexData().getRevision();
+	bvh->indexRevision = mesh->_getIndexData().getRevision();
+	mesh->_getTriangleBVHCache() = bvh;
+	return true;
+}
+
+// -----------------------------------------------------------------------------
+
+TriangleBVH::Hit TriangleBVH::getClosestHit(const Geometry::Ray3 & _ray, float maxDistance) const {
+	Hit hit;
+	if(nodes.empty())
+		return hit;
+	const TraversalRay ray(_ray);
+	uint32_t stack[MAX_DEPTH];
+	uint32_t stackSize = 0;
+	uint32_t current = 0;
+	float t, u, v;
+	if(intersectNode(nodes[0], ray, maxDistance) == std::numeric_limits<float>::infinity())
+		return hit;
+	while(true) {
+		const Node & node = nodes[current];
+		if(node.isLeaf()) {
+			for(uint32_t i = node.first; i < node.first + node.triangleCount; ++i) {
+				if(intersectTriangle(&triangleData[9 * i], ray, std::min(maxDistance, hit.distance), t, u, v))
+					updateHit(hit, triangleIds[i], t, u, v);
+			}
+		} else {
+			// visit the nearer child first
+			const float limit = std::min(maxDistance, hit.distance);
+			float tLeft = intersectNode(nodes[node.first], ray, limit);
+			float tRight = intersectNode(nodes[node.first + 1], ray, limit);
+			uint32_t nearChild = node.first, farChild = node.first + 1;
+			if(tRight < tLeft) {
+				std::swap(nearChild, farChild);
+				std::swap(tLeft, tRight);
+			}
+			if(tLeft != std::numeric_limits<float>::infinity()) {
+				if(tRight != std::numeric_limits<float>::infinity())
+					stack[stackSize++] = farChild;
+				current = nearChild;
+				continue;
+			}
+		}
+		// pop the next node that may still contain a closer hit
+		bool found = false;
+		while(stackSize > 0 && !found) {
+			current = stack[--stackSize];
+			found = intersectNode(nodes[current], ray, std::min(maxDistance, hit.distance)) != std::numeric_limits<float>::infinity();
+		}
+		if(!found)
+			break;
+	}
+	return hit;
+}
+
+bool TriangleBVH::hasHit(const Geometry::Ray3 & _ray, float maxDistance) const {
+	if(nodes.empty())
+		return false;
+	const TraversalRay ray(_ray);
+	uint32_t stack[MAX_DEPTH];
+	uint32_t stackSize = 0;
+	stack[stackSize++] = 0;
+	float t, u, v;
+	while(stackSize > 0) {
+		const Node & node = nodes[stack[--stackSize]];
+		if(intersectNode(node, ray, maxDistance) == std::numeric_limits<float>::infinity())
+			continue;
+		if(node.isLeaf()) {
+			for(uint32_t i = node.first; i < node.first + node.triangleCount; ++i) {
+				if(intersectTriangle(&triangleData[9 * i], ray, maxDistance, t, u, v))
+					return true;
+			}
+		} else {
+			stack[stackSize++] = node.first + 1;
+			stack[stackSize++] = node.first;
+		}
+	}
+	return false;
+}
+
+void TriangleBVH::getClosestHits(const Geometry::Ray3 * rays, uint32_t rayCount, Hit * hits, float maxDistance) const {
+	parallelFor(rayCount, 1024, [&](uint32_t begin, uint32_t end) {
+		for(uint32_t r = begin; r < end; ++r)
+			hits[r] = getClosestHit(rays[r], maxDistance);
+	});
+}
+
+// -----------------------------------------------------------------------------
+
+void TriangleBVH::write(std::ostream & output) const {
+	const uint32_t header[3] = {static_cast<uint32_t>(nodes.size()), getTriangleCount(), 0};
+	output.write(FILE_MAGIC, sizeof(FILE_MAGIC));
+	output.write(reinterpret_cast<const char *>(header), sizeof(header));
+	output.write(reinterpret_cast<const char *>(nodes.data()), nodes.size() * sizeof(Node));
+	output.write(reinterpret_cast<const char *>(triangleData.data()), triangleData.size() * sizeof(float));
+	output.write(reinterpret_cast<const char *>(triangleIds.data()), triangleIds.size() * sizeof(uint32_t));
+}
+
+//! (internal) Number of bytes left in a seekable stream, or the maximum value if the stream is not seekable.
+static uint64_t getRemainingBytes(std::istream & input) {
+	const std::istream::pos_type position = input.tellg();
+	if(position == std::istream::pos_type(-1))
+		return std::numeric_limits<uint64_t>::max();
+	input.seekg(0, std::ios::end);
+	const std::istream::pos_type end = input.tellg();
+	input.seekg(position);
+	if(end == std::istream::pos_type(-1) || !input.good())
+		return std::numeric_limits<uint64_t>::max();
+	return static_cast<uint64_t>(end - position);
+}
+
+/*! (internal) Read @p count values, growing the array chunk by chunk, so that a corrupt count in a stream
+	without known length does not allocate more memory than the stream contains. */
+template<typename T>
+static bool readArray(std::istream & input, std::vector<T> & values, size_t count) {
+	const size_t chunkSize = (1 << 20) / sizeof(T);
+	values.clear();
+	while(values.size() < count) {
+		const size_t offset = values.size();
+		values.resize(offset + std::min(chunkSize, count - offset));
+		input.read(reinterpret_cast<char *>(values.data() + offset), (values.size() - offset) * sizeof(T));
+		if(input.fail())
+			return false;
+	}
+	return true;
+}
+
+//! (static)
+std::shared_ptr<TriangleBVH> TriangleBVH::read(std::istream & input) {
+	char magic[sizeof(FILE_MAGIC)];
+	uint32_t header[3];
+	input.read(magic, sizeof(magic));
+	input.read(reinterpret_cast<char *>(header), sizeof(header));
+	if(!input.good() || std::memcmp(magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0) {
+		WARN("TriangleBVH: Invalid header.");
+		return nullptr;
+	}
+	// the sizes are computed in 64 bits (the counts are limited to 32 bits) and checked against the stream
+	const uint64_t nodeCount = header[0];
+	const uint64_t triangleCount = header[1];
+	const uint64_t dataSize = nodeCount * sizeof(Node) + triangleCount * (9 * sizeof(float) + sizeof(uint32_t));
+	if(dataSize > getRemainingBytes(input) || 9 * triangleCount > std::numeric_limits<size_t>::max() / sizeof(float)
+			|| nodeCount > std::numeric_limits<size_t>::max() / sizeof(Node)) {
+		WARN("TriangleBVH: Unexpected end of data.");
+		return nullptr;
+	}
+	std::shared_ptr<TriangleBVH> bvh(new TriangleBVH);
+	if(!readArray(input, bvh->nodes, static_cast<size_t>(nodeCount))
+			|| !readArray(input, bvh->triangleData, static_cast<size_t>(9 * triangleCount))
+			|| !readArray(input, bvh->triangleIds, static_cast<size_t>(triangleCount))) {
+		WARN("TriangleBVH: Unexpected end of data.");
+		return nullptr;
+	}
+	for(const auto triangle : bvh->triangleIds) {
+		if(triangle >= triangleCount) {
+			WARN("TriangleBVH: Invalid triangle id.");
+			return nullptr;
+		}
+	}
+	// children have to be stored behind their parent and the depth has to fit into the traversal stack
+	std::vector<uint32_t> depths(bvh->nodes.size(), 0);
+	for(uint32_t i = 0; i < bvh->nodes.size(); ++i) {
+		const Node & node = bvh->nodes[i];
+		const uint64_t end = static_cast<uint64_t>(node.first) + (node.isLeaf() ? node.triangleCount : 2);
+		bool valid = end <= (node.isLeaf() ? bvh->triangleIds.size() : bvh->nodes.size());
+		if(valid && !node.isLeaf()) {
+			valid = node.first > i && depths[i] + 1 < MAX_DEPTH;
+			depths[node.first] = depths[node.first + 1] = depths[i] + 1;
+		}
+		if(!valid) {
+			WARN("TriangleBVH: Invalid node.");
+			return nullptr;
+		}
+	}
+	return bvh;
+}
+
+}
+}
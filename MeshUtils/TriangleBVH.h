@@ -0,0 +1,125 @@
+/*
+ This file is part of the Rendering library.
+ Copyright (C) 2026 agent <agent@local>
+
+ This library is subject to the terms of the Mozilla Public License, v. 2.0.
+ You should have received a copy of the MPL along with this library; see the
+ file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef RENDERING_MESHUTILS_TRIANGLEBVH_H_
+#define RENDERING_MESHUTILS_TRIANGLEBVH_H_
+
+#include <Geometry/Vec3.h>
+
+#include <cstdint>
+#include <iosfwd>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace Geometry {
+template<typename _T> class _Ray;
+typedef _Ray<Vec3> Ray3;
+}
+
+namespace Rendering {
+class Mesh;
+namespace MeshUtils {
+
+/**
+ * Bounding volume hierarchy over the triangles of a mesh for fast ray queries.
+ *
+ * The hierarchy is built top-down using the binned surface area heuristic.
+ * Nodes and triangles are stored in flat arrays: the children of an inner node
+ * are stored next to each other and the triangles of a leaf are consecutive.
+ * For each triangle, the first vertex and the two edges starting at it are stored,
+ * so no vertex accessor is needed during traversal.
+ *
+ * A TriangleBVH is immutable after creation and can be queried from multiple threads.
+ * Use get(Mesh*) to obtain the hierarchy that is cached at the mesh. It is rebuilt
+ * when the vertex or index data of the mesh has been marked as changed.
+ *
+ * Triangles are intersected from both sides. A ray hits a triangle at distance t
+ * if origin + t * direction lies inside the triangle and t >= 0. If two triangles
+ * are hit at the same distance, the one with the lower index is reported.
+ * @ingroup mesh_accessor
+ */
+class TriangleBVH {
+	public:
+		//! Node of the hierarchy (32 bytes).
+		struct Node {
+			float min[3];
+			//! Index of the first child (inner node) or of the first triangle (leaf)
+			uint32_t first;
+			float max[3];
+			//! Number of triangles (zero for inner nodes)
+			uint32_t triangleCount;
+
+			bool isLeaf() const	{	return triangleCount > 0;	}
+		};
+
+		//! Result of a ray query.
+		struct Hit {
+			//! Index of the hit triangle in the mesh or -1 if nothing was hit
+			int32_t triangle;
+			//! Ray parameter of the hit point
+			float distance;
+			//! Barycentric coordinates of the hit point w.r.t. the second and third vertex
+			float u, v;
+
+			Hit() : triangle(-1), distance(std::numeric_limits<float>::infinity()), u(0), v(0) {}
+			bool isValid() const	{	return triangle >= 0;	}
+		};
+
+		/*! Return the hierarchy cached at the given mesh.
+			If there is none or the mesh's data has been marked as changed since it was built, a new one is built.
+			\note Building the hierarchy is not thread-safe; concurrent queries on the returned object are.
+			If the mesh is no triangle mesh, an std::invalid_argument exception is thrown. */
+		static std::shared_ptr<const TriangleBVH> get(Mesh * mesh);
+
+		/*! Store @p bvh (e.g. one read from a file) in the cache of the mesh.
+			Returns false if the number of triangles does not match. */
+		static bool attach(Mesh * mesh, const std::shared_ptr<TriangleBVH> & bvh);
+
+		/*! Build the hierarchy for the triangles given by @p indices (three per triangle).
+			@param positions Vertex positions
+			@param indices Vertex indices; may be nullptr for consecutive vertices */
+		TriangleBVH(const std::vector<Geometry::Vec3> & positions, const uint32_t * indices, uint32_t triangleCount);
+
+		//! Return the closest triangle hit by the ray within [0, maxDistance].
+		Hit getClosestHit(const Geometry::Ray3 & ray, float maxDistance = std::numeric_limits<float>::infinity()) const;
+
+		//! Return true if the ray hits any triangle within [0, maxDistance] (e.g. for visibility tests).
+		bool hasHit(const Geometry::Ray3 & ray, float maxDistance = std::numeric_limits<float>::infinity()) const;
+
+		/*! Batched version of getClosestHit(). Large batches are distributed over all hardware threads.
+			@param hits Array receiving one hit for every ray */
+		void getClosestHits(const Geometry::Ray3 * rays, uint32_t rayCount, Hit * hits, float maxDistance = std::numeric_limits<float>::infinity()) const;
+
+		const std::vector<Node> & getNodes() const	{	return nodes;	}
+		uint32_t getTriangleCount() const			{	return static_cast<uint32_t>(triangleIds.size());	}
+
+		/*! Write the hierarchy in a binary format (native byte order).
+			\note The result is only meaningful together with the mesh it was built for. */
+		void write(std::ostream & output) const;
+		//! Read a hierarchy written by write(). Returns nullptr on error.
+		static std::shared_ptr<TriangleBVH> read(std::istream & input);
+
+	private:
+		TriangleBVH();
+
+		std::vector<Node> nodes;
+		//! Nine floats per triangle (vertex a, b - a, c - a) in leaf order
+		std::vector<float> triangleData;
+		//! Mesh triangle index for every triangle in leaf order
+		std::vector<uint32_t> triangleIds;
+
+		uint64_t vertexRevision;
+		uint64_t indexRevision;
+};
+
+}
+}
+
+#endif /* RENDERING_MESHUTILS_TRIANGLEBVH_H_ */
@@ -0,0 +1,274 @@
+/*
+ This file is part of the Rendering library.
+ Copyright (C) 2026 agent <agent@local>
+
+ This library is subject to the terms of the Mozilla Public License, v. 2.0.
+ You should have received a copy of the MPL along with this library; see the
+ file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "RenderQueue.h"
+#include "RenderingContext.h"
+#include "../BufferObject.h"
+#include "../Draw.h"
+#include "../GLHeader.h"
+#include "../Mesh/Mesh.h"
+#include "../Shader/Shader.h"
+#include <Util/Macros.h>
+#include <algorithm>
+#include <utility>
+
+namespace Rendering {
+
+/*! Layout of the sort keys (from the most significant bits): shader, rendering parameters, textures, mesh.
+	Ranks exceeding their bits are clamped; this only reduces the effect of sorting. */
+static const uint32_t SHADER_BITS = 16;
+static const uint32_t PARAMETER_BITS = 8;
+static const uint32_t TEXTURE_BITS = 16;
+static const uint32_t MESH_BITS = 24;
+
+//! (internal)
+static uint64_t clampRank(size_t rank, uint32_t bits) {
+	return std::min<uint64_t>(rank, (1ull << bits) - 1);
+}
+
+//! (internal)
+static bool hasEqualParameters(const RenderQueue::State & a, const RenderQueue::State & b) {
+	return a.blending == b.blending && a.depthBuffer == b.depthBuffer && a.cullFace == b.cullFace;
+}
+
+uint32_t RenderQueue::addState(const State & state) {
+	for(uint32_t i = 0; i < states.size(); ++i) {
+		const State & other = states[i].state;
+		if(other.shader == state.shader && other.textures == state.textures && hasEqualParameters(other, state))
+			return i;
+	}
+	const uint64_t shaderRank = shaderRanks.emplace(state.shader, static_cast<uint32_t>(shaderRanks.size())).first->second;
+	auto textureSet = std::find(textureSets.begin(), textureSets.end(), state.textures);
+	if(textureSet == textureSets.end())
+		textureSet = textureSets.insert(textureSets.end(), state.textures);
+	auto parameterSet = std::find_if(parameterSets.begin(), parameterSets.end(), [&state](const State & other) {
+		return hasEqualParameters(other, state);
+	});
+	if(parameterSet == parameterSets.end())
+		parameterSet = parameterSets.insert(parameterSets.end(), state);
+
+	StateEntry entry;
+	entry.state = state;
+	entry.keyPrefix = (clampRank(shaderRank, SHADER_BITS) << (PARAMETER_BITS + TEXTURE_BITS + MESH_BITS))
+			| (clampRank(std::distance(parameterSets.begin(), parameterSet), PARAMETER_BITS) << (TEXTURE_BITS + MESH_BITS))
+			| (clampRank(std::distance(textureSets.begin(), textureSet), TEXTURE_BITS) << MESH_BITS);
+	states.emplace_back(std::move(entry));
+	return static_cast<uint32_t>(states.size() - 1);
+}
+
+void RenderQueue::add(uint32_t stateId, Mesh * mesh, uint32_t firstElement, uint32_t elementCount, const Geometry::Matrix4x4 & modelToCamera,
+					  const std::vector<Uniform> & _uniforms) {
+	if(stateId >= states.size())
+		INVALID_ARGUMENT_EXCEPTION("RenderQueue::add: Invalid state id.");
+	const uint64_t meshRank = meshRanks.emplace(mesh, static_cast<uint32_t>(meshRanks.size())).first->second;
+	Item item;
+	item.sortKey = states[stateId].keyPrefix | clampRank(meshRank, MESH_BITS);
+	item.stateId = stateId;
+	item.mesh = mesh;
+	item.firstElement = firstElement;
+	item.elementCount = elementCount;
+	item.firstUniform = static_cast<uint32_t>(uniforms.size());
+	item.uniformCount = static_cast<uint32_t>(_uniforms.size());
+	item.modelToCamera = modelToCamera;
+	uniforms.insert(uniforms.end(), _uniforms.begin(), _uniforms.end());
+	order.push_back(static_cast<uint32_t>(items.size()));
+	items.emplace_back(std::move(item));
+}
+
+void RenderQueue::add(uint32_t stateId, Mesh * mesh, const Geometry::Matrix4x4 & modelToCamera, const std::vector<Uniform> & _uniforms) {
+	add(stateId, mesh, 0, mesh->isUsingIndexData() ? mesh->getIndexCount() : mesh->getVertexCount(), modelToCamera, _uniforms);
+}
+
+void RenderQueue::sort() {
+	std::sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) {
+		return items[a].sortKey < items[b].sortKey || (items[a].sortKey == items[b].sortKey && a < b);
+	});
+}
+
+void RenderQueue::clear() {
+	items.clear();
+	order.clear();
+	uniforms.clear();
+	meshRanks.clear();
+}
+
+RenderQueue::Statistics RenderQueue::execute(Backend & backend) const {
+	Statistics statistics;
+	const State * applied = nullptr;
+	std::vector<Geometry::Matrix4x4> instances;
+	//! Values of the uniforms before they were set by a draw call
+	std::vector<std::pair<Shader *, Uniform>> overridden;
+	const auto setsUniform = [this](const Item & item, Util::StringIdentifier name) {
+		for(uint32_t u = item.firstUniform; u < item.firstUniform + item.uniformCount; ++u) {
+			if(uniforms[u].getNameId() == name)
+				return true;
+		}
+		return false;
+	};
+	for(size_t pos = 0; pos < order.size();) {
+		const Item & item = items[order[pos]];
+		const State & state = states[item.stateId].state;
+
+		// apply the differences to the previous state
+		if(!applied || applied->shader != state.shader) {
+			backend.setShader(state.shader);
+			++statistics.shaderChanges;
+		}
+		const size_t unitCount = std::max(state.textures.size(), applied ? applied->textures.size() : 0);
+		for(size_t unit = 0; unit < unitCount; ++unit) {
+			Texture * texture = unit < state.textures.size() ? state.textures[unit] : nullptr;
+			Texture * appliedTexture = applied && unit < applied->textures.size() ? applied->textures[unit] : nullptr;
+			if(applied ? texture != appliedTexture : unit < state.textures.size()) {
+				backend.setTexture(static_cast<uint8_t>(unit), texture);
+				++statistics.textureChanges;
+			}
+		}
+		if(!applied || !hasEqualParameters(*applied, state)) {
+			if(!applied || applied->blending != state.blending)
+				backend.setBlending(state.blending);
+			if(!applied || applied->depthBuffer != state.depthBuffer)
+				backend.setDepthBuffer(state.depthBuffer);
+			if(!applied || applied->cullFace != state.cullFace)
+				backend.setCullFace(state.cullFace);
+			++statistics.parameterChanges;
+		}
+		applied = &state;
+
+		// merge the following draw calls of the same mesh range into one instanced draw call
+		size_t end = pos + 1;
+		if(item.uniformCount == 0 && backend.canDrawInstances(state.shader)) {
+			while(end < order.size()) {
+				const Item & next = items[order[end]];
+				if(next.stateId != item.stateId || next.mesh != item.mesh || next.firstElement != item.firstElement
+						|| next.elementCount != item.elementCount || next.uniformCount > 0)
+					break;
+				++end;
+			}
+		}
+		// restore the uniforms set by previous draw calls with this shader, unless they are set again
+		for(auto it = overridden.begin(); it != overridden.end();) {
+			if(it->first == state.shader && !setsUniform(item, it->second.getNameId())) {
+				backend.setUniform(it->first, it->second);
+				++statistics.uniformChanges;
+				it = overridden.erase(it);
+			} else {
+				++it;
+			}
+		}
+		if(end - pos > 1) {
+			instances.clear();
+			for(size_t i = pos; i < end; ++i)
+				instances.push_back(items[order[i]].modelToCamera);
+			backend.drawInstances(item.mesh, item.firstElement, item.elementCount, instances);
+			++statistics.instancedDrawCalls;
+			statistics.instances += static_cast<uint32_t>(end - pos);
+		} else {
+			for(uint32_t u = item.firstUniform; u < item.firstUniform + item.uniformCount; ++u) {
+				const Uniform & uniform = uniforms[u];
+				const bool saved = std::any_of(overridden.begin(), overridden.end(), [&](const std::pair<Shader *, Uniform> & entry) {
+					return entry.first == state.shader && entry.second.getNameId() == uniform.getNameId();
+				});
+				if(!saved) {
+					Uniform previous = backend.getUniform(state.shader, uniform.getNameId());
+					if(!previous.isNull())
+						overridden.emplace_back(state.shader, std::move(previous));
+				}
+				backend.setUniform(state.shader, uniform);
+				++statistics.uniformChanges;
+			}
+			backend.draw(item.mesh, item.firstElement, item.elementCount, item.modelToCamera);
+			++statistics.drawCalls;
+		}
+		pos = end;
+	}
+	for(const auto & entry : overridden) {
+		backend.setUniform(entry.first, entry.second);
+		++statistics.uniformChanges;
+	}
+	return statistics;
+}
+
+//! (internal) Execution of the draw calls with a RenderingContext.
+class ContextBackend : public RenderQueue::Backend {
+		RenderingContext & rc;
+		const Util::StringIdentifier instanceAttribute;
+		const bool instancing;
+		std::vector<bool> pushedTextures;
+		BufferObject instanceBuffer;
+		std::vector<float> instanceData;
+	public:
+		ContextBackend(RenderingContext & _rc, Util::StringIdentifier _instanceAttribute, bool _instancing) :
+				rc(_rc), instanceAttribute(_instanceAttribute), instancing(_instancing) {
+			rc.pushShader();
+			rc.pushBlending();
+			rc.pushDepthBuffer();
+			rc.pushCullFace();
+			rc.pushMatrix_modelToCamera();
+		}
+		virtual ~ContextBackend() {
+			for(size_t unit = 0; unit < pushedTextures.size(); ++unit) {
+				if(pushedTextures[unit])
+					rc.popTexture(static_cast<uint8_t>(unit));
+			}
+			rc.popMatrix_modelToCamera();
+			rc.popCullFace();
+			rc.popDepthBuffer();
+			rc.popBlending();
+			rc.popShader();
+		}
+
+		void setShader(Shader * shader) override								{	rc.setShader(shader);	}
+		void setTexture(uint8_t unit, Texture * texture) override {
+			if(unit >= pushedTextures.size())
+				pushedTextures.resize(unit + 1, false);
+			if(!pushedTextures[unit]) {
+				rc.pushTexture(unit);
+				pushedTextures[unit] = true;
+			}
+			rc.setTexture(unit, texture);
+		}
+		void setBlending(const BlendingParameters & parameters) override			{	rc.setBlending(parameters);	}
+		void setDepthBuffer(const DepthBufferParameters & parameters) override		{	rc.setDepthBuffer(parameters);	}
+		void setCullFace(const CullFaceParameters & parameters) override			{	rc.setCullFace(parameters);	}
+		void setUniform(Shader * shader, const Uniform & uniform) override {
+			if(shader)
+				shader->setUniform(rc, uniform, false);
+		}
+		Uniform getUniform(Shader * shader, Util::StringIdentifier name) override {
+			return shader ? shader->getUniform(name) : Uniform::nullUniform;
+		}
+		void draw(Mesh * mesh, uint32_t firstElement, uint32_t elementCount, const Geometry::Matrix4x4 & modelToCamera) override {
+			rc.setMatrix_modelToCamera(modelToCamera);
+			rc.displayMesh(mesh, firstElement, elementCount);
+		}
+		bool canDrawInstances(Shader * shader) override {
+			return instancing && shader && shader->getVertexAttributeLocation(instanceAttribute) >= 0;
+		}
+		void drawInstances(Mesh * mesh, uint32_t firstElement, uint32_t elementCount, const std::vector<Geometry::Matrix4x4> & modelToCamera) override {
+			// column major, as matrix uniforms
+			instanceData.resize(16 * modelToCamera.size());
+			for(size_t i = 0; i < modelToCamera.size(); ++i) {
+				const Geometry::Matrix4x4 transposed = modelToCamera[i].getTransposed();
+				std::copy(transposed.getData(), transposed.getData() + 16, instanceData.begin() + 16 * i);
+			}
+			instanceBuffer.uploadData(GL_ARRAY_BUFFER, reinterpret_cast<const uint8_t *>(instanceData.data()), instanceData.size() * sizeof(float), GL_STREAM_DRAW);
+			const int32_t location = rc.getActiveShader()->getVertexAttributeLocation(instanceAttribute);
+			rc.setMatrix_modelToCamera(Geometry::Matrix4x4());
+			enableInstanceBuffer(rc, instanceBuffer, location, 16);
+			Rendering::drawInstances(rc, mesh, firstElement, elementCount, static_cast<uint32_t>(modelToCamera.size()));
+			disableInstanceBuffer(rc, instanceBuffer, location, 16);
+		}
+};
+
+RenderQueue::Statistics RenderQueue::execute(RenderingContext & rc) {
+	ContextBackend backend(rc, instanceAttribute, instancing);
+	return execute(backend);
+}
+
+}
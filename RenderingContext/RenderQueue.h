@@ -0,0 +1,169 @@
+/*
+ This file is part of the Rendering library.
+ Copyright (C) 2026 agent <agent@local>
+
+ This library is subject to the terms of the Mozilla Public License, v. 2.0.
+ You should have received a copy of the MPL along with this library; see the
+ file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef RENDERING_RENDERINGCONTEXT_RENDERQUEUE_H_
+#define RENDERING_RENDERINGCONTEXT_RENDERQUEUE_H_
+
+#include "RenderingParameters.h"
+#include "../Shader/Uniform.h"
+
+#include <Geometry/Matrix4x4.h>
+#include <Util/StringIdentifier.h>
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace Rendering {
+class Mesh;
+class RenderingContext;
+class Shader;
+class Texture;
+
+/**
+ * Deferred execution of draw calls, sorted to minimize the state changes between them.
+ *
+ * Draw calls are recorded with add() and executed with execute(). Every draw call references a
+ * registered State (shader, textures and rendering parameters) and may have its own uniforms.
+ * sort() orders the draw calls by a 64 bit key consisting of the shader, the rendering parameters,
+ * the textures and the mesh (in this order of priority); execute() then applies only the parts of the
+ * state that differ from the previous draw call. The uniforms of a draw call only affect this draw call:
+ * their previous values are restored before the next draw call with the same shader that does not set
+ * them itself, and at the end of execute(). Therefore, sorting does not change the rendered result.
+ * If instancing is enabled (see setInstanceAttribute()),
+ * consecutive draw calls of the same range of a mesh with the same state and without own uniforms are
+ * merged into one instanced draw call.
+ *
+ * The queue does not hold references: all shaders, textures and meshes have to stay alive until the
+ * draw calls have been executed or cleared.
+ * @ingroup context
+ */
+class RenderQueue {
+	public:
+		//! Everything a draw call needs besides the mesh and its own values.
+		struct State {
+			Shader * shader;
+			//! Textures of the units 0, 1, ... (may contain nullptr)
+			std::vector<Texture *> textures;
+			BlendingParameters blending;
+			DepthBufferParameters depthBuffer;
+			CullFaceParameters cullFace;
+
+			State() : shader(nullptr) {}
+			explicit State(Shader * _shader, std::vector<Texture *> _textures = {}) : shader(_shader), textures(std::move(_textures)) {}
+		};
+
+		/**
+		 * Receiver of the commands issued by execute(). Only changes are passed on.
+		 * Used to execute the queue with a RenderingContext, or to record the commands (e.g., for tests).
+		 */
+		class Backend {
+			public:
+				virtual ~Backend() {}
+				virtual void setShader(Shader * shader) = 0;
+				virtual void setTexture(uint8_t unit, Texture * texture) = 0;
+				virtual void setBlending(const BlendingParameters & parameters) = 0;
+				virtual void setDepthBuffer(const DepthBufferParameters & parameters) = 0;
+				virtual void setCullFace(const CullFaceParameters & parameters) = 0;
+				virtual void setUniform(Shader * shader, const Uniform & uniform) = 0;
+				//! Return the current value of the uniform, or a null uniform if the shader does not define it.
+				virtual Uniform getUniform(Shader * shader, Util::StringIdentifier name) = 0;
+				virtual void draw(Mesh * mesh, uint32_t firstElement, uint32_t elementCount, const Geometry::Matrix4x4 & modelToCamera) = 0;
+				//! Return true if draw calls with the given shader can be merged into drawInstances().
+				virtual bool canDrawInstances(Shader * /*shader*/)	{	return false;	}
+				virtual void drawInstances(Mesh * /*mesh*/, uint32_t /*firstElement*/, uint32_t /*elementCount*/,
+										   const std::vector<Geometry::Matrix4x4> & /*modelToCamera*/) {}
+		};
+
+		//! Number of commands issued by execute().
+		struct Statistics {
+			uint32_t drawCalls;
+			uint32_t instancedDrawCalls;
+			//! Number of draw calls merged into instanced draw calls
+			uint32_t instances;
+			uint32_t shaderChanges;
+			uint32_t textureChanges;
+			//! Changes of the blending, depth buffer or cull face parameters
+			uint32_t parameterChanges;
+			//! Uniforms set by draw calls and restored afterwards
+			uint32_t uniformChanges;
+
+			Statistics() : drawCalls(0), instancedDrawCalls(0), instances(0), shaderChanges(0), textureChanges(0), parameterChanges(0), uniformChanges(0) {}
+		};
+
+		RenderQueue() : instancing(false) {}
+
+		/*! Register a state and return its id. Registering an equal state again returns the same id.
+			The ids stay valid for the lifetime of the queue. */
+		uint32_t addState(const State & state);
+		const State & getState(uint32_t stateId) const	{	return states.at(stateId).state;	}
+
+		/*! Record a draw call of the elements [firstElement, firstElement+elementCount) of @p mesh.
+			@param modelToCamera Set as modelToCamera matrix (or passed as instance attribute) for the draw call
+			@param uniforms Set at the state's shader for this draw call only */
+		void add(uint32_t stateId, Mesh * mesh, uint32_t firstElement, uint32_t elementCount, const Geometry::Matrix4x4 & modelToCamera,
+				 const std::vector<Uniform> & uniforms = {});
+		//! Record a draw call of the whole mesh.
+		void add(uint32_t stateId, Mesh * mesh, const Geometry::Matrix4x4 & modelToCamera, const std::vector<Uniform> & uniforms = {});
+
+		//! Order the recorded draw calls by their sort keys; draw calls with equal keys keep their order.
+		void sort();
+
+		/*! Execute the recorded draw calls in their current order with the given context.
+			The context's shader, textures, blending, depth buffer, cull face and modelToCamera matrix are restored afterwards. */
+		Statistics execute(RenderingContext & rc);
+		//! Issue the recorded draw calls in their current order to the given backend.
+		Statistics execute(Backend & backend) const;
+
+		//! Remove all draw calls; the states stay registered.
+		void clear();
+		size_t size() const	{	return items.size();	}
+		bool empty() const	{	return items.empty();	}
+
+		/*! Enable merging draw calls into instanced draw calls for shaders having the vertex attribute @p name.
+			The attribute (mat4, four consecutive locations) receives the modelToCamera matrix of every instance,
+			while the context's modelToCamera matrix is the identity. */
+		void setInstanceAttribute(Util::StringIdentifier name)	{	instanceAttribute = name;	instancing = true;	}
+		void disableInstancing()	{	instancing = false;	}
+
+	private:
+		struct StateEntry {
+			State state;
+			//! Upper bits of the sort keys of the draw calls using the state
+			uint64_t keyPrefix;
+		};
+		struct Item {
+			uint64_t sortKey;
+			uint32_t stateId;
+			Mesh * mesh;
+			uint32_t firstElement;
+			uint32_t elementCount;
+			uint32_t firstUniform;
+			uint32_t uniformCount;
+			Geometry::Matrix4x4 modelToCamera;
+		};
+
+		std::vector<StateEntry> states;
+		std::unordered_map<Shader *, uint32_t> shaderRanks;
+		std::vector<std::vector<Texture *>> textureSets;
+		std::vector<State> parameterSets;
+		std::unordered_map<Mesh *, uint32_t> meshRanks;
+
+		std::vector<Item> items;
+		//! Indices of the items in execution order
+		std::vector<uint32_t> order;
+		std::vector<Uniform> uniforms;
+
+		Util::StringIdentifier instanceAttribute;
+		bool instancing;
+};
+
+}
+
+#endif /* RENDERING_RENDERINGCONTEXT_RENDERQUEUE_H_ */
@@ -26,12 +26,14 @@
 #include "../FBO.h"
 #include "../GLHeader.h"
 #include "../Helper.h"
+#include "../TransientGeometryBuffer.h"
 #include <Geometry/Matrix4x4.h>
 #include <Geometry/Rect.h>
 #include <Util/Graphics/ColorLibrary.h>
 #include <Util/Graphics/Color.h>
 #include <Util/Macros.h>
 #include <Util/References.h>
+#include <algorithm>
 #include <array>
 #include <stdexcept>
 #include <stack>
@@ -88,6 +90,9 @@ class RenderingContext::InternalData {
 
 		UniformRegistry globalUniforms;
 
+		bool sgUniformBlockEnabled;
+		StatusHandler_sgUniforms::UniformBlockBuffer sgUniformBlockBuffer;
+
 		std::stack<Geometry::Matrix4x4> matrixStack;
 		std::stack<Geometry::Matrix4x4> projectionMatrixStack;
 
@@ -106,10 +111,46 @@ class RenderingContext::InternalData {
 		std::stack<Geometry::Rect_i> viewportStack;
 
 		Geometry::Rect_i windowClientArea;
+
+		//! Created when displayTransientGeometry() is called the first time
+		std::unique_ptr<TransientGeometryBuffer> transientGeometry;
+		//! State of the pending transient geometry
+		RenderingStatus transientRenderingStatus;
+		CoreRenderingStatus transientCoreRenderingStatus;
+		Util::Reference<Shader> transientShader;
+		bool flushingTransientGeometry;
+		//! Nesting depth of beginTransientGeometryBatch()
+		uint32_t transientBatchDepth;
 		
 		InternalData() : targetRenderingStatus(), openGLRenderingStatus(), activeRenderingStatus(nullptr),
-			actualCoreRenderingStatus(), appliedCoreRenderingStatus(), globalUniforms(), textureStacks(),
-			currentViewport(0, 0, 0, 0) {
+			actualCoreRenderingStatus(), appliedCoreRenderingStatus(), globalUniforms(), sgUniformBlockEnabled(false), textureStacks(),
+			currentViewport(0, 0, 0, 0), flushingTransientGeometry(false), transientBatchDepth(0) {
+		}
+
+		//! Return true if the current state differs from the state of the pending transient geometry.
+		bool transientStateChanged() const {
+			const RenderingStatus & status = transientRenderingStatus;
+			const CoreRenderingStatus & coreStatus = transientCoreRenderingStatus;
+			return transientShader.get() != activeRenderingStatus->getShader() ||
+					status.matrix_modelToCameraChanged(targetRenderingStatus) ||
+					status.matrix_cameraToClipChanged(targetRenderingStatus) ||
+					status.matrixCameraToWorldChanged(targetRenderingStatus) ||
+					status.materialChanged(targetRenderingStatus) ||
+					status.lightsChanged(targetRenderingStatus) ||
+					status.pointParametersChanged(targetRenderingStatus) ||
+					status.textureUnitsChanged(targetRenderingStatus) ||
+					coreStatus.texturesChanged(actualCoreRenderingStatus) ||
+					coreStatus.blendingParametersChanged(actualCoreRenderingStatus) ||
+					coreStatus.depthBufferParametersChanged(actualCoreRenderingStatus) ||
+					coreStatus.cullFaceParametersChanged(actualCoreRenderingStatus) ||
+					coreStatus.alphaTestParametersChanged(actualCoreRenderingStatus) ||
+					coreStatus.colorBufferParametersChanged(actualCoreRenderingStatus) ||
+					coreStatus.lightingParametersChanged(actualCoreRenderingStatus) ||
+					coreStatus.lineParametersChanged(actualCoreRenderingStatus) ||
+					coreStatus.polygonModeParametersChanged(actualCoreRenderingStatus) ||
+					coreStatus.polygonOffsetParametersChanged(actualCoreRenderingStatus) ||
+					coreStatus.primitiveRestartParametersChanged(actualCoreRenderingStatus) ||
+					coreStatus.stencilParametersChanged(actualCoreRenderingStatus);
 		}
 };
 
@@ -153,6 +194,14 @@ void RenderingContext::setImmediateMode(const bool enabled) {
 		applyChanges();
 }
 
+void RenderingContext::setSGUniformBlockEnabled(bool enabled) {
+	internalData->sgUniformBlockEnabled = enabled;
+}
+
+bool RenderingContext::isSGUniformBlockEnabled() const {
+	return internalData->sgUniformBlockEnabled;
+}
+
 void RenderingContext::clearScreenRect(const Geometry::Rect_i & rect, const Util::Color4f & color, bool _clearDepth) {
 	pushAndSetScissor(ScissorParameters(rect));
 	applyChanges();
@@ -269,6 +318,7 @@ void RenderingContext::barrier(uint32_t flags) {
 // Applying changes ***************************************************************************
 
 void RenderingContext::applyChanges(bool forced) {
+	flushTransientGeometry();
 	try {
 		StatusHandler_glCore::apply(internalData->appliedCoreRenderingStatus, internalData->actualCoreRenderingStatus, forced);
 		Shader * shader = internalData->getActiveRenderingStatus()->getShader();
@@ -277,7 +327,10 @@ void RenderingContext::applyChanges(bool forced) {
 				StatusHandler_glCompatibility::apply(internalData->openGLRenderingStatus, internalData->targetRenderingStatus, forced);
 
 			if(shader->usesSGUniforms()) {
-				StatusHandler_sgUniforms::apply(*shader->getRenderingStatus(), internalData->targetRenderingStatus, forced);
+				if(internalData->sgUniformBlockEnabled && shader->usesSGUniformBlock())
+					StatusHandler_sgUniforms::applyBlock(*shader->getRenderingStatus(), internalData->targetRenderingStatus, forced, internalData->sgUniformBlockBuffer);
+				else
+					StatusHandler_sgUniforms::apply(*shader->getRenderingStatus(), internalData->targetRenderingStatus, forced);
 				if(immediate && getActiveShader() == shader) {
 					shader->applyUniforms(false); // forced is false here, as this forced means to re-apply all uniforms
 				}
@@ -298,6 +351,81 @@ void RenderingContext::applyChanges(bool forced) {
 	GET_GL_ERROR();
 }
 
+// Transient geometry ***************************************************************************
+
+void RenderingContext::displayTransientGeometry(const VertexDescription & vd, uint32_t drawMode, const uint8_t * vertices, uint32_t vertexCount,
+												const uint32_t * indices, uint32_t indexCount) {
+	TransientGeometryBuffer & buffer = getTransientGeometryBuffer();
+	if(!buffer.empty() && (!buffer.isCompatible(vd, drawMode) || internalData->transientStateChanged()))
+		flushTransientGeometry();
+	if(buffer.empty()) {
+		internalData->transientRenderingStatus = internalData->targetRenderingStatus;
+		internalData->transientCoreRenderingStatus = internalData->actualCoreRenderingStatus;
+		internalData->transientShader = getActiveShader();
+	}
+	const TransientGeometryBuffer::Allocation allocation = buffer.append(vd, drawMode, vertexCount, indexCount);
+	std::copy(vertices, vertices + vertexCount * vd.getVertexSize(), allocation.vertices);
+	const uint32_t baseVertex = allocation.baseVertex;
+	std::transform(indices, indices + indexCount, allocation.indices, [baseVertex](uint32_t index) {	return index + baseVertex;	});
+	if(internalData->transientBatchDepth == 0)
+		flushTransientGeometry();
+}
+
+void RenderingContext::flushTransientGeometry() {
+	if(!internalData->transientGeometry || internalData->transientGeometry->empty() || internalData->flushingTransientGeometry)
+		return;
+	internalData->flushingTransientGeometry = true;
+	if(!internalData->transientStateChanged()) {
+		applyChanges();
+		internalData->transientGeometry->draw(*this);
+	} else {
+		// draw with the state of the geometry and restore the current state afterwards
+		const RenderingStatus renderingStatus(internalData->targetRenderingStatus);
+		const CoreRenderingStatus coreRenderingStatus(internalData->actualCoreRenderingStatus);
+		RenderingStatus * activeStatus = internalData->getActiveRenderingStatus();
+		internalData->targetRenderingStatus = internalData->transientRenderingStatus;
+		internalData->actualCoreRenderingStatus = internalData->transientCoreRenderingStatus;
+		if(activeStatus->getShader() != internalData->transientShader.get())
+			setShader(internalData->transientShader.get());
+		applyChanges();
+		internalData->transientGeometry->draw(*this);
+
+		internalData->targetRenderingStatus = renderingStatus;
+		internalData->actualCoreRenderingStatus = coreRenderingStatus;
+		if(internalData->getActiveRenderingStatus() != activeStatus) {
+			setShader(activeStatus->getShader());
+			internalData->setActiveRenderingStatus(activeStatus);
+		}
+		if(immediate)
+			applyChanges();
+	}
+	internalData->transientShader = nullptr;
+	internalData->flushingTransientGeometry = false;
+}
+
+void RenderingContext::beginTransientGeometryBatch() {
+	++internalData->transientBatchDepth;
+}
+
+void RenderingContext::endTransientGeometryBatch() {
+	if(internalData->transientBatchDepth == 0) {
+		WARN("endTransientGeometryBatch: No batch has been started.");
+		return;
+	}
+	if(--internalData->transientBatchDepth == 0)
+		flushTransientGeometry();
+}
+
+bool RenderingContext::isBatchingTransientGeometry() const {
+	return internalData->transientBatchDepth > 0;
+}
+
+TransientGeometryBuffer & RenderingContext::getTransientGeometryBuffer() {
+	if(!internalData->transientGeometry)
+		internalData->transientGeometry.reset(new TransientGeometryBuffer);
+	return *internalData->transientGeometry;
+}
+
 // Atomic counters (extension ARB_shader_atomic_counters)  *****************************************************
 
 
@@ -376,6 +504,7 @@ void RenderingContext::popAtomicCounterTextureBuffer(uint32_t index){
 
 //! \note the texture in iParam may be null to unbind
 void RenderingContext::setAtomicCounterTextureBuffer(uint32_t index, Texture * texture){
+	flushTransientGeometry();
 	assertCorrectAtomicBufferIndex(index);
 #if defined(GL_ARB_shader_image_load_store)
 	if(isAtomicCountersSupported()){
@@ -477,6 +606,7 @@ void RenderingContext::pushAndSetClipPlane(uint8_t index, const ClipPlaneParamet
 }
 
 void RenderingContext::setClipPlane(uint8_t index, const ClipPlaneParameters & planeParameters) {	
+	flushTransientGeometry();
 	if(index >= MAX_CLIP_PLANES) {
 		WARN("setClipPlane: invalid plane index");
 		return;
@@ -526,6 +656,7 @@ void RenderingContext::setColorBuffer(const ColorBufferParameters & p) {
 }
 
 void RenderingContext::clearColor(const Util::Color4f & clearValue) {
+	flushTransientGeometry();
 	glClearColor(clearValue.getR(), clearValue.getG(), clearValue.getB(), clearValue.getA());
 	glClear(GL_COLOR_BUFFER_BIT);
 }
@@ -587,6 +718,7 @@ void RenderingContext::setDepthBuffer(const DepthBufferParameters & p) {
 }
 
 void RenderingContext::clearDepth(float clearValue) {
+	flushTransientGeometry();
 #ifdef LIB_GLESv2
 	glClearDepthf(clearValue);
 #else
@@ -666,6 +798,7 @@ void RenderingContext::popBoundImage(uint8_t unit){
 
 //! \note the texture in iParam may be null to unbind
 void RenderingContext::setBoundImage(uint8_t unit, const ImageBindParameters& iParam){
+	flushTransientGeometry();
 	assertCorrectImageUnit(unit);
 	internalData->boundImages[unit] = iParam;
 #if defined(GL_ARB_shader_image_load_store)
@@ -909,6 +1042,7 @@ static const Uniform::UniformName UNIFORM_SG_SCISSOR_RECT("sg_scissorRect");
 static const Uniform::UniformName UNIFORM_SG_SCISSOR_ENABLED("sg_scissorEnabled");
 
 void RenderingContext::setScissor(const ScissorParameters & scissorParameters) {
+	flushTransientGeometry();
 	internalData->currentScissorParameters = scissorParameters;
 
 	if(internalData->currentScissorParameters.isEnabled()) {
@@ -959,6 +1093,7 @@ void RenderingContext::setStencil(const StencilParameters & stencilParameter) {
 }
 
 void RenderingContext::clearStencil(int32_t clearValue) {
+	flushTransientGeometry();
 	glClearStencil(clearValue);
 	glClear(GL_STENCIL_BUFFER_BIT);
 }
@@ -991,6 +1126,7 @@ void RenderingContext::setFBO(FBO * fbo) {
 	FBO * lastActiveFBO = getActiveFBO();
 	if(fbo == lastActiveFBO)
 		return;
+	flushTransientGeometry();
 	if(fbo == nullptr) {
 		FBO::_disable();
 	} else {
@@ -1001,6 +1137,7 @@ void RenderingContext::setFBO(FBO * fbo) {
 
 // GLOBAL UNIFORMS ***************************************************************************
 void RenderingContext::setGlobalUniform(const Uniform & u) {
+	flushTransientGeometry();
 	internalData->globalUniforms.setUniform(u, false, false);
 	if(immediate)
 		applyChanges();	
@@ -1096,6 +1233,7 @@ void RenderingContext::dispatchComputeIndirect(size_t offset) {
 }
 
 void RenderingContext::loadUniformSubroutines(uint32_t shaderStage, const std::vector<uint32_t>& indices) {
+	flushTransientGeometry();
 	#if defined(LIB_GL) and defined(GL_ARB_shader_subroutine)
 		if(!getActiveShader()) {
 			WARN("loadUniformSubroutines: There is no active shader.");
@@ -1122,6 +1260,7 @@ void RenderingContext::loadUniformSubroutines(uint32_t shaderStage, const std::v
 }
 
 void RenderingContext::_setUniformOnShader(Shader * shader, const Uniform & uniform, bool warnIfUnused, bool forced) {
+	flushTransientGeometry();
 	shader->_getUniformRegistry()->setUniform(uniform, warnIfUnused, forced);
 	if(immediate && getActiveShader() == shader)
 		shader->applyUniforms(false); // forced is false here, as this forced means to re-apply all uniforms
@@ -1223,6 +1362,7 @@ void RenderingContext::pushTransformFeedbackBufferStatus(){
 	internalData->feedbackStack.emplace(internalData->activeFeedbackStatus);
 }
 void RenderingContext::setTransformFeedbackBuffer(CountedBufferObject * buffer){
+	flushTransientGeometry();
 	if(requestTransformFeedbackSupport()){
 		#if defined(LIB_GL) and defined(GL_EXT_transform_feedback)
 		if(buffer!=nullptr){
@@ -1433,6 +1573,7 @@ void RenderingContext::pushViewport() {
 	internalData->viewportStack.emplace(internalData->currentViewport);
 }
 void RenderingContext::setViewport(const Geometry::Rect_i & viewport) {
+	flushTransientGeometry();
 	internalData->currentViewport = viewport;
 	glViewport(internalData->currentViewport.getX(), internalData->currentViewport.getY(), internalData->currentViewport.getWidth(), internalData->currentViewport.getHeight());
 
@@ -51,9 +51,11 @@ class ScissorParameters;
 class StencilParameters;
 class Shader;
 class Texture;
+class TransientGeometryBuffer;
 class Uniform;
 class UniformRegistry;
 class VertexAttribute;
+class VertexDescription;
 enum class TexUnitUsageParameter : uint8_t;
 
 typedef Util::CountedObjectWrapper<BufferObject> CountedBufferObject;
@@ -97,11 +99,75 @@ public:
 		return compabilityMode;
 	}
 
+	/*! If enabled, the sg-uniforms (matrices, lights, material and point size) of shaders declaring the uniform block
+		sg_UniformBlock are uploaded as one std140 uniform buffer range per draw call instead of being set one by one.
+		The block is bound to Shader::SG_UNIFORM_BLOCK_BINDING and has to be declared as follows:
+		\code
+		struct sg_LightSourceParameters {
+			vec3 position; int type; vec3 direction; float constant;
+			float linear; float quadratic; float exponent; float cosCutoff;
+			vec4 ambient; vec4 diffuse; vec4 specular;
+		};
+		struct sg_MaterialParameters {
+			vec4 ambient; vec4 diffuse; vec4 specular; vec4 emission; float shininess;
+		};
+		layout(std140) uniform sg_UniformBlock {
+			mat4 sg_matrix_modelToCamera;
+			mat4 sg_matrix_cameraToClipping;
+			mat4 sg_matrix_modelToClipping;
+			mat4 sg_matrix_worldToCamera;
+			mat4 sg_matrix_cameraToWorld;
+			mat4 sg_matrix_clippingToCamera;
+			sg_MaterialParameters sg_Material;
+			int sg_useMaterials;
+			int sg_lightCount;
+			float sg_pointSize;
+			sg_LightSourceParameters sg_LightSource[8];
+		};
+		\endcode
+		The deprecated matrix names (e.g. sg_modelViewMatrix) are not available in the block. Shaders without the block
+		still receive the sg-uniforms individually. */
+	void setSGUniformBlockEnabled(bool enabled);
+	bool isSGUniformBlockEnabled() const;
+
 	void applyChanges(bool forced = false);
 	//	@}
 
 	// -----------------------------------
 
+	/*!	@name Transient geometry */
+	//	@{
+	/*! Draw geometry that is used only once (e.g. by the functions in Draw.h) without creating a Mesh.
+		The vertices and indices are copied into the context's TransientGeometryBuffer and drawn with the current state.
+		By default, the geometry is drawn immediately. Between beginTransientGeometryBatch() and
+		endTransientGeometryBatch(), the geometry is drawn later, so that consecutive calls with the same state, vertex
+		description and draw mode are drawn with one draw call. The pending geometry is then drawn when the state differs
+		at the next call, before any other draw call (applyChanges()), before changes taking effect immediately (e.g.
+		setFBO(), setViewport(), clearScreenRect() or setting uniforms), by flushTransientGeometry() and at the end of the
+		batch.
+		@param drawMode One of GL_POINTS, GL_LINES or GL_TRIANGLES
+		@param indices Indices of the vertices, starting with 0 for the first vertex
+		\note Inside a batch, flushTransientGeometry() has to be called before reading back or clearing the frame buffer
+			without the context (e.g. createTextureFromScreen(), readDepthValue(), PBO::asyncReadPixels(), clearScreen())
+			and before swapping the buffers.
+		\note In immediate mode, every state change draws the pending geometry. */
+	void displayTransientGeometry(const VertexDescription & vd, uint32_t drawMode, const uint8_t * vertices, uint32_t vertexCount,
+								  const uint32_t * indices, uint32_t indexCount);
+	//! Draw the pending transient geometry.
+	void flushTransientGeometry();
+	/*! Collect the geometry of the following calls of displayTransientGeometry() until the matching call of
+		endTransientGeometryBatch(). Batches can be nested; only the outermost batch draws the geometry at its end. */
+	void beginTransientGeometryBatch();
+	//! End a batch started by beginTransientGeometryBatch() and draw the pending transient geometry.
+	void endTransientGeometryBatch();
+	//! Return true if the context is between beginTransientGeometryBatch() and endTransientGeometryBatch().
+	bool isBatchingTransientGeometry() const;
+	//! The buffer used by displayTransientGeometry() (e.g. for its statistics).
+	TransientGeometryBuffer & getTransientGeometryBuffer();
+	//	@}
+
+	// -----------------------------------
+
 	/*!	@name GL Helper */
 	//	@{
 	static void clearScreen(const Util::Color4f & color);
@@ -12,61 +12,113 @@
 #include "RenderingStatus.h"
 #include "../../Shader/Shader.h"
 #include "../../Shader/UniformRegistry.h"
+#include "../../GLHeader.h"
+#include <algorithm>
+#include <cstring>
 
 namespace Rendering {
 namespace StatusHandler_sgUniforms{
 
-typedef std::vector<Uniform::UniformName> UniformNameArray_t;
+//! (internal) Name of an sg-uniform and its slot in the UniformRegistry of every shader.
+struct SlotName {
+	Uniform::UniformName name;
+	uint32_t slot;
+};
+static uint32_t slotCount = 0;
+
+//! (internal)
+static SlotName createSlot(const std::string & name) {
+	return {Uniform::UniformName(name), slotCount++};
+}
+
+typedef std::vector<SlotName> SlotNameArray_t;
 //! (internal)
-static UniformNameArray_t createNames(const std::string & prefix, uint8_t number, const std::string & postfix) {
-	UniformNameArray_t arr;
+static SlotNameArray_t createSlots(const std::string & prefix, uint8_t number, const std::string & postfix) {
+	SlotNameArray_t arr;
 	arr.reserve(number);
 	for(uint_fast8_t i = 0; i < number; ++i) {
-		arr.emplace_back(prefix + static_cast<char>('0' + i) + postfix);
+		arr.emplace_back(createSlot(prefix + static_cast<char>('0' + i) + postfix));
 	}
 	return arr;
 }
 
-static const Uniform::UniformName UNIFORM_SG_MATRIX_MODEL_TO_CAMERA("sg_matrix_modelToCamera");
-static const Uniform::UniformName UNIFORM_SG_MATRIX_MODEL_TO_CAMERA_OLD("sg_modelViewMatrix");
-static const Uniform::UniformName UNIFORM_SG_MATRIX_CAMERA_TO_CLIPPING("sg_matrix_cameraToClipping");
-static const Uniform::UniformName UNIFORM_SG_MATRIX_CAMERA_TO_CLIPPING_OLD("sg_projectionMatrix");
-static const Uniform::UniformName UNIFORM_SG_MATRIX_MODEL_TO_CLIPPING("sg_matrix_modelToClipping");
-static const Uniform::UniformName UNIFORM_SG_MATRIX_MODEL_TO_CLIPPING_OLD("sg_modelViewProjectionMatrix");
-static const Uniform::UniformName UNIFORM_SG_MATRIX_WORLD_TO_CAMERA("sg_matrix_worldToCamera");
-static const Uniform::UniformName UNIFORM_SG_MATRIX_WORLD_TO_CAMERA_OLD("sg_cameraMatrix");
-static const Uniform::UniformName UNIFORM_SG_MATRIX_CAMERA_TO_WORLD("sg_matrix_cameraToWorld");
-static const Uniform::UniformName UNIFORM_SG_MATRIX_CAMERA_TO_WORLD_OLD("sg_cameraInverseMatrix");
-static const Uniform::UniformName UNIFORM_SG_MATRIX_CLIPPING_TO_CAMERA("sg_matrix_clippingToCamera");
-
-static const Uniform::UniformName UNIFORM_SG_LIGHT_COUNT("sg_lightCount");
-static const Uniform::UniformName UNIFORM_SG_POINT_SIZE("sg_pointSize");
-
-static const UniformNameArray_t UNIFORM_SG_LIGHT_SOURCES_POSITION(createNames("sg_LightSource[", RenderingStatus::MAX_LIGHTS, "].position"));
-static const UniformNameArray_t UNIFORM_SG_LIGHT_SOURCES_DIRECTION(createNames("sg_LightSource[", RenderingStatus::MAX_LIGHTS, "].direction"));
-static const UniformNameArray_t UNIFORM_SG_LIGHT_SOURCES_TYPE(createNames("sg_LightSource[", RenderingStatus::MAX_LIGHTS, "].type"));
-static const UniformNameArray_t UNIFORM_SG_LIGHT_SOURCES_CONSTANT(createNames("sg_LightSource[", RenderingStatus::MAX_LIGHTS, "].constant"));
-static const UniformNameArray_t UNIFORM_SG_LIGHT_SOURCES_LINEAR(createNames("sg_LightSource[", RenderingStatus::MAX_LIGHTS, "].linear"));
-static const UniformNameArray_t UNIFORM_SG_LIGHT_SOURCES_QUADRATIC(createNames("sg_LightSource[", RenderingStatus::MAX_LIGHTS, "].quadratic"));
-static const UniformNameArray_t UNIFORM_SG_LIGHT_SOURCES_AMBIENT(createNames("sg_LightSource[", RenderingStatus::MAX_LIGHTS, "].ambient"));
-static const UniformNameArray_t UNIFORM_SG_LIGHT_SOURCES_DIFFUSE(createNames("sg_LightSource[", RenderingStatus::MAX_LIGHTS, "].diffuse"));
-static const UniformNameArray_t UNIFORM_SG_LIGHT_SOURCES_SPECULAR(createNames("sg_LightSource[", RenderingStatus::MAX_LIGHTS, "].specular"));
-static const UniformNameArray_t UNIFORM_SG_LIGHT_SOURCES_EXPONENT(createNames("sg_LightSource[", RenderingStatus::MAX_LIGHTS, "].exponent"));
-static const UniformNameArray_t UNIFORM_SG_LIGHT_SOURCES_COSCUTOFF(createNames("sg_LightSource[", RenderingStatus::MAX_LIGHTS, "].cosCutoff"));
-
-static const Uniform::UniformName UNIFORM_SG_TEXTURE_ENABLED("sg_textureEnabled");
-static const UniformNameArray_t UNIFORM_SG_TEXTURES(createNames("sg_texture", MAX_TEXTURES, ""));
-static const Uniform::UniformName UNIFORM_SG_USE_MATERIALS("sg_useMaterials");
-static const Uniform::UniformName UNIFORM_SG_MATERIAL_AMBIENT("sg_Material.ambient");
-static const Uniform::UniformName UNIFORM_SG_MATERIAL_DIFFUSE("sg_Material.diffuse");
-static const Uniform::UniformName UNIFORM_SG_MATERIAL_SPECULAR("sg_Material.specular");
-static const Uniform::UniformName UNIFORM_SG_MATERIAL_EMISSION("sg_Material.emission");
-static const Uniform::UniformName UNIFORM_SG_MATERIAL_SHININESS("sg_Material.shininess");
+static const SlotName UNIFORM_SG_MATRIX_MODEL_TO_CAMERA(createSlot("sg_matrix_modelToCamera"));
+static const SlotName UNIFORM_SG_MATRIX_MODEL_TO_CAMERA_OLD(createSlot("sg_modelViewMatrix"));
+static const SlotName UNIFORM_SG_MATRIX_CAMERA_TO_CLIPPING(createSlot("sg_matrix_cameraToClipping"));
+static const SlotName UNIFORM_SG_MATRIX_CAMERA_TO_CLIPPING_OLD(createSlot("sg_projectionMatrix"));
+static const SlotName UNIFORM_SG_MATRIX_MODEL_TO_CLIPPING(createSlot("sg_matrix_modelToClipping"));
+static const SlotName UNIFORM_SG_MATRIX_MODEL_TO_CLIPPING_OLD(createSlot("sg_modelViewProjectionMatrix"));
+static const SlotName UNIFORM_SG_MATRIX_WORLD_TO_CAMERA(createSlot("sg_matrix_worldToCamera"));
+static const SlotName UNIFORM_SG_MATRIX_WORLD_TO_CAMERA_OLD(createSlot("sg_cameraMatrix"));
+static const SlotName UNIFORM_SG_MATRIX_CAMERA_TO_WORLD(createSlot("sg_matrix_cameraToWorld"));
+static const SlotName UNIFORM_SG_MATRIX_CAMERA_TO_WORLD_OLD(createSlot("sg_cameraInverseMatrix"));
+static const SlotName UNIFORM_SG_MATRIX_CLIPPING_TO_CAMERA(createSlot("sg_matrix_clippingToCamera"));
+
+static const SlotName UNIFORM_SG_LIGHT_COUNT(createSlot("sg_lightCount"));
+static const SlotName UNIFORM_SG_POINT_SIZE(createSlot("sg_pointSize"));
+
+static const SlotNameArray_t UNIFORM_SG_LIGHT_SOURCES_POSITION(createSlots("sg_LightSource[", RenderingStatus::MAX_LIGHTS, "].position"));
+static const SlotNameArray_t UNIFORM_SG_LIGHT_SOURCES_DIRECTION(createSlots("sg_LightSource[", RenderingStatus::MAX_LIGHTS, "].direction"));
+static const SlotNameArray_t UNIFORM_SG_LIGHT_SOURCES_TYPE(createSlots("sg_LightSource[", RenderingStatus::MAX_LIGHTS, "].type"));
+static const SlotNameArray_t UNIFORM_SG_LIGHT_SOURCES_CONSTANT(createSlots("sg_LightSource[", RenderingStatus::MAX_LIGHTS, "].constant"));
+static const SlotNameArray_t UNIFORM_SG_LIGHT_SOURCES_LINEAR(createSlots("sg_LightSource[", RenderingStatus::MAX_LIGHTS, "].linear"));
+static const SlotNameArray_t UNIFORM_SG_LIGHT_SOURCES_QUADRATIC(createSlots("sg_LightSource[", RenderingStatus::MAX_LIGHTS, "].quadratic"));
+static const SlotNameArray_t UNIFORM_SG_LIGHT_SOURCES_AMBIENT(createSlots("sg_LightSource[", RenderingStatus::MAX_LIGHTS, "].ambient"));
+static const SlotNameArray_t UNIFORM_SG_LIGHT_SOURCES_DIFFUSE(createSlots("sg_LightSource[", RenderingStatus::MAX_LIGHTS, "].diffuse"));
+static const SlotNameArray_t UNIFORM_SG_LIGHT_SOURCES_SPECULAR(createSlots("sg_LightSource[", RenderingStatus::MAX_LIGHTS, "].specular"));
+static const SlotNameArray_t UNIFORM_SG_LIGHT_SOURCES_EXPONENT(createSlots("sg_LightSource[", RenderingStatus::MAX_LIGHTS, "].exponent"));
+static const SlotNameArray_t UNIFORM_SG_LIGHT_SOURCES_COSCUTOFF(createSlots("sg_LightSource[", RenderingStatus::MAX_LIGHTS, "].cosCutoff"));
+
+static const SlotName UNIFORM_SG_TEXTURE_ENABLED(createSlot("sg_textureEnabled"));
+static const SlotNameArray_t UNIFORM_SG_TEXTURES(createSlots("sg_texture", MAX_TEXTURES, ""));
+static const SlotName UNIFORM_SG_USE_MATERIALS(createSlot("sg_useMaterials"));
+static const SlotName UNIFORM_SG_MATERIAL_AMBIENT(createSlot("sg_Material.ambient"));
+static const SlotName UNIFORM_SG_MATERIAL_DIFFUSE(createSlot("sg_Material.diffuse"));
+static const SlotName UNIFORM_SG_MATERIAL_SPECULAR(createSlot("sg_Material.specular"));
+static const SlotName UNIFORM_SG_MATERIAL_EMISSION(createSlot("sg_Material.emission"));
+static const SlotName UNIFORM_SG_MATERIAL_SHININESS(createSlot("sg_Material.shininess"));
+
+//! (internal) Set the value of an sg-uniform; the uniform is created in place and holds its value inline.
+template<typename value_t>
+static void setUniform(UniformRegistry & registry, const SlotName & slotName, const value_t & value, bool forced) {
+	registry.setSlotUniform(slotName.slot, Uniform(slotName.name, value), false, forced);
+}
+
+//! (internal)
+static void setLightUniforms(UniformRegistry & registry, uint_fast8_t i, const LightParameters & params, const RenderingStatus & actual, bool forced) {
+	setUniform(registry, UNIFORM_SG_LIGHT_SOURCES_POSITION[i], actual.getMatrix_worldToCamera().transformPosition(params.position), forced);
+	setUniform(registry, UNIFORM_SG_LIGHT_SOURCES_DIRECTION[i], actual.getMatrix_worldToCamera().transformDirection(params.direction), forced);
+	setUniform(registry, UNIFORM_SG_LIGHT_SOURCES_TYPE[i], static_cast<int32_t> (params.type), forced);
+	setUniform(registry, UNIFORM_SG_LIGHT_SOURCES_CONSTANT[i], params.constant, forced);
+	setUniform(registry, UNIFORM_SG_LIGHT_SOURCES_LINEAR[i], params.linear, forced);
+	setUniform(registry, UNIFORM_SG_LIGHT_SOURCES_QUADRATIC[i], params.quadratic, forced);
+	setUniform(registry, UNIFORM_SG_LIGHT_SOURCES_AMBIENT[i], params.ambient, forced);
+	setUniform(registry, UNIFORM_SG_LIGHT_SOURCES_DIFFUSE[i], params.diffuse, forced);
+	setUniform(registry, UNIFORM_SG_LIGHT_SOURCES_SPECULAR[i], params.specular, forced);
+	setUniform(registry, UNIFORM_SG_LIGHT_SOURCES_EXPONENT[i], params.exponent, forced);
+	setUniform(registry, UNIFORM_SG_LIGHT_SOURCES_COSCUTOFF[i], params.cosCutoff, forced);
+}
+
+//! (internal)
+static void applyTextureUnits(UniformRegistry & registry, RenderingStatus & target, const RenderingStatus & actual, bool forced) {
+	if (forced || target.textureUnitsChanged(actual)) {
+		int32_t textureUnitsUsedForRendering[MAX_TEXTURES]; // bool uniforms are stored as int32_t
+		for(uint_fast8_t unit = 0; unit < MAX_TEXTURES; ++unit) {
+			const TexUnitUsageParameter usage = actual.getTextureUnitParams(unit).first;
+			textureUnitsUsedForRendering[unit] = (usage != TexUnitUsageParameter::GENERAL_PURPOSE && usage!=TexUnitUsageParameter::DISABLED) ? 1 : 0;
+
+			// for each shader, this is only necessary once...
+			setUniform(registry, UNIFORM_SG_TEXTURES[unit], static_cast<int32_t>(unit), forced);
+		}
+		registry.setSlotUniform(UNIFORM_SG_TEXTURE_ENABLED.slot, Uniform(UNIFORM_SG_TEXTURE_ENABLED.name, Uniform::UNIFORM_BOOL, MAX_TEXTURES,
+										reinterpret_cast<const uint8_t *>(textureUnitsUsedForRendering)), false, forced);
+		target.updateTextureUnits(actual);
+	}
+}
 
 void apply(RenderingStatus & target, const RenderingStatus & actual, bool forced){
 
-	Shader * shader = target.getShader();
-	std::deque<Uniform> uniforms;
+	UniformRegistry & registry = *target.getShader()->_getUniformRegistry();
 
 	// camera  & inverse
 	bool cc = false;
@@ -74,11 +126,11 @@ void apply(RenderingStatus & target, const RenderingStatus & actual, bool forced
 		cc = true;
 		target.updateMatrix_cameraToWorld(actual);
 
-		uniforms.emplace_back(UNIFORM_SG_MATRIX_WORLD_TO_CAMERA, actual.getMatrix_worldToCamera());
-		uniforms.emplace_back(UNIFORM_SG_MATRIX_CAMERA_TO_WORLD, actual.getMatrix_cameraToWorld());
+		setUniform(registry, UNIFORM_SG_MATRIX_WORLD_TO_CAMERA, actual.getMatrix_worldToCamera(), forced);
+		setUniform(registry, UNIFORM_SG_MATRIX_CAMERA_TO_WORLD, actual.getMatrix_cameraToWorld(), forced);
 
-		uniforms.emplace_back(UNIFORM_SG_MATRIX_WORLD_TO_CAMERA_OLD, actual.getMatrix_worldToCamera());
-		uniforms.emplace_back(UNIFORM_SG_MATRIX_CAMERA_TO_WORLD_OLD, actual.getMatrix_cameraToWorld());
+		setUniform(registry, UNIFORM_SG_MATRIX_WORLD_TO_CAMERA_OLD, actual.getMatrix_worldToCamera(), forced);
+		setUniform(registry, UNIFORM_SG_MATRIX_CAMERA_TO_WORLD_OLD, actual.getMatrix_cameraToWorld(), forced);
 	}
 
 	// lights
@@ -86,43 +138,21 @@ void apply(RenderingStatus & target, const RenderingStatus & actual, bool forced
 
 		target.updateLights(actual);
 
-		uniforms.emplace_back(UNIFORM_SG_LIGHT_COUNT, static_cast<int> (actual.getNumEnabledLights()));
+		setUniform(registry, UNIFORM_SG_LIGHT_COUNT, static_cast<int32_t> (actual.getNumEnabledLights()), forced);
 
 		const uint_fast8_t numEnabledLights = actual.getNumEnabledLights();
 		for (uint_fast8_t i = 0; i < numEnabledLights; ++i) {
 			const LightParameters & params = actual.getEnabledLight(i);
 
 			target.updateLightParameter(i, params);
-
-			uniforms.emplace_back(UNIFORM_SG_LIGHT_SOURCES_POSITION[i], actual.getMatrix_worldToCamera().transformPosition(params.position) );
-			uniforms.emplace_back(UNIFORM_SG_LIGHT_SOURCES_DIRECTION[i], actual.getMatrix_worldToCamera().transformDirection(params.direction) );
-			uniforms.emplace_back(UNIFORM_SG_LIGHT_SOURCES_TYPE[i], static_cast<int> (params.type));
-			uniforms.emplace_back(UNIFORM_SG_LIGHT_SOURCES_CONSTANT[i], params.constant);
-			uniforms.emplace_back(UNIFORM_SG_LIGHT_SOURCES_LINEAR[i], params.linear);
-			uniforms.emplace_back(UNIFORM_SG_LIGHT_SOURCES_QUADRATIC[i], params.quadratic);
-			uniforms.emplace_back(UNIFORM_SG_LIGHT_SOURCES_AMBIENT[i], params.ambient);
-			uniforms.emplace_back(UNIFORM_SG_LIGHT_SOURCES_DIFFUSE[i], params.diffuse);
-			uniforms.emplace_back(UNIFORM_SG_LIGHT_SOURCES_SPECULAR[i], params.specular);
-			uniforms.emplace_back(UNIFORM_SG_LIGHT_SOURCES_EXPONENT[i], params.exponent);
-			uniforms.emplace_back(UNIFORM_SG_LIGHT_SOURCES_COSCUTOFF[i], params.cosCutoff);
+			setLightUniforms(registry, i, params, actual, forced);
 		}
 
 		if (forced) { // reset all non-enabled light values
 			LightParameters params;
 			for (uint_fast8_t i = numEnabledLights; i < RenderingStatus::MAX_LIGHTS; ++i) {
 				target.updateLightParameter(i, params);
-
-				uniforms.emplace_back(UNIFORM_SG_LIGHT_SOURCES_POSITION[i], actual.getMatrix_worldToCamera().transformPosition(params.position) );
-				uniforms.emplace_back(UNIFORM_SG_LIGHT_SOURCES_DIRECTION[i], actual.getMatrix_worldToCamera().transformDirection(params.direction) );
-				uniforms.emplace_back(UNIFORM_SG_LIGHT_SOURCES_TYPE[i], static_cast<int> (params.type));
-				uniforms.emplace_back(UNIFORM_SG_LIGHT_SOURCES_CONSTANT[i], params.constant);
-				uniforms.emplace_back(UNIFORM_SG_LIGHT_SOURCES_LINEAR[i], params.linear);
-				uniforms.emplace_back(UNIFORM_SG_LIGHT_SOURCES_QUADRATIC[i], params.quadratic);
-				uniforms.emplace_back(UNIFORM_SG_LIGHT_SOURCES_AMBIENT[i], params.ambient);
-				uniforms.emplace_back(UNIFORM_SG_LIGHT_SOURCES_DIFFUSE[i], params.diffuse);
-				uniforms.emplace_back(UNIFORM_SG_LIGHT_SOURCES_SPECULAR[i], params.specular);
-				uniforms.emplace_back(UNIFORM_SG_LIGHT_SOURCES_EXPONENT[i], params.exponent);
-				uniforms.emplace_back(UNIFORM_SG_LIGHT_SOURCES_COSCUTOFF[i], params.cosCutoff);
+				setLightUniforms(registry, i, params, actual, forced);
 			}
 		}
 	}
@@ -131,14 +161,14 @@ void apply(RenderingStatus & target, const RenderingStatus & actual, bool forced
 	if (forced || target.materialChanged(actual)) {
 		target.updateMaterial(actual);
 
-		uniforms.emplace_back(UNIFORM_SG_USE_MATERIALS, actual.isMaterialEnabled());
+		setUniform(registry, UNIFORM_SG_USE_MATERIALS, actual.isMaterialEnabled(), forced);
 		if (forced || actual.isMaterialEnabled()) {
 			const MaterialParameters & material = actual.getMaterialParameters();
-			uniforms.emplace_back(UNIFORM_SG_MATERIAL_AMBIENT, material.getAmbient());
-			uniforms.emplace_back(UNIFORM_SG_MATERIAL_DIFFUSE, material.getDiffuse());
-			uniforms.emplace_back(UNIFORM_SG_MATERIAL_SPECULAR, material.getSpecular());
-			uniforms.emplace_back(UNIFORM_SG_MATERIAL_EMISSION, material.getEmission());
-			uniforms.emplace_back(UNIFORM_SG_MATERIAL_SHININESS, material.getShininess());
+			setUniform(registry, UNIFORM_SG_MATERIAL_AMBIENT, material.getAmbient(), forced);
+			setUniform(registry, UNIFORM_SG_MATERIAL_DIFFUSE, material.getDiffuse(), forced);
+			setUniform(registry, UNIFORM_SG_MATERIAL_SPECULAR, material.getSpecular(), forced);
+			setUniform(registry, UNIFORM_SG_MATERIAL_EMISSION, material.getEmission(), forced);
+			setUniform(registry, UNIFORM_SG_MATERIAL_SHININESS, material.getShininess(), forced);
 		}
 	}
 
@@ -150,47 +180,132 @@ void apply(RenderingStatus & target, const RenderingStatus & actual, bool forced
 		if (forced || target.matrix_modelToCameraChanged(actual)) {
 			mc = true;
 			target.updateModelViewMatrix(actual);
-			uniforms.emplace_back(UNIFORM_SG_MATRIX_MODEL_TO_CAMERA, actual.getMatrix_modelToCamera());
-			uniforms.emplace_back(UNIFORM_SG_MATRIX_MODEL_TO_CAMERA_OLD, actual.getMatrix_modelToCamera());
+			setUniform(registry, UNIFORM_SG_MATRIX_MODEL_TO_CAMERA, actual.getMatrix_modelToCamera(), forced);
+			setUniform(registry, UNIFORM_SG_MATRIX_MODEL_TO_CAMERA_OLD, actual.getMatrix_modelToCamera(), forced);
 		}
 
 		if (forced || target.matrix_cameraToClipChanged(actual)) {
 			pc = true;
 			target.updateMatrix_cameraToClipping(actual);
-			uniforms.emplace_back(UNIFORM_SG_MATRIX_CAMERA_TO_CLIPPING, actual.getMatrix_cameraToClipping());
-			uniforms.emplace_back(UNIFORM_SG_MATRIX_CAMERA_TO_CLIPPING_OLD, actual.getMatrix_cameraToClipping());
-			uniforms.emplace_back(UNIFORM_SG_MATRIX_CLIPPING_TO_CAMERA, actual.getMatrix_cameraToClipping().inverse());
+			setUniform(registry, UNIFORM_SG_MATRIX_CAMERA_TO_CLIPPING, actual.getMatrix_cameraToClipping(), forced);
+			setUniform(registry, UNIFORM_SG_MATRIX_CAMERA_TO_CLIPPING_OLD, actual.getMatrix_cameraToClipping(), forced);
+			setUniform(registry, UNIFORM_SG_MATRIX_CLIPPING_TO_CAMERA, actual.getMatrix_cameraToClipping().inverse(), forced);
 		}
 		if (forced || pc || mc) {
 			const auto m = actual.getMatrix_cameraToClipping() * actual.getMatrix_modelToCamera();
-			uniforms.emplace_back(UNIFORM_SG_MATRIX_MODEL_TO_CLIPPING, m);
-			uniforms.emplace_back(UNIFORM_SG_MATRIX_MODEL_TO_CLIPPING_OLD, m);
+			setUniform(registry, UNIFORM_SG_MATRIX_MODEL_TO_CLIPPING, m, forced);
+			setUniform(registry, UNIFORM_SG_MATRIX_MODEL_TO_CLIPPING_OLD, m, forced);
 		}
 	}
 
 	// Point
 	if(forced || target.pointParametersChanged(actual)) {
 		target.setPointParameters(actual.getPointParameters());
-		uniforms.emplace_back(UNIFORM_SG_POINT_SIZE, actual.getPointParameters().getSize());
+		setUniform(registry, UNIFORM_SG_POINT_SIZE, actual.getPointParameters().getSize(), forced);
 	}
 
 	// TEXTURE UNITS
-	if (forced || target.textureUnitsChanged(actual)) {
-		std::deque<bool> textureUnitsUsedForRendering;
-		for(uint_fast8_t unit = 0; unit < MAX_TEXTURES; ++unit) {
-			const TexUnitUsageParameter usage = actual.getTextureUnitParams(unit).first;
-			textureUnitsUsedForRendering.emplace_back(usage != TexUnitUsageParameter::GENERAL_PURPOSE && usage!=TexUnitUsageParameter::DISABLED);
+	applyTextureUnits(registry, target, actual, forced);
+}
 
-			// for each shader, this is only necessary once...
-			uniforms.emplace_back(UNIFORM_SG_TEXTURES[unit], static_cast<int32_t>(unit));
-		}
-		uniforms.emplace_back(UNIFORM_SG_TEXTURE_ENABLED, textureUnitsUsedForRendering);
-		target.updateTextureUnits(actual);
+// ------------------------------------------------------------------------------------------------
+// uniform block
+
+static_assert(sizeof(UniformBlock::Light) == 96, "UniformBlock::Light does not match the std140 layout.");
+static_assert(sizeof(UniformBlock) == 480 + RenderingStatus::MAX_LIGHTS * 96, "UniformBlock does not match the std140 layout.");
+
+//! (internal) Store the matrix column major.
+static void copyMatrix(const Geometry::Matrix4x4 & matrix, float * target) {
+	const Geometry::Matrix4x4 transposed = matrix.getTransposed();
+	std::copy(transposed.getData(), transposed.getData() + 16, target);
+}
+
+//! (internal)
+static void copyColor(const Util::Color4f & color, float * target) {
+	std::copy(color.data(), color.data() + 4, target);
+}
+
+//! (internal)
+static void copyLight(const LightParameters & params, const RenderingStatus & actual, UniformBlock::Light & light) {
+	const Geometry::Vec3 position = actual.getMatrix_worldToCamera().transformPosition(params.position);
+	const Geometry::Vec3 direction = actual.getMatrix_worldToCamera().transformDirection(params.direction);
+	std::copy(position.getVec(), position.getVec() + 3, light.position);
+	light.type = static_cast<int32_t>(params.type);
+	std::copy(direction.getVec(), direction.getVec() + 3, light.direction);
+	light.constant = params.constant;
+	light.linear = params.linear;
+	light.quadratic = params.quadratic;
+	light.exponent = params.exponent;
+	light.cosCutoff = params.cosCutoff;
+	copyColor(params.ambient, light.ambient);
+	copyColor(params.diffuse, light.diffuse);
+	copyColor(params.specular, light.specular);
+}
+
+const Geometry::Matrix4x4 & UniformBlockBuffer::getClippingToCamera(const Geometry::Matrix4x4 & cameraToClipping) {
+	if(!hasInverse || cameraToClipping != lastCameraToClipping) {
+		lastCameraToClipping = cameraToClipping;
+		clippingToCamera = cameraToClipping.inverse();
+		hasInverse = true;
 	}
+	return clippingToCamera;
+}
 
-	for(const auto & uniform : uniforms) {
-		shader->_getUniformRegistry()->setUniform(uniform, false, forced);
+void UniformBlockBuffer::upload(const UniformBlock & block, bool forced) {
+	if(!forced && hasLastBlock && std::memcmp(&block, &lastBlock, sizeof(UniformBlock)) == 0)
+		return;
+	if(stride == 0) {
+		GLint alignment = 256;
+		glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+		const uint32_t align = static_cast<uint32_t>(std::max(alignment, 1));
+		stride = ((static_cast<uint32_t>(sizeof(UniformBlock)) + align - 1) / align) * align;
+	}
+	if(nextRange == 0 || nextRange == capacity) {
+		// orphan the buffer; ranges still used by pending draw calls stay valid
+		buffer.allocateData<uint8_t>(GL_UNIFORM_BUFFER, static_cast<size_t>(stride) * capacity, GL_STREAM_DRAW);
+		nextRange = 0;
 	}
+	const uint32_t offset = nextRange * stride;
+	buffer.uploadSubData(GL_UNIFORM_BUFFER, reinterpret_cast<const uint8_t *>(&block), sizeof(UniformBlock), offset);
+	glBindBufferRange(GL_UNIFORM_BUFFER, Shader::SG_UNIFORM_BLOCK_BINDING, buffer.getGLId(), offset, sizeof(UniformBlock));
+	++nextRange;
+	lastBlock = block;
+	hasLastBlock = true;
+}
+
+void applyBlock(RenderingStatus & target, const RenderingStatus & actual, bool forced, UniformBlockBuffer & blockBuffer){
+	// The block only depends on the actual status; changes are detected by comparing it to the last uploaded block.
+	UniformBlock block;
+	std::memset(&block, 0, sizeof(UniformBlock));
+
+	copyMatrix(actual.getMatrix_modelToCamera(), block.matrix_modelToCamera);
+	copyMatrix(actual.getMatrix_cameraToClipping(), block.matrix_cameraToClipping);
+	copyMatrix(actual.getMatrix_cameraToClipping() * actual.getMatrix_modelToCamera(), block.matrix_modelToClipping);
+	copyMatrix(actual.getMatrix_worldToCamera(), block.matrix_worldToCamera);
+	copyMatrix(actual.getMatrix_cameraToWorld(), block.matrix_cameraToWorld);
+	copyMatrix(blockBuffer.getClippingToCamera(actual.getMatrix_cameraToClipping()), block.matrix_clippingToCamera);
+
+	const MaterialParameters & material = actual.getMaterialParameters();
+	copyColor(material.getAmbient(), block.materialAmbient);
+	copyColor(material.getDiffuse(), block.materialDiffuse);
+	copyColor(material.getSpecular(), block.materialSpecular);
+	copyColor(material.getEmission(), block.materialEmission);
+	block.materialShininess = material.getShininess();
+	block.useMaterials = actual.isMaterialEnabled() ? 1 : 0;
+	block.pointSize = actual.getPointParameters().getSize();
+
+	const uint_fast8_t numEnabledLights = actual.getNumEnabledLights();
+	block.lightCount = static_cast<int32_t>(numEnabledLights);
+	for(uint_fast8_t i = 0; i < numEnabledLights; ++i)
+		copyLight(actual.getEnabledLight(i), actual, block.lights[i]);
+	const LightParameters disabledLight;
+	for(uint_fast8_t i = numEnabledLights; i < RenderingStatus::MAX_LIGHTS; ++i)
+		copyLight(disabledLight, actual, block.lights[i]);
+
+	blockBuffer.upload(block, forced);
+
+	// samplers can not be part of a uniform block
+	applyTextureUnits(*target.getShader()->_getUniformRegistry(), target, actual, forced);
 }
 
 }
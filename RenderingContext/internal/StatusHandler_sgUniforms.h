@@ -10,15 +10,82 @@
 */
 #ifndef RENDERING_STATHANDLER_SGUNI_H_
 #define RENDERING_STATHANDLER_SGUNI_H_
-namespace Rendering {
 
-class RenderingStatus;
+#include "RenderingStatus.h"
+#include "../../BufferObject.h"
+#include <Geometry/Matrix4x4.h>
+#include <cstdint>
+
+namespace Rendering {
 
 //! @internal
 namespace StatusHandler_sgUniforms{
 
 void apply(RenderingStatus & target, const RenderingStatus & actual, bool forced);
 
+/*! std140 layout of the uniform block sg_UniformBlock (see RenderingContext::setSGUniformBlockEnabled(bool)).
+	Matrices are stored column major. */
+struct UniformBlock {
+	struct Light {
+		float position[3];
+		int32_t type;
+		float direction[3];
+		float constant;
+		float linear;
+		float quadratic;
+		float exponent;
+		float cosCutoff;
+		float ambient[4];
+		float diffuse[4];
+		float specular[4];
+	};
+	float matrix_modelToCamera[16];
+	float matrix_cameraToClipping[16];
+	float matrix_modelToClipping[16];
+	float matrix_worldToCamera[16];
+	float matrix_cameraToWorld[16];
+	float matrix_clippingToCamera[16];
+	float materialAmbient[4];
+	float materialDiffuse[4];
+	float materialSpecular[4];
+	float materialEmission[4];
+	float materialShininess;
+	float padding0[3]; // a struct occupies a multiple of 16 bytes
+	int32_t useMaterials;
+	int32_t lightCount;
+	float pointSize;
+	float padding1;
+	Light lights[RenderingStatus::MAX_LIGHTS];
+};
+
+/*! Stream buffer receiving the UniformBlock of every draw call at a new range, which is then bound to
+	Shader::SG_UNIFORM_BLOCK_BINDING. The buffer is orphaned when it is full. */
+class UniformBlockBuffer {
+		BufferObject buffer;
+		uint32_t stride;
+		uint32_t capacity;
+		uint32_t nextRange;
+		bool hasLastBlock;
+		UniformBlock lastBlock;
+		bool hasInverse;
+		Geometry::Matrix4x4 lastCameraToClipping;
+		Geometry::Matrix4x4 clippingToCamera;
+	public:
+		UniformBlockBuffer() : buffer(), stride(0), capacity(256), nextRange(0), hasLastBlock(false), lastBlock(),
+				hasInverse(false), lastCameraToClipping(), clippingToCamera() {}
+
+		//! Return the inverse of @p cameraToClipping; it is only recomputed if the matrix has changed since the last call.
+		const Geometry::Matrix4x4 & getClippingToCamera(const Geometry::Matrix4x4 & cameraToClipping);
+
+		/*! Upload and bind the block; if it equals the previously uploaded block, the bound range is kept
+			unless @p forced is true. */
+		void upload(const UniformBlock & block, bool forced);
+};
+
+/*! Variant of apply(...) for shaders declaring the uniform block sg_UniformBlock: the matrices, lights, material
+	and point size are uploaded with @p blockBuffer; only the texture uniforms are set individually. */
+void applyBlock(RenderingStatus & target, const RenderingStatus & actual, bool forced, UniformBlockBuffer & blockBuffer);
+
 }
 }
 #endif /* RENDERING_STATHANDLER_SGUNI_H_ */
@@ -0,0 +1,63 @@
+/*
+	This file is part of the Rendering library.
+	Copyright (C) 2026 agent <agent@local>
+
+	This library is subject to the terms of the Mozilla Public License, v. 2.0.
+	You should have received a copy of the MPL along with this library; see the
+	file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+#include "MappedFile.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Rendering {
+namespace Serialization {
+
+std::shared_ptr<uint8_t> mapFile(const std::string & path, size_t & size) {
+#if defined(_WIN32)
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if(file == INVALID_HANDLE_VALUE)
+		return nullptr;
+	LARGE_INTEGER fileSize;
+	if(!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+		CloseHandle(file);
+		return nullptr;
+	}
+	size = static_cast<size_t>(fileSize.QuadPart);
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+	CloseHandle(file);
+	if(mapping == nullptr)
+		return nullptr;
+	void * address = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+	CloseHandle(mapping);
+	if(address == nullptr)
+		return nullptr;
+	return std::shared_ptr<uint8_t>(static_cast<uint8_t *>(address), [](uint8_t * p) { UnmapViewOfFile(p); });
+#else
+	const int fd = open(path.c_str(), O_RDONLY);
+	if(fd < 0)
+		return nullptr;
+	struct stat fileStat;
+	if(fstat(fd, &fileStat) != 0 || fileStat.st_size <= 0) {
+		close(fd);
+		return nullptr;
+	}
+	const size_t fileSize = static_cast<size_t>(fileStat.st_size);
+	void * address = mmap(nullptr, fileSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if(address == MAP_FAILED)
+		return nullptr;
+	size = fileSize;
+	return std::shared_ptr<uint8_t>(static_cast<uint8_t *>(address), [fileSize](uint8_t * p) { munmap(p, fileSize); });
+#endif
+}
+
+}
+}
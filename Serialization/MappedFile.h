@@ -0,0 +1,29 @@
+/*
+	This file is part of the Rendering library.
+	Copyright (C) 2026 agent <agent@local>
+
+	This library is subject to the terms of the Mozilla Public License, v. 2.0.
+	You should have received a copy of the MPL along with this library; see the
+	file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+#ifndef RENDERING_SERIALIZATION_MAPPEDFILE_H_
+#define RENDERING_SERIALIZATION_MAPPEDFILE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace Rendering {
+namespace Serialization {
+
+/*! (internal) Map the whole local file at @p path copy-on-write into memory: the pages can be
+	written without changing the file. The mapping is released with the last copy of the returned pointer.
+	@param size Receives the size of the file
+	@return The mapped data or nullptr if the file cannot be mapped (e.g. if it is empty) */
+std::shared_ptr<uint8_t> mapFile(const std::string & path, size_t & size);
+
+}
+}
+
+#endif /* RENDERING_SERIALIZATION_MAPPEDFILE_H_ */
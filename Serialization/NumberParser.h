@@ -0,0 +1,120 @@
+/*
+	This file is part of the Rendering library.
+	Copyright (C) 2007-2012 Benjamin Eikel <benjamin@eikel.org>
+	Copyright (C) 2007-2012 Claudius Jähn <claudius@uni-paderborn.de>
+	Copyright (C) 2007-2012 Ralf Petring <ralf@petring.net>
+	Copyright (C) 2026 agent <agent@local>
+
+	This library is subject to the terms of the Mozilla Public License, v. 2.0.
+	You should have received a copy of the MPL along with this library; see the
+	file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+#ifndef RENDERING_SERIALIZATION_NUMBERPARSER_H_
+#define RENDERING_SERIALIZATION_NUMBERPARSER_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+
+/** @file
+ * (internal) Parsing of numbers in text based file formats (used by the OBJ and XYZ streamers).
+ */
+namespace Rendering {
+namespace Serialization {
+
+inline bool isSpace(char c) {
+	return c == ' ' || c == '\t' || c == '\r';
+}
+
+inline bool isDigit(char c) {
+	return c >= '0' && c <= '9';
+}
+
+/*! Parse a decimal floating point number.
+	Faster than strtof, because it does not depend on the locale. Numbers with more than 19
+	significant digits or special values are passed to strtod. Returns the end of the number. */
+inline const char * parseFloat(const char * cursor, const char * end, float & value) {
+	static const double powersOfTen[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+										1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+	while(cursor < end && isSpace(*cursor))
+		++cursor;
+	const char * start = cursor;
+	bool negative = false;
+	if(cursor < end && (*cursor == '-' || *cursor == '+')) {
+		negative = *cursor == '-';
+		++cursor;
+	}
+	uint64_t mantissa = 0;
+	int32_t exponent = 0;
+	uint32_t digits = 0;
+	bool anyDigit = false;
+	for(; cursor < end && isDigit(*cursor); ++cursor, anyDigit = true) {
+		if(digits < 19) {
+			mantissa = mantissa * 10 + static_cast<uint64_t>(*cursor - '0');
+			digits += mantissa > 0 ? 1 : 0;
+		} else {
+			++exponent;
+		}
+	}
+	if(cursor < end && *cursor == '.') {
+		for(++cursor; cursor < end && isDigit(*cursor); ++cursor, anyDigit = true) {
+			if(digits < 19) {
+				mantissa = mantissa * 10 + static_cast<uint64_t>(*cursor - '0');
+				digits += mantissa > 0 ? 1 : 0;
+				--exponent;
+			}
+		}
+	}
+	if(!anyDigit || digits >= 19) {
+		// special values (nan, inf) or too many digits
+		char buffer[64];
+		const std::size_t length = std::min<std::size_t>(sizeof(buffer) - 1, end - start);
+		std::copy(start, start + length, buffer);
+		buffer[length] = '\0';
+		char * numberEnd = buffer;
+		value = static_cast<float>(std::strtod(buffer, &numberEnd));
+		return start + (numberEnd - buffer);
+	}
+	if(cursor < end && (*cursor == 'e' || *cursor == 'E')) {
+		const char * exponentStart = cursor++;
+		bool negativeExponent = false;
+		if(cursor < end && (*cursor == '-' || *cursor == '+')) {
+			negativeExponent = *cursor == '-';
+			++cursor;
+		}
+		if(cursor < end && isDigit(*cursor)) {
+			int32_t explicitExponent = 0;
+			for(; cursor < end && isDigit(*cursor); ++cursor)
+				explicitExponent = std::min(explicitExponent * 10 + (*cursor - '0'), 100000);
+			exponent += negativeExponent ? -explicitExponent : explicitExponent;
+		} else {
+			cursor = exponentStart;
+		}
+	}
+	double result = static_cast<double>(mantissa);
+	if(exponent >= -22 && exponent <= 22)
+		result = exponent < 0 ? result / powersOfTen[-exponent] : result * powersOfTen[exponent];
+	else
+		result *= std::pow(10.0, exponent);
+	value = static_cast<float>(negative ? -result : result);
+	return cursor;
+}
+
+/*! Parse a floating point number at @p cursor, skipping leading whitespace.
+	On success, @p cursor is moved behind the number; otherwise false is returned. */
+inline bool scanFloat(const char *& cursor, const char * end, float & value) {
+	while(cursor < end && isSpace(*cursor))
+		++cursor;
+	const char * numberEnd = parseFloat(cursor, end, value);
+	if(numberEnd == cursor)
+		return false;
+	cursor = numberEnd;
+	return true;
+}
+
+}
+}
+
+#endif /* RENDERING_SERIALIZATION_NUMBERPARSER_H_ */
@@ -95,6 +95,13 @@ Mesh * loadMesh(const Util::FileName & url) {
 	return mesh.detachAndDecrease();
 }
 
+Mesh * loadMeshMapped(const Util::FileName & url) {
+	if(url.getEnding() == StreamerMMF::fileExtension && url.getFSName() == "file") {
+		return StreamerMMF::loadMeshMapped(url);
+	}
+	return loadMesh(url);
+}
+
 Mesh * loadMesh(const std::string & extension, const std::string & data) {
 	std::unique_ptr<AbstractRenderingStreamer> loader(createStreamer(extension, AbstractRenderingStreamer::CAP_LOAD_MESH));
 	if(loader.get() == nullptr) {
@@ -68,6 +68,16 @@ extern const Util::StringIdentifier DESCRIPTION_MATERIAL_SHININESS;
  */
 Mesh * loadMesh(const Util::FileName & url);
 
+/**
+ * Load a single mesh from the given address without copying its data to the heap, if possible.
+ * Local .mmf files are memory mapped (see StreamerMMF::loadMeshMapped); other files are
+ * loaded with loadMesh(const Util::FileName &).
+ *
+ * @param file Address to the file containing the mesh data
+ * @return A single mesh
+ */
+Mesh * loadMeshMapped(const Util::FileName & url);
+
 /**
  * Create a single mesh from the given data.
  * The type of the mesh has to be given as parameter.
@@ -9,12 +9,23 @@
 	file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
 */
 #include "StreamerMMF.h"
+#include "MappedFile.h"
 #include "Serialization.h"
 #include "../Mesh/Mesh.h"
 #include "../Mesh/VertexAttributeIds.h"
 #include "../Mesh/VertexDescription.h"
+#include "../GLHeader.h"
 #include <Util/GenericAttribute.h>
+#include <Util/IO/FileName.h>
+#include <Util/References.h>
+#include <Util/StringUtils.h>
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <stdexcept>
 #include <vector>
 
 /// \todo Show compile error when using a machine without LITTLE-ENDIANness
@@ -36,29 +47,82 @@ void StreamerMMF::Reader::read(uint8_t * data,size_t count) {
 }
 
 void StreamerMMF::Reader::skip(uint32_t size) {
-	in.seekg(std::ios_base::cur+size);
+	in.seekg(size, std::ios_base::cur);
 }
 
-//!	(static)
-Mesh * StreamerMMF::loadMesh(std::istream & input) {
+uint32_t StreamerMMF::MemoryReader::read_uint32() {
+	if(remaining() < 4) {
+		valid = false;
+		cursor = end;
+		return MMF_END;
+	}
+	uint32_t x;
+	std::memcpy(&x, cursor, 4);
+	cursor += 4;
+	return x;
+}
 
-//	std::cout << "\nloadMMF...";
-	Reader reader(input);
+void StreamerMMF::MemoryReader::read(uint8_t * data,size_t count) {
+	if(remaining() < count) {
+		valid = false;
+		std::memset(data, 0, count);
+		cursor = end;
+		return;
+	}
+	std::memcpy(data, cursor, count);
+	cursor += count;
+}
 
-	uint32_t format = reader.read_uint32();
+void StreamerMMF::MemoryReader::skip(uint32_t size) {
+	if(remaining() < size) {
+		valid = false;
+		cursor = end;
+	} else {
+		cursor += size;
+	}
+}
+
+//!	(internal,static)
+template<class Reader_t>
+uint32_t StreamerMMF::readHeader(Reader_t & in) {
+	const uint32_t format = in.read_uint32();
 	if(format!=MMF_HEADER)    {
 		WARN(std::string("wrong mesh format: ") + Util::StringUtils::toString(format));
-		return nullptr;
+		return 0;
 	}
-	uint32_t version = reader.read_uint32();
-	if(version>MMF_VERSION)    {
+	const uint32_t version = in.read_uint32();
+	if(version>MMF_VERSION_2)    {
 		WARN(std::string("can't read mesh, version to high: ") + Util::StringUtils::toString(version));
-		return nullptr;
+		return 0;
+	}
+	return version == MMF_VERSION_2 ? MMF_VERSION_2 : MMF_VERSION;
+}
+
+//!	(static)
+Mesh * StreamerMMF::loadMesh(std::istream & input) {
+	Reader reader(input);
+	const uint32_t version = readHeader(reader);
+	if(version == MMF_VERSION) {
+		return readMesh(reader);
+	} else if(version == MMF_VERSION_2) {
+		std::vector<MeshEntry> entries;
+		uint64_t position = 8;
+		if(!readMeshEntries(reader, entries, position))
+			return nullptr;
+		if(entries.empty()) {
+			WARN("LoaderMMF::loadMesh: file contains no mesh.");
+			return nullptr;
+		}
+		return readMeshV2(reader, entries.front(), position);
 	}
+	return nullptr;
+}
 
+//!	(internal,static)
+Mesh * StreamerMMF::readMesh(Reader & reader) {
 	auto mesh = new Mesh;
 	uint32_t blockType = reader.read_uint32();
-	while(blockType != StreamerMMF::MMF_END && input.good()) {
+	while(blockType != StreamerMMF::MMF_END && reader.in.good()) {
 		// blocksize is discarded.
 		uint32_t blockSize = reader.read_uint32();
 		switch(blockType) {
@@ -76,17 +140,14 @@ Mesh * StreamerMMF::loadMesh(std::istream & input) {
 		}
 		blockType = reader.read_uint32();
 	}
-
-//	std::cout << "done.\n";
 	return mesh;
 }
 
 //!	(internal,static)
-void StreamerMMF::readVertexData(Mesh * mesh, Reader & in) {
+template<class Reader_t>
+void StreamerMMF::readVertexDescription(VertexDescription & vd, Reader_t & in) {
 	static const std::string warningPrefix("LoaderMMF::readVertexData: ");
 
-	VertexDescription vd;
-
 	for(uint32_t attrId = in.read_uint32(); attrId != StreamerMMF::MMF_END ; attrId = in.read_uint32()) {
 		uint32_t numValues = in.read_uint32();
 		uint32_t glType = in.read_uint32();
@@ -134,7 +195,7 @@ void StreamerMMF::readVertexData(Mesh * mesh, Reader & in) {
 			uint32_t extBlockSize=in.read_uint32();
 			extLength-=8;
 
-			if(extLength>extBlockSize) {
+			if(extBlockSize>extLength) {
 				WARN(warningPrefix+"Error in vertex block");
 				FAIL();
 			}
@@ -161,6 +222,12 @@ void StreamerMMF::readVertexData(Mesh * mesh, Reader & in) {
 //        vd.setData(index, numValues, glType);
 
 	}
+}
+
+//!	(internal,static)
+void StreamerMMF::readVertexData(Mesh * mesh, Reader & in) {
+	VertexDescription vd;
+	readVertexDescription(vd, in);
 	const uint32_t count = in.read_uint32();
 	MeshVertexData & vertices = mesh->openVertexData();
 	vertices.allocate(count,vd);
@@ -190,15 +257,132 @@ void StreamerMMF::readIndexData(Mesh * mesh, Reader & in) {
 	}
 }
 
+namespace {
+bool isAligned(const uint8_t * p) {
+	return reinterpret_cast<uintptr_t>(p) % alignof(uint32_t) == 0;
+}
+}
+
+//!	(static)
+Mesh * StreamerMMF::loadMeshMapped(const Util::FileName & url) {
+	static const std::string warningPrefix("StreamerMMF::loadMeshMapped: ");
+	size_t fileSize = 0;
+	std::shared_ptr<uint8_t> mapping = mapFile(url.getPath(), fileSize);
+	if(!mapping) {
+		WARN(warningPrefix + "Cannot map file \"" + url.toString() + "\".");
+		return nullptr;
+	}
+
+	MemoryReader reader(mapping.get(), fileSize);
+	const uint32_t version = readHeader(reader);
+	if(version == 0) {
+		return nullptr;
+	} else if(version == MMF_VERSION_2) {
+		// blocks may be compressed or quantized, so the data is decoded to the heap
+		std::vector<MeshEntry> entries;
+		uint64_t position = 8;
+		if(!readMeshEntries(reader, entries, position) || entries.empty() || entries.front().offset > fileSize || entries.front().size > fileSize - entries.front().offset) {
+			WARN(warningPrefix + "Invalid table of contents in \"" + url.toString() + "\".");
+			return nullptr;
+		}
+		Mesh * mesh = readMeshV2(mapping.get() + entries.front().offset, static_cast<size_t>(entries.front().size));
+		if(mesh)
+			mesh->setFileName(url);
+		return mesh;
+	}
+
+	Util::Reference<Mesh> mesh = new Mesh;
+	try {
+		for(uint32_t blockType = reader.read_uint32(); blockType != MMF_END; blockType = reader.read_uint32()) {
+			const uint32_t blockSize = reader.read_uint32();
+			if(!reader.valid || reader.remaining() < blockSize) {
+				WARN(warningPrefix + "Truncated data block in \"" + url.toString() + "\".");
+				return nullptr;
+			}
+			MemoryReader block(reader.cursor, blockSize);
+			reader.skip(blockSize);
+
+			if(blockType == MMF_VERTEX_DATA) {
+				VertexDescription vd;
+				readVertexDescription(vd, block);
+				const uint32_t count = block.read_uint32();
+				const uint64_t size = static_cast<uint64_t>(vd.getVertexSize()) * count;
+				if(!block.valid || block.remaining() < size) {
+					WARN(warningPrefix + "Invalid vertex block in \"" + url.toString() + "\".");
+					return nullptr;
+				}
+				MeshVertexData & vertices = mesh->openVertexData();
+				if(isAligned(block.cursor)) {
+					vertices._setSharedData(count, vd, std::shared_ptr<uint8_t>(mapping, const_cast<uint8_t *>(block.cursor)));
+				} else {
+					vertices.allocate(count, vd);
+					block.read(vertices.data(), vertices.dataSize());
+				}
+				vertices.updateBoundingBox();
+			} else if(blockType == MMF_INDEX_DATA) {
+				const uint32_t count = block.read_uint32();
+				const uint32_t drawMode = block.read_uint32();
+				if(!block.valid || block.remaining() / sizeof(uint32_t) < count) {
+					WARN(warningPrefix + "Invalid index block in \"" + url.toString() + "\".");
+					return nullptr;
+				}
+				mesh->setGLDrawMode(drawMode);
+				if(count == 0) {
+					mesh->setUseIndexData(false);
+				} else {
+					mesh->setUseIndexData(true);
+					MeshIndexData & indices = mesh->openIndexData();
+					if(isAligned(block.cursor)) {
+						indices._setSharedData(count, std::shared_ptr<uint32_t>(mapping, reinterpret_cast<uint32_t *>(const_cast<uint8_t *>(block.cursor))));
+					} else {
+						indices.allocate(count);
+						block.read(reinterpret_cast<uint8_t *>(indices.data()), indices.dataSize());
+					}
+					indices.updateIndexRange();
+				}
+			} else {
+				WARN(warningPrefix + "unknown data block found.");
+			}
+		}
+	} catch(const std::exception & e) {
+		WARN(warningPrefix + "Invalid vertex block in \"" + url.toString() + "\": " + e.what());
+		return nullptr;
+	}
+	if(!reader.valid) {
+		WARN(warningPrefix + "Missing end marker in \"" + url.toString() + "\".");
+		return nullptr;
+	}
+	mesh->setFileName(url);
+	return mesh.detachAndDecrease();
+}
+
 //! ---|> GenericLoader
 Util::GenericAttributeList * StreamerMMF::loadGeneric(std::istream & input) {
-	Mesh * m = loadMesh(input);
-	if(m == nullptr) {
+	Reader reader(input);
+	const uint32_t version = readHeader(reader);
+	std::vector<Mesh *> meshes;
+	if(version == MMF_VERSION) {
+		meshes.push_back(readMesh(reader));
+	} else if(version == MMF_VERSION_2) {
+		std::vector<MeshEntry> entries;
+		uint64_t position = 8;
+		if(!readMeshEntries(reader, entries, position))
+			return nullptr;
+		for(const auto & entry : entries) {
+			Mesh * m = readMeshV2(reader, entry, position);
+			if(m == nullptr)
+				break;
+			meshes.push_back(m);
+		}
+	}
+	if(meshes.empty()) {
 		return nullptr;
 	}
 	auto l=new Util::GenericAttributeList;
-	Util::GenericAttributeMap * d=Serialization::createMeshDescription(m);
-	l->push_back(d);
+	for(Mesh * m : meshes) {
+		Util::GenericAttributeMap * d=Serialization::createMeshDescription(m);
+		l->push_back(d);
+	}
 	return l;
 }
 
@@ -211,6 +395,8 @@ bool StreamerMMF::saveMesh(Mesh * mesh, std::ostream & output) {
 	/// VertexData
 	MeshVertexData & vertices = mesh->openVertexData();
 	const VertexDescription & vd = vertices.getVertexDescription();
+	if(vertices.getPositionDequantization() != nullptr && !vertices.getPositionDequantization()->isIdentity())
+		WARN("StreamerMMF::saveMesh: The dequantization of the positions is not stored by MMF version 1; use saveMeshes().");
 
 	// prepare header
 	std::ostringstream headerOut;
@@ -270,6 +456,673 @@ bool StreamerMMF::saveMesh(Mesh * mesh, std::ostream & output) {
 
 
 
+// -------------------------------------------------------------------
+// version 2
+
+namespace {
+
+//! CRC-32 (as used by zlib) of the given data.
+uint32_t computeCRC32(const uint8_t * data, size_t size) {
+	static const std::vector<uint32_t> table = []() {
+		std::vector<uint32_t> t(256);
+		for(uint32_t i = 0; i < 256; ++i) {
+			uint32_t c = i;
+			for(int k = 0; k < 8; ++k)
+				c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+			t[i] = c;
+		}
+		return t;
+	}();
+	uint32_t crc = 0xFFFFFFFFu;
+	for(size_t i = 0; i < size; ++i)
+		crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+	return crc ^ 0xFFFFFFFFu;
+}
+
+inline uint32_t load32(const uint8_t * p) {
+	uint32_t x;
+	std::memcpy(&x, p, 4);
+	return x;
+}
+
+void appendLZ4Length(std::vector<uint8_t> & out, size_t length) {
+	for(; length >= 255; length -= 255)
+		out.push_back(255);
+	out.push_back(static_cast<uint8_t>(length));
+}
+
+/*! Compress @p data in the LZ4 block format (greedy matching using a single hash table).
+	The result can be decoded by any LZ4 block decoder. */
+std::vector<uint8_t> compressLZ4(const uint8_t * data, size_t size) {
+	static const size_t MIN_MATCH = 4;
+	static const size_t LAST_LITERALS = 5;		// the last five bytes are always literals
+	static const size_t MATCH_START_LIMIT = 12;	// no match starts within the last twelve bytes
+	static const uint32_t HASH_BITS = 16;
+
+	std::vector<uint8_t> out;
+	out.reserve(size + size / 255 + 16);
+	std::vector<uint32_t> table(1u << HASH_BITS, 0);
+	const size_t matchEnd = size > LAST_LITERALS ? size - LAST_LITERALS : 0;
+	size_t anchor = 0;
+	size_t pos = 0;
+	while(pos + MATCH_START_LIMIT <= size) {
+		const uint32_t sequence = load32(data + pos);
+		const uint32_t hash = (sequence * 2654435761u) >> (32 - HASH_BITS);
+		const size_t candidate = table[hash];
+		table[hash] = static_cast<uint32_t>(pos);
+		if(candidate >= pos || pos - candidate > 0xFFFF || load32(data + candidate) != sequence) {
+			++pos;
+			continue;
+		}
+		size_t length = MIN_MATCH;
+		while(pos + length < matchEnd && data[candidate + length] == data[pos + length])
+			++length;
+
+		const size_t literals = pos - anchor;
+		const size_t offset = pos - candidate;
+		out.push_back(static_cast<uint8_t>((std::min<size_t>(literals, 15) << 4) | std::min<size_t>(length - MIN_MATCH, 15)));
+		if(literals >= 15)
+			appendLZ4Length(out, literals - 15);
+		out.insert(out.end(), data + anchor, data + pos);
+		out.push_back(static_cast<uint8_t>(offset & 0xFF));
+		out.push_back(static_cast<uint8_t>(offset >> 8));
+		if(length - MIN_MATCH >= 15)
+			appendLZ4Length(out, length - MIN_MATCH - 15);
+		pos += length;
+		anchor = pos;
+	}
+	const size_t literals = size - anchor;
+	out.push_back(static_cast<uint8_t>(std::min<size_t>(literals, 15) << 4));
+	if(literals >= 15)
+		appendLZ4Length(out, literals - 15);
+	out.insert(out.end(), data + anchor, data + size);
+	return out;
+}
+
+//! Decode an LZ4 block into exactly @p outputSize bytes. Returns false if the data is invalid.
+bool decompressLZ4(const uint8_t * data, size_t size, uint8_t * output, size_t outputSize) {
+	const uint8_t * in = data;
+	const uint8_t * const inEnd = data + size;
+	size_t pos = 0;
+	while(in < inEnd) {
+		const uint8_t token = *in++;
+		size_t literals = token >> 4;
+		if(literals == 15) {
+			uint8_t b;
+			do {
+				if(in == inEnd)
+					return false;
+				b = *in++;
+				literals += b;
+			} while(b == 255);
+		}
+		if(literals > static_cast<size_t>(inEnd - in) || literals > outputSize - pos)
+			return false;
+		if(literals > 0)
+			std::memcpy(output + pos, in, literals);
+		in += literals;
+		pos += literals;
+		if(in == inEnd) // the last sequence has no match
+			break;
+
+		if(inEnd - in < 2)
+			return false;
+		const size_t offset = in[0] | (static_cast<size_t>(in[1]) << 8);
+		in += 2;
+		size_t length = token & 15;
+		if(length == 15) {
+			uint8_t b;
+			do {
+				if(in == inEnd)
+					return false;
+				b = *in++;
+				length += b;
+			} while(b == 255);
+		}
+		length += 4;
+		if(offset == 0 || offset > pos || length > outputSize - pos)
+			return false;
+		const uint8_t * match = output + pos - offset;
+		for(size_t i = 0; i < length; ++i) // the ranges may overlap
+			output[pos + i] = match[i];
+		pos += length;
+	}
+	return pos == outputSize;
+}
+
+inline float signNotZero(float v) {
+	return v < 0.0f ? -1.0f : 1.0f;
+}
+
+inline int16_t toSnorm16(float v) {
+	return static_cast<int16_t>(std::round(std::min(1.0f, std::max(-1.0f, v)) * 32767.0f));
+}
+
+//! Octahedral encoding of a normal (see Cigolle et al.: "A Survey of Efficient Representations for Independent Unit Vectors").
+void encodeOctahedral(const float * n, int16_t * out) {
+	const float l1 = std::abs(n[0]) + std::abs(n[1]) + std::abs(n[2]);
+	if(l1 == 0.0f) {
+		out[0] = out[1] = 0;
+		return;
+	}
+	float x = n[0] / l1;
+	float y = n[1] / l1;
+	if(n[2] < 0.0f) {
+		const float ox = x;
+		x = (1.0f - std::abs(y)) * signNotZero(ox);
+		y = (1.0f - std::abs(ox)) * signNotZero(y);
+	}
+	out[0] = toSnorm16(x);
+	out[1] = toSnorm16(y);
+}
+
+void decodeOctahedral(const int16_t * in, float * n) {
+	float x = std::max(-1.0f, in[0] / 32767.0f);
+	float y = std::max(-1.0f, in[1] / 32767.0f);
+	const float z = 1.0f - std::abs(x) - std::abs(y);
+	if(z < 0.0f) {
+		const float ox = x;
+		x = (1.0f - std::abs(y)) * signNotZero(ox);
+		y = (1.0f - std::abs(ox)) * signNotZero(y);
+	}
+	const float length = std::sqrt(x * x + y * y + z * z);
+	n[0] = x / length;
+	n[1] = y / length;
+	n[2] = z / length;
+}
+
+void appendData(std::vector<uint8_t> & out, const void * data, size_t size) {
+	const uint8_t * bytes = static_cast<const uint8_t *>(data);
+	out.insert(out.end(), bytes, bytes + size);
+}
+
+void appendUInt32(std::vector<uint8_t> & out, uint32_t x) {
+	appendData(out, &x, 4);
+}
+
+void appendPadding(std::vector<uint8_t> & out) {
+	while(out.size() % 4 != 0)
+		out.push_back(0);
+}
+
+//! Append length and string filled up with zeros until 32bit alignment is reached.
+void appendString(std::vector<uint8_t> & out, const std::string & s) {
+	const size_t paddedLength = (s.length() + 3) & ~static_cast<size_t>(3);
+	appendUInt32(out, static_cast<uint32_t>(paddedLength));
+	appendData(out, s.data(), s.length());
+	out.resize(out.size() + paddedLength - s.length(), 0);
+}
+
+void appendBlock(std::vector<uint8_t> & out, uint32_t type, const std::vector<uint8_t> & payload, bool compress) {
+	std::vector<uint8_t> compressed;
+	if(compress)
+		compressed = compressLZ4(payload.data(), payload.size());
+	const bool useCompressed = compress && compressed.size() < payload.size();
+	const std::vector<uint8_t> & stored = useCompressed ? compressed : payload;
+	appendUInt32(out, type);
+	appendUInt32(out, static_cast<uint32_t>(stored.size()));
+	appendUInt32(out, useCompressed ? Rendering::Serialization::StreamerMMF::MMF_COMPRESSION_LZ4 : Rendering::Serialization::StreamerMMF::MMF_COMPRESSION_NONE);
+	appendUInt32(out, static_cast<uint32_t>(payload.size()));
+	appendUInt32(out, computeCRC32(payload.data(), payload.size()));
+	appendData(out, stored.data(), stored.size());
+	appendPadding(out);
+}
+
+template<class Reader_t>
+std::string readString(Reader_t & in, uint32_t & length) {
+	length = in.read_uint32();
+	if(length > (1u << 16)) { // no valid name is that long; skipping it invalidates the reader
+		in.skip(length);
+		return std::string();
+	}
+	std::vector<uint8_t> data(length);
+	in.read(data.data(), length);
+	std::string s(data.begin(), data.end());
+	return s.substr(0, s.find('\0')); // remove additional zeros
+}
+
+template<class Reader_t>
+uint64_t readUInt64(Reader_t & in) {
+	const uint64_t low = in.read_uint32();
+	const uint64_t high = in.read_uint32();
+	return (high << 32) | low;
+}
+
+void writeUInt64(std::ostream & out, uint64_t x) {
+	out.write(reinterpret_cast<const char *>(&x), 8);
+}
+
+}
+
+//!	(internal,static)
+std::vector<uint8_t> StreamerMMF::writeMeshV2(Mesh * mesh, const SaveOptions & options) {
+	std::vector<uint8_t> meshData;
+
+	/// VertexBlock
+	{
+		MeshVertexData & vertices = mesh->openVertexData();
+		const VertexDescription & vd = vertices.getVertexDescription();
+		const uint32_t count = vertices.getVertexCount();
+		const size_t stride = vd.getVertexSize();
+
+		std::vector<uint8_t> payload;
+		appendUInt32(payload, count);
+		std::vector<const VertexAttribute *> attributes;
+		for(const auto & attr : vd.getAttributes()) {
+			if(!attr.empty())
+				attributes.push_back(&attr);
+		}
+		appendUInt32(payload, static_cast<uint32_t>(attributes.size()));
+
+		// attribute descriptions
+		std::vector<uint32_t> encodings;
+		std::vector<std::vector<float>> ranges;
+		for(const VertexAttribute * attr : attributes) {
+			uint32_t encoding = MMF_ENCODING_NONE;
+			std::vector<float> range;
+			if(attr->getDataType() == GL_FLOAT && count > 0) {
+				const Util::StringIdentifier nameId = attr->getNameId();
+				bool isTexCoord = false;
+				for(uint_fast8_t unit = 0; unit < 8; ++unit)
+					isTexCoord |= (nameId == VertexAttributeIds::getTextureCoordinateIdentifier(unit));
+				if(options.quantizeNormals && nameId == VertexAttributeIds::NORMAL && attr->getNumValues() == 3) {
+					encoding = MMF_ENCODING_OCT16;
+				} else if((options.quantizePositions && nameId == VertexAttributeIds::POSITION) || (options.quantizeTexCoords && isTexCoord)) {
+					encoding = MMF_ENCODING_UNORM16;
+					const uint8_t numValues = attr->getNumValues();
+					std::vector<float> min(numValues, std::numeric_limits<float>::max());
+					std::vector<float> max(numValues, std::numeric_limits<float>::lowest());
+					for(uint32_t i = 0; i < count; ++i) {
+						const uint8_t * vertex = vertices.data() + i * stride + attr->getOffset();
+						for(uint_fast8_t c = 0; c < numValues; ++c) {
+							float v;
+							std::memcpy(&v, vertex + c * sizeof(float), sizeof(float));
+							min[c] = std::min(min[c], v);
+							max[c] = std::max(max[c], v);
+						}
+					}
+					range = min;
+					for(uint_fast8_t c = 0; c < numValues; ++c)
+						range.push_back(max[c] - min[c]);
+				}
+			}
+			appendUInt32(payload, attr->getNumValues());
+			appendUInt32(payload, attr->getDataType());
+			appendUInt32(payload, (attr->getNormalize() ? 0x01 : 0x00) | (attr->getConvertToFloat() ? 0x02 : 0x00));
+			appendUInt32(payload, encoding);
+			appendString(payload, attr->getName());
+			appendData(payload, range.data(), range.size() * sizeof(float));
+			encodings.push_back(encoding);
+			ranges.emplace_back(std::move(range));
+		}
+
+		// attribute streams
+		for(size_t a = 0; a < attributes.size(); ++a) {
+			const VertexAttribute * attr = attributes[a];
+			const uint8_t numValues = attr->getNumValues();
+			const uint8_t * source = vertices.data() + attr->getOffset();
+			if(encodings[a] == MMF_ENCODING_OCT16) {
+				for(uint32_t i = 0; i < count; ++i, source += stride) {
+					float n[3];
+					int16_t encoded[2];
+					std::memcpy(n, source, sizeof(n));
+					encodeOctahedral(n, encoded);
+					appendData(payload, encoded, sizeof(encoded));
+				}
+			} else if(encodings[a] == MMF_ENCODING_UNORM16) {
+				const std::vector<float> & range = ranges[a];
+				for(uint32_t i = 0; i < count; ++i, source += stride) {
+					for(uint_fast8_t c = 0; c < numValues; ++c) {
+						float v;
+						std::memcpy(&v, source + c * sizeof(float), sizeof(float));
+						const float extent = range[numValues + c];
+						const uint16_t q = extent > 0.0f ? static_cast<uint16_t>(std::round(std::min(1.0f, std::max(0.0f, (v - range[c]) / extent)) * 65535.0f)) : 0;
+						appendData(payload, &q, sizeof(q));
+					}
+				}
+			} else {
+				for(uint32_t i = 0; i < count; ++i, source += stride)
+					appendData(payload, source, attr->getDataSize());
+			}
+			appendPadding(payload);
+		}
+		appendBlock(meshData, MMF_VERTEX_DATA, payload, options.compress);
+
+		/// DequantizationBlock
+		if(vertices.getPositionDequantization() != nullptr) {
+			std::vector<uint8_t> matrix;
+			appendData(matrix, vertices.getPositionDequantization()->getData(), 16 * sizeof(float));
+			appendBlock(meshData, MMF_POSITION_DEQUANTIZATION, matrix, false);
+		}
+	}
+
+	/// IndexBlock
+	{
+		std::vector<uint8_t> payload;
+		const uint32_t count = mesh->isUsingIndexData() ? mesh->getIndexCount() : 0;
+		appendUInt32(payload, count);
+		appendUInt32(payload, mesh->getGLDrawMode());
+		if(count > 0) {
+			const MeshIndexData & indices = mesh->openIndexData();
+			const bool useShort = *std::max_element(indices.data(), indices.data() + count) <= std::numeric_limits<uint16_t>::max();
+			appendUInt32(payload, useShort ? sizeof(uint16_t) : sizeof(uint32_t));
+			if(useShort) {
+				for(uint32_t i = 0; i < count; ++i) {
+					const uint16_t index = static_cast<uint16_t>(indices[i]);
+					appendData(payload, &index, sizeof(index));
+				}
+				appendPadding(payload);
+			} else {
+				appendData(payload, indices.data(), indices.dataSize());
+			}
+		} else {
+			appendUInt32(payload, sizeof(uint32_t));
+		}
+		appendBlock(meshData, MMF_INDEX_DATA, payload, options.compress);
+	}
+
+	appendUInt32(meshData, MMF_END);
+	return meshData;
+}
+
+//!	(static)
+bool StreamerMMF::saveMeshes(const std::vector<std::pair<std::string, Mesh *>> & meshes, std::ostream & output, const SaveOptions & options) {
+	std::vector<std::vector<uint8_t>> meshData;
+	std::vector<std::vector<uint8_t>> names;
+	uint64_t offset = 3 * sizeof(uint32_t); // header, version, meshCount
+	for(const auto & namedMesh : meshes) {
+		meshData.emplace_back(writeMeshV2(namedMesh.second, options));
+		names.emplace_back();
+		appendString(names.back(), namedMesh.first);
+		offset += 2 * sizeof(uint64_t) + names.back().size();
+	}
+
+	write(output, MMF_HEADER);
+	write(output, MMF_VERSION_2);
+	write(output, static_cast<uint32_t>(meshes.size()));
+	for(size_t i = 0; i < meshData.size(); ++i) {
+		writeUInt64(output, offset);
+		writeUInt64(output, meshData[i].size());
+		output.write(reinterpret_cast<const char *>(names[i].data()), names[i].size());
+		offset += meshData[i].size();
+	}
+	for(const auto & data : meshData)
+		output.write(reinterpret_cast<const char *>(data.data()), data.size());
+	return output.good();
+}
+
+//!	(internal,static)
+template<class Reader_t>
+bool StreamerMMF::readMeshEntries(Reader_t & in, std::vector<MeshEntry> & entries, uint64_t & position) {
+	const uint32_t meshCount = in.read_uint32();
+	position += sizeof(uint32_t);
+	for(uint32_t i = 0; i < meshCount && in.good(); ++i) {
+		MeshEntry entry;
+		entry.offset = readUInt64(in);
+		entry.size = readUInt64(in);
+		uint32_t nameLength;
+		entry.name = readString(in, nameLength);
+		position += 2 * sizeof(uint64_t) + sizeof(uint32_t) + nameLength;
+		entries.emplace_back(std::move(entry));
+	}
+	bool valid = in.good();
+	uint64_t end = position;
+	for(const auto & entry : entries) {
+		valid &= entry.offset >= end && entry.size <= std::numeric_limits<uint64_t>::max() - entry.offset;
+		end = entry.offset + entry.size;
+	}
+	if(!valid) {
+		WARN("LoaderMMF::readMeshEntries: invalid table of contents.");
+		entries.clear();
+	}
+	return valid;
+}
+
+//!	(internal,static)
+Mesh * StreamerMMF::readMeshV2(Reader & in, const MeshEntry & entry, uint64_t & position) {
+	if(entry.offset < position || entry.size > std::numeric_limits<uint32_t>::max() * 2ull) {
+		WARN("LoaderMMF::readMeshV2: invalid mesh entry.");
+		return nullptr;
+	}
+	in.in.ignore(static_cast<std::streamsize>(entry.offset - position));
+	std::vector<uint8_t> data(static_cast<size_t>(entry.size));
+	in.read(data.data(), data.size());
+	position = entry.offset + entry.size;
+	if(!in.good()) {
+		WARN("LoaderMMF::readMeshV2: unexpected end of file.");
+		return nullptr;
+	}
+	return readMeshV2(data.data(), data.size());
+}
+
+//!	(internal,static)
+Mesh * StreamerMMF::readMeshV2(const uint8_t * data, size_t size) {
+	static const std::string warningPrefix("LoaderMMF::readMeshV2: ");
+	MemoryReader reader(data, size);
+	Util::Reference<Mesh> mesh = new Mesh;
+	std::vector<uint8_t> decompressed;
+	for(uint32_t blockType = reader.read_uint32(); blockType != MMF_END; blockType = reader.read_uint32()) {
+		const uint32_t storedSize = reader.read_uint32();
+		const uint32_t compression = reader.read_uint32();
+		const uint32_t payloadSize = reader.read_uint32();
+		const uint32_t checksum = reader.read_uint32();
+		if(!reader.valid || reader.remaining() < storedSize) {
+			WARN(warningPrefix + "Truncated data block.");
+			return nullptr;
+		}
+		const uint8_t * payload = reader.cursor;
+		reader.skip((storedSize + 3) & ~3u);
+		if(compression == MMF_COMPRESSION_LZ4) {
+			// LZ4 cannot reach a ratio above 255:1; larger sizes indicate corrupt data
+			if(payloadSize / 255 > storedSize) {
+				WARN(warningPrefix + "Invalid compressed block.");
+				return nullptr;
+			}
+			decompressed.resize(payloadSize);
+			if(!decompressLZ4(payload, storedSize, decompressed.data(), payloadSize)) {
+				WARN(warningPrefix + "Invalid compressed block.");
+				return nullptr;
+			}
+			payload = decompressed.data();
+		} else if(compression != MMF_COMPRESSION_NONE || payloadSize != storedSize) {
+			WARN(warningPrefix + "Unsupported compression: " + Util::StringUtils::toString(compression));
+			return nullptr;
+		}
+		if(computeCRC32(payload, payloadSize) != checksum) {
+			WARN(warningPrefix + "Checksum mismatch.");
+			return nullptr;
+		}
+
+		if(blockType == MMF_VERTEX_DATA) {
+			if(!readVertexBlockV2(mesh.get(), payload, payloadSize)) {
+				WARN(warningPrefix + "Invalid vertex block.");
+				return nullptr;
+			}
+		} else if(blockType == MMF_POSITION_DEQUANTIZATION) {
+			if(payloadSize != 16 * sizeof(float)) {
+				WARN(warningPrefix + "Invalid dequantization block.");
+				return nullptr;
+			}
+			float matrix[16];
+			std::memcpy(matrix, payload, sizeof(matrix));
+			MeshVertexData & vertices = mesh->openVertexData();
+			vertices.setPositionDequantization(Geometry::Matrix4x4(matrix));
+			vertices.updateBoundingBox();
+		} else if(blockType == MMF_INDEX_DATA) {
+			if(!readIndexBlockV2(mesh.get(), payload, payloadSize)) {
+				WARN(warningPrefix + "Invalid index block.");
+				return nullptr;
+			}
+		} else {
+			WARN(warningPrefix + "unknown data block found.");
+		}
+	}
+	if(!reader.valid) {
+		WARN(warningPrefix + "Missing end marker.");
+		return nullptr;
+	}
+	return mesh.detachAndDecrease();
+}
+
+//!	(internal,static)
+bool StreamerMMF::readVertexBlockV2(Mesh * mesh, const uint8_t * payload, size_t size) {
+	MemoryReader in(payload, size);
+	const uint32_t count = in.read_uint32();
+	const uint32_t attributeCount = in.read_uint32();
+
+	struct StoredAttribute {
+		std::string name;
+		uint32_t encoding;
+		std::vector<float> range;
+	};
+	std::vector<StoredAttribute> storedAttributes;
+	VertexDescription vd;
+	for(uint32_t a = 0; a < attributeCount && in.valid; ++a) {
+		const uint32_t numValues = in.read_uint32();
+		const uint32_t glType = in.read_uint32();
+		const uint32_t flags = in.read_uint32();
+		StoredAttribute stored;
+		stored.encoding = in.read_uint32();
+		uint32_t nameLength;
+		stored.name = readString(in, nameLength);
+		if(numValues == 0 || numValues > 0xFF || stored.name.empty() || vd.hasAttribute(stored.name))
+			return false;
+		if(stored.encoding == MMF_ENCODING_UNORM16) {
+			stored.range.resize(2 * numValues);
+			in.read(reinterpret_cast<uint8_t *>(stored.range.data()), stored.range.size() * sizeof(float));
+		} else if(stored.encoding == MMF_ENCODING_OCT16 && numValues != 3) {
+			return false;
+		} else if(stored.encoding > MMF_ENCODING_OCT16) {
+			return false;
+		}
+		if(stored.encoding != MMF_ENCODING_NONE && glType != GL_FLOAT)
+			return false;
+		vd.appendAttribute(stored.name, static_cast<uint8_t>(numValues), glType, (flags & 0x01) != 0, (flags & 0x02) != 0);
+		storedAttributes.emplace_back(std::move(stored));
+	}
+	if(!in.valid)
+		return false;
+
+	// check the size before allocating
+	std::vector<uint64_t> valueSizes;
+	uint64_t totalSize = 0;
+	for(const auto & stored : storedAttributes) {
+		const VertexAttribute & attr = vd.getAttribute(stored.name);
+		valueSizes.push_back(stored.encoding == MMF_ENCODING_OCT16 ? 2 * sizeof(int16_t) :
+								stored.encoding == MMF_ENCODING_UNORM16 ? attr.getNumValues() * sizeof(uint16_t) : attr.getDataSize());
+		totalSize += valueSizes.back() * count;
+	}
+	if(in.remaining() < totalSize)
+		return false;
+
+	MeshVertexData & vertices = mesh->openVertexData();
+	vertices.allocate(count, vd);
+	const size_t stride = vd.getVertexSize();
+	for(size_t a = 0; a < storedAttributes.size(); ++a) {
+		const StoredAttribute & stored = storedAttributes[a];
+		const VertexAttribute & attr = vd.getAttribute(stored.name);
+		const uint8_t numValues = attr.getNumValues();
+		const uint64_t valueSize = valueSizes[a];
+		const uint64_t streamSize = valueSize * count;
+		if(in.remaining() < streamSize)
+			return false;
+		uint8_t * target = vertices.data() + attr.getOffset();
+		const uint8_t * source = in.cursor;
+		if(stored.encoding == MMF_ENCODING_OCT16) {
+			for(uint32_t i = 0; i < count; ++i, target += stride, source += valueSize) {
+				int16_t encoded[2];
+				float n[3];
+				std::memcpy(encoded, source, sizeof(encoded));
+				decodeOctahedral(encoded, n);
+				std::memcpy(target, n, sizeof(n));
+			}
+		} else if(stored.encoding == MMF_ENCODING_UNORM16) {
+			for(uint32_t i = 0; i < count; ++i, target += stride) {
+				for(uint_fast8_t c = 0; c < numValues; ++c, source += sizeof(uint16_t)) {
+					uint16_t q;
+					std::memcpy(&q, source, sizeof(q));
+					const float v = stored.range[c] + (q / 65535.0f) * stored.range[numValues + c];
+					std::memcpy(target + c * sizeof(float), &v, sizeof(float));
+				}
+			}
+		} else {
+			for(uint32_t i = 0; i < count; ++i, target += stride, source += valueSize)
+				std::memcpy(target, source, valueSize);
+		}
+		in.skip(static_cast<uint32_t>((streamSize + 3) & ~3ull));
+	}
+	vertices.updateBoundingBox();
+	return in.valid;
+}
+
+//!	(internal,static)
+bool StreamerMMF::readIndexBlockV2(Mesh * mesh, const uint8_t * payload, size_t size) {
+	MemoryReader in(payload, size);
+	const uint32_t count = in.read_uint32();
+	const uint32_t drawMode = in.read_uint32();
+	const uint32_t indexSize = in.read_uint32();
+	if(!in.valid || (indexSize != sizeof(uint16_t) && indexSize != sizeof(uint32_t)) || in.remaining() / indexSize < count)
+		return false;
+	mesh->setGLDrawMode(drawMode);
+	// see readIndexData()
+	if(count == 0) {
+		mesh->setUseIndexData(false);
+		return true;
+	}
+	mesh->setUseIndexData(true);
+	MeshIndexData & indices = mesh->openIndexData();
+	indices.allocate(count);
+	if(indexSize == sizeof(uint32_t)) {
+		in.read(reinterpret_cast<uint8_t *>(indices.data()), indices.dataSize());
+	} else {
+		for(uint32_t i = 0; i < count; ++i) {
+			uint16_t index;
+			in.read(reinterpret_cast<uint8_t *>(&index), sizeof(index));
+			indices[i] = index;
+		}
+	}
+	indices.updateIndexRange();
+	return in.valid;
+}
+
+//!	(static)
+std::vector<std::string> StreamerMMF::getMeshNames(std::istream & input) {
+	Reader reader(input);
+	std::vector<std::string> names;
+	std::vector<MeshEntry> entries;
+	uint64_t position = 8;
+	if(readHeader(reader) == MMF_VERSION_2 && readMeshEntries(reader, entries, position)) {
+		for(const auto & entry : entries)
+			names.push_back(entry.name);
+	}
+	return names;
+}
+
+//!	(static)
+Mesh * StreamerMMF::loadMeshFromArchive(std::istream & input, const std::string & name) {
+	const std::streampos start = input.tellg();
+	Reader reader(input);
+	const uint32_t version = readHeader(reader);
+	if(version != MMF_VERSION_2) {
+		if(version != 0)
+			WARN("LoaderMMF::loadMeshFromArchive: only version 2 files contain named meshes.");
+		return nullptr;
+	}
+	std::vector<MeshEntry> entries;
+	uint64_t position = 8;
+	if(!readMeshEntries(reader, entries, position))
+		return nullptr;
+	for(const auto & entry : entries) {
+		if(entry.name == name) {
+			input.seekg(start + static_cast<std::streamoff>(entry.offset));
+			position = entry.offset;
+			return readMeshV2(reader, entry, position);
+		}
+	}
+	WARN("LoaderMMF::loadMeshFromArchive: mesh not found: " + name);
+	return nullptr;
+}
+
 //!	(internal,static)
 void StreamerMMF::write(std::ostream & out, uint32_t x) {
 	out.write(reinterpret_cast<char *> (&x), 4);
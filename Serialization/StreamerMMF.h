@@ -12,9 +12,17 @@
 #define RENDERING_STREAMERMMF_H_
 
 #include "AbstractRenderingStreamer.h"
+#include <cstddef>
 #include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
 
+namespace Util {
+class FileName;
+}
 namespace Rendering {
+class VertexDescription;
 namespace Serialization {
 
 /**
@@ -76,19 +84,102 @@ namespace Serialization {
 					uint32 indexCount -- the number of indices in the following datablock,
 					uint32 (=GLuint) indexMode -- the meaning of the indices (GL_TRIANGLES, GL_TRIANGLE_STRIP, ...),
 					uint8* indexData -- the index data
+
+
+	Version 2 (MMF_VERSION_2)
+	-------------------------
+
+	Version 2 files contain multiple meshes. A table of contents allows loading a single mesh
+	without reading the whole file. Blocks may be compressed and carry a checksum.
+
+	MMF2-File ::=   Header (char[4] "mmf"+chr(13) ),
+					uint32 version (0x02),
+					uint32 meshCount,
+					MeshEntry[meshCount],
+					MeshData[meshCount]
+
+	MeshEntry ::=   uint64 offset -- position of the MeshData relative to the beginning of the file,
+					uint64 size -- size of the MeshData in bytes,
+					uint32 nameLength -- length of the name including padding zeros,
+					uint8 name[nameLength] (filled up with zeros until 32bit alignment is reached)
+
+	MeshData ::=    Block * (one VertexBlock2, an optional DequantizationBlock2 and one IndexBlock2),
+					EndMarker (uint32 0xFFFFFFFF)
+
+	Block ::=       uint32 dataType (0x00: VertexBlock2, 0x01: IndexBlock2, 0x02: DequantizationBlock2),
+					uint32 storedSize -- nr of bytes of the stored payload,
+					uint32 compression (0x00: none, 0x01: LZ4 block format),
+					uint32 payloadSize -- nr of bytes of the uncompressed payload,
+					uint32 checksum -- CRC-32 of the uncompressed payload,
+					uint8 storedPayload[storedSize]
+
+	VertexBlock2 payload ::=
+					uint32 vertexCount,
+					uint32 attributeCount,
+					AttributeDescription2[attributeCount],
+					AttributeStream[attributeCount] -- the values of one attribute for all vertices
+
+	AttributeDescription2 ::=
+					uint32 numValues,
+					uint32 (=GLuint) type -- type of the decoded attribute,
+					uint32 flags (0x01: normalize, 0x02: convertToFloat),
+					uint32 encoding -- how the attribute is stored:
+						0x00: as is
+						0x01: MMF_ENCODING_UNORM16, float values quantized to uint16 within a range
+						0x02: MMF_ENCODING_OCT16, float normals in octahedral encoding (2 x int16)
+					uint32 nameLength -- length of the name including padding zeros,
+					uint8 name[nameLength],
+					float params[] -- MMF_ENCODING_UNORM16: numValues minima followed by numValues extents
+
+	AttributeStream ::= uint8 data[vertexCount * encoded size of the attribute] (filled up to 32bit alignment)
+
+	DequantizationBlock2 payload ::= -- follows the VertexBlock2
+					float matrix[16] -- transformation of the stored positions into object space
+						(see MeshVertexData::getPositionDequantization())
+
+	IndexBlock2 payload ::=
+					uint32 indexCount,
+					uint32 (=GLuint) indexMode,
+					uint32 indexSize (2 or 4 bytes),
+					uint8 indexData[indexCount * indexSize] (filled up to 32bit alignment)
+
+	\note Quantization is lossy. MMF_ENCODING_UNORM16 has a maximal error of 1/131070 of the attribute's extent.
 */
 class StreamerMMF : public AbstractRenderingStreamer {
 	public:
 		const static uint32_t MMF_VERSION = 0x01;
+		const static uint32_t MMF_VERSION_2 = 0x02;
 		const static uint32_t MMF_HEADER = 0x0d666d6d; // = "mmf "
 
 		const static uint32_t MMF_VERTEX_DATA = 0x00;
 		const static uint32_t MMF_INDEX_DATA = 0x01;
+		const static uint32_t MMF_POSITION_DEQUANTIZATION = 0x02;
 		const static uint32_t MMF_END = 0xFFFFFFFF;
 
 		const static uint32_t MMF_CUSTOM_ATTR_ID = 0xFF;
 		const static uint32_t MMF_VERTEX_ATTR_EXT_NAME = 0x03;
 
+		const static uint32_t MMF_COMPRESSION_NONE = 0x00;
+		const static uint32_t MMF_COMPRESSION_LZ4 = 0x01;
+
+		const static uint32_t MMF_ENCODING_NONE = 0x00;
+		const static uint32_t MMF_ENCODING_UNORM16 = 0x01;
+		const static uint32_t MMF_ENCODING_OCT16 = 0x02;
+
+		//! Options for saveMeshes().
+		struct SaveOptions {
+			//! Compress blocks if that makes them smaller
+			bool compress;
+			//! Store float positions as 16 bit values relative to their bounding box
+			bool quantizePositions;
+			//! Store three-component float normals in octahedral encoding
+			bool quantizeNormals;
+			//! Store float texture coordinates as 16 bit values relative to their range
+			bool quantizeTexCoords;
+
+			SaveOptions() : compress(true), quantizePositions(false), quantizeNormals(false), quantizeTexCoords(false) {}
+		};
+
 		StreamerMMF() :
 			AbstractRenderingStreamer() {
 		}
@@ -99,6 +190,27 @@ class StreamerMMF : public AbstractRenderingStreamer {
 		Mesh * loadMesh(std::istream & input) override;
 		bool saveMesh(Mesh * mesh, std::ostream & output) override;
 
+		/*! Load a mesh from a local .mmf file without copying its data to the heap.
+			The file is mapped copy-on-write and the block layout is validated; the vertex and index
+			data of the mesh reference the mapped pages (see MeshVertexData::_setSharedData()).
+			Pages are only copied when the data is modified. If the mesh's data strategy releases the
+			local data after uploading it (the default), the data is uploaded directly from the mapping
+			and the file is unmapped afterwards.
+			Returns nullptr if the file cannot be mapped or is invalid. */
+		static Mesh * loadMeshMapped(const Util::FileName & url);
+
+		/*! Write the meshes into a single version 2 file (see above).
+			@param meshes Named meshes; the names are used to identify the meshes in loadMeshFromArchive() */
+		static bool saveMeshes(const std::vector<std::pair<std::string, Mesh *>> & meshes, std::ostream & output, const SaveOptions & options = SaveOptions());
+
+		//! Return the names of the meshes stored in a version 2 file; reads only the table of contents.
+		static std::vector<std::string> getMeshNames(std::istream & input);
+
+		/*! Load the mesh with the given name from a version 2 file.
+			Only the table of contents and the data of the requested mesh are read; @p input has to be seekable.
+			Returns nullptr if there is no such mesh or its data is invalid. */
+		static Mesh * loadMeshFromArchive(std::istream & input, const std::string & name);
+
 		static uint8_t queryCapabilities(const std::string & extension);
 		static const char * const fileExtension;
 
@@ -109,11 +221,46 @@ class StreamerMMF : public AbstractRenderingStreamer {
 			uint32_t read_uint32();
 			void read(uint8_t * data,size_t count);
 			void skip(uint32_t size);
-
+			bool good()const	{	return in.good();	}
 		};
+		//! (internal) Bounds checked reader for a memory block; reads past the end return MMF_END and clear @a valid.
+		struct MemoryReader{
+			MemoryReader(const uint8_t * _begin, size_t size) : cursor(_begin), end(_begin + size), valid(true){}
+			const uint8_t * cursor;
+			const uint8_t * end;
+			bool valid;
+			uint32_t read_uint32();
+			void read(uint8_t * data,size_t count);
+			void skip(uint32_t size);
+			size_t remaining()const	{	return static_cast<size_t>(end - cursor);	}
+			bool good()const	{	return valid;	}
+		};
+		struct MeshEntry{
+			uint64_t offset;
+			uint64_t size;
+			std::string name;
+		};
+		//! (internal) Read header and version; returns 0 (after a warning) if the data is no mmf file.
+		template<class Reader_t>
+		static uint32_t readHeader(Reader_t & in);
+		template<class Reader_t>
+		static void readVertexDescription(VertexDescription & vd, Reader_t & in);
+		static Mesh * readMesh(Reader & in);
 		static void readVertexData(Mesh * mesh, Reader & in);
 		static void readIndexData(Mesh * mesh, Reader & in);
 
+		// version 2
+		//! (internal) Read the table of contents; @p position is advanced by the number of bytes read.
+		template<class Reader_t>
+		static bool readMeshEntries(Reader_t & in, std::vector<MeshEntry> & entries, uint64_t & position);
+		//! (internal) Read the MeshData of @p entry; the stream is located at @p position.
+		static Mesh * readMeshV2(Reader & in, const MeshEntry & entry, uint64_t & position);
+		static Mesh * readMeshV2(const uint8_t * data, size_t size);
+		static bool readVertexBlockV2(Mesh * mesh, const uint8_t * payload, size_t size);
+		static bool readIndexBlockV2(Mesh * mesh, const uint8_t * payload, size_t size);
+		//! (internal) Return the MeshData of @p mesh.
+		static std::vector<uint8_t> writeMeshV2(Mesh * mesh, const SaveOptions & options);
+
 
 		static void write(std::ostream & out, uint32_t x);
 };
@@ -3,23 +3,29 @@
 	Copyright (C) 2007-2012 Benjamin Eikel <benjamin@eikel.org>
 	Copyright (C) 2007-2012 Claudius Jähn <claudius@uni-paderborn.de>
 	Copyright (C) 2007-2012 Ralf Petring <ralf@petring.net>
-	
+
 	This library is subject to the terms of the Mozilla Public License, v. 2.0.
-	You should have received a copy of the MPL along with this library; see the 
+	You should have received a copy of the MPL along with this library; see the
 	file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
 */
 #include "StreamerOBJ.h"
+#include "NumberParser.h"
 #include "Serialization.h"
 #include "../Mesh/Mesh.h"
 #include "../Mesh/VertexAttributeIds.h"
 #include "../Mesh/VertexDescription.h"
 #include "../MeshUtils/MeshUtils.h"
+#include "../MeshUtils/ParallelFor.h"
 #include "../GLHeader.h"
 #include <Util/GenericAttribute.h>
 #include <Util/StringUtils.h>
+#include <algorithm>
+#include <cstring>
+#include <istream>
 #include <list>
-#include <map>
-#include <set>
+#include <string>
+#include <thread>
+#include <vector>
 
 using namespace Util;
 
@@ -27,313 +33,406 @@ namespace Rendering {
 namespace Serialization {
 
 const char * const StreamerOBJ::fileExtension = "obj";
-
-struct Vertex {
-
-	Vertex() :
-		data(), index(0) {
-	}
-
-	Vertex(const Vertex & other) :
-		data(other.data), index(other.index) {
-	}
-
-	Vertex(float pos[3], float nor[3], float tex[2]) :
-		data(), index(0) {
-		size_t size = 3;
-		if (nor != nullptr) {
-			size += 3;
-		}
-		if (tex != nullptr) {
-			size += 2;
-		}
-		data.reserve(size);
-		data.push_back(pos[0]);
-		data.push_back(pos[1]);
-		data.push_back(pos[2]);
-		if (nor != nullptr) {
-			data.push_back(nor[0]);
-			data.push_back(nor[1]);
-			data.push_back(nor[2]);
-		}
-		if (tex != nullptr) {
-			// Texture offsets are ignored here.
-			data.push_back(tex[0]);
-			data.push_back(tex[1]);
-		}
+const std::size_t StreamerOBJ::DEFAULT_BLOCK_SIZE;
+
+//! Offset marking indices that are relative to the beginning of a chunk (see parseIndex).
+static const int64_t RELATIVE_INDEX = int64_t(1) << 40;
+
+/**
+ * (internal) Result of parsing a consecutive range of lines.
+ * Parsing of different ranges is independent, so it can be done in parallel.
+ * Negative (relative) OBJ indices cannot be resolved before the number of
+ * elements in the preceding ranges is known. Therefore, they are stored as
+ * one-based index relative to the beginning of the range minus RELATIVE_INDEX.
+ */
+struct ParsedChunk {
+	std::vector<float> positions;
+	std::vector<float> texCoords;
+	std::vector<float> normals;
+	//! Number of corners for each face
+	std::vector<uint32_t> faceSizes;
+	//! v, vt and vn index for each corner of each face (zero if not given)
+	std::vector<int64_t> corners;
+
+	//! Statement that is not a vertex or face, in the order of the file
+	struct Event {
+		enum type_t { GROUP, USE_MATERIAL, MATERIAL_LIBRARY, UNKNOWN } type;
+		//! Number of faces of the chunk preceding this event
+		std::size_t faceCount;
+		std::string argument;
+	};
+	std::vector<Event> events;
+
+	void clear() {
+		positions.clear();
+		texCoords.clear();
+		normals.clear();
+		faceSizes.clear();
+		corners.clear();
+		events.clear();
 	}
-
-	Vertex & operator=(const Vertex & other) {
-		data = other.data;
-		index = other.index;
-		return *this;
-	}
-
-	bool operator<(const Vertex & other) const {
-		// Do not compare index here.
-		return data < other.data;
-	}
-
-	std::vector<float> data;
-	uint32_t index;
 };
 
-static void triangulate(std::list<uint32_t> & l) {
-	if (l.size() <= 3) {
-		if(l.size() < 3) {
-			WARN("cannot triangulate list with < 3 entries");
-			l.clear();
-		}
-		return;
-	}
-	// Copy list.
-	std::list<uint32_t> old(l);
-	l.clear();
-
-	uint32_t a, b, c;
-	a = old.front();
-	old.pop_front();
-	b = old.front();
-	old.pop_front();
-	c = old.front();
-	old.pop_front();
-	l.push_back(a);
-	l.push_back(b);
-	l.push_back(c);
-	while (!old.empty()) {
-		b = c;
-		c = old.front();
-		old.pop_front();
-		l.push_back(a);
-		l.push_back(b);
-		l.push_back(c);
+/*! (internal) Parse an OBJ index. Positive indices are returned unchanged, negative indices
+	are converted as described in ParsedChunk. Returns false if there is no number. */
+static bool parseIndex(const char *& cursor, const char * end, std::size_t chunkElementCount, int64_t & index) {
+	bool negative = false;
+	if(cursor < end && *cursor == '-') {
+		negative = true;
+		++cursor;
 	}
+	if(cursor >= end || !isDigit(*cursor))
+		return false;
+	int64_t value = 0;
+	for(; cursor < end && isDigit(*cursor); ++cursor)
+		value = std::min<int64_t>(value * 10 + (*cursor - '0'), RELATIVE_INDEX / 2);
+	index = negative ? static_cast<int64_t>(chunkElementCount) + 1 - value - RELATIVE_INDEX : value;
+	return true;
 }
 
-
-static Mesh * createMesh(VertexDescription * vertexDesc, const std::list<uint32_t> & faces, const std::set<Vertex> & vertexSet) {
-	Util::Reference<Mesh> mesh = new Mesh;
-
-
-	// Create index data.
-	std::size_t indexCount = faces.size();
-
-	MeshIndexData & indices = mesh->openIndexData();
-	indices.allocate(indexCount);
-	uint32_t * indexData = indices.data();
-
-
-	// Mapping is done because one face list may reference only a small subset of the vertices.
-	std::map<uint32_t, uint32_t> indexMap;
-
-	uint32_t newIndex = 0;
-	for(const auto & face : faces) {
-		auto find = indexMap.lower_bound(face);
-		if(find == indexMap.end() || indexMap.key_comp()(face, find->first)) {
-			find = indexMap.insert(find, std::make_pair(face, newIndex));
-			++newIndex;
-		}
-		*indexData = find->second;
-		++indexData;
-	}
-	indices.updateIndexRange();
-
-	// Create vertex data.
-	MeshVertexData & vertices = mesh->openVertexData();
-	vertices.allocate(indexMap.size(), *vertexDesc);
-
-	const uint16_t posOffset = vertexDesc->getAttribute(VertexAttributeIds::POSITION).getOffset();
-	const uint16_t texOffset = vertexDesc->getAttribute(VertexAttributeIds::TEXCOORD0).getOffset();
-	const uint16_t norOffset = vertexDesc->getAttribute(VertexAttributeIds::NORMAL).getOffset();
-
-	uint8_t * data = vertices.data();
-	for(const auto & vertex : vertexSet) {
-		auto find = indexMap.find(vertex.index);
-		if (find != indexMap.end()) {
-			// Copy position.
-			auto end = std::next(vertex.data.begin(), 3);
-			std::copy(vertex.data.begin(), end, reinterpret_cast<float *> (data + (find->second * vertexDesc->getVertexSize()) + posOffset));
-
-			const bool texAvail = vertex.data.size() == 5 || vertex.data.size() == 8;
-			const bool norAvail = vertex.data.size() == 6 || vertex.data.size() == 8;
-			if(norAvail) {
-				// Copy normal.
-				auto begin = end;
-				std::advance(end, 3);
-				std::copy(begin, end, reinterpret_cast<float *> (data + (find->second * vertexDesc->getVertexSize()) + norOffset));
-			}
-			if(texAvail) {
-				// Copy texture coordinate.
-				auto begin = end;
-				std::advance(end, 2);
-				std::copy(begin, end, reinterpret_cast<float *> (data + (find->second * vertexDesc->getVertexSize()) + texOffset));
-			}
-		}
-	}
-	vertices.updateBoundingBox();
-
-	MeshUtils::shrinkMesh(mesh.get());
-
-	if (mesh->getVertexCount() == 0 || mesh->getIndexCount() == 0) {
-		mesh = nullptr;
-	}
-
-	return mesh.detachAndDecrease();
+//! (internal) Return the rest of the line without leading and trailing whitespace.
+static std::string getArgument(const char * cursor, const char * lineEnd) {
+	while(cursor < lineEnd && isSpace(*cursor))
+		++cursor;
+	while(lineEnd > cursor && isSpace(lineEnd[-1]))
+		--lineEnd;
+	return std::string(cursor, lineEnd);
 }
 
-Util::GenericAttributeList * StreamerOBJ::loadGeneric(std::istream & input) {
-	auto descriptionList = new Util::GenericAttributeList;
-
-	std::set<Vertex> vertices;
-
-
-	// Insert initial items, because first index for OBJ is 1.
-	std::vector<float> positions(3, 0.0f);
-	std::vector<float> normals(3, 0.0f);
-	std::vector<float> texcoords(2, 0.0f);
-
-	std::list<uint32_t> faces;
-
-	std::string currentMtl;
-	std::list<std::string> mtlFiles;
-
-	VertexDescription * vertexDesc = nullptr;
-
-	char chars[256];
+static bool beginsWithKeyword(const char * cursor, const char * lineEnd, const char * keyword) {
+	const std::size_t length = std::strlen(keyword);
+	return static_cast<std::size_t>(lineEnd - cursor) >= length && std::equal(keyword, keyword + length, cursor);
+}
 
-	while (input.getline(chars, 256)) {
-		char * cursor = chars;
-		StringUtils::stepWhitespaces(&cursor);
-		if (*cursor == 'v') {
+//! (internal) Parse all lines in [begin, end).
+static void parseLines(const char * begin, const char * end, ParsedChunk & chunk) {
+	const char * lineBegin = begin;
+	while(lineBegin < end) {
+		const char * lineEnd = static_cast<const char *>(std::memchr(lineBegin, '\n', end - lineBegin));
+		if(!lineEnd)
+			lineEnd = end;
+		const char * cursor = lineBegin;
+		lineBegin = lineEnd + 1;
+		while(cursor < lineEnd && isSpace(*cursor))
 			++cursor;
-			if (*cursor == ' ') {
-				++cursor;
-				float pos[3];
-				pos[0] = strtof(cursor, &cursor);
-				pos[1] = strtof(cursor, &cursor);
-				pos[2] = strtof(cursor, &cursor);
-				positions.insert(positions.end(), pos, pos + 3);
-			} else if (*cursor == 't') {
-				++cursor;
-				float texCoord[2];
-				texCoord[0] = strtof(cursor, &cursor);
-				texCoord[1] = strtof(cursor, &cursor);
-				texcoords.insert(texcoords.end(), texCoord, texCoord + 2);
-			} else if (*cursor == 'n') {
+		if(cursor == lineEnd || *cursor == '#')
+			continue;
+
+		if(*cursor == 'v' && cursor + 1 < lineEnd) {
+			float values[3] = {0.0f, 0.0f, 0.0f};
+			if(isSpace(cursor[1])) {
 				++cursor;
-				float normal[3];
-				normal[0] = strtof(cursor, &cursor);
-				normal[1] = strtof(cursor, &cursor);
-				normal[2] = strtof(cursor, &cursor);
-				normals.insert(normals.end(), normal, normal + 3);
+				for(uint32_t i = 0; i < 3; ++i)
+					cursor = parseFloat(cursor, lineEnd, values[i]);
+				chunk.positions.insert(chunk.positions.end(), values, values + 3);
+			} else if(cursor[1] == 't') {
+				cursor += 2;
+				for(uint32_t i = 0; i < 2; ++i)
+					cursor = parseFloat(cursor, lineEnd, values[i]);
+				chunk.texCoords.insert(chunk.texCoords.end(), values, values + 2);
+			} else if(cursor[1] == 'n') {
+				cursor += 2;
+				for(uint32_t i = 0; i < 3; ++i)
+					cursor = parseFloat(cursor, lineEnd, values[i]);
+				chunk.normals.insert(chunk.normals.end(), values, values + 3);
 			}
-		} else if (*cursor == 'f') {
+		} else if(*cursor == 'f' && cursor + 1 < lineEnd && isSpace(cursor[1])) {
 			++cursor;
-			int32_t v = 0, vt = 0, vn = 0;
-			v = strtol(cursor, &cursor, 10);
-			std::list<uint32_t> vertexIndexList;
-			while (v != 0) {
-				if (*cursor == '/') {
+			uint32_t cornerCount = 0;
+			while(true) {
+				while(cursor < lineEnd && isSpace(*cursor))
+					++cursor;
+				int64_t corner[3] = {0, 0, 0};
+				if(!parseIndex(cursor, lineEnd, chunk.positions.size() / 3, corner[0]))
+					break;
+				if(cursor < lineEnd && *cursor == '/') {
 					++cursor;
-					vt = strtol(cursor, &cursor, 10);
-					if (*cursor == '/') {
+					parseIndex(cursor, lineEnd, chunk.texCoords.size() / 2, corner[1]);
+					if(cursor < lineEnd && *cursor == '/') {
 						++cursor;
-						vn = strtol(cursor, &cursor, 10);
-					}
-				}
-				if (!vertexDesc) {
-					vertexDesc = new VertexDescription;
-					vertexDesc->appendAttribute(VertexAttributeIds::POSITION, 3, GL_FLOAT,false);
-					if (vt != 0) {
-						vertexDesc->appendAttribute(VertexAttributeIds::TEXCOORD0, 2, GL_FLOAT,false);
-					}
-					if (vn != 0) {
-						vertexDesc->appendAttribute(VertexAttributeIds::NORMAL, 3, GL_FLOAT,false);
+						parseIndex(cursor, lineEnd, chunk.normals.size() / 3, corner[2]);
 					}
 				}
+				chunk.corners.insert(chunk.corners.end(), corner, corner + 3);
+				++cornerCount;
+			}
+			chunk.faceSizes.push_back(cornerCount);
+		} else if(beginsWithKeyword(cursor, lineEnd, "mtllib")) {
+			chunk.events.push_back({ParsedChunk::Event::MATERIAL_LIBRARY, chunk.faceSizes.size(), getArgument(cursor + 6, lineEnd)});
+		} else if(beginsWithKeyword(cursor, lineEnd, "usemtl")) {
+			chunk.events.push_back({ParsedChunk::Event::USE_MATERIAL, chunk.faceSizes.size(), getArgument(cursor + 6, lineEnd)});
+		} else if(*cursor == 'g' || *cursor == 's') {
+			chunk.events.push_back({ParsedChunk::Event::GROUP, chunk.faceSizes.size(), std::string()});
+		} else if(*cursor != 'o') {
+			chunk.events.push_back({ParsedChunk::Event::UNKNOWN, chunk.faceSizes.size(), std::string(1, *cursor)});
+		}
+	}
+}
 
-				float * tex = nullptr;
-				float * nor = nullptr;
-				if(v < 0)
-					v = positions.size()/3 + v;
-				if(vt < 0)
-					vt = texcoords.size()/2 + vt;
-				if(vn < 0)
-					vn = normals.size()/3 + vn;
-				
-				if (vt != 0) {
-					tex = &texcoords[2 * vt];
-				}
-				if (vn != 0) {
-					nor = &normals[3 * vn];
-				}
-				uint32_t index;
-				Vertex vertex(&positions[3 * v], nor, tex);
-				auto iter = vertices.lower_bound(vertex);
-				if (iter != vertices.end() && !(vertices.key_comp()(vertex, *iter))) {
-					index = iter->index;
-				} else {
-					vertex.index = vertices.size();
-					vertices.insert(iter, vertex);
-					index = vertex.index;
-				}
+/**
+ * (internal) Collects the faces of one mesh and creates it.
+ * Each distinct v/vt/vn index triple becomes one vertex. The triples are
+ * deduplicated using an open addressing hash table.
+ */
+class ObjMeshBuilder {
+		const std::vector<float> & positions;
+		const std::vector<float> & texCoords;
+		const std::vector<float> & normals;
+
+		bool hasTexCoords;
+		bool hasNormals;
+		bool empty;
+		std::vector<uint32_t> triples;
+		std::vector<uint32_t> indices;
+		std::vector<uint32_t> table;
+		std::vector<uint32_t> faceIndices;
+
+		static uint32_t hashTriple(const uint32_t * triple) {
+			uint64_t h = triple[0] * 0x9E3779B97F4A7C15ull;
+			h ^= (triple[1] + 0x632BE59BD9B4E019ull) * 0xC2B2AE3D27D4EB4Full;
+			h ^= (triple[2] + 0x85EBCA77C2B2AE63ull) * 0x165667B19E3779F9ull;
+			return static_cast<uint32_t>(h ^ (h >> 29));
+		}
+		void grow() {
+			std::vector<uint32_t> newTable(std::max<std::size_t>(1024, 2 * table.size()), 0xffffffff);
+			const uint32_t mask = static_cast<uint32_t>(newTable.size()) - 1;
+			for(uint32_t vertex = 0; vertex < triples.size() / 3; ++vertex) {
+				uint32_t slot = hashTriple(&triples[3 * vertex]) & mask;
+				while(newTable[slot] != 0xffffffff)
+					slot = (slot + 1) & mask;
+				newTable[slot] = vertex;
+			}
+			table.swap(newTable);
+		}
+		uint32_t getVertex(const uint32_t * triple) {
+			if(2 * (triples.size() / 3 + 1) > table.size())
+				grow();
+			const uint32_t mask = static_cast<uint32_t>(table.size()) - 1;
+			uint32_t slot = hashTriple(triple) & mask;
+			while(table[slot] != 0xffffffff) {
+				const uint32_t * other = &triples[3 * table[slot]];
+				if(other[0] == triple[0] && other[1] == triple[1] && other[2] == triple[2])
+					return table[slot];
+				slot = (slot + 1) & mask;
+			}
+			table[slot] = static_cast<uint32_t>(triples.size() / 3);
+			triples.insert(triples.end(), triple, triple + 3);
+			return table[slot];
+		}
+	public:
+		ObjMeshBuilder(const std::vector<float> & _positions, const std::vector<float> & _texCoords, const std::vector<float> & _normals) :
+			positions(_positions), texCoords(_texCoords), normals(_normals), hasTexCoords(false), hasNormals(false), empty(true) {
+		}
 
-				vertexIndexList.push_back(index);
+		bool isEmpty() const	{	return empty;	}
 
-				v = strtoul(cursor, &cursor, 10);
+		/*! Add a face given by one-based, absolute index triples (zero if absent).
+			The vertex format of the mesh is determined by the first corner of the first face. */
+		void addFace(const uint32_t * corners, uint32_t cornerCount) {
+			if(empty) {
+				hasTexCoords = corners[1] != 0;
+				hasNormals = corners[2] != 0;
+				empty = false;
+			}
+			if(cornerCount < 3) {
+				WARN("cannot triangulate list with < 3 entries");
+				return;
+			}
+			faceIndices.clear();
+			for(uint32_t i = 0; i < cornerCount; ++i)
+				faceIndices.push_back(getVertex(corners + 3 * i));
+			// triangle fan
+			for(uint32_t i = 2; i < cornerCount; ++i) {
+				indices.push_back(faceIndices[0]);
+				indices.push_back(faceIndices[i - 1]);
+				indices.push_back(faceIndices[i]);
 			}
-			triangulate(vertexIndexList);
-			while (!vertexIndexList.empty()) {
-				// Append one triangle.
-				for (uint_fast8_t i = 0; i < 3; ++i) {
-					faces.push_back(vertexIndexList.front());
-					vertexIndexList.pop_front();
+		}
+
+		//! Create the mesh from the collected faces and reset the builder. Returns nullptr if there are no triangles.
+		Mesh * createMesh() {
+			Util::Reference<Mesh> mesh;
+			if(!indices.empty()) {
+				VertexDescription vertexDesc;
+				vertexDesc.appendAttribute(VertexAttributeIds::POSITION, 3, GL_FLOAT, false);
+				if(hasTexCoords)
+					vertexDesc.appendAttribute(VertexAttributeIds::TEXCOORD0, 2, GL_FLOAT, false);
+				if(hasNormals)
+					vertexDesc.appendAttribute(VertexAttributeIds::NORMAL, 3, GL_FLOAT, false);
+				const uint32_t vertexCount = static_cast<uint32_t>(triples.size() / 3);
+				mesh = new Mesh(vertexDesc, vertexCount, static_cast<uint32_t>(indices.size()));
+
+				MeshIndexData & indexData = mesh->openIndexData();
+				std::copy(indices.begin(), indices.end(), indexData.data());
+				indexData.updateIndexRange();
+
+				MeshVertexData & vertexData = mesh->openVertexData();
+				const std::size_t vertexSize = vertexDesc.getVertexSize();
+				const uint16_t posOffset = vertexDesc.getAttribute(VertexAttributeIds::POSITION).getOffset();
+				const uint16_t texOffset = vertexDesc.getAttribute(VertexAttributeIds::TEXCOORD0).getOffset();
+				const uint16_t norOffset = vertexDesc.getAttribute(VertexAttributeIds::NORMAL).getOffset();
+				uint8_t * data = vertexData.data();
+				for(uint32_t vertex = 0; vertex < vertexCount; ++vertex, data += vertexSize) {
+					const uint32_t * triple = &triples[3 * vertex];
+					std::copy_n(&positions[3 * (triple[0] - 1)], 3, reinterpret_cast<float *>(data + posOffset));
+					// Missing texture coordinates and normals stay zero.
+					if(hasTexCoords && triple[1] != 0)
+						std::copy_n(&texCoords[2 * (triple[1] - 1)], 2, reinterpret_cast<float *>(data + texOffset));
+					if(hasNormals && triple[2] != 0)
+						std::copy_n(&normals[3 * (triple[2] - 1)], 3, reinterpret_cast<float *>(data + norOffset));
 				}
+				vertexData.updateBoundingBox();
+
+				MeshUtils::shrinkMesh(mesh.get());
+				if(mesh->getVertexCount() == 0 || mesh->getIndexCount() == 0)
+					mesh = nullptr;
 			}
-		} else if (StringUtils::beginsWith(cursor, "mtllib")) {
-			cursor += 6;
-			mtlFiles.push_back(StringUtils::trim(cursor));
-		} else if (*cursor == 'g' || *cursor == 's') {
-			if (!vertexDesc)
-				continue;
+			triples.clear();
+			indices.clear();
+			table.clear();
+			empty = true;
+			return mesh.detachAndDecrease();
+		}
+};
+
+/**
+ * (internal) Sequential part of the loader: appends the parsed chunks in file order,
+ * resolves relative indices and creates the meshes.
+ */
+class ObjChunkMerger {
+		std::vector<float> positions;
+		std::vector<float> texCoords;
+		std::vector<float> normals;
+		ObjMeshBuilder builder;
+		std::string currentMtl;
+		std::vector<uint32_t> faceCorners;
+		bool invalidIndexFound;
+	public:
+		Util::GenericAttributeList * descriptionList;
+		std::list<std::string> mtlFiles;
+
+		ObjChunkMerger() : builder(positions, texCoords, normals), invalidIndexFound(false), descriptionList(new Util::GenericAttributeList) {
+		}
 
-			Mesh * mesh = createMesh(vertexDesc, faces, vertices);
-			vertexDesc = nullptr;
-			faces.clear();
+		void finishMesh() {
+			if(builder.isEmpty())
+				return;
+			Mesh * mesh = builder.createMesh();
 			if(mesh) {
 				Util::GenericAttributeMap * d = Serialization::createMeshDescription(mesh);
 				d->setString(Serialization::DESCRIPTION_MATERIAL_NAME, currentMtl);
 				descriptionList->push_back(d);
 			}
-		} else if (StringUtils::beginsWith(cursor, "usemtl")) {
-
-			if (vertexDesc) {
-				Mesh * mesh = createMesh(vertexDesc, faces, vertices);
-				vertexDesc = nullptr;
-				faces.clear();
-				if(mesh) {
-					Util::GenericAttributeMap * d = Serialization::createMeshDescription(mesh);
-					d->setString(Serialization::DESCRIPTION_MATERIAL_NAME, currentMtl);
-					descriptionList->push_back(d);
+		}
+
+		void handleEvent(const ParsedChunk::Event & event) {
+			switch(event.type) {
+				case ParsedChunk::Event::GROUP:
+					finishMesh();
+					break;
+				case ParsedChunk::Event::USE_MATERIAL:
+					finishMesh();
+					currentMtl = event.argument;
+					break;
+				case ParsedChunk::Event::MATERIAL_LIBRARY:
+					mtlFiles.push_back(event.argument);
+					break;
+				case ParsedChunk::Event::UNKNOWN:
+				default:
+					WARN(std::string("Unknown OBJ keyword \"") + event.argument + "\".");
+					break;
+			}
+		}
+
+		void merge(const ParsedChunk & chunk) {
+			const int64_t positionBase = static_cast<int64_t>(positions.size() / 3);
+			const int64_t texCoordBase = static_cast<int64_t>(texCoords.size() / 2);
+			const int64_t normalBase = static_cast<int64_t>(normals.size() / 3);
+			positions.insert(positions.end(), chunk.positions.begin(), chunk.positions.end());
+			texCoords.insert(texCoords.end(), chunk.texCoords.begin(), chunk.texCoords.end());
+			normals.insert(normals.end(), chunk.normals.begin(), chunk.normals.end());
+			const int64_t bases[3] = {positionBase, texCoordBase, normalBase};
+			const int64_t counts[3] = {static_cast<int64_t>(positions.size() / 3), static_cast<int64_t>(texCoords.size() / 2), static_cast<int64_t>(normals.size() / 3)};
+
+			auto nextEvent = chunk.events.begin();
+			const int64_t * corner = chunk.corners.data();
+			for(std::size_t face = 0; face < chunk.faceSizes.size(); ++face) {
+				for(; nextEvent != chunk.events.end() && nextEvent->faceCount <= face; ++nextEvent)
+					handleEvent(*nextEvent);
+
+				const uint32_t cornerCount = chunk.faceSizes[face];
+				faceCorners.resize(3 * cornerCount);
+				bool valid = true;
+				for(uint32_t i = 0; i < 3 * cornerCount; ++i, ++corner) {
+					int64_t index = *corner;
+					if(index < 0)
+						index += RELATIVE_INDEX + bases[i % 3];
+					if(index < 0 || index > counts[i % 3] || (index == 0 && *corner != 0) || (i % 3 == 0 && index == 0))
+						valid = false;
+					faceCorners[i] = static_cast<uint32_t>(index);
+				}
+				if(valid) {
+					builder.addFace(faceCorners.data(), cornerCount);
+				} else if(!invalidIndexFound) {
+					WARN("OBJ face references a missing vertex; skipping it.");
+					invalidIndexFound = true;
 				}
 			}
-			cursor += 6;
-			currentMtl = StringUtils::trim(cursor);
-		} else if (*cursor != '#' && *cursor != '\0' && *cursor != '\n' && *cursor != '\r' && *cursor != 'o') {
-			WARN(std::string("Unknown OBJ keyword \"") + *cursor + "\".");
+			for(; nextEvent != chunk.events.end(); ++nextEvent)
+				handleEvent(*nextEvent);
 		}
-	}
+};
+
+Util::GenericAttributeList * StreamerOBJ::loadGeneric(std::istream & input) {
+	ObjChunkMerger merger;
+
+	// Read the input in blocks and split every block into one range of lines per thread.
+	const uint32_t threadCount = std::max(1u, std::thread::hardware_concurrency());
+	std::vector<ParsedChunk> chunks(threadCount);
+	std::vector<char> buffer(blockSize);
+	std::size_t carry = 0;
+	bool endOfInput = false;
+	while(!endOfInput) {
+		if(carry == buffer.size())
+			buffer.resize(2 * buffer.size()); // a single line is longer than the buffer
+		input.read(buffer.data() + carry, buffer.size() - carry);
+		const std::size_t available = carry + static_cast<std::size_t>(input.gcount());
+		endOfInput = !input;
+
+		std::size_t blockEnd = available;
+		if(!endOfInput) {
+			while(blockEnd > 0 && buffer[blockEnd - 1] != '\n')
+				--blockEnd;
+			if(blockEnd == 0) {
+				carry = available;
+				continue;
+			}
+		}
+
+		std::vector<const char *> rangeBegins(threadCount + 1, buffer.data() + blockEnd);
+		rangeBegins[0] = buffer.data();
+		for(uint32_t t = 1; t < threadCount; ++t) {
+			const char * begin = std::max<const char *>(rangeBegins[t - 1], buffer.data() + t * (blockEnd / threadCount));
+			const char * lineEnd = static_cast<const char *>(std::memchr(begin, '\n', buffer.data() + blockEnd - begin));
+			rangeBegins[t] = lineEnd ? lineEnd + 1 : buffer.data() + blockEnd;
+		}
+		MeshUtils::parallelFor(threadCount, 1, [&](uint32_t begin, uint32_t end) {
+			for(uint32_t t = begin; t < end; ++t) {
+				chunks[t].clear();
+				parseLines(rangeBegins[t], rangeBegins[t + 1], chunks[t]);
+			}
+		});
+		for(const auto & chunk : chunks)
+			merger.merge(chunk);
 
-	Mesh * mesh = createMesh(vertexDesc, faces, vertices);
-	faces.clear();
-	if(mesh) {
-		Util::GenericAttributeMap * d = Serialization::createMeshDescription(mesh);
-		d->setString(Serialization::DESCRIPTION_MATERIAL_NAME, currentMtl);
-		descriptionList->push_back(d);
+		carry = available - blockEnd;
+		std::copy(buffer.begin() + blockEnd, buffer.begin() + available, buffer.begin());
 	}
+	merger.finishMesh();
 
 	// Traverse list in reverse order to get right order again when using push_front below.
-	for(auto it = mtlFiles.rbegin(); it != mtlFiles.rend(); ++it) {
+	Util::GenericAttributeList * descriptionList = merger.descriptionList;
+	for(auto it = merger.mtlFiles.rbegin(); it != merger.mtlFiles.rend(); ++it) {
 		auto mtlFileDesc = new Util::GenericAttributeMap;
 		mtlFileDesc->setString(Serialization::DESCRIPTION_TYPE, Serialization::DESCRIPTION_TYPE_MATERIAL);
 		mtlFileDesc->setString(Serialization::DESCRIPTION_FILE, *it);
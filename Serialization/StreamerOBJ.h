@@ -12,14 +12,21 @@
 #define RENDERING_STREAMEROBJ_H_
 
 #include "AbstractRenderingStreamer.h"
+#include <algorithm>
+#include <cstddef>
 
 namespace Rendering {
 namespace Serialization {
 
 class StreamerOBJ : public AbstractRenderingStreamer {
 	public:
-		StreamerOBJ() :
-			AbstractRenderingStreamer() {
+		//! Default number of bytes that are read from the stream and parsed at once.
+		static const std::size_t DEFAULT_BLOCK_SIZE = 16 * 1024 * 1024;
+
+		/*! @param _blockSize Number of bytes that are read from the stream and parsed at once; the block is
+				enlarged if a single line does not fit into it. */
+		explicit StreamerOBJ(std::size_t _blockSize = DEFAULT_BLOCK_SIZE) :
+			AbstractRenderingStreamer(), blockSize(std::max<std::size_t>(_blockSize, 1)) {
 		}
 		virtual ~StreamerOBJ() {
 		}
@@ -28,6 +35,9 @@ class StreamerOBJ : public AbstractRenderingStreamer {
 
 		static uint8_t queryCapabilities(const std::string & extension);
 		static const char * const fileExtension;
+
+	private:
+		const std::size_t blockSize;
 };
 }
 }
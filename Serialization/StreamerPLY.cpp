@@ -9,20 +9,27 @@
 	file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
 */
 #include "StreamerPLY.h"
+#include "MappedFile.h"
 #include "Serialization.h"
 #include "../Mesh/Mesh.h"
 #include "../Mesh/VertexAttributeIds.h"
 #include "../Mesh/VertexDescription.h"
 #include "../GLHeader.h"
 #include "../Helper.h"
+#include "../MeshUtils/ParallelFor.h"
 #include <Geometry/Convert.h>
 #include <Util/Graphics/Color.h>
 #include <Util/GenericAttribute.h>
+#include <Util/IO/FileName.h>
 #include <Util/StringUtils.h>
+#include <algorithm>
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <limits>
 #include <map>
 #include <sstream>
+#include <string>
 #include <vector>
 
 namespace Rendering {
@@ -211,6 +218,10 @@ class PLY_Element {
 		const Property & getProperty(int16_t index) const {
 			return entries[index];
 		}
+
+		int16_t getPropertyCount() const {
+			return static_cast<int16_t>(entries.size());
+		}
 		/**
 		 * // dataSize <64 !!!!!!!
 		 */
@@ -379,15 +390,11 @@ class PLY_Element {
 
 //-------------------------------------------------------------------------------------------------
 
-Mesh * StreamerPLY::loadMesh(std::istream & input) {
+/*! (internal) Generic loader that parses every row with PLY_Element::parseData.
+	Used for ascii files and for layouts not supported by the binary copy plan. */
+static Mesh * loadMeshRows(std::vector<char> & buffer) {
 	int cursor=0;
 
-	input.seekg(0, std::ios::end);
-	// Use the stream position as size for the new buffer
-	std::vector<char> buffer(input.tellg());
-	input.seekg(0, std::ios::beg);
-	input.read(buffer.data(), buffer.size());
-
 	// ---- read header ---
 	if( ! Util::StringUtils::beginsWith(buffer.data(), "ply") ) {
 		std::cerr <<" PLYFileLoader Error: Invalid ply header\n";
@@ -654,6 +661,568 @@ Mesh * StreamerPLY::loadMesh(std::istream & input) {
 	return mesh;
 }
 
+// -------------------------------------------------------------------
+// binary fast path
+
+namespace {
+
+//! Read the header; @p bodyOffset receives the position of the first byte after the header.
+bool readHeader(const uint8_t * data, size_t size, std::vector<PLY_Element> & elements, PLY_Element::format_t & format, size_t & bodyOffset) {
+	static const std::string endMarker("end_header");
+	const char * begin = reinterpret_cast<const char *>(data);
+	const char * end = begin + size;
+	if(size < 3 || std::string(begin, 3) != "ply")
+		return false;
+	const char * headerEnd = std::search(begin, end, endMarker.begin(), endMarker.end());
+	if(headerEnd == end)
+		return false;
+	headerEnd = std::find(headerEnd, end, '\n');
+	if(headerEnd == end)
+		return false;
+	bodyOffset = static_cast<size_t>(headerEnd - begin) + 1;
+
+	format = PLY_Element::ASCII;
+	std::istringstream header(std::string(begin, headerEnd));
+	std::string line;
+	while(std::getline(header, line)) {
+		std::istringstream s(line);
+		std::string keyword;
+		s >> keyword;
+		if(keyword == "element") {
+			std::string elemType;
+			uint32_t count = 0;
+			s >> elemType >> count;
+			elements.emplace_back(elemType, format, count);
+		} else if(keyword == "property" && !elements.empty()) {
+			std::string dataType;
+			std::string name;
+			s >> dataType;
+			if(dataType == "list") {
+				std::string countType;
+				s >> countType >> dataType >> name;
+				elements.back().addList(countType, dataType, name);
+			} else {
+				s >> name;
+				elements.back().addProperty(dataType, name);
+			}
+		} else if(keyword == "format") {
+			std::string sformat;
+			s >> sformat;
+			format = PLY_Element::getFormatId(sformat);
+		}
+	}
+	return true;
+}
+
+bool isBigEndianHost() {
+	const uint16_t one = 1;
+	uint8_t firstByte;
+	std::memcpy(&firstByte, &one, 1);
+	return firstByte == 0;
+}
+
+//! Read a value from unaligned memory; the byte order is reversed if @p swapBytes is set.
+template<typename T, bool swapBytes>
+inline T loadValue(const uint8_t * p) {
+	uint8_t bytes[sizeof(T)];
+	for(size_t i = 0; i < sizeof(T); ++i)
+		bytes[i] = swapBytes ? p[sizeof(T) - 1 - i] : p[i];
+	T value;
+	std::memcpy(&value, bytes, sizeof(T));
+	return value;
+}
+
+template<typename Target_t, bool swapBytes>
+inline Target_t loadAs(uint8_t type, const uint8_t * p) {
+	switch(type) {
+		case PLY_Element::TYPE_CHAR:	return static_cast<Target_t>(loadValue<int8_t, swapBytes>(p));
+		case PLY_Element::TYPE_UCHAR:	return static_cast<Target_t>(loadValue<uint8_t, swapBytes>(p));
+		case PLY_Element::TYPE_SHORT:	return static_cast<Target_t>(loadValue<int16_t, swapBytes>(p));
+		case PLY_Element::TYPE_USHORT:	return static_cast<Target_t>(loadValue<uint16_t, swapBytes>(p));
+		case PLY_Element::TYPE_INT:		return static_cast<Target_t>(loadValue<int32_t, swapBytes>(p));
+		case PLY_Element::TYPE_UINT:	return static_cast<Target_t>(loadValue<uint32_t, swapBytes>(p));
+		case PLY_Element::TYPE_FLOAT:	return static_cast<Target_t>(loadValue<float, swapBytes>(p));
+		case PLY_Element::TYPE_DOUBLE:	return static_cast<Target_t>(loadValue<double, swapBytes>(p));
+		default:						return Target_t(0);
+	}
+}
+
+// Conversions of the copy plan; they match the conversions of the generic loader.
+struct ToFloat {
+	template<typename T> float operator()(T v) const	{	return static_cast<float>(v);	}
+};
+struct ToNormalByte {
+	int8_t operator()(int8_t v) const					{	return v;	}
+	template<typename T> int8_t operator()(T v) const	{	return Geometry::Convert::toSigned<int8_t>(static_cast<float>(v));	}
+};
+struct ToColorByte {
+	uint8_t operator()(float v) const					{	return Util::Color4ub(Util::Color4f(v, 0.0f, 0.0f, 0.0f)).getR();	}
+	template<typename T> uint8_t operator()(T v) const	{	return static_cast<uint8_t>(v);	}
+};
+
+//! Tight loop converting one property of @p count rows into one vertex attribute value.
+template<typename Source_t, bool swapBytes, class Convert_t>
+void scatter(const uint8_t * source, size_t rowSize, uint8_t * target, size_t stride, uint32_t count, const Convert_t & convert) {
+	for(uint32_t i = 0; i < count; ++i, source += rowSize, target += stride) {
+		const auto value = convert(loadValue<Source_t, swapBytes>(source));
+		std::memcpy(target, &value, sizeof(value));
+	}
+}
+
+template<bool swapBytes, class Convert_t>
+void scatterProperty(uint8_t type, const uint8_t * source, size_t rowSize, uint8_t * target, size_t stride, uint32_t count, const Convert_t & convert) {
+	switch(type) {
+		case PLY_Element::TYPE_CHAR:	scatter<int8_t, swapBytes>(source, rowSize, target, stride, count, convert);	break;
+		case PLY_Element::TYPE_UCHAR:	scatter<uint8_t, swapBytes>(source, rowSize, target, stride, count, convert);	break;
+		case PLY_Element::TYPE_SHORT:	scatter<int16_t, swapBytes>(source, rowSize, target, stride, count, convert);	break;
+		case PLY_Element::TYPE_USHORT:	scatter<uint16_t, swapBytes>(source, rowSize, target, stride, count, convert);	break;
+		case PLY_Element::TYPE_INT:		scatter<int32_t, swapBytes>(source, rowSize, target, stride, count, convert);	break;
+		case PLY_Element::TYPE_UINT:	scatter<uint32_t, swapBytes>(source, rowSize, target, stride, count, convert);	break;
+		case PLY_Element::TYPE_FLOAT:	scatter<float, swapBytes>(source, rowSize, target, stride, count, convert);		break;
+		case PLY_Element::TYPE_DOUBLE:	scatter<double, swapBytes>(source, rowSize, target, stride, count, convert);	break;
+		default:
+			FAIL();
+	}
+}
+
+template<class Convert_t>
+void scatterProperty(bool swapBytes, uint8_t type, const uint8_t * source, size_t rowSize, uint8_t * target, size_t stride, uint32_t count, const Convert_t & convert) {
+	if(swapBytes)
+		scatterProperty<true>(type, source, rowSize, target, stride, count, convert);
+	else
+		scatterProperty<false>(type, source, rowSize, target, stride, count, convert);
+}
+
+/*! Copy plan for the rows of a binary vertex element without list properties:
+	the header is compiled into one (source offset, type, target offset, conversion) entry per
+	vertex attribute value, and every entry is executed as a typed loop over many rows. */
+struct VertexCopyPlan {
+	enum conversion_t { TO_FLOAT, TO_NORMAL_BYTE, TO_COLOR_BYTE, OPAQUE_ALPHA };
+	struct Copy {
+		uint32_t sourceOffset;
+		uint8_t sourceType;
+		uint32_t targetOffset;
+		conversion_t conversion;
+	};
+	VertexDescription vertexDescription;
+	std::vector<Copy> copies;
+	uint32_t rowSize;
+
+	VertexCopyPlan() : rowSize(0) {}
+
+	//! Returns false if the element cannot be handled by a copy plan.
+	bool init(const PLY_Element & element) {
+		std::vector<uint32_t> offsets;
+		for(int16_t i = 0; i < element.getPropertyCount(); ++i) {
+			const PLY_Element::Property & property = element.getProperty(i);
+			if(property.isList() || property.dataType == PLY_Element::TYPE_UNDEFINED)
+				return false;
+			offsets.push_back(rowSize);
+			rowSize += PLY_Element::getDataSize(property.dataType);
+		}
+		auto addCopies = [&](const std::vector<std::string> & names, uint32_t targetOffset, uint32_t valueSize, conversion_t conversion) {
+			for(const auto & name : names) {
+				const int16_t index = element.getPropertyIndex(name);
+				copies.push_back({offsets[index], element.getProperty(index).dataType, targetOffset, conversion});
+				targetOffset += valueSize;
+			}
+		};
+		auto hasAll = [&](const std::vector<std::string> & names) {
+			for(const auto & name : names) {
+				if(element.getPropertyIndex(name) < 0)
+					return false;
+			}
+			return true;
+		};
+
+		// same vertex format as loadMeshRows
+		if(!hasAll({"x", "y", "z"}))
+			return false;
+		addCopies({"x", "y", "z"}, vertexDescription.appendPosition3D().getOffset(), sizeof(float), TO_FLOAT);
+		if(hasAll({"nx", "ny", "nz"}))
+			addCopies({"nx", "ny", "nz"}, vertexDescription.appendNormalByte().getOffset(), sizeof(int8_t), TO_NORMAL_BYTE);
+		if(hasAll({"s", "t"})) {
+			addCopies({"s", "t"}, vertexDescription.appendTexCoord().getOffset(), sizeof(float), TO_FLOAT);
+		} else if(hasAll({"u", "v"})) {
+			addCopies({"u", "v"}, vertexDescription.appendTexCoord().getOffset(), sizeof(float), TO_FLOAT);
+		}
+		if(hasAll({"red", "green", "blue"})) {
+			const uint32_t colorOffset = vertexDescription.appendColorRGBAByte().getOffset();
+			addCopies({"red", "green", "blue"}, colorOffset, sizeof(uint8_t), TO_COLOR_BYTE);
+			if(hasAll({"alpha"}))
+				addCopies({"alpha"}, colorOffset + 3, sizeof(uint8_t), TO_COLOR_BYTE);
+			else
+				copies.push_back({0, PLY_Element::TYPE_UCHAR, colorOffset + 3, OPAQUE_ALPHA});
+		}
+		return true;
+	}
+
+	void execute(const uint8_t * rows, uint32_t count, uint8_t * vertices, bool swapBytes) const {
+		const size_t stride = vertexDescription.getVertexSize();
+		for(const auto & copy : copies) {
+			const uint8_t * source = rows + copy.sourceOffset;
+			uint8_t * target = vertices + copy.targetOffset;
+			switch(copy.conversion) {
+				case TO_FLOAT:
+					scatterProperty(swapBytes, copy.sourceType, source, rowSize, target, stride, count, ToFloat());
+					break;
+				case TO_NORMAL_BYTE:
+					scatterProperty(swapBytes, copy.sourceType, source, rowSize, target, stride, count, ToNormalByte());
+					break;
+				case TO_COLOR_BYTE:
+					scatterProperty(swapBytes, copy.sourceType, source, rowSize, target, stride, count, ToColorByte());
+					break;
+				case OPAQUE_ALPHA:
+					for(uint32_t i = 0; i < count; ++i, target += stride)
+						*target = 255;
+					break;
+			}
+		}
+	}
+};
+
+/*! Return the end of the row at @p row or nullptr if it exceeds @p end.
+	If @p listIndex is the index of a list property, @p listCount and @p listData receive its size and values. */
+template<bool swapBytes>
+const uint8_t * walkRow(const PLY_Element & element, const uint8_t * row, const uint8_t * end, int16_t listIndex, uint32_t & listCount, const uint8_t * & listData) {
+	for(int16_t i = 0; i < element.getPropertyCount(); ++i) {
+		const PLY_Element::Property & property = element.getProperty(i);
+		const uint8_t dataSize = PLY_Element::getDataSize(property.dataType);
+		uint32_t count = 1;
+		if(property.isList()) {
+			const uint8_t countSize = PLY_Element::getDataSize(property.countType);
+			if(countSize == 0 || static_cast<size_t>(end - row) < countSize)
+				return nullptr;
+			count = loadAs<uint32_t, swapBytes>(property.countType, row);
+			row += countSize;
+			if(i == listIndex) {
+				listCount = count;
+				listData = row;
+			}
+		}
+		if(dataSize == 0 || static_cast<uint64_t>(end - row) < static_cast<uint64_t>(count) * dataSize)
+			return nullptr;
+		row += count * dataSize;
+	}
+	return row;
+}
+
+//! Window over a body that is completely in memory (e.g. a mapped file).
+class MemoryWindow {
+		const uint8_t * cursor;
+		const uint8_t * const dataEnd;
+	public:
+		MemoryWindow(const uint8_t * data, size_t size) : cursor(data), dataEnd(data + size) {}
+
+		const uint8_t * data() const				{	return cursor;	}
+		const uint8_t * end() const					{	return dataEnd;	}
+		size_t available() const					{	return static_cast<size_t>(dataEnd - cursor);	}
+		bool require(size_t count) const			{	return available() >= count;	}
+		bool grow() const							{	return false;	}
+		bool mayContain(uint64_t count) const		{	return available() >= count;	}
+		void consume(size_t count)					{	cursor += count;	}
+};
+
+/*! Window over the body of a file read from a stream: the data is read in chunks, and only the data that has
+	not been consumed yet is kept in memory. */
+class StreamWindow {
+		static const size_t CHUNK_SIZE = 1 << 20;
+		std::istream & input;
+		std::vector<uint8_t> buffer;
+		size_t position;
+		//! Bytes left in the stream behind the buffer; maximum value if the stream is not seekable
+		uint64_t remaining;
+	public:
+		//! @p initialData contains the data that has already been read from @p input (beginning with the window).
+		StreamWindow(std::istream & _input, std::vector<uint8_t> && initialData) :
+				input(_input), buffer(std::move(initialData)), position(0), remaining(std::numeric_limits<uint64_t>::max()) {
+			const std::istream::pos_type current = input.tellg();
+			if(current != std::istream::pos_type(-1)) {
+				input.seekg(0, std::ios::end);
+				const std::istream::pos_type streamEnd = input.tellg();
+				input.seekg(current);
+				if(streamEnd != std::istream::pos_type(-1) && input.good())
+					remaining = static_cast<uint64_t>(streamEnd - current);
+			}
+			input.clear();
+		}
+
+		const uint8_t * data() const				{	return buffer.data() + position;	}
+		const uint8_t * end() const					{	return buffer.data() + buffer.size();	}
+		size_t available() const					{	return buffer.size() - position;	}
+		//! Read data until @p count bytes are available; returns false if the stream ends before.
+		bool require(size_t count) {
+			if(available() >= count)
+				return true;
+			buffer.erase(buffer.begin(), buffer.begin() + position);
+			position = 0;
+			const size_t oldSize = buffer.size();
+			buffer.resize(std::max(count, oldSize + CHUNK_SIZE));
+			input.read(reinterpret_cast<char *>(buffer.data() + oldSize), buffer.size() - oldSize);
+			buffer.resize(oldSize + static_cast<size_t>(input.gcount()));
+			if(remaining != std::numeric_limits<uint64_t>::max())
+				remaining -= static_cast<uint64_t>(input.gcount());
+			return available() >= count;
+		}
+		//! Read the next chunk; returns false at the end of the stream.
+		bool grow()									{	return require(available() + 1);	}
+		//! Returns false if the rest of the stream is known to be shorter than @p count bytes.
+		bool mayContain(uint64_t count) const {
+			return remaining == std::numeric_limits<uint64_t>::max() || available() + remaining >= count;
+		}
+		void consume(size_t count)					{	position += count;	}
+};
+
+/*! Determine the size of the next row of @p element in @p window, reading more data if necessary; returns false
+	if the data is truncated. See walkRow() for @p listIndex, @p listCount and @p listData (valid until the window
+	is changed). */
+template<bool swapBytes, class Window_t>
+bool nextRow(const PLY_Element & element, Window_t & window, int16_t listIndex, size_t & rowSize, uint32_t & listCount, const uint8_t * & listData) {
+	while(true) {
+		const uint8_t * rowEnd = walkRow<swapBytes>(element, window.data(), window.end(), listIndex, listCount, listData);
+		if(rowEnd != nullptr) {
+			rowSize = static_cast<size_t>(rowEnd - window.data());
+			return true;
+		}
+		if(!window.grow())
+			return false;
+	}
+}
+
+/*! Read the faces (triangulated as fans) into the index data of @p mesh; returns false if the data is truncated
+	or a face references a vertex index >= @p vertexCount. */
+template<bool swapBytes, class Window_t>
+bool readFaces(const PLY_Element & element, Window_t & window, uint32_t vertexCount, Mesh * mesh) {
+	int16_t listIndex = element.getPropertyIndex("vertex_indices");
+	if(listIndex < 0)
+		listIndex = element.getPropertyIndex("vertex_index");
+	const uint8_t indexType = listIndex >= 0 ? element.getProperty(listIndex).dataType : PLY_Element::TYPE_UNDEFINED;
+	const uint8_t indexSize = PLY_Element::getDataSize(indexType);
+
+	// the faces are read in a single pass, so the number of indices is not known in advance
+	std::vector<uint32_t> faceIndices;
+	for(int j = 0; j < element.count; ++j) {
+		size_t rowSize;
+		uint32_t listCount = 0;
+		const uint8_t * listData = nullptr;
+		if(!nextRow<swapBytes>(element, window, listIndex, rowSize, listCount, listData))
+			return false;
+		if(listIndex >= 0 && listCount >= 3) {
+			if(faceIndices.size() + 3 * (static_cast<uint64_t>(listCount) - 2) > std::numeric_limits<uint32_t>::max())
+				return false;
+			const uint32_t first = loadAs<uint32_t, swapBytes>(indexType, listData);
+			uint32_t previous = loadAs<uint32_t, swapBytes>(indexType, listData + indexSize);
+			for(uint32_t k = 2; k < listCount; ++k) {
+				const uint32_t current = loadAs<uint32_t, swapBytes>(indexType, listData + k * indexSize);
+				faceIndices.insert(faceIndices.end(), {first, previous, current});
+				previous = current;
+			}
+		}
+		window.consume(rowSize);
+	}
+	if(faceIndices.empty())
+		return true;
+
+	MeshIndexData & indices = mesh->openIndexData();
+	indices.allocate(static_cast<uint32_t>(faceIndices.size()));
+	std::copy(faceIndices.begin(), faceIndices.end(), indices.data());
+	indices.updateIndexRange();
+	if(indices.getMaxIndex() >= vertexCount) {
+		WARN("StreamerPLY: face references vertex " + std::to_string(indices.getMaxIndex()) + " of " + std::to_string(vertexCount) + " vertices.");
+		return false;
+	}
+	return true;
+}
+
+//! Skip the data of an element; returns false if the data is truncated.
+template<bool swapBytes, class Window_t>
+bool skipElement(const PLY_Element & element, Window_t & window) {
+	for(int j = 0; j < element.count; ++j) {
+		size_t rowSize;
+		uint32_t listCount;
+		const uint8_t * listData;
+		if(!nextRow<swapBytes>(element, window, -1, rowSize, listCount, listData))
+			return false;
+		window.consume(rowSize);
+	}
+	return true;
+}
+
+//! Returns true if all elements of the binary file can be read by readBinary().
+bool canReadBinary(const std::vector<PLY_Element> & elements, PLY_Element::format_t format) {
+	if(format != PLY_Element::BINARY_BIG_ENDIAN && format != PLY_Element::BINARY_LITLLE_ENDIAN)
+		return false;
+	for(const auto & element : elements) {
+		if(element.name == "vertex") {
+			VertexCopyPlan plan;
+			if(!plan.init(element))
+				return false;
+		}
+		for(int16_t i = 0; i < element.getPropertyCount(); ++i) {
+			const PLY_Element::Property & property = element.getProperty(i);
+			if(property.dataType == PLY_Element::TYPE_UNDEFINED || (property.isList() && property.countType == PLY_Element::TYPE_UNDEFINED))
+				return false;
+		}
+	}
+	return true;
+}
+
+/*! Read the body of a binary file from @p window (MemoryWindow or StreamWindow) using a VertexCopyPlan for the vertices.
+	Point clouds (files without faces) are split into meshes of at most @p maxVerticesPerChunk
+	vertices; otherwise a single mesh is created. Every mesh is passed to @p consumer. */
+template<class Window_t>
+bool readBinary(const std::vector<PLY_Element> & elements, Window_t & window, bool swapBytes,
+				uint32_t maxVerticesPerChunk, const std::function<void(Util::Reference<Mesh>)> & consumer) {
+	static const uint32_t ROWS_PER_BLOCK = 4096; // rows converted at once; keeps the source rows in the cache
+	static const size_t BYTES_PER_READ = 16 << 20; // vertex data requested from the window at once
+
+	bool hasFaces = false;
+	uint32_t totalVertexCount = 0;
+	for(const auto & element : elements) {
+		hasFaces |= (element.name == "face" && element.count > 0);
+		if(element.name == "vertex")
+			totalVertexCount = static_cast<uint32_t>(std::max(0, element.count));
+	}
+	Util::Reference<Mesh> mesh = hasFaces ? new Mesh : nullptr;
+
+	for(const auto & element : elements) {
+		bool valid = true;
+		if(element.name == "vertex") {
+			VertexCopyPlan plan;
+			plan.init(element);
+			const uint32_t vertexCount = static_cast<uint32_t>(std::max(0, element.count));
+			if(!window.mayContain(static_cast<uint64_t>(vertexCount) * plan.rowSize)) {
+				WARN("StreamerPLY: unexpected end of vertex data.");
+				return false;
+			}
+			const uint32_t rowsPerRead = static_cast<uint32_t>(std::max<size_t>(1, BYTES_PER_READ / plan.rowSize));
+			const uint32_t chunkSize = hasFaces ? std::max(1u, vertexCount) : std::max(1u, maxVerticesPerChunk);
+			for(uint32_t first = 0; first < vertexCount; first += chunkSize) { // no (empty) chunk for an empty element
+				const uint32_t chunkVertexCount = std::min(chunkSize, vertexCount - first);
+				Util::Reference<Mesh> chunk = hasFaces ? mesh : new Mesh;
+				MeshVertexData & vertices = chunk->openVertexData();
+				vertices.allocate(chunkVertexCount, plan.vertexDescription);
+				const size_t stride = plan.vertexDescription.getVertexSize();
+				for(uint32_t read = 0; read < chunkVertexCount; read += rowsPerRead) {
+					const uint32_t rowCount = std::min(rowsPerRead, chunkVertexCount - read);
+					if(!window.require(static_cast<size_t>(rowCount) * plan.rowSize)) {
+						WARN("StreamerPLY: unexpected end of vertex data.");
+						return false;
+					}
+					const uint8_t * rows = window.data();
+					uint8_t * target = vertices.data() + static_cast<size_t>(read) * stride;
+					MeshUtils::parallelFor(rowCount, 16 * ROWS_PER_BLOCK, [&](uint32_t begin, uint32_t rangeEnd) {
+						for(uint32_t block = begin; block < rangeEnd; block += ROWS_PER_BLOCK)
+							plan.execute(rows + static_cast<size_t>(block) * plan.rowSize, std::min(ROWS_PER_BLOCK, rangeEnd - block), target + block * stride, swapBytes);
+					});
+					window.consume(static_cast<size_t>(rowCount) * plan.rowSize);
+				}
+				vertices.updateBoundingBox();
+				if(!hasFaces) {
+					chunk->setDrawMode(Mesh::DRAW_POINTS);
+					chunk->setUseIndexData(false);
+					consumer(chunk);
+				}
+			}
+		} else if(element.name == "face" && hasFaces) {
+			valid = swapBytes ? readFaces<true>(element, window, totalVertexCount, mesh.get())
+							  : readFaces<false>(element, window, totalVertexCount, mesh.get());
+		} else {
+			valid = swapBytes ? skipElement<true>(element, window) : skipElement<false>(element, window);
+		}
+		if(!valid) {
+			WARN("StreamerPLY: invalid or truncated data in element \"" + element.name + "\".");
+			return false;
+		}
+	}
+	if(hasFaces)
+		consumer(mesh);
+	return true;
+}
+
+}
+
+Mesh * StreamerPLY::loadMesh(std::istream & input) {
+	static const size_t CHUNK_SIZE = 64 * 1024;
+	// read chunks until the header is complete
+	std::vector<uint8_t> data;
+	std::vector<PLY_Element> elements;
+	PLY_Element::format_t format;
+	size_t bodyOffset;
+	bool hasHeader = false;
+	while(!hasHeader && input.good()) {
+		const size_t oldSize = data.size();
+		data.resize(oldSize + CHUNK_SIZE);
+		input.read(reinterpret_cast<char *>(data.data() + oldSize), CHUNK_SIZE);
+		data.resize(oldSize + static_cast<size_t>(input.gcount()));
+		hasHeader = readHeader(data.data(), data.size(), elements, format, bodyOffset);
+		if(data.size() >= 3 && std::string(data.begin(), data.begin() + 3) != "ply")
+			break;
+	}
+	if(hasHeader && canReadBinary(elements, format)) {
+		// only a window of the body is kept in memory
+		data.erase(data.begin(), data.begin() + bodyOffset);
+		StreamWindow window(input, std::move(data));
+		Util::Reference<Mesh> mesh;
+		const bool swapBytes = (format == PLY_Element::BINARY_BIG_ENDIAN) != isBigEndianHost();
+		if(!readBinary(elements, window, swapBytes, std::numeric_limits<uint32_t>::max(),
+				[&mesh](Util::Reference<Mesh> m) { mesh = m; }))
+			return nullptr;
+		if(mesh.isNull()) { // a point cloud without points
+			mesh = new Mesh;
+			mesh->setDrawMode(Mesh::DRAW_POINTS);
+			mesh->setUseIndexData(false);
+		}
+		return mesh.detachAndDecrease();
+	}
+	// the generic loader needs the complete file
+	std::vector<char> buffer(data.begin(), data.end());
+	data = std::vector<uint8_t>();
+	while(input.good()) {
+		const size_t oldSize = buffer.size();
+		buffer.resize(oldSize + CHUNK_SIZE);
+		input.read(buffer.data() + oldSize, CHUNK_SIZE);
+		buffer.resize(oldSize + static_cast<size_t>(input.gcount()));
+	}
+	buffer.push_back('\0'); // terminate the data for parsing ascii values
+	return loadMeshRows(buffer);
+}
+
+//! (static)
+bool StreamerPLY::loadMeshChunks(const Util::FileName & url, uint32_t maxVerticesPerChunk, const std::function<void(Util::Reference<Mesh>)> & consumer) {
+	size_t size = 0;
+	std::shared_ptr<uint8_t> mapping = mapFile(url.getPath(), size);
+	if(!mapping) {
+		WARN("StreamerPLY::loadMeshChunks: Cannot map file \"" + url.toString() + "\".");
+		return false;
+	}
+	std::vector<PLY_Element> elements;
+	PLY_Element::format_t format;
+	size_t bodyOffset;
+	if(!readHeader(mapping.get(), size, elements, format, bodyOffset)) {
+		WARN("StreamerPLY::loadMeshChunks: Invalid header in \"" + url.toString() + "\".");
+		return false;
+	}
+	auto setFileName = [&](Util::Reference<Mesh> mesh) {
+		mesh->setFileName(url);
+		consumer(mesh);
+	};
+	if(canReadBinary(elements, format)) {
+		const bool swapBytes = (format == PLY_Element::BINARY_BIG_ENDIAN) != isBigEndianHost();
+		MemoryWindow window(mapping.get() + bodyOffset, size - bodyOffset);
+		return readBinary(elements, window, swapBytes, maxVerticesPerChunk, setFileName);
+	}
+	// ascii data is loaded as a single mesh
+	std::vector<char> buffer(mapping.get(), mapping.get() + size);
+	mapping.reset();
+	buffer.push_back('\0');
+	Util::Reference<Mesh> mesh = loadMeshRows(buffer);
+	if(mesh.isNull())
+		return false;
+	setFileName(mesh);
+	return true;
+}
+
 /**
  * ---|> GenericLoader
  */
@@ -670,6 +1239,9 @@ Util::GenericAttributeList * StreamerPLY::loadGeneric(std::istream & input){
 
 bool StreamerPLY::saveMesh(Mesh * mesh, std::ostream & output) {
 	VertexDescription vd = mesh->getVertexDescription();
+	const Geometry::Matrix4x4 * dequantization = mesh->openVertexData().getPositionDequantization();
+	if(dequantization != nullptr && !dequantization->isIdentity())
+		WARN("StreamerPLY::saveMesh: The dequantization of the positions is not stored; the quantized positions are written.");
 
 	output << "ply" << std::endl;
 	output << "comment minsg 1.0" << std::endl;
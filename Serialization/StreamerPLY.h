@@ -12,7 +12,13 @@
 #define RENDERING_STREAMERPLY_H_
 
 #include "AbstractRenderingStreamer.h"
+#include <Util/References.h>
+#include <cstdint>
+#include <functional>
 
+namespace Util {
+class FileName;
+}
 namespace Rendering {
 namespace Serialization {
 
@@ -28,6 +34,15 @@ class StreamerPLY : public AbstractRenderingStreamer {
 		Mesh * loadMesh(std::istream & input) override;
 		bool saveMesh(Mesh * mesh, std::ostream & output) override;
 
+		/*! Load a local .ply file in chunks (e.g. large laser scans).
+			The file is memory mapped. For binary files, the header is compiled into a copy plan that converts
+			the vertex properties with typed loops on all hardware threads, swapping the byte order if necessary.
+			A point cloud (a file without faces) is split into meshes of at most @p maxVerticesPerChunk points,
+			so no single giant allocation is needed; each mesh is passed to @p consumer as soon as it is complete.
+			Files with faces and ascii files are passed as a single mesh.
+			@return false if the file cannot be read */
+		static bool loadMeshChunks(const Util::FileName & url, uint32_t maxVerticesPerChunk, const std::function<void(Util::Reference<Mesh>)> & consumer);
+
 		static uint8_t queryCapabilities(const std::string & extension);
 		static const char * const fileExtension;
 };
@@ -7,6 +7,7 @@
 	file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
 */
 #include "StreamerXYZ.h"
+#include "NumberParser.h"
 #include "Serialization.h"
 #include "../Mesh/Mesh.h"
 #include "../Mesh/VertexDescription.h"
@@ -16,15 +17,30 @@
 #include <Util/GenericAttribute.h>
 #include <Util/IO/FileUtils.h>
 #include <Util/Macros.h>
+#include <Util/References.h>
+#include <Util/StringUtils.h>
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
 #include <istream>
-#include <random>
 #include <limits>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
 
 namespace Rendering {
 namespace Serialization {
 
 const char * const StreamerXYZ::fileExtension = "xyz";
 
+static uint8_t toColorByte(float value) {
+	return static_cast<uint8_t>(std::min(255.0f, std::max(0.0f, value)));
+}
+
 Mesh * StreamerXYZ::loadMesh(std::istream & input, std::size_t numPoints) {
 	VertexDescription vertexDesc;
 	vertexDesc.appendPosition3D();
@@ -44,16 +60,22 @@ Mesh * StreamerXYZ::loadMesh(std::istream & input, std::size_t numPoints) {
 		FAIL();
 	}
 	std::vector<Point> points;
+	if(numPoints != 0)
+		points.reserve(numPoints);
 
-	float x, y, z;
-	uint16_t r, g, b;
-	while(input.good()) {
-		input >> x >> y >> z >> r >> g >> b;
-		points.emplace_back(x, y, z, r, g, b);
-		
-		if(numPoints != 0 && points.size() >= numPoints) {
-			break;
-		}
+	// lines with less than three numbers (e.g. empty lines) are skipped; missing colors are white
+	std::string line;
+	float values[6];
+	while((numPoints == 0 || points.size() < numPoints) && std::getline(input, line)) {
+		const char * cursor = line.data();
+		const char * end = cursor + line.size();
+		uint32_t valueCount = 0;
+		while(valueCount < 6 && scanFloat(cursor, end, values[valueCount]))
+			++valueCount;
+		if(valueCount < 3)
+			continue;
+		std::fill(values + valueCount, values + 6, 255.0f);
+		points.emplace_back(values[0], values[1], values[2], toColorByte(values[3]), toColorByte(values[4]), toColorByte(values[5]));
 	}
 
 	auto mesh = new Mesh(vertexDesc, points.size(), 0);
@@ -71,8 +93,10 @@ Mesh * StreamerXYZ::loadMesh(std::istream & input, std::size_t numPoints) {
 Util::GenericAttributeList * StreamerXYZ::loadGeneric(std::istream & input) {
 	auto list = new Util::GenericAttributeList;
 	while(input.good()) {
-		Mesh * mesh = loadMesh(input, 1000000);
-		Util::GenericAttributeMap * desc = Serialization::createMeshDescription(mesh);
+		Util::Reference<Mesh> mesh = loadMesh(input, 1000000);
+		if(mesh->getVertexCount() == 0 && !list->empty())
+			break;
+		Util::GenericAttributeMap * desc = Serialization::createMeshDescription(mesh.get());
 		list->push_back(desc);
 	}
 	return list;
@@ -116,19 +140,8 @@ void StreamerXYZ::clusterPoints( std::istream & input, std::vector<std::ostream*
 	const size_t numClusters = outputs.size();
 	const size_t numSamples = numClusters * 100;
 	
-//	input.seekg( 0, std::ios::end);
-//	const uint64_t fileSize = static_cast<uint64_t>(input.tellg());
-
-	input.seekg( 0, std::ios::beg);
-	uint64_t fileSize = 0;
-	while(true){
-		input.seekg( (1024*1024), std::ios::cur);
-		if(!input.good())
-			break;
-		fileSize+=1024*1024;
-		std::cout << ".";
-	}
-	input.clear(std::ios::eofbit);
+	input.seekg( 0, std::ios::end);
+	const uint64_t fileSize = static_cast<uint64_t>(input.tellg());
 	input.seekg( 0, std::ios::beg);
 	FAIL_IF(!input.good());
 		
@@ -224,10 +237,12 @@ void StreamerXYZ::clusterPoints( std::istream & input, std::vector<std::ostream*
 		while(input.good()) {
 			std::string line;
 			std::getline(input,line);
-			std::istringstream lineInput(line);
 			
 			dataCounter+=line.length()+1;
-			lineInput >> x >> y >> z;
+			const char * cursor = line.data();
+			const char * end = cursor + line.size();
+			if(!scanFloat(cursor, end, x) || !scanFloat(cursor, end, y) || !scanFloat(cursor, end, z))
+				continue;
 
 			float closestDist = std::numeric_limits<float>::max();
 			auto outStreamIt = outputs.begin();
@@ -240,7 +255,7 @@ void StreamerXYZ::clusterPoints( std::istream & input, std::vector<std::ostream*
 				}
 				++outStreamIt;
 			}
-			**selectedStreamIt << line;
+			**selectedStreamIt << line << "\n";
 			
 			++pointCounter;
 			if( (pointCounter%1000000) == 0){
@@ -252,5 +267,318 @@ void StreamerXYZ::clusterPoints( std::istream & input, std::vector<std::ostream*
 	std::cout << "Done.\n";
 	
 }
+// -------------------------------------------------------------------
+// tiling
+
+namespace {
+
+//! Cell of the tiling grid.
+struct CellKey {
+	int32_t x, y, z;
+	bool operator==(const CellKey & other) const {
+		return x == other.x && y == other.y && z == other.z;
+	}
+};
+struct CellKeyHash {
+	size_t operator()(const CellKey & key) const {
+		return static_cast<size_t>((static_cast<uint64_t>(static_cast<uint32_t>(key.x)) * 0x9E3779B97F4A7C15ull)
+				^ (static_cast<uint64_t>(static_cast<uint32_t>(key.y)) * 0xC2B2AE3D27D4EB4Full)
+				^ (static_cast<uint64_t>(static_cast<uint32_t>(key.z)) * 0x165667B19E3779F9ull));
+	}
+};
+
+inline int32_t getCellCoordinate(float value, float cellSize) {
+	const float cell = std::floor(value / cellSize);
+	return static_cast<int32_t>(std::max(-2147483520.0f, std::min(2147483520.0f, cell)));
+}
+
+//! Output file of a tile while the points are distributed.
+struct PendingTile {
+	CellKey key;
+	Util::FileName file;
+	uint64_t pointCount;
+	Geometry::Box bounds;
+	std::vector<char> buffer;
+	bool created;
+
+	PendingTile(const CellKey & _key, Util::FileName _file) : key(_key), file(std::move(_file)), pointCount(0), created(false) {
+		bounds.invalidate();
+	}
+};
+
+/*! Appends data blocks to files on a separate thread.
+	push() blocks while more than @a maxQueuedBytes are waiting to be written. */
+class TileWriter {
+	public:
+		explicit TileWriter(size_t _maxQueuedBytes) :
+			queuedBytes(0), maxQueuedBytes(_maxQueuedBytes), finished(false), failed(false), thread(&TileWriter::run, this) {
+		}
+		~TileWriter() {
+			finish();
+		}
+
+		void push(const Util::FileName & file, bool append, std::vector<char> && data) {
+			std::unique_lock<std::mutex> lock(mutex);
+			spaceAvailable.wait(lock, [&] { return queuedBytes == 0 || queuedBytes + data.size() <= maxQueuedBytes; });
+			queuedBytes += data.size();
+			jobs.push_back({file, append, std::move(data)});
+			jobAvailable.notify_one();
+		}
+
+		//! Write all queued data; returns false if a file could not be written.
+		bool finish() {
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				finished = true;
+			}
+			jobAvailable.notify_one();
+			if(thread.joinable())
+				thread.join();
+			return !failed;
+		}
+
+	private:
+		struct Job {
+			Util::FileName file;
+			bool append;
+			std::vector<char> data;
+		};
+		std::mutex mutex;
+		std::condition_variable jobAvailable;
+		std::condition_variable spaceAvailable;
+		std::deque<Job> jobs;
+		size_t queuedBytes;
+		const size_t maxQueuedBytes;
+		bool finished;
+		bool failed;
+		std::thread thread;
+
+		void run() {
+			while(true) {
+				Job job;
+				{
+					std::unique_lock<std::mutex> lock(mutex);
+					jobAvailable.wait(lock, [&] { return finished || !jobs.empty(); });
+					if(jobs.empty())
+						return;
+					job = std::move(jobs.front());
+					jobs.pop_front();
+				}
+				auto output = job.append ? Util::FileUtils::openForAppending(job.file) : Util::FileUtils::openForWriting(job.file);
+				if(output)
+					output->write(job.data.data(), static_cast<std::streamsize>(job.data.size()));
+				if(!output || !output->good()) {
+					WARN("StreamerXYZ: Cannot write to \"" + job.file.toString() + "\".");
+					failed = true;
+				}
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					queuedBytes -= job.data.size();
+				}
+				spaceAvailable.notify_one();
+			}
+		}
+};
+
+/*! Read the points from @p input and append their lines to the file of the cell returned by @p getCell.
+	The files are created by @p createTile. Half of @p memoryLimit is used for buffering lines per tile,
+	the other half for the blocks waiting to be written. */
+template<class GetCell_t, class CreateTile_t>
+bool distributePoints(std::istream & input, size_t memoryLimit, const GetCell_t & getCell, const CreateTile_t & createTile, std::vector<PendingTile> & tiles) {
+	static const size_t BLOCK_SIZE = 4 * 1024 * 1024;
+	const size_t bufferLimit = std::max<size_t>(memoryLimit / 2, 1);
+	const size_t flushSize = std::min<size_t>(1024 * 1024, std::max<size_t>(bufferLimit / 16, 4096));
+
+	TileWriter writer(std::max<size_t>(memoryLimit / 2, 1));
+	std::unordered_map<CellKey, size_t, CellKeyHash> tileIndices;
+	size_t bufferedBytes = 0;
+	auto flush = [&](PendingTile & tile) {
+		bufferedBytes -= tile.buffer.size();
+		writer.push(tile.file, tile.created, std::move(tile.buffer));
+		tile.buffer = std::vector<char>();
+		tile.created = true;
+	};
+
+	std::vector<char> block(BLOCK_SIZE);
+	size_t carry = 0;
+	size_t lastTile = std::numeric_limits<size_t>::max();
+	bool endOfInput = false;
+	while(!endOfInput) {
+		if(carry == block.size())
+			block.resize(2 * block.size()); // a single line is longer than the block
+		input.read(block.data() + carry, static_cast<std::streamsize>(block.size() - carry));
+		const size_t available = carry + static_cast<size_t>(input.gcount());
+		endOfInput = !input;
+
+		const char * lineBegin = block.data();
+		const char * const blockEnd = block.data() + available;
+		while(lineBegin < blockEnd) {
+			const char * lineEnd = static_cast<const char *>(std::memchr(lineBegin, '\n', blockEnd - lineBegin));
+			if(!lineEnd) {
+				if(!endOfInput)
+					break;
+				lineEnd = blockEnd;
+			}
+			const char * cursor = lineBegin;
+			float x, y, z;
+			if(scanFloat(cursor, lineEnd, x) && scanFloat(cursor, lineEnd, y) && scanFloat(cursor, lineEnd, z)) {
+				const CellKey key = getCell(x, y, z);
+				if(lastTile >= tiles.size() || !(tiles[lastTile].key == key)) {
+					auto inserted = tileIndices.emplace(key, tiles.size());
+					if(inserted.second)
+						tiles.push_back(createTile(key));
+					lastTile = inserted.first->second;
+				}
+				PendingTile & tile = tiles[lastTile];
+				tile.buffer.insert(tile.buffer.end(), lineBegin, lineEnd);
+				tile.buffer.push_back('\n');
+				bufferedBytes += static_cast<size_t>(lineEnd - lineBegin) + 1;
+				tile.bounds.include(Geometry::Vec3(x, y, z));
+				++tile.pointCount;
+				if(tile.buffer.size() >= flushSize)
+					flush(tile);
+				if(bufferedBytes > bufferLimit) {
+					for(auto & other : tiles) {
+						if(!other.buffer.empty())
+							flush(other);
+					}
+				}
+			}
+			lineBegin = lineEnd + 1;
+		}
+		carry = lineBegin < blockEnd ? static_cast<size_t>(blockEnd - lineBegin) : 0;
+		std::copy(blockEnd - carry, blockEnd, block.begin());
+	}
+	for(auto & tile : tiles) {
+		if(!tile.buffer.empty() || !tile.created)
+			flush(tile);
+	}
+	return writer.finish();
+}
+
+Util::FileName getTileFileName(const Util::FileName & prefix, const std::string & postfix) {
+	return Util::FileName(prefix.toString() + postfix + "." + StreamerXYZ::fileExtension);
+}
+
+/*! Split @p tile into octants while it contains more than maxPointsPerTile points.
+	@p key is the cell of the tile in a grid with the given @p cellSize. */
+bool refineTile(const StreamerXYZ::TileInfo & tile, const CellKey & key, float cellSize, uint32_t depth,
+				const StreamerXYZ::TilingOptions & options, std::vector<StreamerXYZ::TileInfo> & result) {
+	if(options.maxPointsPerTile == 0 || tile.pointCount <= options.maxPointsPerTile || depth >= options.maxDepth) {
+		result.push_back(tile);
+		return true;
+	}
+	const float childSize = cellSize * 0.5f;
+	// tile files end with ".xyz" (see getTileFileName)
+	const std::string fileString = tile.file.toString();
+	const Util::FileName prefix(fileString.substr(0, fileString.size() - std::strlen(StreamerXYZ::fileExtension) - 1));
+
+	std::vector<PendingTile> children;
+	{
+		auto input = Util::FileUtils::openForReading(tile.file);
+		if(!input)
+			return false;
+		auto getOctant = [&](float x, float y, float z) {
+			// clamp, as the rounding may differ from the parent's
+			const CellKey octant = {
+				std::max(0, std::min(1, getCellCoordinate(x, childSize) - 2 * key.x)),
+				std::max(0, std::min(1, getCellCoordinate(y, childSize) - 2 * key.y)),
+				std::max(0, std::min(1, getCellCoordinate(z, childSize) - 2 * key.z))
+			};
+			return octant;
+		};
+		auto createChild = [&](const CellKey & octant) {
+			return PendingTile(octant, getTileFileName(prefix, "_" + Util::StringUtils::toString(octant.x + 2 * octant.y + 4 * octant.z)));
+		};
+		if(!distributePoints(*input, options.memoryLimit, getOctant, createChild, children))
+			return false;
+	}
+	Util::FileUtils::remove(tile.file);
+	bool success = true;
+	for(const auto & child : children) {
+		const CellKey childKey = {2 * key.x + child.key.x, 2 * key.y + child.key.y, 2 * key.z + child.key.z};
+		success &= refineTile({child.file, child.pointCount, child.bounds}, childKey, childSize, depth + 1, options, result);
+	}
+	return success;
+}
+
+}
+
+//! (static)
+std::vector<StreamerXYZ::TileInfo> StreamerXYZ::tilePoints(const Util::FileName & inputFile, const Util::FileName & outputPrefix, const TilingOptions & options) {
+	auto input = Util::FileUtils::openForReading(inputFile);
+	if(!input || !input->good()) {
+		WARN("StreamerXYZ::tilePoints: Cannot open \"" + inputFile.toString() + "\".");
+		return std::vector<TileInfo>();
+	}
+	return tilePoints(*input, outputPrefix, options);
+}
+
+//! (static)
+std::vector<StreamerXYZ::TileInfo> StreamerXYZ::tilePoints(std::istream & input, const Util::FileName & outputPrefix, const TilingOptions & options) {
+	const float tileSize = options.tileSize;
+	std::vector<PendingTile> tiles;
+	auto getCell = [tileSize](float x, float y, float z) {
+		const CellKey key = {getCellCoordinate(x, tileSize), getCellCoordinate(y, tileSize), getCellCoordinate(z, tileSize)};
+		return key;
+	};
+	auto createTile = [&outputPrefix](const CellKey & key) {
+		std::ostringstream postfix;
+		postfix << '_' << key.x << '_' << key.y << '_' << key.z;
+		return PendingTile(key, getTileFileName(outputPrefix, postfix.str()));
+	};
+	if(tileSize <= 0.0f || !distributePoints(input, options.memoryLimit, getCell, createTile, tiles))
+		return std::vector<TileInfo>();
+
+	std::vector<TileInfo> result;
+	for(const auto & tile : tiles) {
+		if(!refineTile({tile.file, tile.pointCount, tile.bounds}, tile.key, tileSize, 0, options, result))
+			return std::vector<TileInfo>();
+	}
+
+	// manifest: one line per tile: pointCount minX minY minZ maxX maxY maxZ fileName
+	auto manifest = Util::FileUtils::openForWriting(Util::FileName(outputPrefix.toString() + "_tiles.txt"));
+	if(!manifest) {
+		WARN("StreamerXYZ::tilePoints: Cannot write the manifest.");
+		return std::vector<TileInfo>();
+	}
+	manifest->precision(std::numeric_limits<float>::max_digits10);
+	*manifest << "# pointCount minX minY minZ maxX maxY maxZ file\n";
+	for(const auto & tile : result) {
+		*manifest << tile.pointCount << ' ' << tile.bounds.getMinX() << ' ' << tile.bounds.getMinY() << ' ' << tile.bounds.getMinZ() << ' '
+				<< tile.bounds.getMaxX() << ' ' << tile.bounds.getMaxY() << ' ' << tile.bounds.getMaxZ() << ' ' << tile.file.toString() << '\n';
+	}
+	return result;
+}
+
+//! (static)
+std::vector<StreamerXYZ::TileInfo> StreamerXYZ::loadTileManifest(const Util::FileName & manifestFile) {
+	std::vector<TileInfo> tiles;
+	auto input = Util::FileUtils::openForReading(manifestFile);
+	if(!input) {
+		WARN("StreamerXYZ::loadTileManifest: Cannot open \"" + manifestFile.toString() + "\".");
+		return tiles;
+	}
+	std::string line;
+	while(std::getline(*input, line)) {
+		if(line.empty() || line[0] == '#')
+			continue;
+		std::istringstream lineInput(line);
+		TileInfo tile;
+		float minX, minY, minZ, maxX, maxY, maxZ;
+		lineInput >> tile.pointCount >> minX >> minY >> minZ >> maxX >> maxY >> maxZ;
+		std::string file;
+		std::getline(lineInput >> std::ws, file);
+		if(lineInput.fail() || file.empty()) {
+			WARN("StreamerXYZ::loadTileManifest: Invalid line \"" + line + "\".");
+			continue;
+		}
+		tile.file = Util::FileName(file);
+		tile.bounds = Geometry::Box(minX, maxX, minY, maxY, minZ, maxZ);
+		tiles.push_back(tile);
+	}
+	return tiles;
+}
+
 }
 }
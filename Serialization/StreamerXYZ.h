@@ -10,10 +10,11 @@
 #define RENDERING_STREAMERXYZ_H_
 
 #include "AbstractRenderingStreamer.h"
+#include <Geometry/Box.h>
+#include <Util/IO/FileName.h>
+#include <cstddef>
+#include <cstdint>
 #include <vector>
-namespace Util{
-class FileName;
-}
 
 namespace Rendering {
 namespace Serialization {
@@ -39,6 +40,42 @@ class StreamerXYZ : public AbstractRenderingStreamer {
 		static void clusterPoints( const Util::FileName & inputFile, size_t numberOfClusters );
 		static void clusterPoints( std::istream & input, std::vector<std::ostream*> & outputs );
 
+		//! Options for tilePoints().
+		struct TilingOptions {
+			//! Edge length of the cubic cells of the top level grid; every non-empty cell becomes a tile.
+			float tileSize;
+			/*! Tiles with more points are split into eight octants (recursively, by reading the tile file again).
+				0 disables the refinement. */
+			uint64_t maxPointsPerTile;
+			//! Maximal number of octree levels below the top level grid.
+			uint32_t maxDepth;
+			//! Upper bound for the number of bytes buffered for the output files.
+			std::size_t memoryLimit;
+
+			TilingOptions() : tileSize(10.0f), maxPointsPerTile(0), maxDepth(8), memoryLimit(256 * 1024 * 1024) {}
+		};
+		//! Result of tilePoints() for one tile.
+		struct TileInfo {
+			Util::FileName file;
+			uint64_t pointCount;
+			Geometry::Box bounds;
+		};
+
+		/*! Split the points of a (potentially huge) .xyz file into spatially coherent tiles.
+			The input is read once; every point is assigned to the grid cell containing it and its line is
+			appended to the cell's file "<outputPrefix>_<x>_<y>_<z>.xyz". Parsing and writing run on separate
+			threads; the memory used for buffering is bounded by TilingOptions::memoryLimit, independently of
+			the input size. Octants of refined tiles get the additional postfix "_<octant>".
+			A manifest "<outputPrefix>_tiles.txt" lists every tile with its point count and bounding box.
+			A tile can be loaded with loadMesh(input, tile.pointCount).
+			@return the tiles in the order of the manifest */
+		static std::vector<TileInfo> tilePoints(const Util::FileName & inputFile, const Util::FileName & outputPrefix,
+												const TilingOptions & options = TilingOptions());
+		static std::vector<TileInfo> tilePoints(std::istream & input, const Util::FileName & outputPrefix,
+												const TilingOptions & options = TilingOptions());
+		//! Read a manifest written by tilePoints().
+		static std::vector<TileInfo> loadTileManifest(const Util::FileName & manifestFile);
+
 		static uint8_t queryCapabilities(const std::string & extension);
 		static const char * const fileExtension;
 };
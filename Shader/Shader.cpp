@@ -95,7 +95,7 @@ Shader * Shader::createShader(const std::string & vsa, const std::string & gsa,
 
 /*!	[ctor]	*/
 Shader::Shader(flag_t _usage) :
-		usageFlags(_usage), renderingData(), prog(0), status(UNKNOWN), uniforms(new UniformRegistry),glFeedbackVaryingType(0){
+		usageFlags(_usage), renderingData(), prog(0), status(UNKNOWN), uniforms(new UniformRegistry),sgUniformBlock(false),glFeedbackVaryingType(0){
 }
 
 /*!	[dtor]	*/
@@ -119,6 +119,12 @@ bool Shader::init() {
 
 				// initialize uniforms with default
 				initUniformRegistry();
+
+				// bind the block of the sg-uniforms to its fixed binding point
+				const GLuint sgBlockIndex = glGetUniformBlockIndex(prog, "sg_UniformBlock");
+				sgUniformBlock = sgBlockIndex != GL_INVALID_INDEX;
+				if(sgUniformBlock)
+					glUniformBlockBinding(prog, sgBlockIndex, SG_UNIFORM_BLOCK_BINDING);
 			}else{
 				status = INVALID;
 			}
@@ -133,6 +133,7 @@ class Shader : public Util::ReferenceCounter<Shader> {
 	// @{
 	private:
 		const std::unique_ptr<UniformRegistry> uniforms;
+		bool sgUniformBlock;
 
 		/*! (internal) Make sure that all uniforms declared in the shader are registered to the registry
 			with their current value. Called when a shader is linked successfully */
@@ -147,9 +148,15 @@ class Shader : public Util::ReferenceCounter<Shader> {
 		static bool applyUniform(const Uniform & uniform, int32_t uniformLocation);
 
 	public:
+		//! Binding point of the uniform block sg_UniformBlock (see RenderingContext::setSGUniformBlockEnabled(bool)).
+		static const uint32_t SG_UNIFORM_BLOCK_BINDING = 23;
+
 		//! (internal) should only be used by renderingContext
 		UniformRegistry * _getUniformRegistry()const			{	return uniforms.get();	}
 
+		//! Returns true if the linked program declares the uniform block sg_UniformBlock.
+		bool usesSGUniformBlock()const							{	return sgUniformBlock;	}
+
 		/*! Apply those uniforms stored in the internal uniformRegistry to the shader, that have been changed since
 			the last call to this function (or all, if forced is true).
 			\note The Shader needs not to be active. */
@@ -57,6 +57,11 @@ Uniform::Uniform(UniformName _name, dataType_t _type, size_t _numValues,std::vec
 		INVALID_ARGUMENT_EXCEPTION("data is of wrong size");
 }
 
+//! (ctor)
+Uniform::Uniform(UniformName _name, dataType_t _type, size_t _numValues, const uint8_t * _data) :
+		name(std::move(_name)), type(_type), numValues(_numValues), data(_data, _data + _numValues * getValueSize(_type)){
+}
+
 
 // generic ---------------------------------------------------------------
 
@@ -12,6 +12,7 @@
 #define RENDERING_UNIFORM_H
 
 #include <Util/StringIdentifier.h>
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <deque>
@@ -93,6 +94,9 @@ class Uniform {
 		Uniform();
 		Uniform(UniformName _name, dataType_t _type, size_t arraySize);
 		Uniform(UniformName _name, dataType_t _type, size_t arraySize,std::vector<uint8_t> data);
+		/*! Copy arraySize values of the given type from @p data (e.g. int32_t values for UNIFORM_BOOL); like the
+			typed constructors, this does not allocate memory for values up to the size of a 4x4 matrix. */
+		Uniform(UniformName _name, dataType_t _type, size_t arraySize, const uint8_t * data);
 
 		/*! Generic bool-constructor (use another contructor whenever possible)
 			\throw may throw an invalid_argument-exception	*/
@@ -170,10 +174,62 @@ class Uniform {
 		bool isNull()const							{	return name == Util::StringIdentifier();	}
 
 	private:
+		/*! Storage of the values. Values up to the size of a 4x4 matrix are stored inline and only larger arrays
+			are stored on the heap, so that creating and copying most uniforms does not allocate memory. */
+		class ValueBuffer {
+				static const size_t LOCAL_SIZE = 64;
+				uint8_t localData[LOCAL_SIZE];
+				std::vector<uint8_t> heapData;
+				size_t dataSize;
+			public:
+				ValueBuffer() : localData(), heapData(), dataSize(0) {}
+				//! Zero initialized values of the given size
+				explicit ValueBuffer(size_t _size) : localData(), heapData(_size > LOCAL_SIZE ? _size : 0), dataSize(_size) {}
+				ValueBuffer(const uint8_t * begin, const uint8_t * end) : localData(), heapData(), dataSize(static_cast<size_t>(end - begin)) {
+					if(dataSize > LOCAL_SIZE)
+						heapData.assign(begin, end);
+					else
+						std::copy(begin, end, localData);
+				}
+				explicit ValueBuffer(std::vector<uint8_t> && values) : localData(), heapData(), dataSize(values.size()) {
+					if(dataSize > LOCAL_SIZE)
+						heapData = std::move(values);
+					else
+						std::copy(values.begin(), values.end(), localData);
+				}
+				ValueBuffer(const ValueBuffer &) = default;
+				//! The moved-from buffer is empty.
+				ValueBuffer(ValueBuffer && other) : localData(), heapData(std::move(other.heapData)), dataSize(other.dataSize) {
+					if(dataSize <= LOCAL_SIZE)
+						std::copy(other.localData, other.localData + dataSize, localData);
+					other.heapData.clear();
+					other.dataSize = 0;
+				}
+				ValueBuffer & operator=(const ValueBuffer &) = default;
+				ValueBuffer & operator=(ValueBuffer && other) {
+					if(this != &other) {
+						heapData = std::move(other.heapData);
+						dataSize = other.dataSize;
+						if(dataSize <= LOCAL_SIZE)
+							std::copy(other.localData, other.localData + dataSize, localData);
+						other.heapData.clear();
+						other.dataSize = 0;
+					}
+					return *this;
+				}
+
+				uint8_t * data()				{	return dataSize > LOCAL_SIZE ? heapData.data() : localData;	}
+				const uint8_t * data() const	{	return dataSize > LOCAL_SIZE ? heapData.data() : localData;	}
+				size_t size() const				{	return dataSize;	}
+				bool operator==(const ValueBuffer & other) const {
+					return dataSize == other.dataSize && std::equal(data(), data() + dataSize, other.data());
+				}
+		};
+
 		UniformName name;
 		dataType_t type;
 		size_t numValues;
-		std::vector<uint8_t> data;
+		ValueBuffer data;
 };
 }
 
@@ -10,6 +10,7 @@
 */
 #include "UniformRegistry.h"
 #include <Util/Macros.h>
+#include <cassert>
 
 namespace Rendering {
 
@@ -32,6 +33,7 @@ void UniformRegistry::clear(){
 	}
 	uniforms.clear();
 	orderedList.clear();
+	slots.clear();
 	resetCounters();
 }
 
@@ -49,8 +51,24 @@ void UniformRegistry::performGlobalSync(const UniformRegistry & globalUniforms,
 }
 
 void UniformRegistry::setUniform(const Uniform & uniform, bool warnIfUnused, bool forced){
-	entry_t * & entry = uniforms[uniform.getNameId()];
+	updateEntry(uniforms[uniform.getNameId()], uniform, warnIfUnused, forced);
+}
 
+void UniformRegistry::setSlotUniform(uint32_t slot, const Uniform & uniform, bool warnIfUnused, bool forced){
+	if(slot >= slots.size())
+		slots.resize(slot + 1, nullptr);
+	entry_t * & slotEntry = slots[slot];
+	if(slotEntry == nullptr) {
+		entry_t * & entry = uniforms[uniform.getNameId()];
+		updateEntry(entry, uniform, warnIfUnused, forced);
+		slotEntry = entry;
+	} else {
+		assert(slotEntry->uniform.getNameId() == uniform.getNameId());
+		updateEntry(slotEntry, uniform, warnIfUnused, forced);
+	}
+}
+
+void UniformRegistry::updateEntry(entry_t * & entry, const Uniform & uniform, bool warnIfUnused, bool forced){
 	if(entry==nullptr){ // new entry
 		entry = new entry_t( uniform,warnIfUnused,getNewGlobalStep() );
 		orderedList.push_front(entry);
@@ -62,9 +80,8 @@ void UniformRegistry::setUniform(const Uniform & uniform, bool warnIfUnused, boo
 		if(entry->uniform.getType()!=uniform.getType() ){
 			WARN("Type of Uniform changed; this may be a problem. "+entry->uniform.toString()+" -> "+uniform.toString());
 		}
-		// move entry to the front of the orderedList
-		orderedList.erase(entry->positionInUpdateList);
-		orderedList.push_front(entry);
+		// move entry to the front of the orderedList (without reallocating its node)
+		orderedList.splice(orderedList.begin(), orderedList, entry->positionInUpdateList);
 
 		entry->reset(uniform,getNewGlobalStep(),warnIfUnused,orderedList.begin());
 	}
@@ -16,6 +16,7 @@
 #include <cstdint>
 #include <list>
 #include <unordered_map>
+#include <vector>
 
 namespace Rendering {
 class Shader;
@@ -40,6 +41,7 @@ class UniformRegistry {
 
 		uniformRegistry_t uniforms; // collection of all known uniform-entries
 		orderedEntries_t orderedList; // ordered list of all entries (when an entry is updated, it is moved to the front)
+		std::vector<entry_t *> slots; // preresolved entries (see setSlotUniform(...)); nullptr if not yet resolved
 
 		struct entry_t{
 			Uniform uniform;
@@ -66,6 +68,9 @@ class UniformRegistry {
 			return it==uniforms.end() ? nullptr : it->second;
 		}
 
+		//! (internal) Create the entry or update it with the given uniform.
+		void updateEntry(entry_t * & entry, const Uniform & uniform, bool warnIfUnused, bool forced);
+
 		friend class Shader;
 
 	public:
@@ -96,6 +101,11 @@ class UniformRegistry {
 		void performGlobalSync(const UniformRegistry & globalUniforms, bool forced);
 
 		void setUniform(const Uniform & uniform, bool warnIfUnused=false, bool forced=false);
+
+		/*! Like setUniform(...), but the entry of the uniform is resolved only once per @p slot instead of looking
+			it up by its name on every call. The slots are numbered by the caller (e.g. for the sg-uniforms);
+			a slot must always be used for the same uniform name. */
+		void setSlotUniform(uint32_t slot, const Uniform & uniform, bool warnIfUnused=false, bool forced=false);
 };
 
 }
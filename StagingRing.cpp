@@ -0,0 +1,214 @@
+/*
+ This file is part of the Rendering library.
+ Copyright (C) 2026 agent <agent@local>
+
+ This library is subject to the terms of the Mozilla Public License, v. 2.0.
+ You should have received a copy of the MPL along with this library; see the
+ file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "StagingRing.h"
+#include "GLHeader.h"
+#include "Helper.h"
+#include <Util/Macros.h>
+#include <algorithm>
+#include <limits>
+
+namespace Rendering {
+
+const uint32_t StagingRing::INVALID_TRANSFER = std::numeric_limits<uint32_t>::max();
+
+StagingRing::StagingRing(size_t _capacity, size_t _bytesPerFrame, uint32_t workerCount, bool allowPersistentMapping) :
+		capacity(std::max<size_t>(_capacity, 4)), bytesPerFrame(std::max<size_t>(_bytesPerFrame, 1)),
+		chunkSize(std::min(capacity / 4, bytesPerFrame)), mappedData(nullptr), ringBegin(0), ringEnd(0),
+		nextTransferId(0), copiedBytes(0), stopWorkers(false) {
+#if defined(GL_ARB_buffer_storage)
+	if(allowPersistentMapping && isExtensionSupported("GL_ARB_buffer_storage")) {
+		const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		stagingBuffer.prepare();
+		stagingBuffer.bind(GL_COPY_READ_BUFFER);
+		glBufferStorage(GL_COPY_READ_BUFFER, static_cast<GLsizeiptr>(capacity), nullptr, flags);
+		mappedData = static_cast<uint8_t *>(glMapBufferRange(GL_COPY_READ_BUFFER, 0, static_cast<GLsizeiptr>(capacity), flags));
+		stagingBuffer.unbind(GL_COPY_READ_BUFFER);
+		if(mappedData == nullptr) {
+			WARN("StagingRing: Mapping the staging buffer failed; using glBufferData instead.");
+			stagingBuffer.destroy();
+		}
+	}
+#endif
+	if(mappedData == nullptr)
+		localData.resize(capacity);
+	for(uint32_t i = 0; i < std::max(workerCount, 1u); ++i)
+		workers.emplace_back(&StagingRing::runWorker, this);
+}
+
+StagingRing::~StagingRing() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopWorkers = true;
+	}
+	workAvailable.notify_all();
+	for(auto & worker : workers)
+		worker.join();
+	for(auto & frame : frames)
+		glDeleteSync(static_cast<GLsync>(frame.fence));
+	if(mappedData != nullptr) {
+		stagingBuffer.bind(GL_COPY_READ_BUFFER);
+		glUnmapBuffer(GL_COPY_READ_BUFFER);
+		stagingBuffer.unbind(GL_COPY_READ_BUFFER);
+	}
+}
+
+uint32_t StagingRing::enqueue(BufferObject & target, size_t targetOffset, size_t size, Writer_t writer, Callback_t onComplete) {
+	if(size == 0 || !writer)
+		INVALID_ARGUMENT_EXCEPTION("StagingRing::enqueue: Empty transfer.");
+	std::shared_ptr<Transfer> transfer(new Transfer{&target, targetOffset, std::move(writer), std::move(onComplete), nextTransferId++, 0, false});
+	if(nextTransferId == INVALID_TRANSFER)
+		nextTransferId = 0;
+	transfers[transfer->id] = transfer;
+	for(size_t offset = 0; offset < size; offset += chunkSize) {
+		chunks.push_back({transfer, offset, std::min(chunkSize, size - offset), 0, 0, ChunkState::WAITING});
+		++transfer->remainingChunks;
+	}
+	dispatchChunks();
+	return transfer->id;
+}
+
+void StagingRing::cancel(uint32_t transferId) {
+	const auto it = transfers.find(transferId);
+	if(it == transfers.end())
+		return;
+	const std::shared_ptr<Transfer> transfer = it->second;
+	transfers.erase(it);
+	std::unique_lock<std::mutex> lock(mutex);
+	transfer->cancelled = true;
+	workQueue.erase(std::remove_if(workQueue.begin(), workQueue.end(), [&transfer](const Chunk * chunk) {
+		return chunk->transfer == transfer;
+	}), workQueue.end());
+	for(auto & chunk : chunks) {
+		if(chunk.transfer == transfer && (chunk.state == ChunkState::WAITING || chunk.state == ChunkState::QUEUED))
+			chunk.state = ChunkState::CANCELLED;
+	}
+	chunkWritten.wait(lock, [this, &transfer]() {
+		return std::none_of(chunks.begin(), chunks.end(), [&transfer](const Chunk & chunk) {
+			return chunk.transfer == transfer && chunk.state == ChunkState::WRITING;
+		});
+	});
+}
+
+//! (internal)
+void StagingRing::runWorker() {
+	uint8_t * const ringData = mappedData != nullptr ? mappedData : localData.data();
+	std::unique_lock<std::mutex> lock(mutex);
+	while(true) {
+		workAvailable.wait(lock, [this]() {	return stopWorkers || !workQueue.empty();	});
+		if(stopWorkers)
+			return;
+		Chunk * chunk = workQueue.front();
+		workQueue.pop_front();
+		chunk->state = ChunkState::WRITING;
+		lock.unlock();
+		chunk->transfer->writer(ringData + chunk->ringOffset, chunk->sourceOffset, chunk->size);
+		lock.lock();
+		chunk->state = ChunkState::WRITTEN;
+		chunkWritten.notify_all();
+	}
+}
+
+//! (internal)
+void StagingRing::dispatchChunks() {
+	bool dispatched = false;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		for(auto & chunk : chunks) {
+			if(chunk.state != ChunkState::WAITING)
+				continue;
+			// chunks are contiguous; skip the rest of the ring if the chunk does not fit before its end
+			uint64_t start = ringEnd;
+			const size_t offset = static_cast<size_t>(start % capacity);
+			if(offset + chunk.size > capacity)
+				start += capacity - offset;
+			if(start + chunk.size - ringBegin > capacity)
+				break; // keep the order of the ring
+			chunk.ringOffset = static_cast<size_t>(start % capacity);
+			chunk.ringEnd = ringEnd = start + chunk.size;
+			chunk.state = ChunkState::QUEUED;
+			workQueue.push_back(&chunk);
+			dispatched = true;
+		}
+	}
+	if(dispatched)
+		workAvailable.notify_all();
+}
+
+//! (internal)
+void StagingRing::copyChunk(const Chunk & chunk) {
+	const Transfer & transfer = *chunk.transfer;
+	const uint32_t targetOffset = static_cast<uint32_t>(transfer.targetOffset + chunk.sourceOffset);
+	const uint32_t size = static_cast<uint32_t>(chunk.size);
+	if(mappedData != nullptr) {
+		transfer.target->copy(stagingBuffer, static_cast<uint32_t>(chunk.ringOffset), targetOffset, size);
+	} else {
+		// orphan the staging buffer, so that the upload does not wait for the previous copy
+		stagingBuffer.uploadData(GL_COPY_READ_BUFFER, localData.data() + chunk.ringOffset, chunk.size, GL_STREAM_COPY);
+		transfer.target->copy(stagingBuffer, 0, targetOffset, size);
+	}
+}
+
+void StagingRing::update() {
+	// complete the transfers of the frames whose fences have signaled
+	while(!frames.empty()) {
+		Frame & frame = frames.front();
+		const GLenum result = glClientWaitSync(static_cast<GLsync>(frame.fence), 0, 0);
+		if(result == GL_TIMEOUT_EXPIRED)
+			break;
+		if(result == GL_WAIT_FAILED)
+			WARN("StagingRing: Waiting for a fence failed.");
+		glDeleteSync(static_cast<GLsync>(frame.fence));
+		ringBegin = frame.ringEnd;
+		const auto completedTransfers = std::move(frame.completedTransfers);
+		frames.pop_front();
+		for(const auto & transfer : completedTransfers) {
+			if(transfer->cancelled)
+				continue;
+			transfers.erase(transfer->id);
+			if(transfer->onComplete)
+				transfer->onComplete();
+		}
+	}
+	dispatchChunks();
+
+	// copy the written chunks in the order of the ring
+	copiedBytes = 0;
+	Frame currentFrame{nullptr, frames.empty() ? ringBegin : frames.back().ringEnd, {}};
+	bool chunksProcessed = false;
+	while(!chunks.empty()) {
+		Chunk & chunk = chunks.front();
+		ChunkState state;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			state = chunk.state;
+		}
+		if(state == ChunkState::WRITTEN && !chunk.transfer->cancelled) {
+			if(copiedBytes > 0 && copiedBytes + chunk.size > bytesPerFrame)
+				break;
+			copyChunk(chunk);
+			copiedBytes += chunk.size;
+			if(--chunk.transfer->remainingChunks == 0)
+				currentFrame.completedTransfers.push_back(chunk.transfer);
+		} else if(state != ChunkState::CANCELLED && state != ChunkState::WRITTEN) {
+			break;
+		}
+		if(chunk.ringEnd > currentFrame.ringEnd) // cancelled chunks may not have space in the ring
+			currentFrame.ringEnd = chunk.ringEnd;
+		chunks.pop_front();
+		chunksProcessed = true;
+	}
+	if(chunksProcessed) {
+		currentFrame.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		frames.push_back(std::move(currentFrame));
+	}
+	GET_GL_ERROR();
+}
+
+}
@@ -0,0 +1,149 @@
+/*
+ This file is part of the Rendering library.
+ Copyright (C) 2026 agent <agent@local>
+
+ This library is subject to the terms of the Mozilla Public License, v. 2.0.
+ You should have received a copy of the MPL along with this library; see the
+ file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef RENDERING_STAGINGRING_H_
+#define RENDERING_STAGINGRING_H_
+
+#include "BufferObject.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace Rendering {
+
+/**
+ * Asynchronous transfer of data into buffer objects through a ring of staging memory.
+ *
+ * The data of a transfer is written into the ring by worker threads (e.g. copied from a mesh or read from a
+ * file) and copied into the target buffer by update(), which has to be called once per frame in the gl-thread.
+ * At most bytesPerFrame bytes are copied per frame; larger transfers are split into chunks. A transfer is
+ * complete when the fence of the frame which copied its last chunk has signaled.
+ *
+ * If GL_ARB_buffer_storage is supported, the ring is a persistently mapped buffer object; otherwise it is
+ * stored in main memory and every chunk is uploaded into an orphaned staging buffer with glBufferData.
+ * @ingroup rendering_resources
+ */
+class StagingRing {
+	public:
+		/*! Writes the bytes [sourceOffset, sourceOffset + size) of the transferred data to @p destination.
+			Called in a worker thread. */
+		typedef std::function<void (uint8_t * destination, size_t sourceOffset, size_t size)> Writer_t;
+		//! Called in the gl-thread (by update()) when a transfer is complete.
+		typedef std::function<void ()> Callback_t;
+
+		static const uint32_t INVALID_TRANSFER;
+
+		/*! @param capacity Size of the ring in bytes.
+			@param bytesPerFrame Maximum number of bytes copied by one call of update().
+			@param workerCount Number of threads writing the data into the ring.
+			@param allowPersistentMapping Use a persistently mapped buffer if it is supported.
+			@note Must be created in the gl-thread. */
+		StagingRing(size_t capacity, size_t bytesPerFrame, uint32_t workerCount = 1, bool allowPersistentMapping = true);
+		~StagingRing();
+
+		StagingRing(const StagingRing &) = delete;
+		StagingRing & operator=(const StagingRing &) = delete;
+
+		/*! Transfer @p size bytes written by @p writer into @p target at @p targetOffset and return the id of the
+			transfer. @p target has to be allocated and has to stay valid until the transfer is complete or cancelled. */
+		uint32_t enqueue(BufferObject & target, size_t targetOffset, size_t size, Writer_t writer, Callback_t onComplete = Callback_t());
+		/*! Cancel the transfer; its callback is not called. Waits for the workers currently writing its data,
+			so the writer's source may be destroyed afterwards. */
+		void cancel(uint32_t transfer);
+
+		/*! Call the callbacks of the completed transfers, pass new chunks to the workers, and copy the written
+			chunks (at most bytesPerFrame bytes) into their targets. Has to be called once per frame. */
+		void update();
+
+		bool isPersistentlyMapped() const			{	return mappedData != nullptr;	}
+		size_t getCapacity() const					{	return capacity;	}
+		size_t getBytesPerFrame() const				{	return bytesPerFrame;	}
+		//! Number of transfers which are neither complete nor cancelled.
+		size_t getPendingTransferCount() const		{	return transfers.size();	}
+		//! Number of bytes copied by the last call of update().
+		size_t getCopiedBytes() const				{	return copiedBytes;	}
+
+	private:
+		struct Transfer {
+			BufferObject * target;
+			size_t targetOffset;
+			Writer_t writer;
+			Callback_t onComplete;
+			uint32_t id;
+			uint32_t remainingChunks;
+			bool cancelled;
+		};
+		enum class ChunkState : uint8_t {
+			//! Waiting for free space in the ring
+			WAITING,
+			QUEUED,
+			WRITING,
+			WRITTEN,
+			CANCELLED
+		};
+		struct Chunk {
+			std::shared_ptr<Transfer> transfer;
+			size_t sourceOffset;
+			size_t size;
+			size_t ringOffset;
+			//! Position of the end of the chunk in the ring (counted from the creation of the ring)
+			uint64_t ringEnd;
+			ChunkState state;
+		};
+		struct Frame {
+			//! GLsync object
+			void * fence;
+			//! The ring up to this position can be reused when the fence has signaled.
+			uint64_t ringEnd;
+			std::vector<std::shared_ptr<Transfer>> completedTransfers;
+		};
+
+		const size_t capacity;
+		const size_t bytesPerFrame;
+		const size_t chunkSize;
+		BufferObject stagingBuffer;
+		//! Persistently mapped staging buffer, or nullptr
+		uint8_t * mappedData;
+		//! Ring in main memory (if the buffer is not mapped)
+		std::vector<uint8_t> localData;
+		//! Positions of the first used and the first free byte (counted from the creation of the ring)
+		uint64_t ringBegin, ringEnd;
+
+		//! All chunks that have not been copied yet, in the order of the ring
+		std::deque<Chunk> chunks;
+		std::unordered_map<uint32_t, std::shared_ptr<Transfer>> transfers;
+		std::deque<Frame> frames;
+		uint32_t nextTransferId;
+		size_t copiedBytes;
+
+		//! Protects the states of the chunks and the workQueue.
+		std::mutex mutex;
+		std::condition_variable workAvailable;
+		std::condition_variable chunkWritten;
+		std::deque<Chunk *> workQueue;
+		std::vector<std::thread> workers;
+		bool stopWorkers;
+
+		void runWorker();
+		//! Reserve space in the ring for the waiting chunks and pass them to the workers.
+		void dispatchChunks();
+		void copyChunk(const Chunk & chunk);
+};
+
+}
+
+#endif /* RENDERING_STAGINGRING_H_ */
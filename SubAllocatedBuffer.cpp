@@ -0,0 +1,187 @@
+/*
+ This file is part of the Rendering library.
+ Copyright (C) 2026 agent <agent@local>
+
+ This library is subject to the terms of the Mozilla Public License, v. 2.0.
+ You should have received a copy of the MPL along with this library; see the
+ file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "SubAllocatedBuffer.h"
+#include "BufferObject.h"
+#include "GLHeader.h"
+#include <Util/Macros.h>
+#include <algorithm>
+#include <limits>
+
+namespace Rendering {
+
+//! (internal) Backend storing the data in a BufferObject.
+class BufferObjectBackend : public SubAllocatedBuffer::Backend {
+		BufferObject buffer;
+		const uint32_t usageHint;
+	public:
+		explicit BufferObjectBackend(uint32_t _usageHint) : usageHint(_usageHint) {}
+
+		void relocate(size_t capacity, const std::vector<SubAllocatedBuffer::Move> & moves) override {
+			BufferObject newBuffer;
+			newBuffer.allocateData<uint8_t>(GL_COPY_WRITE_BUFFER, capacity, usageHint);
+			if(buffer.isValid()) {
+				for(const auto & move : moves)
+					newBuffer.copy(buffer, static_cast<uint32_t>(move.source), static_cast<uint32_t>(move.target), static_cast<uint32_t>(move.size));
+			}
+			buffer.swap(newBuffer);
+		}
+		void upload(size_t offset, const uint8_t * data, size_t size) override {
+			buffer.uploadSubData(GL_COPY_WRITE_BUFFER, data, size, offset);
+		}
+		void download(size_t offset, uint8_t * data, size_t size) override {
+			const std::vector<uint8_t> bytes = buffer.downloadData<uint8_t>(GL_COPY_READ_BUFFER, size, offset);
+			std::copy(bytes.begin(), bytes.end(), data);
+		}
+		void bind(uint32_t bufferTarget) override		{	buffer.bind(bufferTarget);	}
+		void unbind(uint32_t bufferTarget) override		{	buffer.unbind(bufferTarget);	}
+};
+
+//! (static)
+std::unique_ptr<SubAllocatedBuffer::Backend> SubAllocatedBuffer::createBufferObjectBackend(uint32_t usageHint) {
+	return std::unique_ptr<Backend>(new BufferObjectBackend(usageHint));
+}
+
+const uint32_t SubAllocatedBuffer::INVALID_ALLOCATION = std::numeric_limits<uint32_t>::max();
+
+SubAllocatedBuffer::SubAllocatedBuffer(std::unique_ptr<Backend> _backend, size_t _alignment, size_t initialCapacity) :
+		backend(std::move(_backend)), alignment(std::max<size_t>(_alignment, 1)), capacity(0), usedSize(0), initialized(false) {
+	capacity = align(std::max(initialCapacity, alignment));
+}
+
+uint32_t SubAllocatedBuffer::allocate(size_t size) {
+	const size_t alignedSize = align(std::max<size_t>(size, 1));
+	if(!initialized) {
+		backend->relocate(capacity, {});
+		insertFreeRange(0, capacity);
+		initialized = true;
+	}
+	auto bestFit = freeBySize.lower_bound(alignedSize);
+	if(bestFit == freeBySize.end()) {
+		relocate(align(std::max(capacity * 2, usedSize + alignedSize)));
+		bestFit = freeBySize.lower_bound(alignedSize);
+	}
+	const size_t offset = bestFit->second;
+	const size_t freeSize = bestFit->first;
+	eraseFreeRange(freeByOffset.find(offset));
+	if(freeSize > alignedSize)
+		insertFreeRange(offset + alignedSize, freeSize - alignedSize);
+
+	uint32_t id;
+	if(unusedIds.empty()) {
+		id = static_cast<uint32_t>(allocations.size());
+		allocations.emplace_back();
+	} else {
+		id = unusedIds.back();
+		unusedIds.pop_back();
+	}
+	allocations[id] = {offset, alignedSize, true};
+	usedSize += alignedSize;
+	return id;
+}
+
+void SubAllocatedBuffer::free(uint32_t id) {
+	if(id >= allocations.size() || !allocations[id].used)
+		INVALID_ARGUMENT_EXCEPTION("SubAllocatedBuffer::free: Invalid allocation.");
+	Allocation & allocation = allocations[id];
+	allocation.used = false;
+	usedSize -= allocation.size;
+	unusedIds.push_back(id);
+
+	// merge with the neighboring free ranges
+	size_t offset = allocation.offset;
+	size_t size = allocation.size;
+	auto next = freeByOffset.lower_bound(offset);
+	if(next != freeByOffset.begin()) {
+		auto previous = std::prev(next);
+		if(previous->first + previous->second == offset) {
+			offset = previous->first;
+			size += previous->second;
+			eraseFreeRange(previous);
+		}
+	}
+	if(next != freeByOffset.end() && next->first == allocation.offset + allocation.size) {
+		size += next->second;
+		eraseFreeRange(next);
+	}
+	insertFreeRange(offset, size);
+}
+
+void SubAllocatedBuffer::upload(uint32_t id, const uint8_t * data, size_t size) {
+	const Allocation & allocation = allocations.at(id);
+	if(!allocation.used || size > allocation.size)
+		INVALID_ARGUMENT_EXCEPTION("SubAllocatedBuffer::upload: Invalid allocation or size.");
+	backend->upload(allocation.offset, data, size);
+}
+
+void SubAllocatedBuffer::download(uint32_t id, uint8_t * data, size_t size) {
+	const Allocation & allocation = allocations.at(id);
+	if(!allocation.used || size > allocation.size)
+		INVALID_ARGUMENT_EXCEPTION("SubAllocatedBuffer::download: Invalid allocation or size.");
+	backend->download(allocation.offset, data, size);
+}
+
+size_t SubAllocatedBuffer::defragment() {
+	// already compact if there is at most one free range at the end
+	if(!initialized || freeByOffset.empty() || (freeByOffset.size() == 1 && freeByOffset.begin()->first == usedSize))
+		return 0;
+	return relocate(capacity);
+}
+
+//! (internal)
+void SubAllocatedBuffer::insertFreeRange(size_t offset, size_t size) {
+	freeByOffset.emplace(offset, size);
+	freeBySize.emplace(size, offset);
+}
+
+//! (internal)
+void SubAllocatedBuffer::eraseFreeRange(std::map<size_t, size_t>::iterator it) {
+	auto range = freeBySize.equal_range(it->second);
+	for(auto bySize = range.first; bySize != range.second; ++bySize) {
+		if(bySize->second == it->first) {
+			freeBySize.erase(bySize);
+			break;
+		}
+	}
+	freeByOffset.erase(it);
+}
+
+//! (internal)
+size_t SubAllocatedBuffer::relocate(size_t newCapacity) {
+	std::vector<uint32_t> ids;
+	ids.reserve(getAllocationCount());
+	for(uint32_t id = 0; id < allocations.size(); ++id) {
+		if(allocations[id].used)
+			ids.push_back(id);
+	}
+	std::sort(ids.begin(), ids.end(), [this](uint32_t a, uint32_t b) {	return allocations[a].offset < allocations[b].offset;	});
+
+	std::vector<Move> moves;
+	moves.reserve(ids.size());
+	size_t offset = 0;
+	size_t movedBytes = 0;
+	for(const auto id : ids) {
+		Allocation & allocation = allocations[id];
+		moves.push_back({allocation.offset, offset, allocation.size});
+		if(allocation.offset != offset)
+			movedBytes += allocation.size;
+		allocation.offset = offset;
+		offset += allocation.size;
+	}
+	backend->relocate(newCapacity, moves);
+	capacity = newCapacity;
+
+	freeByOffset.clear();
+	freeBySize.clear();
+	if(offset < capacity)
+		insertFreeRange(offset, capacity - offset);
+	return movedBytes;
+}
+
+}
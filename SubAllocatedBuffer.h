@@ -0,0 +1,119 @@
+/*
+ This file is part of the Rendering library.
+ Copyright (C) 2026 agent <agent@local>
+
+ This library is subject to the terms of the Mozilla Public License, v. 2.0.
+ You should have received a copy of the MPL along with this library; see the
+ file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef RENDERING_SUBALLOCATEDBUFFER_H_
+#define RENDERING_SUBALLOCATEDBUFFER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace Rendering {
+
+/**
+ * Large buffer that is divided into ranges for many small allocations (e.g. the vertex data of many meshes).
+ *
+ * Free ranges are kept in a free list ordered by offset (to merge neighbors) and by size (for a best fit search).
+ * Allocations are identified by ids, which stay valid when the ranges are moved by defragment() or when the
+ * buffer grows. The storage itself is accessed through a Backend, so the allocator can be used (and tested)
+ * without a GPU.
+ * @ingroup rendering_resources
+ */
+class SubAllocatedBuffer {
+	public:
+		//! Copy of a range into the new storage (see Backend::relocate()).
+		struct Move {
+			size_t source;
+			size_t target;
+			size_t size;
+		};
+
+		//! Storage of the buffer.
+		class Backend {
+			public:
+				virtual ~Backend() {}
+				/*! Replace the storage by a new one of @p capacity bytes and copy the given ranges from the old
+					storage into it. The target ranges do not overlap each other. */
+				virtual void relocate(size_t capacity, const std::vector<Move> & moves) = 0;
+				virtual void upload(size_t offset, const uint8_t * data, size_t size) = 0;
+				virtual void download(size_t offset, uint8_t * data, size_t size) = 0;
+				//! Bind the storage to the given OpenGL target (if it is stored in OpenGL).
+				virtual void bind(uint32_t /*bufferTarget*/)	{}
+				virtual void unbind(uint32_t /*bufferTarget*/)	{}
+		};
+
+		/*! Backend storing the data in a BufferObject (with the given usage hint).
+			@note Uses OpenGL and must only be used in the gl-thread. */
+		static std::unique_ptr<Backend> createBufferObjectBackend(uint32_t usageHint);
+
+		static const uint32_t INVALID_ALLOCATION;
+
+		/*! @param alignment Offsets and sizes of the allocations are multiples of the alignment
+				(does not need to be a power of two; e.g. the size of a vertex).
+			@param initialCapacity Initial size of the storage in bytes; it is allocated with the first allocation. */
+		SubAllocatedBuffer(std::unique_ptr<Backend> backend, size_t alignment, size_t initialCapacity);
+
+		/*! Allocate a range of @p size bytes and return its id. If there is no free range large enough, the
+			buffer grows (at least doubling its capacity) and the allocations are compacted at the same time. */
+		uint32_t allocate(size_t size);
+		//! Release the range of the given allocation.
+		void free(uint32_t allocation);
+
+		size_t getOffset(uint32_t allocation) const	{	return allocations.at(allocation).offset;	}
+		size_t getSize(uint32_t allocation) const	{	return allocations.at(allocation).size;	}
+
+		//! Upload @p size bytes (at most the size of the allocation) to the start of the allocation's range.
+		void upload(uint32_t allocation, const uint8_t * data, size_t size);
+		//! Download @p size bytes (at most the size of the allocation) from the start of the allocation's range.
+		void download(uint32_t allocation, uint8_t * data, size_t size);
+
+		/*! Move all allocations to the front of the buffer (keeping their order), so that the free space forms
+			one range at the end. Returns the number of moved bytes. */
+		size_t defragment();
+
+		size_t getAlignment() const				{	return alignment;	}
+		size_t getCapacity() const				{	return capacity;	}
+		//! Number of bytes in use (including the alignment padding).
+		size_t getUsedSize() const				{	return usedSize;	}
+		size_t getLargestFreeRange() const		{	return freeBySize.empty() ? 0 : freeBySize.rbegin()->first;	}
+		uint32_t getAllocationCount() const		{	return static_cast<uint32_t>(allocations.size() - unusedIds.size());	}
+		Backend & getBackend()					{	return *backend;	}
+
+	private:
+		struct Allocation {
+			size_t offset;
+			size_t size;
+			bool used;
+		};
+
+		const std::unique_ptr<Backend> backend;
+		const size_t alignment;
+		size_t capacity;
+		size_t usedSize;
+		bool initialized;
+
+		std::vector<Allocation> allocations;
+		std::vector<uint32_t> unusedIds;
+		//! offset -> size
+		std::map<size_t, size_t> freeByOffset;
+		//! size -> offset
+		std::multimap<size_t, size_t> freeBySize;
+
+		size_t align(size_t size) const	{	return ((size + alignment - 1) / alignment) * alignment;	}
+		void insertFreeRange(size_t offset, size_t size);
+		void eraseFreeRange(std::map<size_t, size_t>::iterator it);
+		//! Move all allocations to the front of new storage of the given capacity.
+		size_t relocate(size_t newCapacity);
+};
+
+}
+
+#endif /* RENDERING_SUBALLOCATEDBUFFER_H_ */
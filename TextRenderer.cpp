@@ -7,23 +7,27 @@
 	file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
 */
 #include "TextRenderer.h"
-#include "Mesh/Mesh.h"
 #include "Mesh/VertexDescription.h"
-#include "MeshUtils/MeshBuilder.h"
 #include "RenderingContext/RenderingParameters.h"
 #include "RenderingContext/RenderingContext.h"
 #include "Shader/Shader.h"
-#include "Shader/Uniform.h"
 #include "Texture/Texture.h"
 #include "Texture/TextureUtils.h"
 #include "Draw.h"
+#include "GLHeader.h"
 #include <Geometry/Rect.h>
 #include <Geometry/Vec2.h>
+#include <Util/Graphics/Bitmap.h>
 #include <Util/Graphics/Color.h>
 #include <Util/Graphics/FontRenderer.h>
 #include <Util/References.h>
 #include <cstdint>
+#include <iterator>
+#include <list>
 #include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace Rendering {
 
@@ -33,10 +37,13 @@ uniform mat4 sg_matrix_modelToClipping;
 
 in vec2 sg_Position;
 in vec2 sg_TexCoord0;
+in vec4 sg_Color;
 out vec2 glyphPos;
+out vec4 textColor;
 
 void main(void) {
 	glyphPos = sg_TexCoord0;
+	textColor = sg_Color;
 	gl_Position = (sg_matrix_modelToClipping * vec4(sg_Position, 0.0, 1.0));
 }
 )***");
@@ -44,9 +51,9 @@ void main(void) {
 static const std::string fragmentProgram(R"***(#version 130
 
 uniform sampler2D sg_texture0;
-uniform vec4 textColor;
 
 in vec2 glyphPos;
+in vec4 textColor;
 out vec4 fragColor;
 
 void main(void) {
@@ -54,17 +61,203 @@ void main(void) {
 }
 )***");
 
+//! Maximum number of cached layouts; the least recently used layout is removed when the cache is full.
+static const size_t MAX_CACHED_LAYOUTS = 4096;
+//! Glyphs of codepoints below this limit are stored in a table indexed by codepoint.
+static const uint32_t GLYPH_TABLE_SIZE = 0x800;
+//! Number of floats per vertex: position (2), texture coordinate (2), color (4)
+static const size_t VERTEX_FLOATS = 8;
+
+static const VertexDescription & getVertexDescription() {
+	static const VertexDescription vertexDescription = []() {
+		VertexDescription vd;
+		vd.appendPosition2D();
+		vd.appendTexCoord();
+		vd.appendColorRGBAFloat();
+		return vd;
+	}();
+	return vertexDescription;
+}
+
 struct TextRenderer::Implementation {
+	//! Metrics of a glyph in pixels
+	struct Glyph {
+		//! Top left corner of the glyph relative to the cursor and the top of the text
+		int32_t left;
+		int32_t top;
+		int32_t width;
+		int32_t height;
+		//! Texture coordinate of the top left corner of the glyph
+		int32_t texLeft;
+		int32_t texTop;
+		int32_t xAdvance;
+		bool valid;
+
+		Glyph() : left(0), top(0), width(0), height(0), texLeft(0), texTop(0), xAdvance(0), valid(false) {}
+	};
+	//! Glyph quads of a text
+	struct Layout {
+		//! Four vertices per glyph: position relative to the text position (2), texture coordinate (2)
+		std::vector<float> vertices;
+		Geometry::Rect_i rect;
+	};
+
+	typedef std::list<std::pair<std::u32string, Layout>> layoutList_t;
+
 	Util::Reference<Shader> shader;
 	Util::Reference<Texture> texture;
-	Util::FontInfo fontInfo;
+	//! Glyphs of codepoints below GLYPH_TABLE_SIZE, indexed by codepoint
+	std::vector<Glyph> glyphs;
+	//! Glyphs of the other codepoints
+	std::unordered_map<uint32_t, Glyph> otherGlyphs;
+	//! Cached layouts, the most recently used first
+	layoutList_t layoutList;
+	std::unordered_map<std::u32string, layoutList_t::iterator> layouts;
+	//! Reused buffers for the geometry of the drawn texts
+	std::vector<float> vertices;
+	std::vector<uint32_t> indices;
+
+	Implementation() = default;
+	//! Copy the font; the layout cache is not copied.
+	Implementation(const Implementation & other) :
+			shader(other.shader), texture(other.texture), glyphs(other.glyphs), otherGlyphs(other.otherGlyphs) {
+	}
+
+	//! Return the glyph of the character, or nullptr if it is not in the font.
+	const Glyph * getGlyph(char32_t character) const {
+		if(character < glyphs.size())
+			return glyphs[character].valid ? &glyphs[character] : nullptr;
+		if(character < GLYPH_TABLE_SIZE)
+			return nullptr;
+		const auto it = otherGlyphs.find(character);
+		return it == otherGlyphs.cend() ? nullptr : &it->second;
+	}
+
+	//! Remove all cached layouts.
+	void clearLayouts() {
+		layouts.clear();
+		layoutList.clear();
+	}
+
+	//! Return the layout of the text; the reference is valid until the next call.
+	const Layout & getLayout(const std::u32string & text) {
+		const auto it = layouts.find(text);
+		if(it != layouts.cend()) {
+			layoutList.splice(layoutList.begin(), layoutList, it->second);
+			return it->second->second;
+		}
+		if(layouts.size() >= MAX_CACHED_LAYOUTS) {
+			// reuse the entry of the least recently used layout
+			layouts.erase(layoutList.back().first);
+			layoutList.splice(layoutList.begin(), layoutList, std::prev(layoutList.end()));
+			layoutList.front().first = text;
+			layoutList.front().second.vertices.clear();
+		} else {
+			layoutList.emplace_front(text, Layout());
+		}
+		layouts.emplace(text, layoutList.begin());
+
+		Layout & layout = layoutList.front().second;
+		layout.rect.invalidate();
+		layout.vertices.reserve(text.size() * 4 * 4);
+		int cursorX = 0;
+		for(const auto & character : text) {
+			const Glyph * glyph = getGlyph(character);
+			if(glyph == nullptr) {
+				// Skip missing characters
+				continue;
+			}
+			const auto left = static_cast<float>(cursorX + glyph->left);
+			const auto top = static_cast<float>(glyph->top);
+			const auto right = left + static_cast<float>(glyph->width);
+			const auto bottom = top + static_cast<float>(glyph->height);
+			const auto texLeft = static_cast<float>(glyph->texLeft);
+			const auto texTop = static_cast<float>(glyph->texTop);
+			const auto texRight = texLeft + static_cast<float>(glyph->width);
+			const auto texBottom = texTop - static_cast<float>(glyph->height);
+			// Top left, bottom left, bottom right, top right
+			layout.vertices.insert(layout.vertices.end(), {left, top, texLeft, texTop,
+														   left, bottom, texLeft, texBottom,
+														   right, bottom, texRight, texBottom,
+														   right, top, texRight, texTop});
+
+			layout.rect.include(Geometry::Vec2i(cursorX + glyph->left, glyph->top));
+			layout.rect.include(Geometry::Vec2i(cursorX + glyph->left + glyph->width, glyph->top + glyph->height));
+
+			cursorX += glyph->xAdvance;
+		}
+		return layout;
+	}
+
+	//! Append the layout of the text at the given position to the buffers.
+	void appendText(const std::u32string & text, const Geometry::Vec2i & position, const Util::Color4f & color) {
+		const Layout & layout = getLayout(text);
+		const auto x = static_cast<float>(position.getX());
+		const auto y = static_cast<float>(position.getY());
+		for(size_t i = 0; i < layout.vertices.size(); i += 16) {
+			const auto indexA = static_cast<uint32_t>(vertices.size() / VERTEX_FLOATS);
+			for(size_t v = i; v < i + 16; v += 4) {
+				vertices.insert(vertices.end(), {layout.vertices[v] + x, layout.vertices[v + 1] + y,
+												 layout.vertices[v + 2], layout.vertices[v + 3],
+												 color.r(), color.g(), color.b(), color.a()});
+			}
+			// Same triangles as MeshUtils::MeshBuilder::addQuad
+			indices.insert(indices.end(), {indexA, indexA + 1, indexA + 3, indexA + 1, indexA + 2, indexA + 3});
+		}
+	}
+
+	//! Draw and clear the buffers.
+	void display(RenderingContext & context) {
+		if(indices.empty())
+			return;
+		if(shader.isNull()) {
+			shader = Shader::createShader(vertexProgram, fragmentProgram, Shader::USE_UNIFORMS);
+		}
+		context.pushAndSetBlending(BlendingParameters(BlendingParameters::SRC_ALPHA, BlendingParameters::ONE_MINUS_SRC_ALPHA));
+		context.pushAndSetDepthBuffer(DepthBufferParameters(false, false, Comparison::LESS));
+		context.pushAndSetShader(shader.get());
+		context.pushAndSetTexture(0, texture.get());
+
+		// consecutive texts are drawn with one draw call
+		context.displayTransientGeometry(getVertexDescription(), GL_TRIANGLES, reinterpret_cast<const uint8_t *>(vertices.data()),
+										 static_cast<uint32_t>(vertices.size() / VERTEX_FLOATS), indices.data(), static_cast<uint32_t>(indices.size()));
+
+		context.popTexture(0);
+		context.popShader();
+		context.popDepthBuffer();
+		context.popBlending();
+		vertices.clear();
+		indices.clear();
+	}
 };
 
 TextRenderer::TextRenderer(const Util::Bitmap & glyphBitmap, 
 						   const Util::FontInfo & fontInfo) :
 		impl(new Implementation) {
 	impl->texture = TextureUtils::createTextureFromBitmap(glyphBitmap);
-	impl->fontInfo = fontInfo;
+
+	const auto textureHeight = static_cast<int32_t>(glyphBitmap.getHeight());
+	for(const auto & entry : fontInfo.glyphMap) {
+		const auto & glyphInfo = entry.second;
+		Implementation::Glyph glyph;
+		glyph.left = glyphInfo.offset.first;
+		glyph.top = fontInfo.ascender - glyphInfo.offset.second;
+		glyph.width = glyphInfo.size.first;
+		glyph.height = glyphInfo.size.second;
+		glyph.texLeft = glyphInfo.position.first;
+		glyph.texTop = textureHeight - glyphInfo.position.second;
+		glyph.xAdvance = glyphInfo.xAdvance;
+		glyph.valid = true;
+
+		const auto codepoint = static_cast<uint32_t>(entry.first);
+		if(codepoint < GLYPH_TABLE_SIZE) {
+			if(codepoint >= impl->glyphs.size())
+				impl->glyphs.resize(codepoint + 1);
+			impl->glyphs[codepoint] = glyph;
+		} else {
+			impl->otherGlyphs[codepoint] = glyph;
+		}
+	}
 }
 
 TextRenderer::~TextRenderer() = default;
@@ -79,117 +272,37 @@ void TextRenderer::draw(RenderingContext & context,
 						const std::u32string & text,
 						const Geometry::Vec2i & textPosition,
 						const Util::Color4f & textColor) const {
-	if(impl->shader.isNull()) {
-		impl->shader = Shader::createShader(vertexProgram, fragmentProgram, Shader::USE_UNIFORMS);
-	}
-	context.pushAndSetBlending(BlendingParameters(BlendingParameters::SRC_ALPHA, BlendingParameters::ONE_MINUS_SRC_ALPHA));
-	context.pushAndSetDepthBuffer(DepthBufferParameters(false, false, Comparison::LESS));
-	context.pushAndSetShader(impl->shader.get());
-	context.pushAndSetTexture(0, impl->texture.get());
-
-	impl->shader->setUniform(context, Uniform("textColor", textColor));
-
-	VertexDescription vertexDescription;
-	vertexDescription.appendPosition2D();
-	vertexDescription.appendTexCoord();
-	MeshUtils::MeshBuilder builder(vertexDescription);
-
-	const auto textureHeight = static_cast<int32_t>(impl->texture->getHeight());
-
-	int cursorX = textPosition.getX();
-	for(const auto & character : text) {
-		const auto it = impl->fontInfo.glyphMap.find(character);
-		if(it == impl->fontInfo.glyphMap.cend()) {
-			// Skip missing characters
-			continue;
-		}
-		const auto & glyphInfo = it->second;
-
-		const auto glyphWidth = glyphInfo.size.first;
-		const auto glyphHeight = glyphInfo.size.second;
-
-		const Geometry::Vec2i topLeftPos(cursorX + glyphInfo.offset.first,
-										 textPosition.getY() + impl->fontInfo.ascender - glyphInfo.offset.second);
-		const Geometry::Vec2i topLeftTexCoord(glyphInfo.position.first,
-											  textureHeight - glyphInfo.position.second);
-
-		// Top left
-		builder.position(topLeftPos);
-		builder.texCoord0(topLeftTexCoord);
-		const auto indexA = builder.addVertex();
-		// Bottom left
-		builder.position(topLeftPos + Geometry::Vec2i(0, glyphHeight));
-		builder.texCoord0(topLeftTexCoord + Geometry::Vec2i(0, -glyphHeight));
-		const auto indexB = builder.addVertex();
-		// Bottom right
-		builder.position(topLeftPos + Geometry::Vec2i(glyphWidth, glyphHeight));
-		builder.texCoord0(topLeftTexCoord + Geometry::Vec2i(glyphWidth, -glyphHeight));
-		const auto indexC = builder.addVertex();
-		// Top right
-		builder.position(topLeftPos + Geometry::Vec2i(glyphWidth, 0));
-		builder.texCoord0(topLeftTexCoord + Geometry::Vec2i(glyphWidth, 0));
-		const auto indexD = builder.addVertex();
-
-		builder.addQuad(indexA, indexB, indexC, indexD);
-
-		cursorX += glyphInfo.xAdvance;
-	}
-	Util::Reference<Mesh> mesh = builder.buildMesh();
-
-	context.displayMesh(mesh.get());
+	impl->appendText(text, textPosition, textColor);
+	impl->display(context);
+}
 
-	context.popTexture(0);
-	context.popShader();
-	context.popDepthBuffer();
-	context.popBlending();
+void TextRenderer::drawMany(RenderingContext & context,
+							const std::vector<Label> & labels) const {
+	for(const auto & label : labels)
+		impl->appendText(label.text, label.position, label.color);
+	impl->display(context);
 }
 
 Geometry::Rect_i TextRenderer::getTextSize(const std::u32string & text) const {
-	Geometry::Rect_i textRect;
-	textRect.invalidate();
-
-	int cursorX = 0;
-	for(const auto & character : text) {
-		const auto it = impl->fontInfo.glyphMap.find(character);
-		if(it == impl->fontInfo.glyphMap.cend()) {
-			// Skip missing characters
-			continue;
-		}
-		const auto & glyphInfo = it->second;
-
-		const auto glyphWidth = glyphInfo.size.first;
-		const auto glyphHeight = glyphInfo.size.second;
-		
-		const Geometry::Vec2i topLeftPos(cursorX + glyphInfo.offset.first,
-										 impl->fontInfo.ascender - glyphInfo.offset.second);
-
-		// Top left
-		textRect.include(topLeftPos);
-		// Bottom right
-		textRect.include(topLeftPos + Geometry::Vec2i(glyphWidth, glyphHeight));
-
-		cursorX += glyphInfo.xAdvance;
-	}
-
-	return textRect;
+	return impl->getLayout(text).rect;
 }
 
 int TextRenderer::getHeightOfX() const {
-	const auto it = impl->fontInfo.glyphMap.find('x');
-	if(it == impl->fontInfo.glyphMap.cend()) {
-		return 0;
-	}
-	const auto & glyphInfo = it->second;
-	return glyphInfo.size.second;
+	const auto glyph = impl->getGlyph('x');
+	return glyph == nullptr ? 0 : glyph->height;
 }
 
 int TextRenderer::getWidthOfM() const {
-	const auto it = impl->fontInfo.glyphMap.find('M');
-	if(it == impl->fontInfo.glyphMap.cend()) {
-		return 0;
-	}
-	const auto & glyphInfo = it->second;
-	return glyphInfo.size.first;
+	const auto glyph = impl->getGlyph('M');
+	return glyph == nullptr ? 0 : glyph->width;
+}
+
+size_t TextRenderer::getLayoutCacheSize() const {
+	return impl->layouts.size();
+}
+
+void TextRenderer::clearLayoutCache() {
+	impl->clearLayouts();
 }
 
 }
@@ -9,18 +9,20 @@
 #ifndef RENDERING_TEXTRENDERER_H
 #define RENDERING_TEXTRENDERER_H
 
+#include <Geometry/Vec2.h>
+#include <Util/Graphics/Color.h>
+#include <cstddef>
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace Geometry {
 template<typename T_> class _Rect;
 typedef _Rect<int> Rect_i;
-template<typename T_> class _Vec2;
-typedef _Vec2<int> Vec2i;
 }
 namespace Util {
 class Bitmap;
-class Color4f;
 struct FontInfo;
 }
 namespace Rendering {
@@ -31,6 +33,16 @@ class RenderingContext;
  * 
  * Display text by using a bitmap that contains pre-rendered glyphs.
  * 
+ * The layout of a text (the glyph quads relative to the text position) is
+ * cached, so that drawing the same text again, or calculating its size, does
+ * not look up its glyphs again. The cache holds the layouts of the 4096 most
+ * recently used texts. The glyphs of a text are drawn with one draw
+ * call (see RenderingContext::displayTransientGeometry()). If the texts are
+ * drawn between RenderingContext::beginTransientGeometryBatch() and
+ * RenderingContext::endTransientGeometryBatch(), the glyphs of all texts drawn
+ * after each other are collected and drawn with one draw call at the end of
+ * the batch.
+ * 
  * @author Benjamin Eikel
  * @date 2013-07-10
  * @ingroup draw
@@ -42,6 +54,19 @@ class TextRenderer {
 		std::unique_ptr<Implementation> impl;
 
 	public:
+		//! Text drawn by drawMany()
+		struct Label {
+			std::u32string text;
+			//! Screen position in pixels of the top left corner of the text
+			Geometry::Vec2i position;
+			Util::Color4f color;
+
+			Label() = default;
+			Label(std::u32string _text, const Geometry::Vec2i & _position, const Util::Color4f & _color) :
+					text(std::move(_text)), position(_position), color(_color) {
+			}
+		};
+
 		/**
 		 * Create a text renderer using a glyph bitmap with the associated glyph
 		 * mapping.
@@ -57,7 +82,7 @@ class TextRenderer {
 		//! Free resources
 		~TextRenderer();
 
-		//! Default copy constructor
+		//! Copy the font; the copy starts with an empty layout cache.
 		TextRenderer(const TextRenderer & other);
 
 		//! Default move constructor
@@ -79,6 +104,17 @@ class TextRenderer {
 				  const Geometry::Vec2i & textPosition,
 				  const Util::Color4f & textColor) const;
 
+		/**
+		 * Draw several texts, each with its own position and color, with one
+		 * draw call.
+		 * 
+		 * @param context Rendering context that is used for drawing
+		 * @param labels Texts that are to be drawn
+		 * @note the 2D-rendering mode must be enabled ( @see Draw::enable2DMode(...) )
+		 */
+		void drawMany(RenderingContext & context,
+					  const std::vector<Label> & labels) const;
+
 		/**
 		 * Calculate the size that would be needed by the text when it was
 		 * drawn.
@@ -104,6 +140,12 @@ class TextRenderer {
 		 * map
 		 */
 		int getWidthOfM() const;
+
+		//! Return the number of texts whose layout is cached.
+		std::size_t getLayoutCacheSize() const;
+
+		//! Discard the cached layouts.
+		void clearLayoutCache();
 };
 
 }
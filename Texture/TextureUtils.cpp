@@ -638,6 +638,7 @@ void updateTextureFromScreen(RenderingContext & context,Texture & t,const Geomet
 	const Texture::Format & format = t.getFormat();
 	const int width=textureRect.getWidth()>static_cast<int>(format.sizeX) ? static_cast<int>(format.sizeX) : textureRect.getWidth();
 	const int height=textureRect.getHeight()>static_cast<int>(format.sizeY) ? static_cast<int>(format.sizeY) : textureRect.getHeight();
+	context.flushTransientGeometry();
 	context.pushAndSetTexture(0,&t);
 	glCopyTexSubImage2D(GL_TEXTURE_2D,0,textureRect.getX(), textureRect.getY(),screenPosX,screenPosY, width, height);
 	context.popTexture(0);
@@ -0,0 +1,93 @@
+/*
+ This file is part of the Rendering library.
+ Copyright (C) 2026 agent <agent@local>
+
+ This library is subject to the terms of the Mozilla Public License, v. 2.0.
+ You should have received a copy of the MPL along with this library; see the
+ file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "TransientGeometryBuffer.h"
+#include "GLHeader.h"
+#include "Helper.h"
+#include "Mesh/MeshVertexData.h"
+#include "RenderingContext/RenderingContext.h"
+#include <Util/Macros.h>
+#include <algorithm>
+
+namespace Rendering {
+
+//! Alignment of the batches in the buffers
+static const size_t BATCH_ALIGNMENT = 16;
+
+TransientGeometryBuffer::TransientGeometryBuffer(size_t vertexCapacity, size_t indexCapacity) :
+		vertexRing{BufferObject(), GL_ARRAY_BUFFER, std::max(vertexCapacity, BATCH_ALIGNMENT), 0},
+		indexRing{BufferObject(), GL_ELEMENT_ARRAY_BUFFER, std::max(indexCapacity, BATCH_ALIGNMENT), 0},
+		batchDrawMode(GL_TRIANGLES) {
+}
+
+TransientGeometryBuffer::Allocation TransientGeometryBuffer::append(const VertexDescription & vd, uint32_t drawMode, uint32_t vertexCount, uint32_t indexCount) {
+	if(drawMode != GL_POINTS && drawMode != GL_LINES && drawMode != GL_TRIANGLES)
+		INVALID_ARGUMENT_EXCEPTION("TransientGeometryBuffer::append: Unsupported draw mode.");
+	if(vertexCount == 0 || indexCount == 0 || vd.getVertexSize() == 0)
+		INVALID_ARGUMENT_EXCEPTION("TransientGeometryBuffer::append: Empty geometry.");
+	if(!isCompatible(vd, drawMode))
+		INVALID_ARGUMENT_EXCEPTION("TransientGeometryBuffer::append: Geometry does not match the current batch.");
+	if(empty()) {
+		batchDescription = vd;
+		batchDrawMode = drawMode;
+	}
+	++statistics.appends;
+
+	const size_t vertexSize = batchDescription.getVertexSize();
+	const size_t vertexPosition = vertexData.size();
+	const size_t indexPosition = indexData.size();
+	vertexData.resize(vertexPosition + vertexCount * vertexSize);
+	indexData.resize(indexPosition + indexCount);
+	return {vertexData.data() + vertexPosition, indexData.data() + indexPosition, static_cast<uint32_t>(vertexPosition / vertexSize)};
+}
+
+//! (internal)
+size_t TransientGeometryBuffer::upload(Ring & ring, const uint8_t * data, size_t size) {
+	ring.position = (ring.position + BATCH_ALIGNMENT - 1) / BATCH_ALIGNMENT * BATCH_ALIGNMENT;
+	if(!ring.buffer.isValid() || ring.position + size > ring.capacity) {
+		if(ring.buffer.isValid())
+			++statistics.orphanings;
+		while(size > ring.capacity)
+			ring.capacity *= 2;
+		// the draw calls using the old storage keep it until they are finished
+		ring.buffer.allocateData<uint8_t>(ring.target, ring.capacity, GL_STREAM_DRAW);
+		ring.position = 0;
+	}
+	const size_t offset = ring.position;
+	ring.buffer.uploadSubData(ring.target, data, size, offset);
+	ring.position += size;
+	statistics.uploadedBytes += size;
+	return offset;
+}
+
+void TransientGeometryBuffer::draw(RenderingContext & rc) {
+	if(empty())
+		return;
+	const size_t vertexOffset = upload(vertexRing, vertexData.data(), vertexData.size());
+	const size_t indexOffset = upload(indexRing, reinterpret_cast<const uint8_t *>(indexData.data()), indexData.size() * sizeof(uint32_t));
+
+	vertexRing.buffer.bind(GL_ARRAY_BUFFER);
+	MeshVertexData::_bindAttributes(rc, batchDescription, reinterpret_cast<const uint8_t *>(vertexOffset));
+	indexRing.buffer.bind(GL_ELEMENT_ARRAY_BUFFER);
+	glDrawElements(batchDrawMode, static_cast<GLsizei>(indexData.size()), GL_UNSIGNED_INT, reinterpret_cast<void *>(indexOffset));
+	indexRing.buffer.unbind(GL_ELEMENT_ARRAY_BUFFER);
+	MeshVertexData::_unbindAttributes(rc);
+	vertexRing.buffer.unbind(GL_ARRAY_BUFFER);
+	GET_GL_ERROR();
+
+	++statistics.drawCalls;
+	clear();
+}
+
+void TransientGeometryBuffer::clear() {
+	vertexData.clear();
+	indexData.clear();
+}
+
+}
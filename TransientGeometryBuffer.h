@@ -0,0 +1,108 @@
+/*
+ This file is part of the Rendering library.
+ Copyright (C) 2026 agent <agent@local>
+
+ This library is subject to the terms of the Mozilla Public License, v. 2.0.
+ You should have received a copy of the MPL along with this library; see the
+ file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef RENDERING_TRANSIENTGEOMETRYBUFFER_H_
+#define RENDERING_TRANSIENTGEOMETRYBUFFER_H_
+
+#include "BufferObject.h"
+#include "Mesh/VertexDescription.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Rendering {
+class RenderingContext;
+
+/**
+ * Arena for geometry that is drawn only once (e.g. by the functions in Draw.h).
+ *
+ * Geometry is appended to a batch in main memory; consecutive appends with the same vertex description and draw mode
+ * are collected in one batch, which is drawn with one draw call by draw(). Every drawn batch is written behind the
+ * previous one into a vertex and an index buffer; if a buffer is full, its storage is orphaned (glBufferData with
+ * nullptr), so that neither writing nor drawing waits for the draw calls still using the old storage.
+ *
+ * The RenderingContext owns one buffer and decides when a batch has to be drawn (see
+ * RenderingContext::displayTransientGeometry()).
+ * @ingroup rendering_resources
+ */
+class TransientGeometryBuffer {
+	public:
+		//! Space for the appended geometry; valid until the next call of append() or draw().
+		struct Allocation {
+			uint8_t * vertices;
+			//! The indices have to be offset by baseVertex.
+			uint32_t * indices;
+			uint32_t baseVertex;
+		};
+		struct Statistics {
+			//! Number of calls of append()
+			uint32_t appends;
+			//! Number of drawn batches
+			uint32_t drawCalls;
+			//! Number of times a buffer was full and its storage was orphaned
+			uint32_t orphanings;
+			size_t uploadedBytes;
+
+			Statistics() : appends(0), drawCalls(0), orphanings(0), uploadedBytes(0) {}
+		};
+
+		/*! @param vertexCapacity, indexCapacity Initial sizes of the buffers in bytes; a buffer grows if a single
+				batch does not fit into it. */
+		explicit TransientGeometryBuffer(size_t vertexCapacity = 4 * 1024 * 1024, size_t indexCapacity = 1024 * 1024);
+
+		TransientGeometryBuffer(const TransientGeometryBuffer &) = delete;
+		TransientGeometryBuffer & operator=(const TransientGeometryBuffer &) = delete;
+
+		//! Return true if no geometry has been appended since the last draw().
+		bool empty() const								{	return indexData.empty();	}
+		//! Return true if geometry with the given vertex description and draw mode can be appended to the current batch.
+		bool isCompatible(const VertexDescription & vd, uint32_t drawMode) const {
+			return empty() || (drawMode == batchDrawMode && vd == batchDescription);
+		}
+
+		/*! Append space for @p vertexCount vertices and @p indexCount indices to the current batch, which has to
+			be empty or compatible (see isCompatible()).
+			@param drawMode One of GL_POINTS, GL_LINES or GL_TRIANGLES (geometry of strips and loops can not be
+				merged into one draw call). */
+		Allocation append(const VertexDescription & vd, uint32_t drawMode, uint32_t vertexCount, uint32_t indexCount);
+
+		/*! Upload the current batch and draw it with the current state of @p rc; the batch is empty afterwards.
+			@note RenderingContext::applyChanges() has to be called before. */
+		void draw(RenderingContext & rc);
+		//! Discard the current batch.
+		void clear();
+
+		const Statistics & getStatistics() const		{	return statistics;	}
+		void resetStatistics()							{	statistics = Statistics();	}
+
+	private:
+		struct Ring {
+			BufferObject buffer;
+			uint32_t target;
+			size_t capacity;
+			//! Position of the first free byte
+			size_t position;
+		};
+
+		Ring vertexRing;
+		Ring indexRing;
+		VertexDescription batchDescription;
+		uint32_t batchDrawMode;
+		std::vector<uint8_t> vertexData;
+		std::vector<uint32_t> indexData;
+		Statistics statistics;
+
+		//! Write @p size bytes into the ring and return their offset in the buffer.
+		size_t upload(Ring & ring, const uint8_t * data, size_t size);
+};
+
+}
+
+#endif /* RENDERING_TRANSIENTGEOMETRYBUFFER_H_ */
@@ -0,0 +1,255 @@
+/*
+ This file is part of the Rendering library.
+ Copyright (C) 2026 agent <agent@local>
+
+ This library is subject to the terms of the Mozilla Public License, v. 2.0.
+ You should have received a copy of the MPL along with this library; see the
+ file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <catch2/catch.hpp>
+#include <Rendering/Mesh/BudgetedMeshDataStrategy.h>
+#include <Rendering/Mesh/Mesh.h>
+#include <Rendering/Mesh/MeshDataStrategy.h>
+#include <Rendering/Mesh/MeshIndexData.h>
+#include <Rendering/Mesh/MeshVertexData.h>
+#include <Rendering/Mesh/VertexDescription.h>
+
+#include <Util/IO/FileName.h>
+#include <Util/References.h>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace Rendering;
+
+//! Stores the uploaded data in main memory instead of graphics memory.
+class FakeMeshBackend : public BudgetedMeshDataStrategy::Backend {
+	public:
+		std::map<Mesh *, std::pair<std::vector<uint8_t>, std::vector<uint32_t>>> uploaded;
+
+		size_t upload(Mesh * m) override {
+			const MeshVertexData & vd = m->_getVertexData();
+			const MeshIndexData & id = m->_getIndexData();
+			REQUIRE(vd.hasLocalData());
+			REQUIRE(id.hasLocalData());
+			auto & data = uploaded[m];
+			data.first.assign(vd.data(), vd.data() + vd.dataSize());
+			data.second.assign(id.data(), id.data() + id.getIndexCount());
+			return vd.dataSize() + id.dataSize();
+		}
+		void download(Mesh * m) override {
+			MeshVertexData & vd = m->_getVertexData();
+			MeshIndexData & id = m->_getIndexData();
+			const auto it = uploaded.find(m);
+			if(it == uploaded.end())
+				return;
+			if(!vd.hasLocalData()) {
+				vd.allocate(vd.getVertexCount(), vd.getVertexDescription());
+				std::copy(it->second.first.begin(), it->second.first.end(), vd.data());
+			}
+			if(!id.hasLocalData()) {
+				id.allocate(id.getIndexCount());
+				std::copy(it->second.second.begin(), it->second.second.end(), id.data());
+			}
+		}
+		void release(Mesh * m) override {
+			REQUIRE(uploaded.erase(m) == 1);
+		}
+		void display(RenderingContext &, Mesh *, uint32_t, uint32_t) override {}
+};
+
+static Mesh * createMesh(uint32_t m) {
+	VertexDescription vd;
+	vd.appendPosition3D();
+	Mesh * mesh = new Mesh(vd, 100, 300);
+	MeshVertexData & vertices = mesh->openVertexData();
+	float * positions = reinterpret_cast<float *>(vertices.data());
+	for(uint32_t i = 0; i < 3 * vertices.getVertexCount(); ++i)
+		positions[i] = static_cast<float>(m * 1000 + i);
+	MeshIndexData & indices = mesh->openIndexData();
+	for(uint32_t i = 0; i < indices.getIndexCount(); ++i)
+		indices[i] = (i * 7 + m) % 100;
+	indices.updateIndexRange();
+	return mesh;
+}
+
+static void checkMesh(Mesh * mesh, uint32_t m) {
+	const MeshVertexData & vertices = mesh->openVertexData();
+	REQUIRE(vertices.hasLocalData());
+	const float * positions = reinterpret_cast<const float *>(vertices.data());
+	for(uint32_t i = 0; i < 3 * vertices.getVertexCount(); ++i)
+		REQUIRE(positions[i] == static_cast<float>(m * 1000 + i));
+	const MeshIndexData & indices = mesh->openIndexData();
+	REQUIRE(indices.hasLocalData());
+	for(uint32_t i = 0; i < indices.getIndexCount(); ++i)
+		REQUIRE(indices[i] == (i * 7 + m) % 100);
+}
+
+TEST_CASE("BudgetedMeshDataStrategyTest_evict", "[BudgetedMeshDataStrategyTest]") {
+	const size_t meshBytes = 100 * 3 * sizeof(float) + 300 * sizeof(uint32_t);
+	std::unique_ptr<FakeMeshBackend> fakeBackend(new FakeMeshBackend);
+	FakeMeshBackend * backend = fakeBackend.get();
+	BudgetedMeshDataStrategy strategy(3 * meshBytes, BudgetedMeshDataStrategy::COMPRESS_EVICTED_DATA, std::move(fakeBackend));
+
+	std::vector<Util::Reference<Mesh>> meshes;
+	for(uint32_t m = 0; m < 10; ++m) {
+		meshes.push_back(createMesh(m));
+		meshes.back()->setDataStrategy(&strategy);
+	}
+
+	// display a sliding window of two meshes per frame
+	for(uint32_t frame = 0; frame < 20; ++frame) {
+		strategy.beginFrame();
+		strategy.prepare(meshes[frame % 10].get());
+		strategy.prepare(meshes[(frame + 1) % 10].get());
+		REQUIRE(strategy.getResidentBytes() <= strategy.getBudget());
+		REQUIRE(strategy.getResidentBytes() == meshBytes * backend->uploaded.size());
+		REQUIRE(strategy.isResident(meshes[frame % 10].get()));
+		REQUIRE(strategy.isResident(meshes[(frame + 1) % 10].get()));
+		if(frame > 1) {
+			// from frame 9 on, every uploaded mesh has been evicted before
+			const auto & statistics = strategy.getFrameStatistics();
+			REQUIRE(statistics.uploads == 1);
+			REQUIRE(statistics.restores == (frame >= 9 ? 1 : 0));
+			REQUIRE(statistics.evictions == 1);
+			REQUIRE(statistics.evictedBytes == meshBytes);
+			REQUIRE(statistics.residentMeshes == 3);
+		}
+	}
+	// the least recently displayed mesh has been evicted and its data has been compressed
+	REQUIRE(strategy.isResident(meshes[9].get()));
+	REQUIRE(strategy.isResident(meshes[0].get()));
+	REQUIRE(strategy.isResident(meshes[8].get()));
+	REQUIRE_FALSE(strategy.isResident(meshes[7].get()));
+	REQUIRE_FALSE(meshes[7]->_getVertexData().hasLocalData());
+	REQUIRE(strategy.getCompressedBytes() > 0);
+	REQUIRE(strategy.getCompressedBytes() < 7 * meshBytes);
+	REQUIRE(strategy.getLastFrameStatistics().uploads == 1);
+
+	// meshes displayed in the current frame are not evicted
+	strategy.beginFrame();
+	for(auto & mesh : meshes)
+		strategy.prepare(mesh.get());
+	REQUIRE(strategy.getResidentBytes() == 10 * meshBytes);
+	strategy.beginFrame();
+	REQUIRE(strategy.getResidentBytes() == 3 * meshBytes);
+	REQUIRE(strategy.getLastFrameStatistics().residentMeshes == 10);
+
+	// the data survives the eviction
+	for(uint32_t m = 0; m < 10; ++m)
+		checkMesh(meshes[m].get(), m);
+
+	strategy.setBudget(0);
+	REQUIRE(strategy.getResidentBytes() == 0);
+	REQUIRE(backend->uploaded.empty());
+	meshes.clear();
+	REQUIRE(strategy.getMeshCount() == 0);
+}
+
+TEST_CASE("BudgetedMeshDataStrategyTest_reload", "[BudgetedMeshDataStrategyTest]") {
+	uint32_t loadCount = 0;
+	BudgetedMeshDataStrategy strategy(0, BudgetedMeshDataStrategy::RELOAD_FROM_FILE,
+									  std::unique_ptr<BudgetedMeshDataStrategy::Backend>(new FakeMeshBackend),
+									  [&loadCount](const Util::FileName & fileName) {
+		++loadCount;
+		return createMesh(static_cast<uint32_t>(std::stoul(fileName.getFile())));
+	});
+
+	Util::Reference<Mesh> fileMesh = createMesh(1);
+	fileMesh->setFileName(Util::FileName("1"));
+	Util::Reference<Mesh> changedMesh = createMesh(2);
+	changedMesh->setFileName(Util::FileName("2"));
+	fileMesh->setDataStrategy(&strategy);
+	changedMesh->setDataStrategy(&strategy);
+
+	strategy.prepare(fileMesh.get());
+	strategy.prepare(changedMesh.get());
+	strategy.beginFrame();
+	REQUIRE(strategy.getResidentBytes() == 0);
+	REQUIRE_FALSE(fileMesh->_getVertexData().hasLocalData());
+	REQUIRE(strategy.getCompressedBytes() == 0);
+
+	// the evicted mesh is loaded again when it is opened or displayed
+	checkMesh(fileMesh.get(), 1);
+	REQUIRE(loadCount == 1);
+	REQUIRE(strategy.getFrameStatistics().restores == 1);
+
+	// a changed mesh is not loaded from its file
+	changedMesh->openVertexData().markAsChanged();
+	REQUIRE(loadCount == 2);
+	strategy.prepare(changedMesh.get());
+	strategy.beginFrame();
+	REQUIRE_FALSE(strategy.isResident(changedMesh.get()));
+	checkMesh(changedMesh.get(), 2);
+	REQUIRE(loadCount == 2);
+
+	// neither is a mesh changed before its first upload
+	Util::Reference<Mesh> editedMesh = createMesh(3);
+	editedMesh->setFileName(Util::FileName("3"));
+	editedMesh->setDataStrategy(&strategy);
+	{
+		Util::Reference<Mesh> edit = createMesh(4);
+		editedMesh->openVertexData().swap(edit->openVertexData());
+		editedMesh->openIndexData().swap(edit->openIndexData());
+		editedMesh->openVertexData().markAsChanged();
+		editedMesh->openIndexData().markAsChanged();
+	}
+	strategy.prepare(editedMesh.get());
+	strategy.beginFrame();
+	REQUIRE_FALSE(strategy.isResident(editedMesh.get()));
+	checkMesh(editedMesh.get(), 4);
+	REQUIRE(loadCount == 2);
+
+	// as default strategy, the strategy sees the meshes before their data is filled in
+	MeshDataStrategy * previousDefault = MeshDataStrategy::getDefaultStrategy();
+	MeshDataStrategy::setDefaultStrategy(&strategy);
+	{
+		// changed after the file name has been set
+		Util::Reference<Mesh> defaultMesh = createMesh(5);
+		defaultMesh->setFileName(Util::FileName("5"));
+		{
+			Util::Reference<Mesh> edit = createMesh(6);
+			defaultMesh->openVertexData().swap(edit->openVertexData());
+			defaultMesh->openIndexData().swap(edit->openIndexData());
+			defaultMesh->openVertexData().markAsChanged();
+		}
+		strategy.prepare(defaultMesh.get());
+		strategy.beginFrame();
+		REQUIRE_FALSE(strategy.isResident(defaultMesh.get()));
+		checkMesh(defaultMesh.get(), 6);
+		REQUIRE(loadCount == 2);
+
+		// filled like by a loader: the file name is set after the data
+		Util::Reference<Mesh> loadedMesh = new Mesh;
+		{
+			Util::Reference<Mesh> data = createMesh(7);
+			loadedMesh->openVertexData().swap(data->openVertexData());
+			loadedMesh->openIndexData().swap(data->openIndexData());
+		}
+		loadedMesh->setFileName(Util::FileName("7"));
+		strategy.prepare(loadedMesh.get());
+		strategy.beginFrame();
+		REQUIRE_FALSE(loadedMesh->_getVertexData().hasLocalData());
+		checkMesh(loadedMesh.get(), 7);
+		REQUIRE(loadCount == 3);
+
+		// filled after the file name has been set: the data may differ from the file
+		Util::Reference<Mesh> filledMesh = new Mesh;
+		filledMesh->setFileName(Util::FileName("8"));
+		{
+			Util::Reference<Mesh> data = createMesh(9);
+			filledMesh->openVertexData().swap(data->openVertexData());
+			filledMesh->openIndexData().swap(data->openIndexData());
+		}
+		strategy.prepare(filledMesh.get());
+		strategy.beginFrame();
+		REQUIRE_FALSE(strategy.isResident(filledMesh.get()));
+		checkMesh(filledMesh.get(), 9);
+		REQUIRE(loadCount == 3);
+	}
+	MeshDataStrategy::setDefaultStrategy(previousDefault);
+}
@@ -9,13 +9,29 @@
 #include <catch2/catch.hpp>
 
 #include <Geometry/Box.h>
+#include <Geometry/Rect.h>
+#include <Geometry/Vec2.h>
 #include <Geometry/Vec3.h>
+#include <Rendering/Mesh/Mesh.h>
+#include <Rendering/Mesh/MeshIndexData.h>
+#include <Rendering/Mesh/MeshVertexData.h>
+#include <Rendering/Mesh/VertexDescription.h>
 #include <Rendering/RenderingContext/RenderingContext.h>
 #include <Rendering/Draw.h>
 #include <Rendering/Helper.h>
+#include <Rendering/TextRenderer.h>
+#include <Rendering/TransientGeometryBuffer.h>
+#include <Util/Graphics/Bitmap.h>
+#include <Util/Graphics/Color.h>
+#include <Util/Graphics/FontRenderer.h>
+#include <Util/Graphics/PixelFormat.h>
+#include <Util/References.h>
 #include <Util/Timer.h>
+#include <algorithm>
 #include <cstdint>
 #include <iostream>
+#include <string>
+#include <vector>
 
 TEST_CASE("DrawTest_testBox", "[DrawTest]") {
 	using namespace Rendering;
@@ -51,3 +67,298 @@ TEST_CASE("DrawTest_testBox", "[DrawTest]") {
 	std::cout << "drawFastAbsBox: " << drawFastBoxTimer.getSeconds() << " s" << std::endl;
 	std::cout << "drawAbsBox: " << drawBoxTimer.getSeconds() << " s" << std::endl;
 }
+
+TEST_CASE("DrawTest_transientGeometry", "[DrawTest]") {
+	using namespace Rendering;
+	const Geometry::Vec3f a(0.0f, 0.0f, 0.0f), b(1.0f, 0.0f, 0.0f), c(1.0f, 1.0f, 0.0f), d(0.0f, 1.0f, 0.0f);
+
+	RenderingContext context;
+	context.setImmediateMode(false);
+	TransientGeometryBuffer & buffer = context.getTransientGeometryBuffer();
+
+	// consecutive calls with the same state are drawn with one draw call
+	buffer.resetStatistics();
+	context.beginTransientGeometryBatch();
+	for(uint_fast32_t quad = 0; quad < 100; ++quad)
+		drawQuad(context, a, b, c, d, Util::Color4f(1.0f, 0.0f, 0.0f, 1.0f));
+	REQUIRE(buffer.getStatistics().drawCalls == 0);
+	context.flushTransientGeometry();
+	REQUIRE(buffer.getStatistics().appends == 100);
+	REQUIRE(buffer.getStatistics().drawCalls == 1);
+	REQUIRE(buffer.empty());
+
+	// a different state, vertex description or draw mode starts a new draw call
+	buffer.resetStatistics();
+	drawQuad(context, a, b, c, d, Util::Color4f(1.0f, 0.0f, 0.0f, 1.0f));
+	drawQuad(context, a, b, c, d, Util::Color4f(0.0f, 0.0f, 1.0f, 1.0f));
+	drawQuad(context, a, b, c, d, Util::Color4f(0.0f, 0.0f, 1.0f, 1.0f));
+	drawTriangle(context, a, b, c);
+	drawVector(context, a, c);
+	drawVector(context, b, d);
+	REQUIRE(buffer.getStatistics().drawCalls == 3);
+	// the pending geometry is drawn before any other draw call
+	context.applyChanges();
+	REQUIRE(buffer.getStatistics().drawCalls == 4);
+	REQUIRE(buffer.empty());
+
+	// the pending geometry is drawn at the end of the batch
+	drawVector(context, a, c);
+	REQUIRE(buffer.getStatistics().drawCalls == 4);
+	context.endTransientGeometryBatch();
+	REQUIRE(buffer.getStatistics().drawCalls == 5);
+	REQUIRE(buffer.empty());
+	REQUIRE(!context.isBatchingTransientGeometry());
+}
+
+TEST_CASE("DrawTest_transientGeometryImmediate", "[DrawTest]") {
+	using namespace Rendering;
+	const Geometry::Vec3f a(0.0f, 0.0f, 0.0f), b(1.0f, 0.0f, 0.0f), c(1.0f, 1.0f, 0.0f), d(0.0f, 1.0f, 0.0f);
+
+	RenderingContext context;
+	REQUIRE(context.getImmediateMode());
+	TransientGeometryBuffer & buffer = context.getTransientGeometryBuffer();
+
+	// without a batch, every call is drawn immediately
+	buffer.resetStatistics();
+	for(uint_fast32_t quad = 0; quad < 10; ++quad) {
+		drawQuad(context, a, b, c, d);
+		REQUIRE(buffer.getStatistics().drawCalls == quad + 1);
+		REQUIRE(buffer.empty());
+	}
+
+	// inside a batch, calls without state changes are drawn with one draw call at the end of the outermost batch
+	buffer.resetStatistics();
+	context.beginTransientGeometryBatch();
+	REQUIRE(context.isBatchingTransientGeometry());
+	for(uint_fast32_t quad = 0; quad < 50; ++quad)
+		drawQuad(context, a, b, c, d);
+	context.beginTransientGeometryBatch();
+	for(uint_fast32_t quad = 0; quad < 50; ++quad)
+		drawQuad(context, a, b, c, d);
+	context.endTransientGeometryBatch();
+	REQUIRE(buffer.getStatistics().drawCalls == 0);
+	context.endTransientGeometryBatch();
+	REQUIRE(!context.isBatchingTransientGeometry());
+	REQUIRE(buffer.getStatistics().appends == 100);
+	REQUIRE(buffer.getStatistics().drawCalls == 1);
+	REQUIRE(buffer.empty());
+
+	// in immediate mode, every state change draws the pending geometry
+	buffer.resetStatistics();
+	context.beginTransientGeometryBatch();
+	drawQuad(context, a, b, c, d, Util::Color4f(1.0f, 0.0f, 0.0f, 1.0f));
+	REQUIRE(buffer.getStatistics().drawCalls == 1);
+	drawQuad(context, a, b, c, d);
+	drawQuad(context, a, b, c, d);
+	REQUIRE(buffer.getStatistics().drawCalls == 1);
+	context.endTransientGeometryBatch();
+	REQUIRE(buffer.getStatistics().drawCalls == 2);
+}
+
+TEST_CASE("DrawTest_transientGeometryBenchmark", "[.][DrawTest]") {
+	using namespace Rendering;
+	std::cout << std::endl;
+	const uint32_t quadCount = 10000;
+	const uint32_t frameCount = 20;
+
+	RenderingContext context;
+	context.setImmediateMode(false);
+	Rendering::disableGLErrorChecking();
+
+	// previous implementation of drawQuad: one mesh that is uploaded again for every quad
+	Util::Reference<Mesh> mesh;
+	{
+		VertexDescription vertexDescription;
+		vertexDescription.appendPosition3D();
+		vertexDescription.appendNormalFloat();
+		vertexDescription.appendTexCoord();
+		mesh = new Mesh(vertexDescription, 4, 6);
+		MeshIndexData & id = mesh->openIndexData();
+		const uint32_t quadIndices[] = {0, 1, 2, 0, 2, 3};
+		std::copy(quadIndices, quadIndices + 6, id.data());
+		id.updateIndexRange();
+		id.markAsChanged();
+	}
+
+	Util::Timer meshTimer;
+	meshTimer.resume();
+	for(uint_fast32_t frame = 0; frame < frameCount; ++frame) {
+		for(uint_fast32_t quad = 0; quad < quadCount; ++quad) {
+			const float x = static_cast<float>(quad % 100);
+			const float y = static_cast<float>(quad / 100);
+			MeshVertexData & vd = mesh->openVertexData();
+			float * vertices = reinterpret_cast<float *>(vd.data());
+			const float quadVertices[] = {
+				x, y, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f,
+				x + 1.0f, y, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 0.0f,
+				x + 1.0f, y + 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f,
+				x, y + 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 1.0f
+			};
+			std::copy(quadVertices, quadVertices + 32, vertices);
+			vd.updateBoundingBox();
+			vd.markAsChanged();
+			context.displayMesh(mesh.get());
+		}
+		RenderingContext::finish();
+	}
+	meshTimer.stop();
+
+	const double quads = static_cast<double>(quadCount) * frameCount;
+	std::cout << "Mesh per quad: " << quads / meshTimer.getSeconds() << " quads/s" << std::endl;
+
+	const auto measure = [&](const char * name, bool batched) {
+		TransientGeometryBuffer & buffer = context.getTransientGeometryBuffer();
+		buffer.resetStatistics();
+		Util::Timer timer;
+		timer.resume();
+		for(uint_fast32_t frame = 0; frame < frameCount; ++frame) {
+			if(batched)
+				context.beginTransientGeometryBatch();
+			for(uint_fast32_t quad = 0; quad < quadCount; ++quad) {
+				const float x = static_cast<float>(quad % 100);
+				const float y = static_cast<float>(quad / 100);
+				drawQuad(context, Geometry::Vec3f(x, y, 0.0f), Geometry::Vec3f(x + 1.0f, y, 0.0f),
+						 Geometry::Vec3f(x + 1.0f, y + 1.0f, 0.0f), Geometry::Vec3f(x, y + 1.0f, 0.0f));
+			}
+			if(batched)
+				context.endTransientGeometryBatch();
+			RenderingContext::finish();
+		}
+		timer.stop();
+		std::cout << name << ": " << quads / timer.getSeconds() << " quads/s ("
+				  << buffer.getStatistics().drawCalls << " draw calls)" << std::endl;
+	};
+	// default: every quad is drawn immediately
+	measure("Transient geometry", false);
+	measure("Transient geometry (batch)", true);
+	Rendering::enableGLErrorChecking();
+}
+
+//! Text renderer with glyphs of 5x7 pixels for 'A' to 'Z', U+FFFD and U+1F600.
+static Rendering::TextRenderer createTextRenderer() {
+	Util::FontInfo fontInfo;
+	fontInfo.ascender = 8;
+	const auto addGlyph = [&fontInfo](uint32_t codepoint, int column) {
+		Util::GlyphInfo & glyphInfo = fontInfo.glyphMap[codepoint];
+		glyphInfo.position = std::make_pair(column * 6, 0);
+		glyphInfo.size = std::make_pair(5, 7);
+		glyphInfo.offset = std::make_pair(0, 7);
+		glyphInfo.xAdvance = 6;
+	};
+	for(uint32_t character = 'A'; character <= 'Z'; ++character)
+		addGlyph(character, static_cast<int>(character - 'A'));
+	addGlyph(0xFFFD, 26);
+	addGlyph(0x1F600, 27);
+	Util::Reference<Util::Bitmap> bitmap = new Util::Bitmap(28 * 6, 8, Util::PixelFormat::MONO);
+	return Rendering::TextRenderer(*bitmap.get(), fontInfo);
+}
+
+TEST_CASE("DrawTest_textRenderer", "[DrawTest]") {
+	using namespace Rendering;
+	TextRenderer textRenderer = createTextRenderer();
+
+	REQUIRE(textRenderer.getWidthOfM() == 5);
+	REQUIRE(textRenderer.getHeightOfX() == 0);
+
+	const Geometry::Rect_i size = textRenderer.getTextSize(U"AB");
+	REQUIRE(size.getX() == 0);
+	REQUIRE(size.getY() == 1);
+	REQUIRE(size.getWidth() == 11);
+	REQUIRE(size.getHeight() == 7);
+	REQUIRE(textRenderer.getLayoutCacheSize() == 1);
+	// missing characters are skipped
+	REQUIRE(textRenderer.getTextSize(U"A?B").getWidth() == 11);
+	REQUIRE(textRenderer.getTextSize(U"\U0001F600A").getWidth() == 11);
+	REQUIRE(textRenderer.getTextSize(U"\uFFFDA").getWidth() == 11);
+	REQUIRE(textRenderer.getTextSize(U"AB").getWidth() == 11);
+	REQUIRE(textRenderer.getLayoutCacheSize() == 4);
+	textRenderer.clearLayoutCache();
+	REQUIRE(textRenderer.getLayoutCacheSize() == 0);
+
+	// a copy does not share the layout cache
+	textRenderer.getTextSize(U"AB");
+	const TextRenderer copy(textRenderer);
+	REQUIRE(copy.getLayoutCacheSize() == 0);
+	REQUIRE(copy.getTextSize(U"\uFFFDA").getWidth() == 11);
+	REQUIRE(copy.getWidthOfM() == 5);
+
+	// when the cache is full, only the least recently used layout is removed
+	const auto createText = [](uint32_t number) {
+		std::u32string text(U"A");
+		for(uint32_t value = number; value > 0; value /= 26)
+			text += static_cast<char32_t>('A' + value % 26);
+		return text;
+	};
+	const size_t maxCachedLayouts = 4096;
+	textRenderer.clearLayoutCache();
+	for(uint32_t number = 0; number < maxCachedLayouts + 100; ++number)
+		REQUIRE(textRenderer.getTextSize(createText(number)).getWidth() == static_cast<int>(createText(number).size()) * 6 - 1);
+	REQUIRE(textRenderer.getLayoutCacheSize() == maxCachedLayouts);
+	textRenderer.clearLayoutCache();
+	REQUIRE(textRenderer.getLayoutCacheSize() == 0);
+
+	RenderingContext context;
+	context.setImmediateMode(false);
+	TransientGeometryBuffer & buffer = context.getTransientGeometryBuffer();
+
+	// texts in different colors are drawn with one draw call
+	std::vector<TextRenderer::Label> labels;
+	for(int label = 0; label < 100; ++label)
+		labels.emplace_back(U"LABEL", Geometry::Vec2i(0, label * 10), Util::Color4f(label / 100.0f, 0.0f, 0.0f, 1.0f));
+	buffer.resetStatistics();
+	textRenderer.drawMany(context, labels);
+	REQUIRE(buffer.getStatistics().drawCalls == 1);
+	context.beginTransientGeometryBatch();
+	textRenderer.drawMany(context, labels);
+	textRenderer.draw(context, U"TEXT", Geometry::Vec2i(10, 10), Util::Color4f(0.0f, 1.0f, 0.0f, 1.0f));
+	textRenderer.draw(context, U"", Geometry::Vec2i(10, 10), Util::Color4f(0.0f, 1.0f, 0.0f, 1.0f));
+	context.endTransientGeometryBatch();
+	REQUIRE(buffer.getStatistics().appends == 3);
+	REQUIRE(buffer.getStatistics().drawCalls == 2);
+	REQUIRE(textRenderer.getLayoutCacheSize() == 3);
+}
+
+TEST_CASE("DrawTest_textRendererBenchmark", "[.][DrawTest]") {
+	using namespace Rendering;
+	std::cout << std::endl;
+	const uint32_t labelCount = 500;
+	const uint32_t frameCount = 100;
+
+	TextRenderer textRenderer = createTextRenderer();
+	RenderingContext context;
+	context.setImmediateMode(false);
+	Rendering::disableGLErrorChecking();
+
+	std::vector<TextRenderer::Label> labels;
+	size_t glyphCount = 0;
+	for(uint32_t label = 0; label < labelCount; ++label) {
+		std::u32string text(U"LABEL NUMBER ");
+		for(uint32_t value = label; value > 0; value /= 26)
+			text += static_cast<char32_t>('A' + value % 26);
+		glyphCount += text.size();
+		labels.emplace_back(text, Geometry::Vec2i(static_cast<int>(label % 10) * 100, static_cast<int>(label / 10) * 10),
+							Util::Color4f(1.0f, 1.0f, 1.0f, 1.0f));
+	}
+
+	const auto measure = [&](const char * name, bool cached, bool batched) {
+		Util::Timer timer;
+		timer.resume();
+		for(uint_fast32_t frame = 0; frame < frameCount; ++frame) {
+			if(!cached)
+				textRenderer.clearLayoutCache();
+			if(batched) {
+				textRenderer.drawMany(context, labels);
+			} else {
+				for(const auto & label : labels)
+					textRenderer.draw(context, label.text, label.position, label.color);
+			}
+			RenderingContext::finish();
+		}
+		timer.stop();
+		std::cout << name << ": " << static_cast<double>(glyphCount) * frameCount / timer.getMilliseconds() << " glyphs/ms" << std::endl;
+	};
+	measure("draw without layout cache", false, false);
+	measure("draw", true, false);
+	measure("drawMany", true, true);
+	Rendering::enableGLErrorChecking();
+}
@@ -0,0 +1,1094 @@
+/*
+ This file is part of the Rendering library.
+ Copyright (C) 2026 agent <agent@local>
+
+ This library is subject to the terms of the Mozilla Public License, v. 2.0.
+ You should have received a copy of the MPL along with this library; see the
+ file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <catch2/catch.hpp>
+#include <Rendering/GLHeader.h>
+#include <Rendering/Mesh/Mesh.h>
+#include <Rendering/Mesh/MeshDataStrategy.h>
+#include <Rendering/Mesh/MeshIndexData.h>
+#include <Rendering/Mesh/MeshVertexData.h>
+#include <Rendering/Mesh/VertexDescription.h>
+#include <Rendering/Mesh/VertexAttributeAccessors.h>
+#include <Rendering/Mesh/VertexAttributeIds.h>
+#include <Rendering/MeshUtils/LODChain.h>
+#include <Rendering/MeshUtils/MarchingCubesMeshBuilder.h>
+#include <Rendering/MeshUtils/MeshClusters.h>
+#include <Rendering/MeshUtils/MeshOptimizer.h>
+#include <Rendering/MeshUtils/MeshUtils.h>
+#include <Rendering/MeshUtils/NormalCalculation.h>
+#include <Rendering/MeshUtils/PrimitiveShapes.h>
+#include <Rendering/MeshUtils/Quantization.h>
+#include <Rendering/MeshUtils/Simplification.h>
+#include <Rendering/MeshUtils/TriangleBVH.h>
+#include <Rendering/Serialization/StreamerMMF.h>
+
+#include <Geometry/LineTriangleIntersection.h>
+#include <Geometry/Matrix4x4.h>
+#include <Geometry/Ray.h>
+#include <Geometry/Sphere.h>
+#include <Geometry/Triangle.h>
+#include <Geometry/Vec3.h>
+#include <Geometry/Vec4.h>
+#include <Util/Graphics/Color.h>
+#include <Util/Timer.h>
+#include <Util/References.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace Rendering;
+
+//! Grid of quads where every quad has its own four (slightly jittered) corner vertices.
+static Mesh * createQuadSoup(uint32_t quadsPerSide, float jitter) {
+	VertexDescription vd;
+	vd.appendPosition3D();
+	const uint32_t quadCount = quadsPerSide * quadsPerSide;
+	Mesh * mesh = new Mesh(vd, 4 * quadCount, 6 * quadCount);
+	std::default_random_engine engine(0);
+	std::uniform_real_distribution<float> jitterDist(-jitter, jitter);
+
+	MeshVertexData & vData = mesh->openVertexData();
+	MeshIndexData & iData = mesh->openIndexData();
+	auto posAcc = PositionAttributeAccessor::create(vData);
+	uint32_t * indices = iData.data();
+	for(uint32_t y = 0; y < quadsPerSide; ++y) {
+		for(uint32_t x = 0; x < quadsPerSide; ++x) {
+			const uint32_t base = 4 * (y * quadsPerSide + x);
+			for(uint32_t c = 0; c < 4; ++c)
+				posAcc->setPosition(base + c, Geometry::Vec3((x + (c & 1)) * 0.1f + jitterDist(engine), (y + (c >> 1)) * 0.1f + jitterDist(engine), jitterDist(engine)));
+			const uint32_t quad[6] = {base, base + 1, base + 2, base + 1, base + 3, base + 2};
+			std::copy(quad, quad + 6, indices + 6 * (y * quadsPerSide + x));
+		}
+	}
+	vData.updateBoundingBox();
+	iData.updateIndexRange();
+	return mesh;
+}
+
+//! Previous, tree based implementation of eliminateDuplicateVertices() and mergeCloseVertices() as reference.
+namespace Baseline {
+struct RawVertex {
+	uint32_t index;
+	const uint8_t * data;
+	size_t size;
+
+	bool operator<(const RawVertex & other) const {
+		const int result = memcmp(data, other.data, std::min(size, other.size));
+		return result != 0 ? result < 0 : size < other.size;
+	}
+};
+
+template<typename Set_t>
+static void weld(Mesh * mesh, Set_t & rawVertices) {
+	const VertexDescription & desc = mesh->getVertexDescription();
+	const uint32_t indexCount = mesh->getIndexCount();
+	std::map<uint32_t, uint32_t> indexReplace;
+	{
+		const MeshVertexData & vertices = mesh->openVertexData();
+		const MeshIndexData & indices = mesh->openIndexData();
+		for(uint32_t counter = 0; counter < indexCount; ++counter) {
+			const uint32_t index = indices[counter];
+			auto it = rawVertices.insert(RawVertex{index, vertices[index], desc.getVertexSize()}).first;
+			indexReplace.insert(std::make_pair(index, it->index));
+		}
+	}
+	std::map<uint32_t, uint32_t> indexPosition;
+	Util::Reference<Mesh> result = new Mesh;
+	MeshVertexData & vertices = result->openVertexData();
+	vertices.allocate(rawVertices.size(), desc);
+	MeshIndexData & indices = result->openIndexData();
+	indices.allocate(indexCount);
+	{
+		uint8_t * data = vertices.data();
+		uint32_t vertexPos = 0;
+		for(const auto & vertex : rawVertices) {
+			std::copy(vertex.data, vertex.data + vertex.size, data);
+			data += vertex.size;
+			indexPosition.insert(std::make_pair(vertex.index, vertexPos++));
+		}
+		const uint32_t * srcIndex = mesh->openIndexData().data();
+		uint32_t * dstIndex = indices.data();
+		for(uint32_t counter = 0; counter < indexCount; ++counter)
+			dstIndex[counter] = indexPosition.find(indexReplace.find(srcIndex[counter])->second)->second;
+	}
+	vertices.updateBoundingBox();
+	indices.updateIndexRange();
+	mesh->swap(*result.get());
+}
+
+static void eliminateDuplicateVertices(Mesh * mesh) {
+	std::set<RawVertex> rawVertices;
+	weld(mesh, rawVertices);
+}
+
+static void mergeCloseVertices(Mesh * mesh, float tolerance) {
+	auto posAcc = PositionAttributeAccessor::create(mesh->openVertexData());
+	auto comp = [&posAcc, tolerance](const RawVertex & lhs, const RawVertex & rhs) {
+		const auto v1 = posAcc->getPosition(lhs.index);
+		const auto v2 = posAcc->getPosition(rhs.index);
+		if(std::abs(v1.x() - v2.x()) > tolerance)
+			return v1.x() < v2.x();
+		if(std::abs(v1.y() - v2.y()) > tolerance)
+			return v1.y() < v2.y();
+		if(std::abs(v1.z() - v2.z()) > tolerance)
+			return v1.z() < v2.z();
+		return false;
+	};
+	std::set<RawVertex, decltype(comp)> rawVertices(comp);
+	weld(mesh, rawVertices);
+}
+}
+
+//! Require that both meshes reference the same positions (up to @p tolerance) in the same order.
+static void requireSamePositions(Mesh * expected, Mesh * actual, float tolerance) {
+	REQUIRE(actual->getIndexCount() == expected->getIndexCount());
+	auto expectedAcc = PositionAttributeAccessor::create(expected->openVertexData());
+	auto actualAcc = PositionAttributeAccessor::create(actual->openVertexData());
+	const MeshIndexData & expectedIndices = expected->openIndexData();
+	const MeshIndexData & actualIndices = actual->openIndexData();
+	uint32_t firstDifference = 0;
+	while(firstDifference < expectedIndices.getIndexCount()
+			&& expectedAcc->getPosition(expectedIndices[firstDifference]).distance(actualAcc->getPosition(actualIndices[firstDifference])) <= tolerance)
+		++firstDifference;
+	REQUIRE(firstDifference == expectedIndices.getIndexCount());
+}
+
+static void checkWelding(uint32_t quadsPerSide) {
+	const uint32_t expectedVertexCount = (quadsPerSide + 1) * (quadsPerSide + 1);
+	Util::Timer t;
+	{
+		Util::Reference<Mesh> mesh = createQuadSoup(quadsPerSide, 0.0f);
+		Util::Reference<Mesh> reference = mesh->clone();
+		t.reset();
+		Baseline::eliminateDuplicateVertices(reference.get());
+		std::cout << "eliminateDuplicateVertices, previous implementation (" << mesh->getVertexCount() << " vertices): " << t.getMilliseconds() << " ms" << std::endl;
+		REQUIRE(reference->getVertexCount() == expectedVertexCount);
+
+		t.reset();
+		MeshUtils::eliminateDuplicateVertices(mesh.get());
+		std::cout << "eliminateDuplicateVertices: " << t.getMilliseconds() << " ms" << std::endl;
+		REQUIRE(mesh->getVertexCount() == expectedVertexCount);
+		requireSamePositions(reference.get(), mesh.get(), 0.0f);
+	}
+	{
+		const float tolerance = 0.001f;
+		Util::Reference<Mesh> mesh = createQuadSoup(quadsPerSide, tolerance * 0.25f);
+		Util::Reference<Mesh> reference = mesh->clone();
+		const uint32_t vertexCount = mesh->getVertexCount();
+		t.reset();
+		Baseline::mergeCloseVertices(reference.get(), tolerance);
+		std::cout << "mergeCloseVertices, previous implementation: " << t.getMilliseconds() << " ms" << std::endl;
+		REQUIRE(reference->getVertexCount() == expectedVertexCount);
+
+		t.reset();
+		REQUIRE(MeshUtils::mergeCloseVertices(mesh.get(), tolerance) == vertexCount - expectedVertexCount);
+		std::cout << "mergeCloseVertices: " << t.getMilliseconds() << " ms" << std::endl;
+		REQUIRE(mesh->getVertexCount() == expectedVertexCount);
+		// the merged vertices may be represented by different members of their cluster
+		requireSamePositions(reference.get(), mesh.get(), 2 * tolerance);
+	}
+}
+
+TEST_CASE("MeshUtilsTest_weldVertices", "[MeshUtilsTest]") {
+	std::cout << std::endl;
+	checkWelding(500); // 1M vertices
+}
+
+TEST_CASE("MeshUtilsTest_weldVerticesLarge", "[.][MeshUtilsTest]") {
+	std::cout << std::endl;
+	checkWelding(1582); // 10M vertices
+}
+
+TEST_CASE("MeshUtilsTest_splitIntoConnectedComponents", "[MeshUtilsTest]") {
+	// A: quad, B: single triangle, C: two triangles whose shared corners are duplicated with a small offset
+	const std::vector<Geometry::Vec3> positions = {
+		{0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 0.0f}, {0.0f, 1.0f, 0.0f},
+		{10.0f, 0.0f, 0.0f}, {11.0f, 0.0f, 0.0f}, {10.0f, 1.0f, 0.0f},
+		{0.0f, 10.0f, 0.0f}, {1.0f, 10.0f, 0.0f}, {0.0f, 11.0f, 0.0f},
+		{1.005f, 10.0f, 0.0f}, {1.0f, 11.0f, 0.0f}, {0.005f, 11.0f, 0.0f}
+	};
+	// triangles in the order A, C, B, A, C
+	const std::vector<uint32_t> indices = {0, 1, 2, 7, 8, 9, 4, 5, 6, 0, 2, 3, 10, 11, 12};
+
+	VertexDescription vd;
+	vd.appendPosition3D();
+	Util::Reference<Mesh> mesh = new Mesh(vd, static_cast<uint32_t>(positions.size()), static_cast<uint32_t>(indices.size()));
+	mesh->setDataStrategy(SimpleMeshDataStrategy::getPureLocalStrategy());
+	{
+		auto posAcc = PositionAttributeAccessor::create(mesh->openVertexData());
+		for(uint32_t i = 0; i < positions.size(); ++i)
+			posAcc->setPosition(i, positions[i]);
+		std::copy(indices.begin(), indices.end(), mesh->openIndexData().data());
+		mesh->openVertexData().updateBoundingBox();
+		mesh->openIndexData().updateIndexRange();
+	}
+
+	// the components are ordered by their first triangle; their vertices by their first reference
+	const auto requireComponent = [&positions](Mesh * component, const std::vector<uint32_t> & sourceVertices, const std::vector<uint32_t> & expectedIndices) {
+		REQUIRE(component->getDataStrategy() == SimpleMeshDataStrategy::getPureLocalStrategy());
+		REQUIRE(component->getVertexCount() == sourceVertices.size());
+		REQUIRE(component->getIndexCount() == expectedIndices.size());
+		auto posAcc = PositionAttributeAccessor::create(component->openVertexData());
+		for(uint32_t i = 0; i < sourceVertices.size(); ++i)
+			REQUIRE(posAcc->getPosition(i) == positions[sourceVertices[i]]);
+		const MeshIndexData & componentIndices = component->openIndexData();
+		for(uint32_t i = 0; i < expectedIndices.size(); ++i)
+			REQUIRE(componentIndices[i] == expectedIndices[i]);
+	};
+
+	// C is connected by merging its duplicated corners (the distance is relative to the diagonal of about 15.6)
+	{
+		std::deque<Mesh *> components = MeshUtils::splitIntoConnectedComponents(mesh.get(), 0.001f);
+		REQUIRE(components.size() == 3);
+		requireComponent(components[0], {0, 1, 2, 3}, {0, 1, 2, 0, 2, 3});
+		requireComponent(components[1], {7, 8, 9, 10, 11, 12}, {0, 1, 2, 3, 4, 5});
+		requireComponent(components[2], {4, 5, 6}, {0, 1, 2});
+		for(auto component : components)
+			delete component;
+	}
+	// with a smaller distance, the two triangles of C are separate components
+	{
+		std::deque<Mesh *> components = MeshUtils::splitIntoConnectedComponents(mesh.get(), 0.00001f);
+		REQUIRE(components.size() == 4);
+		requireComponent(components[0], {0, 1, 2, 3}, {0, 1, 2, 0, 2, 3});
+		requireComponent(components[1], {7, 8, 9}, {0, 1, 2});
+		requireComponent(components[2], {4, 5, 6}, {0, 1, 2});
+		requireComponent(components[3], {10, 11, 12}, {0, 1, 2});
+		for(auto component : components)
+			delete component;
+	}
+}
+
+//! Linear scan over all triangles as reference for the ray queries.
+static int32_t intersectLinear(Mesh * mesh, const Geometry::Ray3 & ray) {
+	auto posAcc = PositionAttributeAccessor::create(mesh->openVertexData());
+	const MeshIndexData & indices = mesh->openIndexData();
+	float tLine, uTri, vTri;
+	int32_t closest = -1;
+	float closestDist = std::numeric_limits<float>::infinity();
+	for(uint32_t i = 0; i < indices.getIndexCount(); i += 3) {
+		const Geometry::Triangle<Geometry::Vec3> triangle(posAcc->getPosition(indices[i]), posAcc->getPosition(indices[i + 1]), posAcc->getPosition(indices[i + 2]));
+		if(Geometry::Intersection::getLineTriangleIntersection(ray, triangle, tLine, uTri, vTri) && tLine >= 0 && tLine < closestDist) {
+			closestDist = tLine;
+			closest = i / 3;
+		}
+	}
+	return closest;
+}
+
+TEST_CASE("MeshUtilsTest_rayIntersection", "[MeshUtilsTest]") {
+	std::cout << std::endl;
+	// height field with 2 * 300 * 300 triangles
+	const uint32_t size = 300;
+	VertexDescription vd;
+	vd.appendPosition3D();
+	Util::Reference<Mesh> mesh = new Mesh(vd, (size + 1) * (size + 1), 6 * size * size);
+	{
+		auto posAcc = PositionAttributeAccessor::create(mesh->openVertexData());
+		for(uint32_t y = 0; y <= size; ++y) {
+			for(uint32_t x = 0; x <= size; ++x)
+				posAcc->setPosition(y * (size + 1) + x, Geometry::Vec3(x * 0.1f, std::sin(x * 0.1f) * std::cos(y * 0.13f), y * 0.1f));
+		}
+		uint32_t * indices = mesh->openIndexData().data();
+		for(uint32_t y = 0; y < size; ++y) {
+			for(uint32_t x = 0; x < size; ++x) {
+				const uint32_t base = y * (size + 1) + x;
+				const uint32_t quad[6] = {base, base + 1, base + size + 1, base + 1, base + size + 2, base + size + 1};
+				std::copy(quad, quad + 6, indices + 6 * (y * size + x));
+			}
+		}
+		mesh->openVertexData().updateBoundingBox();
+		mesh->openIndexData().updateIndexRange();
+	}
+
+	std::default_random_engine engine(0);
+	std::uniform_real_distribution<float> coordinateDist(0.0f, size * 0.1f);
+	std::vector<Geometry::Ray3> rays;
+	for(uint32_t i = 0; i < 10000; ++i)
+		rays.emplace_back(Geometry::Vec3(coordinateDist(engine), 5.0f, coordinateDist(engine)), Geometry::Vec3(coordinateDist(engine) * 0.01f - 0.15f, -1.0f, coordinateDist(engine) * 0.01f - 0.15f));
+
+	Util::Timer t;
+	const uint32_t linearRayCount = 100;
+	std::vector<int32_t> expected;
+	for(uint32_t i = 0; i < linearRayCount; ++i)
+		expected.push_back(intersectLinear(mesh.get(), rays[i]));
+	const double linearTime = t.getSeconds();
+	std::cout << "Linear scan: " << (linearRayCount / linearTime) << " rays/s" << std::endl;
+
+	t.reset();
+	auto bvh = MeshUtils::TriangleBVH::get(mesh.get());
+	std::cout << "Building the BVH: " << t.getMilliseconds() << " ms (" << bvh->getNodes().size() << " nodes)" << std::endl;
+	REQUIRE(MeshUtils::TriangleBVH::get(mesh.get()) == bvh);
+
+	t.reset();
+	for(const auto & ray : rays)
+		MeshUtils::getFirstTriangleIntersectingRay(mesh.get(), ray);
+	std::cout << "getFirstTriangleIntersectingRay: " << (rays.size() / t.getSeconds()) << " rays/s" << std::endl;
+
+	std::vector<MeshUtils::TriangleBVH::Hit> hits(rays.size());
+	t.reset();
+	bvh->getClosestHits(rays.data(), static_cast<uint32_t>(rays.size()), hits.data());
+	std::cout << "TriangleBVH::getClosestHits: " << (rays.size() / t.getSeconds()) << " rays/s" << std::endl;
+
+	for(uint32_t i = 0; i < linearRayCount; ++i) {
+		REQUIRE(MeshUtils::getFirstTriangleIntersectingRay(mesh.get(), rays[i]) == expected[i]);
+		REQUIRE(hits[i].triangle == expected[i]);
+		REQUIRE(bvh->hasHit(rays[i]) == (expected[i] >= 0));
+	}
+
+	// a written and read hierarchy gives the same hits
+	{
+		std::stringstream stream;
+		bvh->write(stream);
+		const std::string data = stream.str();
+		auto readBVH = MeshUtils::TriangleBVH::read(stream);
+		REQUIRE(readBVH);
+		REQUIRE(readBVH->getNodes().size() == bvh->getNodes().size());
+		REQUIRE(readBVH->getTriangleCount() == bvh->getTriangleCount());
+		std::vector<MeshUtils::TriangleBVH::Hit> readHits(rays.size());
+		readBVH->getClosestHits(rays.data(), static_cast<uint32_t>(rays.size()), readHits.data());
+		for(uint32_t i = 0; i < rays.size(); ++i) {
+			REQUIRE(readHits[i].triangle == hits[i].triangle);
+			REQUIRE(readHits[i].distance == hits[i].distance);
+		}
+
+		// the read hierarchy can be attached to a copy of the mesh
+		Util::Reference<Mesh> copy = mesh->clone();
+		REQUIRE(MeshUtils::TriangleBVH::attach(copy.get(), readBVH));
+		REQUIRE(MeshUtils::TriangleBVH::get(copy.get()) == readBVH);
+		for(uint32_t i = 0; i < linearRayCount; ++i)
+			REQUIRE(MeshUtils::getFirstTriangleIntersectingRay(copy.get(), rays[i]) == expected[i]);
+
+		// truncated or foreign data is rejected
+		std::stringstream truncated(data.substr(0, data.size() - 1));
+		REQUIRE_FALSE(MeshUtils::TriangleBVH::read(truncated));
+		std::stringstream foreign(std::string(data.size(), 'x'));
+		REQUIRE_FALSE(MeshUtils::TriangleBVH::read(foreign));
+
+		// so is data with a corrupt triangle count or triangle id
+		std::string corruptCount(data);
+		const uint32_t hugeCount = 0xffffffffu;
+		std::memcpy(&corruptCount[4 + sizeof(uint32_t)], &hugeCount, sizeof(uint32_t));
+		std::stringstream corruptCountStream(corruptCount);
+		REQUIRE_FALSE(MeshUtils::TriangleBVH::read(corruptCountStream));
+		std::string corruptId(data);
+		const uint32_t invalidId = bvh->getTriangleCount();
+		std::memcpy(&corruptId[corruptId.size() - sizeof(uint32_t)], &invalidId, sizeof(uint32_t));
+		std::stringstream corruptIdStream(corruptId);
+		REQUIRE_FALSE(MeshUtils::TriangleBVH::read(corruptIdStream));
+	}
+
+	// changing the vertex data invalidates the cached hierarchy
+	mesh->openVertexData().markAsChanged();
+	REQUIRE(MeshUtils::TriangleBVH::get(mesh.get()) != bvh);
+}
+
+TEST_CASE("MeshUtilsTest_optimizeMesh", "[MeshUtilsTest]") {
+	std::cout << std::endl;
+	// sphere like grid with shuffled triangles and vertices
+	const uint32_t size = 200;
+	const uint32_t vertexCount = (size + 1) * (size + 1);
+	VertexDescription vd;
+	vd.appendPosition3D();
+	vd.appendNormalFloat();
+	Util::Reference<Mesh> mesh = new Mesh(vd, vertexCount, 6 * size * size);
+	std::default_random_engine engine(0);
+	{
+		std::vector<uint32_t> vertexOrder(vertexCount);
+		for(uint32_t i = 0; i < vertexCount; ++i)
+			vertexOrder[i] = i;
+		std::shuffle(vertexOrder.begin(), vertexOrder.end(), engine);
+		auto posAcc = PositionAttributeAccessor::create(mesh->openVertexData());
+		for(uint32_t y = 0; y <= size; ++y) {
+			for(uint32_t x = 0; x <= size; ++x) {
+				const float theta = 3.1415f * y / size;
+				const float phi = 2.0f * 3.1415f * x / size;
+				posAcc->setPosition(vertexOrder[y * (size + 1) + x], Geometry::Vec3(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi)));
+			}
+		}
+		std::vector<uint32_t> quads(size * size);
+		for(uint32_t i = 0; i < quads.size(); ++i)
+			quads[i] = i;
+		std::shuffle(quads.begin(), quads.end(), engine);
+		uint32_t * indices = mesh->openIndexData().data();
+		for(const auto q : quads) {
+			const uint32_t base = (q / size) * (size + 1) + q % size;
+			const uint32_t quad[6] = {base, base + size + 1, base + 1, base + 1, base + size + 1, base + size + 2};
+			for(const auto i : quad)
+				*indices++ = vertexOrder[i];
+		}
+		mesh->openVertexData().updateBoundingBox();
+		mesh->openIndexData().updateIndexRange();
+	}
+	auto getTriangleCenters = [](Mesh * m) {
+		auto posAcc = PositionAttributeAccessor::create(m->openVertexData());
+		const uint32_t * indices = m->openIndexData().data();
+		std::vector<std::tuple<float, float, float>> centers;
+		for(uint32_t i = 0; i < m->getIndexCount(); i += 3) {
+			const Geometry::Vec3 center = posAcc->getPosition(indices[i]) + posAcc->getPosition(indices[i + 1]) + posAcc->getPosition(indices[i + 2]);
+			centers.emplace_back(center.x(), center.y(), center.z());
+		}
+		std::sort(centers.begin(), centers.end());
+		return centers;
+	};
+	const auto centers = getTriangleCenters(mesh.get());
+
+	const MeshUtils::MeshStatistics before = MeshUtils::analyzeMesh(mesh.get());
+	Util::Timer t;
+	MeshUtils::optimizeMesh(mesh.get());
+	std::cout << "optimizeMesh: " << t.getMilliseconds() << " ms" << std::endl;
+	const MeshUtils::MeshStatistics after = MeshUtils::analyzeMesh(mesh.get());
+	std::cout << "ACMR " << before.acmr << " -> " << after.acmr << ", ATVR " << before.atvr << " -> " << after.atvr
+			<< ", fetch overhead " << before.fetchOverhead << " -> " << after.fetchOverhead << std::endl;
+	REQUIRE(before.acmr > 2.5f);
+	REQUIRE(after.acmr < 0.8f);
+	REQUIRE(after.fetchOverhead < before.fetchOverhead);
+	REQUIRE(mesh->getVertexCount() == vertexCount);
+	REQUIRE(getTriangleCenters(mesh.get()) == centers);
+}
+
+TEST_CASE("MeshUtilsTest_quantizeMesh", "[MeshUtilsTest]") {
+	VertexDescription vd;
+	vd.appendPosition3D();
+	vd.appendNormalFloat();
+	vd.appendColorRGBAFloat();
+	vd.appendTexCoord();
+	Util::Reference<Mesh> mesh = MeshUtils::createSphere(vd, Geometry::Sphere_f(Geometry::Vec3(10, 20, 30), 5), 32, 64);
+	Util::Reference<Mesh> original = mesh->clone();
+	const Geometry::Box box = mesh->getBoundingBox();
+
+	MeshUtils::QuantizationOptions options;
+	options.maxPositionError = 0.001f;
+	const MeshUtils::QuantizationReport report = MeshUtils::quantizeMesh(mesh.get(), options);
+	REQUIRE(report.oldVertexSize == 48);
+	REQUIRE(report.newVertexSize == 20);
+	REQUIRE(report.positionError <= options.maxPositionError);
+	REQUIRE(report.normalErrorDegrees <= options.maxNormalErrorDegrees);
+	REQUIRE(report.texCoordError <= options.maxTexCoordError);
+	REQUIRE(report.colorError <= options.maxColorError);
+	REQUIRE(mesh->getVertexDescription().getAttribute(VertexAttributeIds::POSITION).getDataType() == GL_UNSIGNED_SHORT);
+	REQUIRE(mesh->openVertexData().getPositionDequantization() != nullptr);
+	REQUIRE(mesh->getBoundingBox() == box);
+
+	auto oldPos = PositionAttributeAccessor::create(original->openVertexData());
+	auto newPos = PositionAttributeAccessor::create(mesh->openVertexData());
+	auto oldNormal = NormalAttributeAccessor::create(original->openVertexData());
+	auto newNormal = NormalAttributeAccessor::create(mesh->openVertexData());
+	for(uint32_t i = 0; i < mesh->getVertexCount(); ++i) {
+		REQUIRE(oldPos->getPosition(i).distance(newPos->getPosition(i)) <= options.maxPositionError);
+		REQUIRE(oldNormal->getNormal(i).dot(newNormal->getNormal(i)) > 0.9999f);
+	}
+
+	// converting back to floats applies the dequantization
+	std::unique_ptr<MeshVertexData> converted(MeshUtils::convertVertices(mesh->openVertexData(), vd));
+	REQUIRE(converted->getPositionDequantization() == nullptr);
+	auto convertedPos = PositionAttributeAccessor::create(*converted);
+	REQUIRE(convertedPos->getPosition(0).distance(oldPos->getPosition(0)) <= options.maxPositionError);
+
+	// a too small budget keeps the attribute
+	options.maxPositionError = 1.0e-6f;
+	Util::Reference<Mesh> unchanged = original->clone();
+	MeshUtils::quantizeMesh(unchanged.get(), options);
+	REQUIRE(unchanged->getVertexDescription().getAttribute(VertexAttributeIds::POSITION).getDataType() == GL_FLOAT);
+
+	// high dynamic range colors are not clamped into bytes
+	Util::Reference<Mesh> hdr = original->clone();
+	auto hdrColor = ColorAttributeAccessor::create(hdr->openVertexData());
+	hdrColor->setColor(0, Util::Color4f(4.0f, 0.5f, 0.5f, 1.0f));
+	MeshUtils::quantizeMesh(hdr.get());
+	REQUIRE(hdr->getVertexDescription().getAttribute(VertexAttributeIds::COLOR).getDataType() == GL_FLOAT);
+	REQUIRE(ColorAttributeAccessor::create(hdr->openVertexData())->getColor4f(0).getR() == 4.0f);
+
+	// MMF version 2 stores the dequantization
+	std::stringstream archive;
+	REQUIRE(Serialization::StreamerMMF::saveMeshes({{"quantized", mesh.get()}}, archive));
+	Util::Reference<Mesh> loaded = Serialization::StreamerMMF::loadMeshFromArchive(archive, "quantized");
+	REQUIRE(loaded.isNotNull());
+	REQUIRE(loaded->openVertexData().getPositionDequantization() != nullptr);
+	REQUIRE(*loaded->openVertexData().getPositionDequantization() == *mesh->openVertexData().getPositionDequantization());
+	REQUIRE(loaded->getBoundingBox().getMin().distance(box.getMin()) <= 0.001f);
+	auto loadedPos = PositionAttributeAccessor::create(loaded->openVertexData());
+	for(uint32_t i = 0; i < mesh->getVertexCount(); i += 17)
+		REQUIRE(loadedPos->getPosition(i) == newPos->getPosition(i));
+
+	// rebuilding the vertex data keeps the dequantization
+	const Geometry::Matrix4x4 dequantization = *mesh->openVertexData().getPositionDequantization();
+	Util::Reference<Mesh> optimized = mesh->clone();
+	MeshUtils::optimizeMesh(optimized.get());
+	Util::Reference<Mesh> welded = mesh->clone();
+	REQUIRE(MeshUtils::mergeCloseVertices(welded.get(), 0.0001f) > 0);
+	Util::Reference<Mesh> deduplicated = mesh->clone();
+	MeshUtils::eliminateDuplicateVertices(deduplicated.get());
+	Util::Reference<Mesh> compacted = MeshUtils::eliminateUnusedVertices(mesh.get());
+	for(Mesh * rebuilt : {optimized.get(), welded.get(), deduplicated.get(), compacted.get()}) {
+		REQUIRE(rebuilt->openVertexData().getPositionDequantization() != nullptr);
+		REQUIRE(*rebuilt->openVertexData().getPositionDequantization() == dequantization);
+		REQUIRE(rebuilt->getBoundingBox().getMin().distance(box.getMin()) <= 0.001f);
+		REQUIRE(rebuilt->getBoundingBox().getMax().distance(box.getMax()) <= 0.001f);
+	}
+	std::unique_ptr<MeshVertexData> extracted(MeshUtils::extractVertexData(mesh.get(), 17, 100));
+	REQUIRE(extracted->getPositionDequantization() != nullptr);
+	REQUIRE(PositionAttributeAccessor::create(*extracted)->getPosition(0) == newPos->getPosition(17));
+	for(auto & chunk : MeshUtils::splitVertexData(mesh.get(), 1000))
+		REQUIRE(chunk.getPositionDequantization() != nullptr);
+}
+
+//! Simplify a sphere with both simplifiers and print the triangles per second and the maximal distance to the sphere.
+static void checkSimplification(uint32_t segments, bool compareWithSimplifyMesh) {
+	VertexDescription vd;
+	vd.appendPosition3D();
+	vd.appendNormalFloat();
+	const Geometry::Sphere_f sphere(Geometry::Vec3(0, 0, 0), 1);
+	Util::Reference<Mesh> mesh = MeshUtils::createSphere(vd, sphere, segments, 2 * segments);
+	const uint32_t triangleCount = mesh->getPrimitiveCount();
+	const uint32_t target = triangleCount / 10;
+	const MeshUtils::Simplification::weights_t weights = {{1.0f, 0.1f, 0.0f, 0.0f, 1.0f}};
+
+	auto getError = [&sphere](Mesh * m) {
+		auto posAcc = PositionAttributeAccessor::create(m->openVertexData());
+		float error = 0;
+		for(uint32_t i = 0; i < m->getVertexCount(); ++i)
+			error = std::max(error, std::abs(posAcc->getPosition(i).distance(sphere.getCenter()) - sphere.getRadius()));
+		return error;
+	};
+	auto run = [&](const std::string & name, const std::function<Mesh*()> & simplify) {
+		Util::Timer t;
+		Util::Reference<Mesh> result = simplify();
+		const double seconds = t.getSeconds();
+		REQUIRE(result.isNotNull());
+		const float error = getError(result.get());
+		std::cout << name << ": " << triangleCount << " -> " << result->getPrimitiveCount() << " triangles, "
+				<< (triangleCount - result->getPrimitiveCount()) / seconds << " triangles/s, error " << error << std::endl;
+		REQUIRE(result->getPrimitiveCount() <= target);
+		REQUIRE(result->getPrimitiveCount() > target * 0.9);
+		REQUIRE(error < 0.01f);
+	};
+	run("simplifyMeshParallel", [&]() { return MeshUtils::Simplification::simplifyMeshParallel(mesh.get(), target, true, -1.0f, weights); });
+	run("simplifyMeshParallel (1 partition)", [&]() { return MeshUtils::Simplification::simplifyMeshParallel(mesh.get(), target, true, -1.0f, weights, 1); });
+	if(compareWithSimplifyMesh)
+		run("simplifyMesh", [&]() { return MeshUtils::Simplification::simplifyMesh(mesh.get(), target, 0.0f, true, -1.0f, weights); });
+}
+
+TEST_CASE("MeshUtilsTest_simplifyMeshParallel", "[MeshUtilsTest]") {
+	std::cout << std::endl;
+	checkSimplification(128, false);
+}
+
+/*! Grid of size x size quads on [0,1]^2 in the x-y-plane with heights @p height(x, y). The colors and the
+	first texture coordinate jump from 0 to 1 between x = 0.5 and the next column of vertices. */
+static Util::Reference<Mesh> createSteppedGrid(uint32_t size, const std::function<float(float, float)> & height) {
+	VertexDescription vd;
+	vd.appendPosition3D();
+	vd.appendColorRGBAFloat();
+	vd.appendTexCoord();
+	Util::Reference<Mesh> mesh = new Mesh(vd, (size + 1) * (size + 1), 6 * size * size);
+	auto posAcc = PositionAttributeAccessor::create(mesh->openVertexData());
+	auto colorAcc = ColorAttributeAccessor::create(mesh->openVertexData());
+	auto texCoordAcc = TexCoordAttributeAccessor::create(mesh->openVertexData());
+	MeshIndexData & indices = mesh->openIndexData();
+	uint32_t index = 0;
+	for(uint32_t y = 0; y <= size; ++y) {
+		for(uint32_t x = 0; x <= size; ++x) {
+			const uint32_t v = y * (size + 1) + x;
+			const float fx = static_cast<float>(x) / size;
+			const float fy = static_cast<float>(y) / size;
+			const float step = 2 * x > size ? 1.0f : 0.0f;
+			posAcc->setPosition(v, Geometry::Vec3(fx, fy, height(fx, fy)));
+			colorAcc->setColor(v, Util::Color4f(step, 0.0f, 1.0f - step, 1.0f));
+			texCoordAcc->setCoordinate(v, Geometry::Vec2(step, fy));
+			if(x < size && y < size) {
+				for(const uint32_t corner : {v, v + 1, v + size + 2, v, v + size + 2, v + size + 1})
+					indices[index++] = corner;
+			}
+		}
+	}
+	indices.updateIndexRange();
+	mesh->openVertexData().updateBoundingBox();
+	return mesh;
+}
+
+//! Sum of the areas of the triangles projected into the x-y-plane; negative for triangles facing -z.
+static float getProjectedArea(Mesh * mesh, float & minArea) {
+	auto posAcc = PositionAttributeAccessor::create(mesh->openVertexData());
+	const MeshIndexData & indices = mesh->openIndexData();
+	float area = 0.0f;
+	minArea = std::numeric_limits<float>::max();
+	for(uint32_t i = 0; i + 2 < indices.getIndexCount(); i += 3) {
+		const Geometry::Vec3 a = posAcc->getPosition(indices[i]);
+		const Geometry::Vec3 b = posAcc->getPosition(indices[i + 1]);
+		const Geometry::Vec3 c = posAcc->getPosition(indices[i + 2]);
+		const float triangleArea = 0.5f * (b - a).cross(c - a).getZ();
+		area += triangleArea;
+		minArea = std::min(minArea, triangleArea);
+	}
+	return area;
+}
+
+TEST_CASE("MeshUtilsTest_simplifyMeshParallelWeights", "[MeshUtilsTest]") {
+	using MeshUtils::Simplification::weights_t;
+	using MeshUtils::Simplification::simplifyMeshParallel;
+	const uint32_t size = 40;
+	Util::Reference<Mesh> grid = createSteppedGrid(size, [](float, float) { return 0.0f; });
+	const uint32_t target = grid->getPrimitiveCount() / 10;
+	float minArea;
+
+	// the boundary of an open mesh is preserved if the boundary weight is not zero (the maximal angle prevents fold-overs)
+	{
+		Util::Reference<Mesh> result = simplifyMeshParallel(grid.get(), target, true, 0.0f, weights_t{{1.0f, 0.0f, 0.0f, 0.0f, 1.0f}});
+		REQUIRE(result.isNotNull());
+		REQUIRE(result->getPrimitiveCount() <= target);
+		REQUIRE(std::abs(getProjectedArea(result.get(), minArea) - 1.0f) < 1.0e-4f);
+		REQUIRE(minArea >= 0.0f);
+		REQUIRE(result->getBoundingBox().getMin().distance(grid->getBoundingBox().getMin()) < 1.0e-4f);
+		REQUIRE(result->getBoundingBox().getMax().distance(grid->getBoundingBox().getMax()) < 1.0e-4f);
+	}
+
+	// a weighted color or texture coordinate keeps the vertices on their side of the jump between x = 0.5 and the next column
+	for(const int attribute : {MeshUtils::Simplification::COLOR_OFFSET, MeshUtils::Simplification::TEX0_OFFSET}) {
+		CAPTURE(attribute);
+		weights_t weights{{1.0f, 0.0f, 0.0f, 0.0f, 1.0f}};
+		weights[attribute] = 1.0f;
+		Util::Reference<Mesh> result = simplifyMeshParallel(grid.get(), target, true, -1.0f, weights);
+		REQUIRE(result.isNotNull());
+		REQUIRE(result->getPrimitiveCount() <= target);
+		auto posAcc = PositionAttributeAccessor::create(result->openVertexData());
+		auto colorAcc = ColorAttributeAccessor::create(result->openVertexData());
+		auto texCoordAcc = TexCoordAttributeAccessor::create(result->openVertexData());
+		const MeshIndexData & indices = result->openIndexData();
+		for(uint32_t i = 0; i < indices.getIndexCount(); ++i) {
+			const float x = posAcc->getPosition(indices[i]).getX();
+			const float step = attribute == MeshUtils::Simplification::COLOR_OFFSET ? colorAcc->getColor4f(indices[i]).getR()
+																						: texCoordAcc->getCoordinate(indices[i]).getX();
+			if(step < 0.5f) {
+				REQUIRE(step < 0.001f);
+				REQUIRE(x < 0.5f + 1.0e-4f);
+			} else {
+				REQUIRE(step > 0.999f);
+				REQUIRE(x > 0.5f + 1.0f / size - 1.0e-4f);
+			}
+		}
+	}
+
+	// collapses that rotate a triangle by more than the maximal angle are rejected
+	Util::Reference<Mesh> hill = createSteppedGrid(size, [](float x, float y) {
+		return 0.3f * std::sin(static_cast<float>(M_PI) * x) * std::sin(static_cast<float>(M_PI) * y);
+	});
+	const weights_t weights{{1.0f, 0.0f, 0.0f, 0.0f, 1.0f}};
+	Util::Reference<Mesh> unrestricted = simplifyMeshParallel(hill.get(), target, true, -1.0f, weights);
+	Util::Reference<Mesh> restricted = simplifyMeshParallel(hill.get(), target, true, std::cos(1.0f * static_cast<float>(M_PI) / 180.0f), weights);
+	REQUIRE(unrestricted->getPrimitiveCount() <= target);
+	REQUIRE(restricted->getPrimitiveCount() > 2 * target);
+	Util::Reference<Mesh> moderate = simplifyMeshParallel(hill.get(), target, true, std::cos(30.0f * static_cast<float>(M_PI) / 180.0f), weights);
+	getProjectedArea(moderate.get(), minArea);
+	REQUIRE(minArea > 0.0f);
+}
+
+TEST_CASE("MeshUtilsTest_simplifyMeshBenchmark", "[.][MeshUtilsTest]") {
+	std::cout << std::endl;
+	checkSimplification(64, true);
+	checkSimplification(512, true); // 1M triangles
+}
+
+TEST_CASE("MeshUtilsTest_LODChain", "[MeshUtilsTest]") {
+	VertexDescription vd;
+	vd.appendPosition3D();
+	vd.appendNormalFloat();
+	Util::Reference<Mesh> mesh = MeshUtils::createSphere(vd, Geometry::Sphere_f(Geometry::Vec3(0, 0, 0), 1), 64, 128);
+	MeshUtils::LODChainOptions options;
+	options.levelCount = 4;
+	options.weights = {{1.0f, 1.0f, 0.0f, 0.0f, 1.0f}};
+	const std::vector<MeshUtils::LODLevel> levels = MeshUtils::buildLODChain(mesh.get(), options);
+	REQUIRE(levels.size() == 4);
+	REQUIRE(levels.front().mesh.get() == mesh.get());
+	REQUIRE(levels.front().error == 0.0f);
+	for(size_t l = 1; l < levels.size(); ++l) {
+		REQUIRE(levels[l].mesh->getPrimitiveCount() <= levels[l - 1].mesh->getPrimitiveCount() / 2);
+		REQUIRE(levels[l].error >= levels[l - 1].error);
+	}
+
+	const MeshUtils::PackedLODMesh packed = MeshUtils::packLODChain(levels);
+	REQUIRE(packed.mesh.isNotNull());
+	REQUIRE(packed.levels.size() == levels.size());
+	uint32_t separateVertexCount = 0;
+	for(size_t l = 0; l < levels.size(); ++l) {
+		const MeshUtils::LODRange & range = packed.levels[l];
+		REQUIRE(range.elementCount == levels[l].mesh->getIndexCount());
+		REQUIRE(range.error == levels[l].error);
+		// every level only references a prefix of the shared vertices
+		const uint32_t * indices = packed.mesh->openIndexData().data() + range.firstElement;
+		REQUIRE(*std::max_element(indices, indices + range.elementCount) < range.vertexCount);
+		separateVertexCount += levels[l].mesh->getVertexCount();
+	}
+	REQUIRE(packed.levels.back().firstElement + packed.levels.back().elementCount == packed.mesh->getIndexCount());
+	REQUIRE(packed.mesh->getVertexCount() < separateVertexCount);
+
+	// the vertices not changed by the simplification stay bit-identical and are shared with the previous level
+	const auto getVertices = [](Mesh * m, size_t size) {
+		const MeshVertexData & vertexData = m->openVertexData();
+		std::set<std::string> vertices;
+		for(uint32_t v = 0; v < vertexData.getVertexCount(); ++v)
+			vertices.emplace(reinterpret_cast<const char *>(vertexData[v]), size);
+		return vertices;
+	};
+	const size_t vertexSize = vd.getVertexSize();
+	const size_t positionSize = 3 * sizeof(float); // the position is the first attribute
+	std::set<std::string> allVertices = getVertices(levels.front().mesh.get(), vertexSize);
+	size_t uniqueVertexCount = allVertices.size();
+	for(size_t l = 1; l < levels.size(); ++l) {
+		const std::set<std::string> vertices = getVertices(levels[l].mesh.get(), vertexSize);
+		const std::set<std::string> previousVertices = getVertices(levels[l - 1].mesh.get(), vertexSize);
+		const std::set<std::string> positions = getVertices(levels[l].mesh.get(), positionSize);
+		const std::set<std::string> previousPositions = getVertices(levels[l - 1].mesh.get(), positionSize);
+		size_t sharedCount = 0;
+		for(const auto & vertex : vertices)
+			sharedCount += previousVertices.count(vertex);
+		size_t keptPositionCount = 0;
+		for(const auto & position : positions)
+			keptPositionCount += previousPositions.count(position);
+		REQUIRE(sharedCount > 0);
+		REQUIRE(sharedCount == keptPositionCount);
+		uniqueVertexCount += vertices.size() - sharedCount;
+		allVertices.insert(vertices.begin(), vertices.end());
+	}
+	// packing stores each of them once
+	REQUIRE(allVertices.size() == uniqueVertexCount);
+	REQUIRE(packed.mesh->getVertexCount() == uniqueVertexCount);
+	REQUIRE(packed.selectLevel(0.0f) == 0);
+	REQUIRE(packed.selectLevel(1.0f) == levels.size() - 1);
+}
+
+TEST_CASE("MeshUtilsTest_meshClusters", "[MeshUtilsTest]") {
+	VertexDescription vd;
+	vd.appendPosition3D();
+	Util::Reference<Mesh> mesh = MeshUtils::createSphere(vd, Geometry::Sphere_f(Geometry::Vec3(0, 0, 0), 0.5f), 64, 128);
+	const uint32_t indexCount = mesh->getIndexCount();
+	std::vector<std::tuple<uint32_t, uint32_t, uint32_t>> trianglesBefore;
+	{
+		const uint32_t * indices = mesh->openIndexData().data();
+		for(uint32_t i = 0; i < indexCount; i += 3)
+			trianglesBefore.emplace_back(indices[i], indices[i + 1], indices[i + 2]);
+	}
+	REQUIRE(MeshUtils::MeshClusters::get(mesh.get()) == nullptr);
+	const auto clusters = MeshUtils::MeshClusters::build(mesh.get(), 64, 124);
+	REQUIRE(clusters != nullptr);
+	REQUIRE(MeshUtils::MeshClusters::get(mesh.get()) == clusters);
+
+	// the triangles are only reordered
+	std::vector<std::tuple<uint32_t, uint32_t, uint32_t>> trianglesAfter;
+	const uint32_t * indices = mesh->openIndexData().data();
+	for(uint32_t i = 0; i < indexCount; i += 3)
+		trianglesAfter.emplace_back(indices[i], indices[i + 1], indices[i + 2]);
+	std::sort(trianglesBefore.begin(), trianglesBefore.end());
+	std::sort(trianglesAfter.begin(), trianglesAfter.end());
+	REQUIRE(trianglesBefore == trianglesAfter);
+
+	auto posAcc = PositionAttributeAccessor::create(mesh->openVertexData());
+	uint32_t nextElement = 0;
+	for(const auto & cluster : clusters->getClusters()) {
+		REQUIRE(cluster.firstElement == nextElement);
+		nextElement += cluster.elementCount;
+		REQUIRE(cluster.elementCount <= 3 * 124);
+		REQUIRE(cluster.vertexCount <= 64);
+		std::vector<uint32_t> vertices(indices + cluster.firstElement, indices + cluster.firstElement + cluster.elementCount);
+		std::sort(vertices.begin(), vertices.end());
+		REQUIRE(static_cast<uint32_t>(std::unique(vertices.begin(), vertices.end()) - vertices.begin()) == cluster.vertexCount);
+		const Geometry::Vec3 center(cluster.center[0], cluster.center[1], cluster.center[2]);
+		for(const auto & v : vertices) {
+			const Geometry::Vec3 pos = posAcc->getPosition(v);
+			REQUIRE(pos.distance(center) <= cluster.radius + 1.0e-5f);
+			for(uint_fast8_t axis = 0; axis < 3; ++axis) {
+				REQUIRE(pos[axis] >= cluster.min[axis]);
+				REQUIRE(pos[axis] <= cluster.max[axis]);
+			}
+		}
+	}
+	REQUIRE(nextElement == indexCount);
+
+	// the whole mesh is inside of the unit clip space cube
+	std::vector<MeshUtils::MeshClusters::Range> ranges;
+	Geometry::Matrix4x4 viewProjection;
+	REQUIRE(clusters->cull(viewProjection, Geometry::Vec3(0, 0, 10), false, ranges) == clusters->getClusters().size());
+	REQUIRE(ranges.size() == 1);
+	REQUIRE(ranges.front().firstElement == 0);
+	REQUIRE(ranges.front().elementCount == indexCount);
+
+	// back-face culling only skips clusters whose triangles all face away
+	const Geometry::Vec3 camera(0, 0, 10);
+	ranges.clear();
+	const uint32_t frontCount = clusters->cull(viewProjection, camera, true, ranges);
+	REQUIRE(frontCount > 0);
+	REQUIRE(frontCount < clusters->getClusters().size());
+	std::vector<bool> drawn(indexCount / 3, false);
+	for(const auto & range : ranges)
+		std::fill(drawn.begin() + range.firstElement / 3, drawn.begin() + (range.firstElement + range.elementCount) / 3, true);
+	for(uint32_t t = 0; t < indexCount / 3; ++t) {
+		if(drawn[t])
+			continue;
+		const Geometry::Vec3 a = posAcc->getPosition(indices[3 * t]);
+		const Geometry::Vec3 normal = (posAcc->getPosition(indices[3 * t + 1]) - a).cross(posAcc->getPosition(indices[3 * t + 2]) - a);
+		REQUIRE(normal.dot(a - camera) >= 0.0f);
+	}
+
+	// moved out of the view
+	viewProjection.translate(Geometry::Vec3(10, 0, 0));
+	ranges.clear();
+	REQUIRE(clusters->cull(viewProjection, camera, false, ranges) == 0);
+	REQUIRE(ranges.empty());
+
+	mesh->openIndexData().markAsChanged();
+	REQUIRE(MeshUtils::MeshClusters::get(mesh.get()) == nullptr);
+}
+
+TEST_CASE("MeshUtilsTest_meshClustersBenchmark", "[.][MeshUtilsTest]") {
+	std::cout << std::endl;
+	VertexDescription vd;
+	vd.appendPosition3D();
+	Util::Reference<Mesh> mesh = MeshUtils::createSphere(vd, Geometry::Sphere_f(Geometry::Vec3(0, 0, 0), 0.5f), 1024, 2048);
+	Util::Timer timer;
+	const auto clusters = MeshUtils::MeshClusters::build(mesh.get());
+	timer.stop();
+	REQUIRE(clusters != nullptr);
+	std::cout << "build " << clusters->getClusters().size() << " clusters from " << mesh->getPrimitiveCount() << " triangles: " << timer.getMilliseconds() << " ms" << std::endl;
+
+	const uint32_t runs = 100;
+	std::vector<MeshUtils::MeshClusters::Range> ranges;
+	uint32_t visible = 0;
+	Geometry::Matrix4x4 viewProjection;
+	viewProjection.translate(Geometry::Vec3(0.5f, 0, 0));
+	timer.reset();
+	for(uint32_t r = 0; r < runs; ++r) {
+		ranges.clear();
+		visible = clusters->cull(viewProjection, Geometry::Vec3(0, 0, 10), true, ranges);
+	}
+	timer.stop();
+	std::cout << "cull: " << visible << " visible clusters in " << ranges.size() << " ranges, "
+			  << (runs * clusters->getClusters().size() / timer.getSeconds()) << " clusters/s" << std::endl;
+}
+
+//! Return true if every edge of the triangle mesh is shared by exactly two triangles.
+static bool isClosedSurface(Mesh * mesh) {
+	std::map<std::pair<uint32_t, uint32_t>, uint32_t> edgeCounts;
+	const MeshIndexData & indices = mesh->openIndexData();
+	for(uint32_t i = 0; i < indices.getIndexCount(); i += 3) {
+		for(uint32_t k = 0; k < 3; ++k) {
+			const uint32_t a = indices[i + k];
+			const uint32_t b = indices[i + (k + 1) % 3];
+			if(a != b)
+				++edgeCounts[std::make_pair(std::min(a, b), std::max(a, b))];
+		}
+	}
+	return std::all_of(edgeCounts.begin(), edgeCounts.end(), [](const std::pair<const std::pair<uint32_t, uint32_t>, uint32_t> & edge) { return edge.second == 2; });
+}
+
+TEST_CASE("MeshUtilsTest_marchingCubes", "[MeshUtilsTest]") {
+	using namespace MeshUtils::MarchingCubesMeshBuilder;
+	// sphere with a radius of 24 samples in a grid of 4x4x4 chunks
+	const uint32_t resolution = 4 * ChunkedDataSet::CHUNK_SIZE;
+	const float center = (resolution - 1) * 0.5f;
+	auto density = [&](uint32_t x, uint32_t y, uint32_t z) {
+		const Geometry::Vec3 pos(x - center, y - center, z - center);
+		return 1.0f - pos.length() / 48.0f;
+	};
+	DataSet data(resolution, resolution, resolution, false);
+	REQUIRE(data.occlusion.empty());
+	ChunkedDataSet chunkedData(resolution, resolution, resolution);
+	for(uint32_t z = 0; z < resolution; ++z) {
+		for(uint32_t y = 0; y < resolution; ++y) {
+			for(uint32_t x = 0; x < resolution; ++x) {
+				const float value = density(x, y, z);
+				data.density[(z * resolution + y) * resolution + x] = value;
+				// only store values near the surface
+				chunkedData.setDensity(x, y, z, std::abs(value - 0.5f) < 0.05f ? value : (value > 0.5f ? 1.0f : 0.0f));
+			}
+		}
+	}
+	Util::Reference<Mesh> mesh = createMesh(data);
+	REQUIRE(mesh.isNotNull());
+	REQUIRE(mesh->isUsingIndexData());
+	REQUIRE(mesh->getVertexCount() < mesh->getIndexCount() / 3);
+	REQUIRE(isClosedSurface(mesh.get()));
+
+	Util::Reference<Mesh> chunkedMesh = createMesh(chunkedData);
+	REQUIRE(chunkedMesh.isNotNull());
+	REQUIRE(chunkedMesh->getVertexCount() == mesh->getVertexCount());
+	REQUIRE(chunkedMesh->getIndexCount() == mesh->getIndexCount());
+	REQUIRE(isClosedSurface(chunkedMesh.get()));
+	// only the inner chunks intersect the sphere
+	REQUIRE(chunkedData.getAllocatedChunkCount() <= 8);
+
+	chunkedData.isolevel = 2.0f;
+	REQUIRE(createMesh(chunkedData) == nullptr);
+}
+
+TEST_CASE("MeshUtilsTest_calculateNormals", "[MeshUtilsTest]") {
+	VertexDescription vd;
+	vd.appendPosition3D();
+	vd.appendNormalFloat();
+	Util::Reference<Mesh> mesh = MeshUtils::createSphere(vd, Geometry::Sphere_f(Geometry::Vec3(0, 0, 0), 1), 64, 128);
+	const uint32_t vertexCount = mesh->getVertexCount();
+	// randomly displace the vertices
+	std::default_random_engine engine(0);
+	std::uniform_real_distribution<float> offsetDist(-0.01f, 0.01f);
+	auto posAcc = PositionAttributeAccessor::create(mesh->openVertexData());
+	for(uint32_t v = 0; v < vertexCount; ++v)
+		posAcc->setPosition(v, posAcc->getPosition(v) + Geometry::Vec3(offsetDist(engine), offsetDist(engine), offsetDist(engine)));
+
+	// sequential reference: average of the normalized face normals
+	std::vector<Geometry::Vec3> expected(vertexCount);
+	const MeshIndexData & indices = mesh->openIndexData();
+	for(uint32_t i = 0; i < indices.getIndexCount(); i += 3) {
+		const Geometry::Vec3 a = posAcc->getPosition(indices[i]);
+		const Geometry::Vec3 b = posAcc->getPosition(indices[i + 1]);
+		const Geometry::Vec3 c = posAcc->getPosition(indices[i + 2]);
+		Geometry::Vec3 n = (c - b).cross(a - b);
+		if(n.length() > 0)
+			n.normalize();
+		for(uint32_t k = 0; k < 3; ++k)
+			expected[indices[i + k]] += n;
+	}
+	auto normalsEqual = [&](Mesh * m, const std::vector<Geometry::Vec3> & normals, float tolerance) {
+		auto normalAcc = NormalAttributeAccessor::create(m->openVertexData());
+		for(uint32_t v = 0; v < vertexCount; ++v) {
+			const Geometry::Vec3 n = normals[v].length() > 0 ? normals[v].getNormalized() : normals[v];
+			if(normalAcc->getNormal(v).distance(n) > tolerance)
+				return false;
+		}
+		return true;
+	};
+	MeshUtils::calculateNormals(mesh.get());
+	REQUIRE(normalsEqual(mesh.get(), expected, 1.0e-5f));
+
+	const MeshUtils::TriangleAdjacency adjacency(mesh.get());
+	REQUIRE(adjacency.isValid(mesh.get()));
+	for(auto weighting : {MeshUtils::NormalWeighting::AREA, MeshUtils::NormalWeighting::ANGLE}) {
+		// weighted normals differ slightly from the uniform ones
+		MeshUtils::calculateNormals(mesh.get(), weighting, &adjacency);
+		REQUIRE(!normalsEqual(mesh.get(), expected, 1.0e-5f));
+		REQUIRE(normalsEqual(mesh.get(), expected, 0.1f));
+
+		// incremental update after moving some vertices
+		std::vector<uint32_t> dirtyVertices;
+		for(uint32_t v = 0; v < vertexCount; v += 97) {
+			posAcc->setPosition(v, posAcc->getPosition(v) * 1.05f);
+			dirtyVertices.push_back(v);
+		}
+		MeshUtils::updateNormals(mesh.get(), dirtyVertices, weighting, adjacency);
+		std::vector<Geometry::Vec3> updated(vertexCount);
+		{
+			auto normalAcc = NormalAttributeAccessor::create(mesh->openVertexData());
+			for(uint32_t v = 0; v < vertexCount; ++v)
+				updated[v] = normalAcc->getNormal(v);
+		}
+		MeshUtils::calculateNormals(mesh.get(), weighting, &adjacency);
+		REQUIRE(normalsEqual(mesh.get(), updated, 1.0e-6f));
+	}
+
+	mesh->openIndexData().markAsChanged();
+	REQUIRE(!adjacency.isValid(mesh.get()));
+}
+
+TEST_CASE("MeshUtilsTest_combineMeshes", "[MeshUtilsTest]") {
+	VertexDescription vdPosNormal;
+	vdPosNormal.appendPosition3D();
+	vdPosNormal.appendNormalFloat();
+	VertexDescription vdPosColor;
+	vdPosColor.appendPosition3D();
+	vdPosColor.appendColorRGBAByte();
+	std::deque<Mesh *> meshes;
+	std::deque<Geometry::Matrix4x4> transformations;
+	std::vector<Util::Reference<Mesh>> sources;
+	for(uint32_t i = 0; i < 100; ++i) {
+		sources.emplace_back(MeshUtils::createSphere(i % 2 == 0 ? vdPosNormal : vdPosColor, Geometry::Sphere_f(Geometry::Vec3(0, 0, 0), 1), 8 + i % 5, 16));
+		meshes.push_back(sources.back().get());
+		Geometry::Matrix4x4 transformation;
+		transformation.translate(Geometry::Vec3(static_cast<float>(i), 0, 0));
+		transformations.push_back(transformation);
+	}
+	meshes.push_back(nullptr);
+
+	std::vector<MeshUtils::SubmeshRange> ranges;
+	Util::Reference<Mesh> combined = MeshUtils::combineMeshes(meshes, transformations, &ranges);
+	REQUIRE(combined.isNotNull());
+	REQUIRE(ranges.size() == meshes.size());
+	REQUIRE(ranges.back().vertexCount == 0);
+	REQUIRE(ranges.back().elementCount == 0);
+	const VertexDescription & vd = combined->getVertexDescription();
+	REQUIRE(vd.hasAttribute(VertexAttributeIds::POSITION));
+	REQUIRE(vd.hasAttribute(VertexAttributeIds::NORMAL));
+	REQUIRE(vd.hasAttribute(VertexAttributeIds::COLOR));
+
+	auto posAcc = PositionAttributeAccessor::create(combined->openVertexData());
+	const MeshIndexData & indices = combined->openIndexData();
+	uint32_t vertexCount = 0, indexCount = 0;
+	for(uint32_t i = 0; i < sources.size(); ++i) {
+		const MeshUtils::SubmeshRange & range = ranges[i];
+		Mesh * source = sources[i].get();
+		REQUIRE(range.firstVertex == vertexCount);
+		REQUIRE(range.firstElement == indexCount);
+		REQUIRE(range.vertexCount == source->getVertexCount());
+		REQUIRE(range.elementCount == source->getIndexCount());
+		vertexCount += range.vertexCount;
+		indexCount += range.elementCount;
+		auto sourcePosAcc = PositionAttributeAccessor::create(source->openVertexData());
+		for(uint32_t v = 0; v < range.vertexCount; ++v)
+			REQUIRE(posAcc->getPosition(range.firstVertex + v).distance(sourcePosAcc->getPosition(v) + Geometry::Vec3(static_cast<float>(i), 0, 0)) < 1.0e-5f);
+		const MeshIndexData & sourceIndices = source->openIndexData();
+		for(uint32_t j = 0; j < range.elementCount; ++j)
+			REQUIRE(indices[range.firstElement + j] == sourceIndices[j] + range.firstVertex);
+	}
+	REQUIRE(combined->getVertexCount() == vertexCount);
+	REQUIRE(combined->getIndexCount() == indexCount);
+}
+
+TEST_CASE("MeshUtilsTest_transform", "[MeshUtilsTest]") {
+	Geometry::Matrix4x4 transformation;
+	transformation.translate(Geometry::Vec3(1, 2, 3));
+	transformation.rotate_deg(30.0f, 0.0f, 1.0f, 0.0f);
+	VertexDescription vdFloat;
+	vdFloat.appendPosition3D();
+	vdFloat.appendNormalFloat();
+	VertexDescription vdCompressed;
+	vdCompressed.appendPosition4DHalf();
+	vdCompressed.appendNormalByte();
+	for(const VertexDescription * vd : {&vdFloat, &vdCompressed}) {
+		const float epsilon = vd == &vdFloat ? 1.0e-5f : 2.0e-2f;
+		// more vertices than transformed by a single thread
+		Util::Reference<Mesh> mesh = MeshUtils::createSphere(*vd, Geometry::Sphere_f(Geometry::Vec3(0, 0, 0), 1), 256, 512);
+		Util::Reference<Mesh> expected = mesh->clone();
+		MeshVertexData & expectedData = expected->openVertexData();
+		auto expectedPosAcc = PositionAttributeAccessor::create(expectedData);
+		auto expectedNormalAcc = NormalAttributeAccessor::create(expectedData);
+		for(uint32_t i = 0; i < expectedData.getVertexCount(); ++i) {
+			expectedPosAcc->setPosition(i, transformation.transformPosition(expectedPosAcc->getPosition(i)));
+			expectedNormalAcc->setNormal(i, (transformation * Geometry::Vec4(expectedNormalAcc->getNormal(i), 0)).xyz());
+		}
+
+		MeshUtils::transform(mesh->openVertexData(), transformation);
+		auto posAcc = PositionAttributeAccessor::create(mesh->openVertexData());
+		auto normalAcc = NormalAttributeAccessor::create(mesh->openVertexData());
+		for(uint32_t i = 0; i < mesh->getVertexCount(); ++i) {
+			REQUIRE(posAcc->getPosition(i).distance(expectedPosAcc->getPosition(i)) < epsilon);
+			REQUIRE(normalAcc->getNormal(i).distance(expectedNormalAcc->getNormal(i)) < epsilon);
+		}
+	}
+}
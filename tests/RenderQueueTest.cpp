@@ -0,0 +1,158 @@
+/*
+ This file is part of the Rendering library.
+ Copyright (C) 2026 agent <agent@local>
+
+ This library is subject to the terms of the Mozilla Public License, v. 2.0.
+ You should have received a copy of the MPL along with this library; see the
+ file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <catch2/catch.hpp>
+#include <Rendering/Mesh/Mesh.h>
+#include <Rendering/Mesh/VertexDescription.h>
+#include <Rendering/RenderingContext/RenderQueue.h>
+#include <Rendering/Shader/Shader.h>
+#include <Rendering/Shader/Uniform.h>
+#include <Rendering/Texture/Texture.h>
+#include <Rendering/Texture/TextureUtils.h>
+
+#include <Geometry/Matrix4x4.h>
+#include <Geometry/Vec3.h>
+#include <Util/Timer.h>
+#include <Util/References.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+using namespace Rendering;
+
+//! Records the commands of a RenderQueue instead of calling OpenGL.
+class RecordingBackend : public RenderQueue::Backend {
+	public:
+		uint32_t stateChanges = 0;
+		uint32_t drawCalls = 0;
+		uint32_t drawnItems = 0;
+		bool instancing = false;
+		Shader * shader = nullptr;
+		std::vector<Texture *> textures;
+		//! First value of the uniform "color" of every shader (initially 0)
+		std::unordered_map<Shader *, float> colors;
+		//! Shader, texture of unit 0 and color of every drawn item
+		std::vector<std::tuple<Shader *, Texture *, float>> drawnStates;
+
+		void setShader(Shader * _shader) override					{	shader = _shader;	++stateChanges;	}
+		void setTexture(uint8_t unit, Texture * texture) override {
+			if(unit >= textures.size())
+				textures.resize(unit + 1, nullptr);
+			textures[unit] = texture;
+			++stateChanges;
+		}
+		void setBlending(const BlendingParameters &) override			{	++stateChanges;	}
+		void setDepthBuffer(const DepthBufferParameters &) override		{	++stateChanges;	}
+		void setCullFace(const CullFaceParameters &) override			{	++stateChanges;	}
+		void setUniform(Shader * _shader, const Uniform & uniform) override {
+			colors[_shader] = *reinterpret_cast<const float *>(uniform.getData());
+			++stateChanges;
+		}
+		Uniform getUniform(Shader * _shader, Util::StringIdentifier name) override {
+			return Uniform(name, Geometry::Vec3(colors[_shader], 0, 0));
+		}
+		void draw(Mesh *, uint32_t, uint32_t, const Geometry::Matrix4x4 &) override {
+			++drawCalls;
+			++drawnItems;
+			drawnStates.emplace_back(shader, textures.empty() ? nullptr : textures[0], colors[shader]);
+		}
+		bool canDrawInstances(Shader *) override						{	return instancing;	}
+		void drawInstances(Mesh *, uint32_t, uint32_t, const std::vector<Geometry::Matrix4x4> & matrices) override {
+			++drawCalls;
+			drawnItems += static_cast<uint32_t>(matrices.size());
+			drawnStates.insert(drawnStates.end(), matrices.size(), std::make_tuple(shader, textures.empty() ? nullptr : textures[0], colors[shader]));
+		}
+};
+
+TEST_CASE("RenderQueueTest_sortAndMerge", "[RenderQueueTest]") {
+	std::vector<Util::Reference<Shader>> shaders;
+	for(uint32_t i = 0; i < 4; ++i)
+		shaders.emplace_back(Shader::createShader());
+	std::vector<Util::Reference<Texture>> textures;
+	for(uint32_t i = 0; i < 8; ++i)
+		textures.emplace_back(TextureUtils::createStdTexture(4, 4, false));
+	VertexDescription vd;
+	vd.appendPosition3D();
+	std::vector<Util::Reference<Mesh>> meshes;
+	for(uint32_t i = 0; i < 16; ++i)
+		meshes.emplace_back(new Mesh(vd, 3, 3));
+
+	RenderQueue queue;
+	std::vector<uint32_t> stateIds;
+	for(uint32_t s = 0; s < shaders.size(); ++s) {
+		for(uint32_t t = 0; t < textures.size(); ++t) {
+			RenderQueue::State state(shaders[s].get(), {textures[t].get()});
+			if(t % 2 == 0)
+				state.blending.enable();
+			stateIds.push_back(queue.addState(state));
+		}
+	}
+	REQUIRE(queue.addState(queue.getState(stateIds[5])) == stateIds[5]);
+
+	std::default_random_engine engine(0);
+	std::uniform_int_distribution<size_t> stateDist(0, stateIds.size() - 1);
+	std::uniform_int_distribution<size_t> meshDist(0, meshes.size() - 1);
+	const uint32_t itemCount = 10000;
+	for(uint32_t i = 0; i < itemCount; ++i) {
+		Geometry::Matrix4x4 matrix;
+		matrix.translate(Geometry::Vec3(static_cast<float>(i), 0, 0));
+		const uint32_t stateId = stateIds[stateDist(engine)];
+		if(i % 100 == 0)
+			queue.add(stateId, meshes[meshDist(engine)].get(), matrix, {Uniform("color", Geometry::Vec3(static_cast<float>(i + 1), 0, 0))});
+		else
+			queue.add(stateId, meshes[meshDist(engine)].get(), matrix);
+	}
+	REQUIRE(queue.size() == itemCount);
+
+	// submission order
+	Util::Timer timer;
+	RecordingBackend unsortedBackend;
+	const RenderQueue::Statistics unsorted = queue.execute(unsortedBackend);
+	std::cout << "RenderQueue (unsorted): " << unsortedBackend.stateChanges << " state changes, " << unsortedBackend.drawCalls << " draw calls; "
+			  << timer.getMilliseconds() << " ms" << std::endl;
+	REQUIRE(unsorted.drawCalls == itemCount);
+	REQUIRE(unsortedBackend.drawnItems == itemCount);
+
+	// sorted and merged into instanced draw calls
+	timer.reset();
+	queue.sort();
+	RecordingBackend sortedBackend;
+	sortedBackend.instancing = true;
+	const RenderQueue::Statistics sorted = queue.execute(sortedBackend);
+	std::cout << "RenderQueue (sorted, instancing): " << sortedBackend.stateChanges << " state changes, " << sortedBackend.drawCalls << " draw calls; "
+			  << timer.getMilliseconds() << " ms" << std::endl;
+	REQUIRE(sortedBackend.drawnItems == itemCount);
+	REQUIRE(sorted.drawCalls + sorted.instances == itemCount);
+	REQUIRE(sorted.shaderChanges == shaders.size());
+	REQUIRE(sorted.textureChanges <= stateIds.size());
+	// every uniform is set and restored, unless the next draw call with the shader sets it again
+	REQUIRE(sorted.uniformChanges > itemCount / 100);
+	REQUIRE(sorted.uniformChanges <= 2 * itemCount / 100);
+	REQUIRE(sortedBackend.stateChanges < unsortedBackend.stateChanges / 10);
+	REQUIRE(sortedBackend.drawCalls < unsortedBackend.drawCalls / 10);
+
+	// every item is drawn with its own state and the uniforms of other items do not leak into it
+	const auto hasOwnColor = [](const std::tuple<Shader *, Texture *, float> & drawnState) {	return std::get<2>(drawnState) != 0.0f;	};
+	REQUIRE(std::count_if(unsortedBackend.drawnStates.begin(), unsortedBackend.drawnStates.end(), hasOwnColor) == itemCount / 100);
+	for(const auto & entry : unsortedBackend.colors)
+		REQUIRE(entry.second == 0.0f);
+	for(const auto & entry : sortedBackend.colors)
+		REQUIRE(entry.second == 0.0f);
+	std::sort(unsortedBackend.drawnStates.begin(), unsortedBackend.drawnStates.end());
+	std::sort(sortedBackend.drawnStates.begin(), sortedBackend.drawnStates.end());
+	REQUIRE(sortedBackend.drawnStates == unsortedBackend.drawnStates);
+
+	queue.clear();
+	REQUIRE(queue.empty());
+}
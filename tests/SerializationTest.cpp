@@ -0,0 +1,574 @@
+/*
+ This file is part of the Rendering library.
+ Copyright (C) 2026 agent <agent@local>
+
+ This library is subject to the terms of the Mozilla Public License, v. 2.0.
+ You should have received a copy of the MPL along with this library; see the
+ file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <catch2/catch.hpp>
+#include <Rendering/Mesh/Mesh.h>
+#include <Rendering/Mesh/MeshIndexData.h>
+#include <Rendering/Mesh/MeshVertexData.h>
+#include <Rendering/Mesh/VertexAttributeAccessors.h>
+#include <Rendering/Mesh/VertexDescription.h>
+#include <Util/References.h>
+#include <Rendering/Serialization/Serialization.h>
+#include <Rendering/Serialization/StreamerMMF.h>
+#include <Rendering/Serialization/StreamerOBJ.h>
+#include <Rendering/Serialization/StreamerPLY.h>
+#include <Rendering/Serialization/StreamerXYZ.h>
+
+#include <Geometry/Vec2.h>
+#include <Geometry/Vec3.h>
+#include <Util/Graphics/Color.h>
+#include <Util/GenericAttribute.h>
+#include <Util/IO/FileName.h>
+#include <Util/IO/FileUtils.h>
+#include <Util/Timer.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace Rendering;
+
+//! Reset the peak resident memory of the process, so that getPeakMemoryMB() measures from now on (Linux only).
+static void resetPeakMemory() {
+	std::ofstream clearRefs("/proc/self/clear_refs");
+	clearRefs << "5";
+}
+
+//! Value of a memory entry (e.g. "VmHWM:") of /proc/self/status in MB (Linux only, 0 otherwise).
+static double getStatusMemoryMB(const std::string & key) {
+	std::ifstream status("/proc/self/status");
+	std::string line;
+	while(std::getline(status, line)) {
+		if(line.compare(0, key.size(), key) == 0)
+			return std::stod(line.substr(key.size())) / 1024.0;
+	}
+	return 0.0;
+}
+
+//! Peak resident memory of the process in MB.
+static double getPeakMemoryMB() {
+	return getStatusMemoryMB("VmHWM:");
+}
+
+//! Current resident memory of the process in MB.
+static double getCurrentMemoryMB() {
+	return getStatusMemoryMB("VmRSS:");
+}
+
+static std::vector<Util::Reference<Mesh>> getMeshes(Util::GenericAttributeList * descriptions) {
+	std::vector<Util::Reference<Mesh>> meshes;
+	for(const auto & attribute : *descriptions) {
+		auto description = dynamic_cast<Util::GenericAttributeMap *>(attribute);
+		if(description && description->getString(Serialization::DESCRIPTION_TYPE) == Serialization::DESCRIPTION_TYPE_MESH) {
+			auto wrapper = dynamic_cast<Serialization::MeshWrapper_t *>(description->getValue(Serialization::DESCRIPTION_DATA));
+			meshes.emplace_back(wrapper->get());
+		}
+	}
+	return meshes;
+}
+
+TEST_CASE("SerializationTest_loadOBJ", "[SerializationTest]") {
+	std::cout << std::endl;
+	// grid with positions, texture coordinates and normals; quads and one long line
+	const uint32_t size = 500;
+	std::ostringstream obj;
+	obj << "# " << std::string(1000, '-') << "\n";
+	obj << "mtllib test.mtl\nusemtl first\n";
+	for(uint32_t y = 0; y <= size; ++y) {
+		for(uint32_t x = 0; x <= size; ++x)
+			obj << "v " << x * 0.01f << ' ' << y * 0.01f << " 0.25\nvt " << x / float(size) << ' ' << y / float(size) << '\n';
+	}
+	obj << "vn 0 0 1\n";
+	for(uint32_t y = 0; y < size; ++y) {
+		for(uint32_t x = 0; x < size; ++x) {
+			const uint32_t a = y * (size + 1) + x + 1;
+			obj << "f " << a << '/' << a << "/1 " << a + 1 << '/' << a + 1 << "/1 " << a + size + 2 << '/' << a + size + 2 << "/1 " << a + size + 1 << '/' << a + size + 1 << "/1\n";
+		}
+	}
+	// second mesh using relative indices
+	obj << "usemtl second\nv 0 0 0\nv 1 0 0\nv 0 1 0\nf -3 -2 -1\n";
+	const std::string data = obj.str();
+
+	std::istringstream input(data);
+	resetPeakMemory();
+	const double memoryBefore = getCurrentMemoryMB();
+	Util::Timer t;
+	Serialization::StreamerOBJ loader;
+	std::unique_ptr<Util::GenericAttributeList> descriptions(loader.loadGeneric(input));
+	const double seconds = t.getSeconds();
+	std::cout << "StreamerOBJ: " << (data.size() / (1024.0 * 1024.0)) / seconds << " MB/s, "
+			<< "peak memory +" << (getPeakMemoryMB() - memoryBefore) << " MB for " << data.size() / (1024.0 * 1024.0) << " MB" << std::endl;
+
+	REQUIRE(descriptions);
+	REQUIRE(descriptions->size() == 3); // material file and two meshes
+	const auto meshes = getMeshes(descriptions.get());
+	REQUIRE(meshes.size() == 2);
+	REQUIRE(meshes[0]->getVertexCount() == (size + 1) * (size + 1));
+	REQUIRE(meshes[0]->getIndexCount() == 6 * size * size);
+	REQUIRE(meshes[1]->getVertexCount() == 3);
+	REQUIRE(meshes[1]->getIndexCount() == 3);
+	REQUIRE(meshes[1]->getBoundingBox().getMaxX() == 1.0f);
+}
+
+//! Previous, line based OBJ parser as reference; returns the vertex data (position, normal, texture coordinate) of every triangle corner per mesh.
+namespace Baseline {
+static void triangulate(std::list<std::vector<float>> & l) {
+	if(l.size() < 3) {
+		l.clear();
+		return;
+	}
+	std::list<std::vector<float>> old(l);
+	l.clear();
+	const std::vector<float> a = old.front();
+	old.pop_front();
+	std::vector<float> b, c = old.front();
+	old.pop_front();
+	while(!old.empty()) {
+		b = c;
+		c = old.front();
+		old.pop_front();
+		l.push_back(a);
+		l.push_back(b);
+		l.push_back(c);
+	}
+}
+
+static std::vector<std::vector<std::vector<float>>> loadOBJ(std::istream & input) {
+	std::vector<std::vector<std::vector<float>>> meshes;
+	std::vector<float> positions(3, 0.0f);
+	std::vector<float> normals(3, 0.0f);
+	std::vector<float> texcoords(2, 0.0f);
+	std::vector<std::vector<float>> corners;
+	const auto finishMesh = [&meshes, &corners]() {
+		if(!corners.empty())
+			meshes.push_back(corners);
+		corners.clear();
+	};
+	char chars[256];
+	while(input.getline(chars, 256)) {
+		char * cursor = chars;
+		while(*cursor == ' ' || *cursor == '\t')
+			++cursor;
+		if(*cursor == 'v') {
+			++cursor;
+			std::vector<float> & target = *cursor == ' ' ? positions : (*cursor == 't' ? texcoords : normals);
+			++cursor;
+			for(uint32_t i = 0; i < (&target == &texcoords ? 2u : 3u); ++i)
+				target.push_back(strtof(cursor, &cursor));
+		} else if(*cursor == 'f') {
+			++cursor;
+			int32_t v = strtol(cursor, &cursor, 10), vt = 0, vn = 0;
+			std::list<std::vector<float>> vertexList;
+			while(v != 0) {
+				if(*cursor == '/') {
+					++cursor;
+					vt = strtol(cursor, &cursor, 10);
+					if(*cursor == '/') {
+						++cursor;
+						vn = strtol(cursor, &cursor, 10);
+					}
+				}
+				if(v < 0)
+					v = positions.size() / 3 + v;
+				if(vt < 0)
+					vt = texcoords.size() / 2 + vt;
+				if(vn < 0)
+					vn = normals.size() / 3 + vn;
+				std::vector<float> vertex(&positions[3 * v], &positions[3 * v + 3]);
+				if(vn != 0)
+					vertex.insert(vertex.end(), &normals[3 * vn], &normals[3 * vn + 3]);
+				if(vt != 0)
+					vertex.insert(vertex.end(), &texcoords[2 * vt], &texcoords[2 * vt + 2]);
+				vertexList.push_back(vertex);
+				v = strtol(cursor, &cursor, 10);
+			}
+			triangulate(vertexList);
+			corners.insert(corners.end(), vertexList.begin(), vertexList.end());
+		} else if(*cursor == 'g' || *cursor == 's' || std::strncmp(cursor, "usemtl", 6) == 0) {
+			finishMesh();
+		}
+	}
+	finishMesh();
+	return meshes;
+}
+}
+
+TEST_CASE("SerializationTest_loadOBJBlocks", "[SerializationTest]") {
+	// rows of vertices, each followed by the faces of the previous row referencing them with relative indices;
+	// all values are exactly representable, so that both parsers have to produce the same floats
+	const uint32_t size = 30;
+	std::ostringstream obj;
+	obj << "mtllib test.mtl\n";
+	for(uint32_t y = 0; y <= size; ++y) {
+		if(y == size / 2)
+			obj << "usemtl second\n";
+		for(uint32_t x = 0; x <= size; ++x)
+			obj << "v " << x * 0.125f << ' ' << y * 0.25f << ' ' << (x * y) % 7 << "\nvt " << x / 64.0f << ' ' << y / 64.0f << "\nvn 0 " << (x % 2) << " 1\n";
+		if(y == 0)
+			continue;
+		const int32_t row = static_cast<int32_t>(size + 1);
+		for(int32_t x = 0; x < row - 1; ++x) {
+			// corner (x, y - 1) is 2 * row - x vertices back
+			const int32_t a = -2 * row + x, b = a + 1, c = -row + x + 1, d = -row + x;
+			obj << "f " << a << '/' << a << '/' << a << ' ' << b << '/' << b << '/' << b << ' ' << c << '/' << c << '/' << c;
+			if(x % 3 != 0)
+				obj << ' ' << d << '/' << d << '/' << d;
+			obj << '\n';
+		}
+	}
+	// absolute indices of vertices from the first block
+	obj << "g last\nf 1/1/1 2/2/2 " << size + 3 << '/' << size + 3 << '/' << size + 3 << "\n";
+	const std::string data = obj.str();
+
+	std::istringstream referenceInput(data);
+	const auto expected = Baseline::loadOBJ(referenceInput);
+	REQUIRE(expected.size() == 3);
+
+	// block sizes splitting lines, shorter than a line and containing everything
+	for(const std::size_t blockSize : {std::size_t(7), std::size_t(100), std::size_t(4096), Serialization::StreamerOBJ::DEFAULT_BLOCK_SIZE}) {
+		CAPTURE(blockSize);
+		REQUIRE((blockSize > data.size()) == (blockSize == Serialization::StreamerOBJ::DEFAULT_BLOCK_SIZE));
+		Serialization::StreamerOBJ loader(blockSize);
+		std::istringstream input(data);
+		std::unique_ptr<Util::GenericAttributeList> descriptions(loader.loadGeneric(input));
+		REQUIRE(descriptions);
+		const auto meshes = getMeshes(descriptions.get());
+		REQUIRE(meshes.size() == expected.size());
+		for(uint32_t m = 0; m < meshes.size(); ++m) {
+			REQUIRE(meshes[m]->getIndexCount() == expected[m].size());
+			MeshVertexData & vertexData = meshes[m]->openVertexData();
+			auto posAcc = PositionAttributeAccessor::create(vertexData);
+			auto normalAcc = NormalAttributeAccessor::create(vertexData);
+			auto texAcc = TexCoordAttributeAccessor::create(vertexData);
+			const MeshIndexData & indices = meshes[m]->openIndexData();
+			for(uint32_t i = 0; i < indices.getIndexCount(); ++i) {
+				const std::vector<float> & corner = expected[m][i];
+				REQUIRE(corner.size() == 8);
+				REQUIRE(posAcc->getPosition(indices[i]) == Geometry::Vec3(corner[0], corner[1], corner[2]));
+				REQUIRE(normalAcc->getNormal(indices[i]) == Geometry::Vec3(corner[3], corner[4], corner[5]));
+				REQUIRE(texAcc->getCoordinate(indices[i]) == Geometry::Vec2(corner[6], corner[7]));
+			}
+		}
+	}
+}
+
+TEST_CASE("SerializationTest_loadMeshMapped", "[SerializationTest]") {
+	std::cout << std::endl;
+	const uint32_t size = 300;
+	VertexDescription vd;
+	vd.appendPosition3D();
+	vd.appendNormalFloat();
+	Util::Reference<Mesh> mesh = new Mesh(vd, (size + 1) * (size + 1), 6 * size * size);
+	{
+		auto posAcc = PositionAttributeAccessor::create(mesh->openVertexData());
+		for(uint32_t i = 0; i < mesh->getVertexCount(); ++i)
+			posAcc->setPosition(i, Geometry::Vec3(i % (size + 1), i / (size + 1), 0.5f));
+		uint32_t * indices = mesh->openIndexData().data();
+		for(uint32_t i = 0; i < mesh->getIndexCount(); ++i)
+			indices[i] = (i * 7) % mesh->getVertexCount();
+		mesh->openVertexData().updateBoundingBox();
+		mesh->openIndexData().updateIndexRange();
+	}
+	const Util::FileName file("test_loadMeshMapped.mmf");
+	REQUIRE(Serialization::saveMesh(mesh.get(), file));
+
+	const uint32_t iterations = 100;
+	Util::Timer t;
+	for(uint32_t i = 0; i < iterations; ++i)
+		Util::Reference<Mesh> loaded = Serialization::loadMesh(file);
+	std::cout << "loadMesh: " << t.getMilliseconds() / iterations << " ms" << std::endl;
+	t.reset();
+	for(uint32_t i = 0; i < iterations; ++i)
+		Util::Reference<Mesh> loaded = Serialization::loadMeshMapped(file);
+	std::cout << "loadMeshMapped: " << t.getMilliseconds() / iterations << " ms" << std::endl;
+
+	Util::Reference<Mesh> mapped = Serialization::loadMeshMapped(file);
+	REQUIRE(mapped.isNotNull());
+	REQUIRE(mapped->getVertexCount() == mesh->getVertexCount());
+	REQUIRE(mapped->getIndexCount() == mesh->getIndexCount());
+	REQUIRE(mapped->getBoundingBox() == mesh->getBoundingBox());
+	REQUIRE(std::equal(mesh->openVertexData().data(), mesh->openVertexData().data() + mesh->openVertexData().dataSize(), mapped->openVertexData().data()));
+	REQUIRE(std::equal(mesh->openIndexData().data(), mesh->openIndexData().data() + mesh->getIndexCount(), mapped->openIndexData().data()));
+
+	// modifying the mapped data must not change the file
+	mapped->openIndexData()[0] = 42;
+	Util::Reference<Mesh> reloaded = Serialization::loadMeshMapped(file);
+	REQUIRE(reloaded->openIndexData()[0] == mesh->openIndexData()[0]);
+	REQUIRE(mapped->openIndexData()[0] == 42);
+	// copies own their data
+	Util::Reference<Mesh> copy = mapped->clone();
+	mapped = nullptr;
+	REQUIRE(copy->openIndexData()[0] == 42);
+	Util::FileUtils::remove(file);
+}
+
+TEST_CASE("SerializationTest_MMFArchive", "[SerializationTest]") {
+	std::cout << std::endl;
+	const uint32_t size = 200;
+	VertexDescription vd;
+	vd.appendPosition3D();
+	vd.appendNormalFloat();
+	vd.appendTexCoord();
+	Util::Reference<Mesh> grid = new Mesh(vd, (size + 1) * (size + 1), 6 * size * size);
+	{
+		auto posAcc = PositionAttributeAccessor::create(grid->openVertexData());
+		auto normalAcc = NormalAttributeAccessor::create(grid->openVertexData());
+		auto texCoordAcc = TexCoordAttributeAccessor::create(grid->openVertexData());
+		for(uint32_t y = 0; y <= size; ++y) {
+			for(uint32_t x = 0; x <= size; ++x) {
+				const uint32_t i = y * (size + 1) + x;
+				posAcc->setPosition(i, Geometry::Vec3(x * 0.1f, std::sin(x * 0.1f), y * 0.1f));
+				normalAcc->setNormal(i, Geometry::Vec3(-std::cos(x * 0.1f), 1.0f, 0.0f).normalize());
+				texCoordAcc->setCoordinate(i, Geometry::Vec2(x / float(size), y / float(size)));
+			}
+		}
+		uint32_t * indices = grid->openIndexData().data();
+		for(uint32_t y = 0; y < size; ++y) {
+			for(uint32_t x = 0; x < size; ++x) {
+				const uint32_t base = y * (size + 1) + x;
+				const uint32_t quad[6] = {base, base + 1, base + size + 1, base + 1, base + size + 2, base + size + 1};
+				std::copy(quad, quad + 6, indices + 6 * (y * size + x));
+			}
+		}
+		grid->openVertexData().updateBoundingBox();
+		grid->openIndexData().updateIndexRange();
+	}
+	Util::Reference<Mesh> copy = grid->clone();
+
+	Serialization::StreamerMMF streamer;
+	std::stringstream v1;
+	REQUIRE(streamer.saveMesh(grid.get(), v1));
+	std::stringstream v2;
+	REQUIRE(Serialization::StreamerMMF::saveMeshes({{"grid", grid.get()}, {"copy", copy.get()}}, v2));
+	Serialization::StreamerMMF::SaveOptions options;
+	options.quantizePositions = options.quantizeNormals = options.quantizeTexCoords = true;
+	std::stringstream quantized;
+	REQUIRE(Serialization::StreamerMMF::saveMeshes({{"grid", grid.get()}, {"copy", copy.get()}}, quantized, options));
+	std::cout << "MMF v1: " << v1.str().size() << " bytes, v2 (two meshes): " << v2.str().size()
+			<< " bytes, v2 quantized: " << quantized.str().size() << " bytes" << std::endl;
+
+	REQUIRE(Serialization::StreamerMMF::getMeshNames(v2) == std::vector<std::string>({"grid", "copy"}));
+	v2.seekg(0);
+	Util::Reference<Mesh> loaded = Serialization::StreamerMMF::loadMeshFromArchive(v2, "copy");
+	REQUIRE(loaded.isNotNull());
+	REQUIRE(loaded->getVertexCount() == grid->getVertexCount());
+	REQUIRE(loaded->getVertexDescription() == grid->getVertexDescription());
+	REQUIRE(std::equal(grid->openVertexData().data(), grid->openVertexData().data() + grid->openVertexData().dataSize(), loaded->openVertexData().data()));
+	REQUIRE(std::equal(grid->openIndexData().data(), grid->openIndexData().data() + grid->getIndexCount(), loaded->openIndexData().data()));
+
+	quantized.seekg(0);
+	loaded = streamer.loadMesh(quantized);
+	REQUIRE(loaded.isNotNull());
+	REQUIRE(loaded->getIndexCount() == grid->getIndexCount());
+	auto posAcc = PositionAttributeAccessor::create(grid->openVertexData());
+	auto loadedPosAcc = PositionAttributeAccessor::create(loaded->openVertexData());
+	auto normalAcc = NormalAttributeAccessor::create(grid->openVertexData());
+	auto loadedNormalAcc = NormalAttributeAccessor::create(loaded->openVertexData());
+	for(uint32_t i = 0; i < grid->getVertexCount(); i += 97) {
+		REQUIRE(posAcc->getPosition(i).distance(loadedPosAcc->getPosition(i)) < 0.001f);
+		REQUIRE(normalAcc->getNormal(i).dot(loadedNormalAcc->getNormal(i)) > 0.9999f);
+	}
+
+	// a corrupted block is detected by its checksum
+	std::string corrupted = v2.str();
+	corrupted[corrupted.size() / 4] ^= 0x10; // inside the data of the first mesh
+	std::istringstream corruptedInput(corrupted);
+	REQUIRE(Serialization::StreamerMMF::loadMeshFromArchive(corruptedInput, "grid") == nullptr);
+}
+
+//! Append @p value in big endian byte order.
+template<typename T>
+static void appendBigEndian(std::string & data, T value) {
+	char bytes[sizeof(T)];
+	std::memcpy(bytes, &value, sizeof(T));
+	std::reverse(bytes, bytes + sizeof(T));
+	data.append(bytes, sizeof(T));
+}
+
+//! String buffer that cannot seek, like the buffer of a pipe.
+class UnseekableStringBuffer : public std::stringbuf {
+	public:
+		explicit UnseekableStringBuffer(const std::string & data) : std::stringbuf(data, std::ios::in) {}
+	protected:
+		pos_type seekoff(off_type, std::ios::seekdir, std::ios::openmode) override	{	return pos_type(off_type(-1));	}
+		pos_type seekpos(pos_type, std::ios::openmode) override						{	return pos_type(off_type(-1));	}
+};
+
+TEST_CASE("SerializationTest_loadBinaryPLY", "[SerializationTest]") {
+	std::cout << std::endl;
+	// point cloud with colors (big endian)
+	const uint32_t pointCount = 1000000;
+	std::string cloud = "ply\nformat binary_big_endian 1.0\ncomment test\nelement vertex " + std::to_string(pointCount) + "\n"
+		"property float x\nproperty float y\nproperty float z\nproperty uchar red\nproperty uchar green\nproperty uchar blue\nend_header\n";
+	for(uint32_t i = 0; i < pointCount; ++i) {
+		appendBigEndian(cloud, static_cast<float>(i % 1000));
+		appendBigEndian(cloud, static_cast<float>(i / 1000));
+		appendBigEndian(cloud, 0.5f);
+		appendBigEndian(cloud, static_cast<uint8_t>(i));
+		appendBigEndian(cloud, static_cast<uint8_t>(2 * i));
+		appendBigEndian(cloud, static_cast<uint8_t>(3 * i));
+	}
+	Serialization::StreamerPLY streamer;
+	std::istringstream cloudInput(cloud);
+	Util::Timer t;
+	Util::Reference<Mesh> mesh = streamer.loadMesh(cloudInput);
+	std::cout << "StreamerPLY::loadMesh (" << pointCount << " points): " << t.getMilliseconds() << " ms" << std::endl;
+	REQUIRE(mesh.isNotNull());
+	REQUIRE(mesh->getVertexCount() == pointCount);
+	REQUIRE(mesh->getDrawMode() == Mesh::DRAW_POINTS);
+	REQUIRE(mesh->getBoundingBox().getMaxX() == 999.0f);
+	{
+		auto posAcc = PositionAttributeAccessor::create(mesh->openVertexData());
+		auto colorAcc = ColorAttributeAccessor::create(mesh->openVertexData());
+		for(uint32_t i = 0; i < pointCount; i += 9973) {
+			REQUIRE(posAcc->getPosition(i) == Geometry::Vec3(i % 1000, i / 1000, 0.5f));
+			const Util::Color4ub color = colorAcc->getColor4ub(i);
+			REQUIRE(color.getR() == static_cast<uint8_t>(i));
+			REQUIRE(color.getG() == static_cast<uint8_t>(2 * i));
+			REQUIRE(color.getB() == static_cast<uint8_t>(3 * i));
+			REQUIRE(color.getA() == 255);
+		}
+	}
+
+	// the stream is read in chunks; it does not have to be seekable
+	{
+		UnseekableStringBuffer buffer(cloud);
+		std::istream unseekableInput(&buffer);
+		Util::Reference<Mesh> streamedMesh = streamer.loadMesh(unseekableInput);
+		REQUIRE(streamedMesh.isNotNull());
+		REQUIRE(streamedMesh->getVertexCount() == pointCount);
+		REQUIRE(std::equal(mesh->openVertexData().data(), mesh->openVertexData().data() + mesh->openVertexData().dataSize(),
+						   streamedMesh->openVertexData().data()));
+	}
+	std::istringstream truncatedCloudInput(cloud.substr(0, cloud.size() - 1));
+	REQUIRE(streamer.loadMesh(truncatedCloudInput) == nullptr);
+	{
+		UnseekableStringBuffer buffer(cloud.substr(0, cloud.size() - 1));
+		std::istream unseekableInput(&buffer);
+		REQUIRE(streamer.loadMesh(unseekableInput) == nullptr);
+	}
+
+	// the same file in chunks
+	const Util::FileName file("test_loadBinaryPLY.ply");
+	{
+		std::ofstream output(file.getPath(), std::ios::binary);
+		output << cloud;
+	}
+	std::vector<Util::Reference<Mesh>> chunks;
+	t.reset();
+	REQUIRE(Serialization::StreamerPLY::loadMeshChunks(file, 300000, [&chunks](Util::Reference<Mesh> chunk) { chunks.push_back(chunk); }));
+	std::cout << "StreamerPLY::loadMeshChunks: " << t.getMilliseconds() << " ms" << std::endl;
+	REQUIRE(chunks.size() == 4);
+	REQUIRE(chunks.back()->getVertexCount() == 100000);
+	REQUIRE(std::equal(mesh->openVertexData().data() + 900000 * mesh->getVertexDescription().getVertexSize(),
+					   mesh->openVertexData().data() + mesh->openVertexData().dataSize(), chunks.back()->openVertexData().data()));
+	Util::FileUtils::remove(file);
+
+	// polygons are triangulated as fans (little endian, double coordinates, short normals)
+	std::string polygons = "ply\nformat binary_little_endian 1.0\nelement vertex 5\n"
+		"property double x\nproperty double y\nproperty double z\nproperty short nx\nproperty short ny\nproperty short nz\n"
+		"element face 2\nproperty list uchar int vertex_indices\nend_header\n";
+	for(uint32_t i = 0; i < 5; ++i) {
+		const double position[3] = {std::cos(i * 1.2566), std::sin(i * 1.2566), 0.0};
+		const int16_t normal[3] = {0, 0, 1};
+		polygons.append(reinterpret_cast<const char *>(position), sizeof(position));
+		polygons.append(reinterpret_cast<const char *>(normal), sizeof(normal));
+	}
+	const uint8_t triangleSize = 3;
+	const int32_t triangle[3] = {0, 1, 2};
+	const uint8_t pentagonSize = 5;
+	const int32_t pentagon[5] = {0, 1, 2, 3, 4};
+	polygons.append(reinterpret_cast<const char *>(&triangleSize), 1).append(reinterpret_cast<const char *>(triangle), sizeof(triangle));
+	polygons.append(reinterpret_cast<const char *>(&pentagonSize), 1).append(reinterpret_cast<const char *>(pentagon), sizeof(pentagon));
+	std::istringstream polygonInput(polygons);
+	mesh = streamer.loadMesh(polygonInput);
+	REQUIRE(mesh.isNotNull());
+	REQUIRE(mesh->getVertexCount() == 5);
+	REQUIRE(mesh->getIndexCount() == 12);
+	const uint32_t expectedIndices[12] = {0, 1, 2, 0, 1, 2, 0, 2, 3, 0, 3, 4};
+	REQUIRE(std::equal(expectedIndices, expectedIndices + 12, mesh->openIndexData().data()));
+
+	// a face referencing a vertex that does not exist is rejected
+	std::string invalidPolygons = polygons;
+	invalidPolygons[invalidPolygons.size() - sizeof(int32_t)] = 5;
+	std::istringstream invalidPolygonInput(invalidPolygons);
+	REQUIRE(streamer.loadMesh(invalidPolygonInput) == nullptr);
+
+	// an empty point cloud yields no chunks
+	const std::string emptyCloud = "ply\nformat binary_little_endian 1.0\nelement vertex 0\n"
+		"property float x\nproperty float y\nproperty float z\nend_header\n";
+	{
+		std::ofstream output(file.getPath(), std::ios::binary);
+		output << emptyCloud;
+	}
+	chunks.clear();
+	REQUIRE(Serialization::StreamerPLY::loadMeshChunks(file, 300000, [&chunks](Util::Reference<Mesh> chunk) { chunks.push_back(chunk); }));
+	REQUIRE(chunks.empty());
+	Util::FileUtils::remove(file);
+	std::istringstream emptyCloudInput(emptyCloud);
+	mesh = streamer.loadMesh(emptyCloudInput);
+	REQUIRE(mesh.isNotNull());
+	REQUIRE(mesh->getVertexCount() == 0);
+}
+
+TEST_CASE("SerializationTest_tileXYZ", "[SerializationTest]") {
+	std::cout << std::endl;
+	const uint32_t pointCount = 500000;
+	std::ostringstream xyz;
+	std::default_random_engine engine(0);
+	std::uniform_real_distribution<float> coordinateDist(0.0f, 30.0f);
+	for(uint32_t i = 0; i < pointCount; ++i)
+		xyz << coordinateDist(engine) << ' ' << coordinateDist(engine) * 0.1f << ' ' << coordinateDist(engine) * 0.1f << " 10 20 30\n";
+	xyz << "\n"; // empty lines are ignored
+
+	Serialization::StreamerXYZ::TilingOptions options;
+	options.tileSize = 10.0f;
+	options.maxPointsPerTile = 100000;
+	options.memoryLimit = 4 * 1024 * 1024;
+	std::istringstream input(xyz.str());
+	Util::Timer t;
+	const auto tiles = Serialization::StreamerXYZ::tilePoints(input, Util::FileName("test_tileXYZ"), options);
+	std::cout << "StreamerXYZ::tilePoints (" << pointCount << " points, " << tiles.size() << " tiles): " << t.getMilliseconds() << " ms" << std::endl;
+	// three cells of the grid with about 166000 points each; they are split into octants
+	REQUIRE(tiles.size() == 6);
+
+	uint64_t tiledPointCount = 0;
+	for(const auto & tile : tiles) {
+		REQUIRE(tile.pointCount <= options.maxPointsPerTile);
+		REQUIRE(tile.bounds.getExtentX() <= options.tileSize);
+		tiledPointCount += tile.pointCount;
+	}
+	REQUIRE(tiledPointCount == pointCount);
+
+	const auto manifest = Serialization::StreamerXYZ::loadTileManifest(Util::FileName("test_tileXYZ_tiles.txt"));
+	REQUIRE(manifest.size() == tiles.size());
+	REQUIRE(manifest.front().file == tiles.front().file);
+	REQUIRE(manifest.front().bounds == tiles.front().bounds);
+
+	Serialization::StreamerXYZ streamer;
+	for(const auto & tile : manifest) {
+		auto tileInput = Util::FileUtils::openForReading(tile.file);
+		Util::Reference<Mesh> mesh = streamer.loadMesh(*tileInput, tile.pointCount);
+		REQUIRE(mesh->getVertexCount() == tile.pointCount);
+		REQUIRE(mesh->getBoundingBox() == tile.bounds);
+		tileInput.reset();
+		Util::FileUtils::remove(tile.file);
+	}
+	Util::FileUtils::remove(Util::FileName("test_tileXYZ_tiles.txt"));
+}
@@ -0,0 +1,160 @@
+/*
+ This file is part of the Rendering library.
+ Copyright (C) 2026 agent <agent@local>
+
+ This library is subject to the terms of the Mozilla Public License, v. 2.0.
+ You should have received a copy of the MPL along with this library; see the
+ file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <catch2/catch.hpp>
+#include <Rendering/BufferObject.h>
+#include <Rendering/Mesh/AsyncMeshDataStrategy.h>
+#include <Rendering/Mesh/Mesh.h>
+#include <Rendering/Mesh/MeshIndexData.h>
+#include <Rendering/Mesh/MeshVertexData.h>
+#include <Rendering/Mesh/VertexDescription.h>
+#include <Rendering/RenderingContext/RenderingContext.h>
+#include <Rendering/StagingRing.h>
+#include <Rendering/StatisticsQuery.h>
+
+#include <Util/References.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <vector>
+
+using namespace Rendering;
+
+//! Call @p update (once per simulated frame) until @p done returns true; returns false after a timeout.
+static bool runFrames(const std::function<void ()> & update, const std::function<bool ()> & done) {
+	for(uint32_t frame = 0; frame < 10000; ++frame) {
+		update();
+		if(done())
+			return true;
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	return false;
+}
+
+static uint8_t getByte(uint32_t transfer, size_t offset) {
+	return static_cast<uint8_t>(offset * 7 + transfer);
+}
+
+TEST_CASE("StagingRingTest_transfer", "[StagingRingTest]") {
+	for(const bool persistentMapping : {true, false}) {
+		StagingRing ring(4096, 1024, 2, persistentMapping);
+		if(!persistentMapping)
+			REQUIRE_FALSE(ring.isPersistentlyMapped());
+
+		const size_t size = 3000;
+		std::vector<BufferObject> targets(5);
+		std::vector<bool> completed(targets.size(), false);
+		std::vector<uint32_t> ids;
+		for(uint32_t t = 0; t < targets.size(); ++t) {
+			targets[t].allocateData<uint8_t>(BufferObject::TARGET_COPY_WRITE_BUFFER, size, BufferObject::USAGE_STATIC_DRAW);
+			ids.push_back(ring.enqueue(targets[t], 0, size, [t](uint8_t * destination, size_t offset, size_t count) {
+				for(size_t i = 0; i < count; ++i)
+					destination[i] = getByte(t, offset + i);
+			}, [&completed, t]() {	completed[t] = true;	}));
+		}
+		ring.cancel(ids[3]);
+		REQUIRE(ring.getPendingTransferCount() == 4);
+
+		size_t maxCopiedBytes = 0;
+		REQUIRE(runFrames([&]() {
+			ring.update();
+			maxCopiedBytes = std::max(maxCopiedBytes, ring.getCopiedBytes());
+		}, [&ring]() {	return ring.getPendingTransferCount() == 0;	}));
+		REQUIRE(maxCopiedBytes > 0);
+		REQUIRE(maxCopiedBytes <= ring.getBytesPerFrame());
+
+		for(uint32_t t = 0; t < targets.size(); ++t) {
+			REQUIRE(completed[t] == (t != 3));
+			if(t == 3)
+				continue;
+			const std::vector<uint8_t> data = targets[t].downloadData<uint8_t>(BufferObject::TARGET_COPY_READ_BUFFER, size);
+			for(size_t i = 0; i < size; ++i)
+				REQUIRE(data[i] == getByte(t, i));
+		}
+	}
+}
+
+TEST_CASE("StagingRingTest_asyncMeshDataStrategy", "[StagingRingTest]") {
+	AsyncMeshDataStrategy strategy(0, 4096, 1024, 2);
+
+	VertexDescription vd;
+	vd.appendPosition3D();
+	Util::Reference<Mesh> mesh = new Mesh(vd, 500, 900);
+	MeshVertexData & vertices = mesh->openVertexData();
+	float * positions = reinterpret_cast<float *>(vertices.data());
+	for(uint32_t i = 0; i < 3 * vertices.getVertexCount(); ++i)
+		positions[i] = static_cast<float>(i);
+	MeshIndexData & indices = mesh->openIndexData();
+	for(uint32_t i = 0; i < indices.getIndexCount(); ++i)
+		indices[i] = i % 500;
+	indices.updateIndexRange();
+	mesh->setDataStrategy(&strategy);
+
+	// the mesh is not drawable before its upload is complete
+	strategy.prepare(mesh.get());
+	REQUIRE_FALSE(strategy.isReady(mesh.get()));
+	REQUIRE_FALSE(mesh->_getVertexData().isUploaded());
+	REQUIRE(strategy.getPendingMeshCount() == 1);
+	REQUIRE(runFrames([&strategy]() {	strategy.update();	}, [&strategy, &mesh]() {	return strategy.isReady(mesh.get());	}));
+	REQUIRE(mesh->_getVertexData().isUploaded());
+	REQUIRE(mesh->_getIndexData().isUploaded());
+	REQUIRE_FALSE(mesh->_getVertexData().hasLocalData());
+
+	// the data is downloaded from the uploaded buffers
+	const MeshVertexData & downloadedVertices = mesh->openVertexData();
+	REQUIRE(downloadedVertices.hasLocalData());
+	const float * downloadedPositions = reinterpret_cast<const float *>(downloadedVertices.data());
+	for(uint32_t i = 0; i < 3 * downloadedVertices.getVertexCount(); ++i)
+		REQUIRE(downloadedPositions[i] == static_cast<float>(i));
+	const MeshIndexData & downloadedIndices = mesh->openIndexData();
+	for(uint32_t i = 0; i < downloadedIndices.getIndexCount(); ++i)
+		REQUIRE(downloadedIndices[i] == i % 500);
+
+	RenderingContext context;
+	StatisticsQuery query = StatisticsQuery::createPrimitivesSubmittedQuery();
+	const auto countDrawnTriangles = [&context, &query, &mesh]() {
+		query.begin();
+		context.displayMesh(mesh.get());
+		query.end();
+		return query.getResult();
+	};
+	REQUIRE(countDrawnTriangles() == 300);
+
+	// a changed mesh is uploaded again; the previous buffers are drawn until the upload is complete
+	mesh->openVertexData().markAsChanged();
+	strategy.prepare(mesh.get());
+	REQUIRE_FALSE(strategy.isReady(mesh.get()));
+	REQUIRE(mesh->_getVertexData().isUploaded());
+	REQUIRE(countDrawnTriangles() == 300);
+	REQUIRE(runFrames([&strategy]() {	strategy.update();	}, [&strategy, &mesh]() {	return strategy.isReady(mesh.get());	}));
+	REQUIRE_FALSE(mesh->_getVertexData().hasChanged());
+	REQUIRE_FALSE(mesh->_getIndexData().hasChanged());
+	REQUIRE(countDrawnTriangles() == 300);
+
+	// the previous buffers are not drawn if the number of indices has changed
+	MeshIndexData & changedIndices = mesh->openIndexData();
+	changedIndices.allocate(600);
+	for(uint32_t i = 0; i < changedIndices.getIndexCount(); ++i)
+		changedIndices[i] = i % 500;
+	changedIndices.updateIndexRange();
+	REQUIRE(countDrawnTriangles() == 0);
+	REQUIRE_FALSE(strategy.isReady(mesh.get()));
+	REQUIRE(runFrames([&strategy]() {	strategy.update();	}, [&strategy, &mesh]() {	return strategy.isReady(mesh.get());	}));
+	REQUIRE(countDrawnTriangles() == 200);
+
+	// a changed mesh is uploaded again
+	mesh->openVertexData().markAsChanged();
+	strategy.prepare(mesh.get());
+	REQUIRE_FALSE(strategy.isReady(mesh.get()));
+	mesh = nullptr;
+	REQUIRE(strategy.getPendingMeshCount() == 0);
+}
@@ -0,0 +1,211 @@
+/*
+ This file is part of the Rendering library.
+ Copyright (C) 2026 agent <agent@local>
+
+ This library is subject to the terms of the Mozilla Public License, v. 2.0.
+ You should have received a copy of the MPL along with this library; see the
+ file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <catch2/catch.hpp>
+#include <Rendering/Mesh/Mesh.h>
+#include <Rendering/Mesh/MeshIndexData.h>
+#include <Rendering/Mesh/MeshVertexData.h>
+#include <Rendering/Mesh/SharedBufferMeshDataStrategy.h>
+#include <Rendering/Mesh/VertexDescription.h>
+#include <Rendering/SubAllocatedBuffer.h>
+
+#include <Util/References.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace Rendering;
+
+//! Stores the data of a SubAllocatedBuffer in main memory instead of a BufferObject.
+class FakeBackend : public SubAllocatedBuffer::Backend {
+	public:
+		std::vector<uint8_t> storage;
+		uint32_t relocations = 0;
+
+		void relocate(size_t capacity, const std::vector<SubAllocatedBuffer::Move> & moves) override {
+			std::vector<uint8_t> newStorage(capacity, 0);
+			for(const auto & move : moves) {
+				REQUIRE(move.source + move.size <= storage.size());
+				REQUIRE(move.target + move.size <= capacity);
+				std::copy(storage.begin() + move.source, storage.begin() + move.source + move.size, newStorage.begin() + move.target);
+			}
+			storage.swap(newStorage);
+			++relocations;
+		}
+		void upload(size_t offset, const uint8_t * data, size_t size) override {
+			REQUIRE(offset + size <= storage.size());
+			std::copy(data, data + size, storage.begin() + offset);
+		}
+		void download(size_t offset, uint8_t * data, size_t size) override {
+			REQUIRE(offset + size <= storage.size());
+			std::copy(storage.begin() + offset, storage.begin() + offset + size, data);
+		}
+};
+
+TEST_CASE("SubAllocatedBufferTest_allocate", "[SubAllocatedBufferTest]") {
+	std::unique_ptr<FakeBackend> fakeBackend(new FakeBackend);
+	FakeBackend * backend = fakeBackend.get();
+	SubAllocatedBuffer buffer(std::move(fakeBackend), 12, 1000);
+	REQUIRE(buffer.getCapacity() == 1008);
+
+	std::default_random_engine engine(42);
+	std::uniform_int_distribution<size_t> sizeDist(1, 100);
+	std::vector<uint32_t> ids;
+	std::vector<std::vector<uint8_t>> contents;
+	for(uint32_t round = 0; round < 2000; ++round) {
+		if(ids.empty() || engine() % 3 != 0) {
+			std::vector<uint8_t> data(sizeDist(engine), static_cast<uint8_t>(round));
+			const uint32_t id = buffer.allocate(data.size());
+			REQUIRE(buffer.getOffset(id) % 12 == 0);
+			REQUIRE(buffer.getSize(id) >= data.size());
+			buffer.upload(id, data.data(), data.size());
+			ids.push_back(id);
+			contents.push_back(data);
+		} else {
+			const size_t i = engine() % ids.size();
+			buffer.free(ids[i]);
+			ids.erase(ids.begin() + i);
+			contents.erase(contents.begin() + i);
+		}
+		if(round % 500 == 0)
+			buffer.defragment();
+	}
+	REQUIRE(buffer.getAllocationCount() == ids.size());
+	REQUIRE(backend->relocations > 1); // initial allocation and growth
+
+	// no overlapping ranges
+	std::vector<std::pair<size_t, size_t>> ranges;
+	size_t usedSize = 0;
+	for(const auto id : ids) {
+		ranges.emplace_back(buffer.getOffset(id), buffer.getSize(id));
+		usedSize += buffer.getSize(id);
+	}
+	std::sort(ranges.begin(), ranges.end());
+	for(size_t i = 1; i < ranges.size(); ++i)
+		REQUIRE(ranges[i - 1].first + ranges[i - 1].second <= ranges[i].first);
+	REQUIRE(buffer.getUsedSize() == usedSize);
+
+	// the data survives growing and defragmentation
+	buffer.defragment();
+	REQUIRE(buffer.getLargestFreeRange() == buffer.getCapacity() - buffer.getUsedSize());
+	REQUIRE(buffer.defragment() == 0);
+	for(size_t i = 0; i < ids.size(); ++i) {
+		std::vector<uint8_t> data(contents[i].size());
+		buffer.download(ids[i], data.data(), data.size());
+		REQUIRE(data == contents[i]);
+	}
+
+	// freeing everything merges all free ranges
+	for(const auto id : ids)
+		buffer.free(id);
+	REQUIRE(buffer.getUsedSize() == 0);
+	REQUIRE(buffer.getLargestFreeRange() == buffer.getCapacity());
+	REQUIRE_THROWS(buffer.free(ids.front()));
+}
+
+TEST_CASE("SubAllocatedBufferTest_sharedBufferStrategy", "[SubAllocatedBufferTest]") {
+	SharedBufferMeshDataStrategy strategy(SharedBufferMeshDataStrategy::RELEASE_LOCAL_DATA, 1024, []() {
+		return std::unique_ptr<SubAllocatedBuffer::Backend>(new FakeBackend);
+	});
+
+	VertexDescription vd;
+	vd.appendPosition3D();
+	std::vector<Util::Reference<Mesh>> meshes;
+	for(uint32_t m = 0; m < 100; ++m) {
+		Util::Reference<Mesh> mesh = new Mesh(vd, 3 + m, 6);
+		MeshVertexData & vertices = mesh->openVertexData();
+		float * positions = reinterpret_cast<float *>(vertices.data());
+		for(uint32_t i = 0; i < 3 * vertices.getVertexCount(); ++i)
+			positions[i] = static_cast<float>(m * 1000 + i);
+		MeshIndexData & indices = mesh->openIndexData();
+		for(uint32_t i = 0; i < 6; ++i)
+			indices[i] = i % 3;
+		indices.updateIndexRange();
+		mesh->setDataStrategy(&strategy);
+		strategy.prepare(mesh.get());
+		meshes.push_back(mesh);
+	}
+	// one vertex buffer and one index buffer for all meshes
+	REQUIRE(strategy.getMeshCount() == 100);
+	REQUIRE(strategy.getBufferCount() == 2);
+	REQUIRE(strategy.getVertexBuffer(meshes.front()->getVertexDescription())->getAllocationCount() == 100);
+	REQUIRE_FALSE(meshes.front()->_getVertexData().hasLocalData());
+
+	// free every second mesh and compact the buffers
+	for(uint32_t m = 0; m < 100; m += 2)
+		meshes[m] = nullptr;
+	REQUIRE(strategy.getMeshCount() == 50);
+	REQUIRE(strategy.defragment() > 0);
+
+	// the data is downloaded from the shared buffers when it is opened
+	for(uint32_t m = 1; m < 100; m += 2) {
+		const MeshVertexData & vertices = meshes[m]->openVertexData();
+		REQUIRE(vertices.getVertexCount() == 3 + m);
+		const float * positions = reinterpret_cast<const float *>(vertices.data());
+		for(uint32_t i = 0; i < 3 * vertices.getVertexCount(); ++i)
+			REQUIRE(positions[i] == static_cast<float>(m * 1000 + i));
+		const MeshIndexData & indices = meshes[m]->openIndexData();
+		REQUIRE(indices[4] == 1);
+		REQUIRE(indices.getMaxIndex() == 2);
+	}
+
+	// changing the strategy keeps the data accessible
+	meshes[1]->setDataStrategy(SimpleMeshDataStrategy::getPureLocalStrategy());
+	REQUIRE(strategy.getMeshCount() == 49);
+	REQUIRE(meshes[1]->_getVertexData().hasLocalData());
+}
+
+TEST_CASE("SubAllocatedBufferTest_destroyStrategy", "[SubAllocatedBufferTest]") {
+	std::unique_ptr<SharedBufferMeshDataStrategy> strategy(new SharedBufferMeshDataStrategy(SharedBufferMeshDataStrategy::RELEASE_LOCAL_DATA, 1024, []() {
+		return std::unique_ptr<SubAllocatedBuffer::Backend>(new FakeBackend);
+	}));
+	MeshDataStrategy * initialDefault = MeshDataStrategy::getDefaultStrategy();
+	MeshDataStrategy::setDefaultStrategy(strategy.get());
+
+	VertexDescription vd;
+	vd.appendPosition3D();
+	std::vector<Util::Reference<Mesh>> meshes;
+	for(uint32_t m = 0; m < 4; ++m) {
+		// created with the strategy as default strategy
+		Util::Reference<Mesh> mesh = new Mesh(vd, 3, 3);
+		REQUIRE(mesh->getDataStrategy() == strategy.get());
+		float * positions = reinterpret_cast<float *>(mesh->openVertexData().data());
+		for(uint32_t i = 0; i < 9; ++i)
+			positions[i] = static_cast<float>(m * 100 + i);
+		MeshIndexData & indices = mesh->openIndexData();
+		for(uint32_t i = 0; i < 3; ++i)
+			indices[i] = i;
+		indices.updateIndexRange();
+		// the last mesh is never prepared
+		if(m < 3)
+			strategy->prepare(mesh.get());
+		meshes.push_back(mesh);
+	}
+	REQUIRE_FALSE(meshes.front()->_getVertexData().hasLocalData());
+	// a copy uses the same strategy
+	meshes.push_back(meshes[3]->clone());
+
+	// the meshes get the initial default strategy and their data is downloaded
+	strategy.reset();
+	REQUIRE(MeshDataStrategy::getDefaultStrategy() == initialDefault);
+	for(uint32_t m = 0; m < meshes.size(); ++m) {
+		REQUIRE(meshes[m]->getDataStrategy() == initialDefault);
+		REQUIRE(meshes[m]->_getVertexData().hasLocalData());
+		REQUIRE(meshes[m]->_getIndexData().hasLocalData());
+		const float * positions = reinterpret_cast<const float *>(meshes[m]->_getVertexData().data());
+		for(uint32_t i = 0; i < 9; ++i)
+			REQUIRE(positions[i] == static_cast<float>(std::min(m, 3u) * 100 + i));
+		REQUIRE(meshes[m]->_getIndexData()[2] == 2);
+	}
+	// destroying the meshes does not access the destroyed strategy
+	meshes.clear();
+}
@@ -0,0 +1,270 @@
+/*
+ This file is part of the Rendering library.
+ Copyright (C) 2026 agent <agent@local>
+
+ This library is subject to the terms of the Mozilla Public License, v. 2.0.
+ You should have received a copy of the MPL along with this library; see the
+ file LICENSE. If not, you can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <catch2/catch.hpp>
+#include <Rendering/GLHeader.h>
+#include <Rendering/Mesh/Mesh.h>
+#include <Rendering/Mesh/MeshIndexData.h>
+#include <Rendering/Mesh/MeshVertexData.h>
+#include <Rendering/Mesh/VertexDescription.h>
+#include <Rendering/RenderingContext/RenderingContext.h>
+#include <Rendering/RenderingContext/RenderingParameters.h>
+#include <Rendering/Shader/Shader.h>
+#include <Rendering/Shader/Uniform.h>
+#include <Rendering/Shader/UniformRegistry.h>
+
+#include <Geometry/Matrix4x4.h>
+#include <Geometry/Vec3.h>
+#include <Util/Graphics/Color.h>
+#include <Util/References.h>
+#include <Util/StringIdentifier.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace Rendering;
+
+//! Return true if the values of @p uniform are stored inside the Uniform object itself.
+static bool isStoredInline(const Uniform & uniform) {
+	const uint8_t * begin = reinterpret_cast<const uint8_t *>(&uniform);
+	return uniform.getData() >= begin && uniform.getData() < begin + sizeof(Uniform);
+}
+
+TEST_CASE("UniformTest_valueBuffer", "[UniformTest]") {
+	Geometry::Matrix4x4 matrix;
+	matrix.translate(Geometry::Vec3(1.0f, 2.0f, 3.0f));
+
+	// a 4x4 matrix (64 bytes) fits into the inline storage
+	const Uniform small("small", matrix);
+	REQUIRE(small.getDataSize() == 16 * sizeof(float));
+	REQUIRE(isStoredInline(small));
+
+	// larger arrays are stored on the heap
+	const Uniform large("large", std::vector<Geometry::Matrix4x4>{matrix, matrix});
+	REQUIRE(large.getDataSize() == 2 * 16 * sizeof(float));
+	REQUIRE(!isStoredInline(large));
+	REQUIRE(std::equal(small.getData(), small.getData() + small.getDataSize(), large.getData()));
+	REQUIRE(std::equal(small.getData(), small.getData() + small.getDataSize(), large.getData() + small.getDataSize()));
+
+	// raw data
+	const Uniform raw("small", Uniform::UNIFORM_MATRIX_4X4F, 1, small.getData());
+	REQUIRE(raw == small);
+	REQUIRE(isStoredInline(raw));
+
+	SECTION("copy") {
+		Uniform smallCopy(small);
+		Uniform largeCopy(large);
+		REQUIRE(smallCopy == small);
+		REQUIRE(largeCopy == large);
+		REQUIRE(isStoredInline(smallCopy));
+		REQUIRE(largeCopy.getData() != large.getData());
+
+		// assignment switches between inline and heap storage
+		smallCopy = large;
+		largeCopy = small;
+		REQUIRE(smallCopy == large);
+		REQUIRE(largeCopy == small);
+		REQUIRE(!isStoredInline(smallCopy));
+		REQUIRE(isStoredInline(largeCopy));
+	}
+	SECTION("move") {
+		Uniform smallSource(small);
+		Uniform largeSource(large);
+		const uint8_t * heapData = largeSource.getData();
+
+		Uniform smallMoved(std::move(smallSource));
+		Uniform largeMoved(std::move(largeSource));
+		REQUIRE(smallMoved == small);
+		REQUIRE(largeMoved == large);
+		REQUIRE(isStoredInline(smallMoved));
+		// the heap storage is taken over
+		REQUIRE(largeMoved.getData() == heapData);
+		REQUIRE(smallSource.getDataSize() == 0);
+		REQUIRE(largeSource.getDataSize() == 0);
+
+		Uniform target("target", 1.0f);
+		target = std::move(largeMoved);
+		REQUIRE(target == large);
+		REQUIRE(target.getData() == heapData);
+		target = std::move(smallMoved);
+		REQUIRE(target == small);
+		REQUIRE(isStoredInline(target));
+	}
+}
+
+TEST_CASE("UniformTest_setSlotUniform", "[UniformTest]") {
+	const Util::StringIdentifier name("sg_test");
+	const Util::StringIdentifier otherName("sg_other");
+	UniformRegistry registry;
+
+	// the first use of a slot creates the entry
+	registry.setSlotUniform(0, Uniform(name, 1.0f));
+	REQUIRE(registry.getUniform(name) == Uniform(name, 1.0f));
+
+	// the slot and the name refer to the same entry
+	registry.setUniform(Uniform(name, 2.0f));
+	REQUIRE(registry.getUniform(name) == Uniform(name, 2.0f));
+	registry.setSlotUniform(0, Uniform(name, 3.0f));
+	REQUIRE(registry.getUniform(name) == Uniform(name, 3.0f));
+
+	// a slot is resolved to an entry that has been set by name before
+	registry.setUniform(Uniform(otherName, 4));
+	registry.setSlotUniform(5, Uniform(otherName, 5));
+	REQUIRE(registry.getUniform(otherName) == Uniform(otherName, 5));
+	registry.setUniform(Uniform(otherName, 6));
+	registry.setSlotUniform(5, Uniform(otherName, 7));
+	REQUIRE(registry.getUniform(otherName) == Uniform(otherName, 7));
+	REQUIRE(registry.getUniform(name) == Uniform(name, 3.0f));
+
+	// clearing the registry also resets the resolved slots
+	registry.clear();
+	REQUIRE(registry.getUniform(name).isNull());
+	registry.setSlotUniform(0, Uniform(name, 8.0f));
+	REQUIRE(registry.getUniform(name) == Uniform(name, 8.0f));
+	registry.setUniform(Uniform(name, 9.0f));
+	REQUIRE(registry.getUniform(name) == Uniform(name, 9.0f));
+	REQUIRE(registry.getUniform(otherName).isNull());
+}
+
+static const std::string sgStructs(
+	"struct sg_LightSourceParameters {\n"
+	"	vec3 position; int type; vec3 direction; float constant;\n"
+	"	float linear; float quadratic; float exponent; float cosCutoff;\n"
+	"	vec4 ambient; vec4 diffuse; vec4 specular;\n"
+	"};\n"
+	"struct sg_MaterialParameters {\n"
+	"	vec4 ambient; vec4 diffuse; vec4 specular; vec4 emission; float shininess;\n"
+	"};\n");
+
+static const std::string sgUniforms(
+	"uniform mat4 sg_matrix_modelToClipping;\n"
+	"uniform mat4 sg_matrix_clippingToCamera;\n"
+	"uniform sg_MaterialParameters sg_Material;\n"
+	"uniform bool sg_useMaterials;\n"
+	"uniform int sg_lightCount;\n"
+	"uniform sg_LightSourceParameters sg_LightSource[8];\n");
+
+static const std::string sgUniformBlock(
+	"layout(std140) uniform sg_UniformBlock {\n"
+	"	mat4 sg_matrix_modelToCamera;\n"
+	"	mat4 sg_matrix_cameraToClipping;\n"
+	"	mat4 sg_matrix_modelToClipping;\n"
+	"	mat4 sg_matrix_worldToCamera;\n"
+	"	mat4 sg_matrix_cameraToWorld;\n"
+	"	mat4 sg_matrix_clippingToCamera;\n"
+	"	sg_MaterialParameters sg_Material;\n"
+	"	int sg_useMaterials;\n"
+	"	int sg_lightCount;\n"
+	"	float sg_pointSize;\n"
+	"	sg_LightSourceParameters sg_LightSource[8];\n"
+	"};\n");
+
+//! Writes values of the sg-uniforms into the color; the same code is used with single uniforms and with the block.
+static const std::string vertexMain(
+	"in vec3 sg_Position;\n"
+	"out vec4 color;\n"
+	"void main() {\n"
+	"	gl_Position = sg_matrix_modelToClipping * vec4(sg_Position, 1.0);\n"
+	"	vec4 corner = sg_matrix_clippingToCamera * vec4(1.0, 1.0, 0.0, 1.0);\n"
+	"	color = vec4(sg_Material.diffuse.r * 0.5 + 0.1 * float(sg_lightCount),\n"
+	"				(sg_lightCount > 0 ? sg_LightSource[0].diffuse.g : 0.0) * 0.5 + corner.x / corner.w * 0.125,\n"
+	"				0.5 * float(sg_useMaterials), 1.0);\n"
+	"}\n");
+
+static const std::string fragmentShader(
+	"#version 330\n"
+	"in vec4 color;\n"
+	"out vec4 fragColor;\n"
+	"void main() {\n"
+	"	fragColor = color;\n"
+	"}\n");
+
+//! Draw @p mesh with @p shader and return the pixels of the center of the screen.
+static std::vector<uint8_t> renderCenter(RenderingContext & context, Shader * shader, Mesh * mesh) {
+	RenderingContext::clearScreen(Util::Color4f(0.0f, 0.0f, 0.0f, 0.0f));
+	context.pushAndSetShader(shader);
+	context.displayMesh(mesh);
+	context.popShader();
+	RenderingContext::finish();
+
+	std::vector<uint8_t> pixels(16 * 16 * 4);
+	glReadPixels(120, 120, 16, 16, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+	return pixels;
+}
+
+TEST_CASE("UniformTest_sgUniformBlock", "[UniformTest]") {
+	Util::Reference<Shader> uniformShader = Shader::createShader("#version 330\n" + sgStructs + sgUniforms + vertexMain,
+																fragmentShader, Shader::USE_UNIFORMS);
+	Util::Reference<Shader> blockShader = Shader::createShader("#version 330\n" + sgStructs + sgUniformBlock + vertexMain,
+																fragmentShader, Shader::USE_UNIFORMS);
+
+	// quad covering the screen
+	VertexDescription vd;
+	vd.appendPosition3D();
+	Util::Reference<Mesh> quad = new Mesh(vd, 4, 6);
+	{
+		MeshVertexData & vertices = quad->openVertexData();
+		float * positions = reinterpret_cast<float *>(vertices.data());
+		const float corners[] = {-1.0f, -1.0f, 0.0f, 1.0f, -1.0f, 0.0f, 1.0f, 1.0f, 0.0f, -1.0f, 1.0f, 0.0f};
+		std::copy(std::begin(corners), std::end(corners), positions);
+		vertices.updateBoundingBox();
+		vertices.markAsChanged();
+		MeshIndexData & indices = quad->openIndexData();
+		const uint32_t triangles[] = {0, 1, 2, 0, 2, 3};
+		std::copy(std::begin(triangles), std::end(triangles), indices.data());
+		indices.updateIndexRange();
+		indices.markAsChanged();
+	}
+
+	RenderingContext context;
+	context.setSGUniformBlockEnabled(true);
+	context.setMatrix_cameraToWorld(Geometry::Matrix4x4());
+	context.setMatrix_cameraToClipping(Geometry::Matrix4x4::orthographicProjection(-2.0f, 2.0f, -2.0f, 2.0f, -1.0f, 1.0f));
+	Geometry::Matrix4x4 modelToCamera;
+	modelToCamera.scale(2.0f);
+	context.setMatrix_modelToCamera(modelToCamera);
+
+	MaterialParameters material;
+	material.setDiffuse(Util::Color4f(0.6f, 0.0f, 0.0f, 1.0f));
+	context.setMaterial(material);
+	LightParameters light;
+	light.diffuse = Util::Color4f(0.0f, 0.4f, 0.0f, 1.0f);
+	const uint8_t lightNumber = context.enableLight(light);
+
+	const auto withUniforms = renderCenter(context, uniformShader.get(), quad.get());
+	const auto withBlock = renderCenter(context, blockShader.get(), quad.get());
+	CAPTURE(static_cast<int>(withUniforms[0]), static_cast<int>(withUniforms[1]), static_cast<int>(withUniforms[2]));
+	CAPTURE(static_cast<int>(withBlock[0]), static_cast<int>(withBlock[1]), static_cast<int>(withBlock[2]));
+	// red: 0.6 * 0.5 + 0.1 * 1 light; green: 0.4 * 0.5 + 2 (camera space corner) * 0.125
+	REQUIRE(std::abs(static_cast<int>(withUniforms[0]) - 102) <= 2);
+	REQUIRE(std::abs(static_cast<int>(withUniforms[1]) - 115) <= 2);
+	REQUIRE(withBlock == withUniforms);
+
+	// the block is updated when the state changes between two draw calls
+	context.disableLight(lightNumber);
+	context.setMatrix_cameraToClipping(Geometry::Matrix4x4::orthographicProjection(-4.0f, 4.0f, -4.0f, 4.0f, -1.0f, 1.0f));
+	modelToCamera.scale(2.0f);
+	context.setMatrix_modelToCamera(modelToCamera);
+	material.setDiffuse(Util::Color4f(1.0f, 0.0f, 0.0f, 1.0f));
+	context.setMaterial(material);
+
+	const auto changedUniforms = renderCenter(context, uniformShader.get(), quad.get());
+	const auto changedBlock = renderCenter(context, blockShader.get(), quad.get());
+	CAPTURE(static_cast<int>(changedUniforms[0]), static_cast<int>(changedUniforms[1]), static_cast<int>(changedUniforms[2]));
+	CAPTURE(static_cast<int>(changedBlock[0]), static_cast<int>(changedBlock[1]), static_cast<int>(changedBlock[2]));
+	// red: 1.0 * 0.5 without lights; green: 4 (camera space corner) * 0.125 without lights
+	REQUIRE(std::abs(static_cast<int>(changedUniforms[0]) - 128) <= 2);
+	REQUIRE(std::abs(static_cast<int>(changedUniforms[1]) - 128) <= 2);
+	REQUIRE(changedBlock == changedUniforms);
+}
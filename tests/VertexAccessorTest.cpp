@@ -22,6 +22,7 @@
 #include <cstdint>
 #include <functional>
 #include <random>
+#include <stdexcept>
 #include <vector>
 
 using namespace Rendering;
@@ -207,4 +208,117 @@ TEST_CASE("VertexAccessorTest_compareSpeed", "[VertexAccessorTest]") {
     }
     std::cout << "VertexAccessor (GPU;dynamic:location): " << t.getMilliseconds() << " ms" << std::endl;    
   }
-}
\ No newline at end of file
+}
+
+TEST_CASE("VertexAccessorTest_batchAccess", "[VertexAccessorTest]") {
+  VertexDescription vd;
+  vd.appendPosition4DHalf();
+  vd.appendNormalByte();
+  vd.appendColorRGBAByte();
+  vd.appendTexCoord();
+  MeshVertexData vData;
+  vData.allocate(1000, vd);
+
+  std::default_random_engine engine(0);
+  std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+  std::vector<float> values(4 * vData.getVertexCount());
+  for(auto & value : values)
+    value = dist(engine);
+  std::vector<uint32_t> indices;
+  for(uint32_t i = 0; i < vData.getVertexCount(); i += 7)
+    indices.push_back(i);
+  std::shuffle(indices.begin(), indices.end(), engine);
+
+  auto posAcc = PositionAttributeAccessor::create(vData);
+  auto normalAcc = NormalAttributeAccessor::create(vData);
+  auto colorAcc = ColorAttributeAccessor::create(vData);
+  posAcc->setPositions(0, vData.getVertexCount(), values.data());
+  normalAcc->setNormals(0, vData.getVertexCount(), values.data());
+  colorAcc->setColors(0, vData.getVertexCount(), values.data());
+  // batch access equals per-vertex access
+  std::vector<float> result(4 * vData.getVertexCount());
+  posAcc->getPositions(0, vData.getVertexCount(), result.data());
+  for(uint32_t i = 0; i < vData.getVertexCount(); ++i) {
+    const Geometry::Vec3 p = posAcc->getPosition(i);
+    REQUIRE(p.distance(Geometry::Vec3(result[3 * i], result[3 * i + 1], result[3 * i + 2])) == 0.0f);
+    REQUIRE(p.distance(Geometry::Vec3(values[3 * i], values[3 * i + 1], values[3 * i + 2])) < 1.0e-2f);
+  }
+  const uint32_t indexCount = static_cast<uint32_t>(indices.size());
+  normalAcc->gatherNormals(indices.data(), indexCount, result.data());
+  for(uint32_t i = 0; i < indexCount; ++i)
+    REQUIRE(normalAcc->getNormal(indices[i]).distance(Geometry::Vec3(result[3 * i], result[3 * i + 1], result[3 * i + 2])) == 0.0f);
+  colorAcc->getColors4f(10, 20, result.data());
+  for(uint32_t i = 0; i < 20; ++i) {
+    const Util::Color4f c = colorAcc->getColor4f(10 + i);
+    REQUIRE(c.getR() == result[4 * i]);
+    REQUIRE(c.getG() == result[4 * i + 1]);
+    REQUIRE(c.getB() == result[4 * i + 2]);
+    REQUIRE(c.getA() == result[4 * i + 3]);
+  }
+  posAcc->scatterPositions(indices.data(), indexCount, values.data());
+  for(uint32_t i = 0; i < indexCount; ++i)
+    REQUIRE(posAcc->getPosition(indices[i]).distance(Geometry::Vec3(values[3 * i], values[3 * i + 1], values[3 * i + 2])) < 1.0e-2f);
+  REQUIRE_THROWS_AS(posAcc->getPositions(vData.getVertexCount() - 1, 2, result.data()), std::range_error);
+
+  // typed views
+  REQUIRE(UByte4AttributeView::isCompatible(vd.getAttribute(VertexAttributeIds::COLOR)));
+  REQUIRE_FALSE(Float3AttributeView::isCompatible(vd.getAttribute(VertexAttributeIds::POSITION)));
+  REQUIRE_THROWS_AS(Float3AttributeView(vData, VertexAttributeIds::POSITION), std::invalid_argument);
+  UByte4AttributeView colors(vData, VertexAttributeIds::COLOR);
+  REQUIRE(colors.getVertexCount() == vData.getVertexCount());
+  for(uint32_t i = 0; i < vData.getVertexCount(); ++i) {
+    const Util::Color4ub c = colorAcc->getColor4ub(i);
+    REQUIRE((colors[i][0] == c.getR() && colors[i][1] == c.getG() && colors[i][2] == c.getB() && colors[i][3] == c.getA()));
+  }
+}
+
+TEST_CASE("VertexAccessorTest_batchSpeed", "[.][VertexAccessorTest]") {
+  std::cout << std::endl;
+  VertexDescription vd;
+  vd.appendPosition3D();
+  vd.appendNormalByte();
+  vd.appendColorRGBAByte();
+  MeshVertexData vData;
+  vData.allocate(1000000, vd);
+  const uint32_t vertexCount = vData.getVertexCount();
+  auto posAcc = PositionAttributeAccessor::create(vData);
+  auto normalAcc = NormalAttributeAccessor::create(vData);
+  std::vector<float> xyz(3 * vertexCount, 0.5f);
+  Util::Timer t;
+  float sum = 0;
+
+  t.reset();
+  for(uint32_t i = 0; i < vertexCount; ++i)
+    posAcc->setPosition(i, Geometry::Vec3(xyz[3 * i], xyz[3 * i + 1], xyz[3 * i + 2]));
+  for(uint32_t i = 0; i < vertexCount; ++i)
+    sum += posAcc->getPosition(i).x();
+  std::cout << "PositionAttributeAccessor (per vertex): " << t.getMilliseconds() << " ms" << std::endl;
+
+  t.reset();
+  posAcc->setPositions(0, vertexCount, xyz.data());
+  posAcc->getPositions(0, vertexCount, xyz.data());
+  std::cout << "PositionAttributeAccessor (batch): " << t.getMilliseconds() << " ms" << std::endl;
+
+  t.reset();
+  {
+    Float3AttributeView positions(vData, VertexAttributeIds::POSITION);
+    for(uint32_t i = 0; i < vertexCount; ++i)
+      positions[i][0] = xyz[3 * i], positions[i][1] = xyz[3 * i + 1], positions[i][2] = xyz[3 * i + 2];
+    for(uint32_t i = 0; i < vertexCount; ++i)
+      sum += positions[i][0];
+  }
+  std::cout << "Float3AttributeView: " << t.getMilliseconds() << " ms" << std::endl;
+
+  t.reset();
+  for(uint32_t i = 0; i < vertexCount; ++i)
+    normalAcc->setNormal(i, Geometry::Vec3(xyz[3 * i], xyz[3 * i + 1], xyz[3 * i + 2]));
+  for(uint32_t i = 0; i < vertexCount; ++i)
+    sum += normalAcc->getNormal(i).x();
+  std::cout << "NormalAttributeAccessor (per vertex): " << t.getMilliseconds() << " ms" << std::endl;
+
+  t.reset();
+  normalAcc->setNormals(0, vertexCount, xyz.data());
+  normalAcc->getNormals(0, vertexCount, xyz.data());
+  std::cout << "NormalAttributeAccessor (batch): " << t.getMilliseconds() << " ms" << std::endl;
+  REQUIRE(sum > 0);
+}